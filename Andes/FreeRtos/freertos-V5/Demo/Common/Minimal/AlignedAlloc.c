@@ -0,0 +1,306 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests pvPortMallocAligned(), and that the kernel allocates objects aligned
+	to portKERNEL_OBJECT_ALIGNMENT when configUSE_ALIGNED_KERNEL_OBJECTS is set
+	to 1.
+
+	Two instances of prvAlignedAllocTask() run at the same priority.  Each
+	cycle every task:
+
+	1) Allocates a block for each combination of a range of sizes and a range
+	   of alignments, checks each block starts on the requested boundary,
+	   writes a pattern unique to the task and the block into each, checks the
+	   patterns, then frees the blocks.  Some blocks are freed before the
+	   others are allocated, so the heap contains gaps that aligned requests
+	   have to be fitted into.
+
+	2) Creates a queue and a stream buffer, then checks both handles and the
+	   handle of the calling task are aligned to portKERNEL_OBJECT_ALIGNMENT,
+	   sends data through both objects, then deletes them.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+/* Demo app include files. */
+#include "AlignedAlloc.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_ALIGNED_KERNEL_OBJECTS == 1 )
+
+/* The number of tasks described at the top of this file, and their
+priority. */
+#define aaNUM_TASKS					( 2 )
+#define aaTEST_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/* The number of sizes and alignments used in step 1 of each cycle. */
+#define aaNUM_SIZES					( 4 )
+#define aaNUM_ALIGNMENTS			( 5 )
+#define aaNUM_BLOCKS				( aaNUM_SIZES * aaNUM_ALIGNMENTS )
+
+/* The queue and stream buffer created in step 2 of each cycle. */
+#define aaQUEUE_LENGTH				( 3 )
+#define aaSTREAM_BUFFER_SIZE		( 20 )
+
+#define aaCYCLE_DELAY				pdMS_TO_TICKS( 10 )
+
+#ifndef aaALIGNED_ALLOC_TEST_TASK_STACK_SIZE
+	#define aaALIGNED_ALLOC_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* True if pv is a multiple of xAlignment. */
+#define aaIS_ALIGNED( pv, xAlignment ) ( ( ( ( size_t ) ( portPOINTER_SIZE_TYPE ) ( pv ) ) & ( ( xAlignment ) - ( size_t ) 1 ) ) == ( size_t ) 0 )
+
+/* The task described at the top of this file. */
+static void prvAlignedAllocTask( void *pvParameters );
+
+/*
+ * Allocate, check, fill and free blocks of a range of sizes and alignments.
+ * ulPattern identifies the calling task.
+ */
+static BaseType_t prvAllocateAlignedBlocks( uint32_t ulPattern );
+
+/*
+ * Create, use and delete a queue and a stream buffer, checking the alignment
+ * of the objects the kernel allocates.
+ */
+static BaseType_t prvCheckKernelObjectAlignment( void );
+
+/*-----------------------------------------------------------*/
+
+/* Sizes and alignments allocated in step 1 of each cycle. */
+static const size_t xBlockSizes[ aaNUM_SIZES ] = { 1, 24, 100, 300 };
+static const size_t xAlignments[ aaNUM_ALIGNMENTS ] = { 1, 32, 64, 128, 512 };
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxCycles[ aaNUM_TASKS ] = { 0 };
+
+/*-----------------------------------------------------------*/
+
+void vStartAlignedAllocTasks( void )
+{
+UBaseType_t uxTask;
+
+	for( uxTask = 0; uxTask < aaNUM_TASKS; uxTask++ )
+	{
+		xTaskCreate( prvAlignedAllocTask, "AlignAlloc", aaALIGNED_ALLOC_TEST_TASK_STACK_SIZE, ( void * ) uxTask, aaTEST_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAlignedAllocTask( void *pvParameters )
+{
+const UBaseType_t uxTask = ( UBaseType_t ) pvParameters;
+
+	for( ;; )
+	{
+		if( prvAllocateAlignedBlocks( ( uint32_t ) uxTask ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvCheckKernelObjectAlignment() != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxCycles[ uxTask ]++;
+		vTaskDelay( aaCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAllocateAlignedBlocks( uint32_t ulPattern )
+{
+uint8_t *pucBlocks[ aaNUM_BLOCKS ];
+UBaseType_t uxBlock;
+size_t xSize, xAlignment, xByte;
+uint8_t ucValue;
+BaseType_t xReturn = pdPASS;
+
+	for( uxBlock = 0; uxBlock < aaNUM_BLOCKS; uxBlock++ )
+	{
+		xSize = xBlockSizes[ uxBlock % aaNUM_SIZES ];
+		xAlignment = xAlignments[ uxBlock / aaNUM_SIZES ];
+		pucBlocks[ uxBlock ] = ( uint8_t * ) pvPortMallocAligned( xSize, xAlignment );
+
+		if( pucBlocks[ uxBlock ] == NULL )
+		{
+			xReturn = pdFAIL;
+		}
+		else if( aaIS_ALIGNED( pucBlocks[ uxBlock ], xAlignment ) == pdFALSE )
+		{
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			ucValue = ( uint8_t ) ( ( ulPattern << 5 ) + uxBlock );
+			for( xByte = 0; xByte < xSize; xByte++ )
+			{
+				pucBlocks[ uxBlock ][ xByte ] = ucValue;
+			}
+		}
+
+		/* Free every third block straight away, after checking it, so later
+		requests have to be fitted around the gaps it leaves. */
+		if( ( ( uxBlock % 3 ) == 0 ) && ( pucBlocks[ uxBlock ] != NULL ) )
+		{
+			vPortFree( pucBlocks[ uxBlock ] );
+			pucBlocks[ uxBlock ] = NULL;
+		}
+	}
+
+	/* Let the other task run so a block shared with it would be detected. */
+	taskYIELD();
+
+	for( uxBlock = 0; uxBlock < aaNUM_BLOCKS; uxBlock++ )
+	{
+		if( pucBlocks[ uxBlock ] != NULL )
+		{
+			xSize = xBlockSizes[ uxBlock % aaNUM_SIZES ];
+			ucValue = ( uint8_t ) ( ( ulPattern << 5 ) + uxBlock );
+			for( xByte = 0; xByte < xSize; xByte++ )
+			{
+				if( pucBlocks[ uxBlock ][ xByte ] != ucValue )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+
+			vPortFree( pucBlocks[ uxBlock ] );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckKernelObjectAlignment( void )
+{
+QueueHandle_t xQueue;
+StreamBufferHandle_t xStreamBuffer;
+uint32_t ulValue = 0UL;
+uint8_t ucBytes[ 4 ] = { 0 };
+BaseType_t xReturn = pdPASS;
+
+	/* This task was created dynamically, so its TCB is aligned too. */
+	if( aaIS_ALIGNED( xTaskGetCurrentTaskHandle(), portKERNEL_OBJECT_ALIGNMENT ) == pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	xQueue = xQueueCreate( aaQUEUE_LENGTH, sizeof( uint32_t ) );
+
+	if( xQueue == NULL )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		if( aaIS_ALIGNED( xQueue, portKERNEL_OBJECT_ALIGNMENT ) == pdFALSE )
+		{
+			xReturn = pdFAIL;
+		}
+
+		/* The storage area must still be usable. */
+		ulValue = 0x12345678UL;
+		if( xQueueSend( xQueue, &ulValue, 0 ) != pdPASS )
+		{
+			xReturn = pdFAIL;
+		}
+
+		ulValue = 0UL;
+		if( ( xQueueReceive( xQueue, &ulValue, 0 ) != pdPASS ) || ( ulValue != 0x12345678UL ) )
+		{
+			xReturn = pdFAIL;
+		}
+
+		vQueueDelete( xQueue );
+	}
+
+	xStreamBuffer = xStreamBufferCreate( aaSTREAM_BUFFER_SIZE, 1 );
+
+	if( xStreamBuffer == NULL )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		if( aaIS_ALIGNED( xStreamBuffer, portKERNEL_OBJECT_ALIGNMENT ) == pdFALSE )
+		{
+			xReturn = pdFAIL;
+		}
+
+		if( xStreamBufferSend( xStreamBuffer, "abcd", sizeof( ucBytes ), 0 ) != sizeof( ucBytes ) )
+		{
+			xReturn = pdFAIL;
+		}
+
+		if( ( xStreamBufferReceive( xStreamBuffer, ucBytes, sizeof( ucBytes ), 0 ) != sizeof( ucBytes ) ) || ( ucBytes[ 3 ] != ( uint8_t ) 'd' ) )
+		{
+			xReturn = pdFAIL;
+		}
+
+		vStreamBufferDelete( xStreamBuffer );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreAlignedAllocTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+UBaseType_t uxTask;
+static UBaseType_t uxLastCycles[ aaNUM_TASKS ] = { 0 };
+
+	for( uxTask = 0; uxTask < aaNUM_TASKS; uxTask++ )
+	{
+		if( uxLastCycles[ uxTask ] == uxCycles[ uxTask ] )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxLastCycles[ uxTask ] = uxCycles[ uxTask ];
+	}
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_ALIGNED_KERNEL_OBJECTS == 1 */
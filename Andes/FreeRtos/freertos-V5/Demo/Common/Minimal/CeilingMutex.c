@@ -0,0 +1,374 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the priority ceiling mutex type.
+
+	prvLowPriorityTask() takes xCeilingMutex, which has a ceiling priority above
+	the priority of both tasks created by this file, and checks its priority has
+	been raised to the ceiling.  It then unblocks prvMediumPriorityTask().  The
+	medium priority task has a priority above the base priority of the low
+	priority task but below the ceiling, so must not run until the low priority
+	task gives the mutex back - at which point the low priority task must drop
+	back to its base priority and be preempted by the medium priority task.
+
+	The medium priority task takes the mutex itself, to check the ceiling is
+	applied to tasks whose priority is already above the idle priority.
+
+	The low priority task also takes a statically allocated ceiling mutex that
+	has a higher ceiling while still holding the first, to check nested ceiling
+	mutexes are handled.  The nested mutex and the medium priority task use
+	xSemaphoreTakeCeiling() and xSemaphoreGiveCeiling(), so both the generic
+	and the dedicated ceiling mutex paths are tested.
+
+	At the start of each cycle the low priority task also times
+	cmBENCHMARK_ITERATIONS uncontended take/give pairs on a standard mutex
+	using xSemaphoreTake() and xSemaphoreGive(), and on xCeilingMutex using
+	both those macros and xSemaphoreTakeCeiling() and xSemaphoreGiveCeiling().
+	The results can be retrieved by vGetCeilingMutexBenchmarkResults().
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo app include files. */
+#include "CeilingMutex.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_CEILING_MUTEXES == 1 )
+
+#if( configMAX_PRIORITIES < 5 )
+	#error This test needs configMAX_PRIORITIES to be at least 5.
+#endif
+
+/* Priorities of the tasks described at the top of this file, and the ceiling
+priorities of the two mutexes. */
+#define cmLOW_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define cmMEDIUM_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define cmCEILING_PRIORITY			( tskIDLE_PRIORITY + 3 )
+#define cmNESTED_CEILING_PRIORITY	( tskIDLE_PRIORITY + 4 )
+
+/* The number of take/give pairs timed on each mutex type. */
+#define cmBENCHMARK_ITERATIONS		( 1000UL )
+
+/* Misc. */
+#define cmCYCLE_DELAY				pdMS_TO_TICKS( 50 )
+#define cmNO_DELAY					( ( TickType_t ) 0 )
+
+#ifndef cmCEILING_MUTEX_TEST_TASK_STACK_SIZE
+	#define cmCEILING_MUTEX_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* configBENCHMARK_GET_TIME() can be defined in FreeRTOSConfig.h to return a
+free running counter with a higher resolution than the tick count, such as a
+cycle counter. */
+#ifndef configBENCHMARK_GET_TIME
+	#define configBENCHMARK_GET_TIME() ( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+/* The tasks as described at the top of this file. */
+static void prvLowPriorityTask( void *pvParameters );
+static void prvMediumPriorityTask( void *pvParameters );
+
+/*
+ * Check the priority of the calling task is uxExpectedPriority, latching an
+ * error if not.
+ */
+static void prvCheckPriority( UBaseType_t uxExpectedPriority );
+
+/*
+ * Time cmBENCHMARK_ITERATIONS take/give pairs on xMutex, using the ceiling
+ * mutex API if xCeiling is pdTRUE.
+ */
+static uint32_t prvTimeMutex( SemaphoreHandle_t xMutex, BaseType_t xCeiling );
+
+/*-----------------------------------------------------------*/
+
+/* The mutexes used by the demo.  xNestedCeilingMutex is statically allocated
+if configSUPPORT_STATIC_ALLOCATION is 1. */
+static SemaphoreHandle_t xCeilingMutex = NULL, xNestedCeilingMutex = NULL;
+
+/* The standard mutex the benchmark compares against. */
+static SemaphoreHandle_t xStandardMutex = NULL;
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	static StaticSemaphore_t xNestedCeilingMutexBuffer;
+#endif
+
+/* Handle of the task that is woken by a task notification. */
+static TaskHandle_t xMediumTaskHandle = NULL;
+
+/* The most recent benchmark results. */
+static volatile uint32_t ulStandardMutexTime = 0, ulGenericCeilingMutexTime = 0, ulCeilingMutexTime = 0;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxLowCycles = 0, uxMediumCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartCeilingMutexTasks( void )
+{
+	xCeilingMutex = xSemaphoreCreateCeilingMutex( cmCEILING_PRIORITY );
+	xStandardMutex = xSemaphoreCreateMutex();
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		xNestedCeilingMutex = xSemaphoreCreateCeilingMutexStatic( cmNESTED_CEILING_PRIORITY, &xNestedCeilingMutexBuffer );
+	}
+	#else
+	{
+		xNestedCeilingMutex = xSemaphoreCreateCeilingMutex( cmNESTED_CEILING_PRIORITY );
+	}
+	#endif
+
+	if( ( xCeilingMutex != NULL ) && ( xNestedCeilingMutex != NULL ) && ( xStandardMutex != NULL ) )
+	{
+		vQueueAddToRegistry( ( QueueHandle_t ) xCeilingMutex, "Ceiling_Mutex" );
+		vQueueAddToRegistry( ( QueueHandle_t ) xNestedCeilingMutex, "Ceiling_Nested" );
+
+		xTaskCreate( prvLowPriorityTask, "CeilLow", cmCEILING_MUTEX_TEST_TASK_STACK_SIZE, NULL, cmLOW_PRIORITY, NULL );
+		xTaskCreate( prvMediumPriorityTask, "CeilMed", cmCEILING_MUTEX_TEST_TASK_STACK_SIZE, NULL, cmMEDIUM_PRIORITY, &xMediumTaskHandle );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityTask( void *pvParameters )
+{
+UBaseType_t uxMediumCyclesOnEntry;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulStandardMutexTime = prvTimeMutex( xStandardMutex, pdFALSE );
+		ulGenericCeilingMutexTime = prvTimeMutex( xCeilingMutex, pdFALSE );
+		ulCeilingMutexTime = prvTimeMutex( xCeilingMutex, pdTRUE );
+		prvCheckPriority( cmLOW_PRIORITY );
+
+		if( xSemaphoreTake( xCeilingMutex, cmNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		prvCheckPriority( cmCEILING_PRIORITY );
+
+		/* The medium priority task is below the ceiling so must not run,
+		even if this task yields, until the mutex is given back. */
+		uxMediumCyclesOnEntry = uxMediumCycles;
+		xTaskNotifyGive( xMediumTaskHandle );
+		taskYIELD();
+
+		if( uxMediumCycles != uxMediumCyclesOnEntry )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Take a mutex with a higher ceiling while holding the first. */
+		if( xSemaphoreTakeCeiling( xNestedCeilingMutex, cmNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		prvCheckPriority( cmNESTED_CEILING_PRIORITY );
+
+		/* The nested mutex is held, so cannot be taken again. */
+		if( xSemaphoreTakeCeiling( xNestedCeilingMutex, cmNO_DELAY ) != pdFAIL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xSemaphoreGiveCeiling( xNestedCeilingMutex ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Depending on the configuration the priority either falls back to
+		the first ceiling now or remains at the higher ceiling until the last
+		mutex is given back, but it must not fall below the first ceiling. */
+		#if( INCLUDE_uxTaskPriorityGet == 1 )
+		{
+			if( uxTaskPriorityGet( NULL ) < cmCEILING_PRIORITY )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+		#endif /* INCLUDE_uxTaskPriorityGet */
+
+		if( uxMediumCycles != uxMediumCyclesOnEntry )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Giving the mutex back drops this task to its base priority, so the
+		medium priority task runs before the give function returns. */
+		if( xSemaphoreGive( xCeilingMutex ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		prvCheckPriority( cmLOW_PRIORITY );
+
+		if( uxMediumCycles != ( uxMediumCyclesOnEntry + ( UBaseType_t ) 1 ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxLowCycles++;
+		vTaskDelay( cmCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMediumPriorityTask( void *pvParameters )
+{
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait to be woken by the low priority task. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		/* The low priority task must have given the mutex back for this task
+		to be running. */
+		if( xSemaphoreTakeCeiling( xCeilingMutex, cmNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+		else
+		{
+			prvCheckPriority( cmCEILING_PRIORITY );
+
+			if( xSemaphoreGiveCeiling( xCeilingMutex ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			prvCheckPriority( cmMEDIUM_PRIORITY );
+		}
+
+		uxMediumCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPriority( UBaseType_t uxExpectedPriority )
+{
+	#if( INCLUDE_uxTaskPriorityGet == 1 )
+	{
+		if( uxTaskPriorityGet( NULL ) != uxExpectedPriority )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	#else
+	{
+		( void ) uxExpectedPriority;
+	}
+	#endif /* INCLUDE_uxTaskPriorityGet */
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeMutex( SemaphoreHandle_t xMutex, BaseType_t xCeiling )
+{
+uint32_t ulStartTime, ul;
+
+	ulStartTime = configBENCHMARK_GET_TIME();
+
+	for( ul = 0; ul < cmBENCHMARK_ITERATIONS; ul++ )
+	{
+		if( xCeiling != pdFALSE )
+		{
+			if( xSemaphoreTakeCeiling( xMutex, cmNO_DELAY ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xSemaphoreGiveCeiling( xMutex ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+		else
+		{
+			if( xSemaphoreTake( xMutex, cmNO_DELAY ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xSemaphoreGive( xMutex ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+	}
+
+	return configBENCHMARK_GET_TIME() - ulStartTime;
+}
+/*-----------------------------------------------------------*/
+
+void vGetCeilingMutexBenchmarkResults( uint32_t *pulStandardMutexTime, uint32_t *pulGenericCeilingMutexTime, uint32_t *pulCeilingMutexTime )
+{
+	*pulStandardMutexTime = ulStandardMutexTime;
+	*pulGenericCeilingMutexTime = ulGenericCeilingMutexTime;
+	*pulCeilingMutexTime = ulCeilingMutexTime;
+}
+/*-----------------------------------------------------------*/
+
+/* This is called to check that all the created tasks are still running. */
+BaseType_t xAreCeilingMutexTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastLowCycles = 0, uxLastMediumCycles = 0;
+
+	if( uxLastLowCycles == uxLowCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxLastMediumCycles == uxMediumCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastLowCycles = uxLowCycles;
+	uxLastMediumCycles = uxMediumCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_CEILING_MUTEXES == 1 */
@@ -0,0 +1,568 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests co-routines hosted by a task that calls vCoRoutineScheduleOrBlock(),
+	and measures the heap used per connection when a protocol is implemented as
+	one co-routine per connection rather than one task per connection.
+
+	prvCoRoutineHostTask() creates crbNUM_CONNECTIONS connection co-routines,
+	recording the heap used per co-routine, then creates and deletes one task
+	with the stack a task per connection would need, recording the heap it
+	used.  It then creates the co-routines described below and runs all the
+	co-routines for ever.  The host task has a priority above most of the demo
+	tasks, so the demo only keeps running if the host task blocks whenever no
+	co-routine is ready.
+
+	prvDriverTask() cycles through three steps:
+
+	1) Notifies every connection co-routine with a request number using
+	   xCoRoutineNotify(), then checks each co-routine received its request.
+	   Each connection waits in crNOTIFY_WAIT() with a timeout shorter than the
+	   cycle, so notifications also arrive while co-routines are timing out.
+
+	2) Writes a message to a stream buffer read by prvEchoCoRoutine(), which
+	   increments each byte and writes it to a second stream buffer that is
+	   smaller than the message - so the co-routine also has to block waiting
+	   for space - then checks the bytes it reads back.
+
+	3) Sets one of the two bits prvEventGroupCoRoutine() waits for, checks the
+	   co-routine does not respond, sets the other, then waits for the bit the
+	   co-routine sets in response.
+
+	vCoRoutineBenchPeriodicISRTest() is called from the tick hook, and
+	periodically notifies prvTickCoRoutine() with xCoRoutineNotifyFromISR().
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "croutine.h"
+#include "stream_buffer.h"
+#include "event_groups.h"
+
+/* Demo app include files. */
+#include "CoRoutineBench.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( ( configUSE_CO_ROUTINES == 1 ) && ( configUSE_TASK_NOTIFICATIONS == 1 ) )
+
+/* The number of connection co-routines.  A real application would use
+thousands - the default is kept small enough to fit alongside all the other
+demo tasks. */
+#ifndef crbNUM_CONNECTIONS
+	#define crbNUM_CONNECTIONS				( 256 )
+#endif
+
+#ifndef crbCONNECTION_TASK_STACK_SIZE
+	#define crbCONNECTION_TASK_STACK_SIZE	configMINIMAL_STACK_SIZE
+#endif
+
+#ifndef crbHOST_TASK_STACK_SIZE
+	#define crbHOST_TASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+#endif
+
+/* Task and co-routine priorities. */
+#define crbHOST_PRIORITY				( tskIDLE_PRIORITY + 2 )
+#define crbDRIVER_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define crbCONNECTION_PRIORITY			( 0 )
+#define crbSERVICE_PRIORITY				( 1 )
+
+/* Block times. */
+#define crbCYCLE_DELAY					pdMS_TO_TICKS( 20 )
+#define crbCONNECTION_TIMEOUT			pdMS_TO_TICKS( 15 )
+#define crbSERVICE_TIMEOUT				pdMS_TO_TICKS( 100 )
+#define crbSHORT_DELAY					pdMS_TO_TICKS( 5 )
+
+/* Step 2 sends a message that is larger than the response stream buffer. */
+#define crbMESSAGE_LENGTH				( 16 )
+#define crbREQUEST_STREAM_SIZE			( crbMESSAGE_LENGTH * 2 )
+#define crbRESPONSE_STREAM_SIZE			( crbMESSAGE_LENGTH / 2 )
+
+/* Step 3 event bits. */
+#define crbREQUEST_BIT_0				( ( EventBits_t ) 0x01 )
+#define crbREQUEST_BIT_1				( ( EventBits_t ) 0x02 )
+#define crbREQUEST_BITS					( crbREQUEST_BIT_0 | crbREQUEST_BIT_1 )
+#define crbRESPONSE_BIT					( ( EventBits_t ) 0x04 )
+
+/* The number of ticks between notifications sent from the tick hook. */
+#define crbISR_PERIOD					( 10 )
+
+#define crbALL_BITS						( 0xffffffffUL )
+
+/* The tasks and co-routines described at the top of this file. */
+static void prvCoRoutineHostTask( void *pvParameters );
+static void prvDriverTask( void *pvParameters );
+static void prvConnectionCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex );
+static void prvEchoCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex );
+static void prvEventGroupCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex );
+static void prvTickCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex );
+
+/*
+ * The task created to measure the heap used by one task per connection.  It
+ * is deleted before it gets to run.
+ */
+static void prvConnectionTask( void *pvParameters );
+
+/*
+ * The three steps performed by prvDriverTask().
+ */
+static BaseType_t prvNotifyConnections( uint32_t ulRequest );
+static BaseType_t prvEchoMessage( uint32_t ulRequest );
+static BaseType_t prvWaitForEventGroupResponse( void );
+
+/*-----------------------------------------------------------*/
+
+/* Handles the connection co-routines store so the driver task can notify
+them, and the requests they received.  Co-routines do not maintain their stack,
+so variables used across a blocking call are indexed by uxIndex rather than
+declared locally. */
+static volatile CoRoutineHandle_t xConnections[ crbNUM_CONNECTIONS ] = { NULL };
+static uint32_t ulRequests[ crbNUM_CONNECTIONS ] = { 0 };
+static volatile uint32_t ulResponses[ crbNUM_CONNECTIONS ] = { 0 };
+
+/* The handle of prvTickCoRoutine(), and the notifications it received. */
+static volatile CoRoutineHandle_t xTickCoRoutine = NULL;
+static volatile uint32_t ulISRNotifications = 0UL;
+
+static StreamBufferHandle_t xRequestStream = NULL, xResponseStream = NULL;
+static EventGroupHandle_t xEventGroup = NULL;
+
+/* The heap used per connection, as measured by the host task. */
+static size_t xCoRoutineBytes = 0, xTaskBytes = 0;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxDriverCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartCoRoutineBenchTasks( void )
+{
+	xRequestStream = xStreamBufferCreate( crbREQUEST_STREAM_SIZE, 1 );
+	xResponseStream = xStreamBufferCreate( crbRESPONSE_STREAM_SIZE, 1 );
+	xEventGroup = xEventGroupCreate();
+
+	if( ( xRequestStream != NULL ) && ( xResponseStream != NULL ) && ( xEventGroup != NULL ) )
+	{
+		xTaskCreate( prvCoRoutineHostTask, "CRHost", crbHOST_TASK_STACK_SIZE, NULL, crbHOST_PRIORITY, NULL );
+		xTaskCreate( prvDriverTask, "CRDrive", configMINIMAL_STACK_SIZE, NULL, crbDRIVER_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCoRoutineHostTask( void *pvParameters )
+{
+size_t xFreeHeap;
+TaskHandle_t xTask = NULL;
+UBaseType_t uxIndex;
+
+	( void ) pvParameters;
+
+	/* Keep other tasks from allocating memory during the measurements. */
+	vTaskSuspendAll();
+	{
+		xFreeHeap = xPortGetFreeHeapSize();
+
+		for( uxIndex = 0; uxIndex < crbNUM_CONNECTIONS; uxIndex++ )
+		{
+			if( xCoRoutineCreate( prvConnectionCoRoutine, crbCONNECTION_PRIORITY, uxIndex ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		xCoRoutineBytes = ( xFreeHeap - xPortGetFreeHeapSize() ) / ( size_t ) crbNUM_CONNECTIONS;
+
+		/* The same measurement for a task, which needs its own stack. */
+		xFreeHeap = xPortGetFreeHeapSize();
+
+		if( xTaskCreate( prvConnectionTask, "CRBConn", crbCONNECTION_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, &xTask ) == pdPASS )
+		{
+			xTaskBytes = xFreeHeap - xPortGetFreeHeapSize();
+		}
+		else
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	if( xTask != NULL )
+	{
+		vTaskDelete( xTask );
+	}
+
+	if( xCoRoutineCreate( prvEchoCoRoutine, crbSERVICE_PRIORITY, 0 ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xCoRoutineCreate( prvEventGroupCoRoutine, crbSERVICE_PRIORITY, 0 ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xCoRoutineCreate( prvTickCoRoutine, crbSERVICE_PRIORITY, 0 ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	for( ;; )
+	{
+		vCoRoutineScheduleOrBlock();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvConnectionTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vTaskSuspend( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvConnectionCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+BaseType_t xResult;
+
+	/* Publish the handle so the driver task can notify this connection. */
+	xConnections[ uxIndex ] = xHandle;
+
+	crSTART( xHandle );
+
+	for( ;; )
+	{
+		crNOTIFY_WAIT( xHandle, 0UL, crbALL_BITS, &( ulRequests[ uxIndex ] ), crbCONNECTION_TIMEOUT, &xResult );
+
+		if( xResult == pdPASS )
+		{
+			ulResponses[ uxIndex ] = ulRequests[ uxIndex ];
+		}
+	}
+
+	crEND();
+}
+/*-----------------------------------------------------------*/
+
+static void prvEchoCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+static uint8_t ucBuffer[ crbMESSAGE_LENGTH ];
+static size_t xReceived, xSent, xOffset;
+BaseType_t xResult;
+
+	( void ) uxIndex;
+
+	crSTART( xHandle );
+
+	for( ;; )
+	{
+		crSTREAM_BUFFER_RECEIVE( xHandle, xRequestStream, ucBuffer, sizeof( ucBuffer ), &xReceived, crbSERVICE_TIMEOUT, &xResult );
+
+		if( xResult == pdPASS )
+		{
+			for( xOffset = 0; xOffset < xReceived; xOffset++ )
+			{
+				ucBuffer[ xOffset ]++;
+			}
+
+			/* The response stream buffer is smaller than a message, so this
+			blocks until the driver task has read the first part. */
+			xOffset = 0;
+			while( xOffset < xReceived )
+			{
+				crSTREAM_BUFFER_SEND( xHandle, xResponseStream, &( ucBuffer[ xOffset ] ), xReceived - xOffset, &xSent, crbSERVICE_TIMEOUT, &xResult );
+
+				if( xResult == pdPASS )
+				{
+					xOffset += xSent;
+				}
+				else
+				{
+					/* The driver task stopped reading. */
+					xErrorOccurred = pdTRUE;
+					xOffset = xReceived;
+				}
+			}
+		}
+	}
+
+	crEND();
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventGroupCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+static EventBits_t uxBits;
+BaseType_t xResult;
+
+	( void ) uxIndex;
+
+	crSTART( xHandle );
+
+	for( ;; )
+	{
+		/* Wait for both request bits, clearing them on exit. */
+		crEVENT_GROUP_WAIT_BITS( xHandle, xEventGroup, crbREQUEST_BITS, pdTRUE, pdTRUE, &uxBits, crbSERVICE_TIMEOUT, &xResult );
+
+		if( xResult == pdPASS )
+		{
+			if( ( uxBits & crbREQUEST_BITS ) != crbREQUEST_BITS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			( void ) xEventGroupSetBits( xEventGroup, crbRESPONSE_BIT );
+		}
+	}
+
+	crEND();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+static uint32_t ulValue;
+BaseType_t xResult;
+
+	( void ) uxIndex;
+	xTickCoRoutine = xHandle;
+
+	crSTART( xHandle );
+
+	for( ;; )
+	{
+		crNOTIFY_WAIT( xHandle, 0UL, crbALL_BITS, &ulValue, crbSERVICE_TIMEOUT, &xResult );
+
+		if( xResult == pdPASS )
+		{
+			ulISRNotifications += ulValue;
+		}
+	}
+
+	crEND();
+}
+/*-----------------------------------------------------------*/
+
+static void prvDriverTask( void *pvParameters )
+{
+uint32_t ulRequest = 0UL;
+
+	( void ) pvParameters;
+
+	/* Give the host task time to create the co-routines, and each connection
+	co-routine time to publish its handle. */
+	vTaskDelay( crbCYCLE_DELAY );
+
+	for( ;; )
+	{
+		ulRequest++;
+
+		if( prvNotifyConnections( ulRequest ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvEchoMessage( ulRequest ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvWaitForEventGroupResponse() != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxDriverCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvNotifyConnections( uint32_t ulRequest )
+{
+UBaseType_t uxIndex;
+BaseType_t xReturn = pdPASS;
+
+	for( uxIndex = 0; uxIndex < crbNUM_CONNECTIONS; uxIndex++ )
+	{
+		if( xConnections[ uxIndex ] == NULL )
+		{
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			( void ) xCoRoutineNotify( xConnections[ uxIndex ], ulRequest + ( uint32_t ) uxIndex, eSetValueWithOverwrite );
+		}
+	}
+
+	/* Every connection should respond well within the cycle. */
+	vTaskDelay( crbCYCLE_DELAY );
+
+	for( uxIndex = 0; uxIndex < crbNUM_CONNECTIONS; uxIndex++ )
+	{
+		if( ulResponses[ uxIndex ] != ( ulRequest + ( uint32_t ) uxIndex ) )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvEchoMessage( uint32_t ulRequest )
+{
+uint8_t ucMessage[ crbMESSAGE_LENGTH ], ucResponse[ crbMESSAGE_LENGTH ];
+size_t xReceived = 0, xBytes, xByte;
+BaseType_t xReturn = pdPASS;
+
+	for( xByte = 0; xByte < crbMESSAGE_LENGTH; xByte++ )
+	{
+		ucMessage[ xByte ] = ( uint8_t ) ( ulRequest + xByte );
+	}
+
+	if( xStreamBufferSend( xRequestStream, ucMessage, sizeof( ucMessage ), crbSERVICE_TIMEOUT ) != sizeof( ucMessage ) )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		/* The response arrives in at least two parts. */
+		while( xReceived < sizeof( ucResponse ) )
+		{
+			xBytes = xStreamBufferReceive( xResponseStream, &( ucResponse[ xReceived ] ), sizeof( ucResponse ) - xReceived, crbSERVICE_TIMEOUT );
+
+			if( xBytes == ( size_t ) 0 )
+			{
+				xReturn = pdFAIL;
+				break;
+			}
+
+			xReceived += xBytes;
+		}
+
+		for( xByte = 0; xByte < xReceived; xByte++ )
+		{
+			if( ucResponse[ xByte ] != ( uint8_t ) ( ucMessage[ xByte ] + 1U ) )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitForEventGroupResponse( void )
+{
+EventBits_t uxBits;
+BaseType_t xReturn = pdPASS;
+
+	/* The co-routine waits for both request bits, so must not respond to
+	one. */
+	( void ) xEventGroupSetBits( xEventGroup, crbREQUEST_BIT_0 );
+	uxBits = xEventGroupWaitBits( xEventGroup, crbRESPONSE_BIT, pdTRUE, pdFALSE, crbSHORT_DELAY );
+
+	if( ( uxBits & crbRESPONSE_BIT ) != ( EventBits_t ) 0 )
+	{
+		xReturn = pdFAIL;
+	}
+
+	( void ) xEventGroupSetBits( xEventGroup, crbREQUEST_BIT_1 );
+	uxBits = xEventGroupWaitBits( xEventGroup, crbRESPONSE_BIT, pdTRUE, pdFALSE, crbSERVICE_TIMEOUT );
+
+	if( ( uxBits & crbRESPONSE_BIT ) == ( EventBits_t ) 0 )
+	{
+		xReturn = pdFAIL;
+	}
+
+	/* The co-routine cleared the request bits on exit. */
+	if( ( xEventGroupGetBits( xEventGroup ) & crbREQUEST_BITS ) != ( EventBits_t ) 0 )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vCoRoutineBenchPeriodicISRTest( void )
+{
+static UBaseType_t uxTicks = 0;
+
+	uxTicks++;
+
+	if( ( uxTicks >= crbISR_PERIOD ) && ( xTickCoRoutine != NULL ) )
+	{
+		uxTicks = 0;
+		( void ) xCoRoutineNotifyFromISR( xTickCoRoutine, 1UL, eIncrement, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vGetCoRoutineBenchmarkResults( size_t *pxCoRoutineBytes, size_t *pxTaskBytes )
+{
+	*pxCoRoutineBytes = xCoRoutineBytes;
+	*pxTaskBytes = xTaskBytes;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreCoRoutineBenchTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastDriverCycles = 0;
+static uint32_t ulLastISRNotifications = 0UL;
+
+	if( uxLastDriverCycles == uxDriverCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastDriverCycles = uxDriverCycles;
+
+	if( ulLastISRNotifications == ulISRNotifications )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	ulLastISRNotifications = ulISRNotifications;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_CO_ROUTINES */
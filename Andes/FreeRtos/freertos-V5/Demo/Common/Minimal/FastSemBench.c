@@ -0,0 +1,299 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the fast semaphore type, and measures the cost of an uncontended
+	take/give pair on a fast mutex against the cost of the same on a standard
+	mutex.
+
+	prvBenchmarkTask() times fbBENCHMARK_ITERATIONS take/give pairs on each
+	type of mutex using configBENCHMARK_GET_TIME(), and stores the results so
+	they can be retrieved by vGetFastSemaphoreBenchmarkResults().  It then
+	checks that a fast mutex cannot be given past its maximum count and cannot
+	be taken twice, before giving xFastSemaphore to exercise the contended path.
+
+	prvBlockingTask() has a priority above the benchmark task and blocks on
+	xFastSemaphore, which is initially empty, so must preempt the benchmark
+	task as soon as the semaphore is given.  It then blocks on the semaphore
+	again with a timeout, during which the semaphore is not given, to check a
+	task that times out is correctly removed from the semaphore's count.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo app include files. */
+#include "FastSemBench.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+/* Priorities of the tasks described at the top of this file. */
+#define fbBENCHMARK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define fbBLOCKING_PRIORITY			( tskIDLE_PRIORITY + 2 )
+
+/* The number of take/give pairs timed on each mutex type. */
+#define fbBENCHMARK_ITERATIONS		( 1000UL )
+
+/* Misc. */
+#define fbFAST_SEMAPHORE_MAX_COUNT	( ( UBaseType_t ) 5 )
+#define fbTIMEOUT					pdMS_TO_TICKS( 10 )
+#define fbCYCLE_DELAY				pdMS_TO_TICKS( 50 )
+#define fbNO_DELAY					( ( TickType_t ) 0 )
+
+#ifndef fbFAST_SEMAPHORE_TEST_TASK_STACK_SIZE
+	#define fbFAST_SEMAPHORE_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* configBENCHMARK_GET_TIME() can be defined in FreeRTOSConfig.h to return a
+free running counter with a higher resolution than the tick count, such as a
+cycle counter. */
+#ifndef configBENCHMARK_GET_TIME
+	#define configBENCHMARK_GET_TIME() ( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+/* The tasks as described at the top of this file. */
+static void prvBenchmarkTask( void *pvParameters );
+static void prvBlockingTask( void *pvParameters );
+
+/*
+ * Time fbBENCHMARK_ITERATIONS take/give pairs on xMutex, using the fast
+ * semaphore API if xFast is pdTRUE.
+ */
+static uint32_t prvTimeMutex( SemaphoreHandle_t xMutex, BaseType_t xFast );
+
+/*-----------------------------------------------------------*/
+
+/* The semaphores used by the demo.  xFastMutex is statically allocated if
+configSUPPORT_STATIC_ALLOCATION is 1. */
+static SemaphoreHandle_t xStandardMutex = NULL, xFastMutex = NULL, xFastSemaphore = NULL;
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	static StaticSemaphore_t xFastMutexBuffer;
+#endif
+
+/* The most recent benchmark results. */
+static volatile uint32_t ulStandardMutexTime = 0, ulFastMutexTime = 0;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxBenchmarkCycles = 0, uxBlockingCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartFastSemaphoreBenchmarkTasks( void )
+{
+	xStandardMutex = xSemaphoreCreateMutex();
+	xFastSemaphore = xSemaphoreCreateFast( fbFAST_SEMAPHORE_MAX_COUNT, 0 );
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		xFastMutex = xSemaphoreCreateFastMutexStatic( &xFastMutexBuffer );
+	}
+	#else
+	{
+		xFastMutex = xSemaphoreCreateFastMutex();
+	}
+	#endif
+
+	if( ( xStandardMutex != NULL ) && ( xFastMutex != NULL ) && ( xFastSemaphore != NULL ) )
+	{
+		vQueueAddToRegistry( ( QueueHandle_t ) xFastMutex, "Fast_Mutex" );
+		vQueueAddToRegistry( ( QueueHandle_t ) xFastSemaphore, "Fast_Sem" );
+
+		xTaskCreate( prvBenchmarkTask, "FastBench", fbFAST_SEMAPHORE_TEST_TASK_STACK_SIZE, NULL, fbBENCHMARK_PRIORITY, NULL );
+		xTaskCreate( prvBlockingTask, "FastBlock", fbFAST_SEMAPHORE_TEST_TASK_STACK_SIZE, NULL, fbBLOCKING_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeMutex( SemaphoreHandle_t xMutex, BaseType_t xFast )
+{
+uint32_t ulStartTime, ul;
+
+	ulStartTime = configBENCHMARK_GET_TIME();
+
+	for( ul = 0; ul < fbBENCHMARK_ITERATIONS; ul++ )
+	{
+		if( xFast != pdFALSE )
+		{
+			if( xSemaphoreTakeFast( xMutex, fbNO_DELAY ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xSemaphoreGiveFast( xMutex ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+		else
+		{
+			if( xSemaphoreTake( xMutex, fbNO_DELAY ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xSemaphoreGive( xMutex ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+	}
+
+	return configBENCHMARK_GET_TIME() - ulStartTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+UBaseType_t uxBlockingCyclesOnEntry;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulStandardMutexTime = prvTimeMutex( xStandardMutex, pdFALSE );
+		ulFastMutexTime = prvTimeMutex( xFastMutex, pdTRUE );
+
+		/* The fast mutex is available, so cannot be given again. */
+		if( xSemaphoreGiveFast( xFastMutex ) != errQUEUE_FULL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Take the fast mutex, after which it cannot be taken again. */
+		if( xSemaphoreTakeFast( xFastMutex, fbNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xSemaphoreTakeFast( xFastMutex, fbNO_DELAY ) != pdFAIL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xSemaphoreGiveFast( xFastMutex ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* The blocking task is waiting for xFastSemaphore, so giving the
+		semaphore must unblock it, and as it has the higher priority it must
+		run before the give function returns. */
+		uxBlockingCyclesOnEntry = uxBlockingCycles;
+
+		if( xSemaphoreGiveFast( xFastSemaphore ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( uxBlockingCycles != ( uxBlockingCyclesOnEntry + ( UBaseType_t ) 1 ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Don't give the semaphore again until the blocking task's timed
+		take has expired. */
+		uxBenchmarkCycles++;
+		vTaskDelay( fbCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockingTask( void *pvParameters )
+{
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait to be given the semaphore by the benchmark task. */
+		if( xSemaphoreTakeFast( xFastSemaphore, portMAX_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxBlockingCycles++;
+
+		/* The semaphore is not given again until this timed take has
+		expired. */
+		if( xSemaphoreTakeFast( xFastSemaphore, fbTIMEOUT ) != pdFAIL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Timing out must have removed this task from the semaphore's count,
+		so the semaphore is still empty rather than owing this task a wake
+		up. */
+		if( xSemaphoreTakeFast( xFastSemaphore, fbNO_DELAY ) != pdFAIL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vGetFastSemaphoreBenchmarkResults( uint32_t *pulStandardMutexTime, uint32_t *pulFastMutexTime )
+{
+	*pulStandardMutexTime = ulStandardMutexTime;
+	*pulFastMutexTime = ulFastMutexTime;
+}
+/*-----------------------------------------------------------*/
+
+/* This is called to check that all the created tasks are still running. */
+BaseType_t xAreFastSemaphoreBenchmarkTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastBenchmarkCycles = 0, uxLastBlockingCycles = 0;
+
+	if( uxLastBenchmarkCycles == uxBenchmarkCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxLastBlockingCycles == uxBlockingCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastBenchmarkCycles = uxBenchmarkCycles;
+	uxLastBlockingCycles = uxBlockingCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_FAST_SEMAPHORES == 1 */
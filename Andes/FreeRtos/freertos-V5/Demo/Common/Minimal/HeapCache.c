@@ -0,0 +1,303 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the per-task heap caches included in the build when
+	configUSE_TASK_HEAP_CACHE is set to 1.
+
+	hcNUM_TASKS instances of prvHeapCacheTask() run at the same priority, so
+	they continually preempt each other while allocating and freeing memory.
+	Each cycle every task:
+
+	1) Allocates configHEAP_CACHE_DEPTH small blocks, which empties its cache of
+	   blocks of that size, then frees them all again, which fills the cache.
+	   The cache is private to the task and is used most recently freed first,
+	   so allocating the same number of blocks again must return the same
+	   blocks in reverse order whatever the other tasks are doing.
+
+	2) Allocates blocks of a range of sizes, some of which are too large to be
+	   cached, writes a pattern unique to the task and the block into each,
+	   checks the patterns, then frees the blocks in a different order.
+
+	3) The first task also creates a task that fills its own cache and then
+	   deletes itself, so the blocks held in its cache are returned to the heap
+	   when the idle task frees its TCB.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo app include files. */
+#include "HeapCache.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+
+/* The number of tasks described at the top of this file, and their
+priority. */
+#define hcNUM_TASKS					( 2 )
+#define hcTEST_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/* A request this small always fits in the smallest size class, as the block
+header is at least two pointers in size. */
+#define hcSMALL_SIZE				( sizeof( void * ) )
+
+/* The number of blocks allocated in step 2 of each cycle. */
+#define hcNUM_BLOCKS				( 8 )
+
+/* The number of cycles the first task executes between creating tasks that
+delete themselves. */
+#define hcCYCLES_PER_CREATE			( 8 )
+
+#define hcCYCLE_DELAY				pdMS_TO_TICKS( 10 )
+
+#ifndef hcHEAP_CACHE_TEST_TASK_STACK_SIZE
+	#define hcHEAP_CACHE_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The tasks described at the top of this file. */
+static void prvHeapCacheTask( void *pvParameters );
+static void prvSelfDeletingTask( void *pvParameters );
+
+/*
+ * Check blocks freed to the calling task's cache are reused most recently
+ * freed first.
+ */
+static BaseType_t prvCheckCacheReuse( void );
+
+/*
+ * Allocate, fill, check and free blocks of a range of sizes.  ulPattern
+ * identifies the calling task.
+ */
+static BaseType_t prvAllocateAndCheckBlocks( uint32_t ulPattern );
+
+/*-----------------------------------------------------------*/
+
+/* Sizes allocated in step 2 of each cycle.  The larger sizes are not cached
+with the default configuration. */
+static const size_t xBlockSizes[ hcNUM_BLOCKS ] = { 1, 8, 20, 33, 48, 64, 100, 260 };
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxCycles[ hcNUM_TASKS ] = { 0 };
+
+/*-----------------------------------------------------------*/
+
+void vStartHeapCacheTasks( void )
+{
+UBaseType_t uxTask;
+
+	for( uxTask = 0; uxTask < hcNUM_TASKS; uxTask++ )
+	{
+		xTaskCreate( prvHeapCacheTask, "HeapCache", hcHEAP_CACHE_TEST_TASK_STACK_SIZE, ( void * ) uxTask, hcTEST_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapCacheTask( void *pvParameters )
+{
+const UBaseType_t uxTask = ( UBaseType_t ) pvParameters;
+
+	for( ;; )
+	{
+		if( prvCheckCacheReuse() != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvAllocateAndCheckBlocks( ( uint32_t ) uxTask ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( ( uxTask == 0 ) && ( ( uxCycles[ uxTask ] % hcCYCLES_PER_CREATE ) == 0 ) )
+		{
+			xTaskCreate( prvSelfDeletingTask, "HCDelete", hcHEAP_CACHE_TEST_TASK_STACK_SIZE, ( void * ) hcNUM_TASKS, hcTEST_PRIORITY, NULL );
+		}
+
+		uxCycles[ uxTask ]++;
+		vTaskDelay( hcCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSelfDeletingTask( void *pvParameters )
+{
+	/* Fill this task's cache so there are blocks to return to the heap when
+	the task is deleted. */
+	if( prvCheckCacheReuse() != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( prvAllocateAndCheckBlocks( ( uint32_t ) ( UBaseType_t ) pvParameters ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckCacheReuse( void )
+{
+void *pvBlocks[ configHEAP_CACHE_DEPTH ];
+void *pvBlock;
+UBaseType_t uxBlock;
+BaseType_t xReturn = pdPASS;
+
+	/* Empty the cache of small blocks. */
+	for( uxBlock = 0; uxBlock < configHEAP_CACHE_DEPTH; uxBlock++ )
+	{
+		pvBlocks[ uxBlock ] = pvPortMalloc( hcSMALL_SIZE );
+
+		if( pvBlocks[ uxBlock ] == NULL )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	if( xReturn == pdPASS )
+	{
+		/* Refill it. */
+		for( uxBlock = 0; uxBlock < configHEAP_CACHE_DEPTH; uxBlock++ )
+		{
+			vPortFree( pvBlocks[ uxBlock ] );
+		}
+
+		/* The blocks must come back in the reverse order. */
+		for( uxBlock = configHEAP_CACHE_DEPTH; uxBlock > 0; uxBlock-- )
+		{
+			pvBlock = pvPortMalloc( hcSMALL_SIZE );
+
+			if( pvBlock != pvBlocks[ uxBlock - 1 ] )
+			{
+				xReturn = pdFAIL;
+			}
+
+			pvBlocks[ uxBlock - 1 ] = pvBlock;
+		}
+	}
+
+	/* Leave the blocks in the cache. */
+	for( uxBlock = 0; uxBlock < configHEAP_CACHE_DEPTH; uxBlock++ )
+	{
+		vPortFree( pvBlocks[ uxBlock ] );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAllocateAndCheckBlocks( uint32_t ulPattern )
+{
+uint8_t *pucBlocks[ hcNUM_BLOCKS ];
+UBaseType_t uxBlock;
+size_t xByte;
+uint8_t ucValue;
+BaseType_t xReturn = pdPASS;
+
+	for( uxBlock = 0; uxBlock < hcNUM_BLOCKS; uxBlock++ )
+	{
+		pucBlocks[ uxBlock ] = ( uint8_t * ) pvPortMalloc( xBlockSizes[ uxBlock ] );
+
+		if( pucBlocks[ uxBlock ] != NULL )
+		{
+			ucValue = ( uint8_t ) ( ( ulPattern << 4 ) + uxBlock );
+			for( xByte = 0; xByte < xBlockSizes[ uxBlock ]; xByte++ )
+			{
+				pucBlocks[ uxBlock ][ xByte ] = ucValue;
+			}
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	/* Let the other tasks run so a block shared with another task would be
+	detected. */
+	taskYIELD();
+
+	for( uxBlock = 0; uxBlock < hcNUM_BLOCKS; uxBlock++ )
+	{
+		if( pucBlocks[ uxBlock ] != NULL )
+		{
+			ucValue = ( uint8_t ) ( ( ulPattern << 4 ) + uxBlock );
+			for( xByte = 0; xByte < xBlockSizes[ uxBlock ]; xByte++ )
+			{
+				if( pucBlocks[ uxBlock ][ xByte ] != ucValue )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+		}
+	}
+
+	/* Free the odd blocks then the even blocks so the order differs from the
+	order of allocation. */
+	for( uxBlock = 1; uxBlock < hcNUM_BLOCKS; uxBlock += 2 )
+	{
+		vPortFree( pucBlocks[ uxBlock ] );
+	}
+
+	for( uxBlock = 0; uxBlock < hcNUM_BLOCKS; uxBlock += 2 )
+	{
+		vPortFree( pucBlocks[ uxBlock ] );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreHeapCacheTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+UBaseType_t uxTask;
+static UBaseType_t uxLastCycles[ hcNUM_TASKS ] = { 0 };
+
+	for( uxTask = 0; uxTask < hcNUM_TASKS; uxTask++ )
+	{
+		if( uxLastCycles[ uxTask ] == uxCycles[ uxTask ] )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxLastCycles[ uxTask ] = uxCycles[ uxTask ];
+	}
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_TASK_HEAP_CACHE == 1 */
@@ -0,0 +1,315 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the heap allocation tracking included in the build when
+	configUSE_HEAP_TRACKING is set to 1.
+
+	Each cycle prvHeapTrackingTask() reads the allocation sequence number,
+	allocates htNUM_BLOCKS blocks, then checks that exactly those blocks are
+	listed by uxPortGetHeapAllocations() as owned by the task and allocated
+	since the sequence number was read - with the sizes requested, a caller
+	address, and sequence numbers in the order the blocks were allocated.  Other
+	tasks allocate and free memory at the same time, so only blocks owned by
+	this task are considered.  Once the blocks are freed none must be listed,
+	which is the leak check the tracking is intended for.
+
+	The histograms must count the allocations, and a dump written by
+	xHeapTrackingDump() must have a valid header.
+*/
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_tracking.h"
+
+/* Demo app include files. */
+#include "HeapTracking.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_HEAP_TRACKING == 1 )
+
+#define htTEST_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/* The number of blocks allocated each cycle, the size of the smallest, and the
+amount by which each block is larger than the one before. */
+#define htNUM_BLOCKS				( 3 )
+#define htFIRST_BLOCK_SIZE			( 150 )
+#define htBLOCK_SIZE_INCREMENT		( 20 )
+
+/* The size histogram bucket that counts every block size allocated - bucket n
+counts sizes from 2^n to ( 2^( n + 1 ) ) - 1. */
+#define htSIZE_BUCKET				( 7 )
+
+/* The number of blocks read from the heap at a time. */
+#define htBATCH_SIZE				( 4 )
+
+/* Large enough to hold the header and statistics of a dump, and a few
+blocks. */
+#define htDUMP_BUFFER_SIZE			( 512 )
+
+#define htCYCLE_DELAY				pdMS_TO_TICKS( 20 )
+
+#ifndef htHEAP_TRACKING_TEST_TASK_STACK_SIZE
+	#define htHEAP_TRACKING_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The task described at the top of this file. */
+static void prvHeapTrackingTask( void *pvParameters );
+
+/*
+ * Write to pxAllocations the blocks owned by the calling task and allocated
+ * since ulFromSequence, in the order they were allocated, and return the
+ * number of blocks found.  At most uxArraySize blocks are written, but every
+ * block is counted.
+ */
+static UBaseType_t prvGetOwnAllocations( HeapAllocation_t *pxAllocations, UBaseType_t uxArraySize, uint32_t ulFromSequence );
+
+/*
+ * Check the header of a dump.
+ */
+static BaseType_t prvCheckDump( void );
+
+/*-----------------------------------------------------------*/
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxCycles = 0;
+
+/* Written by xHeapTrackingDump(). */
+static uint8_t ucDumpBuffer[ htDUMP_BUFFER_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+void vStartHeapTrackingTasks( void )
+{
+	xTaskCreate( prvHeapTrackingTask, "HeapTrack", htHEAP_TRACKING_TEST_TASK_STACK_SIZE, NULL, htTEST_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapTrackingTask( void *pvParameters )
+{
+void *pvBlocks[ htNUM_BLOCKS ];
+HeapAllocation_t xFound[ htNUM_BLOCKS ];
+HeapTrackingStats_t xStatsBefore, xStatsAfter;
+uint32_t ulMark;
+UBaseType_t uxBlock;
+size_t xSize;
+
+	/* Remove compiler warning about unused parameter. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vHeapTrackingGetStats( &xStatsBefore );
+		ulMark = ulHeapTrackingGetSequence();
+
+		for( uxBlock = 0; uxBlock < htNUM_BLOCKS; uxBlock++ )
+		{
+			pvBlocks[ uxBlock ] = pvPortMalloc( htFIRST_BLOCK_SIZE + ( uxBlock * htBLOCK_SIZE_INCREMENT ) );
+
+			if( pvBlocks[ uxBlock ] == NULL )
+			{
+				/* The heap is never exhausted in this demo.  Nothing can be
+				done safely after this. */
+				xErrorOccurred = pdTRUE;
+				vTaskSuspend( NULL );
+			}
+		}
+
+		/* Exactly the blocks just allocated must be found, in the order they
+		were allocated. */
+		if( prvGetOwnAllocations( xFound, htNUM_BLOCKS, ulMark ) != htNUM_BLOCKS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+		else
+		{
+			for( uxBlock = 0; uxBlock < htNUM_BLOCKS; uxBlock++ )
+			{
+				xSize = htFIRST_BLOCK_SIZE + ( uxBlock * htBLOCK_SIZE_INCREMENT );
+
+				if( ( xFound[ uxBlock ].pvAddress != pvBlocks[ uxBlock ] ) || ( xFound[ uxBlock ].xSize < xSize ) || ( xFound[ uxBlock ].ulSequence < ulMark ) )
+				{
+					xErrorOccurred = pdTRUE;
+				}
+
+				if( ( uxBlock > 0 ) && ( xFound[ uxBlock ].ulSequence <= xFound[ uxBlock - 1 ].ulSequence ) )
+				{
+					xErrorOccurred = pdTRUE;
+				}
+
+				if( xFound[ uxBlock ].pvCaller == NULL )
+				{
+					xErrorOccurred = pdTRUE;
+				}
+			}
+		}
+
+		vHeapTrackingGetStats( &xStatsAfter );
+
+		/* Each block size is counted in the same histogram bucket.  No other
+		task resets the statistics. */
+		if( ( xStatsAfter.ulSizeHistogram[ htSIZE_BUCKET ] - xStatsBefore.ulSizeHistogram[ htSIZE_BUCKET ] ) < ( uint32_t ) htNUM_BLOCKS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( ( xStatsAfter.ulNextSequence - ulMark ) < ( uint32_t ) htNUM_BLOCKS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvCheckDump() != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		for( uxBlock = 0; uxBlock < htNUM_BLOCKS; uxBlock++ )
+		{
+			vPortFree( pvBlocks[ uxBlock ] );
+		}
+
+		/* Nothing has leaked. */
+		if( prvGetOwnAllocations( xFound, htNUM_BLOCKS, ulMark ) != 0 )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxCycles++;
+		vTaskDelay( htCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetOwnAllocations( HeapAllocation_t *pxAllocations, UBaseType_t uxArraySize, uint32_t ulFromSequence )
+{
+HeapAllocation_t xBatch[ htBATCH_SIZE ];
+UBaseType_t uxRead = 0, uxFound = 0, uxBlocks, uxBlock, uxPosition;
+const TaskHandle_t xThisTask = xTaskGetCurrentTaskHandle();
+HeapAllocation_t xTemp;
+
+	/* Stop other tasks allocating or freeing blocks between batches. */
+	vTaskSuspendAll();
+	do
+	{
+		uxBlocks = uxPortGetHeapAllocations( xBatch, htBATCH_SIZE, uxRead, ulFromSequence );
+
+		for( uxBlock = 0; uxBlock < uxBlocks; uxBlock++ )
+		{
+			if( xBatch[ uxBlock ].xOwner == xThisTask )
+			{
+				if( uxFound < uxArraySize )
+				{
+					pxAllocations[ uxFound ] = xBatch[ uxBlock ];
+				}
+
+				uxFound++;
+			}
+		}
+
+		uxRead += uxBlocks;
+	} while( uxBlocks == htBATCH_SIZE );
+	( void ) xTaskResumeAll();
+
+	/* The blocks are listed in address order, so sort them into sequence
+	order. */
+	for( uxBlock = 1; ( uxBlock < uxFound ) && ( uxBlock < uxArraySize ); uxBlock++ )
+	{
+		xTemp = pxAllocations[ uxBlock ];
+
+		for( uxPosition = uxBlock; ( uxPosition > 0 ) && ( pxAllocations[ uxPosition - 1 ].ulSequence > xTemp.ulSequence ); uxPosition-- )
+		{
+			pxAllocations[ uxPosition ] = pxAllocations[ uxPosition - 1 ];
+		}
+
+		pxAllocations[ uxPosition ] = xTemp;
+	}
+
+	return uxFound;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckDump( void )
+{
+uint32_t ulHeader[ 6 ];
+size_t xWritten;
+BaseType_t xReturn = pdPASS;
+
+	xWritten = xHeapTrackingDump( ucDumpBuffer, sizeof( ucDumpBuffer ), 0 );
+
+	if( xWritten < sizeof( ulHeader ) )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		memcpy( ( void * ) ulHeader, ( void * ) ucDumpBuffer, sizeof( ulHeader ) );
+
+		if( ( ulHeader[ 0 ] != heaptrackDUMP_MAGIC ) || ( ulHeader[ 1 ] != heaptrackDUMP_VERSION ) ||
+			( ulHeader[ 2 ] != ( uint32_t ) sizeof( void * ) ) || ( ulHeader[ 3 ] != heaptrackHISTOGRAM_BUCKETS ) )
+		{
+			xReturn = pdFAIL;
+		}
+
+		/* This task holds htNUM_BLOCKS blocks, but the buffer is too small to
+		hold every block in the heap. */
+		if( ( ulHeader[ 5 ] < ( uint32_t ) htNUM_BLOCKS ) || ( ulHeader[ 4 ] > ulHeader[ 5 ] ) )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreHeapTrackingTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastCycles = 0;
+
+	if( uxLastCycles == uxCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastCycles = uxCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_HEAP_TRACKING == 1 */
@@ -0,0 +1,377 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests priority inheritance through a chain of blocked mutex holders, and
+	that a priority is dropped as soon as the mutex it was inherited through is
+	given back, even when other mutexes are still held.
+
+	Four tasks are created:
+
+	prvLowPriorityTask() takes xMutex2 and xMutex3 then wakes the medium
+	priority task.  The medium priority task takes xMutex1 then blocks on
+	xMutex2, so the low priority task inherits the medium priority.  The low
+	priority task then wakes the high priority task, which blocks on xMutex1.
+	The medium priority task holds xMutex1 but is itself blocked on xMutex2, so
+	both the medium and the low priority task must inherit the high priority.
+
+	Before blocking, the high priority task wakes prvSpinnerTask(), which has a
+	priority between the medium and high priorities and does nothing but burn
+	CPU time.  If the priority were only inherited by the immediate holder of
+	xMutex1 then the spinner would prevent the low priority task from running,
+	and so prevent it from giving back xMutex2, for the whole of its spin time.
+	The high priority task measures how long it was blocked on xMutex1 and
+	latches an error if the time exceeds inhcMAX_INVERSION_TIME.
+
+	When the low priority task gives back xMutex2 it still holds xMutex3, which
+	no task is waiting for, so its priority must fall straight back to its base
+	priority.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo app include files. */
+#include "InheritChain.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+#if( configMAX_PRIORITIES < 5 )
+	#error This test needs configMAX_PRIORITIES to be at least 5.
+#endif
+
+/* Priorities of the tasks described at the top of this file. */
+#define inhcLOW_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define inhcMEDIUM_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define inhcSPINNER_PRIORITY		( tskIDLE_PRIORITY + 3 )
+#define inhcHIGH_PRIORITY			( tskIDLE_PRIORITY + 4 )
+
+/* The time the low priority task holds xMutex2 once the high priority task is
+blocked, the time the spinner task burns CPU for, and the longest time the high
+priority task is permitted to wait for xMutex1.  The permitted time is longer
+than the hold time to allow for higher priority demo tasks, and shorter than the
+spin time so a missing inheritance is detected. */
+#define inhcHOLD_TIME				pdMS_TO_TICKS( 2 )
+#define inhcSPIN_TIME				pdMS_TO_TICKS( 50 )
+#define inhcMAX_INVERSION_TIME		pdMS_TO_TICKS( 20 )
+
+/* Misc. */
+#define inhcBLOCK_TIME				pdMS_TO_TICKS( 500 )
+#define inhcCYCLE_DELAY				pdMS_TO_TICKS( 100 )
+#define inhcNO_DELAY				( ( TickType_t ) 0 )
+
+#ifndef inhcINHERIT_CHAIN_TEST_TASK_STACK_SIZE
+	#define inhcINHERIT_CHAIN_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The tasks as described at the top of this file. */
+static void prvLowPriorityTask( void *pvParameters );
+static void prvMediumPriorityTask( void *pvParameters );
+static void prvSpinnerTask( void *pvParameters );
+static void prvHighPriorityTask( void *pvParameters );
+
+/*
+ * Check the priority of the calling task is uxExpectedPriority, latching an
+ * error if not.
+ */
+static void prvCheckPriority( UBaseType_t uxExpectedPriority );
+
+/*-----------------------------------------------------------*/
+
+/* The mutexes used by the demo. */
+static SemaphoreHandle_t xMutex1, xMutex2, xMutex3;
+
+/* Handles of the tasks that are woken by task notifications. */
+static TaskHandle_t xMediumTaskHandle, xSpinnerTaskHandle, xHighTaskHandle;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxLowCycles = 0, uxMediumCycles = 0, uxHighCycles = 0;
+
+/* The longest time the high priority task has waited for xMutex1.  Only
+written, so it can be inspected in the debugger. */
+static volatile TickType_t xMaxInversionTime = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartInheritChainTasks( void )
+{
+	xMutex1 = xSemaphoreCreateMutex();
+	xMutex2 = xSemaphoreCreateMutex();
+	xMutex3 = xSemaphoreCreateMutex();
+
+	if( ( xMutex1 != NULL ) && ( xMutex2 != NULL ) && ( xMutex3 != NULL ) )
+	{
+		vQueueAddToRegistry( ( QueueHandle_t ) xMutex1, "Chain_Mutex1" );
+		vQueueAddToRegistry( ( QueueHandle_t ) xMutex2, "Chain_Mutex2" );
+		vQueueAddToRegistry( ( QueueHandle_t ) xMutex3, "Chain_Mutex3" );
+
+		xTaskCreate( prvLowPriorityTask, "ChLow", inhcINHERIT_CHAIN_TEST_TASK_STACK_SIZE, NULL, inhcLOW_PRIORITY, NULL );
+		xTaskCreate( prvMediumPriorityTask, "ChMed", inhcINHERIT_CHAIN_TEST_TASK_STACK_SIZE, NULL, inhcMEDIUM_PRIORITY, &xMediumTaskHandle );
+		xTaskCreate( prvSpinnerTask, "ChSpin", inhcINHERIT_CHAIN_TEST_TASK_STACK_SIZE, NULL, inhcSPINNER_PRIORITY, &xSpinnerTaskHandle );
+		xTaskCreate( prvHighPriorityTask, "ChHigh", inhcINHERIT_CHAIN_TEST_TASK_STACK_SIZE, NULL, inhcHIGH_PRIORITY, &xHighTaskHandle );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityTask( void *pvParameters )
+{
+TickType_t xTimeOnEntering;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Nothing else uses xMutex2 or xMutex3 at this point. */
+		if( xSemaphoreTake( xMutex2, inhcNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xSemaphoreTake( xMutex3, inhcNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* The medium priority task takes xMutex1 then blocks on xMutex2,
+		causing this task to inherit its priority. */
+		xTaskNotifyGive( xMediumTaskHandle );
+		prvCheckPriority( inhcMEDIUM_PRIORITY );
+
+		/* The high priority task blocks on xMutex1, which is held by the
+		blocked medium priority task.  Its priority must be inherited through
+		the medium priority task by this task. */
+		xTaskNotifyGive( xHighTaskHandle );
+		prvCheckPriority( inhcHIGH_PRIORITY );
+
+		/* Hold xMutex2 for a while.  The spinner task is now ready to run but
+		must not do so as this task has inherited a higher priority. */
+		xTimeOnEntering = xTaskGetTickCount();
+		while( ( xTaskGetTickCount() - xTimeOnEntering ) < inhcHOLD_TIME )
+		{
+			/* Busy wait. */
+		}
+
+		/* Giving xMutex2 unblocks the medium priority task, which in turn
+		gives back xMutex1 to unblock the high priority task.  Both will
+		execute, as will the spinner task, before this task continues. */
+		if( xSemaphoreGive( xMutex2 ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* xMutex3 is still held, but no task is waiting for it, so the
+		inherited priority must already have been dropped. */
+		prvCheckPriority( inhcLOW_PRIORITY );
+
+		if( xSemaphoreGive( xMutex3 ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxLowCycles++;
+		vTaskDelay( inhcCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMediumPriorityTask( void *pvParameters )
+{
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait to be woken by the low priority task. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		if( xSemaphoreTake( xMutex1, inhcNO_DELAY ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* xMutex2 is held by the low priority task, so this blocks. */
+		if( xSemaphoreTake( xMutex2, inhcBLOCK_TIME ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+		else
+		{
+			/* The high priority task is waiting for xMutex1. */
+			prvCheckPriority( inhcHIGH_PRIORITY );
+
+			if( xSemaphoreGive( xMutex2 ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		/* Giving xMutex1 unblocks the high priority task. */
+		if( xSemaphoreGive( xMutex1 ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		prvCheckPriority( inhcMEDIUM_PRIORITY );
+		uxMediumCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpinnerTask( void *pvParameters )
+{
+TickType_t xTimeOnEntering;
+UBaseType_t uxHighCyclesOnEntering;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait to be woken by the high priority task. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		/* Burn CPU time until the high priority task has obtained xMutex1, or
+		the spin time expires.  If inheritance through the chain is working
+		then the high priority task will already have completed its cycle by
+		the time this task runs. */
+		xTimeOnEntering = xTaskGetTickCount();
+		uxHighCyclesOnEntering = uxHighCycles;
+
+		while( ( uxHighCycles == uxHighCyclesOnEntering ) && ( ( xTaskGetTickCount() - xTimeOnEntering ) < inhcSPIN_TIME ) )
+		{
+			/* Busy wait. */
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHighPriorityTask( void *pvParameters )
+{
+TickType_t xTimeOnEntering, xInversionTime;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait to be woken by the low priority task. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		/* Make the spinner task ready.  It has a lower priority than this
+		task so will not run yet. */
+		xTaskNotifyGive( xSpinnerTaskHandle );
+
+		/* xMutex1 is held by the medium priority task, which is blocked on
+		xMutex2, which is held by the low priority task. */
+		xTimeOnEntering = xTaskGetTickCount();
+
+		if( xSemaphoreTake( xMutex1, inhcBLOCK_TIME ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+		else
+		{
+			xInversionTime = xTaskGetTickCount() - xTimeOnEntering;
+
+			if( xInversionTime > xMaxInversionTime )
+			{
+				xMaxInversionTime = xInversionTime;
+			}
+
+			if( xInversionTime > inhcMAX_INVERSION_TIME )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xSemaphoreGive( xMutex1 ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		uxHighCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPriority( UBaseType_t uxExpectedPriority )
+{
+	#if( INCLUDE_uxTaskPriorityGet == 1 )
+	{
+		if( uxTaskPriorityGet( NULL ) != uxExpectedPriority )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	#else
+	{
+		( void ) uxExpectedPriority;
+	}
+	#endif /* INCLUDE_uxTaskPriorityGet */
+}
+/*-----------------------------------------------------------*/
+
+/* This is called to check that all the created tasks are still running. */
+BaseType_t xAreInheritChainTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastLowCycles = 0, uxLastMediumCycles = 0, uxLastHighCycles = 0;
+
+	if( uxLastLowCycles == uxLowCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxLastMediumCycles == uxMediumCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxLastHighCycles == uxHighCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastLowCycles = uxLowCycles;
+	uxLastMediumCycles = uxMediumCycles;
+	uxLastHighCycles = uxHighCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 */
@@ -0,0 +1,490 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the fixed block memory pools included in the build when
+	configUSE_MEMORY_POOLS is set to 1.
+
+	Each cycle prvMemPoolControllerTask() allocates every block of a statically
+	allocated pool, checks the blocks are distinct and aligned, and that a
+	further allocation fails both immediately and after waiting for the
+	specified block time.  It then passes one block to the lower priority
+	prvMemPoolFreeTask() and waits for a block to become available.  The free
+	task checks the block still holds the pattern written by the controller
+	and frees it, which must unblock the controller with that same block.
+
+	The controller also creates, uses and deletes a dynamically allocated pool,
+	and shares a second single block pool with vMemPoolPeriodicISRTest(), which
+	is called from the tick hook.  The interrupt allocates the block whenever it
+	is free, holds it for a few ticks, then frees it with
+	vMemPoolFreeFromISR() - unblocking the controller if it is waiting for the
+	block at the time.  Both sides fill the block with their own pattern while
+	they hold it and check the pattern is unchanged before freeing it, which
+	would not be the case if the block had been given to both at once.
+*/
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mempool.h"
+
+/* Demo app include files. */
+#include "MemPoolTest.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_MEMORY_POOLS == 1 )
+
+#define mpCONTROLLER_PRIORITY		( tskIDLE_PRIORITY + 2 )
+#define mpFREE_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+
+/* The statically allocated pool.  The block size is deliberately not a
+multiple of portBYTE_ALIGNMENT so the rounding is tested. */
+#define mpBLOCK_SIZE				( 20 )
+#define mpBLOCK_COUNT				( 4 )
+
+/* The dynamically allocated pool, with blocks too small to hold the free list
+link before rounding. */
+#define mpDYNAMIC_BLOCK_SIZE		( 1 )
+#define mpDYNAMIC_BLOCK_COUNT		( 3 )
+
+/* The pool shared with the tick hook. */
+#define mpISR_BLOCK_SIZE			( 32 )
+#define mpISR_HOLD_TICKS			( 3 )
+#define mpISR_PATTERN				( 0xa5 )
+#define mpTASK_PATTERN				( 0x5a )
+
+#define mpSHORT_DELAY				pdMS_TO_TICKS( 10 )
+#define mpLONG_DELAY				pdMS_TO_TICKS( 500 )
+#define mpCYCLE_DELAY				pdMS_TO_TICKS( 20 )
+
+#ifndef mpMEM_POOL_TEST_TASK_STACK_SIZE
+	#define mpMEM_POOL_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The tasks described at the top of this file. */
+static void prvMemPoolControllerTask( void *pvParameters );
+static void prvMemPoolFreeTask( void *pvParameters );
+
+/*
+ * The tests performed on each of the pools.
+ */
+static BaseType_t prvTestStaticPool( uint8_t ucPattern );
+static BaseType_t prvTestDynamicPool( void );
+static BaseType_t prvTestISRPool( void );
+
+/*
+ * Returns pdTRUE if every byte of pucBlock is ucPattern.
+ */
+static BaseType_t prvCheckPattern( const uint8_t *pucBlock, size_t xLength, uint8_t ucPattern );
+
+/*-----------------------------------------------------------*/
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxCycles = 0, uxISRCycles = 0;
+
+/* The statically allocated pool, and the pool shared with the tick hook. */
+static uint8_t ucPoolStorage[ mempoolSTORAGE_SIZE( mpBLOCK_SIZE, mpBLOCK_COUNT ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+static StaticMemPool_t xStaticPoolStruct;
+static MemPoolHandle_t xStaticPool = NULL, xISRPool = NULL;
+
+/* The block passed from the controller to the free task, and the pattern the
+controller wrote to it. */
+static TaskHandle_t xFreeTask = NULL;
+static void * volatile pvBlockToFree = NULL;
+static volatile uint8_t ucPatternToCheck = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartMemPoolTasks( void )
+{
+	xStaticPool = xMemPoolCreateStatic( mpBLOCK_SIZE, mpBLOCK_COUNT, ucPoolStorage, &xStaticPoolStruct );
+	xISRPool = xMemPoolCreate( mpISR_BLOCK_SIZE, 1 );
+
+	if( ( xStaticPool != NULL ) && ( xISRPool != NULL ) )
+	{
+		xTaskCreate( prvMemPoolControllerTask, "MPCtrl", mpMEM_POOL_TEST_TASK_STACK_SIZE, NULL, mpCONTROLLER_PRIORITY, NULL );
+		xTaskCreate( prvMemPoolFreeTask, "MPFree", mpMEM_POOL_TEST_TASK_STACK_SIZE, NULL, mpFREE_TASK_PRIORITY, &xFreeTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMemPoolControllerTask( void *pvParameters )
+{
+uint8_t ucPattern = 0;
+
+	/* Remove compiler warning about unused parameter. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( prvTestStaticPool( ucPattern ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvTestDynamicPool() != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( prvTestISRPool() != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		ucPattern++;
+		uxCycles++;
+		vTaskDelay( mpCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTestStaticPool( uint8_t ucPattern )
+{
+uint8_t *pucBlocks[ mpBLOCK_COUNT ], *pucBlock;
+const size_t xBlockSize = xMemPoolGetBlockSize( xStaticPool );
+TickType_t xTimeBefore;
+UBaseType_t uxBlock, uxOther;
+BaseType_t xReturn = pdPASS;
+
+	if( ( xBlockSize != mempoolBLOCK_SIZE( mpBLOCK_SIZE ) ) || ( xBlockSize < mpBLOCK_SIZE ) || ( ( xBlockSize % portBYTE_ALIGNMENT ) != 0 ) )
+	{
+		xReturn = pdFAIL;
+	}
+
+	/* Take every block in the pool. */
+	for( uxBlock = 0; uxBlock < mpBLOCK_COUNT; uxBlock++ )
+	{
+		pucBlocks[ uxBlock ] = ( uint8_t * ) pvMemPoolAlloc( xStaticPool, 0 );
+
+		if( pucBlocks[ uxBlock ] == NULL )
+		{
+			/* Nothing else uses this pool, so this should not happen.  Give
+			up rather than leak blocks. */
+			return pdFAIL;
+		}
+
+		/* The block must lie within the storage, on a block boundary, and
+		must not have been returned already. */
+		if( ( pucBlocks[ uxBlock ] < ucPoolStorage ) || ( pucBlocks[ uxBlock ] >= &( ucPoolStorage[ sizeof( ucPoolStorage ) ] ) ) || ( ( ( size_t ) ( pucBlocks[ uxBlock ] - ucPoolStorage ) % xBlockSize ) != 0 ) )
+		{
+			xReturn = pdFAIL;
+		}
+
+		for( uxOther = 0; uxOther < uxBlock; uxOther++ )
+		{
+			if( pucBlocks[ uxOther ] == pucBlocks[ uxBlock ] )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+
+		memset( pucBlocks[ uxBlock ], ( int ) ( ucPattern + uxBlock ), xBlockSize );
+	}
+
+	if( ( uxMemPoolGetFreeCount( xStaticPool ) != 0 ) || ( uxMemPoolGetMinimumEverFreeCount( xStaticPool ) != 0 ) )
+	{
+		xReturn = pdFAIL;
+	}
+
+	/* The pool is empty so further allocations must fail, both without a
+	block time and after the block time has expired. */
+	if( pvMemPoolAlloc( xStaticPool, 0 ) != NULL )
+	{
+		xReturn = pdFAIL;
+	}
+
+	xTimeBefore = xTaskGetTickCount();
+
+	if( pvMemPoolAlloc( xStaticPool, mpSHORT_DELAY ) != NULL )
+	{
+		xReturn = pdFAIL;
+	}
+
+	if( ( xTaskGetTickCount() - xTimeBefore ) < mpSHORT_DELAY )
+	{
+		xReturn = pdFAIL;
+	}
+
+	/* Pass the first block to the free task, which has a lower priority so
+	does not run until this task blocks waiting for a block below.  Freeing the
+	block must unblock this task, and as it is the only free block it must be
+	the block obtained. */
+	pvBlockToFree = pucBlocks[ 0 ];
+	ucPatternToCheck = ucPattern;
+	xTaskNotifyGive( xFreeTask );
+
+	pucBlock = ( uint8_t * ) pvMemPoolAlloc( xStaticPool, mpLONG_DELAY );
+
+	if( pucBlock != pucBlocks[ 0 ] )
+	{
+		xReturn = pdFAIL;
+
+		if( pucBlock == NULL )
+		{
+			/* The block was not freed so cannot be freed below. */
+			return pdFAIL;
+		}
+	}
+
+	/* Check the blocks were not overwritten while they were allocated, then
+	return them all. */
+	for( uxBlock = 1; uxBlock < mpBLOCK_COUNT; uxBlock++ )
+	{
+		if( prvCheckPattern( pucBlocks[ uxBlock ], xBlockSize, ( uint8_t ) ( ucPattern + uxBlock ) ) != pdTRUE )
+		{
+			xReturn = pdFAIL;
+		}
+
+		vMemPoolFree( xStaticPool, pucBlocks[ uxBlock ] );
+	}
+
+	vMemPoolFree( xStaticPool, pucBlock );
+
+	if( uxMemPoolGetFreeCount( xStaticPool ) != mpBLOCK_COUNT )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTestDynamicPool( void )
+{
+MemPoolHandle_t xPool;
+uint8_t *pucBlocks[ mpDYNAMIC_BLOCK_COUNT ];
+size_t xBlockSize;
+UBaseType_t uxBlock;
+BaseType_t xReturn = pdPASS;
+
+	xPool = xMemPoolCreate( mpDYNAMIC_BLOCK_SIZE, mpDYNAMIC_BLOCK_COUNT );
+
+	if( xPool == NULL )
+	{
+		/* The heap is shared with other tests, so this is not an error. */
+		return pdPASS;
+	}
+
+	/* Blocks must be large enough to hold the free list link. */
+	xBlockSize = xMemPoolGetBlockSize( xPool );
+
+	if( ( xBlockSize < sizeof( uint32_t ) ) || ( ( xBlockSize % portBYTE_ALIGNMENT ) != 0 ) )
+	{
+		xReturn = pdFAIL;
+	}
+
+	for( uxBlock = 0; uxBlock < mpDYNAMIC_BLOCK_COUNT; uxBlock++ )
+	{
+		pucBlocks[ uxBlock ] = ( uint8_t * ) pvMemPoolAlloc( xPool, 0 );
+
+		if( ( pucBlocks[ uxBlock ] == NULL ) || ( ( ( portPOINTER_SIZE_TYPE ) pucBlocks[ uxBlock ] & ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) != 0 ) )
+		{
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			memset( pucBlocks[ uxBlock ], ( int ) uxBlock, xBlockSize );
+		}
+	}
+
+	if( uxMemPoolGetMinimumEverFreeCount( xPool ) != 0 )
+	{
+		xReturn = pdFAIL;
+	}
+
+	for( uxBlock = 0; uxBlock < mpDYNAMIC_BLOCK_COUNT; uxBlock++ )
+	{
+		if( pucBlocks[ uxBlock ] != NULL )
+		{
+			if( prvCheckPattern( pucBlocks[ uxBlock ], xBlockSize, ( uint8_t ) uxBlock ) != pdTRUE )
+			{
+				xReturn = pdFAIL;
+			}
+
+			vMemPoolFree( xPool, pucBlocks[ uxBlock ] );
+		}
+	}
+
+	vMemPoolDelete( xPool );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTestISRPool( void )
+{
+uint8_t *pucBlock;
+const size_t xBlockSize = xMemPoolGetBlockSize( xISRPool );
+static UBaseType_t uxLastISRCycles = 0;
+BaseType_t xReturn = pdPASS;
+
+	/* The interrupt holds the block for mpISR_HOLD_TICKS at a time, so the
+	block should become available well within the block time - usually by
+	vMemPoolFreeFromISR() unblocking this task. */
+	pucBlock = ( uint8_t * ) pvMemPoolAlloc( xISRPool, mpLONG_DELAY );
+
+	if( pucBlock == NULL )
+	{
+		return pdFAIL;
+	}
+
+	/* Hold the block long enough for the interrupt to attempt to allocate it
+	while this task has it. */
+	memset( pucBlock, mpTASK_PATTERN, xBlockSize );
+	vTaskDelay( mpISR_HOLD_TICKS );
+
+	if( prvCheckPattern( pucBlock, xBlockSize, mpTASK_PATTERN ) != pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	vMemPoolFree( xISRPool, pucBlock );
+
+	/* The interrupt should have held and freed the block at least once since
+	the last cycle. */
+	if( uxISRCycles == uxLastISRCycles )
+	{
+		xReturn = pdFAIL;
+	}
+
+	uxLastISRCycles = uxISRCycles;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMemPoolFreeTask( void *pvParameters )
+{
+	/* Remove compiler warning about unused parameter. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait for the controller to pass a block. */
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		if( prvCheckPattern( ( uint8_t * ) pvBlockToFree, xMemPoolGetBlockSize( xStaticPool ), ucPatternToCheck ) != pdTRUE )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* The controller is waiting for this block, so will preempt this task
+		here. */
+		vMemPoolFree( xStaticPool, pvBlockToFree );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolPeriodicISRTest( void )
+{
+static uint8_t *pucBlock = NULL;
+static UBaseType_t uxHeldTicks = 0;
+size_t xBlockSize;
+
+	/* Nothing to do until the pool has been created. */
+	if( xISRPool != NULL )
+	{
+		xBlockSize = xMemPoolGetBlockSize( xISRPool );
+
+		if( pucBlock == NULL )
+		{
+			/* Take the block if the task does not have it. */
+			pucBlock = ( uint8_t * ) pvMemPoolAllocFromISR( xISRPool );
+
+			if( pucBlock != NULL )
+			{
+				memset( pucBlock, mpISR_PATTERN, xBlockSize );
+				uxHeldTicks = 0;
+			}
+		}
+		else
+		{
+			uxHeldTicks++;
+
+			if( uxHeldTicks >= mpISR_HOLD_TICKS )
+			{
+				if( prvCheckPattern( pucBlock, xBlockSize, mpISR_PATTERN ) != pdTRUE )
+				{
+					xErrorOccurred = pdTRUE;
+				}
+
+				/* The tick interrupt performs a context switch if one is
+				needed, so the woken flag is not used. */
+				vMemPoolFreeFromISR( xISRPool, pucBlock, NULL );
+				pucBlock = NULL;
+				uxISRCycles++;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckPattern( const uint8_t *pucBlock, size_t xLength, uint8_t ucPattern )
+{
+size_t x;
+BaseType_t xReturn = pdTRUE;
+
+	for( x = 0; x < xLength; x++ )
+	{
+		if( pucBlock[ x ] != ucPattern )
+		{
+			xReturn = pdFALSE;
+			break;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreMemPoolTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastCycles = 0;
+
+	if( uxLastCycles == uxCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastCycles = uxCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_MEMORY_POOLS == 1 */
@@ -0,0 +1,364 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests queue sets built with configUSE_QUEUE_SET_BITMAP set to 1, which hold
+	a ready bit per member instead of a copy of every event.
+
+	A single queue set holds qsbNUM_QUEUES queues, a stream buffer and a message
+	buffer - far more members than a set that stores events could hold for the
+	same RAM.  Each cycle prvSendTask(), which has the higher priority, writes
+	one item to every queue in a scrambled order, then to the stream buffer and
+	the message buffer.  The stream buffer is reset while it is in the set
+	before it is written, so it must still be a member of the set after the
+	reset.  prvSendTask() also removes the first queue from the set while the
+	queue holds data and adds it back again, which leaves the queue ready
+	straight away.  prvSendTask() then blocks, and prvReceiveTask() selects from
+	the set until every member has been read.
+
+	As every member is ready by the time prvReceiveTask() runs, the set must
+	return the members in the order they occupy the set, and each exactly once
+	per cycle.  Once all the members have been read the set must be empty again,
+	so prvReceiveTask() blocks on the set until the next cycle starts.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+/* Demo app include files. */
+#include "QueueSetBitmap.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+/* Priorities of the tasks described at the top of this file. */
+#define qsbRECEIVE_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define qsbSEND_PRIORITY			( tskIDLE_PRIORITY + 2 )
+
+/* The members of the set.  The queues occupy the first qsbNUM_QUEUES slots,
+followed by the stream buffer then the message buffer. */
+#define qsbNUM_QUEUES				( 256 )
+#define qsbSTREAM_BUFFER_INDEX		( qsbNUM_QUEUES )
+#define qsbMESSAGE_BUFFER_INDEX		( qsbNUM_QUEUES + 1 )
+#define qsbNUM_MEMBERS				( qsbNUM_QUEUES + 2 )
+
+/* Used to write to the queues in an order that differs from the order in
+which they are read.  Must not share a factor with qsbNUM_QUEUES. */
+#define qsbSEND_STRIDE				( 37 )
+
+/* Sizes of the stream buffer and message buffer. */
+#define qsbBUFFER_SIZE_BYTES		( 32 )
+#define qsbMESSAGE_LENGTH			( sizeof( uint32_t ) )
+
+/* Timing.  The receive task must never time out as a cycle is sent long
+before the block time expires. */
+#define qsbSEND_PERIOD				pdMS_TO_TICKS( 50 )
+#define qsbRECEIVE_BLOCK_TIME		pdMS_TO_TICKS( 500 )
+#define qsbDONT_BLOCK				( ( TickType_t ) 0 )
+
+#ifndef qsbQUEUE_SET_TEST_TASK_STACK_SIZE
+	#define qsbQUEUE_SET_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The tasks as described at the top of this file. */
+static void prvSendTask( void *pvParameters );
+static void prvReceiveTask( void *pvParameters );
+
+/*
+ * Reads from the set member xMember, returning the member's index in the set,
+ * or qsbNUM_MEMBERS if the member is not known or could not be read.
+ */
+static UBaseType_t prvReceiveFromMember( QueueSetMemberHandle_t xMember );
+
+/*-----------------------------------------------------------*/
+
+/* The queue set and its members. */
+static QueueSetHandle_t xQueueSet = NULL;
+static QueueHandle_t xQueues[ qsbNUM_QUEUES ] = { NULL };
+static StreamBufferHandle_t xStreamBuffer = NULL;
+static MessageBufferHandle_t xMessageBuffer = NULL;
+
+/* The value written to every member during the current cycle. */
+static volatile uint32_t ulCycleValue = 0;
+
+/* The number of members read during the current cycle. */
+static volatile UBaseType_t uxReceivedThisCycle = 0;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxSendCycles = 0, uxReceiveCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartQueueSetBitmapTasks( void )
+{
+UBaseType_t uxQueue;
+
+	xQueueSet = xQueueCreateSet( qsbNUM_MEMBERS );
+	configASSERT( xQueueSet );
+
+	if( xQueueSet != NULL )
+	{
+		for( uxQueue = 0; uxQueue < qsbNUM_QUEUES; uxQueue++ )
+		{
+			xQueues[ uxQueue ] = xQueueCreate( 1, sizeof( uint32_t ) );
+			configASSERT( xQueues[ uxQueue ] );
+
+			if( xQueueAddToSet( xQueues[ uxQueue ], xQueueSet ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		xStreamBuffer = xStreamBufferCreate( qsbBUFFER_SIZE_BYTES, 1 );
+		xMessageBuffer = xMessageBufferCreate( qsbBUFFER_SIZE_BYTES );
+		configASSERT( xStreamBuffer );
+		configASSERT( xMessageBuffer );
+
+		if( ( xStreamBufferAddToSet( xStreamBuffer, xQueueSet ) != pdPASS ) || ( xMessageBufferAddToSet( xMessageBuffer, xQueueSet ) != pdPASS ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* A member cannot be added to a set twice, and the set is now full. */
+		if( ( xQueueAddToSet( xQueues[ 0 ], xQueueSet ) != pdFAIL ) || ( xStreamBufferAddToSet( xStreamBuffer, xQueueSet ) != pdFAIL ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* Nothing has been sent yet. */
+		if( xQueueSelectFromSet( xQueueSet, qsbDONT_BLOCK ) != NULL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		xTaskCreate( prvSendTask, "QSBTx", qsbQUEUE_SET_TEST_TASK_STACK_SIZE, NULL, qsbSEND_PRIORITY, NULL );
+		xTaskCreate( prvReceiveTask, "QSBRx", qsbQUEUE_SET_TEST_TASK_STACK_SIZE, NULL, qsbRECEIVE_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendTask( void *pvParameters )
+{
+UBaseType_t uxCount, uxQueue;
+uint32_t ulValue;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* The receive task has the lower priority so only runs while this
+		task is blocked.  By the time this task runs again it must have read
+		every member written to during the previous cycle. */
+		vTaskDelay( qsbSEND_PERIOD );
+
+		if( ( uxSendCycles != 0 ) && ( uxReceivedThisCycle != qsbNUM_MEMBERS ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxReceivedThisCycle = 0;
+		ulCycleValue++;
+		ulValue = ulCycleValue;
+
+		for( uxCount = 0; uxCount < qsbNUM_QUEUES; uxCount++ )
+		{
+			uxQueue = ( uxCount * qsbSEND_STRIDE ) % qsbNUM_QUEUES;
+
+			if( xQueueSend( xQueues[ uxQueue ], &ulValue, qsbDONT_BLOCK ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		/* Resetting the stream buffer discards the data written to it, but
+		must leave it in the set, so the data written after the reset still
+		makes it ready. */
+		if( xStreamBufferSend( xStreamBuffer, &ulValue, sizeof( ulValue ), qsbDONT_BLOCK ) != sizeof( ulValue ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xStreamBufferReset( xStreamBuffer ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xStreamBufferSend( xStreamBuffer, &ulValue, sizeof( ulValue ), qsbDONT_BLOCK ) != sizeof( ulValue ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xMessageBufferSend( xMessageBuffer, &ulValue, qsbMESSAGE_LENGTH, qsbDONT_BLOCK ) != qsbMESSAGE_LENGTH )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		/* A member that holds data can be removed from the set, and is ready
+		again as soon as it is added back.  It returns to the same slot as that
+		is the first free one. */
+		if( xQueueRemoveFromSet( xQueues[ 0 ], xQueueSet ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xQueueRemoveFromSet( xQueues[ 0 ], xQueueSet ) != pdFAIL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xQueueAddToSet( xQueues[ 0 ], xQueueSet ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxSendCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceiveTask( void *pvParameters )
+{
+QueueSetMemberHandle_t xMember;
+UBaseType_t uxIndex;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xMember = xQueueSelectFromSet( xQueueSet, qsbRECEIVE_BLOCK_TIME );
+
+		if( xMember == NULL )
+		{
+			/* The send task writes to the set well within the block time. */
+			xErrorOccurred = pdTRUE;
+		}
+		else
+		{
+			uxIndex = prvReceiveFromMember( xMember );
+
+			/* All the members were ready before this task ran, so they must be
+			selected in turn, starting from the first. */
+			if( uxIndex != uxReceivedThisCycle )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			uxReceivedThisCycle++;
+
+			if( uxReceivedThisCycle == qsbNUM_MEMBERS )
+			{
+				/* Every member has been read, so the set must be empty. */
+				if( xQueueSelectFromSet( xQueueSet, qsbDONT_BLOCK ) != NULL )
+				{
+					xErrorOccurred = pdTRUE;
+				}
+
+				uxReceiveCycles++;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvReceiveFromMember( QueueSetMemberHandle_t xMember )
+{
+UBaseType_t uxIndex = qsbNUM_MEMBERS, uxQueue;
+uint32_t ulReceived = 0;
+
+	if( xMember == ( QueueSetMemberHandle_t ) xStreamBuffer )
+	{
+		if( xStreamBufferReceive( xStreamBuffer, &ulReceived, sizeof( ulReceived ), qsbDONT_BLOCK ) == sizeof( ulReceived ) )
+		{
+			uxIndex = qsbSTREAM_BUFFER_INDEX;
+		}
+	}
+	else if( xMember == ( QueueSetMemberHandle_t ) xMessageBuffer )
+	{
+		if( xMessageBufferReceive( xMessageBuffer, &ulReceived, sizeof( ulReceived ), qsbDONT_BLOCK ) == qsbMESSAGE_LENGTH )
+		{
+			uxIndex = qsbMESSAGE_BUFFER_INDEX;
+		}
+	}
+	else
+	{
+		/* The member was returned by the set so must hold data. */
+		if( xQueueReceive( ( QueueHandle_t ) xMember, &ulReceived, qsbDONT_BLOCK ) == pdPASS )
+		{
+			for( uxQueue = 0; uxQueue < qsbNUM_QUEUES; uxQueue++ )
+			{
+				if( xQueues[ uxQueue ] == ( QueueHandle_t ) xMember )
+				{
+					uxIndex = uxQueue;
+				}
+			}
+		}
+	}
+
+	if( ulReceived != ulCycleValue )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	return uxIndex;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreQueueSetBitmapTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastSendCycles = 0, uxLastReceiveCycles = 0;
+
+	if( uxLastSendCycles == uxSendCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxLastReceiveCycles == uxReceiveCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastSendCycles = uxSendCycles;
+	uxLastReceiveCycles = uxReceiveCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_QUEUE_SET_BITMAP == 1 */
@@ -0,0 +1,652 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the reader-writer lock, and measures how read throughput scales with
+	the number of reader tasks when a reader-writer lock is used in place of a
+	mutex.
+
+	prvControlTask() first checks the lock's semantics with the help of
+	prvHelperTask(), which has a higher priority and is told which operation to
+	perform using a task notification:
+
+	+ A task waiting to read causes the write holder to inherit its priority,
+	  which is kept when the holder takes and gives a mutex, and disinherited
+	  when the write lock is released.
+	+ A lock that prefers writers does not grant new read locks while a task is
+	  waiting to write, whereas a lock that prefers readers does.
+	+ The last reader to release the lock unblocks a waiting writer.
+	+ A task that times out waiting to write no longer holds off readers.
+
+	prvControlTask() then runs the benchmark.  Each phase starts a number of
+	prvReaderTask() tasks, each of which repeatedly obtains the lock, checks the
+	shared data is consistent, then holds the lock for a tick to simulate a slow
+	look up before releasing it again.  The control task updates the shared data
+	under the lock every few ticks.  Each phase is run once with a standard mutex
+	and once with a reader-writer lock, and the number of completed reads is
+	recorded.  Reads are serialised by the mutex, so only the reader-writer lock
+	should complete more reads as reader tasks are added.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "rwlock.h"
+
+/* Demo app include files. */
+#include "RWLockBench.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_RW_LOCKS == 1 )
+
+#if( configMAX_PRIORITIES < 4 )
+	#error This test needs configMAX_PRIORITIES to be at least 4.
+#endif
+
+/* Priorities of the tasks described at the top of this file. */
+#define rwbREADER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define rwbCONTROL_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define rwbHELPER_PRIORITY			( tskIDLE_PRIORITY + 3 )
+
+/* The commands sent to the helper task. */
+#define rwbHELPER_READ				( 1UL )
+#define rwbHELPER_WRITE				( 2UL )
+
+/* The maximum number of reader tasks, and the number of lock types
+benchmarked. */
+#define rwbMAX_READERS				( 4 )
+#define rwbNUM_LOCK_TYPES			( 2 )
+
+/* Benchmark timing. */
+#define rwbPHASE_TICKS				pdMS_TO_TICKS( 100 )
+#define rwbWRITE_PERIOD				pdMS_TO_TICKS( 10 )
+#define rwbREAD_HOLD_TICKS			( ( TickType_t ) 1 )
+
+/* Misc. */
+#define rwbSHORT_TIMEOUT			pdMS_TO_TICKS( 5 )
+#define rwbCYCLE_DELAY				pdMS_TO_TICKS( 200 )
+#define rwbNO_DELAY					( ( TickType_t ) 0 )
+
+#ifndef rwbRW_LOCK_TEST_TASK_STACK_SIZE
+	#define rwbRW_LOCK_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The tasks as described at the top of this file. */
+static void prvControlTask( void *pvParameters );
+static void prvHelperTask( void *pvParameters );
+static void prvReaderTask( void *pvParameters );
+
+/*
+ * The semantic checks and the benchmark performed by the control task.
+ */
+static void prvCheckRWLockSemantics( void );
+static uint32_t prvRunBenchmarkPhase( BaseType_t xUseRWLock, UBaseType_t uxReaders );
+
+/*
+ * Obtain and release the lock being benchmarked, which is either
+ * xBenchmarkMutex or xWriterPreferringLock.
+ */
+static BaseType_t prvTakeBenchmarkLock( BaseType_t xForWriting );
+static void prvGiveBenchmarkLock( BaseType_t xForWriting );
+
+/*
+ * Tell the helper task to perform ulCommand on xLock.
+ */
+static void prvSendHelperCommand( RWLockHandle_t xLock, uint32_t ulCommand );
+
+/*
+ * Check the helper task has completed the last command sent to it if
+ * xExpectCompleted is pdTRUE, or is still blocked on the lock if
+ * xExpectCompleted is pdFALSE.
+ */
+static void prvCheckHelperCompleted( BaseType_t xExpectCompleted );
+
+/*
+ * Check the priority of the calling task is uxExpectedPriority, latching an
+ * error if not.
+ */
+static void prvCheckPriority( UBaseType_t uxExpectedPriority );
+
+/*-----------------------------------------------------------*/
+
+/* The locks used by the demo.  xWriterPreferringLock is statically allocated
+if configSUPPORT_STATIC_ALLOCATION is 1. */
+static RWLockHandle_t xWriterPreferringLock = NULL, xReaderPreferringLock = NULL;
+static SemaphoreHandle_t xBenchmarkMutex = NULL;
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	static StaticRWLock_t xWriterPreferringLockBuffer;
+#endif
+
+/* The lock the helper task operates on next. */
+static RWLockHandle_t xHelperLock = NULL;
+
+/* Task handles used for task notifications. */
+static TaskHandle_t xControlTaskHandle = NULL, xHelperTaskHandle = NULL;
+static TaskHandle_t xReaderTaskHandles[ rwbMAX_READERS ] = { NULL };
+
+/* Benchmark state.  ulSharedData1 and ulSharedData2 are only ever updated
+together under the lock, so readers must always see them equal. */
+static volatile BaseType_t xPhaseRunning = pdFALSE, xPhaseUsesRWLock = pdFALSE;
+static volatile uint32_t ulSharedData1 = 0, ulSharedData2 = 0;
+static volatile uint32_t ulReaderReads[ rwbMAX_READERS ] = { 0 };
+
+/* The number of reads completed by each benchmark phase. */
+static volatile uint32_t ulBenchmarkReads[ rwbNUM_LOCK_TYPES ][ rwbNUM_PHASES ] = { { 0 } };
+static const UBaseType_t uxReadersPerPhase[ rwbNUM_PHASES ] = rwbREADER_TASKS_PER_PHASE;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxControlCycles = 0, uxHelperCycles = 0;
+static UBaseType_t uxHelperCommandsSent = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartRWLockBenchmarkTasks( void )
+{
+UBaseType_t uxReader;
+
+	xBenchmarkMutex = xSemaphoreCreateMutex();
+	xReaderPreferringLock = xRWLockCreate( rwlockPREFER_READERS );
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		xWriterPreferringLock = xRWLockCreateStatic( rwlockPREFER_WRITERS, &xWriterPreferringLockBuffer );
+	}
+	#else
+	{
+		xWriterPreferringLock = xRWLockCreate( rwlockPREFER_WRITERS );
+	}
+	#endif
+
+	if( ( xBenchmarkMutex != NULL ) && ( xReaderPreferringLock != NULL ) && ( xWriterPreferringLock != NULL ) )
+	{
+		xTaskCreate( prvControlTask, "RWCtrl", rwbRW_LOCK_TEST_TASK_STACK_SIZE, NULL, rwbCONTROL_PRIORITY, &xControlTaskHandle );
+		xTaskCreate( prvHelperTask, "RWHelp", rwbRW_LOCK_TEST_TASK_STACK_SIZE, NULL, rwbHELPER_PRIORITY, &xHelperTaskHandle );
+
+		for( uxReader = 0; uxReader < rwbMAX_READERS; uxReader++ )
+		{
+			/* The task's index is passed in as the parameter. */
+			xTaskCreate( prvReaderTask, "RWRead", rwbRW_LOCK_TEST_TASK_STACK_SIZE, ( void * ) uxReader, rwbREADER_PRIORITY, &( xReaderTaskHandles[ uxReader ] ) );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+UBaseType_t uxPhase;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvCheckRWLockSemantics();
+
+		for( uxPhase = 0; uxPhase < rwbNUM_PHASES; uxPhase++ )
+		{
+			ulBenchmarkReads[ 0 ][ uxPhase ] = prvRunBenchmarkPhase( pdFALSE, uxReadersPerPhase[ uxPhase ] );
+			ulBenchmarkReads[ 1 ][ uxPhase ] = prvRunBenchmarkPhase( pdTRUE, uxReadersPerPhase[ uxPhase ] );
+		}
+
+		/* With the most reader tasks the reader-writer lock must allow more
+		reads to complete than the mutex. */
+		if( ulBenchmarkReads[ 1 ][ rwbNUM_PHASES - 1 ] <= ulBenchmarkReads[ 0 ][ rwbNUM_PHASES - 1 ] )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxControlCycles++;
+		vTaskDelay( rwbCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckRWLockSemantics( void )
+{
+	/* Priority inheritance.  While this task holds the write lock the helper
+	task blocks trying to read, which must raise this task to the helper's
+	priority.  Giving back a mutex taken meanwhile must not lower the priority,
+	as the helper is still waiting.  Releasing the lock must drop this task
+	back to its own priority, at which point the helper preempts it. */
+	if( xRWLockAcquireWrite( xWriterPreferringLock, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvSendHelperCommand( xWriterPreferringLock, rwbHELPER_READ );
+	prvCheckHelperCompleted( pdFALSE );
+	prvCheckPriority( rwbHELPER_PRIORITY );
+
+	if( xSemaphoreTake( xBenchmarkMutex, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xSemaphoreGive( xBenchmarkMutex ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvCheckPriority( rwbHELPER_PRIORITY );
+	prvCheckHelperCompleted( pdFALSE );
+
+	if( xRWLockReleaseWrite( xWriterPreferringLock ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvCheckPriority( rwbCONTROL_PRIORITY );
+	prvCheckHelperCompleted( pdTRUE );
+
+	/* A write lock cannot be released by a task that does not hold it. */
+	if( xRWLockReleaseWrite( xWriterPreferringLock ) != pdFAIL )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	/* Writer preference.  While this task holds a read lock the helper task
+	blocks trying to write, after which no new read locks can be obtained.
+	The helper obtains the lock when the last read lock is released. */
+	if( xRWLockAcquireRead( xWriterPreferringLock, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvSendHelperCommand( xWriterPreferringLock, rwbHELPER_WRITE );
+	prvCheckHelperCompleted( pdFALSE );
+
+	if( xRWLockAcquireRead( xWriterPreferringLock, rwbNO_DELAY ) != pdFAIL )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xRWLockReleaseRead( xWriterPreferringLock ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvCheckHelperCompleted( pdTRUE );
+
+	/* Reader preference.  The same sequence on a lock that prefers readers
+	must allow a second read lock to be obtained while the helper waits. */
+	if( xRWLockAcquireRead( xReaderPreferringLock, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvSendHelperCommand( xReaderPreferringLock, rwbHELPER_WRITE );
+	prvCheckHelperCompleted( pdFALSE );
+
+	if( xRWLockAcquireRead( xReaderPreferringLock, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxRWLockGetReaderCount( xReaderPreferringLock ) != ( UBaseType_t ) 2 )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xRWLockReleaseRead( xReaderPreferringLock ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	/* One read lock is still held, so the helper must still be waiting. */
+	prvCheckHelperCompleted( pdFALSE );
+
+	if( xRWLockReleaseRead( xReaderPreferringLock ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	prvCheckHelperCompleted( pdTRUE );
+
+	/* Timeout.  Waiting to write while this task holds a read lock can only
+	time out, after which readers must no longer be held off. */
+	if( xRWLockAcquireRead( xWriterPreferringLock, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xRWLockAcquireWrite( xWriterPreferringLock, rwbSHORT_TIMEOUT ) != pdFAIL )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( xRWLockAcquireRead( xWriterPreferringLock, rwbNO_DELAY ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( ( xRWLockReleaseRead( xWriterPreferringLock ) != pdPASS ) || ( xRWLockReleaseRead( xWriterPreferringLock ) != pdPASS ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	/* Both locks must now be free. */
+	if( ( uxRWLockGetReaderCount( xWriterPreferringLock ) != ( UBaseType_t ) 0 ) || ( xRWLockGetWriteHolder( xWriterPreferringLock ) != NULL ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( ( uxRWLockGetReaderCount( xReaderPreferringLock ) != ( UBaseType_t ) 0 ) || ( xRWLockGetWriteHolder( xReaderPreferringLock ) != NULL ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendHelperCommand( RWLockHandle_t xLock, uint32_t ulCommand )
+{
+	xHelperLock = xLock;
+	uxHelperCommandsSent++;
+
+	/* The helper has the higher priority so runs until it either completes
+	the command or blocks on the lock before the notify function returns. */
+	xTaskNotify( xHelperTaskHandle, ulCommand, eSetValueWithOverwrite );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckHelperCompleted( BaseType_t xExpectCompleted )
+{
+UBaseType_t uxExpectedCycles = uxHelperCommandsSent;
+
+	if( xExpectCompleted == pdFALSE )
+	{
+		uxExpectedCycles--;
+	}
+
+	if( uxHelperCycles != uxExpectedCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHelperTask( void *pvParameters )
+{
+uint32_t ulCommand;
+BaseType_t xForWriting;
+
+	/* Just to remove compiler warning. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		( void ) xTaskNotifyWait( 0, 0, &ulCommand, portMAX_DELAY );
+		xForWriting = ( ulCommand == rwbHELPER_WRITE ) ? pdTRUE : pdFALSE;
+
+		if( xForWriting != pdFALSE )
+		{
+			if( xRWLockAcquireWrite( xHelperLock, portMAX_DELAY ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			/* Writers have exclusive access. */
+			if( uxRWLockGetReaderCount( xHelperLock ) != ( UBaseType_t ) 0 )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xRWLockReleaseWrite( xHelperLock ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+		else
+		{
+			if( xRWLockAcquireRead( xHelperLock, portMAX_DELAY ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xRWLockGetWriteHolder( xHelperLock ) != NULL )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xRWLockReleaseRead( xHelperLock ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		uxHelperCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRunBenchmarkPhase( BaseType_t xUseRWLock, UBaseType_t uxReaders )
+{
+UBaseType_t uxReader;
+TickType_t xPhaseStart, xLastWakeTime;
+uint32_t ulReads = 0;
+
+	xPhaseUsesRWLock = xUseRWLock;
+	xPhaseRunning = pdTRUE;
+
+	for( uxReader = 0; uxReader < uxReaders; uxReader++ )
+	{
+		ulReaderReads[ uxReader ] = 0;
+		xTaskNotifyGive( xReaderTaskHandles[ uxReader ] );
+	}
+
+	/* Update the shared data periodically until the phase ends. */
+	xPhaseStart = xTaskGetTickCount();
+	xLastWakeTime = xPhaseStart;
+
+	while( ( xTaskGetTickCount() - xPhaseStart ) < rwbPHASE_TICKS )
+	{
+		vTaskDelayUntil( &xLastWakeTime, rwbWRITE_PERIOD );
+
+		if( prvTakeBenchmarkLock( pdTRUE ) == pdPASS )
+		{
+			ulSharedData1++;
+
+			/* Hold the lock across a tick so a reader that is not excluded
+			would see the data half updated. */
+			vTaskDelay( ( TickType_t ) 1 );
+			ulSharedData2++;
+
+			prvGiveBenchmarkLock( pdTRUE );
+		}
+		else
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+
+	/* Stop the readers, and wait for each to finish its last read. */
+	xPhaseRunning = pdFALSE;
+
+	for( uxReader = 0; uxReader < uxReaders; uxReader++ )
+	{
+		if( ulTaskNotifyTake( pdFALSE, rwbPHASE_TICKS ) == 0 )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+
+	for( uxReader = 0; uxReader < uxReaders; uxReader++ )
+	{
+		ulReads += ulReaderReads[ uxReader ];
+	}
+
+	return ulReads;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void *pvParameters )
+{
+const UBaseType_t uxIndex = ( UBaseType_t ) pvParameters;
+
+	for( ;; )
+	{
+		/* Wait for a benchmark phase to start. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		while( xPhaseRunning != pdFALSE )
+		{
+			if( prvTakeBenchmarkLock( pdFALSE ) == pdPASS )
+			{
+				if( ulSharedData1 != ulSharedData2 )
+				{
+					xErrorOccurred = pdTRUE;
+				}
+
+				/* Simulate a slow look up. */
+				vTaskDelay( rwbREAD_HOLD_TICKS );
+				prvGiveBenchmarkLock( pdFALSE );
+
+				ulReaderReads[ uxIndex ]++;
+			}
+			else
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		xTaskNotifyGive( xControlTaskHandle );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTakeBenchmarkLock( BaseType_t xForWriting )
+{
+BaseType_t xReturn;
+
+	if( xPhaseUsesRWLock != pdFALSE )
+	{
+		if( xForWriting != pdFALSE )
+		{
+			xReturn = xRWLockAcquireWrite( xWriterPreferringLock, portMAX_DELAY );
+		}
+		else
+		{
+			xReturn = xRWLockAcquireRead( xWriterPreferringLock, portMAX_DELAY );
+		}
+	}
+	else
+	{
+		xReturn = xSemaphoreTake( xBenchmarkMutex, portMAX_DELAY );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGiveBenchmarkLock( BaseType_t xForWriting )
+{
+BaseType_t xReturn;
+
+	if( xPhaseUsesRWLock != pdFALSE )
+	{
+		if( xForWriting != pdFALSE )
+		{
+			xReturn = xRWLockReleaseWrite( xWriterPreferringLock );
+		}
+		else
+		{
+			xReturn = xRWLockReleaseRead( xWriterPreferringLock );
+		}
+	}
+	else
+	{
+		xReturn = xSemaphoreGive( xBenchmarkMutex );
+	}
+
+	if( xReturn != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPriority( UBaseType_t uxExpectedPriority )
+{
+	#if( INCLUDE_uxTaskPriorityGet == 1 )
+	{
+		if( uxTaskPriorityGet( NULL ) != uxExpectedPriority )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	#else
+	{
+		( void ) uxExpectedPriority;
+	}
+	#endif /* INCLUDE_uxTaskPriorityGet */
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulGetRWLockBenchmarkReads( BaseType_t xUsedRWLock, UBaseType_t uxPhase )
+{
+uint32_t ulReturn = 0;
+
+	if( uxPhase < rwbNUM_PHASES )
+	{
+		ulReturn = ulBenchmarkReads[ ( xUsedRWLock != pdFALSE ) ? 1 : 0 ][ uxPhase ];
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* This is called to check that all the created tasks are still running. */
+BaseType_t xAreRWLockBenchmarkTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastControlCycles = 0, uxLastHelperCycles = 0;
+
+	if( uxLastControlCycles == uxControlCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	if( uxLastHelperCycles == uxHelperCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastControlCycles = uxControlCycles;
+	uxLastHelperCycles = uxHelperCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_RW_LOCKS == 1 */
@@ -0,0 +1,403 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests run to completion tasks, which are created with
+	xTaskCreateRunToCompletion() and execute on a stack shared by all the run
+	to completion tasks of the same priority, and measures the heap used per
+	event handler when a handler is a run to completion task rather than a task
+	blocked on a notification.
+
+	prvControllerTask() creates sstNUM_HANDLERS low priority handlers, recording
+	the heap used per handler (including its share of the stack), then creates
+	and deletes one task with the stack a task per handler would need,
+	recording the heap it used.  It also creates one high priority handler.
+	Each cycle it then notifies every low priority handler with the cycle
+	number, delays, and checks every handler ran with the value it was sent.
+
+	The low priority handlers have a priority below the controller, so all of
+	them are ready at once and have to take turns on their shared stack, while
+	other demo tasks of the same priority time slice with them.  Each handler:
+
+	1) Checks no other low priority handler is part way through, as that
+	   handler would be using the same stack.
+
+	2) Fills a local array with a pattern, notifies the high priority handler
+	   for some handler indexes, then checks the pattern was not overwritten
+	   by the high priority handler, which preempts it on a different stack.
+
+	3) For handler 0 only, notifies itself while running, so the handler must
+	   run a second time, with a notification value of zero.
+
+	vSharedStackPeriodicISRTest() is called from the tick hook, and
+	periodically notifies the high priority handler from an interrupt, so it
+	also preempts the low priority handlers at arbitrary points.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo app include files. */
+#include "SharedStack.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+/* The number of low priority handlers. */
+#ifndef sstNUM_HANDLERS
+	#define sstNUM_HANDLERS					( 128 )
+#endif
+
+#ifndef sstHANDLER_TASK_STACK_SIZE
+	#define sstHANDLER_TASK_STACK_SIZE		configMINIMAL_STACK_SIZE
+#endif
+
+/* Task priorities. */
+#define sstLOW_PRIORITY					( tskIDLE_PRIORITY + 1 )
+#define sstCONTROLLER_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define sstHIGH_PRIORITY				( tskIDLE_PRIORITY + 3 )
+
+/* The time allowed for all the low priority handlers to run. */
+#define sstCYCLE_DELAY					pdMS_TO_TICKS( 50 )
+
+/* Every sstHIGH_NOTIFY_INTERVAL'th low priority handler notifies the high
+priority handler. */
+#define sstHIGH_NOTIFY_INTERVAL			( 8 )
+
+/* The number of words each handler writes to its stack. */
+#define sstPATTERN_WORDS				( 16 )
+
+/* The number of ticks between notifications sent from the tick hook. */
+#define sstISR_PERIOD					( 3 )
+
+/* Marks that no low priority handler is running. */
+#define sstNO_HANDLER					( ( UBaseType_t ) 0xffff )
+
+/* The task and handlers described at the top of this file. */
+static void prvControllerTask( void *pvParameters );
+static void prvLowPriorityHandler( void *pvParameters, uint32_t ulNotifiedValue );
+static void prvHighPriorityHandler( void *pvParameters, uint32_t ulNotifiedValue );
+
+/*
+ * The task created to measure the heap used by one task per handler.  It is
+ * deleted before it gets to run.
+ */
+static void prvHandlerTask( void *pvParameters );
+
+/*
+ * Writes and checks the pattern written to the stack by a handler.
+ */
+static void prvWritePattern( volatile uint32_t *pulPattern, uint32_t ulSeed );
+static BaseType_t prvCheckPattern( volatile uint32_t *pulPattern, uint32_t ulSeed );
+
+/*-----------------------------------------------------------*/
+
+/* Handles of the low priority handlers, and the notification values each
+received. */
+static TaskHandle_t xLowHandlers[ sstNUM_HANDLERS ] = { NULL };
+static volatile uint32_t ulReceived[ sstNUM_HANDLERS ] = { 0 };
+
+static TaskHandle_t xHighHandler = NULL;
+
+/* The low priority handler that is part way through, if any. */
+static volatile UBaseType_t uxRunningHandler = sstNO_HANDLER;
+
+/* Counts of handler executions. */
+static volatile uint32_t ulHighNotifications = 0UL, ulReruns = 0UL;
+
+/* The heap used per handler, as measured by the controller task. */
+static size_t xRunToCompletionBytes = 0, xTaskBytes = 0;
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxControllerCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartSharedStackTasks( void )
+{
+	xTaskCreate( prvControllerTask, "SSCtrl", configMINIMAL_STACK_SIZE, NULL, sstCONTROLLER_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void *pvParameters )
+{
+size_t xFreeHeap;
+TaskHandle_t xTask = NULL;
+UBaseType_t uxIndex;
+uint32_t ulCycle = 0UL, ulLastReruns;
+
+	( void ) pvParameters;
+
+	/* Keep other tasks from allocating memory during the measurements. */
+	vTaskSuspendAll();
+	{
+		xFreeHeap = xPortGetFreeHeapSize();
+
+		for( uxIndex = 0; uxIndex < sstNUM_HANDLERS; uxIndex++ )
+		{
+			if( xTaskCreateRunToCompletion( prvLowPriorityHandler, "SSLow", ( void * ) uxIndex, sstLOW_PRIORITY, &( xLowHandlers[ uxIndex ] ) ) != pdPASS )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		xRunToCompletionBytes = ( xFreeHeap - xPortGetFreeHeapSize() ) / ( size_t ) sstNUM_HANDLERS;
+
+		/* The same measurement for a task, which needs its own stack. */
+		xFreeHeap = xPortGetFreeHeapSize();
+
+		if( xTaskCreate( prvHandlerTask, "SSTask", sstHANDLER_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, &xTask ) == pdPASS )
+		{
+			xTaskBytes = xFreeHeap - xPortGetFreeHeapSize();
+		}
+		else
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	if( xTask != NULL )
+	{
+		vTaskDelete( xTask );
+	}
+
+	if( xTaskCreateRunToCompletion( prvHighPriorityHandler, "SSHigh", NULL, sstHIGH_PRIORITY, &xHighHandler ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	for( ;; )
+	{
+		ulCycle++;
+		ulLastReruns = ulReruns;
+
+		/* The handlers have a lower priority, so do not run until this task
+		delays. */
+		for( uxIndex = 0; uxIndex < sstNUM_HANDLERS; uxIndex++ )
+		{
+			if( xLowHandlers[ uxIndex ] != NULL )
+			{
+				( void ) xTaskNotify( xLowHandlers[ uxIndex ], ulCycle, eSetValueWithOverwrite );
+			}
+		}
+
+		vTaskDelay( sstCYCLE_DELAY );
+
+		for( uxIndex = 0; uxIndex < sstNUM_HANDLERS; uxIndex++ )
+		{
+			if( ulReceived[ uxIndex ] != ulCycle )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+		}
+
+		/* Handler 0 notified itself, so ran a second time. */
+		if( ulReruns == ulLastReruns )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( uxRunningHandler != sstNO_HANDLER )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		uxControllerCycles++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandlerTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityHandler( void *pvParameters, uint32_t ulNotifiedValue )
+{
+const UBaseType_t uxIndex = ( UBaseType_t ) pvParameters;
+volatile uint32_t ulPattern[ sstPATTERN_WORDS ];
+
+	/* 1) No other handler of this priority may be part way through. */
+	if( uxRunningHandler != sstNO_HANDLER )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxRunningHandler = uxIndex;
+
+	if( ulNotifiedValue == 0UL )
+	{
+		/* 3) The second run of handler 0, caused by notifying itself. */
+		if( uxIndex == 0 )
+		{
+			ulReruns++;
+		}
+		else
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	else
+	{
+		ulReceived[ uxIndex ] = ulNotifiedValue;
+
+		/* 2) The high priority handler runs on a different stack, so cannot
+		overwrite this one. */
+		prvWritePattern( ulPattern, ( uint32_t ) uxIndex );
+
+		if( ( ( uxIndex % sstHIGH_NOTIFY_INTERVAL ) == 0 ) && ( xHighHandler != NULL ) )
+		{
+			xTaskNotifyGive( xHighHandler );
+		}
+
+		if( prvCheckPattern( ulPattern, ( uint32_t ) uxIndex ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( uxIndex == 0 )
+		{
+			( void ) xTaskNotify( xLowHandlers[ 0 ], 0UL, eNoAction );
+		}
+	}
+
+	uxRunningHandler = sstNO_HANDLER;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHighPriorityHandler( void *pvParameters, uint32_t ulNotifiedValue )
+{
+volatile uint32_t ulPattern[ sstPATTERN_WORDS ];
+
+	( void ) pvParameters;
+
+	/* The notification value is the number of times the handler was notified
+	since it last ran. */
+	if( ulNotifiedValue == 0UL )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	ulHighNotifications += ulNotifiedValue;
+
+	prvWritePattern( ulPattern, ~ulNotifiedValue );
+
+	if( prvCheckPattern( ulPattern, ~ulNotifiedValue ) != pdPASS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWritePattern( volatile uint32_t *pulPattern, uint32_t ulSeed )
+{
+UBaseType_t uxWord;
+
+	for( uxWord = 0; uxWord < sstPATTERN_WORDS; uxWord++ )
+	{
+		pulPattern[ uxWord ] = ( ulSeed << 8 ) ^ ( uint32_t ) uxWord;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckPattern( volatile uint32_t *pulPattern, uint32_t ulSeed )
+{
+UBaseType_t uxWord;
+BaseType_t xReturn = pdPASS;
+
+	for( uxWord = 0; uxWord < sstPATTERN_WORDS; uxWord++ )
+	{
+		if( pulPattern[ uxWord ] != ( ( ulSeed << 8 ) ^ ( uint32_t ) uxWord ) )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vSharedStackPeriodicISRTest( void )
+{
+static UBaseType_t uxTicks = 0;
+
+	uxTicks++;
+
+	if( ( uxTicks >= sstISR_PERIOD ) && ( xHighHandler != NULL ) )
+	{
+		uxTicks = 0;
+		vTaskNotifyGiveFromISR( xHighHandler, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vGetSharedStackBenchmarkResults( size_t *pxRunToCompletionBytes, size_t *pxTaskBytes )
+{
+	*pxRunToCompletionBytes = xRunToCompletionBytes;
+	*pxTaskBytes = xTaskBytes;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreSharedStackTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastControllerCycles = 0;
+static uint32_t ulLastHighNotifications = 0UL;
+
+	if( uxLastControllerCycles == uxControllerCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastControllerCycles = uxControllerCycles;
+
+	if( ulLastHighNotifications == ulHighNotifications )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	ulLastHighNotifications = ulHighNotifications;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_SHARED_STACK_TASKS */
@@ -0,0 +1,374 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+	Tests the kernel object slab caches included in the build when
+	configUSE_KERNEL_OBJECT_SLABS is set to 1.
+
+	vStartSlabCacheTasks() reserves scNUM_OBJECTS objects in every cache before
+	the scheduler is started.  Each cycle prvSlabCacheTask() then creates
+	scNUM_OBJECTS queues, semaphores, timers, event groups, stream buffers,
+	message buffers and tasks, checks each object can be used, and deletes them
+	all again - which is the pattern of object use the caches are intended for.
+
+	Freed objects are reused most recently freed first, so with the scheduler
+	suspended deleting an object then creating another of the same type must
+	return the same memory.  The statistics of every cache must also remain
+	consistent however other tasks are using the caches - the objects in use
+	plus the objects free must equal the objects held by all the cache's slabs,
+	and the allocations less the frees must equal the objects in use.  As the
+	heap is never exhausted in this demo, no allocation can fail.
+*/
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include "event_groups.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+#include "slab.h"
+
+/* Demo app include files. */
+#include "SlabCache.h"
+
+/* This file can only be used if the functionality it tests is included in the
+build.  Remove the whole file if this is not the case. */
+#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+
+/* Priority of the task described at the top of this file, and of the tasks it
+creates, which must never run. */
+#define scTEST_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define scCREATED_TASK_PRIORITY		( tskIDLE_PRIORITY )
+
+/* The number of objects of each type created each cycle, and reserved in each
+cache when the demo starts. */
+#define scNUM_OBJECTS				( 4 )
+
+/* Sizes used for the objects created each cycle. */
+#define scQUEUE_LENGTH				( 2 )
+#define scBUFFER_SIZE_BYTES			( 16 )
+
+/* Timing. */
+#define scCYCLE_DELAY				pdMS_TO_TICKS( 20 )
+#define scTIMER_PERIOD				pdMS_TO_TICKS( 1000 )
+#define scDONT_BLOCK				( ( TickType_t ) 0 )
+#define scTIMER_COMMAND_BLOCK_TIME	pdMS_TO_TICKS( 100 )
+
+#ifndef scSLAB_CACHE_TEST_TASK_STACK_SIZE
+	#define scSLAB_CACHE_TEST_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* The task described at the top of this file. */
+static void prvSlabCacheTask( void *pvParameters );
+
+/* The tasks created and deleted by prvSlabCacheTask(), which never run as
+they have a lower priority than prvSlabCacheTask(). */
+static void prvCreatedTask( void *pvParameters );
+
+/* The callback used by the timers created each cycle, which never expire. */
+static void prvTimerCallback( TimerHandle_t xTimer );
+
+/*
+ * Create, use and delete scNUM_OBJECTS objects of every type.
+ */
+static void prvCreateAndDeleteObjects( void );
+
+/*
+ * Check objects freed with the scheduler suspended are reused straight away.
+ */
+static void prvCheckObjectReuse( void );
+
+/*
+ * Check the statistics of every cache are consistent.
+ */
+static void prvCheckCacheStats( void );
+
+/*-----------------------------------------------------------*/
+
+/* Variables used to detect and latch errors. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+static volatile UBaseType_t uxCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartSlabCacheTasks( void )
+{
+eSlabCache eCache;
+
+	/* Populate the caches before the heap becomes fragmented. */
+	for( eCache = eSlabCacheTask; eCache < eSlabCacheCount; eCache++ )
+	{
+		if( xSlabCacheReserve( eCache, scNUM_OBJECTS ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+
+	xTaskCreate( prvSlabCacheTask, "SlabCache", scSLAB_CACHE_TEST_TASK_STACK_SIZE, NULL, scTEST_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSlabCacheTask( void *pvParameters )
+{
+	/* Remove compiler warning about unused parameter. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvCreateAndDeleteObjects();
+		prvCheckObjectReuse();
+		prvCheckCacheStats();
+
+		uxCycles++;
+		vTaskDelay( scCYCLE_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateAndDeleteObjects( void )
+{
+QueueHandle_t xQueues[ scNUM_OBJECTS ];
+SemaphoreHandle_t xSemaphores[ scNUM_OBJECTS ];
+TimerHandle_t xTimers[ scNUM_OBJECTS ];
+EventGroupHandle_t xEventGroups[ scNUM_OBJECTS ];
+StreamBufferHandle_t xStreamBuffers[ scNUM_OBJECTS ];
+MessageBufferHandle_t xMessageBuffers[ scNUM_OBJECTS ];
+TaskHandle_t xTasks[ scNUM_OBJECTS ];
+UBaseType_t uxObject;
+uint32_t ulValue;
+
+	for( uxObject = 0; uxObject < scNUM_OBJECTS; uxObject++ )
+	{
+		xQueues[ uxObject ] = xQueueCreate( scQUEUE_LENGTH, sizeof( uint32_t ) );
+		xSemaphores[ uxObject ] = xSemaphoreCreateBinary();
+		xTimers[ uxObject ] = xTimerCreate( "SlabTmr", scTIMER_PERIOD, pdFALSE, NULL, prvTimerCallback );
+		xEventGroups[ uxObject ] = xEventGroupCreate();
+		xStreamBuffers[ uxObject ] = xStreamBufferCreate( scBUFFER_SIZE_BYTES, 1 );
+		xMessageBuffers[ uxObject ] = xMessageBufferCreate( scBUFFER_SIZE_BYTES );
+
+		if( xTaskCreate( prvCreatedTask, "SlabTsk", configMINIMAL_STACK_SIZE, NULL, scCREATED_TASK_PRIORITY, &( xTasks[ uxObject ] ) ) != pdPASS )
+		{
+			xTasks[ uxObject ] = NULL;
+		}
+
+		if( ( xQueues[ uxObject ] == NULL ) || ( xSemaphores[ uxObject ] == NULL ) || ( xTimers[ uxObject ] == NULL ) ||
+			( xEventGroups[ uxObject ] == NULL ) || ( xStreamBuffers[ uxObject ] == NULL ) || ( xMessageBuffers[ uxObject ] == NULL ) ||
+			( xTasks[ uxObject ] == NULL ) )
+		{
+			/* The heap is never exhausted, so the objects must have been
+			created.  Nothing can be done safely after this. */
+			xErrorOccurred = pdTRUE;
+			vTaskSuspend( NULL );
+		}
+	}
+
+	/* Use every object, writing a value that identifies the object so an
+	object that shared memory with another would be detected. */
+	for( uxObject = 0; uxObject < scNUM_OBJECTS; uxObject++ )
+	{
+		ulValue = ( uint32_t ) uxObject;
+		( void ) xQueueSend( xQueues[ uxObject ], &ulValue, scDONT_BLOCK );
+		( void ) xSemaphoreGive( xSemaphores[ uxObject ] );
+		( void ) xEventGroupSetBits( xEventGroups[ uxObject ], ( EventBits_t ) ( 1UL << uxObject ) );
+		( void ) xStreamBufferSend( xStreamBuffers[ uxObject ], &ulValue, sizeof( ulValue ), scDONT_BLOCK );
+		( void ) xMessageBufferSend( xMessageBuffers[ uxObject ], &ulValue, sizeof( ulValue ), scDONT_BLOCK );
+		vTimerSetTimerID( xTimers[ uxObject ], ( void * ) xQueues[ uxObject ] );
+	}
+
+	for( uxObject = 0; uxObject < scNUM_OBJECTS; uxObject++ )
+	{
+		ulValue = ~( uint32_t ) 0;
+		if( ( xQueueReceive( xQueues[ uxObject ], &ulValue, scDONT_BLOCK ) != pdPASS ) || ( ulValue != ( uint32_t ) uxObject ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xSemaphoreTake( xSemaphores[ uxObject ], scDONT_BLOCK ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( xEventGroupGetBits( xEventGroups[ uxObject ] ) != ( EventBits_t ) ( 1UL << uxObject ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		ulValue = ~( uint32_t ) 0;
+		if( ( xStreamBufferReceive( xStreamBuffers[ uxObject ], &ulValue, sizeof( ulValue ), scDONT_BLOCK ) != sizeof( ulValue ) ) || ( ulValue != ( uint32_t ) uxObject ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		ulValue = ~( uint32_t ) 0;
+		if( ( xMessageBufferReceive( xMessageBuffers[ uxObject ], &ulValue, sizeof( ulValue ), scDONT_BLOCK ) != sizeof( ulValue ) ) || ( ulValue != ( uint32_t ) uxObject ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( pvTimerGetTimerID( xTimers[ uxObject ] ) != ( void * ) xQueues[ uxObject ] )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+
+	for( uxObject = 0; uxObject < scNUM_OBJECTS; uxObject++ )
+	{
+		vQueueDelete( xQueues[ uxObject ] );
+		vSemaphoreDelete( xSemaphores[ uxObject ] );
+		vEventGroupDelete( xEventGroups[ uxObject ] );
+		vStreamBufferDelete( xStreamBuffers[ uxObject ] );
+		vMessageBufferDelete( xMessageBuffers[ uxObject ] );
+		vTaskDelete( xTasks[ uxObject ] );
+	}
+
+	/* Timers are deleted last as sending the delete command can block, and
+	the created tasks must not run.  The timers are freed by the timer service
+	task. */
+	for( uxObject = 0; uxObject < scNUM_OBJECTS; uxObject++ )
+	{
+		if( xTimerDelete( xTimers[ uxObject ], scTIMER_COMMAND_BLOCK_TIME ) != pdPASS )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckObjectReuse( void )
+{
+SemaphoreHandle_t xSemaphore, xNextSemaphore;
+EventGroupHandle_t xEventGroup, xNextEventGroup;
+
+	/* Suspend the scheduler so no other task can take the freed objects. */
+	vTaskSuspendAll();
+	{
+		xSemaphore = xSemaphoreCreateMutex();
+		xEventGroup = xEventGroupCreate();
+
+		if( ( xSemaphore != NULL ) && ( xEventGroup != NULL ) )
+		{
+			vSemaphoreDelete( xSemaphore );
+			vEventGroupDelete( xEventGroup );
+
+			xNextSemaphore = xSemaphoreCreateMutex();
+			xNextEventGroup = xEventGroupCreate();
+
+			if( ( xNextSemaphore != xSemaphore ) || ( xNextEventGroup != xEventGroup ) )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			if( xNextSemaphore != NULL )
+			{
+				vSemaphoreDelete( xNextSemaphore );
+			}
+
+			if( xNextEventGroup != NULL )
+			{
+				vEventGroupDelete( xNextEventGroup );
+			}
+		}
+		else
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckCacheStats( void )
+{
+eSlabCache eCache;
+SlabCacheStats_t xStats;
+
+	for( eCache = eSlabCacheTask; eCache < eSlabCacheCount; eCache++ )
+	{
+		vSlabCacheGetStats( eCache, &xStats );
+
+		if( ( xStats.xObjectsInUse + xStats.xObjectsFree ) != ( xStats.xNumberOfSlabs * ( size_t ) configSLAB_OBJECTS_PER_SLAB ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( ( xStats.xNumberOfSuccessfulAllocations - xStats.xNumberOfSuccessfulFrees ) != xStats.xObjectsInUse )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		if( ( xStats.xMaximumObjectsInUse < xStats.xObjectsInUse ) || ( xStats.xNumberOfFailedAllocations != ( size_t ) 0 ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreatedTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	/* Should never run as it is deleted before the idle task gets a chance to
+	run. */
+	xErrorOccurred = pdTRUE;
+	vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( TimerHandle_t xTimer )
+{
+	( void ) xTimer;
+
+	/* The timers are never started. */
+	xErrorOccurred = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreSlabCacheTasksStillRunning( void )
+{
+BaseType_t xReturn = pdPASS;
+static UBaseType_t uxLastCycles = 0;
+
+	if( uxLastCycles == uxCycles )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	uxLastCycles = uxCycles;
+
+	if( xErrorOccurred == pdTRUE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+
+#endif /* configUSE_KERNEL_OBJECT_SLABS == 1 */
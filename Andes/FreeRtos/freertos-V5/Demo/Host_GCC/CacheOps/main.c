@@ -0,0 +1,334 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test of the scatter-gather DMA cache maintenance in
+ * Demo/V5/RTOSDemo_bsp/cache.c.
+ *
+ * cache.c is built as a native host program against nds_intrinsic.h and
+ * platform.h in this directory (see the Makefile, "make test" builds and runs
+ * the test).  The CSR model below describes an 8KB L1 D-cache with 32 byte
+ * lines, no L2 cache and no DMA coherence port, and records each CCTL command
+ * cache.c issues along with whether interrupts were enabled at the time.
+ *
+ * The test checks that nds_dma_writeback_ranges() and
+ * nds_dma_invalidate_ranges() sort and merge the ranges, issue a cache line
+ * shared by several ranges once, write back rather than invalidate the
+ * boundary lines of a range, disable interrupts once for the whole list, and
+ * switch to whole cache operations once the merged ranges cover more than the
+ * D-cache.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cache.h"
+#include "platform.h"
+
+/* MDCM_CFG: 32 byte lines (DSIZE 3), 4 ways (DWAY 3) and 64 sets (DSET 0). */
+#define testMDCM_CFG				( ( 3UL << 6 ) | ( 3UL << 3 ) | 0UL )
+#define testLINE_SIZE				( 32UL )
+#define testDCACHE_SIZE				( 8192UL )
+
+/* The L1 CCTL commands, as defined in cache.c. */
+#define testL1D_VA_INVAL			( 0UL )
+#define testL1D_VA_WB				( 1UL )
+#define testL1D_VA_WBINVAL			( 2UL )
+#define testL1D_WBINVAL_ALL			( 6UL )
+#define testL1D_WB_ALL				( 7UL )
+
+/* The address recorded for commands that operate on the whole cache. */
+#define testALL_LINES				( ~0UL )
+
+/* The most commands recorded by one call. */
+#define testMAX_COMMANDS			( 512 )
+
+/* Report the line of the first check that fails, and exit. */
+#define testCHECK( x )		prvCheck( ( x ), #x, __LINE__ )
+
+/*-----------------------------------------------------------*/
+
+/* A CCTL command issued by cache.c. */
+typedef struct CCTL_COMMAND
+{
+	unsigned long ulCommand;
+	unsigned long ulAddress;
+	int iInterruptsEnabled;
+} CctlCommand_t;
+
+/*
+ * Check that the commands recorded since the last call are exactly the
+ * uxExpected commands in pxExpected, in order, and that every command was
+ * issued with interrupts disabled.  Then clear the record.
+ */
+static void prvCheckCommands( const CctlCommand_t *pxExpected, size_t uxExpected, int iLine );
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine );
+
+/*-----------------------------------------------------------*/
+
+SMU_RegDef xSmuModel;
+L2C_RegDef xL2cModel;
+
+/* The CSR model.  mstatus starts with interrupts enabled. */
+static unsigned long ulMstatus = MSTATUS_MIE;
+static unsigned long ulCctlBeginAddress = 0;
+
+/* The commands recorded, and the number of times interrupts were disabled. */
+static CctlCommand_t xCommands[ testMAX_COMMANDS ];
+static size_t uxCommands = 0;
+static unsigned long ulInterruptDisables = 0;
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+size_t x;
+
+	/* cache.c reads the cache configuration on first use, with interrupts
+	disabled, so that is done before interrupts are counted. */
+	nds_dma_writeback_ranges( NULL, 0 );
+	prvCheckCommands( NULL, 0, __LINE__ );
+	ulInterruptDisables = 0;
+
+	/* Writeback.  The ranges are sorted, the two that touch are merged, the
+	empty range is dropped, and the lines at 0x120 and 0x140, which are each
+	shared by two ranges, are written back once. */
+	{
+	struct nds_dma_range xRanges[] = { { 0x140, 0x10 }, { 0x100, 0x30 }, { 0x130, 0x8 }, { 0x1000, 0 }, { 0x158, 0x30 } };
+	const CctlCommand_t xExpected[] =
+	{
+		{ testL1D_VA_WB, 0x100, 0 },
+		{ testL1D_VA_WB, 0x120, 0 },
+		{ testL1D_VA_WB, 0x140, 0 },
+		{ testL1D_VA_WB, 0x160, 0 },
+		{ testL1D_VA_WB, 0x180, 0 }
+	};
+
+		nds_dma_writeback_ranges( xRanges, sizeof( xRanges ) / sizeof( xRanges[ 0 ] ) );
+		prvCheckCommands( xExpected, sizeof( xExpected ) / sizeof( xExpected[ 0 ] ), __LINE__ );
+		testCHECK( ulInterruptDisables == 1 );
+
+		/* The list is left sorted and merged. */
+		testCHECK( ( xRanges[ 0 ].start == 0x100 ) && ( xRanges[ 0 ].size == 0x38 ) );
+		testCHECK( ( xRanges[ 1 ].start == 0x140 ) && ( xRanges[ 1 ].size == 0x10 ) );
+		testCHECK( ( xRanges[ 2 ].start == 0x158 ) && ( xRanges[ 2 ].size == 0x30 ) );
+	}
+
+	/* Invalidate.  The unaligned boundary lines are written back and
+	invalidated rather than invalidated, so the bytes between 0x214 and 0x218
+	are kept.  The lines at 0x200 and 0x240, each shared by two ranges, are
+	operated on once. */
+	{
+	struct nds_dma_range xRanges[] = { { 0x204, 0x10 }, { 0x300, 0x40 }, { 0x24c, 0x4 }, { 0x218, 0x30 } };
+	const CctlCommand_t xExpected[] =
+	{
+		{ testL1D_VA_WBINVAL, 0x200, 0 },
+		{ testL1D_VA_INVAL, 0x220, 0 },
+		{ testL1D_VA_WBINVAL, 0x240, 0 },
+		{ testL1D_VA_INVAL, 0x300, 0 },
+		{ testL1D_VA_INVAL, 0x320, 0 }
+	};
+
+		ulInterruptDisables = 0;
+		nds_dma_invalidate_ranges( xRanges, sizeof( xRanges ) / sizeof( xRanges[ 0 ] ) );
+		prvCheckCommands( xExpected, sizeof( xExpected ) / sizeof( xExpected[ 0 ] ), __LINE__ );
+		testCHECK( ulInterruptDisables == 1 );
+	}
+
+	/* Ranges that cover exactly the D-cache are still operated on line by
+	line. */
+	{
+	struct nds_dma_range xRanges[] = { { 0x10000, testDCACHE_SIZE } };
+	CctlCommand_t xExpected[ testDCACHE_SIZE / testLINE_SIZE ];
+
+		for( x = 0; x < ( testDCACHE_SIZE / testLINE_SIZE ); x++ )
+		{
+			xExpected[ x ].ulCommand = testL1D_VA_WB;
+			xExpected[ x ].ulAddress = 0x10000 + ( x * testLINE_SIZE );
+			xExpected[ x ].iInterruptsEnabled = 0;
+		}
+
+		nds_dma_writeback_ranges( xRanges, 1 );
+		prvCheckCommands( xExpected, sizeof( xExpected ) / sizeof( xExpected[ 0 ] ), __LINE__ );
+	}
+
+	/* Once the merged lines cover more than the D-cache, the whole cache is
+	written back, or written back and invalidated. */
+	{
+	struct nds_dma_range xRanges[] = { { 0x0, 0x1000 }, { 0x4000, 0x1001 } };
+	const CctlCommand_t xWriteback[] = { { testL1D_WB_ALL, testALL_LINES, 0 } };
+	const CctlCommand_t xInvalidate[] = { { testL1D_WBINVAL_ALL, testALL_LINES, 0 } };
+
+		nds_dma_writeback_ranges( xRanges, 2 );
+		prvCheckCommands( xWriteback, 1, __LINE__ );
+
+		nds_dma_invalidate_ranges( xRanges, 2 );
+		prvCheckCommands( xInvalidate, 1, __LINE__ );
+	}
+
+	/* Lists with no bytes in them issue nothing and leave interrupts alone. */
+	{
+	struct nds_dma_range xRanges[] = { { 0x100, 0 }, { 0x200, 0 } };
+
+		ulInterruptDisables = 0;
+		nds_dma_writeback_ranges( xRanges, 2 );
+		nds_dma_invalidate_ranges( xRanges, 2 );
+		nds_dma_invalidate_ranges( xRanges, 0 );
+		prvCheckCommands( NULL, 0, __LINE__ );
+		testCHECK( ulInterruptDisables == 0 );
+	}
+
+	/* Interrupts are enabled again after every call. */
+	testCHECK( ( ulMstatus & MSTATUS_MIE ) != 0 );
+
+	printf( "cache ops tests passed\r\n" );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckCommands( const CctlCommand_t *pxExpected, size_t uxExpected, int iLine )
+{
+size_t x;
+
+	if( uxCommands != uxExpected )
+	{
+		printf( "main.c:%d: %lu commands issued, expected %lu\n", iLine, ( unsigned long ) uxCommands, ( unsigned long ) uxExpected );
+		exit( 1 );
+	}
+
+	for( x = 0; x < uxCommands; x++ )
+	{
+		if( ( xCommands[ x ].ulCommand != pxExpected[ x ].ulCommand ) ||
+			( xCommands[ x ].ulAddress != pxExpected[ x ].ulAddress ) ||
+			( xCommands[ x ].iInterruptsEnabled != 0 ) )
+		{
+			printf( "main.c:%d: command %lu is %lu at 0x%lx with interrupts %s, expected %lu at 0x%lx\n", iLine, ( unsigned long ) x,
+					xCommands[ x ].ulCommand, xCommands[ x ].ulAddress, ( xCommands[ x ].iInterruptsEnabled != 0 ) ? "enabled" : "disabled",
+					pxExpected[ x ].ulCommand, pxExpected[ x ].ulAddress );
+			exit( 1 );
+		}
+	}
+
+	uxCommands = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine )
+{
+	if( iResult == 0 )
+	{
+		printf( "main.c:%d: check failed: %s\n", iLine, pcExpression );
+		exit( 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* CSR model, see nds_intrinsic.h. */
+
+unsigned long __nds__csrr( unsigned long ulCsr )
+{
+unsigned long ulValue = 0;
+
+	switch( ulCsr )
+	{
+		case NDS_MSTATUS:
+			ulValue = ulMstatus;
+			break;
+
+		case NDS_MDCM_CFG:
+			ulValue = testMDCM_CFG;
+			break;
+
+		default:
+			/* No I-cache geometry, no coherence port and no MSC_EXT. */
+			break;
+	}
+
+	return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+void __nds__csrw( unsigned long ulValue, unsigned long ulCsr )
+{
+	if( ulCsr == NDS_MCCTLBEGINADDR )
+	{
+		ulCctlBeginAddress = ulValue;
+	}
+	else if( ulCsr == NDS_MCCTLCOMMAND )
+	{
+		testCHECK( uxCommands < testMAX_COMMANDS );
+
+		xCommands[ uxCommands ].ulCommand = ulValue;
+		xCommands[ uxCommands ].iInterruptsEnabled = ( ( ulMstatus & MSTATUS_MIE ) != 0 );
+
+		if( ( ulValue == testL1D_WBINVAL_ALL ) || ( ulValue == testL1D_WB_ALL ) )
+		{
+			xCommands[ uxCommands ].ulAddress = testALL_LINES;
+		}
+		else
+		{
+			xCommands[ uxCommands ].ulAddress = ulCctlBeginAddress;
+		}
+
+		uxCommands++;
+	}
+	else
+	{
+		testCHECK( ulCsr == NDS_MSTATUS );
+		ulMstatus = ulValue;
+	}
+}
+/*-----------------------------------------------------------*/
+
+unsigned long __nds__csrrs( unsigned long ulBits, unsigned long ulCsr )
+{
+unsigned long ulValue = ulMstatus;
+
+	testCHECK( ulCsr == NDS_MSTATUS );
+	ulMstatus |= ulBits;
+
+	return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+unsigned long __nds__csrrc( unsigned long ulBits, unsigned long ulCsr )
+{
+unsigned long ulValue = ulMstatus;
+
+	testCHECK( ulCsr == NDS_MSTATUS );
+
+	if( ( ( ulMstatus & MSTATUS_MIE ) != 0 ) && ( ( ulBits & MSTATUS_MIE ) != 0 ) )
+	{
+		ulInterruptDisables++;
+	}
+
+	ulMstatus &= ~ulBits;
+
+	return ulValue;
+}
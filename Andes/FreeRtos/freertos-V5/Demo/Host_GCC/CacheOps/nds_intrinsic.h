@@ -0,0 +1,57 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef NDS_INTRINSIC_H
+#define NDS_INTRINSIC_H
+
+/*-----------------------------------------------------------
+ * Host stand in for the Andes toolchain's nds_intrinsic.h, used to build
+ * cache.c.  The CSR intrinsics call the CSR model in main.c, which records the
+ * CCTL commands cache.c issues and the state of mstatus.MIE when it issues
+ * them.
+ *-----------------------------------------------------------*/
+
+/* Only the CSRs accessed by cache.c. */
+enum
+{
+	NDS_MSTATUS,
+	NDS_MICM_CFG,
+	NDS_MDCM_CFG,
+	NDS_MMSC_CFG,
+	NDS_MMSC_CFG2,
+	NDS_MCACHE_CTL,
+	NDS_MCCTLBEGINADDR,
+	NDS_MCCTLCOMMAND
+};
+
+/* Public API of the CSR model in main.c. */
+unsigned long __nds__csrr( unsigned long ulCsr );
+void __nds__csrw( unsigned long ulValue, unsigned long ulCsr );
+unsigned long __nds__csrrs( unsigned long ulBits, unsigned long ulCsr );
+unsigned long __nds__csrrc( unsigned long ulBits, unsigned long ulCsr );
+
+#endif /* NDS_INTRINSIC_H */
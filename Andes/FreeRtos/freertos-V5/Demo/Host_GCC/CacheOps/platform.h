@@ -0,0 +1,64 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+/*-----------------------------------------------------------
+ * Host stand in for the AE250 platform.h, used to build cache.c.  DEV_SMU
+ * points to ordinary memory with SYSTEMCFG clear, so cache.c finds no L2
+ * cache and only issues L1 CCTL commands, which go through the CSR model in
+ * main.c.  DEV_L2C is defined so cache.c builds, but is never accessed.
+ *-----------------------------------------------------------*/
+
+#include <stdint.h>
+
+#define __I		volatile const
+#define __O		volatile
+#define __IO	volatile
+
+typedef struct {
+	__I  unsigned int IDREV;                /* 0x00 ID and Revision Register */
+	     unsigned int RESERVED0[1];         /* 0x04 Reserved */
+	__I  unsigned int SYSTEMCFG;            /* 0x08 SYSTEM configuration register */
+} SMU_RegDef;
+
+typedef struct {
+	struct {
+		__IO unsigned long long CCTLCMD;        /* Core CCTL Command Register */
+		__IO unsigned long long CCTLACC;        /* Core CCTL Access Line Register */
+		__I  unsigned long long CCTLSTATUS;     /* Core CCTL Status Register */
+	} CORECCTL[1];
+} L2C_RegDef;
+
+extern SMU_RegDef xSmuModel;
+extern L2C_RegDef xL2cModel;
+
+#define DEV_SMU				( &xSmuModel )
+#define DEV_L2C				( &xL2cModel )
+
+#endif /* PLATFORM_H */
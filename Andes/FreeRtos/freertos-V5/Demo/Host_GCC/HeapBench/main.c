@@ -0,0 +1,288 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host benchmark for the FreeRTOS memory allocators.
+ *
+ * The same source is linked against heap_4.c, heap_5.c and heap_6.c (see the
+ * Makefile in this directory, "make run" builds and runs all three).  Every
+ * allocator is given the same configTOTAL_HEAP_SIZE bytes - heap_4.c as a single
+ * array, heap_5.c and heap_6.c as two regions with a gap between them - then
+ * a deterministic pseudo random sequence of allocations and frees is applied.
+ *
+ * The time taken by each call to pvPortMalloc() and vPortFree() is measured and
+ * the mean, 99th percentile and maximum are reported, followed by the
+ * fragmentation of the heap at the end of the run as reported by
+ * vPortGetHeapStats().  Times are wall clock times on the host, so are only
+ * meaningful relative to each other.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The number of allocations that can be live at any one time. */
+#define benchNUM_SLOTS			( 2048 )
+
+/* The number of allocations and frees measured, after benchWARM_UP_OPS
+operations have been used to fragment the heap. */
+#define benchNUM_OPS			( 400000 )
+#define benchWARM_UP_OPS		( 100000 )
+
+/* Seed for the pseudo random sequence, so every allocator sees the same
+requests. */
+#define benchRANDOM_SEED		( 0x12345678UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Linear congruential generator, used in place of rand() so the sequence
+ * does not depend on the host C library.
+ */
+static uint32_t prvRandom( void );
+
+/*
+ * Return a request size.  Most requests are small, as they are for kernel
+ * objects, with occasional larger buffers.
+ */
+static size_t prvRandomSize( void );
+
+/*
+ * Allocate or free the memory held by a randomly chosen slot, recording the
+ * time taken if pulTimes is not NULL.
+ */
+static void prvDoOperation( uint32_t *pulMallocTimes, size_t *pxMallocs, uint32_t *pulFreeTimes, size_t *pxFrees );
+
+/*
+ * Sort an array of times and print its mean, 99th percentile and maximum.
+ */
+static void prvReportTimes( const char *pcName, uint32_t *pulTimes, size_t xCount );
+
+static uint32_t prvNanoseconds( void );
+static int prvCompareTimes( const void *pv1, const void *pv2 );
+
+/*-----------------------------------------------------------*/
+
+/* The heap itself, see configAPPLICATION_ALLOCATED_HEAP. */
+uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+
+static void *pvSlots[ benchNUM_SLOTS ];
+static uint32_t ulRandomState = benchRANDOM_SEED;
+static size_t xFailedAllocations = 0;
+
+static uint32_t ulMallocTimes[ benchNUM_OPS ];
+static uint32_t ulFreeTimes[ benchNUM_OPS ];
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+size_t xOp, xMallocs = 0, xFrees = 0, xLiveBytes = 0, xSlot;
+HeapStats_t xHeapStats;
+
+	#if( BENCH_HEAP != 4 )
+	{
+		/* Two regions, with a gap between them that is not part of the heap.
+		Regions must be passed to heap_5.c in address order. */
+		const HeapRegion_t xHeapRegions[] =
+		{
+			{ ucHeap, configTOTAL_HEAP_SIZE / 2 },
+			{ ucHeap + ( configTOTAL_HEAP_SIZE / 2 ) + 4096, ( configTOTAL_HEAP_SIZE / 2 ) - 4096 },
+			{ NULL, 0 }
+		};
+
+		vPortDefineHeapRegions( xHeapRegions );
+	}
+	#endif
+
+	for( xOp = 0; xOp < benchWARM_UP_OPS; xOp++ )
+	{
+		prvDoOperation( NULL, NULL, NULL, NULL );
+	}
+
+	xFailedAllocations = 0;
+
+	for( xOp = 0; xOp < benchNUM_OPS; xOp++ )
+	{
+		prvDoOperation( ulMallocTimes, &xMallocs, ulFreeTimes, &xFrees );
+	}
+
+	for( xSlot = 0; xSlot < benchNUM_SLOTS; xSlot++ )
+	{
+		if( pvSlots[ xSlot ] != NULL )
+		{
+			xLiveBytes += *( ( size_t * ) pvSlots[ xSlot ] );
+		}
+	}
+
+	vPortGetHeapStats( &xHeapStats );
+
+	printf( "heap_%d\r\n", BENCH_HEAP );
+	prvReportTimes( "  malloc", ulMallocTimes, xMallocs );
+	prvReportTimes( "  free  ", ulFreeTimes, xFrees );
+	printf( "  failed allocations     %lu of %lu\r\n", ( unsigned long ) xFailedAllocations, ( unsigned long ) ( xMallocs + xFailedAllocations ) );
+	printf( "  bytes requested (live) %lu\r\n", ( unsigned long ) xLiveBytes );
+	printf( "  free bytes             %lu\r\n", ( unsigned long ) xHeapStats.xAvailableHeapSpaceInBytes );
+	printf( "  largest free block     %lu\r\n", ( unsigned long ) xHeapStats.xSizeOfLargestFreeBlockInBytes );
+	printf( "  free blocks            %lu\r\n", ( unsigned long ) xHeapStats.xNumberOfFreeBlocks );
+	printf( "  minimum ever free      %lu\r\n", ( unsigned long ) xHeapStats.xMinimumEverFreeBytesRemaining );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDoOperation( uint32_t *pulMallocTimes, size_t *pxMallocs, uint32_t *pulFreeTimes, size_t *pxFrees )
+{
+uint32_t ulSlot, ulStart, ulEnd;
+size_t xSize;
+void *pv;
+
+	ulSlot = prvRandom() % benchNUM_SLOTS;
+
+	if( pvSlots[ ulSlot ] == NULL )
+	{
+		xSize = prvRandomSize();
+
+		ulStart = prvNanoseconds();
+		pv = pvPortMalloc( xSize );
+		ulEnd = prvNanoseconds();
+
+		if( pv != NULL )
+		{
+			/* Touch the memory and remember its size, so any corruption of the
+			heap structures shows up as an assert in the allocator. */
+			memset( pv, 0xa5, xSize );
+			*( ( size_t * ) pv ) = xSize;
+			pvSlots[ ulSlot ] = pv;
+
+			if( pulMallocTimes != NULL )
+			{
+				pulMallocTimes[ *pxMallocs ] = ulEnd - ulStart;
+				( *pxMallocs )++;
+			}
+		}
+		else
+		{
+			xFailedAllocations++;
+		}
+	}
+	else
+	{
+		ulStart = prvNanoseconds();
+		vPortFree( pvSlots[ ulSlot ] );
+		ulEnd = prvNanoseconds();
+
+		pvSlots[ ulSlot ] = NULL;
+
+		if( pulFreeTimes != NULL )
+		{
+			pulFreeTimes[ *pxFrees ] = ulEnd - ulStart;
+			( *pxFrees )++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReportTimes( const char *pcName, uint32_t *pulTimes, size_t xCount )
+{
+size_t x;
+uint64_t ullTotal = 0;
+
+	if( xCount == 0 )
+	{
+		return;
+	}
+
+	qsort( pulTimes, xCount, sizeof( uint32_t ), prvCompareTimes );
+
+	for( x = 0; x < xCount; x++ )
+	{
+		ullTotal += pulTimes[ x ];
+	}
+
+	printf( "%s ns: mean %lu, p99 %lu, max %lu (%lu calls)\r\n", pcName, ( unsigned long ) ( ullTotal / xCount ), ( unsigned long ) pulTimes[ ( xCount * 99 ) / 100 ], ( unsigned long ) pulTimes[ xCount - 1 ], ( unsigned long ) xCount );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+	ulRandomState = ( ulRandomState * 1103515245UL ) + 12345UL;
+	return ulRandomState >> 8;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvRandomSize( void )
+{
+uint32_t ulClass = prvRandom() % 100;
+
+	if( ulClass < 70 )
+	{
+		return 16 + ( prvRandom() % 240 );
+	}
+	else if( ulClass < 95 )
+	{
+		return 256 + ( prvRandom() % 1792 );
+	}
+	else
+	{
+		return 2048 + ( prvRandom() % 14336 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvNanoseconds( void )
+{
+struct timespec xTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &xTime );
+	return ( uint32_t ) ( ( ( uint64_t ) xTime.tv_sec * 1000000000ULL ) + ( uint64_t ) xTime.tv_nsec );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareTimes( const void *pv1, const void *pv2 )
+{
+uint32_t ul1 = *( const uint32_t * ) pv1, ul2 = *( const uint32_t * ) pv2;
+
+	return ( ul1 > ul2 ) - ( ul1 < ul2 );
+}
+/*-----------------------------------------------------------*/
+
+/* There is no scheduler, so there is nothing to suspend. */
+void vTaskSuspendAll( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskResumeAll( void )
+{
+	return pdFALSE;
+}
+
@@ -0,0 +1,260 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host micro-benchmark for the list implementation in list.c.
+ *
+ * The same source is built with configUSE_SKIP_LISTS set to 0 and to 1 (see the
+ * Makefile in this directory, "make run" builds and runs both).  For lists of
+ * 10, 100 and 1000 items, each sorted by vListInsert() as the delayed task list
+ * and event lists are, a deterministic pseudo random item is repeatedly removed
+ * with uxListRemove() and inserted again with a new pseudo random value.
+ *
+ * The time taken by each call is measured and the mean, 99th percentile and
+ * maximum are reported.  Times are wall clock times on the host, including the
+ * time taken to read the clock, so are only meaningful relative to each other.
+ * The structure of each list, including the skip list index levels, is checked
+ * after every run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "list.h"
+
+/* The list lengths measured. */
+#define benchNUM_LENGTHS		( 3 )
+#define benchMAX_ITEMS			( 1000 )
+
+/* The number of remove and insert pairs measured for each list length. */
+#define benchNUM_OPS			( 200000 )
+
+/* Item values are chosen from this range, so some items have equal values. */
+#define benchVALUE_RANGE		( 100000UL )
+
+/* Seed for the pseudo random sequence, so both builds see the same
+operations. */
+#define benchRANDOM_SEED		( 0x12345678UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Fill a list with xItems items, then remove and reinsert items, recording the
+ * time taken by each call.
+ */
+static void prvBenchmarkLength( size_t xItems );
+
+/*
+ * Check the list is sorted, holds xItems items that all know they are in the
+ * list, and that every index level is a correctly linked subset of the list in
+ * the same order.
+ */
+static void prvCheckList( size_t xItems );
+
+/*
+ * Sort an array of times and print its mean, 99th percentile and maximum.
+ */
+static void prvReportTimes( const char *pcName, uint32_t *pulTimes, size_t xCount );
+
+static uint32_t prvRandom( void );
+static uint32_t prvNanoseconds( void );
+static int prvCompareTimes( const void *pv1, const void *pv2 );
+
+/*-----------------------------------------------------------*/
+
+static const size_t xLengths[ benchNUM_LENGTHS ] = { 10, 100, benchMAX_ITEMS };
+
+static List_t xBenchList;
+static ListItem_t xItems[ benchMAX_ITEMS ];
+static uint32_t ulRandomState = benchRANDOM_SEED;
+
+static uint32_t ulInsertTimes[ benchNUM_OPS ];
+static uint32_t ulRemoveTimes[ benchNUM_OPS ];
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+size_t xLength;
+
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+		printf( "skip list, %d index levels, item size %lu bytes\r\n", configSKIP_LIST_LEVELS, ( unsigned long ) sizeof( ListItem_t ) );
+	}
+	#else
+	{
+		printf( "linked list, item size %lu bytes\r\n", ( unsigned long ) sizeof( ListItem_t ) );
+	}
+	#endif
+
+	for( xLength = 0; xLength < benchNUM_LENGTHS; xLength++ )
+	{
+		prvBenchmarkLength( xLengths[ xLength ] );
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkLength( size_t xItemCount )
+{
+size_t xItem, xOp;
+uint32_t ulStart, ulEnd;
+ListItem_t *pxItem;
+
+	vListInitialise( &xBenchList );
+
+	for( xItem = 0; xItem < xItemCount; xItem++ )
+	{
+		vListInitialiseItem( &( xItems[ xItem ] ) );
+		listSET_LIST_ITEM_OWNER( &( xItems[ xItem ] ), &( xItems[ xItem ] ) );
+		listSET_LIST_ITEM_VALUE( &( xItems[ xItem ] ), prvRandom() % benchVALUE_RANGE );
+		vListInsert( &xBenchList, &( xItems[ xItem ] ) );
+	}
+
+	prvCheckList( xItemCount );
+
+	for( xOp = 0; xOp < benchNUM_OPS; xOp++ )
+	{
+		pxItem = &( xItems[ prvRandom() % xItemCount ] );
+
+		ulStart = prvNanoseconds();
+		( void ) uxListRemove( pxItem );
+		ulEnd = prvNanoseconds();
+		ulRemoveTimes[ xOp ] = ulEnd - ulStart;
+
+		listSET_LIST_ITEM_VALUE( pxItem, prvRandom() % benchVALUE_RANGE );
+
+		ulStart = prvNanoseconds();
+		vListInsert( &xBenchList, pxItem );
+		ulEnd = prvNanoseconds();
+		ulInsertTimes[ xOp ] = ulEnd - ulStart;
+	}
+
+	prvCheckList( xItemCount );
+
+	printf( "%lu items\r\n", ( unsigned long ) xItemCount );
+	prvReportTimes( "  vListInsert ", ulInsertTimes, benchNUM_OPS );
+	prvReportTimes( "  uxListRemove", ulRemoveTimes, benchNUM_OPS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckList( size_t xItemCount )
+{
+const ListItem_t *pxEnd = listGET_END_MARKER( &xBenchList );
+const ListItem_t *pxItem;
+size_t xCount = 0;
+TickType_t xLastValue = 0;
+
+	configASSERT( listCURRENT_LIST_LENGTH( &xBenchList ) == xItemCount );
+
+	for( pxItem = listGET_HEAD_ENTRY( &xBenchList ); pxItem != pxEnd; pxItem = listGET_NEXT( pxItem ) )
+	{
+		configASSERT( listLIST_ITEM_CONTAINER( pxItem ) == &xBenchList );
+		configASSERT( pxItem->pxNext->pxPrevious == pxItem );
+		configASSERT( listGET_LIST_ITEM_VALUE( pxItem ) >= xLastValue );
+		xLastValue = listGET_LIST_ITEM_VALUE( pxItem );
+		xCount++;
+	}
+
+	configASSERT( xCount == xItemCount );
+
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+	UBaseType_t uxLevel;
+	const ListItem_t *pxIndexed, *pxPrevious;
+	const MiniListItem_t *pxEndMarker = &( xBenchList.xListEnd );
+
+		for( uxLevel = 0; uxLevel < configSKIP_LIST_LEVELS; uxLevel++ )
+		{
+			/* Walk the level and the list together.  Every item on the level
+			must be found in the list, in the same order, and must be on every
+			level below this one. */
+			pxItem = listGET_HEAD_ENTRY( &xBenchList );
+			pxPrevious = pxEnd;
+
+			for( pxIndexed = pxEndMarker->pxSkipNext[ uxLevel ]; pxIndexed != pxEnd; pxIndexed = pxIndexed->pxSkipNext[ uxLevel ] )
+			{
+				configASSERT( pxIndexed->pxSkipPrevious[ uxLevel ] == pxPrevious );
+				configASSERT( pxIndexed->uxSkipLevels > uxLevel );
+
+				while( ( pxItem != pxEnd ) && ( pxItem != pxIndexed ) )
+				{
+					pxItem = listGET_NEXT( pxItem );
+				}
+
+				configASSERT( pxItem == pxIndexed );
+				pxPrevious = pxIndexed;
+			}
+
+			configASSERT( pxEndMarker->pxSkipPrevious[ uxLevel ] == pxPrevious );
+		}
+	}
+	#endif /* configUSE_SKIP_LISTS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvReportTimes( const char *pcName, uint32_t *pulTimes, size_t xCount )
+{
+size_t x;
+uint64_t ullTotal = 0;
+
+	qsort( pulTimes, xCount, sizeof( uint32_t ), prvCompareTimes );
+
+	for( x = 0; x < xCount; x++ )
+	{
+		ullTotal += pulTimes[ x ];
+	}
+
+	printf( "%s ns: mean %lu, p99 %lu, max %lu\r\n", pcName, ( unsigned long ) ( ullTotal / xCount ), ( unsigned long ) pulTimes[ ( xCount * 99 ) / 100 ], ( unsigned long ) pulTimes[ xCount - 1 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+	ulRandomState = ( ulRandomState * 1103515245UL ) + 12345UL;
+	return ulRandomState >> 8;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvNanoseconds( void )
+{
+struct timespec xTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &xTime );
+	return ( uint32_t ) ( ( ( uint64_t ) xTime.tv_sec * 1000000000ULL ) + ( uint64_t ) xTime.tv_nsec );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareTimes( const void *pv1, const void *pv2 )
+{
+uint32_t ul1 = *( const uint32_t * ) pv1, ul2 = *( const uint32_t * ) pv2;
+
+	return ( ul1 > ul2 ) - ( ul1 < ul2 );
+}
@@ -0,0 +1,72 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+ * Configuration used to build the kernel as a native host program for the
+ * mutex benchmark.  Only the mutex related definitions are significant, the
+ * remainder keep the kernel as small as possible.
+ *-----------------------------------------------------------*/
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION				1
+#define configUSE_IDLE_HOOK					0
+#define configUSE_TICK_HOOK					0
+#define configCPU_CLOCK_HZ					( 1000000UL )
+#define configTICK_RATE_HZ					( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES				( 5 )
+#define configMINIMAL_STACK_SIZE			( ( unsigned short ) 256 )
+#define configMAX_TASK_NAME_LEN				( 16 )
+#define configUSE_16_BIT_TICKS				0
+#define configUSE_TIMERS					0
+#define configUSE_TRACE_FACILITY			0
+#define INCLUDE_uxTaskPriorityGet			1
+#define INCLUDE_xTaskGetSchedulerState		1
+#define INCLUDE_xSemaphoreGetMutexHolder	1
+
+#define configSUPPORT_STATIC_ALLOCATION		0
+#define configSUPPORT_DYNAMIC_ALLOCATION	1
+#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 64 * 1024 ) )
+#define configUSE_MALLOC_FAILED_HOOK		0
+
+/* Mutexes.  The Makefile builds the benchmark with and without transitive
+priority inheritance. */
+#define configUSE_MUTEXES					1
+#define configUSE_CEILING_MUTEXES			1
+
+#ifndef configUSE_TRANSITIVE_PRIORITY_INHERITANCE
+	#define configUSE_TRANSITIVE_PRIORITY_INHERITANCE	0
+#endif
+
+/* The benchmark fails on the first assertion that does not hold. */
+#define configASSERT( x ) assert( x )
+
+#endif /* FREERTOS_CONFIG_H */
+
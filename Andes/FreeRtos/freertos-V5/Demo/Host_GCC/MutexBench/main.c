@@ -0,0 +1,280 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host benchmark for the priority ceiling mutex take and give paths.
+ *
+ * tasks.c, queue.c, list.c and heap_4.c are built as a native host program
+ * with the port layer in this directory (see the Makefile, "make run" builds
+ * and runs the benchmark with and without transitive priority inheritance).
+ * One task is created and the scheduler is started, at which point
+ * xPortStartScheduler() below runs the benchmark as that task.
+ *
+ * The benchmark first checks the priority of the task as ceiling mutexes are
+ * taken and given through xSemaphoreTakeCeiling() and xSemaphoreGiveCeiling(),
+ * mixed with xSemaphoreTake() and xSemaphoreGive() and nested with other
+ * mutexes.  It then times uncontended take/give pairs on a standard mutex
+ * using xSemaphoreTake() and xSemaphoreGive(), and on a ceiling mutex using
+ * both those macros and the dedicated ceiling mutex macros.  Times are wall
+ * clock times on the host, so are only meaningful relative to each other.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Priority of the task the benchmark runs as, and the ceiling priorities of
+the two ceiling mutexes. */
+#define benchTASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define benchCEILING_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define benchNESTED_CEILING_PRIORITY	( tskIDLE_PRIORITY + 3 )
+
+/* The number of take/give pairs in each timed run, and the number of runs of
+which the fastest is reported. */
+#define benchITERATIONS					( 1000000UL )
+#define benchRUNS						( 5 )
+
+#define benchNO_DELAY					( ( TickType_t ) 0 )
+
+/* Report the line of the first check that fails, and exit. */
+#define benchCHECK( x )		prvCheck( ( x ), #x, __LINE__ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Check the priority of the calling task as mutexes are taken and given.
+ */
+static void prvCheckCeilingPaths( void );
+
+/*
+ * Time benchITERATIONS take/give pairs on xMutex benchRUNS times, using the
+ * ceiling mutex API if xCeiling is pdTRUE, and return the fastest run in
+ * nanoseconds per pair.
+ */
+static double prvTimeMutex( SemaphoreHandle_t xMutex, BaseType_t xCeiling );
+
+static uint64_t prvNanoseconds( void );
+static void prvCheck( int iResult, const char *pcExpression, int iLine );
+static void prvTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static SemaphoreHandle_t xStandardMutex = NULL, xCeilingMutex = NULL, xNestedCeilingMutex = NULL;
+static BaseType_t xBenchmarkRun = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xStandardMutex = xSemaphoreCreateMutex();
+	xCeilingMutex = xSemaphoreCreateCeilingMutex( benchCEILING_PRIORITY );
+	xNestedCeilingMutex = xSemaphoreCreateCeilingMutex( benchNESTED_CEILING_PRIORITY );
+	benchCHECK( ( xStandardMutex != NULL ) && ( xCeilingMutex != NULL ) && ( xNestedCeilingMutex != NULL ) );
+
+	benchCHECK( xTaskCreate( prvTask, "Bench", configMINIMAL_STACK_SIZE, NULL, benchTASK_PRIORITY, NULL ) == pdPASS );
+
+	/* Runs the benchmark, then returns. */
+	vTaskStartScheduler();
+
+	benchCHECK( xBenchmarkRun != pdFALSE );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckCeilingPaths( void )
+{
+	/* The dedicated paths raise and restore the priority. */
+	benchCHECK( xSemaphoreTakeCeiling( xCeilingMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchCEILING_PRIORITY );
+	benchCHECK( xSemaphoreGetMutexHolder( xCeilingMutex ) == xTaskGetCurrentTaskHandle() );
+	benchCHECK( xSemaphoreTakeCeiling( xCeilingMutex, benchNO_DELAY ) == pdFAIL );
+	benchCHECK( xSemaphoreGiveCeiling( xCeilingMutex ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+	benchCHECK( xSemaphoreGetMutexHolder( xCeilingMutex ) == NULL );
+	benchCHECK( xSemaphoreGiveCeiling( xCeilingMutex ) == pdFAIL );
+
+	/* The dedicated and generic paths can be mixed. */
+	benchCHECK( xSemaphoreTake( xCeilingMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchCEILING_PRIORITY );
+	benchCHECK( xSemaphoreGiveCeiling( xCeilingMutex ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+
+	benchCHECK( xSemaphoreTakeCeiling( xCeilingMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchCEILING_PRIORITY );
+	benchCHECK( xSemaphoreGive( xCeilingMutex ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+
+	/* Nested ceiling mutexes.  Once the inner mutex is given back the
+	priority either falls to the outer ceiling, with transitive priority
+	inheritance, or remains at the inner ceiling until the last mutex is
+	given back. */
+	benchCHECK( xSemaphoreTakeCeiling( xCeilingMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( xSemaphoreTakeCeiling( xNestedCeilingMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchNESTED_CEILING_PRIORITY );
+	benchCHECK( xSemaphoreGiveCeiling( xNestedCeilingMutex ) == pdPASS );
+
+	#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	{
+		benchCHECK( uxTaskPriorityGet( NULL ) == benchCEILING_PRIORITY );
+	}
+	#else
+	{
+		benchCHECK( uxTaskPriorityGet( NULL ) == benchNESTED_CEILING_PRIORITY );
+	}
+	#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+	benchCHECK( xSemaphoreGiveCeiling( xCeilingMutex ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+
+	/* A ceiling mutex given back while a standard mutex is still held. */
+	benchCHECK( xSemaphoreTake( xStandardMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( xSemaphoreTakeCeiling( xCeilingMutex, benchNO_DELAY ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchCEILING_PRIORITY );
+	benchCHECK( xSemaphoreGiveCeiling( xCeilingMutex ) == pdPASS );
+
+	#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	{
+		benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+	}
+	#else
+	{
+		benchCHECK( uxTaskPriorityGet( NULL ) == benchCEILING_PRIORITY );
+	}
+	#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+	benchCHECK( xSemaphoreGive( xStandardMutex ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+}
+/*-----------------------------------------------------------*/
+
+static double prvTimeMutex( SemaphoreHandle_t xMutex, BaseType_t xCeiling )
+{
+uint64_t ullStart, ullTime, ullFastest = UINT64_MAX;
+uint32_t ul;
+int iRun;
+
+	for( iRun = 0; iRun < benchRUNS; iRun++ )
+	{
+		ullStart = prvNanoseconds();
+
+		for( ul = 0; ul < benchITERATIONS; ul++ )
+		{
+			if( xCeiling != pdFALSE )
+			{
+				( void ) xSemaphoreTakeCeiling( xMutex, benchNO_DELAY );
+				( void ) xSemaphoreGiveCeiling( xMutex );
+			}
+			else
+			{
+				( void ) xSemaphoreTake( xMutex, benchNO_DELAY );
+				( void ) xSemaphoreGive( xMutex );
+			}
+		}
+
+		ullTime = prvNanoseconds() - ullStart;
+
+		if( ullTime < ullFastest )
+		{
+			ullFastest = ullTime;
+		}
+	}
+
+	/* Every pair must have left the mutex available. */
+	benchCHECK( xSemaphoreGetMutexHolder( xMutex ) == NULL );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchTASK_PRIORITY );
+
+	return ( double ) ullFastest / ( double ) benchITERATIONS;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNanoseconds( void )
+{
+struct timespec xTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &xTime );
+	return ( ( uint64_t ) xTime.tv_sec * 1000000000ULL ) + ( uint64_t ) xTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine )
+{
+	if( iResult == 0 )
+	{
+		printf( "main.c:%d: check failed: %s\n", iLine, pcExpression );
+		exit( 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTask( void *pvParameters )
+{
+	/* The task never runs, the benchmark runs in its place. */
+	( void ) pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+/* Port layer functions, see portmacro.h. */
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	( void ) pxCode;
+	( void ) pvParameters;
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+double dStandard, dGeneric, dCeiling;
+
+	prvCheckCeilingPaths();
+
+	dStandard = prvTimeMutex( xStandardMutex, pdFALSE );
+	dGeneric = prvTimeMutex( xCeilingMutex, pdFALSE );
+	dCeiling = prvTimeMutex( xCeilingMutex, pdTRUE );
+
+	printf( "transitive priority inheritance %s\r\n", ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) ? "on" : "off" );
+	printf( "  standard mutex, xSemaphoreTake/Give        %.1f ns per pair\r\n", dStandard );
+	printf( "  ceiling mutex, xSemaphoreTake/Give         %.1f ns per pair\r\n", dGeneric );
+	printf( "  ceiling mutex, xSemaphoreTake/GiveCeiling  %.1f ns per pair\r\n", dCeiling );
+
+	xBenchmarkRun = pdTRUE;
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+}
+
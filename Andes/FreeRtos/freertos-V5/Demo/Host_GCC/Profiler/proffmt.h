@@ -0,0 +1,95 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PROFFMT_H
+#define PROFFMT_H
+
+/*-----------------------------------------------------------
+ * The sample buffer written by RTOSDemo_bsp/profiler/profiler.c, as dumped by
+ * the host (xProfilerBuffer, a ProfilerBuffer_t).  These definitions are
+ * shared by the host symbolizer and the synthetic dump generator, and must be
+ * kept in step with profiler.h.
+ *
+ * All fields are in target (little endian) byte order.  The header is
+ *
+ *   u32 magic, u8 version, u8 pointer size, u8 backtrace depth,
+ *   u8 task name length, u32 samples per second, u32 capacity (samples),
+ *   u32 head (index of the next sample written), u32 count (samples written,
+ *   saturating), u32 maximum tasks, u32 number of tasks, u32 task ID offset,
+ *   u32 task name offset, u32 sample offset
+ *
+ * and the offsets, from the start of the dump, locate
+ *
+ *   ptr task IDs[ maximum tasks ]
+ *   char task names[ maximum tasks ][ task name length ]
+ *   ptr samples[ capacity ][ 2 + backtrace depth ]
+ *
+ * where "ptr" is 4 bytes on RV32 and 8 bytes on RV64.  Each sample is the
+ * interrupted PC, the handle of the interrupted task and the return addresses
+ * found on the task's frame pointer chain, innermost first, unused ones 0.
+ * Samples are in a ring: the oldest of the min( count, capacity ) valid
+ * samples is the one that many samples before head.
+ *-----------------------------------------------------------*/
+
+#define proffmtMAGIC						( 0x50534350UL )	/* "PCSP" */
+#define proffmtVERSION						( 1u )
+
+/* Byte offsets of the header fields. */
+#define proffmtOFF_MAGIC					( 0 )
+#define proffmtOFF_VERSION					( 4 )
+#define proffmtOFF_POINTER_SIZE				( 5 )
+#define proffmtOFF_DEPTH					( 6 )
+#define proffmtOFF_NAME_LENGTH				( 7 )
+#define proffmtOFF_SAMPLE_HZ				( 8 )
+#define proffmtOFF_CAPACITY					( 12 )
+#define proffmtOFF_HEAD						( 16 )
+#define proffmtOFF_COUNT					( 20 )
+#define proffmtOFF_MAX_TASKS				( 24 )
+#define proffmtOFF_NUM_TASKS				( 28 )
+#define proffmtOFF_TASK_ID_OFFSET			( 32 )
+#define proffmtOFF_TASK_NAME_OFFSET			( 36 )
+#define proffmtOFF_SAMPLE_OFFSET			( 40 )
+#define proffmtHEADER_SIZE					( 44 )
+
+/* The ELF symbol table fields read by profsym and written by profgen. */
+#define proffmtELFCLASS32					( 1 )
+#define proffmtELFCLASS64					( 2 )
+#define proffmtELFDATA2LSB					( 1 )
+#define proffmtSHT_SYMTAB					( 2 )
+#define proffmtSHT_STRTAB					( 3 )
+#define proffmtSHT_NOBITS					( 8 )
+#define proffmtSHF_WRITE					( 0x1 )
+#define proffmtSHF_ALLOC					( 0x2 )
+#define proffmtSHF_EXECINSTR				( 0x4 )
+#define proffmtSTT_NOTYPE					( 0 )
+#define proffmtSTT_OBJECT					( 1 )
+#define proffmtSTT_FUNC						( 2 )
+#define proffmtSTB_LOCAL					( 0 )
+#define proffmtSTB_GLOBAL					( 1 )
+#define proffmtEM_RISCV						( 243 )
+
+#endif /* PROFFMT_H */
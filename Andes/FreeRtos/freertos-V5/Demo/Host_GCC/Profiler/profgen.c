@@ -0,0 +1,454 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Writes synthetic ELF images and profiler buffer dumps for the golden file
+ * tests of profsym (see the Makefile in this directory, "make test").  The
+ * dumps are laid out the way RTOSDemo_bsp/profiler/profiler.c lays out
+ * xProfilerBuffer for an RV32 or an RV64 target, and the ELF images hold only
+ * the sections and symbols profsym reads, so every line of the profiles can
+ * be checked by hand.
+ *
+ * Usage: profgen rv64|rv32|truncated elf dump
+ *
+ *   rv64        RV64 target with three frame backtraces, a ring that has
+ *               wrapped, a task whose name was not recorded, a recursive
+ *               call, assembler labels, aliases and symbols that are not code
+ *   rv32        RV32 target without backtraces, with a PC outside any symbol
+ *   truncated   the rv64 dump with its last byte missing
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "proffmt.h"
+
+/* Size of the buffers the ELF image and the dump are built in. */
+#define genMAX_FILE_SIZE			( 8192 )
+
+/* Sections of the ELF images. */
+#define genSECTION_TEXT				( 1 )
+#define genSECTION_DATA				( 2 )
+#define genSECTION_SYMTAB			( 3 )
+#define genSECTION_STRTAB			( 4 )
+#define genSECTION_SHSTRTAB			( 5 )
+#define genNUM_SECTIONS				( 6 )
+#define genSHN_ABS					( 0xfff1 )
+#define genSTT_FILE					( 4 )
+
+/* RV64 code, data and task handles. */
+#define genMAIN						( 0x80000000ULL )
+#define genTASK_A_CODE				( 0x80000100ULL )
+#define genWORK						( 0x80000200ULL )
+#define genMEMCPY					( 0x80000300ULL )
+#define genIDLE_CODE				( 0x80000400ULL )
+#define genTRAP_HANDLER				( 0x80000500ULL )
+#define genPROCESSED_SOURCE			( 0x80000580ULL )
+#define genPROFILER_BUFFER			( 0x80100000ULL )
+#define genTASK_A					( 0x80200000ULL )
+#define genIDLE_TASK				( 0x80200400ULL )
+#define genUNNAMED_TASK				( 0x80200800ULL )
+
+/* RV32 code and task handles. */
+#define genRV32_TASK_CODE			( 0x00001000ULL )
+#define genRV32_IDLE_HOOK			( 0x00001100ULL )
+#define genRV32_IDLE_CODE			( 0x00001200ULL )
+#define genRV32_WORKER_TASK			( 0x00002000ULL )
+#define genRV32_IDLE_TASK			( 0x00002100ULL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Build an ELF image with the given symbols.
+ */
+static void prvElfBegin( unsigned uPointerSize, uint64_t ullTextStart );
+static void prvElfSymbol( const char *pcName, uint64_t ullValue, uint64_t ullSize, uint8_t ucType, uint8_t ucBind, uint16_t usSection );
+static size_t prvElfEnd( void );
+
+/*
+ * Build a dump, then add tasks and samples to it.
+ */
+static void prvDumpBegin( unsigned uPointerSize, unsigned uDepth, uint32_t ulSampleHz, uint32_t ulCapacity, uint32_t ulMaxTasks, unsigned uNameLength );
+static void prvDumpTask( uint64_t ullTask, const char *pcName );
+static void prvDumpSample( uint64_t ullPC, uint64_t ullTask, uint64_t ullReturn1, uint64_t ullReturn2, uint64_t ullReturn3 );
+
+static void prvRV64( void );
+static void prvRV32( void );
+
+static void prvPut( uint8_t *pucFile, size_t xOffset, uint64_t ullValue, unsigned uSize );
+static size_t prvAddString( uint8_t *pucTable, size_t *pxSize, const char *pcString );
+static int prvWrite( const char *pcFile, const uint8_t *pucData, size_t xSize );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucElf[ genMAX_FILE_SIZE ], ucDump[ genMAX_FILE_SIZE ];
+static uint8_t ucSymtab[ genMAX_FILE_SIZE ], ucStrtab[ genMAX_FILE_SIZE ];
+static size_t xSymtabSize = 0, xStrtabSize = 0, xDumpSize = 0;
+static unsigned uElfPointerSize = 8;
+static uint64_t ullElfTextStart = 0;
+
+/* Layout of the dump being built. */
+static unsigned uDumpPointerSize, uDumpDepth, uDumpNameLength;
+static uint32_t ulDumpCapacity, ulDumpHead = 0, ulDumpCount = 0, ulDumpNumTasks = 0;
+static size_t xTaskIdOffset, xTaskNameOffset, xSampleOffset;
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+size_t xElfSize;
+
+	if( argc != 4 )
+	{
+		fprintf( stderr, "usage: profgen rv64|rv32|truncated elf dump\n" );
+		return 1;
+	}
+
+	if( ( strcmp( argv[ 1 ], "rv64" ) == 0 ) || ( strcmp( argv[ 1 ], "truncated" ) == 0 ) )
+	{
+		prvRV64();
+		xElfSize = prvElfEnd();
+		if( argv[ 1 ][ 0 ] == 't' )
+		{
+			xDumpSize--;
+		}
+	}
+	else if( strcmp( argv[ 1 ], "rv32" ) == 0 )
+	{
+		prvRV32();
+		xElfSize = prvElfEnd();
+	}
+	else
+	{
+		fprintf( stderr, "profgen: unknown scenario %s\n", argv[ 1 ] );
+		return 1;
+	}
+
+	if( prvWrite( argv[ 2 ], ucElf, xElfSize ) != 0 )
+	{
+		return 1;
+	}
+
+	return prvWrite( argv[ 3 ], ucDump, xDumpSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRV64( void )
+{
+	prvElfBegin( 8, genMAIN );
+	prvElfSymbol( "crt0.S", 0, 0, genSTT_FILE, proffmtSTB_LOCAL, genSHN_ABS );
+	prvElfSymbol( "$x", genMAIN, 0, proffmtSTT_NOTYPE, proffmtSTB_LOCAL, genSECTION_TEXT );
+	prvElfSymbol( "main", genMAIN, 0x40, proffmtSTT_FUNC, proffmtSTB_GLOBAL, genSECTION_TEXT );
+	prvElfSymbol( "prvTaskA", genTASK_A_CODE, 0x80, proffmtSTT_FUNC, proffmtSTB_LOCAL, genSECTION_TEXT );
+	prvElfSymbol( "prvWork", genWORK, 0x60, proffmtSTT_FUNC, proffmtSTB_LOCAL, genSECTION_TEXT );
+
+	/* The global name of an aliased function is used. */
+	prvElfSymbol( "prvCopy", genMEMCPY, 0x100, proffmtSTT_FUNC, proffmtSTB_LOCAL, genSECTION_TEXT );
+	prvElfSymbol( "memcpy", genMEMCPY, 0x100, proffmtSTT_FUNC, proffmtSTB_GLOBAL, genSECTION_TEXT );
+	prvElfSymbol( "prvIdleTask", genIDLE_CODE, 0x40, proffmtSTT_FUNC, proffmtSTB_LOCAL, genSECTION_TEXT );
+
+	/* Assembler code has labels rather than sized functions. */
+	prvElfSymbol( "freertos_risc_v_trap_handler", genTRAP_HANDLER, 0, proffmtSTT_NOTYPE, proffmtSTB_GLOBAL, genSECTION_TEXT );
+	prvElfSymbol( "processed_source", genPROCESSED_SOURCE, 0, proffmtSTT_NOTYPE, proffmtSTB_LOCAL, genSECTION_TEXT );
+	prvElfSymbol( "xProfilerBuffer", genPROFILER_BUFFER, 0x800, proffmtSTT_OBJECT, proffmtSTB_GLOBAL, genSECTION_DATA );
+
+	/* Two task names are kept, so the third task is named by its handle. */
+	prvDumpBegin( 8, 3, 997, 8, 2, 16 );
+	prvDumpTask( genTASK_A, "TaskA" );
+	prvDumpTask( genIDLE_TASK, "IDLE" );
+
+	/* Three samples that are overwritten when the ring wraps. */
+	prvDumpSample( genMAIN + 0x4, genIDLE_TASK, 0, 0, 0 );
+	prvDumpSample( genMAIN + 0x4, genIDLE_TASK, 0, 0, 0 );
+	prvDumpSample( genMAIN + 0x4, genIDLE_TASK, 0, 0, 0 );
+
+	/* TaskA: main calls prvTaskA, which calls prvWork, which calls memcpy and
+	itself. */
+	prvDumpSample( genWORK + 0x10, genTASK_A, genTASK_A_CODE + 0x20, genMAIN + 0x10, 0 );
+	prvDumpSample( genWORK + 0x10, genTASK_A, genTASK_A_CODE + 0x20, genMAIN + 0x10, 0 );
+	prvDumpSample( genMEMCPY + 0x40, genTASK_A, genWORK + 0x18, genTASK_A_CODE + 0x20, genMAIN + 0x10 );
+	prvDumpSample( genTASK_A_CODE + 0x30, genTASK_A, genMAIN + 0x10, 0, 0 );
+	prvDumpSample( genWORK + 0x20, genTASK_A, genWORK + 0x28, genTASK_A_CODE + 0x20, genMAIN + 0x10 );
+
+	/* IDLE, with a frame walk that ended at once, and in the trap handler. */
+	prvDumpSample( genIDLE_CODE + 0x8, genIDLE_TASK, 0, 0, 0 );
+	prvDumpSample( genPROCESSED_SOURCE + 0x10, genIDLE_TASK, 0, 0, 0 );
+
+	/* A PC outside any symbol, called from the last instruction of
+	prvIdleTask, so the return address is the end of the function. */
+	prvDumpSample( 0x90000000ULL, genUNNAMED_TASK, genIDLE_CODE + 0x40, 0, 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRV32( void )
+{
+	prvElfBegin( 4, genRV32_TASK_CODE );
+	prvElfSymbol( "vWorkerTask", genRV32_TASK_CODE, 0x100, proffmtSTT_FUNC, proffmtSTB_GLOBAL, genSECTION_TEXT );
+	prvElfSymbol( "vApplicationIdleHook", genRV32_IDLE_HOOK, 0x20, proffmtSTT_FUNC, proffmtSTB_GLOBAL, genSECTION_TEXT );
+	prvElfSymbol( "prvIdleTask", genRV32_IDLE_CODE, 0x40, proffmtSTT_FUNC, proffmtSTB_LOCAL, genSECTION_TEXT );
+
+	prvDumpBegin( 4, 0, 1000, 16, 4, 16 );
+	prvDumpTask( genRV32_WORKER_TASK, "Worker" );
+	prvDumpTask( genRV32_IDLE_TASK, "IDLE" );
+
+	prvDumpSample( genRV32_TASK_CODE + 0x10, genRV32_WORKER_TASK, 0, 0, 0 );
+	prvDumpSample( genRV32_TASK_CODE + 0x80, genRV32_WORKER_TASK, 0, 0, 0 );
+	prvDumpSample( genRV32_TASK_CODE + 0xfc, genRV32_WORKER_TASK, 0, 0, 0 );
+	prvDumpSample( genRV32_IDLE_HOOK + 0x4, genRV32_IDLE_TASK, 0, 0, 0 );
+	prvDumpSample( genRV32_IDLE_CODE + 0x3c, genRV32_IDLE_TASK, 0, 0, 0 );
+
+	/* Between vApplicationIdleHook and prvIdleTask. */
+	prvDumpSample( genRV32_IDLE_HOOK + 0x80, genRV32_IDLE_TASK, 0, 0, 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvElfBegin( unsigned uPointerSize, uint64_t ullTextStart )
+{
+	uElfPointerSize = uPointerSize;
+	ullElfTextStart = ullTextStart;
+
+	/* The null string and the null symbol. */
+	xStrtabSize = 1;
+	xSymtabSize = ( uPointerSize == 8 ) ? 24 : 16;
+}
+/*-----------------------------------------------------------*/
+
+static void prvElfSymbol( const char *pcName, uint64_t ullValue, uint64_t ullSize, uint8_t ucType, uint8_t ucBind, uint16_t usSection )
+{
+const size_t xName = prvAddString( ucStrtab, &xStrtabSize, pcName );
+const uint8_t ucInfo = ( uint8_t ) ( ( ucBind << 4 ) | ucType );
+
+	if( uElfPointerSize == 8 )
+	{
+		prvPut( ucSymtab, xSymtabSize, xName, 4 );
+		prvPut( ucSymtab, xSymtabSize + 4, ucInfo, 1 );
+		prvPut( ucSymtab, xSymtabSize + 6, usSection, 2 );
+		prvPut( ucSymtab, xSymtabSize + 8, ullValue, 8 );
+		prvPut( ucSymtab, xSymtabSize + 16, ullSize, 8 );
+		xSymtabSize += 24;
+	}
+	else
+	{
+		prvPut( ucSymtab, xSymtabSize, xName, 4 );
+		prvPut( ucSymtab, xSymtabSize + 4, ullValue, 4 );
+		prvPut( ucSymtab, xSymtabSize + 8, ullSize, 4 );
+		prvPut( ucSymtab, xSymtabSize + 12, ucInfo, 1 );
+		prvPut( ucSymtab, xSymtabSize + 14, usSection, 2 );
+		xSymtabSize += 16;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvElfEnd( void )
+{
+static uint8_t ucShstrtab[ 64 ];
+size_t xShstrtabSize = 1, xSymtabOffset, xStrtabOffset, xShstrtabOffset, xShoff, xSh, x;
+const int i64 = ( uElfPointerSize == 8 );
+const unsigned uWord = uElfPointerSize, uShentsize = i64 ? 64 : 40;
+size_t xNames[ genNUM_SECTIONS ];
+uint32_t ulType[ genNUM_SECTIONS ] = { 0, proffmtSHT_NOBITS, proffmtSHT_NOBITS, proffmtSHT_SYMTAB, proffmtSHT_STRTAB, proffmtSHT_STRTAB };
+uint64_t ullFlags[ genNUM_SECTIONS ] = { 0, proffmtSHF_ALLOC | proffmtSHF_EXECINSTR, proffmtSHF_ALLOC | proffmtSHF_WRITE, 0, 0, 0 };
+uint64_t ullAddr[ genNUM_SECTIONS ] = { 0 }, ullOffset[ genNUM_SECTIONS ] = { 0 }, ullSize[ genNUM_SECTIONS ] = { 0 };
+
+	xNames[ 0 ] = 0;
+	xNames[ genSECTION_TEXT ] = prvAddString( ucShstrtab, &xShstrtabSize, ".text" );
+	xNames[ genSECTION_DATA ] = prvAddString( ucShstrtab, &xShstrtabSize, ".data" );
+	xNames[ genSECTION_SYMTAB ] = prvAddString( ucShstrtab, &xShstrtabSize, ".symtab" );
+	xNames[ genSECTION_STRTAB ] = prvAddString( ucShstrtab, &xShstrtabSize, ".strtab" );
+	xNames[ genSECTION_SHSTRTAB ] = prvAddString( ucShstrtab, &xShstrtabSize, ".shstrtab" );
+
+	/* The ELF header, then the tables, then the section headers. */
+	xSymtabOffset = i64 ? 64 : 52;
+	xSymtabOffset = ( xSymtabOffset + 7 ) & ~( size_t ) 7;
+	xStrtabOffset = xSymtabOffset + xSymtabSize;
+	xShstrtabOffset = xStrtabOffset + xStrtabSize;
+	xShoff = ( xShstrtabOffset + xShstrtabSize + 7 ) & ~( size_t ) 7;
+
+	memcpy( &( ucElf[ xSymtabOffset ] ), ucSymtab, xSymtabSize );
+	memcpy( &( ucElf[ xStrtabOffset ] ), ucStrtab, xStrtabSize );
+	memcpy( &( ucElf[ xShstrtabOffset ] ), ucShstrtab, xShstrtabSize );
+
+	ullAddr[ genSECTION_TEXT ] = ullElfTextStart;
+	ullSize[ genSECTION_TEXT ] = 0x1000;
+	ullAddr[ genSECTION_DATA ] = ullElfTextStart + 0x100000;
+	ullSize[ genSECTION_DATA ] = 0x1000;
+	ullOffset[ genSECTION_SYMTAB ] = xSymtabOffset;
+	ullSize[ genSECTION_SYMTAB ] = xSymtabSize;
+	ullOffset[ genSECTION_STRTAB ] = xStrtabOffset;
+	ullSize[ genSECTION_STRTAB ] = xStrtabSize;
+	ullOffset[ genSECTION_SHSTRTAB ] = xShstrtabOffset;
+	ullSize[ genSECTION_SHSTRTAB ] = xShstrtabSize;
+
+	memcpy( ucElf, "\177ELF", 4 );
+	ucElf[ 4 ] = i64 ? proffmtELFCLASS64 : proffmtELFCLASS32;
+	ucElf[ 5 ] = proffmtELFDATA2LSB;
+	ucElf[ 6 ] = 1;
+	prvPut( ucElf, 16, 2, 2 );								/* ET_EXEC */
+	prvPut( ucElf, 18, proffmtEM_RISCV, 2 );
+	prvPut( ucElf, 20, 1, 4 );
+	prvPut( ucElf, 24, ullElfTextStart, uWord );			/* e_entry */
+	prvPut( ucElf, i64 ? 40 : 32, xShoff, uWord );
+	prvPut( ucElf, i64 ? 52 : 40, i64 ? 64 : 52, 2 );		/* e_ehsize */
+	prvPut( ucElf, i64 ? 58 : 46, uShentsize, 2 );
+	prvPut( ucElf, i64 ? 60 : 48, genNUM_SECTIONS, 2 );
+	prvPut( ucElf, i64 ? 62 : 50, genSECTION_SHSTRTAB, 2 );
+
+	for( x = 0; x < genNUM_SECTIONS; x++ )
+	{
+		xSh = xShoff + ( x * uShentsize );
+		prvPut( ucElf, xSh, xNames[ x ], 4 );
+		prvPut( ucElf, xSh + 4, ulType[ x ], 4 );
+		prvPut( ucElf, xSh + 8, ullFlags[ x ], uWord );
+		prvPut( ucElf, xSh + ( i64 ? 16 : 12 ), ullAddr[ x ], uWord );
+		prvPut( ucElf, xSh + ( i64 ? 24 : 16 ), ullOffset[ x ], uWord );
+		prvPut( ucElf, xSh + ( i64 ? 32 : 20 ), ullSize[ x ], uWord );
+		if( x == genSECTION_SYMTAB )
+		{
+			/* sh_link is the string table, sh_info one past the last local
+			symbol, and sh_entsize the symbol size. */
+			prvPut( ucElf, xSh + ( i64 ? 40 : 24 ), genSECTION_STRTAB, 4 );
+			prvPut( ucElf, xSh + ( i64 ? 44 : 28 ), 1, 4 );
+			prvPut( ucElf, xSh + ( i64 ? 56 : 36 ), i64 ? 24 : 16, uWord );
+		}
+		prvPut( ucElf, xSh + ( i64 ? 48 : 32 ), ( x == genSECTION_SYMTAB ) ? uWord : 1, uWord );	/* sh_addralign */
+	}
+
+	return xShoff + ( genNUM_SECTIONS * uShentsize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDumpBegin( unsigned uPointerSize, unsigned uDepth, uint32_t ulSampleHz, uint32_t ulCapacity, uint32_t ulMaxTasks, unsigned uNameLength )
+{
+	uDumpPointerSize = uPointerSize;
+	uDumpDepth = uDepth;
+	uDumpNameLength = uNameLength;
+	ulDumpCapacity = ulCapacity;
+
+	/* As the target pads ProfilerBuffer_t. */
+	xTaskIdOffset = ( proffmtHEADER_SIZE + uPointerSize - 1 ) & ~( size_t ) ( uPointerSize - 1 );
+	xTaskNameOffset = xTaskIdOffset + ( ulMaxTasks * uPointerSize );
+	xSampleOffset = xTaskNameOffset + ( ulMaxTasks * uNameLength );
+	xSampleOffset = ( xSampleOffset + uPointerSize - 1 ) & ~( size_t ) ( uPointerSize - 1 );
+	xDumpSize = xSampleOffset + ( ulCapacity * ( 2 + uDepth ) * uPointerSize );
+
+	/* Unused parts of the buffer are not assumed to be zero. */
+	memset( ucDump, 0xa5, xDumpSize );
+
+	prvPut( ucDump, proffmtOFF_MAGIC, proffmtMAGIC, 4 );
+	prvPut( ucDump, proffmtOFF_VERSION, proffmtVERSION, 1 );
+	prvPut( ucDump, proffmtOFF_POINTER_SIZE, uPointerSize, 1 );
+	prvPut( ucDump, proffmtOFF_DEPTH, uDepth, 1 );
+	prvPut( ucDump, proffmtOFF_NAME_LENGTH, uNameLength, 1 );
+	prvPut( ucDump, proffmtOFF_SAMPLE_HZ, ulSampleHz, 4 );
+	prvPut( ucDump, proffmtOFF_CAPACITY, ulCapacity, 4 );
+	prvPut( ucDump, proffmtOFF_MAX_TASKS, ulMaxTasks, 4 );
+	prvPut( ucDump, proffmtOFF_TASK_ID_OFFSET, xTaskIdOffset, 4 );
+	prvPut( ucDump, proffmtOFF_TASK_NAME_OFFSET, xTaskNameOffset, 4 );
+	prvPut( ucDump, proffmtOFF_SAMPLE_OFFSET, xSampleOffset, 4 );
+
+	ulDumpHead = 0;
+	ulDumpCount = 0;
+	ulDumpNumTasks = 0;
+	prvPut( ucDump, proffmtOFF_HEAD, ulDumpHead, 4 );
+	prvPut( ucDump, proffmtOFF_COUNT, ulDumpCount, 4 );
+	prvPut( ucDump, proffmtOFF_NUM_TASKS, ulDumpNumTasks, 4 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDumpTask( uint64_t ullTask, const char *pcName )
+{
+const size_t xName = xTaskNameOffset + ( ulDumpNumTasks * uDumpNameLength );
+
+	prvPut( ucDump, xTaskIdOffset + ( ulDumpNumTasks * uDumpPointerSize ), ullTask, uDumpPointerSize );
+	memset( &( ucDump[ xName ] ), 0, uDumpNameLength );
+	strncpy( ( char * ) &( ucDump[ xName ] ), pcName, uDumpNameLength - 1 );
+
+	ulDumpNumTasks++;
+	prvPut( ucDump, proffmtOFF_NUM_TASKS, ulDumpNumTasks, 4 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDumpSample( uint64_t ullPC, uint64_t ullTask, uint64_t ullReturn1, uint64_t ullReturn2, uint64_t ullReturn3 )
+{
+const uint64_t ullReturns[ 3 ] = { ullReturn1, ullReturn2, ullReturn3 };
+const size_t xSample = xSampleOffset + ( ulDumpHead * ( 2 + uDumpDepth ) * uDumpPointerSize );
+unsigned x;
+
+	/* As vProfilerSample() in profiler.c. */
+	prvPut( ucDump, xSample, ullPC, uDumpPointerSize );
+	prvPut( ucDump, xSample + uDumpPointerSize, ullTask, uDumpPointerSize );
+	for( x = 0; x < uDumpDepth; x++ )
+	{
+		prvPut( ucDump, xSample + ( ( 2 + x ) * uDumpPointerSize ), ( x < 3 ) ? ullReturns[ x ] : 0, uDumpPointerSize );
+	}
+
+	ulDumpHead = ( ulDumpHead + 1 == ulDumpCapacity ) ? 0 : ulDumpHead + 1;
+	ulDumpCount++;
+	prvPut( ucDump, proffmtOFF_HEAD, ulDumpHead, 4 );
+	prvPut( ucDump, proffmtOFF_COUNT, ulDumpCount, 4 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPut( uint8_t *pucFile, size_t xOffset, uint64_t ullValue, unsigned uSize )
+{
+unsigned x;
+
+	for( x = 0; x < uSize; x++ )
+	{
+		pucFile[ xOffset + x ] = ( uint8_t ) ( ullValue >> ( 8 * x ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvAddString( uint8_t *pucTable, size_t *pxSize, const char *pcString )
+{
+const size_t xOffset = *pxSize;
+
+	strcpy( ( char * ) &( pucTable[ xOffset ] ), pcString );
+	*pxSize += strlen( pcString ) + 1;
+
+	return xOffset;
+}
+/*-----------------------------------------------------------*/
+
+static int prvWrite( const char *pcFile, const uint8_t *pucData, size_t xSize )
+{
+FILE *pxFile;
+
+	pxFile = fopen( pcFile, "wb" );
+	if( ( pxFile == NULL ) || ( fwrite( pucData, 1, xSize, pxFile ) != xSize ) )
+	{
+		perror( pcFile );
+		return 1;
+	}
+
+	fclose( pxFile );
+	return 0;
+}
+/*-----------------------------------------------------------*/
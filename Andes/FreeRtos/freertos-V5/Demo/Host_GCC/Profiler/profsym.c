@@ -0,0 +1,877 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Symbolizes the samples of the PC sampling profiler
+ * (RTOSDemo_bsp/profiler/profiler.c) against the ELF image they were taken
+ * from, and writes a report or folded stacks.  The input is a dump of
+ * xProfilerBuffer, see proffmt.h, for example from GDB:
+ *
+ *   (gdb) dump binary value profile.bin xProfilerBuffer
+ *
+ * The report gives the share of the samples taken in each task, and a flat
+ * profile: for each function the samples taken in it (self) and, if the
+ * samples have backtraces, the samples taken in it or in a function it called
+ * (total).
+ *
+ * Folded stacks (-c) are one line for each distinct stack: the task, then the
+ * functions from the outermost caller to the sampled function, separated by
+ * semicolons, then the number of samples.  This is the input of flamegraph.pl
+ * (github.com/brendangregg/FlameGraph) and of speedscope.
+ *
+ * Addresses are looked up among the function symbols of the ELF symbol table,
+ * then among the untyped labels of executable sections, which is how most
+ * assembler functions appear.  A return address is looked up one byte before
+ * it, so in the call instruction.  Other addresses are reported as [unknown].
+ *
+ * Usage: profsym [-c] [-n count] elf dump
+ *
+ *   -c   write folded stacks instead of the report
+ *   -n   list only the count functions with the most self samples
+ *
+ * The exit status is 0 if both files were read and 1 otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "proffmt.h"
+
+/* Name of an address that is not in any symbol. */
+#define symUNKNOWN					"[unknown]"
+
+/* First of the reserved section indexes (SHN_LORESERVE). */
+#define symSHN_LORESERVE			( 0xff00u )
+
+/*-----------------------------------------------------------*/
+
+/* A function symbol or a label. */
+typedef struct
+{
+	uint64_t ullStart;
+	uint64_t ullSize;
+	const char *pcName;
+	unsigned uRank;
+} Symbol_t;
+
+/* Samples of a task. */
+typedef struct
+{
+	uint64_t ullId;
+	char *pcName;
+	uint32_t ulSamples;
+} Task_t;
+
+/* Samples of a symbol, see prvLookup() for the indexes. */
+typedef struct
+{
+	uint32_t ulSelf;
+	uint32_t ulTotal;
+	uint32_t ulLastSample;
+} Count_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Read a whole file into memory.
+ */
+static uint8_t *prvReadFile( const char *pcFile, size_t *pxSize );
+
+/*
+ * Read a little endian number of uSize bytes.
+ */
+static uint64_t prvGet( const uint8_t *pucData, unsigned uSize );
+
+/*
+ * Load the function symbols and labels of an ELF image.
+ */
+static int prvLoadSymbols( const uint8_t *pucElf, size_t xSize );
+static int prvCompareSymbols( const void *pvA, const void *pvB );
+static size_t prvSortSymbols( Symbol_t *pxSymbols, size_t xNum );
+
+/*
+ * The index of the symbol holding an address: a function, then a label, then
+ * xNumFunctions + xNumLabels if there is none.
+ */
+static size_t prvLookup( uint64_t ullAddress );
+static const char *prvSymbolName( size_t xIndex );
+
+/*
+ * Read the header and the task names of a dump.
+ */
+static int prvLoadDump( const uint8_t *pucDump, size_t xSize );
+static Task_t *prvFindTask( uint64_t ullId );
+
+/*
+ * The address of frame uFrame of sample ulSample, in ring order, frame 0 being
+ * the sampled PC, and the task of a sample.
+ */
+static uint64_t prvFrame( uint32_t ulSample, unsigned uFrame );
+static uint64_t prvSampleTask( uint32_t ulSample );
+
+static void prvPrintReport( void );
+static int prvPrintFolded( void );
+static int prvCompareTasks( const void *pvA, const void *pvB );
+static int prvCompareCounts( const void *pvA, const void *pvB );
+static int prvCompareStrings( const void *pvA, const void *pvB );
+
+/*-----------------------------------------------------------*/
+
+static Symbol_t *pxFunctions = NULL, *pxLabels = NULL;
+static size_t xNumFunctions = 0, xNumLabels = 0;
+static Count_t *pxCounts = NULL;
+
+static Task_t *pxTasks = NULL;
+static size_t xNumTasks = 0, xMaxTasks = 0;
+
+/* The dump and its header. */
+static const uint8_t *pucSamples = NULL;
+static unsigned uPointerSize, uDepth;
+static uint32_t ulSampleHz, ulCapacity, ulHead, ulCount, ulNumSamples;
+
+/* -n */
+static size_t xListFunctions = SIZE_MAX;
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+int iOption, iFolded = 0;
+static uint8_t *pucElf, *pucDump;
+size_t xElfSize, xDumpSize;
+
+	while( ( iOption = getopt( argc, argv, "cn:" ) ) != -1 )
+	{
+		switch( iOption )
+		{
+			case 'c':
+				iFolded = 1;
+				break;
+
+			case 'n':
+				xListFunctions = ( size_t ) strtoul( optarg, NULL, 0 );
+				break;
+
+			default:
+				fprintf( stderr, "usage: profsym [-c] [-n count] elf dump\n" );
+				return 1;
+		}
+	}
+
+	if( optind + 2 != argc )
+	{
+		fprintf( stderr, "usage: profsym [-c] [-n count] elf dump\n" );
+		return 1;
+	}
+
+	pucElf = prvReadFile( argv[ optind ], &xElfSize );
+	pucDump = prvReadFile( argv[ optind + 1 ], &xDumpSize );
+	if( ( pucElf == NULL ) || ( pucDump == NULL ) )
+	{
+		return 1;
+	}
+
+	if( prvLoadSymbols( pucElf, xElfSize ) != 0 )
+	{
+		fprintf( stderr, "profsym: %s is not a little endian ELF image with a symbol table\n", argv[ optind ] );
+		return 1;
+	}
+
+	if( prvLoadDump( pucDump, xDumpSize ) != 0 )
+	{
+		fprintf( stderr, "profsym: %s is not a complete profiler buffer dump\n", argv[ optind + 1 ] );
+		return 1;
+	}
+
+	if( iFolded != 0 )
+	{
+		return prvPrintFolded();
+	}
+
+	prvPrintReport();
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvReadFile( const char *pcFile, size_t *pxSize )
+{
+FILE *pxFile;
+uint8_t *pucData = NULL;
+long lSize;
+
+	pxFile = fopen( pcFile, "rb" );
+	if( pxFile == NULL )
+	{
+		perror( pcFile );
+		return NULL;
+	}
+
+	if( ( fseek( pxFile, 0, SEEK_END ) == 0 ) && ( ( lSize = ftell( pxFile ) ) >= 0 ) && ( fseek( pxFile, 0, SEEK_SET ) == 0 ) )
+	{
+		/* One more byte, so an empty file is not a NULL buffer. */
+		pucData = malloc( ( size_t ) lSize + 1 );
+		if( ( pucData != NULL ) && ( fread( pucData, 1, ( size_t ) lSize, pxFile ) == ( size_t ) lSize ) )
+		{
+			*pxSize = ( size_t ) lSize;
+		}
+		else
+		{
+			free( pucData );
+			pucData = NULL;
+		}
+	}
+
+	if( pucData == NULL )
+	{
+		fprintf( stderr, "profsym: cannot read %s\n", pcFile );
+	}
+
+	fclose( pxFile );
+	return pucData;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGet( const uint8_t *pucData, unsigned uSize )
+{
+uint64_t ullValue = 0;
+
+	while( uSize > 0 )
+	{
+		uSize--;
+		ullValue = ( ullValue << 8 ) | pucData[ uSize ];
+	}
+
+	return ullValue;
+}
+/*-----------------------------------------------------------*/
+
+static int prvLoadSymbols( const uint8_t *pucElf, size_t xSize )
+{
+const uint8_t *pucSection, *pucSymbol, *pucSymtab = NULL, *pucStrtab;
+uint64_t ullShoff, ullOffset, ullSize, ullStrOffset, ullStrSize, ullValue, ullSymSize, ullSectionEnd;
+unsigned uShentsize, uShnum, uSymentsize, uWord, uType, uBind, uShndx, uName;
+size_t x, xNumSymbols;
+int i64;
+const char *pcName;
+
+	if( ( xSize < 52 ) || ( memcmp( pucElf, "\177ELF", 4 ) != 0 ) || ( pucElf[ 5 ] != proffmtELFDATA2LSB ) )
+	{
+		return -1;
+	}
+
+	if( pucElf[ 4 ] == proffmtELFCLASS64 )
+	{
+		if( xSize < 64 )
+		{
+			return -1;
+		}
+		i64 = 1;
+		uWord = 8;
+		ullShoff = prvGet( &( pucElf[ 40 ] ), 8 );
+		uShentsize = ( unsigned ) prvGet( &( pucElf[ 58 ] ), 2 );
+		uShnum = ( unsigned ) prvGet( &( pucElf[ 60 ] ), 2 );
+		uSymentsize = 24;
+	}
+	else if( pucElf[ 4 ] == proffmtELFCLASS32 )
+	{
+		i64 = 0;
+		uWord = 4;
+		ullShoff = prvGet( &( pucElf[ 32 ] ), 4 );
+		uShentsize = ( unsigned ) prvGet( &( pucElf[ 46 ] ), 2 );
+		uShnum = ( unsigned ) prvGet( &( pucElf[ 48 ] ), 2 );
+		uSymentsize = 16;
+	}
+	else
+	{
+		return -1;
+	}
+
+	if( ( uShentsize < ( i64 ? 64u : 40u ) ) || ( ullShoff > xSize ) || ( ( ( uint64_t ) uShnum * uShentsize ) > ( xSize - ullShoff ) ) )
+	{
+		return -1;
+	}
+
+	/* The section header fields used, see the ELF specification. */
+	#define symSH( uIndex )			( &( pucElf[ ullShoff + ( ( uint64_t ) ( uIndex ) * uShentsize ) ] ) )
+	#define symSH_TYPE( pucSh )		( ( unsigned ) prvGet( &( ( pucSh )[ 4 ] ), 4 ) )
+	#define symSH_FLAGS( pucSh )	prvGet( &( ( pucSh )[ 8 ] ), uWord )
+	#define symSH_ADDR( pucSh )		prvGet( &( ( pucSh )[ i64 ? 16 : 12 ] ), uWord )
+	#define symSH_OFFSET( pucSh )	prvGet( &( ( pucSh )[ i64 ? 24 : 16 ] ), uWord )
+	#define symSH_SIZE( pucSh )		prvGet( &( ( pucSh )[ i64 ? 32 : 20 ] ), uWord )
+	#define symSH_LINK( pucSh )		( ( unsigned ) prvGet( &( ( pucSh )[ i64 ? 40 : 24 ] ), 4 ) )
+
+	for( x = 0; x < uShnum; x++ )
+	{
+		if( symSH_TYPE( symSH( x ) ) == proffmtSHT_SYMTAB )
+		{
+			pucSymtab = symSH( x );
+			break;
+		}
+	}
+
+	if( ( pucSymtab == NULL ) || ( symSH_LINK( pucSymtab ) >= uShnum ) )
+	{
+		return -1;
+	}
+
+	ullOffset = symSH_OFFSET( pucSymtab );
+	ullSize = symSH_SIZE( pucSymtab );
+	pucSection = symSH( symSH_LINK( pucSymtab ) );
+	ullStrOffset = symSH_OFFSET( pucSection );
+	ullStrSize = symSH_SIZE( pucSection );
+	if( ( ullOffset > xSize ) || ( ullSize > ( xSize - ullOffset ) ) || ( ullStrOffset > xSize ) || ( ullStrSize > ( xSize - ullStrOffset ) ) )
+	{
+		return -1;
+	}
+
+	pucStrtab = &( pucElf[ ullStrOffset ] );
+	xNumSymbols = ( size_t ) ( ullSize / uSymentsize );
+	pxFunctions = calloc( xNumSymbols + 1, sizeof( Symbol_t ) );
+	pxLabels = calloc( xNumSymbols + 1, sizeof( Symbol_t ) );
+	if( ( pxFunctions == NULL ) || ( pxLabels == NULL ) )
+	{
+		return -1;
+	}
+
+	for( x = 0; x < xNumSymbols; x++ )
+	{
+		pucSymbol = &( pucElf[ ullOffset + ( x * uSymentsize ) ] );
+		uName = ( unsigned ) prvGet( pucSymbol, 4 );
+		if( i64 != 0 )
+		{
+			uType = pucSymbol[ 4 ] & 0xfu;
+			uBind = pucSymbol[ 4 ] >> 4;
+			uShndx = ( unsigned ) prvGet( &( pucSymbol[ 6 ] ), 2 );
+			ullValue = prvGet( &( pucSymbol[ 8 ] ), 8 );
+			ullSymSize = prvGet( &( pucSymbol[ 16 ] ), 8 );
+		}
+		else
+		{
+			ullValue = prvGet( &( pucSymbol[ 4 ] ), 4 );
+			ullSymSize = prvGet( &( pucSymbol[ 8 ] ), 4 );
+			uType = pucSymbol[ 12 ] & 0xfu;
+			uBind = pucSymbol[ 12 ] >> 4;
+			uShndx = ( unsigned ) prvGet( &( pucSymbol[ 14 ] ), 2 );
+		}
+
+		/* Only named symbols defined in a section of the image. */
+		if( ( uShndx == 0 ) || ( uShndx >= symSHN_LORESERVE ) || ( uShndx >= uShnum ) || ( uName >= ullStrSize ) )
+		{
+			continue;
+		}
+		pcName = ( const char * ) &( pucStrtab[ uName ] );
+		if( ( memchr( pcName, '\0', ( size_t ) ( ullStrSize - uName ) ) == NULL ) || ( pcName[ 0 ] == '\0' ) )
+		{
+			continue;
+		}
+
+		if( ( uType == proffmtSTT_FUNC ) && ( ullSymSize != 0 ) )
+		{
+			pxFunctions[ xNumFunctions ].ullStart = ullValue;
+			pxFunctions[ xNumFunctions ].ullSize = ullSymSize;
+			pxFunctions[ xNumFunctions ].pcName = pcName;
+			pxFunctions[ xNumFunctions ].uRank = ( uBind == proffmtSTB_GLOBAL ) ? 0 : ( ( uBind == proffmtSTB_LOCAL ) ? 2 : 1 );
+			xNumFunctions++;
+		}
+		else if( ( ( uType == proffmtSTT_FUNC ) || ( uType == proffmtSTT_NOTYPE ) ) && ( ( symSH_FLAGS( symSH( uShndx ) ) & proffmtSHF_EXECINSTR ) != 0 ) &&
+				 ( pcName[ 0 ] != '$' ) && ( strncmp( pcName, ".L", 2 ) != 0 ) )
+		{
+			/* A label, which extends to the next label or function, or to the
+			end of its section. */
+			ullSectionEnd = symSH_ADDR( symSH( uShndx ) ) + symSH_SIZE( symSH( uShndx ) );
+			if( ullValue >= ullSectionEnd )
+			{
+				continue;
+			}
+			pxLabels[ xNumLabels ].ullStart = ullValue;
+			pxLabels[ xNumLabels ].ullSize = ullSectionEnd - ullValue;
+			pxLabels[ xNumLabels ].pcName = pcName;
+			pxLabels[ xNumLabels ].uRank = ( uBind == proffmtSTB_GLOBAL ) ? 0 : ( ( uBind == proffmtSTB_LOCAL ) ? 2 : 1 );
+			xNumLabels++;
+		}
+	}
+
+	#undef symSH
+	#undef symSH_TYPE
+	#undef symSH_FLAGS
+	#undef symSH_ADDR
+	#undef symSH_OFFSET
+	#undef symSH_SIZE
+	#undef symSH_LINK
+
+	xNumFunctions = prvSortSymbols( pxFunctions, xNumFunctions );
+	xNumLabels = prvSortSymbols( pxLabels, xNumLabels );
+
+	/* One more count, for addresses that are not in any symbol. */
+	pxCounts = calloc( xNumFunctions + xNumLabels + 1, sizeof( Count_t ) );
+	return ( pxCounts == NULL ) ? -1 : 0;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareSymbols( const void *pvA, const void *pvB )
+{
+const Symbol_t *pxA = pvA, *pxB = pvB;
+
+	if( pxA->ullStart != pxB->ullStart )
+	{
+		return ( pxA->ullStart < pxB->ullStart ) ? -1 : 1;
+	}
+	if( pxA->uRank != pxB->uRank )
+	{
+		return ( pxA->uRank < pxB->uRank ) ? -1 : 1;
+	}
+
+	return strcmp( pxA->pcName, pxB->pcName );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvSortSymbols( Symbol_t *pxSymbols, size_t xNum )
+{
+size_t x, xKept = 0;
+
+	qsort( pxSymbols, xNum, sizeof( Symbol_t ), prvCompareSymbols );
+
+	/* Of the aliases at an address, keep the global one, then the first by
+	name, so the output does not depend on the order of the symbol table. */
+	for( x = 0; x < xNum; x++ )
+	{
+		if( ( xKept == 0 ) || ( pxSymbols[ x ].ullStart != pxSymbols[ xKept - 1 ].ullStart ) )
+		{
+			pxSymbols[ xKept++ ] = pxSymbols[ x ];
+		}
+	}
+
+	return xKept;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvLookup( uint64_t ullAddress )
+{
+size_t xLow, xHigh, xMiddle, xFunction = SIZE_MAX;
+
+	/* The last function starting at or below the address. */
+	xLow = 0;
+	xHigh = xNumFunctions;
+	while( xLow < xHigh )
+	{
+		xMiddle = xLow + ( ( xHigh - xLow ) / 2 );
+		if( pxFunctions[ xMiddle ].ullStart <= ullAddress )
+		{
+			xLow = xMiddle + 1;
+		}
+		else
+		{
+			xHigh = xMiddle;
+		}
+	}
+
+	if( xLow > 0 )
+	{
+		xFunction = xLow - 1;
+		if( ( ullAddress - pxFunctions[ xFunction ].ullStart ) < pxFunctions[ xFunction ].ullSize )
+		{
+			return xFunction;
+		}
+	}
+
+	/* Otherwise the last label starting at or below the address, if it starts
+	after that function. */
+	xLow = 0;
+	xHigh = xNumLabels;
+	while( xLow < xHigh )
+	{
+		xMiddle = xLow + ( ( xHigh - xLow ) / 2 );
+		if( pxLabels[ xMiddle ].ullStart <= ullAddress )
+		{
+			xLow = xMiddle + 1;
+		}
+		else
+		{
+			xHigh = xMiddle;
+		}
+	}
+
+	if( ( xLow > 0 ) && ( ( ullAddress - pxLabels[ xLow - 1 ].ullStart ) < pxLabels[ xLow - 1 ].ullSize ) &&
+		( ( xFunction == SIZE_MAX ) || ( pxLabels[ xLow - 1 ].ullStart > pxFunctions[ xFunction ].ullStart ) ) )
+	{
+		return xNumFunctions + xLow - 1;
+	}
+
+	return xNumFunctions + xNumLabels;
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvSymbolName( size_t xIndex )
+{
+	if( xIndex < xNumFunctions )
+	{
+		return pxFunctions[ xIndex ].pcName;
+	}
+	else if( xIndex < ( xNumFunctions + xNumLabels ) )
+	{
+		return pxLabels[ xIndex - xNumFunctions ].pcName;
+	}
+
+	return symUNKNOWN;
+}
+/*-----------------------------------------------------------*/
+
+static int prvLoadDump( const uint8_t *pucDump, size_t xSize )
+{
+uint32_t ulMaxTasks, ulNumTasks, ulTaskIdOffset, ulTaskNameOffset, ulSampleOffset, x;
+unsigned uNameLength, uLength;
+const char *pcName;
+uint64_t ullSamplesSize;
+
+	if( ( xSize < proffmtHEADER_SIZE ) ||
+		( prvGet( &( pucDump[ proffmtOFF_MAGIC ] ), 4 ) != proffmtMAGIC ) ||
+		( pucDump[ proffmtOFF_VERSION ] != proffmtVERSION ) )
+	{
+		return -1;
+	}
+
+	uPointerSize = pucDump[ proffmtOFF_POINTER_SIZE ];
+	uDepth = pucDump[ proffmtOFF_DEPTH ];
+	uNameLength = pucDump[ proffmtOFF_NAME_LENGTH ];
+	ulSampleHz = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_SAMPLE_HZ ] ), 4 );
+	ulCapacity = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_CAPACITY ] ), 4 );
+	ulHead = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_HEAD ] ), 4 );
+	ulCount = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_COUNT ] ), 4 );
+	ulMaxTasks = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_MAX_TASKS ] ), 4 );
+	ulNumTasks = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_NUM_TASKS ] ), 4 );
+	ulTaskIdOffset = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_TASK_ID_OFFSET ] ), 4 );
+	ulTaskNameOffset = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_TASK_NAME_OFFSET ] ), 4 );
+	ulSampleOffset = ( uint32_t ) prvGet( &( pucDump[ proffmtOFF_SAMPLE_OFFSET ] ), 4 );
+	ullSamplesSize = ( uint64_t ) ulCapacity * ( 2 + uDepth ) * uPointerSize;
+
+	if( ( ( uPointerSize != 4 ) && ( uPointerSize != 8 ) ) || ( ulCapacity == 0 ) || ( ulHead >= ulCapacity ) || ( ulNumTasks > ulMaxTasks ) ||
+		( ( ( uint64_t ) ulTaskIdOffset + ( ( uint64_t ) ulMaxTasks * uPointerSize ) ) > xSize ) ||
+		( ( ( uint64_t ) ulTaskNameOffset + ( ( uint64_t ) ulMaxTasks * uNameLength ) ) > xSize ) ||
+		( ( ( uint64_t ) ulSampleOffset + ullSamplesSize ) > xSize ) )
+	{
+		return -1;
+	}
+
+	pucSamples = &( pucDump[ ulSampleOffset ] );
+	ulNumSamples = ( ulCount < ulCapacity ) ? ulCount : ulCapacity;
+
+	/* The named tasks, then room for every sample to be of another task. */
+	xMaxTasks = ( size_t ) ulNumTasks + ulNumSamples;
+	pxTasks = calloc( xMaxTasks + 1, sizeof( Task_t ) );
+	if( pxTasks == NULL )
+	{
+		return -1;
+	}
+
+	for( x = 0; x < ulNumTasks; x++ )
+	{
+		pcName = ( const char * ) &( pucDump[ ulTaskNameOffset + ( x * uNameLength ) ] );
+		for( uLength = 0; ( uLength < uNameLength ) && ( pcName[ uLength ] != '\0' ); uLength++ )
+		{
+		}
+
+		pxTasks[ xNumTasks ].ullId = prvGet( &( pucDump[ ulTaskIdOffset + ( x * uPointerSize ) ] ), uPointerSize );
+		pxTasks[ xNumTasks ].pcName = malloc( uLength + 1 );
+		if( pxTasks[ xNumTasks ].pcName == NULL )
+		{
+			return -1;
+		}
+		memcpy( pxTasks[ xNumTasks ].pcName, pcName, uLength );
+		pxTasks[ xNumTasks ].pcName[ uLength ] = '\0';
+		xNumTasks++;
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static Task_t *prvFindTask( uint64_t ullId )
+{
+size_t x;
+
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		if( pxTasks[ x ].ullId == ullId )
+		{
+			return &( pxTasks[ x ] );
+		}
+	}
+
+	/* A task whose name was not recorded is named by its handle. */
+	pxTasks[ xNumTasks ].ullId = ullId;
+	pxTasks[ xNumTasks ].pcName = malloc( 24 );
+	if( pxTasks[ xNumTasks ].pcName == NULL )
+	{
+		fprintf( stderr, "profsym: out of memory\n" );
+		exit( 1 );
+	}
+	snprintf( pxTasks[ xNumTasks ].pcName, 24, "0x%0*llx", ( int ) uPointerSize * 2, ( unsigned long long ) ullId );
+
+	return &( pxTasks[ xNumTasks++ ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvFrame( uint32_t ulSample, unsigned uFrame )
+{
+const uint32_t ulIndex = ( uint32_t ) ( ( ( uint64_t ) ulHead + ulCapacity - ulNumSamples + ulSample ) % ulCapacity );
+const uint8_t *pucSample = &( pucSamples[ ( uint64_t ) ulIndex * ( 2 + uDepth ) * uPointerSize ] );
+uint64_t ullAddress;
+
+	if( uFrame == 0 )
+	{
+		return prvGet( pucSample, uPointerSize );
+	}
+
+	/* A return address is moved into the call instruction, 0 ends the
+	backtrace. */
+	ullAddress = prvGet( &( pucSample[ ( 1 + uFrame ) * uPointerSize ] ), uPointerSize );
+	return ( ullAddress == 0 ) ? 0 : ullAddress - 1;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvSampleTask( uint32_t ulSample )
+{
+const uint32_t ulIndex = ( uint32_t ) ( ( ( uint64_t ) ulHead + ulCapacity - ulNumSamples + ulSample ) % ulCapacity );
+
+	return prvGet( &( pucSamples[ ( ( ( uint64_t ) ulIndex * ( 2 + uDepth ) ) + 1 ) * uPointerSize ] ), uPointerSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintReport( void )
+{
+const size_t xNumCounts = xNumFunctions + xNumLabels + 1;
+size_t *pxOrder, x, xIndex;
+uint32_t ulSample;
+unsigned uFrame;
+uint64_t ullAddress;
+
+	for( ulSample = 0; ulSample < ulNumSamples; ulSample++ )
+	{
+		prvFindTask( prvSampleTask( ulSample ) )->ulSamples++;
+
+		for( uFrame = 0; uFrame <= uDepth; uFrame++ )
+		{
+			ullAddress = prvFrame( ulSample, uFrame );
+			if( ( uFrame > 0 ) && ( ullAddress == 0 ) )
+			{
+				break;
+			}
+
+			xIndex = prvLookup( ullAddress );
+			if( uFrame == 0 )
+			{
+				pxCounts[ xIndex ].ulSelf++;
+			}
+
+			/* Recursion counts once in a sample. */
+			if( pxCounts[ xIndex ].ulLastSample != ulSample + 1 )
+			{
+				pxCounts[ xIndex ].ulLastSample = ulSample + 1;
+				pxCounts[ xIndex ].ulTotal++;
+			}
+		}
+	}
+
+	printf( "Profile of %lu samples", ( unsigned long ) ulNumSamples );
+	if( ulCount > ulCapacity )
+	{
+		printf( ", %lu%s older samples overwritten", ( unsigned long ) ( ulCount - ulCapacity ), ( ulCount == UINT32_MAX ) ? " or more" : "" );
+	}
+	printf( "\nPointer size %u bits, %lu samples per second, backtrace depth %u\n", uPointerSize * 8, ( unsigned long ) ulSampleHz, uDepth );
+	if( ulSampleHz != 0 )
+	{
+		printf( "Sampled time %.3f s\n", ( double ) ulNumSamples / ulSampleHz );
+	}
+
+	if( ulNumSamples == 0 )
+	{
+		return;
+	}
+
+	qsort( pxTasks, xNumTasks, sizeof( Task_t ), prvCompareTasks );
+	printf( "\nTasks:                      samples   share\n" );
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		if( pxTasks[ x ].ulSamples != 0 )
+		{
+			printf( "  %-24s %8lu  %5.1f%%\n", pxTasks[ x ].pcName, ( unsigned long ) pxTasks[ x ].ulSamples, ( 100.0 * pxTasks[ x ].ulSamples ) / ulNumSamples );
+		}
+	}
+
+	pxOrder = malloc( xNumCounts * sizeof( size_t ) );
+	if( pxOrder == NULL )
+	{
+		return;
+	}
+	for( x = 0; x < xNumCounts; x++ )
+	{
+		pxOrder[ x ] = x;
+	}
+	qsort( pxOrder, xNumCounts, sizeof( size_t ), prvCompareCounts );
+
+	if( uDepth > 0 )
+	{
+		printf( "\nFunctions:  self   share     total   share\n" );
+	}
+	else
+	{
+		printf( "\nFunctions:  self   share\n" );
+	}
+
+	for( x = 0; ( x < xNumCounts ) && ( x < xListFunctions ) && ( pxCounts[ pxOrder[ x ] ].ulTotal != 0 ); x++ )
+	{
+		xIndex = pxOrder[ x ];
+		printf( "  %14lu  %5.1f%%", ( unsigned long ) pxCounts[ xIndex ].ulSelf, ( 100.0 * pxCounts[ xIndex ].ulSelf ) / ulNumSamples );
+		if( uDepth > 0 )
+		{
+			printf( "  %8lu  %5.1f%%", ( unsigned long ) pxCounts[ xIndex ].ulTotal, ( 100.0 * pxCounts[ xIndex ].ulTotal ) / ulNumSamples );
+		}
+		printf( "  %s\n", prvSymbolName( xIndex ) );
+	}
+
+	free( pxOrder );
+}
+/*-----------------------------------------------------------*/
+
+static int prvPrintFolded( void )
+{
+char **ppcStacks, *pcStack;
+const char *pcNames[ 1 + 256 ];
+size_t xLength, xRun;
+uint32_t ulSample, ulStart;
+unsigned uFrames, uFrame;
+uint64_t ullAddress;
+
+	ppcStacks = calloc( ( size_t ) ulNumSamples + 1, sizeof( char * ) );
+	if( ppcStacks == NULL )
+	{
+		fprintf( stderr, "profsym: out of memory\n" );
+		return 1;
+	}
+
+	for( ulSample = 0; ulSample < ulNumSamples; ulSample++ )
+	{
+		/* The task, then the frames from the outermost caller. */
+		uFrames = 0;
+		for( uFrame = 0; uFrame <= uDepth; uFrame++ )
+		{
+			ullAddress = prvFrame( ulSample, uFrame );
+			if( ( uFrame > 0 ) && ( ullAddress == 0 ) )
+			{
+				break;
+			}
+			pcNames[ uFrames++ ] = prvSymbolName( prvLookup( ullAddress ) );
+		}
+
+		xLength = strlen( prvFindTask( prvSampleTask( ulSample ) )->pcName ) + 1;
+		for( uFrame = 0; uFrame < uFrames; uFrame++ )
+		{
+			xLength += strlen( pcNames[ uFrame ] ) + 1;
+		}
+
+		pcStack = malloc( xLength );
+		if( pcStack == NULL )
+		{
+			fprintf( stderr, "profsym: out of memory\n" );
+			return 1;
+		}
+
+		strcpy( pcStack, prvFindTask( prvSampleTask( ulSample ) )->pcName );
+		while( uFrames > 0 )
+		{
+			strcat( pcStack, ";" );
+			strcat( pcStack, pcNames[ --uFrames ] );
+		}
+		ppcStacks[ ulSample ] = pcStack;
+	}
+
+	qsort( ppcStacks, ulNumSamples, sizeof( char * ), prvCompareStrings );
+
+	for( ulStart = 0; ulStart < ulNumSamples; ulStart += ( uint32_t ) xRun )
+	{
+		for( xRun = 1; ( ulStart + xRun < ulNumSamples ) && ( strcmp( ppcStacks[ ulStart ], ppcStacks[ ulStart + xRun ] ) == 0 ); xRun++ )
+		{
+		}
+		printf( "%s %lu\n", ppcStacks[ ulStart ], ( unsigned long ) xRun );
+	}
+
+	for( ulSample = 0; ulSample < ulNumSamples; ulSample++ )
+	{
+		free( ppcStacks[ ulSample ] );
+	}
+	free( ppcStacks );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareTasks( const void *pvA, const void *pvB )
+{
+const Task_t *pxA = pvA, *pxB = pvB;
+
+	if( pxA->ulSamples != pxB->ulSamples )
+	{
+		return ( pxA->ulSamples > pxB->ulSamples ) ? -1 : 1;
+	}
+
+	return strcmp( pxA->pcName, pxB->pcName );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCounts( const void *pvA, const void *pvB )
+{
+const Count_t *pxA = &( pxCounts[ *( const size_t * ) pvA ] ), *pxB = &( pxCounts[ *( const size_t * ) pvB ] );
+int iResult;
+
+	if( pxA->ulSelf != pxB->ulSelf )
+	{
+		return ( pxA->ulSelf > pxB->ulSelf ) ? -1 : 1;
+	}
+	if( pxA->ulTotal != pxB->ulTotal )
+	{
+		return ( pxA->ulTotal > pxB->ulTotal ) ? -1 : 1;
+	}
+
+	iResult = strcmp( prvSymbolName( *( const size_t * ) pvA ), prvSymbolName( *( const size_t * ) pvB ) );
+	if( iResult == 0 )
+	{
+		/* Functions of the same name in different files. */
+		iResult = ( *( const size_t * ) pvA < *( const size_t * ) pvB ) ? -1 : 1;
+	}
+
+	return iResult;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareStrings( const void *pvA, const void *pvB )
+{
+	return strcmp( *( char * const * ) pvA, *( char * const * ) pvB );
+}
+/*-----------------------------------------------------------*/
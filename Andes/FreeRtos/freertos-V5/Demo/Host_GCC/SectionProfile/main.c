@@ -0,0 +1,392 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for critical section and scheduler suspension profiling.
+ *
+ * tasks.c, list.c, section_profile.c and heap_4.c are built as a native host
+ * program with the port layer in this directory (see the Makefile, "make test"
+ * builds and runs the test).  Two tasks are created and the scheduler is
+ * started, at which point xPortStartScheduler() below runs the tests as the
+ * first task.  The cycle counter read by tasks.c is a variable that the tests
+ * advance, so every section takes a known number of cycles.
+ *
+ * The tests check that nested sections are timed as one, that the longest
+ * sections are kept in order with their caller and task, that the histogram
+ * counts every section, that the time a task is switched out from within a
+ * critical section is not counted, that scheduler suspensions are timed
+ * separately from the critical sections taken while the scheduler is
+ * suspended, and that sections taken before the scheduler started are not
+ * recorded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "section_profile.h"
+
+/* The number of sections of random length timed by prvTestLongest(). */
+#define testNUM_RANDOM_SECTIONS		( 100 )
+
+/* The longest section timed by prvTestLongest(), in cycles. */
+#define testMAX_RANDOM_CYCLES		( 1000000UL )
+
+/* The largest distance, in bytes, expected between the start of a helper
+function and the return address of a call it makes. */
+#define testMAX_CALL_OFFSET			( 256U )
+
+/* Report the line of the first check that fails, and exit. */
+#define testCHECK( x )		prvCheck( ( x ), #x, __LINE__ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tests, called in turn by xPortStartScheduler().
+ */
+static void prvTestBeforeScheduler( void );
+static void prvTestNesting( void );
+static void prvTestLongest( void );
+static void prvTestYield( void );
+static void prvTestSchedulerSuspended( void );
+static void prvTestList( void );
+
+/*
+ * Helpers that enter a section and spend ulCycles in it, so the recorded
+ * caller is known to be within them.  prvCriticalSection() also exits the
+ * critical section.
+ */
+static void prvEnterCritical( uint32_t ulCycles ) __attribute__( ( noinline ) );
+static void prvSuspendAll( uint32_t ulCycles ) __attribute__( ( noinline ) );
+static void prvCriticalSection( uint32_t ulCycles ) __attribute__( ( noinline ) );
+
+/*
+ * Returns pdTRUE if pvCaller is a return address within the function
+ * pvFunction.
+ */
+static BaseType_t prvCalledFrom( void *pvCaller, void ( *pvFunction )( uint32_t ) );
+
+/*
+ * Linear congruential generator, used in place of rand() so the sequence
+ * does not depend on the host C library.
+ */
+static uint32_t prvRandom( void );
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine );
+static int prvCompareCyclesDescending( const void *pv1, const void *pv2 );
+static void prvTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* Read by tasks.c through portGET_CYCLE_COUNT(). */
+volatile uint32_t ulTestCycleCount = 0UL;
+
+static TaskHandle_t xTaskA = NULL, xTaskB = NULL;
+static uint32_t ulRandomState = 0x12345678UL;
+static BaseType_t xTestsRun = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	testCHECK( xTaskCreate( prvTask, "A", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &xTaskA ) == pdPASS );
+	testCHECK( xTaskCreate( prvTask, "B", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &xTaskB ) == pdPASS );
+
+	/* Neither of these is recorded, as the scheduler has not started. */
+	vTaskSuspendAll();
+	ulTestCycleCount += 1000UL;
+	( void ) xTaskResumeAll();
+	prvCriticalSection( 1000UL );
+
+	/* Runs the tests, then returns. */
+	vTaskStartScheduler();
+
+	testCHECK( xTestsRun != pdFALSE );
+	printf( "section profile tests passed\n" );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBeforeScheduler( void )
+{
+static SectionProfile_t xProfile;
+
+	vSectionProfileGet( sectprofCRITICAL_SECTION, &xProfile );
+	testCHECK( xProfile.ulCount == 0UL );
+	testCHECK( xProfile.xLongest[ 0 ].ulCycles == 0UL );
+
+	vSectionProfileGet( sectprofSCHEDULER_SUSPENDED, &xProfile );
+	testCHECK( xProfile.ulCount == 0UL );
+	testCHECK( xProfile.xLongest[ 0 ].ulCycles == 0UL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestNesting( void )
+{
+static SectionProfile_t xProfile;
+
+	/* vSectionProfileReset() ends with a critical section of its own, which
+	takes no cycles as the cycle count does not move. */
+	vSectionProfileReset();
+
+	prvEnterCritical( 10UL );
+	taskENTER_CRITICAL();
+	ulTestCycleCount += 20UL;
+	taskEXIT_CRITICAL();
+	ulTestCycleCount += 5UL;
+	taskEXIT_CRITICAL();
+
+	vSectionProfileGet( sectprofCRITICAL_SECTION, &xProfile );
+	testCHECK( xProfile.ulCount == 2UL );
+	testCHECK( xProfile.ulHistogram[ 0 ] == 1UL );
+	testCHECK( xProfile.ulHistogram[ 5 ] == 1UL );
+	testCHECK( xProfile.xLongest[ 0 ].ulCycles == 35UL );
+	testCHECK( prvCalledFrom( xProfile.xLongest[ 0 ].pvCaller, prvEnterCritical ) != pdFALSE );
+	testCHECK( xProfile.xLongest[ 0 ].xTask == xTaskGetCurrentTaskHandle() );
+	testCHECK( xProfile.xLongest[ 1 ].ulCycles == 0UL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestLongest( void )
+{
+static SectionProfile_t xProfile;
+static uint32_t ulCycles[ testNUM_RANDOM_SECTIONS ];
+uint32_t ulExpectedHistogram[ sectprofHISTOGRAM_BUCKETS ] = { 0 };
+UBaseType_t uxSection, uxBucket;
+uint32_t ulBucketStart;
+
+	vSectionProfileReset();
+	ulExpectedHistogram[ 0 ] = 1UL;
+
+	for( uxSection = 0; uxSection < testNUM_RANDOM_SECTIONS; uxSection++ )
+	{
+		ulCycles[ uxSection ] = ( prvRandom() % testMAX_RANDOM_CYCLES ) + 1UL;
+		prvCriticalSection( ulCycles[ uxSection ] );
+
+		/* Bucket n counts 2^n to ( 2^( n + 1 ) ) - 1 cycles, and the last
+		bucket counts everything longer. */
+		for( uxBucket = sectprofHISTOGRAM_BUCKETS - 1, ulBucketStart = 1UL << uxBucket; ulCycles[ uxSection ] < ulBucketStart; uxBucket--, ulBucketStart >>= 1 )
+		{
+		}
+
+		ulExpectedHistogram[ uxBucket ]++;
+	}
+
+	vSectionProfileGet( sectprofCRITICAL_SECTION, &xProfile );
+	testCHECK( xProfile.ulCount == ( testNUM_RANDOM_SECTIONS + 1UL ) );
+	testCHECK( memcmp( xProfile.ulHistogram, ulExpectedHistogram, sizeof( ulExpectedHistogram ) ) == 0 );
+
+	qsort( ulCycles, testNUM_RANDOM_SECTIONS, sizeof( ulCycles[ 0 ] ), prvCompareCyclesDescending );
+
+	for( uxSection = 0; uxSection < configSECTION_PROFILE_LONGEST; uxSection++ )
+	{
+		testCHECK( xProfile.xLongest[ uxSection ].ulCycles == ulCycles[ uxSection ] );
+		testCHECK( prvCalledFrom( xProfile.xLongest[ uxSection ].pvCaller, prvCriticalSection ) != pdFALSE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestYield( void )
+{
+static SectionProfile_t xProfile;
+
+	vSectionProfileReset();
+	testCHECK( xTaskGetCurrentTaskHandle() == xTaskB );
+
+	/* Task B yields from within a critical section, and task A runs for
+	1000 cycles, 7 of them in a critical section of its own, before yielding
+	back to task B.  Task B's section took 15 cycles. */
+	prvEnterCritical( 10UL );
+	taskYIELD();
+
+	testCHECK( xTaskGetCurrentTaskHandle() == xTaskA );
+	ulTestCycleCount += 993UL;
+	prvCriticalSection( 7UL );
+	taskYIELD();
+
+	testCHECK( xTaskGetCurrentTaskHandle() == xTaskB );
+	ulTestCycleCount += 5UL;
+	taskEXIT_CRITICAL();
+
+	vSectionProfileGet( sectprofCRITICAL_SECTION, &xProfile );
+	testCHECK( xProfile.ulCount == 3UL );
+	testCHECK( xProfile.xLongest[ 0 ].ulCycles == 15UL );
+	testCHECK( xProfile.xLongest[ 0 ].xTask == xTaskB );
+	testCHECK( prvCalledFrom( xProfile.xLongest[ 0 ].pvCaller, prvEnterCritical ) != pdFALSE );
+	testCHECK( xProfile.xLongest[ 1 ].ulCycles == 7UL );
+	testCHECK( xProfile.xLongest[ 1 ].xTask == xTaskA );
+	testCHECK( xProfile.xLongest[ 2 ].ulCycles == 0UL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSchedulerSuspended( void )
+{
+static SectionProfile_t xProfile;
+
+	vSectionProfileReset();
+
+	/* Each xTaskResumeAll() enters a critical section, which takes no
+	cycles. */
+	prvSuspendAll( 100UL );
+	prvCriticalSection( 3UL );
+	vTaskSuspendAll();
+	ulTestCycleCount += 50UL;
+	( void ) xTaskResumeAll();
+	ulTestCycleCount += 22UL;
+	( void ) xTaskResumeAll();
+
+	vSectionProfileGet( sectprofSCHEDULER_SUSPENDED, &xProfile );
+	testCHECK( xProfile.ulCount == 1UL );
+	testCHECK( xProfile.ulHistogram[ 7 ] == 1UL );
+	testCHECK( xProfile.xLongest[ 0 ].ulCycles == 175UL );
+	testCHECK( xProfile.xLongest[ 0 ].xTask == xTaskB );
+	testCHECK( prvCalledFrom( xProfile.xLongest[ 0 ].pvCaller, prvSuspendAll ) != pdFALSE );
+	testCHECK( xProfile.xLongest[ 1 ].ulCycles == 0UL );
+
+	/* The sections are the reset, prvCriticalSection(), both calls to
+	xTaskResumeAll() and the vSectionProfileGet() above. */
+	vSectionProfileGet( sectprofCRITICAL_SECTION, &xProfile );
+	testCHECK( xProfile.ulCount == 5UL );
+	testCHECK( xProfile.xLongest[ 0 ].ulCycles == 3UL );
+	testCHECK( xProfile.xLongest[ 1 ].ulCycles == 0UL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestList( void )
+{
+static char cBuffer[ 512 ];
+char cShortBuffer[ 12 ];
+
+	/* Follows prvTestSchedulerSuspended(), whose final vSectionProfileGet()
+	added a sixth critical section. */
+	vSectionProfileList( cBuffer, sizeof( cBuffer ) );
+
+	testCHECK( strncmp( cBuffer, "critical\t3\t", 11 ) == 0 );
+	testCHECK( strstr( cBuffer, "\r\nsuspended\t175\t" ) != NULL );
+	testCHECK( strstr( cBuffer, "\r\n6 critical sections\r\n1 suspended sections\r\n" ) != NULL );
+	testCHECK( cBuffer[ strlen( cBuffer ) - 1 ] == '\n' );
+
+	/* A short buffer is truncated and terminated. */
+	memset( cShortBuffer, 'x', sizeof( cShortBuffer ) );
+	vSectionProfileList( cShortBuffer, sizeof( cShortBuffer ) );
+	testCHECK( strlen( cShortBuffer ) < sizeof( cShortBuffer ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEnterCritical( uint32_t ulCycles )
+{
+	taskENTER_CRITICAL();
+	ulTestCycleCount += ulCycles;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendAll( uint32_t ulCycles )
+{
+	vTaskSuspendAll();
+	ulTestCycleCount += ulCycles;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCriticalSection( uint32_t ulCycles )
+{
+	taskENTER_CRITICAL();
+	ulTestCycleCount += ulCycles;
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCalledFrom( void *pvCaller, void ( *pvFunction )( uint32_t ) )
+{
+uintptr_t uxCaller = ( uintptr_t ) pvCaller, uxFunction = ( uintptr_t ) pvFunction;
+
+	return ( ( uxCaller > uxFunction ) && ( uxCaller < ( uxFunction + testMAX_CALL_OFFSET ) ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+	ulRandomState = ( ulRandomState * 1103515245UL ) + 12345UL;
+	return ulRandomState >> 8;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCyclesDescending( const void *pv1, const void *pv2 )
+{
+const uint32_t ul1 = *( const uint32_t * ) pv1, ul2 = *( const uint32_t * ) pv2;
+
+	return ( ul1 < ul2 ) - ( ul1 > ul2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine )
+{
+	if( iResult == 0 )
+	{
+		printf( "main.c:%d: check failed: %s\n", iLine, pcExpression );
+		exit( 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTask( void *pvParameters )
+{
+	/* The tasks never run, the tests run in their place. */
+	( void ) pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+/* Port layer functions, see portmacro.h. */
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	( void ) pxCode;
+	( void ) pvParameters;
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+	prvTestBeforeScheduler();
+	prvTestNesting();
+	prvTestLongest();
+	prvTestYield();
+	prvTestSchedulerSuspended();
+	prvTestList();
+	xTestsRun = pdTRUE;
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+}
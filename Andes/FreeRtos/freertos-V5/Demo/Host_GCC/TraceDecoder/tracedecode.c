@@ -0,0 +1,1837 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host decoder and latency analyzer for the event stream written by the Andes
+ * RTOS tracer (RTOSDemo_bsp/tracer/tracer.c).  The input is a raw dump of the
+ * tracer log buffer, either the bytes the host has read from the buffer in
+ * order, or (with -r) the whole ring buffer together with its head and tail
+ * offsets from the Transfer Control Block.  See tracefmt.h for the event
+ * encoding.
+ *
+ * From the stream the decoder rebuilds, for each task, the intervals in which
+ * it ran and the intervals in which it was blocked on a queue, semaphore,
+ * stream buffer, event group or task notification, and for each interrupt the
+ * intervals in which it ran.  It then reports:
+ *
+ * + The share of the traced time used by each task and each interrupt.  Time
+ *   spent in an interrupt is charged to the interrupt, not to the task it
+ *   interrupted.
+ *
+ * + Wakeup latency: the time from a queue or semaphore operation in an
+ *   interrupt that woke a higher priority task to that task being switched in.
+ *
+ * + Blocking time: the time from a task switching out after blocking on a
+ *   kernel object or a notification to it being switched in again.
+ *
+ * + Heap operations: the number of allocations, failed allocations and frees,
+ *   and the peak number of bytes allocated, if the stream has MALLOC and FREE
+ *   events.
+ *
+ * + Interrupt latency: the largest entry latency, duration and wake latency of
+ *   each interrupt in CPU cycles, as measured on the target by isrstats.c, if
+ *   the stream has ISR_LATENCY_MAX events.
+ *
+ * Latency and blocking times are reported as power of two histograms.  All
+ * times are in mtime ticks, which the port increments at configCPU_CLOCK_HZ, so
+ * the CPU frequency in the SYSTEM_DESC event is used as the timebase unless
+ * -f is given.
+ *
+ * Usage: tracedecode [-e] [-l] [-a 32|64] [-f hz] [-r head,tail] [-j out.json] dump
+ *
+ *   -e   print every decoded event
+ *   -l   print the run and blocked intervals of each task
+ *   -a   pointer size of the target, if the stream has no SYSTEM_DESC event
+ *   -f   mtime frequency in Hz
+ *   -r   the dump is the whole ring buffer, with the given head and tail
+ *   -j   write the intervals and events as Chrome trace event JSON, which can
+ *        be opened by chrome://tracing and by Perfetto (ui.perfetto.dev)
+ *
+ * The exit status is 0 if the whole dump was decoded and 1 otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tracefmt.h"
+
+/* Number of histogram buckets.  Bucket 0 holds zero tick times, bucket n holds
+times from 2^(n-1) to 2^n - 1 ticks, and the last bucket holds everything
+longer. */
+#define decodeHISTOGRAM_BUCKETS		( 34 )
+
+/* Width of the longest bar drawn in a histogram. */
+#define decodeHISTOGRAM_BAR_WIDTH	( 40 )
+
+/* Longest name kept for a task or object, the same as prvMAX_TASK_NAME_SIZE in
+tracer.c. */
+#define decodeMAX_NAME_SIZE			( 256 )
+
+/* Deepest interrupt nesting followed. */
+#define decodeMAX_IRQ_NESTING		( 16 )
+
+/* Chrome trace thread used for interrupts.  Tasks use their index plus one. */
+#define decodeIRQ_THREAD			( 0 )
+
+/* Kinds of Record_t. */
+#define decodeRECORD_RUN			( 0 )
+#define decodeRECORD_BLOCKED		( 1 )
+#define decodeRECORD_IRQ			( 2 )
+#define decodeRECORD_INSTANT		( 3 )
+
+/* Return values of prvDecodeEvent(). */
+#define decodeOK					( 0 )
+#define decodeTRUNCATED				( -1 )
+#define decodeBAD_EVENT				( -2 )
+
+/*-----------------------------------------------------------*/
+
+/* One decoded event. */
+typedef struct
+{
+	size_t xOffset;
+	uint8_t ucId;
+	uint64_t ullTime;
+	uint64_t ullPtr;
+	uint64_t ullTicksToWait;
+	uint32_t ulValue;
+	uint16_t usValue;
+	uint8_t ucStatus;
+	uint8_t ucQueueType;
+	uint8_t ucWoken;
+	uint8_t ucHasTicksToWait;
+	uint8_t ucHasWoken;
+	uint8_t ucLevel;
+	uint8_t ucContext;
+	char cName[ decodeMAX_NAME_SIZE ];
+
+	/* Fields of the kernel object events. */
+	uint8_t ucType;
+	uint64_t ullValue;
+	uint64_t ullValue2;
+} Event_t;
+
+/* Count, minimum, maximum, total and histogram of a set of times. */
+typedef struct
+{
+	uint32_t ulCount;
+	uint64_t ullMin;
+	uint64_t ullMax;
+	uint64_t ullTotal;
+	uint32_t ulHistogram[ decodeHISTOGRAM_BUCKETS ];
+} Stats_t;
+
+typedef struct
+{
+	uint64_t ullId;
+	char cName[ decodeMAX_NAME_SIZE ];
+	uint16_t usPriority;
+	int xHasInfo;
+	int xIsIdle;
+	int xDeleted;
+	uint32_t ulSwitchIns;
+	uint64_t ullRunTicks;
+
+	/* Start of the open run interval, if the task is the current task. */
+	uint64_t ullRunStart;
+
+	/* Set by a blocking kernel object event, the task is then blocked from the
+	end of its run interval until it is next switched in. */
+	int xBlockPending;
+	int xBlocked;
+	uint64_t ullBlockStart;
+	uint64_t ullBlockObject;
+
+	Stats_t xBlockStats;
+	Stats_t xWakeStats;
+} Task_t;
+
+typedef struct
+{
+	uint8_t ucType;
+	uint16_t usId;
+	uint32_t ulCount;
+	uint64_t ullSelfTicks;
+	uint64_t ullMaxTicks;
+
+	/* The largest of each measure in ISR_LATENCY_MAX events. */
+	int xHasCycles;
+	uint64_t ullMaxCycles[ tracefmtISR_MEASURES ];
+} Irq_t;
+
+typedef struct
+{
+	uint64_t ullId;
+	char cName[ decodeMAX_NAME_SIZE ];
+} Object_t;
+
+/* An interval or instant kept for the timeline and the JSON output. */
+typedef struct
+{
+	uint8_t ucKind;
+	uint8_t ucEvent;
+	uint8_t ucStatus;
+	size_t xSequence;
+	size_t xIndex;
+	int xThread;
+	uint64_t ullStart;
+	uint64_t ullDuration;
+	uint64_t ullObject;
+} Record_t;
+
+typedef struct
+{
+	size_t xIrq;
+	uint64_t ullEnter;
+} IrqFrame_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the dump into a buffer, taking the bytes from tail to head if the dump
+ * is a whole ring buffer.
+ */
+static uint8_t *prvReadDump( const char *pcFile, const char *pcRing, size_t *pxSize );
+
+/*
+ * Decode the event at *pxOffset, advancing *pxOffset past it.
+ */
+static int prvDecodeEvent( const uint8_t *pucData, size_t xSize, size_t *pxOffset, Event_t *pxEvent );
+
+/*
+ * Update the task, interrupt and latency state for one event.
+ */
+static void prvProcessEvent( const Event_t *pxEvent );
+
+static void prvPrintEvent( const Event_t *pxEvent );
+static void prvPrintReport( void );
+static void prvPrintTimeline( void );
+static int prvWriteJson( const char *pcFile );
+
+/*
+ * Helpers for the state.
+ */
+static size_t prvFindTask( uint64_t ullId );
+static size_t prvFindIrq( uint8_t ucType, uint16_t usId );
+static size_t prvLatencyIrq( uint64_t ullSource );
+static const char *prvObjectName( uint64_t ullId );
+static void prvSetObjectName( uint64_t ullId, const char *pcName );
+static void prvCharge( uint64_t ullTime );
+static void prvSwitchIn( size_t xTask, uint64_t ullTime );
+static void prvEndRun( uint64_t ullTime );
+static void prvAddRecord( uint8_t ucKind, size_t xIndex, int xThread, uint64_t ullStart, uint64_t ullEnd );
+static void prvAddStat( Stats_t *pxStats, uint64_t ullTicks );
+static void prvPrintStats( const char *pcName, const Stats_t *pxStats );
+static const char *prvEventName( uint8_t ucId );
+static unsigned prvObjectFields( uint8_t ucId );
+static void prvPrintObjectEvent( const Event_t *pxEvent );
+static const char *prvStatusName( uint8_t ucStatus );
+static const char *prvMeasureName( uint8_t ucMeasure );
+static const char *prvIrqName( size_t xIrq );
+static void prvPrintJsonString( FILE *pxFile, const char *pcString );
+static int prvCompareRecords( const void *pv1, const void *pv2 );
+static void *prvGrow( void *pvArray, size_t *pxCapacity, size_t xCount, size_t xItemSize );
+
+/*-----------------------------------------------------------*/
+
+/* Pointer size of the target, set by -a or by the SYSTEM_DESC event. */
+static unsigned uPointerSize = 8;
+static int xPointerSizeGiven = 0;
+
+/* Timebase in Hz, set by -f or by the SYSTEM_DESC event. */
+static uint64_t ullFrequency = 0;
+static int xFrequencyGiven = 0;
+
+static Task_t *pxTasks = NULL;
+static size_t xNumTasks = 0, xTaskCapacity = 0;
+static Irq_t *pxIrqs = NULL;
+static size_t xNumIrqs = 0, xIrqCapacity = 0;
+static Object_t *pxObjects = NULL;
+static size_t xNumObjects = 0, xObjectCapacity = 0;
+static Record_t *pxRecords = NULL;
+static size_t xNumRecords = 0, xRecordCapacity = 0;
+
+/* Index of the current task, or SIZE_MAX if there is none. */
+static size_t xCurrentTask = SIZE_MAX;
+
+/* Interrupts currently being handled, innermost last. */
+static IrqFrame_t xIrqStack[ decodeMAX_IRQ_NESTING ];
+static size_t xIrqLevel = 0;
+
+/* Time of the first event, and time up to which prvCharge() has charged. */
+static uint64_t ullFirstTime = 0, ullChargedTime = 0;
+static uint64_t ullLastTime = 0;
+
+/* Time charged to no task and no interrupt, before the first switch in. */
+static uint64_t ullUnknownTicks = 0;
+
+/* Time of the first interrupt operation that woke a higher priority task and
+has not yet been followed by a switch in. */
+static int xWakePending = 0;
+static uint64_t ullWakeTime = 0;
+
+static uint32_t ulNumEvents = 0;
+static uint64_t ullLostEvents = 0;
+
+/* Counts of the MALLOC and FREE events, and the bytes allocated by them. */
+static uint32_t ulMallocs = 0, ulFailedMallocs = 0, ulFrees = 0;
+static uint64_t ullHeapBytes = 0, ullPeakHeapBytes = 0;
+
+static int xPrintEvents = 0;
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+const char *pcRing = NULL, *pcJson = NULL;
+uint8_t *pucData;
+size_t xSize, xOffset = 0;
+Event_t xEvent;
+int xOption, xPrintTimeline = 0, xResult = decodeOK, xExitStatus = 0;
+
+	while( ( xOption = getopt( argc, argv, "ela:f:r:j:" ) ) != -1 )
+	{
+		switch( xOption )
+		{
+			case 'e':
+				xPrintEvents = 1;
+				break;
+
+			case 'l':
+				xPrintTimeline = 1;
+				break;
+
+			case 'a':
+				if( strcmp( optarg, "32" ) == 0 )
+				{
+					uPointerSize = 4;
+				}
+				else if( strcmp( optarg, "64" ) == 0 )
+				{
+					uPointerSize = 8;
+				}
+				else
+				{
+					fprintf( stderr, "tracedecode: -a must be 32 or 64\n" );
+					return 1;
+				}
+				xPointerSizeGiven = 1;
+				break;
+
+			case 'f':
+				ullFrequency = strtoull( optarg, NULL, 0 );
+				if( ullFrequency == 0 )
+				{
+					fprintf( stderr, "tracedecode: bad frequency %s\n", optarg );
+					return 1;
+				}
+				xFrequencyGiven = 1;
+				break;
+
+			case 'r':
+				pcRing = optarg;
+				break;
+
+			case 'j':
+				pcJson = optarg;
+				break;
+
+			default:
+				fprintf( stderr, "usage: tracedecode [-e] [-l] [-a 32|64] [-f hz] [-r head,tail] [-j out.json] dump\n" );
+				return 1;
+		}
+	}
+
+	if( optind != ( argc - 1 ) )
+	{
+		fprintf( stderr, "usage: tracedecode [-e] [-l] [-a 32|64] [-f hz] [-r head,tail] [-j out.json] dump\n" );
+		return 1;
+	}
+
+	pucData = prvReadDump( argv[ optind ], pcRing, &xSize );
+	if( pucData == NULL )
+	{
+		return 1;
+	}
+
+	if( xPrintEvents != 0 )
+	{
+		printf( "Events:\n" );
+	}
+
+	while( xOffset < xSize )
+	{
+		xResult = prvDecodeEvent( pucData, xSize, &xOffset, &xEvent );
+		if( xResult != decodeOK )
+		{
+			break;
+		}
+
+		ulNumEvents++;
+		prvProcessEvent( &xEvent );
+	}
+
+	/* Close the intervals still open at the end of the trace. */
+	prvCharge( ullLastTime );
+	prvEndRun( ullLastTime );
+	while( xIrqLevel > 0 )
+	{
+		xIrqLevel--;
+		prvAddRecord( decodeRECORD_IRQ, xIrqStack[ xIrqLevel ].xIrq, decodeIRQ_THREAD, xIrqStack[ xIrqLevel ].ullEnter, ullLastTime );
+	}
+
+	/* Intervals are recorded when they end, so put them in start order. */
+	if( xNumRecords > 0 )
+	{
+		qsort( pxRecords, xNumRecords, sizeof( Record_t ), prvCompareRecords );
+	}
+
+	if( xResult == decodeTRUNCATED )
+	{
+		printf( "Error: event truncated at offset %lu\n", ( unsigned long ) xOffset );
+		xExitStatus = 1;
+	}
+	else if( xResult == decodeBAD_EVENT )
+	{
+		printf( "Error: unknown or malformed event 0x%02x at offset %lu\n", pucData[ xOffset ], ( unsigned long ) xOffset );
+		xExitStatus = 1;
+	}
+
+	if( xPrintEvents != 0 )
+	{
+		printf( "\n" );
+	}
+
+	prvPrintReport();
+
+	if( xPrintTimeline != 0 )
+	{
+		prvPrintTimeline();
+	}
+
+	if( ( pcJson != NULL ) && ( prvWriteJson( pcJson ) != 0 ) )
+	{
+		xExitStatus = 1;
+	}
+
+	free( pucData );
+	return xExitStatus;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvReadDump( const char *pcFile, const char *pcRing, size_t *pxSize )
+{
+FILE *pxFile;
+uint8_t *pucDump, *pucData;
+size_t xDumpSize = 0, xCapacity = 4096, xRead;
+unsigned long ulHead, ulTail;
+
+	pxFile = fopen( pcFile, "rb" );
+	if( pxFile == NULL )
+	{
+		perror( pcFile );
+		return NULL;
+	}
+
+	pucDump = malloc( xCapacity );
+	while( pucDump != NULL )
+	{
+		xRead = fread( pucDump + xDumpSize, 1, xCapacity - xDumpSize, pxFile );
+		xDumpSize += xRead;
+		if( xDumpSize < xCapacity )
+		{
+			break;
+		}
+		pucDump = prvGrow( pucDump, &xCapacity, xDumpSize, 1 );
+	}
+	fclose( pxFile );
+
+	if( ( pucDump == NULL ) || ( pcRing == NULL ) )
+	{
+		*pxSize = xDumpSize;
+		return pucDump;
+	}
+
+	/* The target writes at head and the host reads from tail, so the unread
+	events run from tail to head, wrapping at the end of the buffer. */
+	if( ( sscanf( pcRing, "%lu,%lu", &ulHead, &ulTail ) != 2 ) || ( ulHead >= xDumpSize ) || ( ulTail >= xDumpSize ) )
+	{
+		fprintf( stderr, "tracedecode: bad ring offsets %s for a %lu byte dump\n", pcRing, ( unsigned long ) xDumpSize );
+		free( pucDump );
+		return NULL;
+	}
+
+	pucData = malloc( xDumpSize );
+	if( pucData != NULL )
+	{
+		if( ulTail <= ulHead )
+		{
+			*pxSize = ulHead - ulTail;
+			memcpy( pucData, pucDump + ulTail, *pxSize );
+		}
+		else
+		{
+			*pxSize = ( xDumpSize - ulTail ) + ulHead;
+			memcpy( pucData, pucDump + ulTail, xDumpSize - ulTail );
+			memcpy( pucData + ( xDumpSize - ulTail ), pucDump, ulHead );
+		}
+	}
+
+	free( pucDump );
+	return pucData;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvReadField( const uint8_t *pucField, unsigned uSize )
+{
+uint64_t ullValue = 0;
+unsigned u;
+
+	/* Fields are in target byte order, which is little endian. */
+	for( u = 0; u < uSize; u++ )
+	{
+		ullValue |= ( ( uint64_t ) pucField[ u ] ) << ( 8 * u );
+	}
+
+	return ullValue;
+}
+/*-----------------------------------------------------------*/
+
+static int prvDecodeEvent( const uint8_t *pucData, size_t xSize, size_t *pxOffset, Event_t *pxEvent )
+{
+size_t xPos = *pxOffset, xEnd, xLength;
+const size_t xStart = xPos;
+uint64_t ullDelta = 0;
+unsigned uShift = 0, uOp, uFields;
+uint8_t ucByte;
+int xHasLength = 0, xFromIsr;
+
+	/* Take a field of the given size, or fail if the dump ends first. */
+	#define decodeTAKE( uSize, ullOut )								\
+	{																\
+		if( ( xSize - xPos ) < ( uSize ) )							\
+		{															\
+			return decodeTRUNCATED;									\
+		}															\
+		ullOut = prvReadField( &( pucData[ xPos ] ), ( uSize ) );	\
+		xPos += ( uSize );											\
+	}
+
+	memset( pxEvent, 0, sizeof( *pxEvent ) );
+	pxEvent->xOffset = xStart;
+	pxEvent->ucId = pucData[ xPos++ ];
+	xEnd = xSize;
+
+	switch( pxEvent->ucId )
+	{
+		case tracefmtEVT_TRACE_START:
+		case tracefmtEVT_TRACE_STOP:
+		case tracefmtEVT_START_INFO_FINISHED:
+			break;
+
+		case tracefmtEVT_BUFFER_OVERFLOW:
+			decodeTAKE( 4, pxEvent->ulValue );
+			break;
+
+		case tracefmtEVT_SYSTEM_DESC:
+		case tracefmtEVT_TASK_INFO:
+		case tracefmtEVT_CURRENT_CONTEXT:
+		case tracefmtEVT_HEAP_STATS:
+		case tracefmtEVT_HEAP_ALLOCATION:
+			/* The length counts itself and the fields after it, so fields
+			added by a later tracer are skipped. */
+			decodeTAKE( 1, xLength );
+			if( xLength == 0 )
+			{
+				return decodeBAD_EVENT;
+			}
+			if( ( xSize - xStart - 1 ) < xLength )
+			{
+				return decodeTRUNCATED;
+			}
+			xEnd = xStart + 1 + xLength;
+			xHasLength = 1;
+
+			if( pxEvent->ucId == tracefmtEVT_SYSTEM_DESC )
+			{
+				decodeTAKE( 4, pxEvent->ulValue );
+				decodeTAKE( 1, pxEvent->ucContext );
+			}
+			else if( pxEvent->ucId == tracefmtEVT_TASK_INFO )
+			{
+				decodeTAKE( uPointerSize, pxEvent->ullPtr );
+				decodeTAKE( 2, pxEvent->usValue );
+			}
+			else if( pxEvent->ucId == tracefmtEVT_CURRENT_CONTEXT )
+			{
+				decodeTAKE( 1, pxEvent->ucLevel );
+				decodeTAKE( 1, pxEvent->ucContext );
+				decodeTAKE( uPointerSize, pxEvent->ullPtr );
+			}
+
+			if( xPos > xEnd )
+			{
+				return decodeBAD_EVENT;
+			}
+			break;
+
+		case tracefmtEVT_IDLE_TASK_INFO:
+		case tracefmtEVT_OBJECT_NAME:
+		case tracefmtEVT_TASK_SWITCH_IN:
+		case tracefmtEVT_TASK_CREATE:
+		case tracefmtEVT_TASK_DELETE:
+			decodeTAKE( uPointerSize, pxEvent->ullPtr );
+			break;
+
+		case tracefmtEVT_EXCEPTION_ENTER:
+		case tracefmtEVT_EXCEPTION_EXIT:
+		case tracefmtEVT_ISR_ENTER:
+		case tracefmtEVT_ISR_EXIT:
+		case tracefmtEVT_TICK_ISR_ENTER:
+		case tracefmtEVT_TICK_ISR_EXIT:
+			decodeTAKE( 2, pxEvent->usValue );
+			break;
+
+		case tracefmtEVT_QUEUE_SEND:
+		case tracefmtEVT_QUEUE_SEND_FROM_ISR:
+		case tracefmtEVT_QUEUE_RECV:
+		case tracefmtEVT_QUEUE_RECV_FROM_ISR:
+		case tracefmtEVT_QUEUE_PEEK:
+		case tracefmtEVT_QUEUE_PEEK_FROM_ISR:
+			xFromIsr = ( ( pxEvent->ucId - tracefmtEVT_QUEUE_SEND ) & 1 );
+			decodeTAKE( uPointerSize, pxEvent->ullPtr );
+			decodeTAKE( 1, pxEvent->ucStatus );
+			if( xFromIsr == 0 )
+			{
+				decodeTAKE( uPointerSize, pxEvent->ullTicksToWait );
+				pxEvent->ucHasTicksToWait = 1;
+			}
+			else if( pxEvent->ucId != tracefmtEVT_QUEUE_PEEK_FROM_ISR )
+			{
+				decodeTAKE( 1, pxEvent->ucWoken );
+				pxEvent->ucHasWoken = 1;
+			}
+			break;
+
+		case tracefmtEVT_SEMAPHORE_TAKE:
+		case tracefmtEVT_SEMAPHORE_TAKE_FROM_ISR:
+		case tracefmtEVT_SEMAPHORE_GIVE:
+		case tracefmtEVT_SEMAPHORE_GIVE_FROM_ISR:
+			uOp = pxEvent->ucId - tracefmtEVT_SEMAPHORE_TAKE;
+			xFromIsr = ( uOp & 1 );
+			decodeTAKE( uPointerSize, pxEvent->ullPtr );
+			decodeTAKE( 1, pxEvent->ucStatus );
+			decodeTAKE( 1, pxEvent->ucQueueType );
+			if( xFromIsr == 0 )
+			{
+				if( pxEvent->ucId == tracefmtEVT_SEMAPHORE_TAKE )
+				{
+					decodeTAKE( uPointerSize, pxEvent->ullTicksToWait );
+					pxEvent->ucHasTicksToWait = 1;
+				}
+			}
+			else
+			{
+				decodeTAKE( 1, pxEvent->ucWoken );
+				pxEvent->ucHasWoken = 1;
+			}
+			break;
+
+		default:
+			/* Kernel object events, with the fields in a fixed order. */
+			uFields = prvObjectFields( pxEvent->ucId );
+			if( uFields == 0 )
+			{
+				return decodeBAD_EVENT;
+			}
+
+			if( ( uFields & tracefmtFIELD_OBJECT ) != 0 )
+			{
+				decodeTAKE( uPointerSize, pxEvent->ullPtr );
+			}
+			if( ( uFields & tracefmtFIELD_STATUS ) != 0 )
+			{
+				decodeTAKE( 1, pxEvent->ucStatus );
+			}
+			if( ( uFields & tracefmtFIELD_TYPE ) != 0 )
+			{
+				decodeTAKE( 1, pxEvent->ucType );
+			}
+			if( ( uFields & tracefmtFIELD_PRIORITY ) != 0 )
+			{
+				decodeTAKE( 2, pxEvent->usValue );
+			}
+			if( ( uFields & tracefmtFIELD_VALUE ) != 0 )
+			{
+				decodeTAKE( uPointerSize, pxEvent->ullValue );
+			}
+			if( ( uFields & tracefmtFIELD_VALUE2 ) != 0 )
+			{
+				decodeTAKE( uPointerSize, pxEvent->ullValue2 );
+			}
+
+			/* Only a failed allocation is not a success. */
+			if( ( pxEvent->ucId == tracefmtEVT_MALLOC ) && ( pxEvent->ullPtr == 0 ) )
+			{
+				pxEvent->ucStatus = tracefmtSTAT_FAIL;
+			}
+			break;
+	}
+
+	/* Strings are NUL terminated, and end the fields of the event. */
+	if( ( pxEvent->ucId == tracefmtEVT_TASK_INFO ) || ( pxEvent->ucId == tracefmtEVT_OBJECT_NAME ) )
+	{
+	size_t xLen = 0;
+
+		while( ( xPos < xEnd ) && ( pucData[ xPos ] != '\0' ) )
+		{
+			if( xLen < ( decodeMAX_NAME_SIZE - 1 ) )
+			{
+				pxEvent->cName[ xLen++ ] = ( char ) pucData[ xPos ];
+			}
+			xPos++;
+		}
+
+		if( xPos >= xEnd )
+		{
+			return ( xEnd == xSize ) ? decodeTRUNCATED : decodeBAD_EVENT;
+		}
+		xPos++;
+	}
+
+	if( xHasLength != 0 )
+	{
+		xPos = xEnd;
+	}
+
+	/* Timestamp delta. */
+	do
+	{
+		if( xPos >= xSize )
+		{
+			return decodeTRUNCATED;
+		}
+		if( uShift >= ( 7 * tracefmtMAX_LEB128_SIZE ) )
+		{
+			return decodeBAD_EVENT;
+		}
+
+		ucByte = pucData[ xPos++ ];
+		ullDelta |= ( ( uint64_t ) ( ucByte & 0x7f ) ) << uShift;
+		uShift += 7;
+	} while( ( ucByte & 0x80 ) != 0 );
+
+	#undef decodeTAKE
+
+	/* Deltas are from the previous event that was written, even when events
+	were lost in between. */
+	pxEvent->ullTime = ( ( ulNumEvents == 0 ) ? 0 : ullLastTime ) + ullDelta;
+	*pxOffset = xPos;
+
+	return decodeOK;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessEvent( const Event_t *pxEvent )
+{
+const uint64_t ullTime = pxEvent->ullTime;
+uint64_t ullObject = pxEvent->ullPtr;
+size_t xTask, xIrq;
+uint8_t ucType;
+
+	if( ulNumEvents == 1 )
+	{
+		ullFirstTime = ullChargedTime = ullTime;
+	}
+
+	ullLastTime = ullTime;
+
+	switch( pxEvent->ucId )
+	{
+			case tracefmtEVT_TRACE_STOP:
+			/* Nothing is known until the next CURRENT_CONTEXT. */
+			prvCharge( ullTime );
+			prvEndRun( ullTime );
+			while( xIrqLevel > 0 )
+			{
+				xIrqLevel--;
+				prvAddRecord( decodeRECORD_IRQ, xIrqStack[ xIrqLevel ].xIrq, decodeIRQ_THREAD, xIrqStack[ xIrqLevel ].ullEnter, ullTime );
+			}
+			for( xTask = 0; xTask < xNumTasks; xTask++ )
+			{
+				pxTasks[ xTask ].xBlocked = 0;
+			}
+			xWakePending = 0;
+			break;
+
+		case tracefmtEVT_BUFFER_OVERFLOW:
+			ullLostEvents += pxEvent->ulValue;
+			break;
+
+		case tracefmtEVT_SYSTEM_DESC:
+			if( xPointerSizeGiven == 0 )
+			{
+				uPointerSize = ( pxEvent->ucContext == tracefmtARCH_RV64 ) ? 8 : 4;
+			}
+			if( xFrequencyGiven == 0 )
+			{
+				ullFrequency = pxEvent->ulValue;
+			}
+			break;
+
+		case tracefmtEVT_TASK_INFO:
+			xTask = prvFindTask( pxEvent->ullPtr );
+			strcpy( pxTasks[ xTask ].cName, pxEvent->cName );
+			pxTasks[ xTask ].usPriority = pxEvent->usValue;
+			pxTasks[ xTask ].xHasInfo = 1;
+			pxTasks[ xTask ].xDeleted = 0;
+			break;
+
+		case tracefmtEVT_IDLE_TASK_INFO:
+			xTask = prvFindTask( pxEvent->ullPtr );
+			pxTasks[ xTask ].xIsIdle = 1;
+			break;
+
+		case tracefmtEVT_OBJECT_NAME:
+			prvSetObjectName( pxEvent->ullPtr, pxEvent->cName );
+			break;
+
+		case tracefmtEVT_CURRENT_CONTEXT:
+			/* The interrupts being handled when tracing started are not
+			known, so only the task is followed. */
+			prvCharge( ullTime );
+			if( ( pxEvent->ucContext == tracefmtCONTEXT_TASK ) && ( pxEvent->ullPtr != 0 ) )
+			{
+				prvSwitchIn( prvFindTask( pxEvent->ullPtr ), ullTime );
+			}
+			break;
+
+		case tracefmtEVT_EXCEPTION_ENTER:
+		case tracefmtEVT_ISR_ENTER:
+		case tracefmtEVT_TICK_ISR_ENTER:
+			prvCharge( ullTime );
+			if( pxEvent->ucId == tracefmtEVT_EXCEPTION_ENTER )
+			{
+				ucType = tracefmtCONTEXT_EXCEPTION;
+			}
+			else if( pxEvent->ucId == tracefmtEVT_ISR_ENTER )
+			{
+				ucType = tracefmtCONTEXT_ISR;
+			}
+			else
+			{
+				ucType = tracefmtCONTEXT_TICK_ISR;
+			}
+
+			xIrq = prvFindIrq( ucType, pxEvent->usValue );
+			pxIrqs[ xIrq ].ulCount++;
+			if( xIrqLevel < decodeMAX_IRQ_NESTING )
+			{
+				xIrqStack[ xIrqLevel ].xIrq = xIrq;
+				xIrqStack[ xIrqLevel ].ullEnter = ullTime;
+				xIrqLevel++;
+			}
+			break;
+
+		case tracefmtEVT_EXCEPTION_EXIT:
+		case tracefmtEVT_ISR_EXIT:
+		case tracefmtEVT_TICK_ISR_EXIT:
+			prvCharge( ullTime );
+			if( xIrqLevel > 0 )
+			{
+				xIrqLevel--;
+				xIrq = xIrqStack[ xIrqLevel ].xIrq;
+				if( ( ullTime - xIrqStack[ xIrqLevel ].ullEnter ) > pxIrqs[ xIrq ].ullMaxTicks )
+				{
+					pxIrqs[ xIrq ].ullMaxTicks = ullTime - xIrqStack[ xIrqLevel ].ullEnter;
+				}
+				prvAddRecord( decodeRECORD_IRQ, xIrq, decodeIRQ_THREAD, xIrqStack[ xIrqLevel ].ullEnter, ullTime );
+			}
+			break;
+
+		case tracefmtEVT_TASK_SWITCH_IN:
+			prvCharge( ullTime );
+			xTask = prvFindTask( pxEvent->ullPtr );
+			if( ( xWakePending != 0 ) && ( xTask != xCurrentTask ) )
+			{
+				prvAddStat( &( pxTasks[ xTask ].xWakeStats ), ullTime - ullWakeTime );
+				xWakePending = 0;
+			}
+			prvSwitchIn( xTask, ullTime );
+			break;
+
+		case tracefmtEVT_TASK_CREATE:
+			( void ) prvFindTask( pxEvent->ullPtr );
+			break;
+
+		case tracefmtEVT_TASK_DELETE:
+			xTask = prvFindTask( pxEvent->ullPtr );
+			pxTasks[ xTask ].xDeleted = 1;
+			pxTasks[ xTask ].xBlockPending = 0;
+			pxTasks[ xTask ].xBlocked = 0;
+			break;
+
+		case tracefmtEVT_ISR_LATENCY_MAX:
+			/* Measured in cycles on the target, so not part of the
+			intervals. */
+			if( pxEvent->ucType < tracefmtISR_MEASURES )
+			{
+				xIrq = prvLatencyIrq( pxEvent->ullValue2 );
+				pxIrqs[ xIrq ].xHasCycles = 1;
+				if( pxEvent->ullValue > pxIrqs[ xIrq ].ullMaxCycles[ pxEvent->ucType ] )
+				{
+					pxIrqs[ xIrq ].ullMaxCycles[ pxEvent->ucType ] = pxEvent->ullValue;
+				}
+			}
+			break;
+
+		case tracefmtEVT_TRACE_START:
+		case tracefmtEVT_START_INFO_FINISHED:
+		case tracefmtEVT_HEAP_STATS:
+		case tracefmtEVT_HEAP_ALLOCATION:
+			break;
+
+		default:
+			if( pxEvent->ucId == tracefmtEVT_MALLOC )
+			{
+				if( pxEvent->ullPtr == 0 )
+				{
+					ulFailedMallocs++;
+				}
+				else
+				{
+					ulMallocs++;
+					ullHeapBytes += pxEvent->ullValue;
+					if( ullHeapBytes > ullPeakHeapBytes )
+					{
+						ullPeakHeapBytes = ullHeapBytes;
+					}
+				}
+			}
+			else if( pxEvent->ucId == tracefmtEVT_FREE )
+			{
+				/* Blocks allocated before tracing started are not counted. */
+				ulFrees++;
+				ullHeapBytes -= ( pxEvent->ullValue < ullHeapBytes ) ? pxEvent->ullValue : ullHeapBytes;
+			}
+
+			/* Queue, semaphore and other kernel object operations. */
+			if( xIrqLevel > 0 )
+			{
+				if( ( pxEvent->ucWoken != 0 ) && ( xWakePending == 0 ) )
+				{
+					xWakePending = 1;
+					ullWakeTime = ullTime;
+				}
+				xIrq = xIrqStack[ xIrqLevel - 1 ].xIrq;
+				prvAddRecord( decodeRECORD_INSTANT, xIrq, decodeIRQ_THREAD, ullTime, ullTime );
+			}
+			else if( xCurrentTask != SIZE_MAX )
+			{
+				/* A task waits for its own notifications. */
+				if( ( pxEvent->ucId == tracefmtEVT_TASK_NOTIFY_TAKE ) || ( pxEvent->ucId == tracefmtEVT_TASK_NOTIFY_WAIT ) )
+				{
+					ullObject = pxTasks[ xCurrentTask ].ullId;
+				}
+
+				/* A stream buffer blocks in a notification wait, so the
+				first object the task blocks on is kept. */
+				if( ( pxEvent->ucStatus == tracefmtSTAT_BLOCKING ) && ( pxTasks[ xCurrentTask ].xBlockPending == 0 ) )
+				{
+					pxTasks[ xCurrentTask ].xBlockPending = 1;
+					pxTasks[ xCurrentTask ].ullBlockObject = ullObject;
+				}
+				prvAddRecord( decodeRECORD_INSTANT, xCurrentTask, ( int ) xCurrentTask + 1, ullTime, ullTime );
+			}
+			else
+			{
+				prvAddRecord( decodeRECORD_INSTANT, SIZE_MAX, decodeIRQ_THREAD, ullTime, ullTime );
+			}
+
+			if( xNumRecords > 0 )
+			{
+				pxRecords[ xNumRecords - 1 ].ucEvent = pxEvent->ucId;
+				pxRecords[ xNumRecords - 1 ].ucStatus = pxEvent->ucStatus;
+				pxRecords[ xNumRecords - 1 ].ullObject = ullObject;
+			}
+			break;
+	}
+
+	if( xPrintEvents != 0 )
+	{
+		prvPrintEvent( pxEvent );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCharge( uint64_t ullTime )
+{
+const uint64_t ullTicks = ullTime - ullChargedTime;
+
+	/* Time is charged to the innermost interrupt being handled, or if there is
+	none to the current task. */
+	if( xIrqLevel > 0 )
+	{
+		pxIrqs[ xIrqStack[ xIrqLevel - 1 ].xIrq ].ullSelfTicks += ullTicks;
+	}
+	else if( xCurrentTask != SIZE_MAX )
+	{
+		pxTasks[ xCurrentTask ].ullRunTicks += ullTicks;
+	}
+	else
+	{
+		ullUnknownTicks += ullTicks;
+	}
+
+	ullChargedTime = ullTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchIn( size_t xTask, uint64_t ullTime )
+{
+Task_t *pxTask = &( pxTasks[ xTask ] );
+
+	if( xTask == xCurrentTask )
+	{
+		/* The scheduler chose the running task again.  If it had blocked it
+		was woken before it could switch out, so was never blocked. */
+		pxTask->xBlockPending = 0;
+		return;
+	}
+
+	prvEndRun( ullTime );
+
+	if( pxTask->xBlocked != 0 )
+	{
+		prvAddStat( &( pxTask->xBlockStats ), ullTime - pxTask->ullBlockStart );
+		prvAddRecord( decodeRECORD_BLOCKED, xTask, ( int ) xTask + 1, pxTask->ullBlockStart, ullTime );
+		pxRecords[ xNumRecords - 1 ].ullObject = pxTask->ullBlockObject;
+		pxTask->xBlocked = 0;
+	}
+
+	pxTask->xBlockPending = 0;
+	pxTask->ulSwitchIns++;
+	pxTask->ullRunStart = ullTime;
+	xCurrentTask = xTask;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEndRun( uint64_t ullTime )
+{
+Task_t *pxTask;
+
+	if( xCurrentTask == SIZE_MAX )
+	{
+		return;
+	}
+
+	pxTask = &( pxTasks[ xCurrentTask ] );
+	prvAddRecord( decodeRECORD_RUN, xCurrentTask, ( int ) xCurrentTask + 1, pxTask->ullRunStart, ullTime );
+
+	if( pxTask->xBlockPending != 0 )
+	{
+		pxTask->xBlockPending = 0;
+		pxTask->xBlocked = 1;
+		pxTask->ullBlockStart = ullTime;
+	}
+
+	xCurrentTask = SIZE_MAX;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddRecord( uint8_t ucKind, size_t xIndex, int xThread, uint64_t ullStart, uint64_t ullEnd )
+{
+Record_t *pxRecord;
+
+	pxRecords = prvGrow( pxRecords, &xRecordCapacity, xNumRecords, sizeof( Record_t ) );
+	pxRecord = &( pxRecords[ xNumRecords++ ] );
+	memset( pxRecord, 0, sizeof( *pxRecord ) );
+	pxRecord->ucKind = ucKind;
+	pxRecord->xSequence = xNumRecords;
+	pxRecord->xIndex = xIndex;
+	pxRecord->xThread = xThread;
+	pxRecord->ullStart = ullStart;
+	pxRecord->ullDuration = ullEnd - ullStart;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddStat( Stats_t *pxStats, uint64_t ullTicks )
+{
+unsigned uBucket = 0;
+
+	while( ( ( ullTicks >> uBucket ) != 0 ) && ( uBucket < ( decodeHISTOGRAM_BUCKETS - 1 ) ) )
+	{
+		uBucket++;
+	}
+
+	if( ( pxStats->ulCount == 0 ) || ( ullTicks < pxStats->ullMin ) )
+	{
+		pxStats->ullMin = ullTicks;
+	}
+	if( ullTicks > pxStats->ullMax )
+	{
+		pxStats->ullMax = ullTicks;
+	}
+
+	pxStats->ulCount++;
+	pxStats->ullTotal += ullTicks;
+	pxStats->ulHistogram[ uBucket ]++;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFindTask( uint64_t ullId )
+{
+size_t x;
+
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		if( pxTasks[ x ].ullId == ullId )
+		{
+			return x;
+		}
+	}
+
+	pxTasks = prvGrow( pxTasks, &xTaskCapacity, xNumTasks, sizeof( Task_t ) );
+	memset( &( pxTasks[ xNumTasks ] ), 0, sizeof( Task_t ) );
+	pxTasks[ xNumTasks ].ullId = ullId;
+	snprintf( pxTasks[ xNumTasks ].cName, decodeMAX_NAME_SIZE, "0x%0*llx", ( int ) uPointerSize * 2, ( unsigned long long ) ullId );
+
+	return xNumTasks++;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFindIrq( uint8_t ucType, uint16_t usId )
+{
+size_t x;
+
+	for( x = 0; x < xNumIrqs; x++ )
+	{
+		if( ( pxIrqs[ x ].ucType == ucType ) && ( pxIrqs[ x ].usId == usId ) )
+		{
+			return x;
+		}
+	}
+
+	pxIrqs = prvGrow( pxIrqs, &xIrqCapacity, xNumIrqs, sizeof( Irq_t ) );
+	memset( &( pxIrqs[ xNumIrqs ] ), 0, sizeof( Irq_t ) );
+	pxIrqs[ xNumIrqs ].ucType = ucType;
+	pxIrqs[ xNumIrqs ].usId = usId;
+
+	return xNumIrqs++;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvLatencyIrq( uint64_t ullSource )
+{
+	/* isrstats.c keeps the tick in place of PLIC source 0. */
+	if( ullSource == 0 )
+	{
+		return prvFindIrq( tracefmtCONTEXT_TICK_ISR, 0 );
+	}
+
+	return prvFindIrq( tracefmtCONTEXT_ISR, ( uint16_t ) ullSource );
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvIrqName( size_t xIrq )
+{
+static char cName[ 32 ];
+
+	if( pxIrqs[ xIrq ].ucType == tracefmtCONTEXT_TICK_ISR )
+	{
+		return "Tick ISR";
+	}
+
+	snprintf( cName, sizeof( cName ), "%s %u", ( pxIrqs[ xIrq ].ucType == tracefmtCONTEXT_ISR ) ? "ISR" : "Exception", ( unsigned ) pxIrqs[ xIrq ].usId );
+	return cName;
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvObjectName( uint64_t ullId )
+{
+static char cName[ 24 ];
+size_t x;
+
+	for( x = 0; x < xNumObjects; x++ )
+	{
+		if( pxObjects[ x ].ullId == ullId )
+		{
+			return pxObjects[ x ].cName;
+		}
+	}
+
+	/* Notification and priority events name a task. */
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		if( pxTasks[ x ].ullId == ullId )
+		{
+			return pxTasks[ x ].cName;
+		}
+	}
+
+	snprintf( cName, sizeof( cName ), "0x%0*llx", ( int ) uPointerSize * 2, ( unsigned long long ) ullId );
+	return cName;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetObjectName( uint64_t ullId, const char *pcName )
+{
+size_t x;
+
+	for( x = 0; x < xNumObjects; x++ )
+	{
+		if( pxObjects[ x ].ullId == ullId )
+		{
+			break;
+		}
+	}
+
+	if( x == xNumObjects )
+	{
+		pxObjects = prvGrow( pxObjects, &xObjectCapacity, xNumObjects, sizeof( Object_t ) );
+		pxObjects[ xNumObjects++ ].ullId = ullId;
+	}
+
+	strcpy( pxObjects[ x ].cName, pcName );
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvEventName( uint8_t ucId )
+{
+static const char * const pcNames[] =
+{
+	"TRACE_START", "TRACE_STOP", "START_INFO_FINISHED", "BUFFER_OVERFLOW",
+	"SYSTEM_DESC", "TASK_INFO", "IDLE_TASK_INFO", "OBJECT_NAME",
+	"CURRENT_CONTEXT", "EXCEPTION_ENTER", "EXCEPTION_EXIT", "ISR_ENTER",
+	"ISR_EXIT", "TICK_ISR_ENTER", "TICK_ISR_EXIT"
+};
+static const char * const pcRtosNames[] =
+{
+	"TASK_SWITCH_IN", "TASK_CREATE", "TASK_DELETE", "QUEUE_SEND",
+	"QUEUE_SEND_FROM_ISR", "QUEUE_RECV", "QUEUE_RECV_FROM_ISR", "QUEUE_PEEK",
+	"QUEUE_PEEK_FROM_ISR", "SEMAPHORE_TAKE", "SEMAPHORE_TAKE_FROM_ISR",
+	"SEMAPHORE_GIVE", "SEMAPHORE_GIVE_FROM_ISR", "HEAP_STATS", "HEAP_ALLOCATION",
+	"STREAM_BUFFER_CREATE", "STREAM_BUFFER_DELETE", "STREAM_BUFFER_RESET",
+	"STREAM_BUFFER_SEND", "STREAM_BUFFER_SEND_FROM_ISR", "STREAM_BUFFER_RECV",
+	"STREAM_BUFFER_RECV_FROM_ISR", "EVENT_GROUP_CREATE", "EVENT_GROUP_DELETE",
+	"EVENT_GROUP_SET_BITS", "EVENT_GROUP_SET_BITS_FROM_ISR",
+	"EVENT_GROUP_CLEAR_BITS", "EVENT_GROUP_CLEAR_BITS_FROM_ISR",
+	"EVENT_GROUP_WAIT_BITS", "EVENT_GROUP_SYNC", "TIMER_CREATE",
+	"TIMER_COMMAND_SEND", "TIMER_COMMAND_RECV", "TIMER_EXPIRED", "TASK_NOTIFY",
+	"TASK_NOTIFY_FROM_ISR", "TASK_NOTIFY_TAKE", "TASK_NOTIFY_WAIT",
+	"TASK_PRIORITY_INHERIT", "TASK_PRIORITY_DISINHERIT", "MALLOC", "FREE",
+	"ISR_LATENCY_MAX"
+};
+
+	if( ucId <= tracefmtEVT_TICK_ISR_EXIT )
+	{
+		return pcNames[ ucId ];
+	}
+	else if( ( ucId >= tracefmtEVT_TASK_SWITCH_IN ) && ( ucId <= tracefmtEVT_ISR_LATENCY_MAX ) )
+	{
+		return pcRtosNames[ ucId - tracefmtEVT_TASK_SWITCH_IN ];
+	}
+
+	return "UNKNOWN";
+}
+/*-----------------------------------------------------------*/
+
+static unsigned prvObjectFields( uint8_t ucId )
+{
+/* The fields of each kernel object event, as sent by tracer.c. */
+static const uint8_t ucFields[] =
+{
+	/* STREAM_BUFFER_CREATE, DELETE, RESET */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_TYPE,
+	tracefmtFIELD_OBJECT,
+	tracefmtFIELD_OBJECT,
+	/* STREAM_BUFFER_SEND, SEND_FROM_ISR, RECV, RECV_FROM_ISR */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	/* EVENT_GROUP_CREATE, DELETE */
+	tracefmtFIELD_OBJECT,
+	tracefmtFIELD_OBJECT,
+	/* EVENT_GROUP_SET_BITS, SET_BITS_FROM_ISR, CLEAR_BITS, CLEAR_BITS_FROM_ISR */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	/* EVENT_GROUP_WAIT_BITS, SYNC */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_VALUE | tracefmtFIELD_VALUE2,
+	/* TIMER_CREATE, COMMAND_SEND, COMMAND_RECV, EXPIRED */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT,
+	/* TASK_NOTIFY, NOTIFY_FROM_ISR, NOTIFY_TAKE, NOTIFY_WAIT */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE,
+	tracefmtFIELD_STATUS | tracefmtFIELD_VALUE,
+	tracefmtFIELD_STATUS | tracefmtFIELD_VALUE,
+	/* TASK_PRIORITY_INHERIT, DISINHERIT */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_PRIORITY,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_PRIORITY,
+	/* MALLOC, FREE */
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE,
+	/* ISR_LATENCY_MAX */
+	tracefmtFIELD_TYPE | tracefmtFIELD_VALUE | tracefmtFIELD_VALUE2
+};
+
+	if( ( ucId >= tracefmtEVT_STREAM_BUFFER_CREATE ) && ( ucId <= tracefmtEVT_ISR_LATENCY_MAX ) )
+	{
+		return ucFields[ ucId - tracefmtEVT_STREAM_BUFFER_CREATE ];
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvStatusName( uint8_t ucStatus )
+{
+	switch( ucStatus )
+	{
+		case tracefmtSTAT_SUCCESS:	return "success";
+		case tracefmtSTAT_FAIL:		return "fail";
+		case tracefmtSTAT_BLOCKING:	return "blocking";
+		default:					return "unknown";
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintEvent( const Event_t *pxEvent )
+{
+size_t xTask;
+
+	switch( pxEvent->ucId )
+	{
+		case tracefmtEVT_TRACE_START:
+		case tracefmtEVT_TRACE_STOP:
+		case tracefmtEVT_START_INFO_FINISHED:
+		case tracefmtEVT_HEAP_STATS:
+		case tracefmtEVT_HEAP_ALLOCATION:
+			/* Nothing to show after the name. */
+			printf( "  %12llu  %s\n", ( unsigned long long ) pxEvent->ullTime, prvEventName( pxEvent->ucId ) );
+			return;
+
+		default:
+			printf( "  %12llu  %-23s", ( unsigned long long ) pxEvent->ullTime, prvEventName( pxEvent->ucId ) );
+			break;
+	}
+
+	switch( pxEvent->ucId )
+	{
+		case tracefmtEVT_BUFFER_OVERFLOW:
+			printf( " lost %lu", ( unsigned long ) pxEvent->ulValue );
+			break;
+
+		case tracefmtEVT_SYSTEM_DESC:
+			printf( " cpu %lu Hz, %s", ( unsigned long ) pxEvent->ulValue, ( pxEvent->ucContext == tracefmtARCH_RV64 ) ? "rv64" : "rv32" );
+			break;
+
+		case tracefmtEVT_TASK_INFO:
+			printf( " %s priority %u", pxEvent->cName, ( unsigned ) pxEvent->usValue );
+			break;
+
+		case tracefmtEVT_OBJECT_NAME:
+			printf( " 0x%0*llx %s", ( int ) uPointerSize * 2, ( unsigned long long ) pxEvent->ullPtr, pxEvent->cName );
+			break;
+
+		case tracefmtEVT_CURRENT_CONTEXT:
+			printf( " irq level %u, context %u, ", ( unsigned ) pxEvent->ucLevel, ( unsigned ) pxEvent->ucContext );
+			if( pxEvent->ullPtr != 0 )
+			{
+				/* Looked up first, as a new task grows pxTasks. */
+				xTask = prvFindTask( pxEvent->ullPtr );
+				printf( "%s", pxTasks[ xTask ].cName );
+			}
+			else
+			{
+				printf( "none" );
+			}
+			break;
+
+		case tracefmtEVT_EXCEPTION_ENTER:
+		case tracefmtEVT_EXCEPTION_EXIT:
+		case tracefmtEVT_ISR_ENTER:
+		case tracefmtEVT_ISR_EXIT:
+		case tracefmtEVT_TICK_ISR_ENTER:
+		case tracefmtEVT_TICK_ISR_EXIT:
+			printf( " %u", ( unsigned ) pxEvent->usValue );
+			break;
+
+		case tracefmtEVT_IDLE_TASK_INFO:
+		case tracefmtEVT_TASK_SWITCH_IN:
+		case tracefmtEVT_TASK_CREATE:
+		case tracefmtEVT_TASK_DELETE:
+			xTask = prvFindTask( pxEvent->ullPtr );
+			printf( " %s", pxTasks[ xTask ].cName );
+			break;
+
+		default:
+			if( prvObjectFields( pxEvent->ucId ) != 0 )
+			{
+				prvPrintObjectEvent( pxEvent );
+				break;
+			}
+
+			printf( " %s %s", prvObjectName( pxEvent->ullPtr ), prvStatusName( pxEvent->ucStatus ) );
+			if( pxEvent->ucHasTicksToWait != 0 )
+			{
+				printf( ", wait %llu", ( unsigned long long ) pxEvent->ullTicksToWait );
+			}
+			if( pxEvent->ucHasWoken != 0 )
+			{
+				printf( ", woken %u", ( unsigned ) pxEvent->ucWoken );
+			}
+			break;
+	}
+
+	printf( "\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintObjectEvent( const Event_t *pxEvent )
+{
+const unsigned uFields = prvObjectFields( pxEvent->ucId );
+const unsigned long long ullValue = ( unsigned long long ) pxEvent->ullValue;
+
+	if( ( pxEvent->ucId == tracefmtEVT_MALLOC ) || ( pxEvent->ucId == tracefmtEVT_FREE ) )
+	{
+		printf( " 0x%0*llx size %llu", ( int ) uPointerSize * 2, ( unsigned long long ) pxEvent->ullPtr, ullValue );
+		return;
+	}
+
+	if( ( uFields & tracefmtFIELD_OBJECT ) != 0 )
+	{
+		printf( " %s", prvObjectName( pxEvent->ullPtr ) );
+	}
+	if( ( uFields & tracefmtFIELD_STATUS ) != 0 )
+	{
+		printf( " %s", prvStatusName( pxEvent->ucStatus ) );
+	}
+	if( ( uFields & tracefmtFIELD_PRIORITY ) != 0 )
+	{
+		printf( " priority %u", ( unsigned ) pxEvent->usValue );
+	}
+
+	switch( pxEvent->ucId )
+	{
+		case tracefmtEVT_STREAM_BUFFER_CREATE:
+			printf( " %s", ( pxEvent->ucType != 0 ) ? "message buffer" : "stream buffer" );
+			break;
+
+		case tracefmtEVT_STREAM_BUFFER_SEND:
+		case tracefmtEVT_STREAM_BUFFER_SEND_FROM_ISR:
+		case tracefmtEVT_STREAM_BUFFER_RECV:
+		case tracefmtEVT_STREAM_BUFFER_RECV_FROM_ISR:
+			printf( ", %s %llu bytes", ( pxEvent->ucType != 0 ) ? "message" : "stream", ullValue );
+			break;
+
+		case tracefmtEVT_EVENT_GROUP_SET_BITS:
+		case tracefmtEVT_EVENT_GROUP_SET_BITS_FROM_ISR:
+		case tracefmtEVT_EVENT_GROUP_CLEAR_BITS:
+		case tracefmtEVT_EVENT_GROUP_CLEAR_BITS_FROM_ISR:
+		case tracefmtEVT_EVENT_GROUP_WAIT_BITS:
+			printf( " bits 0x%llx", ullValue );
+			break;
+
+		case tracefmtEVT_EVENT_GROUP_SYNC:
+			printf( ", set 0x%llx, wait for 0x%llx", ullValue, ( unsigned long long ) pxEvent->ullValue2 );
+			break;
+
+		case tracefmtEVT_TIMER_CREATE:
+			printf( " period %llu", ullValue );
+			break;
+
+		case tracefmtEVT_TIMER_COMMAND_SEND:
+		case tracefmtEVT_TIMER_COMMAND_RECV:
+			printf( "%s command %d, value %llu", ( ( uFields & tracefmtFIELD_STATUS ) != 0 ) ? "," : "", ( int ) ( int8_t ) pxEvent->ucType, ullValue );
+			break;
+
+		case tracefmtEVT_TASK_NOTIFY:
+		case tracefmtEVT_TASK_NOTIFY_FROM_ISR:
+			printf( ", action %u, value 0x%llx", ( unsigned ) pxEvent->ucType, ullValue );
+			break;
+
+		case tracefmtEVT_TASK_NOTIFY_TAKE:
+		case tracefmtEVT_TASK_NOTIFY_WAIT:
+			printf( ", wait %llu", ullValue );
+			break;
+
+		case tracefmtEVT_ISR_LATENCY_MAX:
+			if( pxEvent->ullValue2 == 0 )
+			{
+				printf( " Tick ISR" );
+			}
+			else
+			{
+				printf( " ISR %llu", ( unsigned long long ) pxEvent->ullValue2 );
+			}
+			printf( " %s %llu cycles", prvMeasureName( pxEvent->ucType ), ullValue );
+			break;
+
+		default:
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvMeasureName( uint8_t ucMeasure )
+{
+	switch( ucMeasure )
+	{
+		case tracefmtISR_ENTRY:		return "entry latency";
+		case tracefmtISR_DURATION:	return "duration";
+		case tracefmtISR_WAKE:		return "wake latency";
+		default:					return "unknown";
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintShare( const char *pcName, uint64_t ullTicks, uint64_t ullDuration )
+{
+	printf( "  %-24s %12llu  %5.1f%%\n", pcName, ( unsigned long long ) ullTicks, ( ullDuration != 0 ) ? ( ( double ) ullTicks * 100.0 ) / ( double ) ullDuration : 0.0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintReport( void )
+{
+const uint64_t ullDuration = ullLastTime - ullFirstTime;
+size_t x;
+int xAny;
+
+	printf( "Decoded %lu events, %llu lost to buffer overflow\n", ( unsigned long ) ulNumEvents, ( unsigned long long ) ullLostEvents );
+	printf( "Pointer size %u bits, timebase %llu Hz\n", uPointerSize * 8, ( unsigned long long ) ullFrequency );
+	printf( "Duration %llu ticks", ( unsigned long long ) ullDuration );
+	if( ullFrequency != 0 )
+	{
+		printf( " (%.3f us)", ( ( double ) ullDuration * 1000000.0 ) / ( double ) ullFrequency );
+	}
+	printf( "\n\n" );
+
+	printf( "CPU share:                        ticks   share\n" );
+	for( x = 0; x < xNumTasks; x++ )
+	{
+	char cLabel[ decodeMAX_NAME_SIZE + 32 ];
+
+		if( pxTasks[ x ].xHasInfo != 0 )
+		{
+			snprintf( cLabel, sizeof( cLabel ), "%s (%u)%s", pxTasks[ x ].cName, ( unsigned ) pxTasks[ x ].usPriority, ( pxTasks[ x ].xDeleted != 0 ) ? " deleted" : "" );
+		}
+		else
+		{
+			snprintf( cLabel, sizeof( cLabel ), "%s%s", pxTasks[ x ].cName, ( pxTasks[ x ].xDeleted != 0 ) ? " deleted" : "" );
+		}
+		prvPrintShare( cLabel, pxTasks[ x ].ullRunTicks, ullDuration );
+	}
+	for( x = 0; x < xNumIrqs; x++ )
+	{
+		prvPrintShare( prvIrqName( x ), pxIrqs[ x ].ullSelfTicks, ullDuration );
+	}
+	if( ullUnknownTicks != 0 )
+	{
+		prvPrintShare( "(unknown)", ullUnknownTicks, ullDuration );
+	}
+
+	printf( "\nTasks:                     switch ins\n" );
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		printf( "  %-24s %10lu%s\n", pxTasks[ x ].cName, ( unsigned long ) pxTasks[ x ].ulSwitchIns, ( pxTasks[ x ].xIsIdle != 0 ) ? "  idle task" : "" );
+	}
+
+	printf( "\nInterrupts:                     count    max ticks\n" );
+	for( x = 0; x < xNumIrqs; x++ )
+	{
+		printf( "  %-24s %10lu %12llu\n", prvIrqName( x ), ( unsigned long ) pxIrqs[ x ].ulCount, ( unsigned long long ) pxIrqs[ x ].ullMaxTicks );
+	}
+
+	printf( "\nWakeup latency, interrupt to task switch in (ticks):\n" );
+	for( xAny = 0, x = 0; x < xNumTasks; x++ )
+	{
+		if( pxTasks[ x ].xWakeStats.ulCount != 0 )
+		{
+			prvPrintStats( pxTasks[ x ].cName, &( pxTasks[ x ].xWakeStats ) );
+			xAny = 1;
+		}
+	}
+	if( xAny == 0 )
+	{
+		printf( "  none\n" );
+	}
+
+	printf( "\nBlocking time, kernel object or notification (ticks):\n" );
+	for( xAny = 0, x = 0; x < xNumTasks; x++ )
+	{
+		if( pxTasks[ x ].xBlockStats.ulCount != 0 )
+		{
+			prvPrintStats( pxTasks[ x ].cName, &( pxTasks[ x ].xBlockStats ) );
+			xAny = 1;
+		}
+	}
+	if( xAny == 0 )
+	{
+		printf( "  none\n" );
+	}
+
+	if( ( ulMallocs + ulFailedMallocs + ulFrees ) != 0 )
+	{
+		printf( "\nHeap operations:\n" );
+		printf( "  mallocs %lu, failed %lu, frees %lu, peak bytes %llu\n", ( unsigned long ) ulMallocs, ( unsigned long ) ulFailedMallocs, ( unsigned long ) ulFrees, ( unsigned long long ) ullPeakHeapBytes );
+	}
+
+	for( xAny = 0, x = 0; x < xNumIrqs; x++ )
+	{
+		if( pxIrqs[ x ].xHasCycles != 0 )
+		{
+			if( xAny == 0 )
+			{
+				printf( "\nInterrupt latency maxima (cycles):  entry     duration         wake\n" );
+				xAny = 1;
+			}
+			printf( "  %-24s %14llu %12llu %12llu\n", prvIrqName( x ), ( unsigned long long ) pxIrqs[ x ].ullMaxCycles[ tracefmtISR_ENTRY ], ( unsigned long long ) pxIrqs[ x ].ullMaxCycles[ tracefmtISR_DURATION ], ( unsigned long long ) pxIrqs[ x ].ullMaxCycles[ tracefmtISR_WAKE ] );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintStats( const char *pcName, const Stats_t *pxStats )
+{
+uint32_t ulLargest = 0;
+unsigned uBucket, uBar;
+unsigned long long ullLow, ullHigh;
+
+	printf( "  %s: count %lu, min %llu, mean %llu, max %llu\n", pcName, ( unsigned long ) pxStats->ulCount, ( unsigned long long ) pxStats->ullMin, ( unsigned long long ) ( pxStats->ullTotal / pxStats->ulCount ), ( unsigned long long ) pxStats->ullMax );
+
+	for( uBucket = 0; uBucket < decodeHISTOGRAM_BUCKETS; uBucket++ )
+	{
+		if( pxStats->ulHistogram[ uBucket ] > ulLargest )
+		{
+			ulLargest = pxStats->ulHistogram[ uBucket ];
+		}
+	}
+
+	for( uBucket = 0; uBucket < decodeHISTOGRAM_BUCKETS; uBucket++ )
+	{
+		if( pxStats->ulHistogram[ uBucket ] == 0 )
+		{
+			continue;
+		}
+
+		ullLow = ( uBucket == 0 ) ? 0 : ( 1ULL << ( uBucket - 1 ) );
+		ullHigh = ( uBucket == 0 ) ? 0 : ( ( 1ULL << uBucket ) - 1 );
+
+		if( uBucket == ( decodeHISTOGRAM_BUCKETS - 1 ) )
+		{
+			printf( "    %10llu -            %6lu ", ullLow, ( unsigned long ) pxStats->ulHistogram[ uBucket ] );
+		}
+		else
+		{
+			printf( "    %10llu - %-10llu %6lu ", ullLow, ullHigh, ( unsigned long ) pxStats->ulHistogram[ uBucket ] );
+		}
+
+		for( uBar = 0; uBar < ( ( pxStats->ulHistogram[ uBucket ] * decodeHISTOGRAM_BAR_WIDTH ) + ulLargest - 1 ) / ulLargest; uBar++ )
+		{
+			putchar( '#' );
+		}
+		putchar( '\n' );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintTimeline( void )
+{
+size_t x, xRecord;
+const Record_t *pxRecord;
+
+	printf( "\nTimeline:  start     duration  (ticks)\n" );
+
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		printf( "  %s\n", pxTasks[ x ].cName );
+
+		for( xRecord = 0; xRecord < xNumRecords; xRecord++ )
+		{
+			pxRecord = &( pxRecords[ xRecord ] );
+			if( pxRecord->xThread != ( ( int ) x + 1 ) )
+			{
+				continue;
+			}
+
+			if( pxRecord->ucKind == decodeRECORD_RUN )
+			{
+				printf( "    %12llu %12llu  run\n", ( unsigned long long ) pxRecord->ullStart, ( unsigned long long ) pxRecord->ullDuration );
+			}
+			else if( pxRecord->ucKind == decodeRECORD_BLOCKED )
+			{
+				printf( "    %12llu %12llu  blocked on %s\n", ( unsigned long long ) pxRecord->ullStart, ( unsigned long long ) pxRecord->ullDuration, prvObjectName( pxRecord->ullObject ) );
+			}
+			else
+			{
+				printf( "    %12llu %12s  %s %s %s\n", ( unsigned long long ) pxRecord->ullStart, "", prvEventName( pxRecord->ucEvent ), prvObjectName( pxRecord->ullObject ), prvStatusName( pxRecord->ucStatus ) );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static double prvMicroseconds( uint64_t ullTicks )
+{
+	/* Without a timebase one tick is shown as one microsecond. */
+	if( ullFrequency == 0 )
+	{
+		return ( double ) ullTicks;
+	}
+
+	return ( ( double ) ullTicks * 1000000.0 ) / ( double ) ullFrequency;
+}
+/*-----------------------------------------------------------*/
+
+static int prvWriteJson( const char *pcFile )
+{
+FILE *pxFile;
+size_t x;
+const Record_t *pxRecord;
+
+	pxFile = fopen( pcFile, "w" );
+	if( pxFile == NULL )
+	{
+		perror( pcFile );
+		return -1;
+	}
+
+	fprintf( pxFile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+	fprintf( pxFile, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"FreeRTOS\"}},\n" );
+	fprintf( pxFile, "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"Interrupts\"}}", decodeIRQ_THREAD );
+
+	for( x = 0; x < xNumTasks; x++ )
+	{
+		fprintf( pxFile, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", ( int ) x + 1 );
+		prvPrintJsonString( pxFile, pxTasks[ x ].cName );
+		fprintf( pxFile, "}}" );
+	}
+
+	for( x = 0; x < xNumRecords; x++ )
+	{
+		pxRecord = &( pxRecords[ x ] );
+
+		if( pxRecord->ucKind == decodeRECORD_INSTANT )
+		{
+			fprintf( pxFile, ",\n{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":\"%s\",\"args\":{\"object\":", pxRecord->xThread, prvMicroseconds( pxRecord->ullStart ), prvEventName( pxRecord->ucEvent ) );
+			prvPrintJsonString( pxFile, prvObjectName( pxRecord->ullObject ) );
+			fprintf( pxFile, ",\"status\":\"%s\"}}", prvStatusName( pxRecord->ucStatus ) );
+			continue;
+		}
+
+		fprintf( pxFile, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":", pxRecord->xThread, prvMicroseconds( pxRecord->ullStart ), prvMicroseconds( pxRecord->ullDuration ) );
+
+		if( pxRecord->ucKind == decodeRECORD_RUN )
+		{
+			prvPrintJsonString( pxFile, pxTasks[ pxRecord->xIndex ].cName );
+			fprintf( pxFile, "}" );
+		}
+		else if( pxRecord->ucKind == decodeRECORD_BLOCKED )
+		{
+			fprintf( pxFile, "\"blocked\",\"args\":{\"object\":" );
+			prvPrintJsonString( pxFile, prvObjectName( pxRecord->ullObject ) );
+			fprintf( pxFile, "}}" );
+		}
+		else
+		{
+			prvPrintJsonString( pxFile, prvIrqName( pxRecord->xIndex ) );
+			fprintf( pxFile, "}" );
+		}
+	}
+
+	fprintf( pxFile, "\n]}\n" );
+
+	return ( fclose( pxFile ) == 0 ) ? 0 : -1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintJsonString( FILE *pxFile, const char *pcString )
+{
+	fputc( '"', pxFile );
+
+	for( ; *pcString != '\0'; pcString++ )
+	{
+		if( ( *pcString == '"' ) || ( *pcString == '\\' ) )
+		{
+			fprintf( pxFile, "\\%c", *pcString );
+		}
+		else if( ( unsigned char ) *pcString < 0x20 )
+		{
+			fprintf( pxFile, "\\u%04x", ( unsigned ) ( unsigned char ) *pcString );
+		}
+		else
+		{
+			fputc( *pcString, pxFile );
+		}
+	}
+
+	fputc( '"', pxFile );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareRecords( const void *pv1, const void *pv2 )
+{
+const Record_t *pxRecord1 = ( const Record_t * ) pv1, *pxRecord2 = ( const Record_t * ) pv2;
+
+	if( pxRecord1->ullStart != pxRecord2->ullStart )
+	{
+		return ( pxRecord1->ullStart > pxRecord2->ullStart ) ? 1 : -1;
+	}
+
+	return ( pxRecord1->xSequence > pxRecord2->xSequence ) - ( pxRecord1->xSequence < pxRecord2->xSequence );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvGrow( void *pvArray, size_t *pxCapacity, size_t xCount, size_t xItemSize )
+{
+void *pvNew;
+
+	if( ( pvArray != NULL ) && ( xCount < *pxCapacity ) )
+	{
+		return pvArray;
+	}
+
+	*pxCapacity = ( *pxCapacity == 0 ) ? 16 : ( *pxCapacity * 2 );
+	pvNew = realloc( pvArray, *pxCapacity * xItemSize );
+	if( pvNew == NULL )
+	{
+		fprintf( stderr, "tracedecode: out of memory\n" );
+		exit( 1 );
+	}
+
+	return pvNew;
+}
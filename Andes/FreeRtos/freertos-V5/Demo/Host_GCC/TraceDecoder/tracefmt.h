@@ -0,0 +1,198 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef TRACEFMT_H
+#define TRACEFMT_H
+
+/*-----------------------------------------------------------
+ * The event stream written by RTOSDemo_bsp/tracer/tracer.c into the log
+ * buffer managed by RTOSDemo_bsp/tracer/transfer.c.  These definitions are
+ * shared by the host decoder and the synthetic stream generator, and must be
+ * kept in step with the prvEVT_ID_ and prvOP_ macros in tracer.c.
+ *
+ * Each event is a one byte ID, followed by the fixed size fields listed below
+ * in target (little endian) byte order, followed by the number of mtime ticks
+ * since the previous event that was successfully written, encoded as an
+ * unsigned LEB128 number.  "ptr" fields are uintptr_t and "ulong" fields are
+ * unsigned long, so are 4 bytes on RV32 and 8 bytes on RV64.  Strings are NUL
+ * terminated.  TRACE_START always has a zero timestamp delta.
+ *
+ *   TRACE_START, TRACE_STOP, START_INFO_FINISHED		no fields
+ *   BUFFER_OVERFLOW		u32 events lost
+ *   SYSTEM_DESC			u8 length, u32 CPU Hz, u8 arch (0 RV32, 1 RV64)
+ *   TASK_INFO				u8 length, ptr task, u16 priority, str name
+ *   IDLE_TASK_INFO			ptr task
+ *   OBJECT_NAME			ptr object, str name
+ *   CURRENT_CONTEXT		u8 length, u8 IRQ level, u8 context type, ptr id
+ *   *_ENTER, *_EXIT		u16 IRQ number (trap events)
+ *   TASK_SWITCH_IN, TASK_CREATE, TASK_DELETE			ptr task
+ *   QUEUE_ (from task)		ptr queue, u8 status, ulong ticks to wait
+ *   QUEUE_ (from ISR)		ptr queue, u8 status, u8 higher priority task
+ *							woken (not sent by PEEK_FROM_ISR)
+ *   SEMAPHORE_ (task)		ptr queue, u8 status, u8 queue type, ulong ticks
+ *							to wait (not sent by GIVE)
+ *   SEMAPHORE_ (ISR)		ptr queue, u8 status, u8 queue type, u8 higher
+ *							priority task woken
+ *   HEAP_STATS, HEAP_ALLOCATION						u8 length, then data
+ *
+ * Where an event has a length field it counts itself and the fields that
+ * follow it, but not the ID or the timestamp delta.
+ *
+ * The kernel object events (configTRACER_KERNEL_OBJECT_EVENTS) have some of
+ * these fields, always in this order: ptr object, u8 status, u8 type, u16
+ * priority, ulong value, ulong value 2.
+ *
+ *   STREAM_BUFFER_CREATE	object, type (1 for a message buffer)
+ *   STREAM_BUFFER_DELETE, STREAM_BUFFER_RESET			object
+ *   STREAM_BUFFER_SEND, _RECV (and _FROM_ISR)			object, status, type,
+ *							value bytes sent or received
+ *   EVENT_GROUP_CREATE, EVENT_GROUP_DELETE				object
+ *   EVENT_GROUP_SET_BITS, _CLEAR_BITS (and _FROM_ISR)	object, value bits
+ *   EVENT_GROUP_WAIT_BITS	object, status, value bits to wait for
+ *   EVENT_GROUP_SYNC		object, status, value bits to set, value 2 bits
+ *							to wait for
+ *   TIMER_CREATE			object, value period (preceded by an OBJECT_NAME)
+ *   TIMER_COMMAND_SEND		object, status, type command, value
+ *   TIMER_COMMAND_RECV		object, type command, value
+ *   TIMER_EXPIRED			object
+ *   TASK_NOTIFY (and _FROM_ISR)	object task, status, type action, value
+ *   TASK_NOTIFY_TAKE, TASK_NOTIFY_WAIT	status, value ticks to wait (the
+ *							current task)
+ *   TASK_PRIORITY_INHERIT, _DISINHERIT	object task, priority
+ *   MALLOC, FREE			object address, value size (address 0 for a
+ *							failed MALLOC)
+ *   ISR_LATENCY_MAX		type measure (tracefmtISR_), value cycles, value 2
+ *							PLIC source (0 for the tick), see
+ *							RTOSDemo_bsp/isrstats/isrstats.h
+ *-----------------------------------------------------------*/
+
+/* System events. */
+#define tracefmtEVT_TRACE_START				( 0u )
+#define tracefmtEVT_TRACE_STOP				( 1u )
+#define tracefmtEVT_START_INFO_FINISHED		( 2u )
+#define tracefmtEVT_BUFFER_OVERFLOW			( 3u )
+#define tracefmtEVT_SYSTEM_DESC				( 4u )
+#define tracefmtEVT_TASK_INFO				( 5u )
+#define tracefmtEVT_IDLE_TASK_INFO			( 6u )
+#define tracefmtEVT_OBJECT_NAME				( 7u )
+#define tracefmtEVT_CURRENT_CONTEXT			( 8u )
+#define tracefmtEVT_EXCEPTION_ENTER			( 9u )
+#define tracefmtEVT_EXCEPTION_EXIT			( 10u )
+#define tracefmtEVT_ISR_ENTER				( 11u )
+#define tracefmtEVT_ISR_EXIT				( 12u )
+#define tracefmtEVT_TICK_ISR_ENTER			( 13u )
+#define tracefmtEVT_TICK_ISR_EXIT			( 14u )
+
+/* RTOS events. */
+#define tracefmtEVT_TASK_SWITCH_IN			( 32u )
+#define tracefmtEVT_TASK_CREATE				( 33u )
+#define tracefmtEVT_TASK_DELETE				( 34u )
+#define tracefmtEVT_QUEUE_SEND				( 35u )
+#define tracefmtEVT_QUEUE_SEND_FROM_ISR		( 36u )
+#define tracefmtEVT_QUEUE_RECV				( 37u )
+#define tracefmtEVT_QUEUE_RECV_FROM_ISR		( 38u )
+#define tracefmtEVT_QUEUE_PEEK				( 39u )
+#define tracefmtEVT_QUEUE_PEEK_FROM_ISR		( 40u )
+#define tracefmtEVT_SEMAPHORE_TAKE			( 41u )
+#define tracefmtEVT_SEMAPHORE_TAKE_FROM_ISR	( 42u )
+#define tracefmtEVT_SEMAPHORE_GIVE			( 43u )
+#define tracefmtEVT_SEMAPHORE_GIVE_FROM_ISR	( 44u )
+#define tracefmtEVT_HEAP_STATS				( 45u )
+#define tracefmtEVT_HEAP_ALLOCATION			( 46u )
+
+/* Kernel object events. */
+#define tracefmtEVT_STREAM_BUFFER_CREATE	( 47u )
+#define tracefmtEVT_STREAM_BUFFER_DELETE	( 48u )
+#define tracefmtEVT_STREAM_BUFFER_RESET		( 49u )
+#define tracefmtEVT_STREAM_BUFFER_SEND		( 50u )
+#define tracefmtEVT_STREAM_BUFFER_SEND_FROM_ISR	( 51u )
+#define tracefmtEVT_STREAM_BUFFER_RECV		( 52u )
+#define tracefmtEVT_STREAM_BUFFER_RECV_FROM_ISR	( 53u )
+#define tracefmtEVT_EVENT_GROUP_CREATE		( 54u )
+#define tracefmtEVT_EVENT_GROUP_DELETE		( 55u )
+#define tracefmtEVT_EVENT_GROUP_SET_BITS	( 56u )
+#define tracefmtEVT_EVENT_GROUP_SET_BITS_FROM_ISR	( 57u )
+#define tracefmtEVT_EVENT_GROUP_CLEAR_BITS	( 58u )
+#define tracefmtEVT_EVENT_GROUP_CLEAR_BITS_FROM_ISR	( 59u )
+#define tracefmtEVT_EVENT_GROUP_WAIT_BITS	( 60u )
+#define tracefmtEVT_EVENT_GROUP_SYNC		( 61u )
+#define tracefmtEVT_TIMER_CREATE			( 62u )
+#define tracefmtEVT_TIMER_COMMAND_SEND		( 63u )
+#define tracefmtEVT_TIMER_COMMAND_RECV		( 64u )
+#define tracefmtEVT_TIMER_EXPIRED			( 65u )
+#define tracefmtEVT_TASK_NOTIFY				( 66u )
+#define tracefmtEVT_TASK_NOTIFY_FROM_ISR	( 67u )
+#define tracefmtEVT_TASK_NOTIFY_TAKE		( 68u )
+#define tracefmtEVT_TASK_NOTIFY_WAIT		( 69u )
+#define tracefmtEVT_TASK_PRIORITY_INHERIT	( 70u )
+#define tracefmtEVT_TASK_PRIORITY_DISINHERIT	( 71u )
+#define tracefmtEVT_MALLOC					( 72u )
+#define tracefmtEVT_FREE					( 73u )
+#define tracefmtEVT_ISR_LATENCY_MAX			( 74u )
+
+/* Measures of the ISR_LATENCY_MAX event, see isrstatsMEASURE_ in isrstats.h. */
+#define tracefmtISR_ENTRY					( 0u )
+#define tracefmtISR_DURATION				( 1u )
+#define tracefmtISR_WAKE					( 2u )
+#define tracefmtISR_MEASURES				( 3u )
+
+/* Fields of the kernel object events, see prvFIELD_ in tracer.c. */
+#define tracefmtFIELD_OBJECT				( 0x01u )
+#define tracefmtFIELD_STATUS				( 0x02u )
+#define tracefmtFIELD_TYPE					( 0x04u )
+#define tracefmtFIELD_PRIORITY				( 0x08u )
+#define tracefmtFIELD_VALUE					( 0x10u )
+#define tracefmtFIELD_VALUE2				( 0x20u )
+
+/* CPU architecture in SYSTEM_DESC. */
+#define tracefmtARCH_RV32					( 0u )
+#define tracefmtARCH_RV64					( 1u )
+
+/* Context types in CURRENT_CONTEXT. */
+#define tracefmtCONTEXT_NONE				( 0u )
+#define tracefmtCONTEXT_TASK				( 1u )
+#define tracefmtCONTEXT_ISR					( 2u )
+#define tracefmtCONTEXT_TICK_ISR			( 3u )
+#define tracefmtCONTEXT_EXCEPTION			( 4u )
+#define tracefmtCONTEXT_IDLE				( 5u )
+#define tracefmtCONTEXT_KERNEL				( 6u )
+
+/* API status of queue and semaphore events, see tracerAPI_STAT_ in
+tracer.h. */
+#define tracefmtSTAT_SUCCESS				( 0u )
+#define tracefmtSTAT_FAIL					( 1u )
+#define tracefmtSTAT_BLOCKING				( 2u )
+
+/* Queue types of semaphore events, see queueQUEUE_TYPE_ in queue.h. */
+#define tracefmtQUEUE_TYPE_MUTEX				( 1u )
+#define tracefmtQUEUE_TYPE_COUNTING_SEMAPHORE	( 2u )
+#define tracefmtQUEUE_TYPE_BINARY_SEMAPHORE		( 3u )
+
+/* An unsigned 64-bit LEB128 number is at most 10 bytes. */
+#define tracefmtMAX_LEB128_SIZE				( 10 )
+
+#endif /* TRACEFMT_H */
@@ -0,0 +1,640 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Writes synthetic Andes RTOS tracer event streams for the golden file tests of
+ * tracedecode (see the Makefile in this directory, "make test").  Events are
+ * encoded the way RTOSDemo_bsp/tracer/tracer.c encodes them, for an RV32 or an
+ * RV64 target, at scripted mtime timestamps so every latency, blocking time
+ * and CPU share in the decoder report can be checked by hand.
+ *
+ * Usage: tracegen basic|rv32|objects|truncated|ring file
+ *
+ *   basic       RV64 target with an idle task and two application tasks, a
+ *               tick interrupt and a UART interrupt that wakes a task through a
+ *               semaphore and, nested in the tick interrupt, through a queue
+ *   rv32        RV32 target, with a lost event count, exceptions, an unnamed
+ *               task and a trace stop and restart
+ *   objects     RV64 target using stream and message buffers, an event group,
+ *               a software timer, task notifications, priority inheritance,
+ *               the heap and interrupt latency maxima, with a task blocked on
+ *               a stream buffer and on an event group
+ *   truncated   the basic stream with its last byte missing
+ *   ring        the basic stream written into a ring buffer so that it wraps,
+ *               the head and tail offsets to pass to tracedecode -r are
+ *               printed
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tracefmt.h"
+
+/* Size of the buffer an event stream is built in. */
+#define genMAX_STREAM_SIZE			( 4096 )
+
+/* Size of the ring buffer written by the ring scenario, and the tail offset,
+chosen so the basic stream wraps. */
+#define genRING_SIZE				( 1024 )
+#define genRING_TAIL				( 900 )
+
+/* Task, queue and semaphore handles. */
+#define genIDLE_TASK				( 0x80010000ULL )
+#define genRX_TASK					( 0x80010400ULL )
+#define genTX_TASK					( 0x80010800ULL )
+#define genUART_SEMAPHORE			( 0x80020000ULL )
+#define genDATA_QUEUE				( 0x80020100ULL )
+
+#define genRV32_IDLE_TASK			( 0x00001000ULL )
+#define genRV32_WORKER_TASK			( 0x00001100ULL )
+#define genRV32_LOST_TASK			( 0x00001200ULL )
+#define genRV32_SEMAPHORE			( 0x00002000ULL )
+#define genRV32_QUEUE				( 0x00002100ULL )
+
+#define genPRODUCER_TASK			( 0x80010c00ULL )
+#define genCONSUMER_TASK			( 0x80011000ULL )
+#define genTIMER_TASK				( 0x80011400ULL )
+#define genSTREAM_BUFFER			( 0x80020200ULL )
+#define genMESSAGE_BUFFER			( 0x80020300ULL )
+#define genEVENT_GROUP				( 0x80020400ULL )
+#define genTIMER					( 0x80020500ULL )
+#define genHEAP_BLOCK				( 0x80030000ULL )
+
+/* Interrupt numbers. */
+#define genUART_IRQ					( 7 )
+#define genGPIO_IRQ					( 3 )
+#define genECALL_EXCEPTION			( 11 )
+
+/* Number of fields in the HEAP_STATS event, see prvHeapStatsEvent() in
+tracer.c. */
+#define genHEAP_STATS_FIELDS		( ( 3 * 16 ) + 5 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Start an event at the given absolute time.  The timestamp delta is added by
+ * prvEnd().
+ */
+static void prvBegin( uint8_t ucId, uint64_t ullTime );
+static void prvEnd( void );
+
+/*
+ * Add fields in target byte order, as prvEventAddField() does in tracer.c.
+ */
+static void prvAdd( uint64_t ullValue, unsigned uSize );
+static void prvAddPtr( uint64_t ullValue );
+static void prvAddStr( const char *pcString );
+
+/*
+ * Helpers for the events used by the scenarios.
+ */
+static void prvTraceStart( uint64_t ullTime );
+static void prvSystemDesc( uint64_t ullTime, uint32_t ulHz, uint8_t ucArch );
+static void prvTaskInfo( uint64_t ullTime, uint64_t ullTask, uint16_t usPriority, const char *pcName );
+static void prvPtrEvent( uint8_t ucId, uint64_t ullTime, uint64_t ullPtr );
+static void prvObjectName( uint64_t ullTime, uint64_t ullObject, const char *pcName );
+static void prvCurrentContext( uint64_t ullTime, uint8_t ucContext, uint64_t ullId );
+static void prvTrap( uint8_t ucId, uint64_t ullTime, uint16_t usIrq );
+static void prvQueueOp( uint8_t ucId, uint64_t ullTime, uint64_t ullQueue, uint8_t ucStatus, uint64_t ullTicksToWait, uint8_t ucWoken );
+static void prvSemaphoreOp( uint8_t ucId, uint64_t ullTime, uint64_t ullSemaphore, uint8_t ucStatus, uint8_t ucType, uint64_t ullTicksToWait, uint8_t ucWoken );
+static void prvObjectOp( uint8_t ucId, uint64_t ullTime, unsigned uFields, uint64_t ullObject, uint8_t ucStatus, uint8_t ucType, uint16_t usPriority, uint64_t ullValue, uint64_t ullValue2 );
+static void prvNoFields( uint8_t ucId, uint64_t ullTime );
+
+static void prvBasicStream( void );
+static void prvRV32Stream( void );
+static void prvObjectsStream( void );
+static int prvWrite( const char *pcFile, const uint8_t *pucData, size_t xSize );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucStream[ genMAX_STREAM_SIZE ];
+static size_t xStreamSize = 0;
+
+/* Pointer size of the target, 4 or 8. */
+static unsigned uPointerSize = 8;
+
+/* Time of the previous event, and of the event being built. */
+static uint64_t ullLastTime = 0, ullEventTime = 0;
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+static uint8_t ucRing[ genRING_SIZE ];
+size_t xFirstPart;
+
+	if( argc != 3 )
+	{
+		fprintf( stderr, "usage: tracegen basic|rv32|objects|truncated|ring file\n" );
+		return 1;
+	}
+
+	if( strcmp( argv[ 1 ], "basic" ) == 0 )
+	{
+		prvBasicStream();
+		return prvWrite( argv[ 2 ], ucStream, xStreamSize );
+	}
+	else if( strcmp( argv[ 1 ], "rv32" ) == 0 )
+	{
+		prvRV32Stream();
+		return prvWrite( argv[ 2 ], ucStream, xStreamSize );
+	}
+	else if( strcmp( argv[ 1 ], "objects" ) == 0 )
+	{
+		prvObjectsStream();
+		return prvWrite( argv[ 2 ], ucStream, xStreamSize );
+	}
+	else if( strcmp( argv[ 1 ], "truncated" ) == 0 )
+	{
+		prvBasicStream();
+		return prvWrite( argv[ 2 ], ucStream, xStreamSize - 1 );
+	}
+	else if( strcmp( argv[ 1 ], "ring" ) == 0 )
+	{
+		prvBasicStream();
+
+		if( ( xStreamSize >= genRING_SIZE ) || ( xStreamSize <= ( genRING_SIZE - genRING_TAIL ) ) )
+		{
+			fprintf( stderr, "tracegen: the basic stream does not wrap in the ring\n" );
+			return 1;
+		}
+
+		/* The bytes outside the unread part of a ring are stale data. */
+		memset( ucRing, 0xa5, sizeof( ucRing ) );
+		xFirstPart = genRING_SIZE - genRING_TAIL;
+		memcpy( &( ucRing[ genRING_TAIL ] ), ucStream, xFirstPart );
+		memcpy( ucRing, &( ucStream[ xFirstPart ] ), xStreamSize - xFirstPart );
+		printf( "%lu,%lu\n", ( unsigned long ) ( xStreamSize - xFirstPart ), ( unsigned long ) genRING_TAIL );
+
+		return prvWrite( argv[ 2 ], ucRing, sizeof( ucRing ) );
+	}
+
+	fprintf( stderr, "tracegen: unknown scenario %s\n", argv[ 1 ] );
+	return 1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBasicStream( void )
+{
+uint32_t ulField;
+
+	uPointerSize = 8;
+
+	/* Start info, as sent by prvRtosTracerStart().  The idle task is running. */
+	prvTraceStart( 0 );
+	prvSystemDesc( 10, 60000000UL, tracefmtARCH_RV64 );
+	prvPtrEvent( tracefmtEVT_IDLE_TASK_INFO, 12, genIDLE_TASK );
+	prvTaskInfo( 14, genIDLE_TASK, 0, "IDLE" );
+	prvTaskInfo( 16, genRX_TASK, 3, "Rx" );
+	prvTaskInfo( 18, genTX_TASK, 2, "Tx" );
+	prvObjectName( 20, genUART_SEMAPHORE, "UartSem" );
+	prvObjectName( 22, genDATA_QUEUE, "DataQ" );
+	prvCurrentContext( 24, tracefmtCONTEXT_TASK, genIDLE_TASK );
+	prvNoFields( tracefmtEVT_START_INFO_FINISHED, 26 );
+
+	/* A tick unblocks Rx. */
+	prvTrap( tracefmtEVT_TICK_ISR_ENTER, 100, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 110, genRX_TASK );
+	prvTrap( tracefmtEVT_TICK_ISR_EXIT, 120, 0 );
+
+	/* Rx blocks on the empty queue, Tx runs and sends to it, which unblocks Rx
+	after 410 - 215 = 195 ticks. */
+	prvQueueOp( tracefmtEVT_QUEUE_RECV, 200, genDATA_QUEUE, tracefmtSTAT_BLOCKING, 100, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 215, genTX_TASK );
+	prvQueueOp( tracefmtEVT_QUEUE_SEND, 400, genDATA_QUEUE, tracefmtSTAT_SUCCESS, 0, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 410, genRX_TASK );
+	prvQueueOp( tracefmtEVT_QUEUE_RECV, 420, genDATA_QUEUE, tracefmtSTAT_SUCCESS, 100, 0 );
+
+	/* Rx blocks on the UART semaphore, Tx delays, so idle runs. */
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_TAKE, 500, genUART_SEMAPHORE, tracefmtSTAT_BLOCKING, tracefmtQUEUE_TYPE_BINARY_SEMAPHORE, 0xffffffffffffffffULL, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 510, genTX_TASK );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 700, genIDLE_TASK );
+
+	/* The UART interrupt gives the semaphore, Rx is switched in 10 ticks later
+	after being blocked for 1020 - 510 = 510 ticks. */
+	prvTrap( tracefmtEVT_ISR_ENTER, 1000, genUART_IRQ );
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_GIVE_FROM_ISR, 1010, genUART_SEMAPHORE, tracefmtSTAT_SUCCESS, tracefmtQUEUE_TYPE_BINARY_SEMAPHORE, 0, 1 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 1020, genRX_TASK );
+	prvTrap( tracefmtEVT_ISR_EXIT, 1030, genUART_IRQ );
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_TAKE, 1040, genUART_SEMAPHORE, tracefmtSTAT_SUCCESS, tracefmtQUEUE_TYPE_BINARY_SEMAPHORE, 0xffffffffffffffffULL, 0 );
+
+	/* A tick that does not switch task. */
+	prvTrap( tracefmtEVT_TICK_ISR_ENTER, 1100, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 1105, genRX_TASK );
+	prvTrap( tracefmtEVT_TICK_ISR_EXIT, 1110, 0 );
+
+	/* Rx blocks on the queue again.  The UART interrupt, nested in the tick
+	interrupt, sends to the queue and Rx is switched in 15 ticks later after
+	being blocked for 1330 - 1205 = 125 ticks. */
+	prvQueueOp( tracefmtEVT_QUEUE_RECV, 1200, genDATA_QUEUE, tracefmtSTAT_BLOCKING, 50, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 1205, genIDLE_TASK );
+	prvTrap( tracefmtEVT_TICK_ISR_ENTER, 1300, 0 );
+	prvTrap( tracefmtEVT_ISR_ENTER, 1305, genUART_IRQ );
+	prvQueueOp( tracefmtEVT_QUEUE_SEND_FROM_ISR, 1315, genDATA_QUEUE, tracefmtSTAT_SUCCESS, 0, 1 );
+	prvTrap( tracefmtEVT_ISR_EXIT, 1320, genUART_IRQ );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 1330, genRX_TASK );
+	prvTrap( tracefmtEVT_TICK_ISR_EXIT, 1340, 0 );
+	prvQueueOp( tracefmtEVT_QUEUE_RECV, 1350, genDATA_QUEUE, tracefmtSTAT_SUCCESS, 50, 0 );
+
+	/* Heap report, which the decoder skips using the length fields. */
+	prvBegin( tracefmtEVT_HEAP_STATS, 1360 );
+	prvAdd( 1 + ( genHEAP_STATS_FIELDS * 4 ), 1 );
+	for( ulField = 0; ulField < genHEAP_STATS_FIELDS; ulField++ )
+	{
+		prvAdd( ulField, 4 );
+	}
+	prvEnd();
+
+	prvBegin( tracefmtEVT_HEAP_ALLOCATION, 1370 );
+	prvAdd( 1 + ( 4 * uPointerSize ) + 4, 1 );
+	prvAddPtr( 0x80030000ULL );
+	prvAddPtr( 64 );
+	prvAddPtr( 0x80001234ULL );
+	prvAddPtr( genRX_TASK );
+	prvAdd( 42, 4 );
+	prvEnd();
+
+	prvPtrEvent( tracefmtEVT_TASK_DELETE, 1400, genTX_TASK );
+	prvNoFields( tracefmtEVT_TRACE_STOP, 1500 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRV32Stream( void )
+{
+	uPointerSize = 4;
+
+	/* Tracing starts while the kernel runs before the scheduler. */
+	prvTraceStart( 0 );
+	prvSystemDesc( 5, 25000000UL, tracefmtARCH_RV32 );
+	prvPtrEvent( tracefmtEVT_IDLE_TASK_INFO, 6, genRV32_IDLE_TASK );
+	prvTaskInfo( 7, genRV32_IDLE_TASK, 0, "IDLE" );
+	prvTaskInfo( 8, genRV32_WORKER_TASK, 1, "Worker \"A\"" );
+	prvCurrentContext( 9, tracefmtCONTEXT_KERNEL, 0 );
+	prvNoFields( tracefmtEVT_START_INFO_FINISHED, 10 );
+
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 20, genRV32_WORKER_TASK );
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_GIVE, 50, genRV32_SEMAPHORE, tracefmtSTAT_SUCCESS, tracefmtQUEUE_TYPE_COUNTING_SEMAPHORE, 0, 0 );
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_TAKE, 60, genRV32_SEMAPHORE, tracefmtSTAT_SUCCESS, tracefmtQUEUE_TYPE_COUNTING_SEMAPHORE, 0, 0 );
+	prvTrap( tracefmtEVT_EXCEPTION_ENTER, 70, genECALL_EXCEPTION );
+	prvTrap( tracefmtEVT_EXCEPTION_EXIT, 90, genECALL_EXCEPTION );
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_TAKE, 100, genRV32_SEMAPHORE, tracefmtSTAT_BLOCKING, tracefmtQUEUE_TYPE_COUNTING_SEMAPHORE, 1000, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 105, genRV32_IDLE_TASK );
+
+	/* Three events were lost, including the creation of a task, and the
+	timestamp delta needs four LEB128 bytes. */
+	prvBegin( tracefmtEVT_BUFFER_OVERFLOW, 5000105 );
+	prvAdd( 3, 4 );
+	prvEnd();
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 5000200, genRV32_LOST_TASK );
+	prvTrap( tracefmtEVT_ISR_ENTER, 5000300, genGPIO_IRQ );
+	prvQueueOp( tracefmtEVT_QUEUE_PEEK_FROM_ISR, 5000310, genRV32_QUEUE, tracefmtSTAT_FAIL, 0, 0 );
+	prvSemaphoreOp( tracefmtEVT_SEMAPHORE_TAKE_FROM_ISR, 5000320, genRV32_SEMAPHORE, tracefmtSTAT_SUCCESS, tracefmtQUEUE_TYPE_COUNTING_SEMAPHORE, 0, 0 );
+	prvTrap( tracefmtEVT_ISR_EXIT, 5000330, genGPIO_IRQ );
+
+	/* The host stops and restarts tracing.  Worker is not counted as blocked
+	across the stop. */
+	prvNoFields( tracefmtEVT_TRACE_STOP, 5000400 );
+	prvTraceStart( 5000400 );
+	prvSystemDesc( 5000401, 25000000UL, tracefmtARCH_RV32 );
+	prvCurrentContext( 5000402, tracefmtCONTEXT_TASK, genRV32_WORKER_TASK );
+	prvNoFields( tracefmtEVT_START_INFO_FINISHED, 5000403 );
+	prvQueueOp( tracefmtEVT_QUEUE_PEEK, 5000450, genRV32_QUEUE, tracefmtSTAT_FAIL, 0, 0 );
+	prvNoFields( tracefmtEVT_TRACE_STOP, 5000500 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvObjectsStream( void )
+{
+const unsigned uSend = tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE;
+const unsigned uBits = tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE;
+const unsigned uWait = tracefmtFIELD_OBJECT | tracefmtFIELD_STATUS | tracefmtFIELD_VALUE;
+const unsigned uTake = tracefmtFIELD_STATUS | tracefmtFIELD_VALUE;
+const unsigned uPriority = tracefmtFIELD_OBJECT | tracefmtFIELD_PRIORITY;
+const unsigned uMax = tracefmtFIELD_TYPE | tracefmtFIELD_VALUE | tracefmtFIELD_VALUE2;
+
+	uPointerSize = 8;
+
+	prvTraceStart( 0 );
+	prvSystemDesc( 10, 60000000UL, tracefmtARCH_RV64 );
+	prvPtrEvent( tracefmtEVT_IDLE_TASK_INFO, 12, genIDLE_TASK );
+	prvTaskInfo( 14, genIDLE_TASK, 0, "IDLE" );
+	prvTaskInfo( 16, genPRODUCER_TASK, 2, "Prod" );
+	prvTaskInfo( 18, genCONSUMER_TASK, 3, "Cons" );
+	prvTaskInfo( 20, genTIMER_TASK, 4, "Tmr Svc" );
+	prvObjectName( 22, genSTREAM_BUFFER, "Stream" );
+	prvObjectName( 24, genEVENT_GROUP, "Events" );
+	prvCurrentContext( 26, tracefmtCONTEXT_TASK, genCONSUMER_TASK );
+	prvNoFields( tracefmtEVT_START_INFO_FINISHED, 28 );
+
+	/* Cons creates the objects.  The message buffer is not named, the timer
+	is named by the OBJECT_NAME event sent with TIMER_CREATE, and the second
+	allocation fails. */
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_CREATE, 100, tracefmtFIELD_OBJECT | tracefmtFIELD_TYPE, genSTREAM_BUFFER, 0, 0, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_CREATE, 105, tracefmtFIELD_OBJECT | tracefmtFIELD_TYPE, genMESSAGE_BUFFER, 0, 1, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_CREATE, 110, tracefmtFIELD_OBJECT, genEVENT_GROUP, 0, 0, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_TIMER_CREATE, 115, tracefmtFIELD_OBJECT | tracefmtFIELD_VALUE, genTIMER, 0, 0, 0, 100, 0 );
+	prvObjectName( 116, genTIMER, "Tmr" );
+	prvObjectOp( tracefmtEVT_MALLOC, 120, uBits, genHEAP_BLOCK, 0, 0, 0, 128, 0 );
+	prvObjectOp( tracefmtEVT_MALLOC, 125, uBits, 0, 0, 0, 0, 4096, 0 );
+
+	/* Cons blocks on the empty stream buffer, which waits for a notification
+	inside the kernel.  Prod sends 16 bytes and notifies Cons, which is
+	switched in after being blocked for 310 - 210 = 100 ticks on Stream. */
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_RECV, 200, uSend, genSTREAM_BUFFER, tracefmtSTAT_BLOCKING, 0, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_TASK_NOTIFY_WAIT, 202, uTake, 0, tracefmtSTAT_BLOCKING, 0, 0, 0xffffffffffffffffULL, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 210, genPRODUCER_TASK );
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_SEND, 300, uSend, genSTREAM_BUFFER, tracefmtSTAT_SUCCESS, 0, 0, 16, 0 );
+	prvObjectOp( tracefmtEVT_TASK_NOTIFY, 302, uSend, genCONSUMER_TASK, tracefmtSTAT_SUCCESS, 0, 0, 0, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 310, genCONSUMER_TASK );
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_RECV, 320, uSend, genSTREAM_BUFFER, tracefmtSTAT_SUCCESS, 0, 0, 16, 0 );
+
+	/* Cons waits for two event bits, one set by Prod and one by the UART
+	interrupt, and is blocked for 520 - 405 = 115 ticks. */
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_WAIT_BITS, 400, uWait, genEVENT_GROUP, tracefmtSTAT_BLOCKING, 0, 0, 0x3, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 405, genPRODUCER_TASK );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_SET_BITS, 450, uBits, genEVENT_GROUP, 0, 0, 0, 0x1, 0 );
+	prvObjectOp( tracefmtEVT_TIMER_COMMAND_SEND, 460, uSend, genTIMER, tracefmtSTAT_SUCCESS, 1, 0, 460, 0 );
+	prvTrap( tracefmtEVT_ISR_ENTER, 500, genUART_IRQ );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_SET_BITS_FROM_ISR, 505, uBits, genEVENT_GROUP, 0, 0, 0, 0x2, 0 );
+	prvTrap( tracefmtEVT_ISR_EXIT, 510, genUART_IRQ );
+
+	/* The first UART interrupt sets the maxima of all three measures, which
+	are sent once it has been measured. */
+	prvObjectOp( tracefmtEVT_ISR_LATENCY_MAX, 511, uMax, 0, 0, tracefmtISR_ENTRY, 0, 45, genUART_IRQ );
+	prvObjectOp( tracefmtEVT_ISR_LATENCY_MAX, 512, uMax, 0, 0, tracefmtISR_DURATION, 0, 580, genUART_IRQ );
+	prvObjectOp( tracefmtEVT_ISR_LATENCY_MAX, 513, uMax, 0, 0, tracefmtISR_WAKE, 0, 1250, genUART_IRQ );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 520, genCONSUMER_TASK );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_WAIT_BITS, 525, uWait, genEVENT_GROUP, tracefmtSTAT_SUCCESS, 0, 0, 0x3, 0 );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_CLEAR_BITS, 530, uBits, genEVENT_GROUP, 0, 0, 0, 0x3, 0 );
+
+	/* Cons raises the priority of Prod, which holds a mutex, until Prod gives
+	it back. */
+	prvObjectOp( tracefmtEVT_TASK_PRIORITY_INHERIT, 600, uPriority, genPRODUCER_TASK, 0, 0, 3, 0, 0 );
+	prvObjectOp( tracefmtEVT_TASK_PRIORITY_DISINHERIT, 650, uPriority, genPRODUCER_TASK, 0, 0, 2, 0, 0 );
+
+	/* Interrupt side of the notification, event group and message buffer
+	APIs. */
+	prvTrap( tracefmtEVT_ISR_ENTER, 700, genUART_IRQ );
+	prvObjectOp( tracefmtEVT_TASK_NOTIFY_FROM_ISR, 705, uSend, genCONSUMER_TASK, tracefmtSTAT_SUCCESS, 2, 0, 1, 0 );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_CLEAR_BITS_FROM_ISR, 706, uBits, genEVENT_GROUP, 0, 0, 0, 0x8, 0 );
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_SEND_FROM_ISR, 707, uSend, genMESSAGE_BUFFER, tracefmtSTAT_SUCCESS, 1, 0, 8, 0 );
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_RECV_FROM_ISR, 708, uSend, genMESSAGE_BUFFER, tracefmtSTAT_SUCCESS, 1, 0, 8, 0 );
+	prvTrap( tracefmtEVT_ISR_EXIT, 710, genUART_IRQ );
+	prvObjectOp( tracefmtEVT_ISR_LATENCY_MAX, 711, uMax, 0, 0, tracefmtISR_DURATION, 0, 610, genUART_IRQ );
+	prvObjectOp( tracefmtEVT_TASK_NOTIFY_TAKE, 720, uTake, 0, tracefmtSTAT_SUCCESS, 0, 0, 10, 0 );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_SYNC, 730, uWait | tracefmtFIELD_VALUE2, genEVENT_GROUP, tracefmtSTAT_FAIL, 0, 0, 0x4, 0xc );
+
+	/* The timer service task starts the timer and it expires. */
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 800, genTIMER_TASK );
+	prvObjectOp( tracefmtEVT_TIMER_COMMAND_RECV, 805, tracefmtFIELD_OBJECT | tracefmtFIELD_TYPE | tracefmtFIELD_VALUE, genTIMER, 0, 1, 0, 460, 0 );
+	prvObjectOp( tracefmtEVT_TIMER_EXPIRED, 810, tracefmtFIELD_OBJECT, genTIMER, 0, 0, 0, 0, 0 );
+	prvPtrEvent( tracefmtEVT_TASK_SWITCH_IN, 820, genCONSUMER_TASK );
+
+	/* Cons tears everything down. */
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_RESET, 900, tracefmtFIELD_OBJECT, genSTREAM_BUFFER, 0, 0, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_STREAM_BUFFER_DELETE, 905, tracefmtFIELD_OBJECT, genMESSAGE_BUFFER, 0, 0, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_EVENT_GROUP_DELETE, 910, tracefmtFIELD_OBJECT, genEVENT_GROUP, 0, 0, 0, 0, 0 );
+	prvObjectOp( tracefmtEVT_FREE, 915, uBits, genHEAP_BLOCK, 0, 0, 0, 128, 0 );
+	prvNoFields( tracefmtEVT_TRACE_STOP, 1000 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBegin( uint8_t ucId, uint64_t ullTime )
+{
+	ullEventTime = ullTime;
+	prvAdd( ucId, 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEnd( void )
+{
+uint64_t ullDelta = ullEventTime - ullLastTime;
+
+	/* The same encoding as prvLEB128_ENCODE_U64() in tracer.c. */
+	while( ullDelta > 0x7f )
+	{
+		ucStream[ xStreamSize++ ] = ( uint8_t ) ( ( ullDelta & 0x7f ) | 0x80 );
+		ullDelta >>= 7;
+	}
+	ucStream[ xStreamSize++ ] = ( uint8_t ) ullDelta;
+
+	ullLastTime = ullEventTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAdd( uint64_t ullValue, unsigned uSize )
+{
+unsigned u;
+
+	for( u = 0; u < uSize; u++ )
+	{
+		ucStream[ xStreamSize++ ] = ( uint8_t ) ( ullValue >> ( 8 * u ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddPtr( uint64_t ullValue )
+{
+	prvAdd( ullValue, uPointerSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddStr( const char *pcString )
+{
+	memcpy( &( ucStream[ xStreamSize ] ), pcString, strlen( pcString ) + 1 );
+	xStreamSize += strlen( pcString ) + 1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTraceStart( uint64_t ullTime )
+{
+	/* TRACE_START always has a zero timestamp delta. */
+	ullLastTime = ullTime;
+	prvNoFields( tracefmtEVT_TRACE_START, ullTime );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSystemDesc( uint64_t ullTime, uint32_t ulHz, uint8_t ucArch )
+{
+	prvBegin( tracefmtEVT_SYSTEM_DESC, ullTime );
+	prvAdd( 1 + 4 + 1, 1 );
+	prvAdd( ulHz, 4 );
+	prvAdd( ucArch, 1 );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskInfo( uint64_t ullTime, uint64_t ullTask, uint16_t usPriority, const char *pcName )
+{
+	prvBegin( tracefmtEVT_TASK_INFO, ullTime );
+	prvAdd( 1 + uPointerSize + 2 + strlen( pcName ) + 1, 1 );
+	prvAddPtr( ullTask );
+	prvAdd( usPriority, 2 );
+	prvAddStr( pcName );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvPtrEvent( uint8_t ucId, uint64_t ullTime, uint64_t ullPtr )
+{
+	prvBegin( ucId, ullTime );
+	prvAddPtr( ullPtr );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvObjectName( uint64_t ullTime, uint64_t ullObject, const char *pcName )
+{
+	prvBegin( tracefmtEVT_OBJECT_NAME, ullTime );
+	prvAddPtr( ullObject );
+	prvAddStr( pcName );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCurrentContext( uint64_t ullTime, uint8_t ucContext, uint64_t ullId )
+{
+	prvBegin( tracefmtEVT_CURRENT_CONTEXT, ullTime );
+	prvAdd( 1 + 1 + 1 + uPointerSize, 1 );
+	prvAdd( 0, 1 );
+	prvAdd( ucContext, 1 );
+	prvAddPtr( ullId );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTrap( uint8_t ucId, uint64_t ullTime, uint16_t usIrq )
+{
+	prvBegin( ucId, ullTime );
+	prvAdd( usIrq, 2 );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueOp( uint8_t ucId, uint64_t ullTime, uint64_t ullQueue, uint8_t ucStatus, uint64_t ullTicksToWait, uint8_t ucWoken )
+{
+	prvBegin( ucId, ullTime );
+	prvAddPtr( ullQueue );
+	prvAdd( ucStatus, 1 );
+
+	/* As prvCreateEventQueueOp() in tracer.c. */
+	if( ( ucId == tracefmtEVT_QUEUE_SEND ) || ( ucId == tracefmtEVT_QUEUE_RECV ) || ( ucId == tracefmtEVT_QUEUE_PEEK ) )
+	{
+		prvAddPtr( ullTicksToWait );
+	}
+	else if( ucId != tracefmtEVT_QUEUE_PEEK_FROM_ISR )
+	{
+		prvAdd( ucWoken, 1 );
+	}
+
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSemaphoreOp( uint8_t ucId, uint64_t ullTime, uint64_t ullSemaphore, uint8_t ucStatus, uint8_t ucType, uint64_t ullTicksToWait, uint8_t ucWoken )
+{
+	prvBegin( ucId, ullTime );
+	prvAddPtr( ullSemaphore );
+	prvAdd( ucStatus, 1 );
+	prvAdd( ucType, 1 );
+
+	/* As prvCreateEventQueueOp() in tracer.c. */
+	if( ucId == tracefmtEVT_SEMAPHORE_TAKE )
+	{
+		prvAddPtr( ullTicksToWait );
+	}
+	else if( ucId != tracefmtEVT_SEMAPHORE_GIVE )
+	{
+		prvAdd( ucWoken, 1 );
+	}
+
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvObjectOp( uint8_t ucId, uint64_t ullTime, unsigned uFields, uint64_t ullObject, uint8_t ucStatus, uint8_t ucType, uint16_t usPriority, uint64_t ullValue, uint64_t ullValue2 )
+{
+	prvBegin( ucId, ullTime );
+
+	/* As prvCreateEventObjectOp() in tracer.c. */
+	if( ( uFields & tracefmtFIELD_OBJECT ) != 0 )
+	{
+		prvAddPtr( ullObject );
+	}
+	if( ( uFields & tracefmtFIELD_STATUS ) != 0 )
+	{
+		prvAdd( ucStatus, 1 );
+	}
+	if( ( uFields & tracefmtFIELD_TYPE ) != 0 )
+	{
+		prvAdd( ucType, 1 );
+	}
+	if( ( uFields & tracefmtFIELD_PRIORITY ) != 0 )
+	{
+		prvAdd( usPriority, 2 );
+	}
+	if( ( uFields & tracefmtFIELD_VALUE ) != 0 )
+	{
+		prvAddPtr( ullValue );
+	}
+	if( ( uFields & tracefmtFIELD_VALUE2 ) != 0 )
+	{
+		prvAddPtr( ullValue2 );
+	}
+
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvNoFields( uint8_t ucId, uint64_t ullTime )
+{
+	prvBegin( ucId, ullTime );
+	prvEnd();
+}
+/*-----------------------------------------------------------*/
+
+static int prvWrite( const char *pcFile, const uint8_t *pucData, size_t xSize )
+{
+FILE *pxFile;
+
+	pxFile = fopen( pcFile, "wb" );
+	if( pxFile == NULL )
+	{
+		perror( pcFile );
+		return 1;
+	}
+
+	if( ( fwrite( pucData, 1, xSize, pxFile ) != xSize ) || ( fclose( pxFile ) != 0 ) )
+	{
+		perror( pcFile );
+		return 1;
+	}
+
+	return 0;
+}
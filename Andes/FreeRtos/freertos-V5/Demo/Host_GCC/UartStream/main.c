@@ -0,0 +1,197 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host benchmark of the interrupt driven UART driver in
+ * Demo/V5/RTOSDemo_bsp/uartstream.
+ *
+ * The kernel, the driver, its loopback benchmark and uart.c are built as a
+ * native host program, with uartmodel.c standing in for the UART and the
+ * port layer in this directory (see the Makefile, "make test" builds and runs
+ * the benchmark).  xPortStartScheduler() below runs xUartBenchLoopback() on
+ * UART1 at each receive FIFO trigger level, and with each interrupt latency in
+ * character times.  The model advances a character time each time the
+ * benchmark waits.
+ *
+ * Each run must move every byte without error, overrun or drop, leave the
+ * transmit interrupt disabled, and take no more interrupts than the trigger
+ * level and the transmit FIFO depth allow.  The table printed shows how close
+ * each run comes to the line rate, and how many bytes each interrupt moves.
+ * With latency the line rate falls whenever the transmit FIFO runs empty
+ * before the interrupt refills it, so the best trigger level depends on the
+ * latency as much as on the FIFO depth.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "uartstream.h"
+
+/* Bytes sent and received back by each run. */
+#define testBENCH_BYTES				( 4096UL )
+
+/* Size of each stream buffer. */
+#define testBUFFER_SIZE				( 256 )
+
+/* Depth of the model's FIFOs. */
+#define testFIFO_DEPTH				( 16UL )
+
+/* Report the line of the first check that fails, and exit. */
+#define testCHECK( x )		prvCheck( ( x ), #x, __LINE__ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Run the benchmark at each trigger level with an interrupt latency of
+ * ulLatency character times.
+ */
+static void prvBenchLatency( uint32_t ulLatency );
+
+/*
+ * The benchmark's wait function, which advances the model by a character
+ * time.
+ */
+static void prvWait( void );
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine );
+static void prvTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t xTestsRun = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	testCHECK( xTaskCreate( prvTask, "Bench", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL ) == pdPASS );
+
+	/* Runs the benchmark, then returns. */
+	vTaskStartScheduler();
+
+	testCHECK( xTestsRun != pdFALSE );
+	printf( "UART stream benchmark passed\n" );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchLatency( uint32_t ulLatency )
+{
+static const uint32_t ulTriggers[] = { UARTC_FCR_RFIFO16_TRGL1, UARTC_FCR_RFIFO16_TRGL4, UARTC_FCR_RFIFO16_TRGL8, UARTC_FCR_RFIFO16_TRGL14 };
+static const uint32_t ulTriggerLevels[] = { 1, 4, 8, 14 };
+UartBenchResult_t xResult;
+UBaseType_t x;
+
+	vUartModelSetLatency( ulLatency );
+
+	for( x = 0; x < ( sizeof( ulTriggers ) / sizeof( ulTriggers[ 0 ] ) ); x++ )
+	{
+		/* The trigger level can be changed at any time, leaving the FIFOs
+		enabled and not reset. */
+		uartstreamWRITE( DEV_UART1, FCR, UARTC_FCR_FIFO_EN | ulTriggers[ x ] );
+
+		testCHECK( xUartBenchLoopback( uartstreamUART1, testBENCH_BYTES, prvWait, &xResult ) == pdPASS );
+		testCHECK( xResult.ulBytes == testBENCH_BYTES );
+		testCHECK( xResult.ulErrors == 0UL );
+		testCHECK( xResult.xStats.ulRxBytes == testBENCH_BYTES );
+		testCHECK( xResult.xStats.ulTxBytes == testBENCH_BYTES );
+		testCHECK( xResult.xStats.ulRxOverruns == 0UL );
+		testCHECK( xResult.xStats.ulRxDropped == 0UL );
+		testCHECK( xResult.xStats.ulLineErrors == 0UL );
+		testCHECK( ( ulUartModelGetIer( DEV_UART1 ) & UARTC_IER_THRE ) == 0UL );
+
+		/* Each interrupt other than the timeout that ends the run either
+		reaches the trigger level or refills the whole transmit FIFO. */
+		testCHECK( xResult.xStats.ulInterrupts <= ( ( testBENCH_BYTES / ulTriggerLevels[ x ] ) + ( testBENCH_BYTES / testFIFO_DEPTH ) + 1UL ) );
+
+		printf( "%7lu %7lu %10lu %5lu.%lu%% %10lu %9lu.%lu\n",
+				( unsigned long ) ulLatency,
+				( unsigned long ) ulTriggerLevels[ x ],
+				( unsigned long ) xResult.ulCycles,
+				( unsigned long ) ( ( xResult.ulBytes * 100UL ) / xResult.ulCycles ),
+				( unsigned long ) ( ( ( xResult.ulBytes * 1000UL ) / xResult.ulCycles ) % 10UL ),
+				( unsigned long ) xResult.xStats.ulInterrupts,
+				( unsigned long ) ( xResult.ulBytes / xResult.xStats.ulInterrupts ),
+				( unsigned long ) ( ( ( xResult.ulBytes * 10UL ) / xResult.xStats.ulInterrupts ) % 10UL ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWait( void )
+{
+	vUartModelStep();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheck( int iResult, const char *pcExpression, int iLine )
+{
+	if( iResult == 0 )
+	{
+		printf( "main.c:%d: check failed: %s\n", iLine, pcExpression );
+		exit( 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTask( void *pvParameters )
+{
+	/* The task never runs, the benchmark runs in its place. */
+	( void ) pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+/* Port layer functions, see portmacro.h. */
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	( void ) pxCode;
+	( void ) pvParameters;
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+	testCHECK( xUartStreamInit( uartstreamUART1, 115200UL, testBUFFER_SIZE, testBUFFER_SIZE ) == pdPASS );
+
+	printf( "latency trigger char times  line rate interrupts bytes/int\n" );
+	prvBenchLatency( 0UL );
+	prvBenchLatency( 2UL );
+	prvBenchLatency( 4UL );
+	xTestsRun = pdTRUE;
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+}
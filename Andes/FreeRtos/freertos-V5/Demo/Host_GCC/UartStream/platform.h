@@ -0,0 +1,94 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+/*-----------------------------------------------------------
+ * Host stand in for the AE250 platform.h, used to build uartstream.c,
+ * uartbench.c and uart.c against the UART model in uartmodel.c.  DEV_UART1
+ * and DEV_UART2 point to ordinary memory, which absorbs the accesses made
+ * directly by uart.c, while the accesses made through uartstreamREAD() and
+ * uartstreamWRITE() (see FreeRTOSConfig.h) are passed to the model.
+ *-----------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define __I		volatile const
+#define __O		volatile
+#define __IO	volatile
+
+typedef struct {
+	__I  unsigned int IDREV;                /* 0x00 ID and Revision Register */
+	     unsigned int RESERVED0[3];         /* 0x04 ~ 0x0C Reserved */
+	__I  unsigned int CFG;                  /* 0x10 Hardware Configure Register */
+	__IO unsigned int OSCR;                 /* 0x14 Over Sample Control Register */
+	     unsigned int RESERVED1[2];         /* 0x18 ~ 0x1C Reserved */
+	union {
+		__IO unsigned int RBR;          /* 0x20 Receiver Buffer Register */
+		__O  unsigned int THR;          /* 0x20 Transmitter Holding Register */
+		__IO unsigned int DLL;          /* 0x20 Divisor Latch LSB */
+	};
+	union {
+		__IO unsigned int IER;          /* 0x24 Interrupt Enable Register */
+		__IO unsigned int DLM;          /* 0x24 Divisor Latch MSB */
+	};
+	union {
+		__IO unsigned int IIR;          /* 0x28 Interrupt Identification Register */
+		__O  unsigned int FCR;          /* 0x28 FIFO Control Register */
+	};
+	__IO unsigned int LCR;                  /* 0x2C Line Control Register */
+	__IO unsigned int MCR;                  /* 0x30 Modem Control Register */
+	__IO unsigned int LSR;                  /* 0x34 Line Status Register */
+	__IO unsigned int MSR;                  /* 0x38 Modem Status Register */
+	__IO unsigned int SCR;                  /* 0x3C Scratch Register */
+} UART_RegDef;
+
+extern UART_RegDef xUartModelRegisters[ 2 ];
+
+#define DEV_UART1			( &( xUartModelRegisters[ 0 ] ) )
+#define DEV_UART2			( &( xUartModelRegisters[ 1 ] ) )
+#define IRQ_UART1_SOURCE	8
+#define IRQ_UART2_SOURCE	9
+#define UCLKFREQ			( 20000000UL )
+
+/* There is no PLIC, the model calls the UART interrupt handlers itself. */
+#define __nds__plic_set_priority( ulSource, ulPriority )	( ( void ) ( ulSource ), ( void ) ( ulPriority ) )
+#define __nds__plic_enable_interrupt( ulSource )			( ( void ) ( ulSource ) )
+
+/* Public API of uartmodel.c */
+uint32_t ulUartModelRead( const volatile void *pvUart, size_t xOffset );
+void vUartModelWrite( volatile void *pvUart, size_t xOffset, uint32_t ulValue );
+void vUartModelStep( void );
+void vUartModelSetLatency( uint32_t ulCharTimes );
+uint32_t ulUartModelGetIer( const volatile void *pvUart );
+
+/* Character times since the model started. */
+extern volatile uint32_t ulUartModelTime;
+
+#endif /* PLATFORM_H */
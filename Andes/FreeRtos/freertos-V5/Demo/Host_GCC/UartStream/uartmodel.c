@@ -0,0 +1,322 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Model of the two AE250 UARTs, for the host UART benchmark.
+ *
+ * Time advances a character time at a time in vUartModelStep().  In each step
+ * the transmitter of each UART sends the oldest byte of its transmit FIFO,
+ * which in loopback mode arrives in its own receive FIFO, or sets the overrun
+ * error if the receive FIFO is full.  Interrupts are identified as the 16550
+ * compatible UART does:
+ *
+ * + Receive line status, while an overrun has not been read from LSR.
+ * + Receive data available, while the receive FIFO holds at least the FCR
+ *   trigger level.
+ * + Character timeout, while the receive FIFO holds fewer bytes but has been
+ *   neither written nor read for four character times.
+ * + Transmit holding register empty, raised when the transmit FIFO empties or
+ *   the interrupt is enabled with it empty, and cleared by writing THR or by
+ *   reading IIR while it is the interrupt identified.
+ *
+ * A pending interrupt calls the UART's handler once it has been pending for
+ * the latency set by vUartModelSetLatency(), standing in for the time a
+ * target takes to enter the handler.
+ */
+
+#include "FreeRTOS.h"
+#include "uartstream.h"
+
+#define modelFIFO_DEPTH				( 16 )
+
+/* Character times without receive FIFO activity that raise a timeout. */
+#define modelTIMEOUT_CHAR_TIMES		( 4 )
+
+/*-----------------------------------------------------------*/
+
+typedef struct UartModel
+{
+	uint8_t ucRxFifo[ modelFIFO_DEPTH ];
+	uint32_t ulRxHead;
+	uint32_t ulRxCount;
+	uint8_t ucTxFifo[ modelFIFO_DEPTH ];
+	uint32_t ulTxHead;
+	uint32_t ulTxCount;
+	uint32_t ulIer;
+	uint32_t ulFcr;
+	uint32_t ulLcr;
+	uint32_t ulMcr;
+	uint32_t ulLsrErrors;
+	uint32_t ulRxIdle;
+	BaseType_t xThrePending;
+	uint32_t ulPendingTime;
+} UartModel_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the index of the UART whose registers are at pvUart.
+ */
+static UBaseType_t prvIndex( const volatile void *pvUart );
+
+/*
+ * Returns the IIR interrupt identification of the highest priority
+ * interrupt pending, clearing a transmit holding register empty interrupt if
+ * xRead is pdTRUE and it is the one identified.
+ */
+static uint32_t prvIdentify( UartModel_t *pxModel, BaseType_t xRead );
+
+/*-----------------------------------------------------------*/
+
+UART_RegDef xUartModelRegisters[ 2 ];
+volatile uint32_t ulUartModelTime = 0UL;
+
+static UartModel_t xModels[ 2 ];
+static uint32_t ulLatency = 0UL;
+
+/*-----------------------------------------------------------*/
+
+uint32_t ulUartModelRead( const volatile void *pvUart, size_t xOffset )
+{
+UartModel_t * const pxModel = &( xModels[ prvIndex( pvUart ) ] );
+uint32_t ulValue = 0UL;
+
+	switch( xOffset )
+	{
+		case offsetof( UART_RegDef, RBR ):
+			if( pxModel->ulRxCount > 0 )
+			{
+				ulValue = pxModel->ucRxFifo[ pxModel->ulRxHead ];
+				pxModel->ulRxHead = ( pxModel->ulRxHead + 1 ) % modelFIFO_DEPTH;
+				pxModel->ulRxCount--;
+			}
+			pxModel->ulRxIdle = 0;
+			break;
+
+		case offsetof( UART_RegDef, IER ):
+			ulValue = pxModel->ulIer;
+			break;
+
+		case offsetof( UART_RegDef, IIR ):
+			ulValue = prvIdentify( pxModel, pdTRUE ) | UARTC_IIR_FIFO_EN;
+			break;
+
+		case offsetof( UART_RegDef, LCR ):
+			ulValue = pxModel->ulLcr;
+			break;
+
+		case offsetof( UART_RegDef, MCR ):
+			ulValue = pxModel->ulMcr;
+			break;
+
+		case offsetof( UART_RegDef, LSR ):
+			ulValue = pxModel->ulLsrErrors;
+			pxModel->ulLsrErrors = 0;
+			if( pxModel->ulRxCount > 0 )
+			{
+				ulValue |= UARTC_LSR_RDR;
+			}
+			if( pxModel->ulTxCount == 0 )
+			{
+				ulValue |= UARTC_LSR_THRE | UARTC_LSR_TEMT;
+			}
+			break;
+
+		default:
+			/* CFG reads as 0, a 16 byte FIFO, and there is no modem. */
+			break;
+	}
+
+	return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+void vUartModelWrite( volatile void *pvUart, size_t xOffset, uint32_t ulValue )
+{
+UartModel_t * const pxModel = &( xModels[ prvIndex( pvUart ) ] );
+
+	switch( xOffset )
+	{
+		case offsetof( UART_RegDef, THR ):
+			if( pxModel->ulTxCount < modelFIFO_DEPTH )
+			{
+				pxModel->ucTxFifo[ ( pxModel->ulTxHead + pxModel->ulTxCount ) % modelFIFO_DEPTH ] = ( uint8_t ) ulValue;
+				pxModel->ulTxCount++;
+			}
+			pxModel->xThrePending = pdFALSE;
+			break;
+
+		case offsetof( UART_RegDef, IER ):
+			if( ( ( ulValue & ~pxModel->ulIer & UARTC_IER_THRE ) != 0 ) && ( pxModel->ulTxCount == 0 ) )
+			{
+				pxModel->xThrePending = pdTRUE;
+			}
+			pxModel->ulIer = ulValue;
+			break;
+
+		case offsetof( UART_RegDef, FCR ):
+			if( ( ulValue & UARTC_FCR_RFIFO_RESET ) != 0 )
+			{
+				pxModel->ulRxCount = 0;
+			}
+			if( ( ulValue & UARTC_FCR_TFIFO_RESET ) != 0 )
+			{
+				pxModel->ulTxCount = 0;
+			}
+			pxModel->ulFcr = ulValue;
+			break;
+
+		case offsetof( UART_RegDef, LCR ):
+			pxModel->ulLcr = ulValue;
+			break;
+
+		case offsetof( UART_RegDef, MCR ):
+			pxModel->ulMcr = ulValue;
+			break;
+
+		default:
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vUartModelStep( void )
+{
+UartModel_t *pxModel;
+UBaseType_t uxUart;
+
+	ulUartModelTime++;
+
+	for( uxUart = 0; uxUart < 2; uxUart++ )
+	{
+		pxModel = &( xModels[ uxUart ] );
+
+		pxModel->ulRxIdle++;
+
+		if( pxModel->ulTxCount > 0 )
+		{
+			if( ( pxModel->ulMcr & UARTC_MCR_LPBK ) != 0 )
+			{
+				if( pxModel->ulRxCount == modelFIFO_DEPTH )
+				{
+					pxModel->ulLsrErrors |= UARTC_LSR_OE;
+				}
+				else
+				{
+					pxModel->ucRxFifo[ ( pxModel->ulRxHead + pxModel->ulRxCount ) % modelFIFO_DEPTH ] = pxModel->ucTxFifo[ pxModel->ulTxHead ];
+					pxModel->ulRxCount++;
+				}
+				pxModel->ulRxIdle = 0;
+			}
+
+			pxModel->ulTxHead = ( pxModel->ulTxHead + 1 ) % modelFIFO_DEPTH;
+			pxModel->ulTxCount--;
+			if( pxModel->ulTxCount == 0 )
+			{
+				pxModel->xThrePending = pdTRUE;
+			}
+		}
+
+		if( prvIdentify( pxModel, pdFALSE ) == UARTC_IIR_NONE )
+		{
+			pxModel->ulPendingTime = 0;
+		}
+		else if( pxModel->ulPendingTime < ulLatency )
+		{
+			pxModel->ulPendingTime++;
+		}
+		else
+		{
+			pxModel->ulPendingTime = 0;
+			if( uxUart == 0 )
+			{
+				uart1_irq_handler();
+			}
+			else
+			{
+				uart2_irq_handler();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vUartModelSetLatency( uint32_t ulCharTimes )
+{
+	ulLatency = ulCharTimes;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulUartModelGetIer( const volatile void *pvUart )
+{
+	return xModels[ prvIndex( pvUart ) ].ulIer;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvIndex( const volatile void *pvUart )
+{
+	configASSERT( ( pvUart == DEV_UART1 ) || ( pvUart == DEV_UART2 ) );
+
+	return ( pvUart == DEV_UART1 ) ? 0 : 1;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvIdentify( UartModel_t *pxModel, BaseType_t xRead )
+{
+static const uint32_t ulTriggerLevels[] = { 1, 4, 8, 14 };
+const uint32_t ulTrigger = ulTriggerLevels[ ( pxModel->ulFcr & UARTC_FCR_RXFIFO_TRGL_MASK ) >> UARTC_FCR_RXFIFO_TRGL_SHIFT ];
+
+	if( ( ( pxModel->ulIer & UARTC_IER_RLS ) != 0 ) && ( ( pxModel->ulLsrErrors & UARTC_LSR_OE ) != 0 ) )
+	{
+		return UARTC_IIR_RLS;
+	}
+
+	if( ( pxModel->ulIer & UARTC_IER_RDR ) != 0 )
+	{
+		if( pxModel->ulRxCount >= ulTrigger )
+		{
+			return UARTC_IIR_RDA;
+		}
+
+		if( ( pxModel->ulRxCount > 0 ) && ( pxModel->ulRxIdle >= modelTIMEOUT_CHAR_TIMES ) )
+		{
+			return UARTC_IIR_RTO;
+		}
+	}
+
+	if( ( ( pxModel->ulIer & UARTC_IER_THRE ) != 0 ) && ( pxModel->xThrePending != pdFALSE ) )
+	{
+		if( xRead != pdFALSE )
+		{
+			pxModel->xThrePending = pdFALSE;
+		}
+		return UARTC_IIR_THRE;
+	}
+
+	return UARTC_IIR_NONE;
+}
+/*-----------------------------------------------------------*/
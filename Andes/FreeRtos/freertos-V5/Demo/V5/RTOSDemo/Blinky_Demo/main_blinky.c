@@ -85,6 +85,9 @@
 #include "timers.h"
 #include "semphr.h"
 
+/* Platform includes. */
+#include "dlog.h"
+
 /* Priorities at which the tasks are created. */
 #define mainQUEUE_RECEIVE_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
 #define	mainQUEUE_SEND_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
@@ -102,6 +105,14 @@ queue send software timer respectively. */
 #define mainVALUE_SENT_FROM_TASK			( 100UL )
 #define mainVALUE_SENT_FROM_TIMER			( 200UL )
 
+/* With deferred logging the receive task writes its messages to the log
+instead of waiting for the UART to send them. */
+#if( configUSE_DEFERRED_LOG == 1 )
+	#define mainPRINT( pcMessage )			dlogPRINTF( pcMessage )
+#else
+	#define mainPRINT( pcMessage )			printf( pcMessage )
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -248,15 +259,15 @@ uint32_t ulReceivedValue;
 		console output) from a FreeRTOS task. */
 		if( ulReceivedValue == mainVALUE_SENT_FROM_TASK )
 		{
-			printf( "Message received from task\r\n" );
+			mainPRINT( "Message received from task\r\n" );
 		}
 		else if( ulReceivedValue == mainVALUE_SENT_FROM_TIMER )
 		{
-			printf( "Message received from software timer\r\n" );
+			mainPRINT( "Message received from software timer\r\n" );
 		}
 		else
 		{
-			printf( "Unexpected message\r\n" );
+			mainPRINT( "Unexpected message\r\n" );
 		}
     }
 }
@@ -61,13 +61,26 @@
 #define configUSE_TASK_NOTIFICATIONS			1
 #define configUSE_MUTEXES						1
 #define configUSE_RECURSIVE_MUTEXES				1
+#define configUSE_TRANSITIVE_PRIORITY_INHERITANCE	1
+#define configUSE_CEILING_MUTEXES				1
+#define configUSE_FAST_SEMAPHORES				1
+#define configUSE_RW_LOCKS						1
 #define configUSE_COUNTING_SEMAPHORES			1
 #define configQUEUE_REGISTRY_SIZE				10
-#define configUSE_QUEUE_SETS					0
+#define configUSE_QUEUE_SETS					1
+#define configUSE_QUEUE_SET_BITMAP				1
+#define configUSE_SKIP_LISTS					0
+#define configSKIP_LIST_LEVELS					4
 
 /* Memory allocation definitions. */
 #define configSUPPORT_STATIC_ALLOCATION			1
 #define configSUPPORT_DYNAMIC_ALLOCATION		1
+#define configUSE_KERNEL_OBJECT_SLABS			1
+#define configUSE_TASK_HEAP_CACHE				1
+#define configUSE_HEAP_TRACKING					1
+#define configUSE_MEMORY_POOLS					1
+#define configUSE_ALIGNED_KERNEL_OBJECTS		1
+#define configKERNEL_OBJECT_ALIGNMENT			( ( size_t ) nds_dcache_line_size() )
 #ifdef CFG_CF1
 #define configTOTAL_HEAP_SIZE					( ( size_t ) ( 1024 * 1024 ) )
 #else
@@ -87,11 +100,17 @@
 #define configGENERATE_RUN_TIME_STATS			0
 #define configUSE_TRACE_FACILITY    			1		// Awareness debugging used
 #define configUSE_STATS_FORMATTING_FUNCTIONS	0
+#define configUSE_SECTION_PROFILING			0
+#define configSECTION_PROFILE_LONGEST			8
 
 /* Co-routine definitions. */
-#define configUSE_CO_ROUTINES 					0
+#define configUSE_CO_ROUTINES 					1
 #define configMAX_CO_ROUTINE_PRIORITIES         ( 2 )
 
+/* Run to completion task definitions. */
+#define configUSE_SHARED_STACK_TASKS			1
+#define configSHARED_STACK_DEPTH				( 1024 )
+
 /* Software timer definitions. */
 #define configUSE_TIMERS						1
 #define configTIMER_TASK_PRIORITY				( configMAX_PRIORITIES - 1 )
@@ -133,8 +152,13 @@ in assembler files. */
 	void vClearTickInterrupt( void );
 	void vPreSleepProcessing( unsigned long uxExpectedIdleTime );
 	void vPostSleepProcessing( unsigned long uxExpectedIdleTime );
+	unsigned long ulGetBenchmarkTime( void );
+	unsigned long nds_dcache_line_size( void );
 #endif /* __ASSEMBLER__ */
 
+/* Used by the benchmarks in the full demo to time operations in CPU cycles. */
+#define configBENCHMARK_GET_TIME() ulGetBenchmarkTime()
+
 
 
 /* Normal assert() semantics without relying on the provision of an assert.h
@@ -161,6 +185,12 @@ header file. */
 #endif
 #endif
 
+/* Run the HSP in top-of-stack recording mode instead of overflow detection, so
+each task's deepest stack pointer is kept in its TCB for uxTaskGetStackPeak().
+Overflows are then found by configCHECK_FOR_STACK_OVERFLOW when the task is
+switched out.  Needs configHSP_ENABLE. */
+#define configRECORD_STACK_PEAK				0
+
 #if 0
 /*
  * The application must provide a function that configures a peripheral to
@@ -182,6 +212,60 @@ provided in this demo can be extended to save even more power. */
 /* Compiler specifics. */
 #define fabs( x ) __builtin_fabs( x )
 
+/* PC sampling profiler specifics, see RTOSDemo_bsp/profiler/profiler.h. */
+
+/* Enable the PC sampling profiler */
+#define configUSE_PC_PROFILER				0
+
+/* Samples per second, from PIT channel 3.  Not a multiple of the tick rate, so
+work done in step with the tick is still sampled. */
+#define configPROFILER_SAMPLE_HZ			( 997 )
+
+/* Return addresses recorded with each sample.  Needs a build with
+USE_FRAME_POINTER=1. */
+#define configPROFILER_BACKTRACE_DEPTH		( 0 )
+
+/* Samples kept for the host, the oldest are overwritten first. */
+#define configPROFILER_BUFFER_SAMPLES		( 1024 )
+
+/* Interrupt latency statistics specifics, see RTOSDemo_bsp/isrstats/isrstats.h. */
+
+/* Time the entry, duration and task wake latency of the tick and of each PLIC
+interrupt source. */
+#define configUSE_ISR_STATS					0
+
+/* PLIC sources measured, the tick is kept in place of source 0. */
+#define configISR_STATS_NUM_IRQS			( 32 )
+
+/* Power of two histogram buckets, the last counts all longer times. */
+#define configISR_STATS_BUCKETS				( 16 )
+
+/* Deferred logging specifics, see RTOSDemo_bsp/dlog/dlog.h. */
+
+/* Print the demo's messages from a low priority drain task, so tasks and
+interrupts do not wait for the UART. */
+#define configUSE_DEFERRED_LOG				0
+
+/* Words of the ring buffer, a power of two.  A message takes two words plus
+one per argument. */
+#define configDLOG_BUFFER_WORDS				( 1024 )
+
+/* Period at which the drain task prints the messages written. */
+#define configDLOG_DRAIN_PERIOD_MS			( 20 )
+
+/* Interrupt driven UART specifics, see RTOSDemo_bsp/uartstream/uartstream.h. */
+
+/* Build the stream buffer UART driver, and run its loopback benchmark once
+from main.c. */
+#define configUSE_UART_STREAM				0
+
+/* Receive FIFO level that raises an interrupt. */
+#define configUART_STREAM_RX_TRIGGER		UARTC_FCR_RFIFO16_TRGL8
+
+/* Fill the transmit FIFO by DMA, AE250 only.  Also needs
+configUART1_DMA_TX_REQ and configUART2_DMA_TX_REQ. */
+#define configUART_STREAM_USE_DMA			0
+
 /* Andes RTOS Tracer specifics. */
 
 /* Enable Andes RTOS Tracer */
@@ -194,6 +278,15 @@ Members except log buffer in uncached buffer used at most 6 cache line space. */
 /* Maximum number of RTOS tasks info can be kept in target */
 #define configTRACER_MAX_NUM_TASK_INFO		32
 
+/* Bytes of events written to the log buffer before they are written back and
+made visible to the host.  Pending events are also published every tick.  Set
+to 0 to publish every event as it is written. */
+#define configTRACER_BATCH_SIZE				( tracerCACHE_LINE_SIZE )
+
+/* Trace stream buffer, event group, timer, task notification, priority
+inheritance and heap events in addition to task, queue and semaphore events. */
+#define configTRACER_KERNEL_OBJECT_EVENTS	1
+
 #if( configUSE_ANDES_TRACER == 1 && configUSE_TRACE_FACILITY != 1 )
 	/* Andes RTOS Tracer needs configUSE_TRACE_FACILITY. Forcely enable it. */
 	#undef configUSE_TRACE_FACILITY
@@ -73,6 +73,7 @@
 #include "task.h"
 #include "timers.h"
 #include "semphr.h"
+#include "heap_tracking.h"
 
 /* Standard demo application includes. */
 #include "flop.h"
@@ -90,6 +91,18 @@
 #include "AbortDelay.h"
 #include "QueueOverwrite.h"
 #include "TimerDemo.h"
+#include "InheritChain.h"
+#include "CeilingMutex.h"
+#include "FastSemBench.h"
+#include "RWLockBench.h"
+#include "QueueSetBitmap.h"
+#include "SlabCache.h"
+#include "HeapCache.h"
+#include "HeapTracking.h"
+#include "MemPoolTest.h"
+#include "AlignedAlloc.h"
+#include "CoRoutineBench.h"
+#include "SharedStack.h"
 
 /* Priorities for the demo application tasks. */
 #define mainSEM_TEST_PRIORITY				( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
@@ -190,6 +203,18 @@ void main_full( void )
 	vStartStaticallyAllocatedTasks();
 	vStartQueueOverwriteTask( mainQUEUE_OVERWRITE_PRIORITY );
 	vStartTimerDemoTask( mainTIMER_TEST_PERIOD );
+	vStartInheritChainTasks();
+	vStartCeilingMutexTasks();
+	vStartFastSemaphoreBenchmarkTasks();
+	vStartRWLockBenchmarkTasks();
+	vStartQueueSetBitmapTasks();
+	vStartSlabCacheTasks();
+	vStartHeapCacheTasks();
+	vStartHeapTrackingTasks();
+	vStartMemPoolTasks();
+	vStartAlignedAllocTasks();
+	vStartCoRoutineBenchTasks();
+	vStartSharedStackTasks();
 
 	/* Create the register check tasks, as described at the top of this	file */
 	xTaskCreate( prvRegTestTaskEntry1, "Reg1", configMINIMAL_STACK_SIZE, mainREG_TEST_TASK_1_PARAMETER, tskIDLE_PRIORITY, NULL );
@@ -224,6 +249,9 @@ TickType_t xLastExecutionTime;
 static uint64_t ullLastRegTest1Value = 0, ullLastRegTest2Value = 0;
 uint32_t ullErrorFound = pdFALSE;
 const char *pcStatusString = "Pass";
+uint32_t ulStandardMutexTime, ulFastMutexTime, ulGenericCeilingMutexTime, ulCeilingMutexTime;
+HeapTrackingStats_t xHeapStats;
+size_t xCoRoutineBytes, xTaskBytes, xRunToCompletionBytes;
 
 	/* Just to stop compiler warnings. */
 	( void ) pvParameters;
@@ -320,6 +348,78 @@ const char *pcStatusString = "Pass";
 			pcStatusString = "Error: Timer Demo";
 		}
 
+		if( xAreInheritChainTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 19ULL;
+			pcStatusString = "Error: Inherit Chain";
+		}
+
+		if( xAreCeilingMutexTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 20ULL;
+			pcStatusString = "Error: Ceiling Mutex";
+		}
+
+		if( xAreFastSemaphoreBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 21ULL;
+			pcStatusString = "Error: Fast Semaphore";
+		}
+
+		if( xAreRWLockBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 22ULL;
+			pcStatusString = "Error: RW Lock";
+		}
+
+		if( xAreQueueSetBitmapTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 23ULL;
+			pcStatusString = "Error: Queue Set Bitmap";
+		}
+
+		if( xAreSlabCacheTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 24ULL;
+			pcStatusString = "Error: Slab Cache";
+		}
+
+		if( xAreHeapCacheTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 25ULL;
+			pcStatusString = "Error: Heap Cache";
+		}
+
+		if( xAreHeapTrackingTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 26ULL;
+			pcStatusString = "Error: Heap Tracking";
+		}
+
+		if( xAreMemPoolTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 27ULL;
+			pcStatusString = "Error: Memory Pools";
+		}
+
+		if( xAreAlignedAllocTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 28ULL;
+			pcStatusString = "Error: Aligned Alloc";
+		}
+
+		if( xAreCoRoutineBenchTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 29ULL;
+			pcStatusString = "Error: Co-routines";
+		}
+
+		if( xAreSharedStackTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 30ULL;
+			pcStatusString = "Error: Shared Stack";
+		}
+
 		/* Check that the register test 1 task is still running. */
 		if( ullLastRegTest1Value == ullRegTest1LoopCounter )
 		{
@@ -339,6 +439,36 @@ const char *pcStatusString = "Pass";
 		/* Output the system status string. */
 		printf( "%s, status code = %u, tick count = %u\r\n", pcStatusString, (unsigned int)ullErrorFound, (unsigned int)xTaskGetTickCount() );
 
+		/* Output the time taken by the most recent mutex benchmarks. */
+		vGetFastSemaphoreBenchmarkResults( &ulStandardMutexTime, &ulFastMutexTime );
+		printf( "Mutex take/give cycles: standard = %u, fast = %u\r\n", (unsigned int)ulStandardMutexTime, (unsigned int)ulFastMutexTime );
+
+		/* Output the time taken by the most recent priority ceiling mutex
+		benchmarks. */
+		vGetCeilingMutexBenchmarkResults( &ulStandardMutexTime, &ulGenericCeilingMutexTime, &ulCeilingMutexTime );
+		printf( "Ceiling mutex take/give cycles: standard = %u, generic = %u, ceiling = %u\r\n", (unsigned int)ulStandardMutexTime, (unsigned int)ulGenericCeilingMutexTime, (unsigned int)ulCeilingMutexTime );
+
+		/* Output the reads completed by 1, 2 and 4 reader tasks using a mutex
+		and using a reader-writer lock. */
+		printf( "Reads per phase: mutex = %u/%u/%u, rwlock = %u/%u/%u\r\n",
+				(unsigned int)ulGetRWLockBenchmarkReads( pdFALSE, 0 ), (unsigned int)ulGetRWLockBenchmarkReads( pdFALSE, 1 ), (unsigned int)ulGetRWLockBenchmarkReads( pdFALSE, 2 ),
+				(unsigned int)ulGetRWLockBenchmarkReads( pdTRUE, 0 ), (unsigned int)ulGetRWLockBenchmarkReads( pdTRUE, 1 ), (unsigned int)ulGetRWLockBenchmarkReads( pdTRUE, 2 ) );
+
+		/* Output the worst case heap allocation and free times. */
+		vHeapTrackingGetStats( &xHeapStats );
+		printf( "Heap cycles: malloc max = %u, free max = %u, failed allocations = %u\r\n",
+				(unsigned int)xHeapStats.ulMaximumAllocationCycles, (unsigned int)xHeapStats.ulMaximumFreeCycles, (unsigned int)xHeapStats.ulFailedAllocations );
+
+		/* Output the heap used per connection by a co-routine and by a
+		task. */
+		vGetCoRoutineBenchmarkResults( &xCoRoutineBytes, &xTaskBytes );
+		printf( "Heap bytes per connection: co-routine = %u, task = %u\r\n", (unsigned int)xCoRoutineBytes, (unsigned int)xTaskBytes );
+
+		/* Output the heap used per event handler by a run to completion task
+		and by a task. */
+		vGetSharedStackBenchmarkResults( &xRunToCompletionBytes, &xTaskBytes );
+		printf( "Heap bytes per handler: run to completion = %u, task = %u\r\n", (unsigned int)xRunToCompletionBytes, (unsigned int)xTaskBytes );
+
 		configASSERT( ullErrorFound == pdFALSE );
 	}
 }
@@ -429,4 +559,13 @@ void vFullDemoTickHook( void )
 
 	/* Call the code that 'gives' a task notification from an ISR. */
 	xNotifyTaskFromISR();
+
+	/* Call the code that allocates and frees memory pool blocks from an ISR. */
+	vMemPoolPeriodicISRTest();
+
+	/* Call the code that notifies a co-routine from an ISR. */
+	vCoRoutineBenchPeriodicISRTest();
+
+	/* Call the code that notifies a run to completion task from an ISR. */
+	vSharedStackPeriodicISRTest();
 }
@@ -46,6 +46,10 @@
 /* Platfrom includes. */
 #include "platform.h"
 #include "uart.h"
+#include "profiler.h"
+#include "isrstats.h"
+#include "dlog.h"
+#include "uartstream.h"
 
 /* mainSELECTED_APPLICATION is used to select between two demo applications,
  * as described at the top of this file.
@@ -58,6 +62,27 @@
  */
 #define mainSELECTED_APPLICATION	0
 
+/* When configRECORD_STACK_PEAK is 1 a task prints the most stack each task has
+used at this period, so the stack sizes can be reduced to what is needed.  When
+configUSE_ISR_STATS is 1 it also prints the interrupt latency statistics. */
+#define mainREPORT_TASK				( ( configRECORD_STACK_PEAK == 1 ) || ( configUSE_ISR_STATS == 1 ) )
+#define mainREPORT_PERIOD			pdMS_TO_TICKS( 10000 )
+#define mainREPORT_MAX_TASKS		( 16 )
+#define mainREPORT_PRIORITY			( tskIDLE_PRIORITY + 1 )
+
+/* When configUSE_UART_STREAM is 1 a task runs the UART loopback benchmark once
+on the UART that is not the console, which is UART1 on AE350 and UART2 on
+AE250. */
+#ifdef AE350_UART1
+	#define mainUART_BENCH_PORT			uartstreamUART2
+#else
+	#define mainUART_BENCH_PORT			uartstreamUART1
+#endif
+#define mainUART_BENCH_BAUD			( 115200 )
+#define mainUART_BENCH_BYTES		( 4096 )
+#define mainUART_BENCH_BUFFER_SIZE	( 256 )
+#define mainUART_BENCH_PRIORITY		( tskIDLE_PRIORITY + 1 )
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -65,6 +90,22 @@
  */
 static void prvSetupHardware( void );
 
+/*
+ * Print the stack used by each task and the interrupt latency statistics every
+ * mainREPORT_PERIOD.
+ */
+#if( mainREPORT_TASK )
+	static void prvReportTask( void *pvParameters );
+#endif
+
+/*
+ * Measure the throughput of the interrupt driven UART driver with the UART in
+ * loopback mode, then delete itself.
+ */
+#if( configUSE_UART_STREAM == 1 )
+	static void prvUartBenchTask( void *pvParameters );
+#endif
+
 /*
  * See the comments at the top of this file and above the
  * mainSELECTED_APPLICATION definition.
@@ -84,6 +125,9 @@ void vApplicationIdleHook( void );
 void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName );
 void vApplicationTickHook( void );
 
+/* Returns the mcycle counter, used by configBENCHMARK_GET_TIME(). */
+unsigned long ulGetBenchmarkTime( void );
+
 /*-----------------------------------------------------------*/
 
 int main( void )
@@ -91,6 +135,27 @@ int main( void )
 	/* Configure the hardware ready to run the demo. */
 	prvSetupHardware();
 
+	#if( mainREPORT_TASK )
+	{
+		xTaskCreate( prvReportTask, "Report", configMINIMAL_STACK_SIZE, NULL, mainREPORT_PRIORITY, NULL );
+	}
+	#endif
+
+	#if( configUSE_UART_STREAM == 1 )
+	{
+		xTaskCreate( prvUartBenchTask, "UartBench", configMINIMAL_STACK_SIZE * 2, NULL, mainUART_BENCH_PRIORITY, NULL );
+	}
+	#endif
+
+	/* Messages written with dlogPRINTF() are printed by the drain task. */
+	#if( configUSE_DEFERRED_LOG == 1 )
+	{
+		if( xDLogInit() != pdPASS )
+		{
+			vAssertCalled( __FILE__, __LINE__ );
+		}
+	}
+	#endif
 
 	/* The mainSELECTED_APPLICATION setting is described at the top
 	of this file. */
@@ -131,10 +196,100 @@ static void prvSetupHardware( void )
 		{
 			while( 1 );
 		}
+
+		{
+		uint32_t ulUnbatchedCycles, ulBatchedCycles;
+
+			vRtosTracerGetWriteCycles( &ulUnbatchedCycles, &ulBatchedCycles );
+			printf( "Tracer cycles per event: unbatched = %u, batched = %u\r\n", ( unsigned ) ulUnbatchedCycles, ( unsigned ) ulBatchedCycles );
+		}
+	#endif
+
+	/* If the PC sampling profiler is enabled, profile from the start of the
+	scheduler.  The host reads xProfilerBuffer, see profiler.h. */
+	#if( configUSE_PC_PROFILER == 1 )
+		if( xProfilerInit() != pdPASS )
+		{
+			while( 1 );
+		}
+		vProfilerStart();
 	#endif
 }
 /*-----------------------------------------------------------*/
 
+#if( mainREPORT_TASK )
+
+	static void prvReportTask( void *pvParameters )
+	{
+	#if( configRECORD_STACK_PEAK == 1 )
+		static TaskStatus_t xTaskStatus[ mainREPORT_MAX_TASKS ];
+		UBaseType_t uxTasks, x;
+		configSTACK_DEPTH_TYPE uxPeak, uxSize;
+	#endif
+
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			vTaskDelay( mainREPORT_PERIOD );
+
+			#if( configRECORD_STACK_PEAK == 1 )
+			{
+				/* The peaks are read from the TCBs, so the stacks are not
+				scanned and the report does not disturb the other tasks. */
+				uxTasks = uxTaskGetSystemState( xTaskStatus, mainREPORT_MAX_TASKS, NULL );
+				printf( "Task             peak stack (words)\r\n" );
+				for( x = 0; x < uxTasks; x++ )
+				{
+					uxPeak = uxTaskGetStackPeak( xTaskStatus[ x ].xHandle, &uxSize );
+					printf( "%-16s %6u of %6u\r\n", xTaskStatus[ x ].pcTaskName, ( unsigned ) uxPeak, ( unsigned ) uxSize );
+				}
+			}
+			#endif
+
+			#if( configUSE_ISR_STATS == 1 )
+			{
+				vIsrStatsPrint();
+			}
+			#endif
+		}
+	}
+
+#endif /* mainREPORT_TASK */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_UART_STREAM == 1 )
+
+	static void prvUartBenchTask( void *pvParameters )
+	{
+	UartBenchResult_t xResult;
+	BaseType_t xStatus;
+
+		( void ) pvParameters;
+
+		if( xUartStreamInit( mainUART_BENCH_PORT, mainUART_BENCH_BAUD, mainUART_BENCH_BUFFER_SIZE, mainUART_BENCH_BUFFER_SIZE ) != pdPASS )
+		{
+			vAssertCalled( __FILE__, __LINE__ );
+		}
+
+		xStatus = xUartBenchLoopback( mainUART_BENCH_PORT, mainUART_BENCH_BYTES, NULL, &xResult );
+
+		printf( "UART loopback %s: %u bytes, %u errors, %u cycles, %u UART and %u DMA interrupts, %u overruns, %u dropped\r\n",
+				( xStatus == pdPASS ) ? "passed" : "FAILED",
+				( unsigned ) xResult.ulBytes,
+				( unsigned ) xResult.ulErrors,
+				( unsigned ) xResult.ulCycles,
+				( unsigned ) xResult.xStats.ulInterrupts,
+				( unsigned ) xResult.xStats.ulDmaInterrupts,
+				( unsigned ) xResult.xStats.ulRxOverruns,
+				( unsigned ) xResult.xStats.ulRxDropped );
+
+		vTaskDelete( NULL );
+	}
+
+#endif /* configUSE_UART_STREAM */
+/*-----------------------------------------------------------*/
+
 void vAssertCalled( const char * pcFile, unsigned long ulLine )
 {
 volatile unsigned long ul = 0;
@@ -208,6 +363,12 @@ volatile size_t xFreeHeapSpace;
 
 void vApplicationTickHook( void )
 {
+	#if( configUSE_PC_PROFILER == 1 ) && ( configPROFILER_USE_TICK == 1 )
+	{
+		vProfilerSample();
+	}
+	#endif
+
 	#if( mainSELECTED_APPLICATION == 1 )
 	{
 		/* Only the comprehensive demo actually uses the tick hook. */
@@ -218,6 +379,12 @@ void vApplicationTickHook( void )
 }
 /*-----------------------------------------------------------*/
 
+unsigned long ulGetBenchmarkTime( void )
+{
+	return read_csr( NDS_MCYCLE );
+}
+/*-----------------------------------------------------------*/
+
 /* configUSE_STATIC_ALLOCATION is set to 1, so the application must provide an
 implementation of vApplicationGetIdleTaskMemory() to provide the memory that is
 used by the Idle task. */
@@ -8,6 +8,7 @@
 #include "platform.h"
 
 #include "FreeRTOS.h"
+#include "isrstats.h"
 
 typedef void (*isr_func)(void);
 
@@ -77,6 +78,9 @@ HANDLER IS SPECIFIC TO FREERTOS WHICH USES PLIC! */
 void mext_interrupt(void)
 {
 	unsigned int irq_source = __nds__plic_claim_interrupt();
+	#if( configUSE_ISR_STATS == 1 )
+		vIsrStatsEnter(irq_source);
+	#endif
 	#if( configUSE_ANDES_TRACER == 1 )
 		traceISR_ENTER(irq_source);
 	#endif
@@ -87,5 +91,8 @@ void mext_interrupt(void)
 	#if( configUSE_ANDES_TRACER == 1 )
 		traceISR_EXIT();
 	#endif
+	#if( configUSE_ISR_STATS == 1 )
+		vIsrStatsExit();
+	#endif
 	__nds__plic_complete_interrupt(irq_source);
 }
@@ -10,6 +10,7 @@
 #include "ae350.h"
 
 #include "FreeRTOS.h"
+#include "isrstats.h"
 
 #define PLIC_BASE_ADDRESS               0xE4000000
 
@@ -82,12 +83,11 @@ version that does not enable interrupts is provided below.  THIS INTERRUPT
 HANDLER IS SPECIFIC TO FREERTOS WHICH USES PLIC! */
 void mext_interrupt(void)
 {
-
-	printf("[Debug] Entering mext_interrupt\n");
-	printf("[Debug] Pending Status: 0x%x\n", *(volatile unsigned int *)(PLIC_BASE_ADDRESS + PLIC_PENDING_OFFSET));
-
 	unsigned int irq_source = __nds__plic_claim_interrupt();
-	printf("plic_claim_interrupt %d\n",irq_source);
+
+	#if( configUSE_ISR_STATS == 1 )
+		vIsrStatsEnter(irq_source);
+	#endif
 	#if( configUSE_ANDES_TRACER == 1 )
 		traceISR_ENTER(irq_source);
 	#endif
@@ -99,5 +99,8 @@ void mext_interrupt(void)
 	#if( configUSE_ANDES_TRACER == 1 )
 		traceISR_EXIT();
 	#endif
+	#if( configUSE_ISR_STATS == 1 )
+		vIsrStatsExit();
+	#endif
 	__nds__plic_complete_interrupt(irq_source);
 }
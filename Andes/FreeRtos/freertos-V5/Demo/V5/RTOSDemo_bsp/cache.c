@@ -85,6 +85,7 @@ struct _cache_info {
 	uint8_t has_l2_cache;
 	uint8_t has_dma_coherency;
 	unsigned long cacheline_size;
+	unsigned long dcache_size;
 };
 
 /* Cache APIs */
@@ -92,6 +93,8 @@ struct _cache_info cache_info = {.is_init = 0, .has_l2_cache = 0, .has_dma_coher
 enum cache_t {ICACHE, DCACHE};
 
 static void get_cache_info(void);
+static inline unsigned long cache_set(enum cache_t cache);
+static inline unsigned long cache_way(enum cache_t cache);
 
 /* Critical section APIs */
 static ALWAYS_INLINE unsigned long GIE_SAVE(void)
@@ -148,6 +151,9 @@ static void get_cache_info(void)
 			cache_info.cacheline_size = 0;
 		}
 
+		/* Get L1 D-cache size */
+		cache_info.dcache_size = cache_way(DCACHE) * cache_set(DCACHE) * cache_info.cacheline_size;
+
 		/* Check L2 cache is supported */
 		if (DEV_SMU->SYSTEMCFG & (1 << 8)) {
 			cache_info.has_l2_cache = 1;
@@ -462,6 +468,20 @@ void nds_dcache_flush_all(void)
 	}
 }
 
+/*
+ * nds_dcache_line_size(void)
+ *
+ * Return the D-cache line size in bytes, or 0 when the cache is not used.
+ */
+unsigned long nds_dcache_line_size(void)
+{
+#ifdef CFG_CACHE_ENABLE
+	return cache_line_size();
+#else
+	return 0;
+#endif
+}
+
 static ALWAYS_INLINE void nds_dcache_invalidate_addr(unsigned long addr)
 {
 	nds_dcache_invalidate_range(addr, 1);
@@ -592,3 +612,187 @@ void nds_dma_invalidate_range2(unsigned long start, unsigned long size)
 
 	GIE_RESTORE(saved_gie);
 }
+
+/*
+ * sort_dma_ranges(ranges, count)
+ *
+ * Sort ranges by start address. Insertion sort, as descriptors and buffers
+ * are usually handed over in address order already.
+ */
+static void sort_dma_ranges(struct nds_dma_range *ranges, unsigned int count)
+{
+	struct nds_dma_range range;
+	unsigned int i, j;
+
+	for (i = 1; i < count; ++i) {
+		range = ranges[i];
+		for (j = i; (j > 0) && (ranges[j-1].start > range.start); --j)
+			ranges[j] = ranges[j-1];
+		ranges[j] = range;
+	}
+}
+
+/*
+ * merge_dma_ranges(ranges, count, line_size, total)
+ *
+ * Sort ranges, then merge the ones that overlap or touch and drop the empty
+ * ones, in place. Returns the number of ranges left, and in total the bytes
+ * of the cache lines they cover.
+ *
+ * Ranges that only share a cache line are kept apart, so the bytes between
+ * them are not invalidated. Callers skip the shared line the second time.
+ */
+static unsigned int merge_dma_ranges(struct nds_dma_range *ranges, unsigned int count,
+				     unsigned long line_size, unsigned long *total)
+{
+	unsigned int i, merged = 0;
+	unsigned long end;
+
+	sort_dma_ranges(ranges, count);
+
+	for (i = 0; i < count; ++i) {
+		if (ranges[i].size == 0)
+			continue;
+
+		if ((merged > 0) && (ranges[i].start <= ranges[merged-1].start + ranges[merged-1].size)) {
+			end = ranges[i].start + ranges[i].size;
+			if (end > ranges[merged-1].start + ranges[merged-1].size)
+				ranges[merged-1].size = end - ranges[merged-1].start;
+		}
+		else {
+			ranges[merged++] = ranges[i];
+		}
+	}
+
+	*total = 0;
+	for (i = 0; i < merged; ++i) {
+		*total += ROUND_UP(ranges[i].start + ranges[i].size, line_size)
+			  - ROUND_DOWN(ranges[i].start, line_size);
+	}
+
+	return merged;
+}
+
+static inline __attribute__((always_inline)) unsigned long dma_ranges_all_size()
+{
+	if (NDS_DMA_RANGES_ALL_SIZE != 0)
+		return NDS_DMA_RANGES_ALL_SIZE;
+
+	/* Never operate on the whole cache if its size is unknown. */
+	return (cache_info.dcache_size != 0) ? cache_info.dcache_size : ~0UL;
+}
+
+/*
+ * nds_dma_writeback_ranges(ranges, count)
+ *
+ * Writeback D-Cache of each of the regions, see nds_dma_writeback_range().
+ */
+void nds_dma_writeback_ranges(struct nds_dma_range *ranges, unsigned int count)
+{
+	if (has_dma_coherency()) {
+		return;
+	}
+
+	unsigned long line_size = cache_line_size();
+	unsigned long total, start, end, next = 0;
+	unsigned int i;
+
+	if (line_size == 0) {
+		return;
+	}
+
+	count = merge_dma_ranges(ranges, count, line_size, &total);
+	if (count == 0) {
+		return;
+	}
+
+	unsigned long saved_gie = GIE_SAVE();
+
+	if (total > dma_ranges_all_size()) {
+		/* There is no L2 writeback all, flush writes back too. */
+		nds_l1c_dcache_writeback_all();
+		nds_l2c_cache_flush_all();
+	}
+	else {
+		for (i = 0; i < count; ++i) {
+			start = ROUND_DOWN(ranges[i].start, line_size);
+			end   = ROUND_UP(ranges[i].start + ranges[i].size, line_size);
+
+			/* Skip the line shared with the previous range. */
+			if (start < next)
+				start = next;
+
+			if (start < end) {
+				nds_l1c_dcache_writeback_range(start, end - start);
+				nds_l2c_cache_writeback_range(start, end - start);
+				next = end;
+			}
+		}
+	}
+
+	GIE_RESTORE(saved_gie);
+}
+
+/*
+ * nds_dma_invalidate_ranges(ranges, count)
+ *
+ * Invalidate D-Cache of each of the unaligned regions, see
+ * nds_dma_invalidate_range(). Unaligned boundary lines are written back.
+ */
+void nds_dma_invalidate_ranges(struct nds_dma_range *ranges, unsigned int count)
+{
+	if (has_dma_coherency()) {
+		return;
+	}
+
+	unsigned long line_size = cache_line_size();
+	unsigned long total, start, end, aligned_start, aligned_end, next = 0;
+	unsigned int i;
+
+	if (line_size == 0) {
+		return;
+	}
+
+	count = merge_dma_ranges(ranges, count, line_size, &total);
+	if (count == 0) {
+		return;
+	}
+
+	if (total > dma_ranges_all_size()) {
+		nds_dcache_flush_all();
+		return;
+	}
+
+	unsigned long saved_gie = GIE_SAVE();
+
+	for (i = 0; i < count; ++i) {
+		start = ranges[i].start;
+		end   = start + ranges[i].size;
+		aligned_start = ROUND_UP(start, line_size);
+		aligned_end   = ROUND_DOWN(end, line_size);
+
+		/*
+		 * Only a flushed boundary line can be shared with the previous
+		 * range, as ranges that overlap or touch have been merged.
+		 */
+		if (aligned_start > aligned_end) {
+			if (ROUND_DOWN(start, line_size) >= next)
+				nds_dcache_flush_addr(start);
+		}
+		else {
+			if ((start < aligned_start) && (ROUND_DOWN(start, line_size) >= next)) {
+				nds_dcache_flush_addr(start);
+			}
+			if (aligned_start < aligned_end) {
+				nds_dcache_invalidate_range(aligned_start, aligned_end - aligned_start);
+			}
+			if (aligned_end < end) {
+				nds_dcache_flush_addr(end);
+			}
+		}
+
+		next = ROUND_UP(end, line_size);
+	}
+
+	GIE_RESTORE(saved_gie);
+}
@@ -18,10 +18,35 @@ extern void nds_dcache_writeback_range(unsigned long start, unsigned long size);
 extern void nds_dcache_invalidate_range(unsigned long start, unsigned long size);
 extern void nds_dcache_flush_range(unsigned long start, unsigned long size);
 extern void nds_dcache_flush_all(void);
+extern unsigned long nds_dcache_line_size(void);
 
 /* DMA-specific ops */
 extern void nds_dma_writeback_range(unsigned long start, unsigned long size);
 extern void nds_dma_invalidate_range(unsigned long start, unsigned long size);
 extern void nds_dma_invalidate_range2(unsigned long start, unsigned long size);
 
+/*
+ * Scatter-gather DMA ops
+ *
+ * Do the same as nds_dma_writeback_range() and nds_dma_invalidate_range() for
+ * each of count ranges, with interrupts disabled once for the whole list.
+ * The list is sorted by start address and merged in place, so a cache line
+ * shared by several ranges is operated on once. When the merged ranges cover
+ * more than NDS_DMA_RANGES_ALL_SIZE bytes, the whole D-cache is written back,
+ * or flushed, instead.
+ */
+struct nds_dma_range {
+	unsigned long start;
+	unsigned long size;
+};
+
+/* Bytes of merged ranges above which the whole D-cache is operated on.
+   Defaults to the size of the L1 D-cache. */
+#ifndef NDS_DMA_RANGES_ALL_SIZE
+#define NDS_DMA_RANGES_ALL_SIZE			0
+#endif
+
+extern void nds_dma_writeback_ranges(struct nds_dma_range *ranges, unsigned int count);
+extern void nds_dma_invalidate_ranges(struct nds_dma_range *ranges, unsigned int count);
+
 #endif /* __CACHE_H__ */
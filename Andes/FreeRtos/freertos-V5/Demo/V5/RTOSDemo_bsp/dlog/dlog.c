@@ -0,0 +1,310 @@
+#include "FreeRTOS.h"
+
+#if( configUSE_DEFERRED_LOG == 1 )
+
+#include <stdio.h>
+#include <string.h>
+
+#include "task.h"
+#include "atomic.h"
+#include "dlog.h"
+
+#if( ( configDLOG_BUFFER_WORDS & ( configDLOG_BUFFER_WORDS - 1 ) ) != 0 )
+	#error configDLOG_BUFFER_WORDS must be a power of two
+#endif
+
+/* Index of a word in uxDLogBuffer[] from a free running count of words. */
+#define prvINDEX( ulWord )		( ( ulWord ) & ( configDLOG_BUFFER_WORDS - 1 ) )
+
+/* Room for the longest conversion specification printed, such as "%-08lx",
+and its terminator.  Longer specifications are truncated. */
+#define dlogMAX_SPEC_LENGTH		( 16 )
+
+/* The argument types selected by the length modifier of a conversion. */
+#define dlogARG_INT				( 0 )
+#define dlogARG_LONG			( 1 )
+#define dlogARG_LONG_LONG		( 2 )
+#define dlogARG_SIZE			( 3 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Print the oldest message, returning pdFALSE if there is no complete message
+ * to print.
+ */
+static BaseType_t prvDrainOne( void );
+
+/*
+ * Print a message, passing each argument to printf() as the type its
+ * conversion specification expects.  The arguments were stored as uintptr_t,
+ * and passing a uintptr_t where printf() reads an int or an unsigned int is
+ * undefined behaviour, so each conversion is printed on its own with its
+ * argument cast back.
+ */
+static void prvPrintMessage( const char *pcFormat, const uintptr_t *puxArgs, UBaseType_t uxArgs );
+
+static void prvDrainTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The records.  A record is the format, the number of arguments and the
+arguments.  The format word of a record is 0 until the record is complete,
+and the drain task sets every word of a record back to 0 once it has read
+it. */
+static volatile uintptr_t uxDLogBuffer[ configDLOG_BUFFER_WORDS ];
+
+/* Free running counts of the words reserved by writers and of the words freed
+by the drain task. */
+static volatile uint32_t ulDLogHead;
+static volatile uint32_t ulDLogTail;
+
+static volatile uint32_t ulDLogDropped;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xDLogInit( void )
+{
+	return xTaskCreate( prvDrainTask, "DLog", configDLOG_DRAIN_STACK_SIZE, NULL, configDLOG_DRAIN_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDLogWrite( const char *pcFormat, const uintptr_t *puxArgs, UBaseType_t uxArgs )
+{
+const uint32_t ulWords = dlogHEADER_WORDS + ( uint32_t ) uxArgs;
+uint32_t ulHead;
+UBaseType_t x;
+
+	configASSERT( uxArgs <= dlogMAX_ARGS );
+
+	/* Reserve the words.  An interrupt, or a task that preempts this one, can
+	reserve words between the read of the head and the compare and swap, in
+	which case the reservation is tried again after the words it took. */
+	do
+	{
+		ulHead = ulDLogHead;
+
+		if( ( ulHead - ulDLogTail ) > ( configDLOG_BUFFER_WORDS - ulWords ) )
+		{
+			( void ) Atomic_Increment_u32( &ulDLogDropped );
+			return pdFAIL;
+		}
+	} while( Atomic_CompareAndSwap_u32( &ulDLogHead, ulHead + ulWords, ulHead ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS );
+
+	for( x = 0; x < uxArgs; x++ )
+	{
+		uxDLogBuffer[ prvINDEX( ulHead + dlogHEADER_WORDS + x ) ] = puxArgs[ x ];
+	}
+	uxDLogBuffer[ prvINDEX( ulHead + 1 ) ] = ( uintptr_t ) uxArgs;
+
+	/* The format is written last, as it marks the record complete. */
+	portMEMORY_BARRIER();
+	uxDLogBuffer[ prvINDEX( ulHead ) ] = ( uintptr_t ) pcFormat;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulDLogGetDropped( void )
+{
+	return ulDLogDropped;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDrainOne( void )
+{
+const uint32_t ulTail = ulDLogTail;
+uintptr_t uxArgs[ dlogMAX_ARGS ] = { 0 };
+const char *pcFormat;
+uint32_t ulWords;
+UBaseType_t uxCount, x;
+
+	if( ulTail == ulDLogHead )
+	{
+		return pdFALSE;
+	}
+
+	pcFormat = ( const char * ) uxDLogBuffer[ prvINDEX( ulTail ) ];
+	if( pcFormat == NULL )
+	{
+		/* Reserved by a task that was preempted before it completed the
+		record. */
+		return pdFALSE;
+	}
+
+	portMEMORY_BARRIER();
+	uxCount = ( UBaseType_t ) uxDLogBuffer[ prvINDEX( ulTail + 1 ) ];
+	ulWords = dlogHEADER_WORDS + ( uint32_t ) uxCount;
+
+	for( x = 0; x < uxCount; x++ )
+	{
+		uxArgs[ x ] = uxDLogBuffer[ prvINDEX( ulTail + dlogHEADER_WORDS + x ) ];
+	}
+
+	/* Any word of this record can hold the format of a later record, so all
+	are cleared before the words are freed. */
+	for( x = 0; x < ulWords; x++ )
+	{
+		uxDLogBuffer[ prvINDEX( ulTail + x ) ] = 0;
+	}
+	portMEMORY_BARRIER();
+	ulDLogTail = ulTail + ulWords;
+
+	prvPrintMessage( pcFormat, uxArgs, uxCount );
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintMessage( const char *pcFormat, const uintptr_t *puxArgs, UBaseType_t uxArgs )
+{
+char cSpec[ dlogMAX_SPEC_LENGTH ];
+size_t xLength;
+UBaseType_t uxArg = 0, uxType;
+uintptr_t uxValue;
+char cConversion;
+
+	while( *pcFormat != '\0' )
+	{
+		if( *pcFormat != '%' )
+		{
+			( void ) putchar( *pcFormat );
+			pcFormat++;
+			continue;
+		}
+
+		/* Copy the flags, width, precision and length modifier, noting the
+		type the length modifier selects. */
+		cSpec[ 0 ] = '%';
+		xLength = 1;
+		uxType = dlogARG_INT;
+		pcFormat++;
+
+		while( ( *pcFormat != '\0' ) && ( strchr( "-+ #0123456789.hlz", *pcFormat ) != NULL ) )
+		{
+			if( *pcFormat == 'l' )
+			{
+				uxType = ( uxType == dlogARG_LONG ) ? dlogARG_LONG_LONG : dlogARG_LONG;
+			}
+			else if( *pcFormat == 'z' )
+			{
+				uxType = dlogARG_SIZE;
+			}
+
+			if( xLength < ( dlogMAX_SPEC_LENGTH - 2 ) )
+			{
+				cSpec[ xLength++ ] = *pcFormat;
+			}
+
+			pcFormat++;
+		}
+
+		cConversion = *pcFormat;
+		if( cConversion == '\0' )
+		{
+			break;
+		}
+
+		pcFormat++;
+		cSpec[ xLength++ ] = cConversion;
+		cSpec[ xLength ] = '\0';
+
+		if( cConversion == '%' )
+		{
+			( void ) putchar( '%' );
+			continue;
+		}
+
+		/* A missing argument prints as 0 rather than reading past the
+		record. */
+		uxValue = ( uxArg < uxArgs ) ? puxArgs[ uxArg++ ] : 0;
+
+		switch( cConversion )
+		{
+			case 'd':
+			case 'i':
+				if( uxType == dlogARG_LONG_LONG )
+				{
+					printf( cSpec, ( long long ) ( intptr_t ) uxValue );
+				}
+				else if( uxType != dlogARG_INT )
+				{
+					/* %zd is printed as a long, which has the width of a
+					size_t on RISC-V. */
+					printf( cSpec, ( long ) ( intptr_t ) uxValue );
+				}
+				else
+				{
+					printf( cSpec, ( int ) uxValue );
+				}
+				break;
+
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+				if( uxType == dlogARG_LONG_LONG )
+				{
+					printf( cSpec, ( unsigned long long ) uxValue );
+				}
+				else if( uxType == dlogARG_LONG )
+				{
+					printf( cSpec, ( unsigned long ) uxValue );
+				}
+				else if( uxType == dlogARG_SIZE )
+				{
+					printf( cSpec, ( size_t ) uxValue );
+				}
+				else
+				{
+					printf( cSpec, ( unsigned int ) uxValue );
+				}
+				break;
+
+			case 'c':
+				printf( cSpec, ( int ) uxValue );
+				break;
+
+			case 's':
+				printf( cSpec, ( const char * ) uxValue );
+				break;
+
+			case 'p':
+				printf( cSpec, ( void * ) uxValue );
+				break;
+
+			default:
+				/* Floating point and other conversions cannot be printed
+				from a uintptr_t, so the specification is printed as it is
+				and its argument skipped. */
+				printf( "%s", cSpec );
+				break;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDrainTask( void *pvParameters )
+{
+uint32_t ulReported = 0, ulDropped;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		while( prvDrainOne() != pdFALSE )
+		{
+		}
+
+		ulDropped = ulDLogDropped;
+		if( ulDropped != ulReported )
+		{
+			printf( "dlog: %u messages dropped\r\n", ( unsigned ) ( ulDropped - ulReported ) );
+			ulReported = ulDropped;
+		}
+
+		vTaskDelay( pdMS_TO_TICKS( configDLOG_DRAIN_PERIOD_MS ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_DEFERRED_LOG == 1 ) */
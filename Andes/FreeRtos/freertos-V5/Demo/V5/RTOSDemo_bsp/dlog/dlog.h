@@ -0,0 +1,85 @@
+#ifndef DLOG_H
+#define DLOG_H
+
+/*
+ * Deferred logging.
+ *
+ * printf() in this BSP writes each character to the UART by polling, so a
+ * message costs the caller as long as the UART takes to send it, and printf()
+ * cannot be used from interrupts.  dlogPRINTF() instead stores a pointer to
+ * the format string and the argument values in a ring buffer, and a low
+ * priority drain task later passes them to printf().  A message costs its
+ * caller a compare and swap and a store per word, so dlogPRINTF() can be used
+ * from interrupts and from time critical loops, and messages from several
+ * tasks are printed whole instead of interleaved.
+ *
+ * Space for each record is reserved by a compare and swap on the head of the
+ * ring, so tasks and interrupts write without taking a lock or masking
+ * interrupts, and the format is written last to publish the record.  When the
+ * ring is full the message is dropped and counted, and the drain task reports
+ * the number dropped.  The drain task stops at a record that a task it
+ * preempted is still writing, and carries on from it once that task has run.
+ *
+ * Because the message is formatted later:
+ *
+ * + The format and any string passed for %s must remain valid until the
+ *   message has been printed, so should be string literals or other constant
+ *   data.
+ *
+ * + Each argument is stored as a uintptr_t, so pointers must be cast to
+ *   uintptr_t.  The drain task casts each argument back to the type its
+ *   conversion expects before passing it to printf(), so %d, %u and %x take
+ *   an int or unsigned int, the 'h', 'l', "ll" and 'z' length modifiers take
+ *   the matching types, and %s and %p take a pointer.  Floating point
+ *   arguments, and 64-bit arguments on RV32, cannot be printed.
+ */
+
+#if( configUSE_DEFERRED_LOG == 1 )
+
+/* Words in the ring buffer, a power of two.  Each message takes
+dlogHEADER_WORDS plus one per argument. */
+#ifndef configDLOG_BUFFER_WORDS
+	#define configDLOG_BUFFER_WORDS			( 1024 )
+#endif
+
+/* The drain task prints the messages that have been written at this period. */
+#ifndef configDLOG_DRAIN_PERIOD_MS
+	#define configDLOG_DRAIN_PERIOD_MS		( 20 )
+#endif
+
+#ifndef configDLOG_DRAIN_PRIORITY
+	#define configDLOG_DRAIN_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#endif
+
+#ifndef configDLOG_DRAIN_STACK_SIZE
+	#define configDLOG_DRAIN_STACK_SIZE		( configMINIMAL_STACK_SIZE )
+#endif
+
+/* The most arguments a message can have. */
+#define dlogMAX_ARGS						( 6 )
+
+/* Words of each record before its arguments: the format and the number of
+arguments. */
+#define dlogHEADER_WORDS					( 2 )
+
+/*
+ * Write a message to be printed by the drain task.  Can be called from tasks
+ * and interrupts, with the scheduler running or not.
+ *
+ *   dlogPRINTF( "rx %u bytes to %p\r\n", ( unsigned ) xLength, ( uintptr_t ) pvBuffer );
+ */
+#define dlogPRINTF( pcFormat, ... )																		\
+	do																									\
+	{																									\
+	const uintptr_t uxDLogArgs[] = { 0, ##__VA_ARGS__ };												\
+																										\
+		( void ) xDLogWrite( ( pcFormat ), &( uxDLogArgs[ 1 ] ), ( sizeof( uxDLogArgs ) / sizeof( uxDLogArgs[ 0 ] ) ) - 1 );	\
+	} while( 0 )
+
+/* Public API of dlog.c */
+BaseType_t xDLogInit( void );
+BaseType_t xDLogWrite( const char *pcFormat, const uintptr_t *puxArgs, UBaseType_t uxArgs );
+uint32_t ulDLogGetDropped( void );
+
+#endif /* ( configUSE_DEFERRED_LOG == 1 ) */
+#endif /* DLOG_H */
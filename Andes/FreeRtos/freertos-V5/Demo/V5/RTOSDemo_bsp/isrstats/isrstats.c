@@ -0,0 +1,245 @@
+#include "FreeRTOS.h"
+
+#if( configUSE_ISR_STATS == 1 )
+
+#include <stdio.h>
+#include <string.h>
+
+#include "task.h"
+#include "isrstats.h"
+
+#define prvSEND_MAX_EVENTS	( ( configUSE_ANDES_TRACER == 1 ) && ( configTRACER_KERNEL_OBJECT_EVENTS == 1 ) )
+
+/* Index of each measure's bit in ulNewMax. */
+#define prvNEW_MAX( xMeasure )		( 1UL << ( xMeasure ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Add ulCycles to pxHistogram, returning pdTRUE if it is a new maximum.
+ */
+static BaseType_t prvRecord( IsrStatsHistogram_t *pxHistogram, uint32_t ulCycles );
+
+/*
+ * Record the duration and wake latency of the interrupt being handled, then
+ * send any new maxima to the tracer.
+ */
+static void prvExit( uint32_t ulExit );
+
+/*-----------------------------------------------------------*/
+
+/* mcycle on entry to freertos_risc_v_trap_handler, written by portASM.S. */
+volatile uint32_t ulIsrStatsTrapCycle;
+
+static IsrStats_t xIsrStats[ configISR_STATS_NUM_IRQS ];
+
+/* The interrupt being handled. */
+static UBaseType_t uxCurrentIrq;
+static uint32_t ulEnterCycle;
+static TaskHandle_t xInterruptedTask;
+static uint32_t ulNewMax;
+
+#if( configUSE_TICKLESS_IDLE == 0 )
+	extern uint64_t ullNextTime;
+	extern const size_t uxTimerIncrementsForOneTick;
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vIsrStatsGet( UBaseType_t uxIrq, IsrStats_t *pxStats )
+{
+	configASSERT( uxIrq < configISR_STATS_NUM_IRQS );
+
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xIsrStats[ uxIrq ];
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vIsrStatsReset( void )
+{
+	taskENTER_CRITICAL();
+	{
+		memset( xIsrStats, 0, sizeof( xIsrStats ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vIsrStatsPrint( void )
+{
+static IsrStats_t xStats;
+static const char * const pcMeasures[] = { "entry", "duration", "wake" };
+const IsrStatsHistogram_t * const pxHistograms[] = { &( xStats.xEntry ), &( xStats.xDuration ), &( xStats.xWake ) };
+const IsrStatsHistogram_t *pxHistogram;
+UBaseType_t uxIrq, uxMeasure, uxBucket;
+
+	printf( "IRQ  measure        count         max  histogram (log2 cycles: count)\r\n" );
+	for( uxIrq = 0; uxIrq < configISR_STATS_NUM_IRQS; uxIrq++ )
+	{
+		vIsrStatsGet( uxIrq, &xStats );
+		if( xStats.xEntry.ulCount == 0 )
+		{
+			continue;
+		}
+
+		for( uxMeasure = 0; uxMeasure < ( sizeof( pxHistograms ) / sizeof( pxHistograms[ 0 ] ) ); uxMeasure++ )
+		{
+			pxHistogram = pxHistograms[ uxMeasure ];
+
+			if( uxIrq == isrstatsTICK_IRQ )
+			{
+				printf( "tick %-9s %10lu %11lu ", pcMeasures[ uxMeasure ], ( unsigned long ) pxHistogram->ulCount, ( unsigned long ) pxHistogram->ulMax );
+			}
+			else
+			{
+				printf( "%4lu %-9s %10lu %11lu ", ( unsigned long ) uxIrq, pcMeasures[ uxMeasure ], ( unsigned long ) pxHistogram->ulCount, ( unsigned long ) pxHistogram->ulMax );
+			}
+
+			for( uxBucket = 0; uxBucket < configISR_STATS_BUCKETS; uxBucket++ )
+			{
+				if( pxHistogram->ulBuckets[ uxBucket ] != 0 )
+				{
+					printf( " %lu:%lu", ( unsigned long ) uxBucket, ( unsigned long ) pxHistogram->ulBuckets[ uxBucket ] );
+				}
+			}
+			printf( "\r\n" );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vIsrStatsEnter( UBaseType_t uxIrq )
+{
+const uint32_t ulEnter = portGET_CYCLE_COUNT();
+
+	uxCurrentIrq = uxIrq;
+	ulEnterCycle = ulEnter;
+	xInterruptedTask = xTaskGetCurrentTaskHandle();
+	ulNewMax = 0;
+
+	if( uxIrq < configISR_STATS_NUM_IRQS )
+	{
+		if( prvRecord( &( xIsrStats[ uxIrq ].xEntry ), ulEnter - ulIsrStatsTrapCycle ) != pdFALSE )
+		{
+			ulNewMax |= prvNEW_MAX( isrstatsMEASURE_ENTRY );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vIsrStatsExit( void )
+{
+	prvExit( portGET_CYCLE_COUNT() );
+}
+/*-----------------------------------------------------------*/
+
+void vIsrStatsTickEnter( void )
+{
+const uint32_t ulEnter = portGET_CYCLE_COUNT();
+uint32_t ulLatency;
+
+	#if( configUSE_TICKLESS_IDLE == 0 )
+	{
+	const volatile uint32_t * const pulMtimeLow = ( const volatile uint32_t * ) ( configMTIME_BASE_ADDRESS );
+
+		/* portASM.S has already written ullNextTime to mtimecmp and moved
+		ullNextTime on by a tick, so the compare value that raised this tick
+		is two ticks before ullNextTime. */
+		ulLatency = *pulMtimeLow - ( ( uint32_t ) ullNextTime - ( 2UL * ( uint32_t ) uxTimerIncrementsForOneTick ) );
+	}
+	#else
+	{
+		/* Tickless idle moves ullNextTime, so only the time since the trap
+		was taken is known. */
+		ulLatency = ulEnter - ulIsrStatsTrapCycle;
+	}
+	#endif
+
+	uxCurrentIrq = isrstatsTICK_IRQ;
+	ulEnterCycle = ulEnter;
+	xInterruptedTask = xTaskGetCurrentTaskHandle();
+	ulNewMax = 0;
+
+	if( prvRecord( &( xIsrStats[ isrstatsTICK_IRQ ].xEntry ), ulLatency ) != pdFALSE )
+	{
+		ulNewMax |= prvNEW_MAX( isrstatsMEASURE_ENTRY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vIsrStatsTickExit( void )
+{
+	prvExit( portGET_CYCLE_COUNT() );
+}
+/*-----------------------------------------------------------*/
+
+static void prvExit( uint32_t ulExit )
+{
+IsrStats_t *pxStats;
+
+	if( uxCurrentIrq >= configISR_STATS_NUM_IRQS )
+	{
+		return;
+	}
+
+	pxStats = &( xIsrStats[ uxCurrentIrq ] );
+
+	if( prvRecord( &( pxStats->xDuration ), ulExit - ulEnterCycle ) != pdFALSE )
+	{
+		ulNewMax |= prvNEW_MAX( isrstatsMEASURE_DURATION );
+	}
+
+	if( xTaskGetCurrentTaskHandle() != xInterruptedTask )
+	{
+		if( prvRecord( &( pxStats->xWake ), ulExit - ulIsrStatsTrapCycle ) != pdFALSE )
+		{
+			ulNewMax |= prvNEW_MAX( isrstatsMEASURE_WAKE );
+		}
+	}
+
+	#if( prvSEND_MAX_EVENTS )
+	{
+		if( ( ulNewMax & prvNEW_MAX( isrstatsMEASURE_ENTRY ) ) != 0 )
+		{
+			vRtosTracerIsrLatencyMax( isrstatsMEASURE_ENTRY, pxStats->xEntry.ulMax, uxCurrentIrq );
+		}
+		if( ( ulNewMax & prvNEW_MAX( isrstatsMEASURE_DURATION ) ) != 0 )
+		{
+			vRtosTracerIsrLatencyMax( isrstatsMEASURE_DURATION, pxStats->xDuration.ulMax, uxCurrentIrq );
+		}
+		if( ( ulNewMax & prvNEW_MAX( isrstatsMEASURE_WAKE ) ) != 0 )
+		{
+			vRtosTracerIsrLatencyMax( isrstatsMEASURE_WAKE, pxStats->xWake.ulMax, uxCurrentIrq );
+		}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRecord( IsrStatsHistogram_t *pxHistogram, uint32_t ulCycles )
+{
+UBaseType_t uxBucket;
+
+	uxBucket = ( ulCycles > 1UL ) ? ( UBaseType_t ) ( 31 - __builtin_clz( ulCycles ) ) : 0;
+	if( uxBucket >= configISR_STATS_BUCKETS )
+	{
+		uxBucket = configISR_STATS_BUCKETS - 1;
+	}
+
+	pxHistogram->ulBuckets[ uxBucket ]++;
+	pxHistogram->ulCount++;
+
+	if( ulCycles > pxHistogram->ulMax )
+	{
+		pxHistogram->ulMax = ulCycles;
+		return pdTRUE;
+	}
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_ISR_STATS == 1 ) */
@@ -0,0 +1,84 @@
+#ifndef ISRSTATS_H
+#define ISRSTATS_H
+
+/*
+ * Interrupt latency and duration statistics.
+ *
+ * For the tick and for each PLIC interrupt source the following are kept as a
+ * count, a maximum and a power of two histogram, all in CPU cycles:
+ *
+ * + Entry latency: from the interrupt being raised to its handler being
+ *   called.  The tick is raised when mtime reaches mtimecmp, so its latency is
+ *   measured from that mtime value, which the port takes to count at
+ *   configCPU_CLOCK_HZ.  The time at which a PLIC source is raised cannot be
+ *   read, so its latency is measured from the first instructions of
+ *   freertos_risc_v_trap_handler, after the trap has been taken and the
+ *   interrupted instruction has been abandoned.
+ *
+ * + Duration: from the handler being called to it returning, including any
+ *   context switch it requests.
+ *
+ * + Wake latency: from the start of the trap handler to the return from the
+ *   interrupt, counted only when the interrupt switched to another task.  This
+ *   is the time taken for an interrupt to run the task it woke.
+ *
+ * portASM.S records mcycle on trap entry and calls vIsrStatsTickEnter() and
+ * vIsrStatsTickExit() around the tick.  mext_interrupt() in interrupt.c calls
+ * vIsrStatsEnter() and vIsrStatsExit() around the handler of each claimed
+ * source.  Interrupts do not nest, so one set of timestamps is enough.
+ *
+ * With the Andes RTOS Tracer, each new maximum is also sent as an
+ * ISR_LATENCY_MAX event once the interrupt has been measured, so the time to
+ * send it is not part of the measurement.
+ */
+
+#if( configUSE_ISR_STATS == 1 )
+
+/* Statistics are kept for PLIC sources below this number.  Source 0 is never
+claimed from the PLIC, so its entry holds the tick. */
+#ifndef configISR_STATS_NUM_IRQS
+	#define configISR_STATS_NUM_IRQS		( 32 )
+#endif
+
+/* Buckets of each histogram.  Bucket n counts times of 2^n to 2^(n+1) - 1
+cycles, bucket 0 also counts 0, and the last bucket also counts all longer
+times. */
+#ifndef configISR_STATS_BUCKETS
+	#define configISR_STATS_BUCKETS			( 16 )
+#endif
+
+/* Index of the tick in the statistics. */
+#define isrstatsTICK_IRQ					( 0 )
+
+/* Measures, as sent in the type field of the ISR_LATENCY_MAX tracer event. */
+#define isrstatsMEASURE_ENTRY				( 0 )
+#define isrstatsMEASURE_DURATION			( 1 )
+#define isrstatsMEASURE_WAKE				( 2 )
+
+typedef struct IsrStatsHistogram
+{
+	uint32_t ulCount;
+	uint32_t ulMax;
+	uint32_t ulBuckets[ configISR_STATS_BUCKETS ];
+} IsrStatsHistogram_t;
+
+typedef struct IsrStats
+{
+	IsrStatsHistogram_t xEntry;
+	IsrStatsHistogram_t xDuration;
+	IsrStatsHistogram_t xWake;
+} IsrStats_t;
+
+/* Public API of isrstats.c */
+void vIsrStatsGet( UBaseType_t uxIrq, IsrStats_t *pxStats );
+void vIsrStatsReset( void );
+void vIsrStatsPrint( void );
+
+/* Called by the port and the interrupt dispatcher only. */
+void vIsrStatsEnter( UBaseType_t uxIrq );
+void vIsrStatsExit( void );
+void vIsrStatsTickEnter( void );
+void vIsrStatsTickExit( void );
+
+#endif /* ( configUSE_ISR_STATS == 1 ) */
+#endif /* ISRSTATS_H */
@@ -0,0 +1,243 @@
+#include "FreeRTOS.h"
+
+#if( configUSE_PC_PROFILER == 1 )
+
+#include <stddef.h>
+
+#include "task.h"
+#include "platform.h"
+#include "cache.h"
+#include "profiler.h"
+
+/*
+ * Macros for the context saved by freertos_risc_v_trap_handler in portASM.S.
+ *
+ * pxTopOfStack, the first member of the TCB, points to the chip specific
+ * registers, as portasmADDITIONAL_CONTEXT_SIZE in the Andes V5
+ * freertos_risc_v_chip_specific_extensions.h, followed by x1 and x5 to x31.
+ */
+#ifdef __riscv_flen
+	#define prvFPU_CONTEXT_WORDS		( 1 + ( 32 * ( __riscv_flen / 8 ) ) / sizeof( uintptr_t ) )
+#else
+	#define prvFPU_CONTEXT_WORDS		( 1 )
+#endif
+#define prvADDITIONAL_CONTEXT_WORDS		( 2 + prvFPU_CONTEXT_WORDS )
+#define prvCONTEXT_FP					( prvADDITIONAL_CONTEXT_WORDS + 5 )	/* x8, s0/fp */
+
+/* Macros for the PIT channel registers. */
+#define prvPIT_CH_MODE_TIMER32			( 1 )
+#define prvPIT_CH_CLK_PCLK				( 1 << 3 )
+#define prvPIT_CFG_NUM_CHANNELS			( 0x7 )
+#define prvPIT_CHANNEL_BIT				( 1UL << ( configPROFILER_PIT_CHANNEL * 4 ) )
+#define prvPIT_RELOAD					( ( PCLKFREQ / configPROFILER_SAMPLE_HZ ) - 1 )
+
+#if( configPROFILER_USE_TICK == 1 )
+	#define prvSAMPLE_HZ				( configTICK_RATE_HZ )
+#else
+	#define prvSAMPLE_HZ				( configPROFILER_SAMPLE_HZ )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Record the name of the task the first time it is sampled.
+ */
+static void prvAddTask( TaskHandle_t xTask );
+
+/*-----------------------------------------------------------*/
+
+ProfilerBuffer_t xProfilerBuffer;
+
+static volatile BaseType_t xProfilerEnabled = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xProfilerInit( void )
+{
+	#if( configPROFILER_USE_TICK == 0 )
+	{
+		if( ( DEV_PIT->CFG & prvPIT_CFG_NUM_CHANNELS ) <= configPROFILER_PIT_CHANNEL )
+		{
+			return pdFAIL;
+		}
+	}
+	#endif
+
+	xProfilerBuffer.ulMagic = 0;
+	xProfilerBuffer.ucVersion = profilerVERSION;
+	xProfilerBuffer.ucPointerSize = sizeof( uintptr_t );
+	xProfilerBuffer.ucDepth = configPROFILER_BACKTRACE_DEPTH;
+	xProfilerBuffer.ucNameLength = configMAX_TASK_NAME_LEN;
+	xProfilerBuffer.ulSampleHz = prvSAMPLE_HZ;
+	xProfilerBuffer.ulCapacity = configPROFILER_BUFFER_SAMPLES;
+	xProfilerBuffer.ulHead = 0;
+	xProfilerBuffer.ulCount = 0;
+	xProfilerBuffer.ulMaxTasks = configPROFILER_MAX_TASKS;
+	xProfilerBuffer.ulNumTasks = 0;
+	xProfilerBuffer.ulTaskIdOffset = offsetof( ProfilerBuffer_t, uxTaskIds );
+	xProfilerBuffer.ulTaskNameOffset = offsetof( ProfilerBuffer_t, cTaskNames );
+	xProfilerBuffer.ulSampleOffset = offsetof( ProfilerBuffer_t, uxSamples );
+	xProfilerBuffer.ulMagic = profilerMAGIC;
+
+	#if( configPROFILER_USE_TICK == 0 )
+	{
+		/* A 32-bit timer clocked by PCLK, started by vProfilerStart(). */
+		DEV_PIT->CHNEN &= ~prvPIT_CHANNEL_BIT;
+		DEV_PIT->CHANNEL[ configPROFILER_PIT_CHANNEL ].CTRL = prvPIT_CH_MODE_TIMER32 | prvPIT_CH_CLK_PCLK;
+		DEV_PIT->CHANNEL[ configPROFILER_PIT_CHANNEL ].RELOAD = prvPIT_RELOAD;
+		DEV_PIT->INTST = prvPIT_CHANNEL_BIT;
+		DEV_PIT->INTEN |= prvPIT_CHANNEL_BIT;
+
+		__nds__plic_set_priority( IRQ_PIT_SOURCE, 1 );
+		__nds__plic_enable_interrupt( IRQ_PIT_SOURCE );
+	}
+	#endif
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vProfilerStart( void )
+{
+	taskENTER_CRITICAL();
+	{
+		/* Each start begins a new profile. */
+		xProfilerBuffer.ulHead = 0;
+		xProfilerBuffer.ulCount = 0;
+		xProfilerBuffer.ulNumTasks = 0;
+		xProfilerEnabled = pdTRUE;
+
+		#if( configPROFILER_USE_TICK == 0 )
+		{
+			DEV_PIT->CHNEN |= prvPIT_CHANNEL_BIT;
+		}
+		#endif
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vProfilerStop( void )
+{
+	taskENTER_CRITICAL();
+	{
+		#if( configPROFILER_USE_TICK == 0 )
+		{
+			DEV_PIT->CHNEN &= ~prvPIT_CHANNEL_BIT;
+		}
+		#endif
+
+		xProfilerEnabled = pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+
+	/* The host reads the buffer from memory. */
+	#ifdef CFG_CACHE_ENABLE
+		nds_dcache_writeback_range( ( unsigned long ) &xProfilerBuffer, sizeof( xProfilerBuffer ) );
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vProfilerSample( void )
+{
+TaskHandle_t xTask;
+uintptr_t *puxSample;
+uint32_t ulHead;
+
+	if( xProfilerEnabled == pdFALSE )
+	{
+		return;
+	}
+
+	/* Interrupts do not nest, so the interrupted context is always a task, and
+	mepc is not written until the trap handler returns. */
+	xTask = xTaskGetCurrentTaskHandle();
+	ulHead = xProfilerBuffer.ulHead;
+	puxSample = &( xProfilerBuffer.uxSamples[ ulHead * profilerSAMPLE_WORDS ] );
+	puxSample[ 0 ] = read_csr( NDS_MEPC );
+	puxSample[ 1 ] = ( uintptr_t ) xTask;
+
+	#if( configPROFILER_BACKTRACE_DEPTH > 0 )
+	{
+	const uintptr_t *puxContext = *( const uintptr_t * const * ) xTask;
+	uintptr_t uxFrame = puxContext[ prvCONTEXT_FP ];
+	uintptr_t uxLow = ( uintptr_t ) puxContext;
+	const uintptr_t uxHigh = uxLow + configPROFILER_MAX_STACK_SPAN;
+	UBaseType_t x;
+
+		/* The return address and the caller's frame pointer are the two words
+		below the frame pointer.  Frames move up the stack, so the walk ends at
+		the first frame pointer that does not. */
+		for( x = 0; x < configPROFILER_BACKTRACE_DEPTH; x++ )
+		{
+			if( ( uxFrame <= uxLow ) || ( uxFrame > uxHigh ) || ( ( uxFrame & ( sizeof( uintptr_t ) - 1 ) ) != 0 ) )
+			{
+				break;
+			}
+
+			puxSample[ 2 + x ] = ( ( const uintptr_t * ) uxFrame )[ -1 ];
+			uxLow = uxFrame;
+			uxFrame = ( ( const uintptr_t * ) uxFrame )[ -2 ];
+		}
+
+		for( ; x < configPROFILER_BACKTRACE_DEPTH; x++ )
+		{
+			puxSample[ 2 + x ] = 0;
+		}
+	}
+	#endif
+
+	prvAddTask( xTask );
+
+	xProfilerBuffer.ulHead = ( ulHead + 1 == configPROFILER_BUFFER_SAMPLES ) ? 0 : ulHead + 1;
+	if( xProfilerBuffer.ulCount != UINT32_MAX )
+	{
+		xProfilerBuffer.ulCount++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddTask( TaskHandle_t xTask )
+{
+const uint32_t ulNumTasks = xProfilerBuffer.ulNumTasks;
+const char *pcName;
+uint32_t x;
+
+	for( x = 0; x < ulNumTasks; x++ )
+	{
+		if( xProfilerBuffer.uxTaskIds[ x ] == ( uintptr_t ) xTask )
+		{
+			return;
+		}
+	}
+
+	if( ulNumTasks < configPROFILER_MAX_TASKS )
+	{
+		pcName = pcTaskGetName( xTask );
+		for( x = 0; x < configMAX_TASK_NAME_LEN; x++ )
+		{
+			xProfilerBuffer.cTaskNames[ ulNumTasks ][ x ] = pcName[ x ];
+			if( pcName[ x ] == '\0' )
+			{
+				break;
+			}
+		}
+		xProfilerBuffer.cTaskNames[ ulNumTasks ][ configMAX_TASK_NAME_LEN - 1 ] = '\0';
+		xProfilerBuffer.uxTaskIds[ ulNumTasks ] = ( uintptr_t ) xTask;
+		xProfilerBuffer.ulNumTasks = ulNumTasks + 1;
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configPROFILER_USE_TICK == 0 )
+
+	void pit_irq_handler( void )
+	{
+		DEV_PIT->INTST = prvPIT_CHANNEL_BIT;
+		vProfilerSample();
+	}
+
+#endif /* configPROFILER_USE_TICK */
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_PC_PROFILER == 1 ) */
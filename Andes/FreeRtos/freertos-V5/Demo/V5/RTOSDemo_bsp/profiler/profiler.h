@@ -0,0 +1,111 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/*
+ * Statistical PC sampling profiler.
+ *
+ * Each sample records the PC the interrupted task was executing (mepc), the
+ * task, and optionally up to configPROFILER_BACKTRACE_DEPTH return addresses
+ * found by walking the task's frame pointer chain.  Samples are kept in a ring
+ * buffer, xProfilerBuffer, that the host dumps through the debugger, e.g.
+ *
+ *   (gdb) dump binary value profile.bin xProfilerBuffer
+ *
+ * and symbolizes against the ELF with Demo/Host_GCC/Profiler/profsym.
+ *
+ * Samples are taken from channel configPROFILER_PIT_CHANNEL of the PIT at
+ * configPROFILER_SAMPLE_HZ, or, if configPROFILER_USE_TICK is 1, by calling
+ * vProfilerSample() from the tick hook.  Sampling from the tick is simpler but
+ * misses work that is synchronised with the tick, so a sample rate that is not
+ * a multiple of the tick rate is preferred.
+ *
+ * Backtraces need the whole image to be built with frame pointers, see
+ * USE_FRAME_POINTER in the Makefile.  A sample taken in a function prologue or
+ * epilogue, before or after the frame pointer is set up, misses the caller of
+ * the sampled function.
+ */
+
+#if( configUSE_PC_PROFILER == 1 )
+
+/* Samples per second taken from the PIT. */
+#ifndef configPROFILER_SAMPLE_HZ
+	#define configPROFILER_SAMPLE_HZ		( 997 )
+#endif
+
+/* Sample from the tick hook instead of the PIT. */
+#ifndef configPROFILER_USE_TICK
+	#define configPROFILER_USE_TICK			0
+#endif
+
+/* PIT channel used for sampling, 0 to 3. */
+#ifndef configPROFILER_PIT_CHANNEL
+	#define configPROFILER_PIT_CHANNEL		( 3 )
+#endif
+
+/* Return addresses recorded with each sample.  0 records the PC only. */
+#ifndef configPROFILER_BACKTRACE_DEPTH
+	#define configPROFILER_BACKTRACE_DEPTH	( 0 )
+#endif
+
+/* Samples kept in the ring buffer, the oldest are overwritten first. */
+#ifndef configPROFILER_BUFFER_SAMPLES
+	#define configPROFILER_BUFFER_SAMPLES	( 1024 )
+#endif
+
+/* Tasks whose names are kept for the host.  Samples of further tasks are
+reported by handle. */
+#ifndef configPROFILER_MAX_TASKS
+	#define configPROFILER_MAX_TASKS		( 32 )
+#endif
+
+/* A frame pointer more than this many bytes above the interrupted context ends
+the backtrace, so a corrupt frame chain is not followed out of the stack. */
+#ifndef configPROFILER_MAX_STACK_SPAN
+	#define configPROFILER_MAX_STACK_SPAN	( 0x10000 )
+#endif
+
+/* Identifies xProfilerBuffer in a memory dump, see proffmt.h on the host. */
+#define profilerMAGIC						( 0x50534350UL )	/* "PCSP" in memory */
+#define profilerVERSION						( 1 )
+
+/* Words of each sample in uxSamples[]: the PC, the task handle and the return
+addresses, the unused ones 0. */
+#define profilerSAMPLE_WORDS				( 2 + configPROFILER_BACKTRACE_DEPTH )
+
+#ifndef __ASSEMBLER__
+	/*
+	 * The sample buffer read by the host.  Offsets are from the start of the
+	 * structure, so the host does not depend on the target's padding.
+	 */
+	typedef struct ProfilerBuffer
+	{
+		uint32_t ulMagic;				/* profilerMAGIC, once initialised. */
+		uint8_t ucVersion;				/* profilerVERSION. */
+		uint8_t ucPointerSize;			/* Bytes in a word of uxSamples[] and uxTaskIds[]. */
+		uint8_t ucDepth;				/* configPROFILER_BACKTRACE_DEPTH. */
+		uint8_t ucNameLength;			/* configMAX_TASK_NAME_LEN. */
+		uint32_t ulSampleHz;			/* Samples per second. */
+		uint32_t ulCapacity;			/* configPROFILER_BUFFER_SAMPLES. */
+		volatile uint32_t ulHead;		/* Index of the next sample written. */
+		volatile uint32_t ulCount;		/* Samples written, saturating. */
+		uint32_t ulMaxTasks;			/* configPROFILER_MAX_TASKS. */
+		volatile uint32_t ulNumTasks;	/* Entries used in uxTaskIds[] and cTaskNames[]. */
+		uint32_t ulTaskIdOffset;
+		uint32_t ulTaskNameOffset;
+		uint32_t ulSampleOffset;
+		uintptr_t uxTaskIds[ configPROFILER_MAX_TASKS ];
+		char cTaskNames[ configPROFILER_MAX_TASKS ][ configMAX_TASK_NAME_LEN ];
+		uintptr_t uxSamples[ configPROFILER_BUFFER_SAMPLES * profilerSAMPLE_WORDS ];
+	} ProfilerBuffer_t;
+
+	extern ProfilerBuffer_t xProfilerBuffer;
+
+	/* Public API of profiler.c */
+	BaseType_t xProfilerInit( void );
+	void vProfilerStart( void );
+	void vProfilerStop( void );
+	void vProfilerSample( void );
+#endif /* __ASSEMBLER__ */
+
+#endif /* ( configUSE_PC_PROFILER == 1 ) */
+#endif /* PROFILER_H */
@@ -7,9 +7,13 @@
 #include "transfer.h"
 #include "queue.h"
 #include "semphr.h"
+#include "heap_tracking.h"
 
 /*
  * Macros of Event ID
+ *
+ * Note: the event format is also decoded on the host by
+ * Demo/Host_GCC/TraceDecoder, keep tracefmt.h there in step with these.
  */
 
 /* System Events */
@@ -43,6 +47,39 @@
 #define prvEVT_ID_SEMAPHORE_TAKE_FROM_ISR	( 42u )
 #define prvEVT_ID_SEMAPHORE_GIVE			( 43u )
 #define prvEVT_ID_SEMAPHORE_GIVE_FROM_ISR	( 44u )
+#define prvEVT_ID_HEAP_STATS				( 45u )
+#define prvEVT_ID_HEAP_ALLOCATION			( 46u )
+#define prvEVT_ID_STREAM_BUFFER_CREATE		( 47u )
+#define prvEVT_ID_STREAM_BUFFER_DELETE		( 48u )
+#define prvEVT_ID_STREAM_BUFFER_RESET		( 49u )
+#define prvEVT_ID_STREAM_BUFFER_SEND		( 50u )
+#define prvEVT_ID_STREAM_BUFFER_SEND_FROM_ISR	( 51u )
+#define prvEVT_ID_STREAM_BUFFER_RECV		( 52u )
+#define prvEVT_ID_STREAM_BUFFER_RECV_FROM_ISR	( 53u )
+#define prvEVT_ID_EVENT_GROUP_CREATE		( 54u )
+#define prvEVT_ID_EVENT_GROUP_DELETE		( 55u )
+#define prvEVT_ID_EVENT_GROUP_SET_BITS		( 56u )
+#define prvEVT_ID_EVENT_GROUP_SET_BITS_FROM_ISR	( 57u )
+#define prvEVT_ID_EVENT_GROUP_CLEAR_BITS	( 58u )
+#define prvEVT_ID_EVENT_GROUP_CLEAR_BITS_FROM_ISR	( 59u )
+#define prvEVT_ID_EVENT_GROUP_WAIT_BITS		( 60u )
+#define prvEVT_ID_EVENT_GROUP_SYNC			( 61u )
+#define prvEVT_ID_TIMER_CREATE				( 62u )
+#define prvEVT_ID_TIMER_COMMAND_SEND		( 63u )
+#define prvEVT_ID_TIMER_COMMAND_RECV		( 64u )
+#define prvEVT_ID_TIMER_EXPIRED				( 65u )
+#define prvEVT_ID_TASK_NOTIFY				( 66u )
+#define prvEVT_ID_TASK_NOTIFY_FROM_ISR		( 67u )
+#define prvEVT_ID_TASK_NOTIFY_TAKE			( 68u )
+#define prvEVT_ID_TASK_NOTIFY_WAIT			( 69u )
+#define prvEVT_ID_TASK_PRIORITY_INHERIT		( 70u )
+#define prvEVT_ID_TASK_PRIORITY_DISINHERIT	( 71u )
+#define prvEVT_ID_MALLOC					( 72u )
+#define prvEVT_ID_FREE						( 73u )
+#define prvEVT_ID_ISR_LATENCY_MAX			( 74u )
+
+/* Number of heap blocks read at a time by vRtosTracerHeapReport() */
+#define prvHEAP_REPORT_BATCH_SIZE			( 8 )
 
 /* Max length of Task name */
 #define prvMAX_TASK_NAME_SIZE				( 256 )
@@ -72,6 +109,14 @@
 #define prvOP_FROM_TASK			( 0x0 << prvOP_CTX_SHIFT )
 #define prvOP_FROM_ISR			( 0x1 << prvOP_CTX_SHIFT )
 
+/* Macro of fields sent by kernel object events, in the order they are sent */
+#define prvFIELD_OBJECT			( 0x01 )	/* uintptr_t: object, task or address */
+#define prvFIELD_STATUS			( 0x02 )	/* uint8_t: API status */
+#define prvFIELD_TYPE			( 0x04 )	/* uint8_t: buffer kind, timer command or notify action */
+#define prvFIELD_PRIORITY		( 0x08 )	/* uint16_t: task priority */
+#define prvFIELD_VALUE			( 0x10 )	/* unsigned long: bytes, bits, ticks, size or value */
+#define prvFIELD_VALUE2			( 0x20 )	/* unsigned long: bits to wait for of EVENT_GROUP_SYNC */
+
 /* Macro of Context Type */
 #define prvCONTEXT_NONE			( 0 )
 #define prvCONTEXT_TASK			( 1 )
@@ -554,6 +599,9 @@ int xReturn;
 	{
 		ulBufferOverflow++;
 	}
+
+	/* Make the start info visible to the host without waiting for a batch. */
+	vFlushLogBuffer();
 }
 
 /* prvRtosTracerStart(): Start RTOS Tracer
@@ -599,6 +647,9 @@ int xReturn;
 	{
 		ulBufferOverflow++;
 	}
+
+	/* No more events follow, so publish the last batch. */
+	vFlushLogBuffer();
 }
 
 static void prvRtosTracerHandleStartFlag( void )
@@ -826,7 +877,22 @@ void vRtosTracerEnterTickISR( void )
 
 void vRtosTracerExitTickISR( void )
 {
+UBaseType_t uxSavedStatus;
+
 	vRtosTracerExitTrap();
+
+	/* Events wait at most one tick to be made visible to the host. */
+	uxSavedStatus = prvMIE_SAVE();
+	{
+		vFlushLogBuffer();
+	}
+	prvMIE_RESTORE( uxSavedStatus );
+}
+
+void vRtosTracerGetWriteCycles( uint32_t *pulUnbatchedCycles, uint32_t *pulBatchedCycles )
+{
+	*pulUnbatchedCycles = ulMeasureLogBufferWrite( 0 );
+	*pulBatchedCycles = ulMeasureLogBufferWrite( configTRACER_BATCH_SIZE );
 }
 
 void vRtosTracerTaskSwitchIn( void *pvTask )
@@ -1347,4 +1413,390 @@ UBaseType_t uxSavedStatus;
 	}
 	prvMIE_RESTORE( uxSavedStatus );
 }
+
+#if( configTRACER_KERNEL_OBJECT_EVENTS == 1 )
+
+/* prvCreateEventObjectOp(): Send a kernel object event with the fields in
+ulFields, which are sent in the order of the prvFIELD_ bits. */
+static void prvCreateEventObjectOp( uint8_t ucEventId, uint32_t ulFields,
+	void *pvObject, uint8_t ucApiStatus, uint8_t ucType, uint16_t usPriority,
+	unsigned long uxValue, unsigned long uxValue2 )
+{
+UBaseType_t uxSavedStatus;
+
+	prvRtosTracerHandleHostControl();
+
+	uxSavedStatus = prvMIE_SAVE();
+	{
+		if( xTraceEnable )
+		{
+		EventData_t xEvent;
+		uint64_t ullEventTimestamp;
+		int xReturn;
+
+			xReturn = prvBufferOverflowEventSend();
+
+			if( xReturn == 0 )
+			{
+				prvEventInit( &xEvent, ucEventId, pucEventBuffer );
+
+				if( ulFields & prvFIELD_OBJECT )
+				{
+					prvEventAddFieldPtr( &xEvent, ( uintptr_t ) pvObject );
+				}
+				if( ulFields & prvFIELD_STATUS )
+				{
+					prvEventAddFieldU8( &xEvent, ucApiStatus );
+				}
+				if( ulFields & prvFIELD_TYPE )
+				{
+					prvEventAddFieldU8( &xEvent, ucType );
+				}
+				if( ulFields & prvFIELD_PRIORITY )
+				{
+					prvEventAddFieldU16( &xEvent, usPriority );
+				}
+				if( ulFields & prvFIELD_VALUE )
+				{
+					prvEventAddFieldULong( &xEvent, uxValue );
+				}
+				if( ulFields & prvFIELD_VALUE2 )
+				{
+					prvEventAddFieldULong( &xEvent, uxValue2 );
+				}
+
+				prvEventAddTimestamp( &xEvent, &ullEventTimestamp );
+				xReturn = prvEventSend( &xEvent );
+				if( xReturn == 0 )
+				{
+					ullLastEventTimestamp = ullEventTimestamp;
+				}
+				else
+				{
+					ulBufferOverflow++;
+				}
+			}
+		}
+	}
+	prvMIE_RESTORE( uxSavedStatus );
+}
+
+void vRtosTracerStreamBufferCreate( void *pvStreamBuffer, uint8_t ucIsMessageBuffer )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_CREATE, prvFIELD_OBJECT | prvFIELD_TYPE,
+		pvStreamBuffer, 0, ucIsMessageBuffer, 0, 0, 0 );
+}
+
+void vRtosTracerStreamBufferDelete( void *pvStreamBuffer )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_DELETE, prvFIELD_OBJECT,
+		pvStreamBuffer, 0, 0, 0, 0, 0 );
+}
+
+void vRtosTracerStreamBufferReset( void *pvStreamBuffer )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_RESET, prvFIELD_OBJECT,
+		pvStreamBuffer, 0, 0, 0, 0, 0 );
+}
+
+void vRtosTracerStreamBufferSend( void *pvStreamBuffer, uint8_t ucApiStatus,
+	uint8_t ucIsMessageBuffer, unsigned long uxBytes )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_SEND, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvStreamBuffer, ucApiStatus, ucIsMessageBuffer, 0, uxBytes, 0 );
+}
+
+void vRtosTracerStreamBufferRecv( void *pvStreamBuffer, uint8_t ucApiStatus,
+	uint8_t ucIsMessageBuffer, unsigned long uxBytes )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_RECV, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvStreamBuffer, ucApiStatus, ucIsMessageBuffer, 0, uxBytes, 0 );
+}
+
+void vRtosTracerStreamBufferSendFromISR( void *pvStreamBuffer, uint8_t ucApiStatus,
+	uint8_t ucIsMessageBuffer, unsigned long uxBytes )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_SEND_FROM_ISR, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvStreamBuffer, ucApiStatus, ucIsMessageBuffer, 0, uxBytes, 0 );
+}
+
+void vRtosTracerStreamBufferRecvFromISR( void *pvStreamBuffer, uint8_t ucApiStatus,
+	uint8_t ucIsMessageBuffer, unsigned long uxBytes )
+{
+	prvCreateEventObjectOp( prvEVT_ID_STREAM_BUFFER_RECV_FROM_ISR, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvStreamBuffer, ucApiStatus, ucIsMessageBuffer, 0, uxBytes, 0 );
+}
+
+void vRtosTracerEventGroupCreate( void *pvEventGroup )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_CREATE, prvFIELD_OBJECT,
+		pvEventGroup, 0, 0, 0, 0, 0 );
+}
+
+void vRtosTracerEventGroupDelete( void *pvEventGroup )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_DELETE, prvFIELD_OBJECT,
+		pvEventGroup, 0, 0, 0, 0, 0 );
+}
+
+void vRtosTracerEventGroupSetBits( void *pvEventGroup, unsigned long uxBits )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_SET_BITS, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvEventGroup, 0, 0, 0, uxBits, 0 );
+}
+
+void vRtosTracerEventGroupSetBitsFromISR( void *pvEventGroup, unsigned long uxBits )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_SET_BITS_FROM_ISR, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvEventGroup, 0, 0, 0, uxBits, 0 );
+}
+
+void vRtosTracerEventGroupClearBits( void *pvEventGroup, unsigned long uxBits )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_CLEAR_BITS, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvEventGroup, 0, 0, 0, uxBits, 0 );
+}
+
+void vRtosTracerEventGroupClearBitsFromISR( void *pvEventGroup, unsigned long uxBits )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_CLEAR_BITS_FROM_ISR, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvEventGroup, 0, 0, 0, uxBits, 0 );
+}
+
+void vRtosTracerEventGroupWaitBits( void *pvEventGroup, uint8_t ucApiStatus,
+	unsigned long uxBitsToWaitFor )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_WAIT_BITS, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_VALUE,
+		pvEventGroup, ucApiStatus, 0, 0, uxBitsToWaitFor, 0 );
+}
+
+void vRtosTracerEventGroupSync( void *pvEventGroup, uint8_t ucApiStatus,
+	unsigned long uxBitsToSet, unsigned long uxBitsToWaitFor )
+{
+	prvCreateEventObjectOp( prvEVT_ID_EVENT_GROUP_SYNC, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_VALUE | prvFIELD_VALUE2,
+		pvEventGroup, ucApiStatus, 0, 0, uxBitsToSet, uxBitsToWaitFor );
+}
+
+void vRtosTracerTimerCreate( void *pvTimer, unsigned long xPeriod, const char *pcTimerName )
+{
+	/* Timers are not in the queue registry, so name them as they are
+	created. */
+	if( pcTimerName != NULL )
+	{
+		vRtosTracerQueueRegistryAdd( pvTimer, pcTimerName );
+	}
+
+	prvCreateEventObjectOp( prvEVT_ID_TIMER_CREATE, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvTimer, 0, 0, 0, xPeriod, 0 );
+}
+
+void vRtosTracerTimerCommandSend( void *pvTimer, uint8_t ucApiStatus,
+	uint8_t ucCommand, unsigned long xValue )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TIMER_COMMAND_SEND, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvTimer, ucApiStatus, ucCommand, 0, xValue, 0 );
+}
+
+void vRtosTracerTimerCommandRecv( void *pvTimer, uint8_t ucCommand, unsigned long xValue )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TIMER_COMMAND_RECV, prvFIELD_OBJECT | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvTimer, 0, ucCommand, 0, xValue, 0 );
+}
+
+void vRtosTracerTimerExpired( void *pvTimer )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TIMER_EXPIRED, prvFIELD_OBJECT,
+		pvTimer, 0, 0, 0, 0, 0 );
+}
+
+void vRtosTracerTaskNotify( void *pvTask, uint8_t ucApiStatus, uint8_t ucAction,
+	unsigned long ulValue )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TASK_NOTIFY, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvTask, ucApiStatus, ucAction, 0, ulValue, 0 );
+}
+
+void vRtosTracerTaskNotifyFromISR( void *pvTask, uint8_t ucApiStatus, uint8_t ucAction,
+	unsigned long ulValue )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TASK_NOTIFY_FROM_ISR, prvFIELD_OBJECT | prvFIELD_STATUS | prvFIELD_TYPE | prvFIELD_VALUE,
+		pvTask, ucApiStatus, ucAction, 0, ulValue, 0 );
+}
+
+void vRtosTracerTaskNotifyTake( uint8_t ucApiStatus, unsigned long xTicksToWait )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TASK_NOTIFY_TAKE, prvFIELD_STATUS | prvFIELD_VALUE,
+		NULL, ucApiStatus, 0, 0, xTicksToWait, 0 );
+}
+
+void vRtosTracerTaskNotifyWait( uint8_t ucApiStatus, unsigned long xTicksToWait )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TASK_NOTIFY_WAIT, prvFIELD_STATUS | prvFIELD_VALUE,
+		NULL, ucApiStatus, 0, 0, xTicksToWait, 0 );
+}
+
+void vRtosTracerTaskPriorityInherit( void *pvTask, uint16_t usPriority )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TASK_PRIORITY_INHERIT, prvFIELD_OBJECT | prvFIELD_PRIORITY,
+		pvTask, 0, 0, usPriority, 0, 0 );
+}
+
+void vRtosTracerTaskPriorityDisinherit( void *pvTask, uint16_t usPriority )
+{
+	prvCreateEventObjectOp( prvEVT_ID_TASK_PRIORITY_DISINHERIT, prvFIELD_OBJECT | prvFIELD_PRIORITY,
+		pvTask, 0, 0, usPriority, 0, 0 );
+}
+
+void vRtosTracerMalloc( void *pvAddress, unsigned long uxSize )
+{
+	prvCreateEventObjectOp( prvEVT_ID_MALLOC, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvAddress, 0, 0, 0, uxSize, 0 );
+}
+
+void vRtosTracerFree( void *pvAddress, unsigned long uxSize )
+{
+	prvCreateEventObjectOp( prvEVT_ID_FREE, prvFIELD_OBJECT | prvFIELD_VALUE,
+		pvAddress, 0, 0, 0, uxSize, 0 );
+}
+
+void vRtosTracerIsrLatencyMax( uint8_t ucMeasure, unsigned long uxCycles, unsigned long uxIrq )
+{
+	prvCreateEventObjectOp( prvEVT_ID_ISR_LATENCY_MAX, prvFIELD_TYPE | prvFIELD_VALUE | prvFIELD_VALUE2,
+		NULL, 0, ucMeasure, 0, uxCycles, uxIrq );
+}
+
+#endif /* ( configTRACER_KERNEL_OBJECT_EVENTS == 1 ) */
+
+#if( configUSE_HEAP_TRACKING == 1 )
+
+/* prvHeapStatsEvent(): Send HEAP_STATS event
+Note: this API can only be called when IRQ is disabled */
+static void prvHeapStatsEvent( const HeapTrackingStats_t *pxStats )
+{
+EventData_t xEvent;
+uint64_t ullEventTimestamp;
+int xReturn;
+
+	if( prvBufferOverflowEventSend() )
+	{
+		return;
+	}
+
+	/* Length + Histograms + Counters, all 32-bit in HeapTrackingStats_t order */
+	uint8_t ucLength = 1 + sizeof( HeapTrackingStats_t );
+
+	prvEventInit( &xEvent, prvEVT_ID_HEAP_STATS, pucEventBuffer );
+	prvEventAddFieldU8( &xEvent, ucLength );
+	for( UBaseType_t i = 0; i < heaptrackHISTOGRAM_BUCKETS; i++ )
+	{
+		prvEventAddFieldU32( &xEvent, pxStats->ulSizeHistogram[ i ] );
+	}
+	for( UBaseType_t i = 0; i < heaptrackHISTOGRAM_BUCKETS; i++ )
+	{
+		prvEventAddFieldU32( &xEvent, pxStats->ulAllocationCycleHistogram[ i ] );
+	}
+	for( UBaseType_t i = 0; i < heaptrackHISTOGRAM_BUCKETS; i++ )
+	{
+		prvEventAddFieldU32( &xEvent, pxStats->ulFreeCycleHistogram[ i ] );
+	}
+	prvEventAddFieldU32( &xEvent, pxStats->ulMaximumAllocationCycles );
+	prvEventAddFieldU32( &xEvent, pxStats->ulMaximumFreeCycles );
+	prvEventAddFieldU32( &xEvent, pxStats->ulFailedAllocations );
+	prvEventAddFieldU32( &xEvent, pxStats->ulLargestFailedRequest );
+	prvEventAddFieldU32( &xEvent, pxStats->ulNextSequence );
+	prvEventAddTimestamp( &xEvent, &ullEventTimestamp );
+	xReturn = prvEventSend( &xEvent );
+	if( xReturn == 0 )
+	{
+		ullLastEventTimestamp = ullEventTimestamp;
+	}
+	else
+	{
+		ulBufferOverflow++;
+	}
+}
+
+/* prvHeapAllocationEvent(): Send HEAP_ALLOCATION event
+Note: this API can only be called when IRQ is disabled */
+static void prvHeapAllocationEvent( const HeapAllocation_t *pxAllocation )
+{
+EventData_t xEvent;
+uint64_t ullEventTimestamp;
+int xReturn;
+
+	if( prvBufferOverflowEventSend() )
+	{
+		return;
+	}
+
+	/* Length + Address + Size + Caller + Owner + Sequence */
+	uint8_t ucLength = 1 + ( 4 * sizeof( uintptr_t ) ) + 4;
+
+	prvEventInit( &xEvent, prvEVT_ID_HEAP_ALLOCATION, pucEventBuffer );
+	prvEventAddFieldU8( &xEvent, ucLength );
+	prvEventAddFieldPtr( &xEvent, ( uintptr_t ) pxAllocation->pvAddress );
+	prvEventAddFieldPtr( &xEvent, ( uintptr_t ) pxAllocation->xSize );
+	prvEventAddFieldPtr( &xEvent, ( uintptr_t ) pxAllocation->pvCaller );
+	prvEventAddFieldPtr( &xEvent, ( uintptr_t ) pxAllocation->xOwner );
+	prvEventAddFieldU32( &xEvent, pxAllocation->ulSequence );
+	prvEventAddTimestamp( &xEvent, &ullEventTimestamp );
+	xReturn = prvEventSend( &xEvent );
+	if( xReturn == 0 )
+	{
+		ullLastEventTimestamp = ullEventTimestamp;
+	}
+	else
+	{
+		ulBufferOverflow++;
+	}
+}
+
+/* vRtosTracerHeapReport(): Send the heap tracking histograms as a HEAP_STATS
+event, followed by a HEAP_ALLOCATION event for every allocated block with a
+sequence number of at least ulFromSequence.  Called by the application, not
+from a trace hook, as it walks the heap. */
+void vRtosTracerHeapReport( uint32_t ulFromSequence )
+{
+HeapTrackingStats_t xStats;
+HeapAllocation_t xAllocations[ prvHEAP_REPORT_BATCH_SIZE ];
+UBaseType_t uxSavedStatus, uxBlocks, uxSent = 0;
+
+	prvRtosTracerHandleHostControl();
+
+	if( xTraceEnable == pdFALSE )
+	{
+		return;
+	}
+
+	/* Read the heap with IRQ enabled, then send each batch with IRQ
+	disabled. */
+	vHeapTrackingGetStats( &xStats );
+
+	uxSavedStatus = prvMIE_SAVE();
+	{
+		if( xTraceEnable )
+		{
+			prvHeapStatsEvent( &xStats );
+		}
+	}
+	prvMIE_RESTORE( uxSavedStatus );
+
+	do
+	{
+		uxBlocks = uxPortGetHeapAllocations( xAllocations, prvHEAP_REPORT_BATCH_SIZE, uxSent, ulFromSequence );
+
+		uxSavedStatus = prvMIE_SAVE();
+		{
+			for( UBaseType_t i = 0; ( i < uxBlocks ) && xTraceEnable; i++ )
+			{
+				prvHeapAllocationEvent( &( xAllocations[ i ] ) );
+			}
+		}
+		prvMIE_RESTORE( uxSavedStatus );
+
+		uxSent += uxBlocks;
+	} while( uxBlocks == prvHEAP_REPORT_BATCH_SIZE );
+}
+
+#endif /* ( configUSE_HEAP_TRACKING == 1 ) */
 #endif /* ( configUSE_ANDES_TRACER == 1 ) */
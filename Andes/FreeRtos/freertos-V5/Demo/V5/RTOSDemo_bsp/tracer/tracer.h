@@ -20,6 +20,20 @@ Note: The size MUST be cache line size or multiple of it. */
 	#error "Couldn't define cache line size smaller than 32 byte."
 #endif
 
+/* Events are made visible to the host once this many bytes are waiting, and at
+every tick.  0 makes every event visible as it is written. */
+#ifndef configTRACER_BATCH_SIZE
+	#define configTRACER_BATCH_SIZE	( tracerCACHE_LINE_SIZE )
+#endif
+
+/* Trace stream buffer, message buffer, event group, software timer, task
+notification, priority inheritance, heap and interrupt latency maximum events as
+well as task, queue and semaphore events.  Set to 0 for a host that only decodes
+the latter. */
+#ifndef configTRACER_KERNEL_OBJECT_EVENTS
+	#define configTRACER_KERNEL_OBJECT_EVENTS	1
+#endif
+
 /* API status macro for trace hook */
 #define tracerAPI_STAT_SUCCESS		( 0u )
 #define tracerAPI_STAT_FAIL			( 1u )
@@ -49,6 +63,46 @@ Note: The size MUST be cache line size or multiple of it. */
 	void vRtosTracerQueueRecvFromISR( void *pvQueue, uint8_t ucApiStatus, uint8_t ucQueueType, uint8_t ucHigherPriorityTaskWoken );
 	void vRtosTracerQueuePeekFromISR( void *pvQueue, uint8_t ucApiStatus, uint8_t ucQueueType );
 	void vRtosTracerQueueRegistryAdd( void *pvQueue, const char *pcQueueName );
+
+	#if( configTRACER_KERNEL_OBJECT_EVENTS == 1 )
+		void vRtosTracerStreamBufferCreate( void *pvStreamBuffer, uint8_t ucIsMessageBuffer );
+		void vRtosTracerStreamBufferDelete( void *pvStreamBuffer );
+		void vRtosTracerStreamBufferReset( void *pvStreamBuffer );
+		void vRtosTracerStreamBufferSend( void *pvStreamBuffer, uint8_t ucApiStatus, uint8_t ucIsMessageBuffer, unsigned long uxBytes );
+		void vRtosTracerStreamBufferRecv( void *pvStreamBuffer, uint8_t ucApiStatus, uint8_t ucIsMessageBuffer, unsigned long uxBytes );
+		void vRtosTracerStreamBufferSendFromISR( void *pvStreamBuffer, uint8_t ucApiStatus, uint8_t ucIsMessageBuffer, unsigned long uxBytes );
+		void vRtosTracerStreamBufferRecvFromISR( void *pvStreamBuffer, uint8_t ucApiStatus, uint8_t ucIsMessageBuffer, unsigned long uxBytes );
+		void vRtosTracerEventGroupCreate( void *pvEventGroup );
+		void vRtosTracerEventGroupDelete( void *pvEventGroup );
+		void vRtosTracerEventGroupSetBits( void *pvEventGroup, unsigned long uxBits );
+		void vRtosTracerEventGroupSetBitsFromISR( void *pvEventGroup, unsigned long uxBits );
+		void vRtosTracerEventGroupClearBits( void *pvEventGroup, unsigned long uxBits );
+		void vRtosTracerEventGroupClearBitsFromISR( void *pvEventGroup, unsigned long uxBits );
+		void vRtosTracerEventGroupWaitBits( void *pvEventGroup, uint8_t ucApiStatus, unsigned long uxBitsToWaitFor );
+		void vRtosTracerEventGroupSync( void *pvEventGroup, uint8_t ucApiStatus, unsigned long uxBitsToSet, unsigned long uxBitsToWaitFor );
+		void vRtosTracerTimerCreate( void *pvTimer, unsigned long xPeriod, const char *pcTimerName );
+		void vRtosTracerTimerCommandSend( void *pvTimer, uint8_t ucApiStatus, uint8_t ucCommand, unsigned long xValue );
+		void vRtosTracerTimerCommandRecv( void *pvTimer, uint8_t ucCommand, unsigned long xValue );
+		void vRtosTracerTimerExpired( void *pvTimer );
+		void vRtosTracerTaskNotify( void *pvTask, uint8_t ucApiStatus, uint8_t ucAction, unsigned long ulValue );
+		void vRtosTracerTaskNotifyFromISR( void *pvTask, uint8_t ucApiStatus, uint8_t ucAction, unsigned long ulValue );
+		void vRtosTracerTaskNotifyTake( uint8_t ucApiStatus, unsigned long xTicksToWait );
+		void vRtosTracerTaskNotifyWait( uint8_t ucApiStatus, unsigned long xTicksToWait );
+		void vRtosTracerTaskPriorityInherit( void *pvTask, uint16_t usPriority );
+		void vRtosTracerTaskPriorityDisinherit( void *pvTask, uint16_t usPriority );
+		void vRtosTracerMalloc( void *pvAddress, unsigned long uxSize );
+		void vRtosTracerFree( void *pvAddress, unsigned long uxSize );
+		void vRtosTracerIsrLatencyMax( uint8_t ucMeasure, unsigned long uxCycles, unsigned long uxIrq );
+	#endif
+
+	#if( configUSE_HEAP_TRACKING == 1 )
+		void vRtosTracerHeapReport( uint32_t ulFromSequence );
+	#endif
+
+	/* Cycles taken to write an event to the log buffer, publishing each event
+	and publishing in batches of configTRACER_BATCH_SIZE bytes.  Can only be
+	called after xRtosTracerInit() and before the host starts tracing. */
+	void vRtosTracerGetWriteCycles( uint32_t *pulUnbatchedCycles, uint32_t *pulBatchedCycles );
 #endif /* __ASSEMBLER__ */
 
 /* Definition of FreeRTOS trace hook */
@@ -127,5 +181,127 @@ not using xTicksToWait in traceQUEUE_SEND() */
 #define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName ) \
 	vRtosTracerQueueRegistryAdd( xQueue, pcQueueName )
 
+#if( configTRACER_KERNEL_OBJECT_EVENTS == 1 )
+
+/* Stream and message buffers, expanded in stream_buffer.c */
+#define tracerIS_MESSAGE_BUFFER( xStreamBuffer ) \
+	( ( ( ( StreamBuffer_t * ) ( xStreamBuffer ) )->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0 )
+
+#define traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer ) \
+	vRtosTracerStreamBufferCreate( pxStreamBuffer, ( xIsMessageBuffer == pdTRUE ) )
+
+#define traceSTREAM_BUFFER_DELETE( xStreamBuffer ) \
+	vRtosTracerStreamBufferDelete( xStreamBuffer )
+
+#define traceSTREAM_BUFFER_RESET( xStreamBuffer ) \
+	vRtosTracerStreamBufferReset( xStreamBuffer )
+
+#define traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesSent ) \
+	vRtosTracerStreamBufferSend( xStreamBuffer, tracerAPI_STAT_SUCCESS, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), xBytesSent )
+
+#define traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer ) \
+	vRtosTracerStreamBufferSend( xStreamBuffer, tracerAPI_STAT_FAIL, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), 0 )
+
+#define traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer ) \
+	vRtosTracerStreamBufferSend( xStreamBuffer, tracerAPI_STAT_BLOCKING, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), 0 )
+
+#define traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent ) \
+	vRtosTracerStreamBufferSendFromISR( xStreamBuffer, ( xBytesSent > 0 ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), xBytesSent )
+
+#define traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength ) \
+	vRtosTracerStreamBufferRecv( xStreamBuffer, tracerAPI_STAT_SUCCESS, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), xReceivedLength )
+
+#define traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer ) \
+	vRtosTracerStreamBufferRecv( xStreamBuffer, tracerAPI_STAT_FAIL, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), 0 )
+
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer ) \
+	vRtosTracerStreamBufferRecv( xStreamBuffer, tracerAPI_STAT_BLOCKING, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), 0 )
+
+#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength ) \
+	vRtosTracerStreamBufferRecvFromISR( xStreamBuffer, ( xReceivedLength > 0 ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, tracerIS_MESSAGE_BUFFER( xStreamBuffer ), xReceivedLength )
+
+/* Event groups */
+#define traceEVENT_GROUP_CREATE( xEventGroup ) \
+	vRtosTracerEventGroupCreate( xEventGroup )
+
+#define traceEVENT_GROUP_DELETE( xEventGroup ) \
+	vRtosTracerEventGroupDelete( xEventGroup )
+
+#define traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet ) \
+	vRtosTracerEventGroupSetBits( xEventGroup, uxBitsToSet )
+
+#define traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet ) \
+	vRtosTracerEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet )
+
+#define traceEVENT_GROUP_CLEAR_BITS( xEventGroup, uxBitsToClear ) \
+	vRtosTracerEventGroupClearBits( xEventGroup, uxBitsToClear )
+
+#define traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear ) \
+	vRtosTracerEventGroupClearBitsFromISR( xEventGroup, uxBitsToClear )
+
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor ) \
+	vRtosTracerEventGroupWaitBits( xEventGroup, tracerAPI_STAT_BLOCKING, uxBitsToWaitFor )
+
+#define traceEVENT_GROUP_WAIT_BITS_END( xEventGroup, uxBitsToWaitFor, xTimeoutOccurred ) \
+	vRtosTracerEventGroupWaitBits( xEventGroup, ( xTimeoutOccurred ) ? tracerAPI_STAT_FAIL : tracerAPI_STAT_SUCCESS, uxBitsToWaitFor )
+
+#define traceEVENT_GROUP_SYNC_BLOCK( xEventGroup, uxBitsToSet, uxBitsToWaitFor ) \
+	vRtosTracerEventGroupSync( xEventGroup, tracerAPI_STAT_BLOCKING, uxBitsToSet, uxBitsToWaitFor )
+
+#define traceEVENT_GROUP_SYNC_END( xEventGroup, uxBitsToSet, uxBitsToWaitFor, xTimeoutOccurred ) \
+	vRtosTracerEventGroupSync( xEventGroup, ( xTimeoutOccurred ) ? tracerAPI_STAT_FAIL : tracerAPI_STAT_SUCCESS, uxBitsToSet, uxBitsToWaitFor )
+
+/* Software timers, expanded in timers.c */
+#define traceTIMER_CREATE( pxNewTimer ) \
+	vRtosTracerTimerCreate( pxNewTimer, pxNewTimer->xTimerPeriodInTicks, pxNewTimer->pcTimerName )
+
+#define traceTIMER_COMMAND_SEND( xTimer, xMessageID, xMessageValueValue, xReturn ) \
+	vRtosTracerTimerCommandSend( xTimer, ( xReturn == pdPASS ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, ( uint8_t ) xMessageID, xMessageValueValue )
+
+#define traceTIMER_COMMAND_RECEIVED( pxTimer, xMessageID, xMessageValue ) \
+	vRtosTracerTimerCommandRecv( pxTimer, ( uint8_t ) xMessageID, xMessageValue )
+
+#define traceTIMER_EXPIRED( pxTimer ) \
+	vRtosTracerTimerExpired( pxTimer )
+
+/* Task notifications, expanded in tasks.c.  The variables used are the locals
+and arguments of the functions that call the hooks. */
+#define traceTASK_NOTIFY() \
+	vRtosTracerTaskNotify( pxTCB, ( xReturn == pdPASS ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, ( uint8_t ) eAction, ulValue )
+
+#define traceTASK_NOTIFY_FROM_ISR() \
+	vRtosTracerTaskNotifyFromISR( pxTCB, ( xReturn == pdPASS ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, ( uint8_t ) eAction, ulValue )
+
+#define traceTASK_NOTIFY_GIVE_FROM_ISR() \
+	vRtosTracerTaskNotifyFromISR( pxTCB, tracerAPI_STAT_SUCCESS, ( uint8_t ) eIncrement, 0 )
+
+#define traceTASK_NOTIFY_TAKE_BLOCK() \
+	vRtosTracerTaskNotifyTake( tracerAPI_STAT_BLOCKING, xTicksToWait )
+
+#define traceTASK_NOTIFY_TAKE() \
+	vRtosTracerTaskNotifyTake( ( pxCurrentTCB->ulNotifiedValue != 0UL ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, xTicksToWait )
+
+#define traceTASK_NOTIFY_WAIT_BLOCK() \
+	vRtosTracerTaskNotifyWait( tracerAPI_STAT_BLOCKING, xTicksToWait )
+
+#define traceTASK_NOTIFY_WAIT() \
+	vRtosTracerTaskNotifyWait( ( pxCurrentTCB->ucNotifyState == taskNOTIFICATION_RECEIVED ) ? tracerAPI_STAT_SUCCESS : tracerAPI_STAT_FAIL, xTicksToWait )
+
+/* Mutex priority inheritance */
+#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority ) \
+	vRtosTracerTaskPriorityInherit( pxTCBOfMutexHolder, uxInheritedPriority )
+
+#define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority ) \
+	vRtosTracerTaskPriorityDisinherit( pxTCBOfMutexHolder, uxOriginalPriority )
+
+/* Heap */
+#define traceMALLOC( pvAddress, uiSize ) \
+	vRtosTracerMalloc( pvAddress, uiSize )
+
+#define traceFREE( pvAddress, uiSize ) \
+	vRtosTracerFree( pvAddress, uiSize )
+
+#endif /* ( configTRACER_KERNEL_OBJECT_EVENTS == 1 ) */
+
 #endif /* ( configUSE_ANDES_TRACER == 1 ) */
 #endif /* TRACE_H */
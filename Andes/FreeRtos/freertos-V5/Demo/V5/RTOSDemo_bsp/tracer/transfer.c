@@ -56,6 +56,11 @@
 #define prvMEMCPY( des, src, n )	__builtin_memcpy ( ( des ), ( src ), ( n ) )
 #define prvMEMSET( s, c, n )		__builtin_memset ( ( s ), ( c ), ( n ) )
 
+/* Macros for ulMeasureLogBufferWrite(): events written, and size of each event
+(a TASK_SWITCH_IN event with a two byte timestamp delta) */
+#define prvBENCHMARK_EVENTS			( 256 )
+#define prvBENCHMARK_EVENT_SIZE		( 1 + sizeof( uintptr_t ) + 2 )
+
 /* Macros for explicit conversion between pointer and integer. */
 #define prvPTR_TO_UINT( x )			( ( uintptr_t )( x ) )
 #define prvUINT_TO_PTR( x )			( ( void * )( uintptr_t )( x ) )
@@ -192,6 +197,12 @@ typedef struct
 	uintptr_t *puxLogHead;
 	/* Touched by host */
 	volatile uintptr_t *puxLogTail;
+	/* Target's own head, ahead of *puxLogHead by the events not yet published */
+	uintptr_t uxHead;
+	/* Tail when last read from the host, never ahead of *puxLogTail */
+	uintptr_t uxTail;
+	/* Unpublished bytes at which the head is published, 0 publishes every event */
+	uintptr_t uxBatchSize;
 } LogBufferManage_t;
 
 typedef struct
@@ -312,22 +323,6 @@ static portFORCE_INLINE void prvDcacheWritebackRangeCCTL( UBaseType_t uxBase, UB
 /*
  * Transfer Control Block implementation.
  */
-static portFORCE_INLINE BaseType_t prvIsRingBufferFull( uintptr_t uxHead, uintptr_t uxTail, uintptr_t uxSize )
-{
-	if( ( uxHead + 1 ) == uxTail )
-	{
-		return pdTRUE;
-	}
-	else if( ( ( uxHead + 1 ) == uxSize ) && ( uxTail == 0 ) )
-	{
-		return pdTRUE;
-	}
-	else
-	{
-		return pdFALSE;
-	}
-}
-
 static portFORCE_INLINE BaseType_t prvIsRingBufferEmpty( uintptr_t uxHead, uintptr_t uxTail )
 {
 	if( uxHead == uxTail )
@@ -351,88 +346,175 @@ static portFORCE_INLINE BaseType_t prvIsRingBufferEmpty( uintptr_t uxHead, uintp
  * the host-written buffer should be kicked out from cacheline immediately
  * and not in the cacheline at this time.
  */
-static BaseType_t prvWriteLogBuffer( LogBufferManage_t *pxLogBuf, uint8_t *pucData,
-	UBaseType_t uxSize )
+/* prvLogBufferFree(): Number of bytes that can be written at uxHead without
+reaching uxTail.  One byte is always left free, so head == tail means empty. */
+static portFORCE_INLINE uintptr_t prvLogBufferFree( uintptr_t uxHead, uintptr_t uxTail, uintptr_t uxSize )
 {
-BaseType_t xReturn;
-UBaseType_t uxSavedStatus;
-uint64_t ullBufStart;
-uintptr_t uxBufSize, uxHead, uxTail;
+	if( uxTail > uxHead )
+	{
+		return uxTail - uxHead - 1;
+	}
+	else
+	{
+		return uxSize - ( uxHead - uxTail ) - 1;
+	}
+}
 
-	ullBufStart = pxLogBuf->ullBufStart;
-	uxBufSize = pxLogBuf->uxBufSize;
+/* prvPublishLogBuffer(): Make the events written since the last publish
+visible to the host, with one writeback of the written bytes (two if they wrap)
+and one of the head pointer.
+Note: this API can only be called when IRQ is disabled */
+static void prvPublishLogBuffer( LogBufferManage_t *pxLogBuf )
+{
+uint64_t ullBufStart = pxLogBuf->ullBufStart;
+uintptr_t uxPublished = *( pxLogBuf->puxLogHead );
+uintptr_t uxHead = pxLogBuf->uxHead;
 
-	uxSavedStatus = prvMIE_SAVE();
+	if( uxPublished == uxHead )
 	{
-		uxHead = *( pxLogBuf->puxLogHead );
+		return;
+	}
+
+	if( uxPublished < uxHead )
+	{
+		prvDcacheWritebackRangeCCTL( ullBufStart + uxPublished, uxHead - uxPublished );
+	}
+	else
+	{
+		prvDcacheWritebackRangeCCTL( ullBufStart + uxPublished, pxLogBuf->uxBufSize - uxPublished );
+
+		if( uxHead != 0 )
+		{
+			prvDcacheWritebackRangeCCTL( ullBufStart, uxHead );
+		}
+	}
 
+	/* The host reads up to the head, so it is written after the events. */
+	*( pxLogBuf->puxLogHead ) = uxHead;
+	prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( pxLogBuf->puxLogHead ), 8 );
+}
+
+/* prvWriteLogBuffer(): Copy an event to the log buffer at the target's own
+head, which is only published to the host (see prvPublishLogBuffer()) once
+uxBatchSize bytes are waiting, so the cache maintenance is done per batch rather
+than per event.  The tail is only read from the host when the last value read
+leaves too little space, as the host only ever moves it forward.  An uxBatchSize
+of 0 publishes every event and reads the tail every time.
+Return: pdTRUE if written, pdFALSE if the log buffer is full.
+Note: this API can only be called when IRQ is disabled */
+static BaseType_t prvWriteLogBuffer( LogBufferManage_t *pxLogBuf, uint8_t *pucData,
+	UBaseType_t uxSize )
+{
+uint64_t ullBufStart = pxLogBuf->ullBufStart;
+uintptr_t uxBufSize = pxLogBuf->uxBufSize;
+uintptr_t uxHead = pxLogBuf->uxHead;
+uintptr_t uxFirstSize, uxPending;
+
+	if( ( pxLogBuf->uxBatchSize == 0 ) ||
+		( uxSize > prvLogBufferFree( uxHead, pxLogBuf->uxTail, uxBufSize ) ) )
+	{
 		/* Host-written buffer */
 		prvDcacheInvalidateAddrCCTL( prvPTR_TO_UINT( pxLogBuf->puxLogTail ) );
-		uxTail = *( pxLogBuf->puxLogTail );
+		pxLogBuf->uxTail = *( pxLogBuf->puxLogTail );
 
-		if( prvIsRingBufferFull( uxHead, uxTail, uxBufSize ) == pdTRUE )
+		if( uxSize > prvLogBufferFree( uxHead, pxLogBuf->uxTail, uxBufSize ) )
 		{
-			xReturn = pdFALSE;
+			return pdFALSE;
 		}
-		else if( uxTail <= uxHead )
+	}
+
+	if( ( uxHead + uxSize ) < uxBufSize )
+	{
+		prvMEMCPY( prvUINT_TO_PTR( ullBufStart + uxHead ), pucData, uxSize );
+		uxHead += uxSize;
+	}
+	else
+	{
+		uxFirstSize = uxBufSize - uxHead;
+		prvMEMCPY( prvUINT_TO_PTR( ullBufStart + uxHead ), pucData, uxFirstSize );
+		uxHead = uxSize - uxFirstSize;
+
+		if( uxHead != 0 )
 		{
-			if( ( uxHead + uxSize ) < uxBufSize )
-			{
-				prvMEMCPY( prvUINT_TO_PTR( ullBufStart + uxHead ), pucData, uxSize );
-				prvDcacheWritebackRangeCCTL( ullBufStart + uxHead, uxSize );
+			prvMEMCPY( prvUINT_TO_PTR( ullBufStart ), pucData + uxFirstSize, uxHead );
+		}
+	}
 
-				*( pxLogBuf->puxLogHead ) = uxHead + uxSize;
-				prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( pxLogBuf->puxLogHead ), 8 );
+	pxLogBuf->uxHead = uxHead;
 
-				xReturn = pdTRUE;
-			}
-			else if( ( ( uxHead + uxSize ) - uxBufSize ) < uxTail )
-			{
-			uintptr_t uxFirstSize = uxBufSize - uxHead;
-			uintptr_t uxSecondSize = uxSize - uxFirstSize;
+	uxPending = uxHead - *( pxLogBuf->puxLogHead );
+	if( uxHead < *( pxLogBuf->puxLogHead ) )
+	{
+		uxPending += uxBufSize;
+	}
 
-				prvMEMCPY( prvUINT_TO_PTR( ullBufStart + uxHead ), pucData, uxFirstSize );
-				prvDcacheWritebackRangeCCTL( ullBufStart + uxHead, uxFirstSize );
+	if( uxPending >= pxLogBuf->uxBatchSize )
+	{
+		prvPublishLogBuffer( pxLogBuf );
+	}
 
-				if( uxSecondSize != 0 )
-				{
-					prvMEMCPY( prvUINT_TO_PTR( ullBufStart ), pucData + uxFirstSize, uxSecondSize );
-					prvDcacheWritebackRangeCCTL( ullBufStart, uxSecondSize );
-				}
+	return pdTRUE;
+}
 
-				*( pxLogBuf->puxLogHead ) = uxSecondSize;
-				prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( pxLogBuf->puxLogHead ), 8 );
+BaseType_t xWriteLogBuffer( uint8_t *pucData, UBaseType_t uxSize )
+{
+	return prvWriteLogBuffer( &xLogBufferManage, pucData, uxSize );
+}
 
-				xReturn = pdTRUE;
-			}
-			else
+void vFlushLogBuffer( void )
+{
+	prvPublishLogBuffer( &xLogBufferManage );
+}
+
+uint32_t ulMeasureLogBufferWrite( UBaseType_t uxBatchSize )
+{
+static prvCACHE_ALIGN TargetBlockAlign_t xScratchTarget;
+static prvCACHE_ALIGN HostBlockAlign_t xScratchHost;
+LogBufferManage_t xScratch = xLogBufferManage;
+uint8_t ucEvent[ prvBENCHMARK_EVENT_SIZE ] = { 0 };
+UBaseType_t uxSavedStatus, uxEvent;
+unsigned long ulStart, ulEnd;
+uint32_t ulTotal = 0;
+
+	/* The events are written to the real log buffer, but at a scratch head
+	that is never published, so the host must not have been sent anything. */
+	if( ( *( xLogBufferManage.puxLogHead ) != 0 ) || ( xLogBufferManage.uxHead != 0 ) )
+	{
+		return 0;
+	}
+
+	xScratch.uxBatchSize = uxBatchSize;
+	xScratch.uxHead = 0;
+	xScratch.uxTail = 0;
+	xScratch.puxLogHead = ( uintptr_t * )xScratchTarget.xData.ucLogHead;
+	xScratch.puxLogTail = ( uintptr_t * )xScratchHost.xData.ucLogTail;
+	*( xScratch.puxLogHead ) = 0;
+	*( xScratch.puxLogTail ) = 0;
+	prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( xScratch.puxLogHead ), 8 );
+	prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( xScratch.puxLogTail ), 8 );
+
+	uxSavedStatus = prvMIE_SAVE();
+	{
+		for( uxEvent = 0; uxEvent < prvBENCHMARK_EVENTS; uxEvent++ )
+		{
+			/* Act as the host, reading everything published whenever the
+			buffer is half full.  Not timed. */
+			if( prvLogBufferFree( xScratch.uxHead, *( xScratch.puxLogTail ), xScratch.uxBufSize ) < ( xScratch.uxBufSize / 2 ) )
 			{
-				xReturn = pdFALSE;
+				*( xScratch.puxLogTail ) = *( xScratch.puxLogHead );
+				prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( xScratch.puxLogTail ), 8 );
 			}
-		}
-		else if( ( uxHead + uxSize ) < uxTail )
-		{
-			prvMEMCPY( prvUINT_TO_PTR( ullBufStart + uxHead ), pucData, uxSize );
-			prvDcacheWritebackRangeCCTL( ullBufStart + uxHead, uxSize );
 
-			*( pxLogBuf->puxLogHead ) = uxHead + uxSize;
-			prvDcacheWritebackRangeCCTL( prvPTR_TO_UINT( pxLogBuf->puxLogHead ), 8 );
+			__asm volatile( "csrr %0, mcycle" : "=r"( ulStart ) );
+			prvWriteLogBuffer( &xScratch, ucEvent, sizeof( ucEvent ) );
+			__asm volatile( "csrr %0, mcycle" : "=r"( ulEnd ) );
 
-			xReturn = pdTRUE;
-		}
-		else
-		{
-			xReturn = pdFALSE;
+			ulTotal += ( uint32_t )( ulEnd - ulStart );
 		}
 	}
 	prvMIE_RESTORE( uxSavedStatus );
 
-	return xReturn;
-}
-
-BaseType_t xWriteLogBuffer( uint8_t *pucData, UBaseType_t uxSize )
-{
-	return prvWriteLogBuffer( &xLogBufferManage, pucData, uxSize );
+	return ulTotal / prvBENCHMARK_EVENTS;
 }
 
 static BaseType_t prvReadCommandBuffer( CmdBufferManage_t *pxCmdBuf, uint8_t *pucData, UBaseType_t uxSize )
@@ -670,6 +752,9 @@ unsigned long uxMdcmCfg;
 	/* Initialize BufferManage struct for target usage */
 	xLogBufferManage.ullBufStart = pxTracerTCB->xLogBuffer.ullBufStart;
 	xLogBufferManage.uxBufSize = *( uintptr_t * )pxTracerTCB->xLogBuffer.ucBufSize;
+	xLogBufferManage.uxHead = 0;
+	xLogBufferManage.uxTail = 0;
+	xLogBufferManage.uxBatchSize = configTRACER_BATCH_SIZE;
 	xCmdBufferManage.ullBufStart = pxTracerTCB->xCmdBuffer.ullBufStart;
 	xCmdBufferManage.uxBufSize = *( uintptr_t * )pxTracerTCB->xCmdBuffer.ucBufSize;
 
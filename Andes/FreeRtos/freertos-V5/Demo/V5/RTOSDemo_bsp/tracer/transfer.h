@@ -7,6 +7,8 @@
 int xInitTracerTCB( uint8_t ucCacheEnable );
 uint8_t ucReadStartFlag( void );
 BaseType_t xWriteLogBuffer( uint8_t *pucData, UBaseType_t uxSize );
+void vFlushLogBuffer( void );
+uint32_t ulMeasureLogBufferWrite( UBaseType_t uxBatchSize );
 BaseType_t xReadCommandBuffer( uint8_t *pucData, UBaseType_t uxSize );
 #endif /* ( configUSE_ANDES_TRACER == 1 ) */
 #endif /* TRANSFER_H */
@@ -0,0 +1,116 @@
+#include "FreeRTOS.h"
+
+#if( configUSE_UART_STREAM == 1 )
+
+#include <string.h>
+
+#include "task.h"
+#include "uartstream.h"
+
+/* Bytes sent or checked by each call to the driver. */
+#define prvBENCH_CHUNK				( 64 )
+
+/* Consecutive calls to pvWait without any byte sent or received after which
+the benchmark gives up. */
+#define prvBENCH_MAX_IDLE_WAITS		( 1000 )
+
+/* The value of the nth byte of the benchmark. */
+#define prvPATTERN( ulIndex )		( ( uint8_t ) ( ( ulIndex ) ^ ( ( ulIndex ) >> 8 ) ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Used when no pvWait is given.
+ */
+static void prvDelay( void );
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xUartBenchLoopback( UBaseType_t uxPort, uint32_t ulBytes, void ( *pvWait )( void ), UartBenchResult_t *pxResult )
+{
+uint8_t ucBuffer[ prvBENCH_CHUNK ];
+UartStreamStats_t xStart;
+uint32_t ulSent = 0, ulReceived = 0, ulIdleWaits = 0, ulStartCycle;
+size_t xCount, xProgress, x;
+
+	if( pvWait == NULL )
+	{
+		pvWait = prvDelay;
+	}
+
+	memset( pxResult, 0, sizeof( *pxResult ) );
+	vUartStreamGetStats( uxPort, &xStart );
+	vUartStreamSetLoopback( uxPort, pdTRUE );
+
+	ulStartCycle = portGET_CYCLE_COUNT();
+
+	while( ulReceived < ulBytes )
+	{
+		/* Keep the transmit stream buffer full, and empty the receive stream
+		buffer, without blocking on either. */
+		xProgress = 0;
+		if( ulSent < ulBytes )
+		{
+			xCount = ( ( ulBytes - ulSent ) < sizeof( ucBuffer ) ) ? ( ulBytes - ulSent ) : sizeof( ucBuffer );
+			for( x = 0; x < xCount; x++ )
+			{
+				ucBuffer[ x ] = prvPATTERN( ulSent + x );
+			}
+
+			xCount = xUartStreamSend( uxPort, ucBuffer, xCount, 0 );
+			ulSent += xCount;
+			xProgress += xCount;
+		}
+
+		xCount = xUartStreamReceive( uxPort, ucBuffer, sizeof( ucBuffer ), 0 );
+		for( x = 0; x < xCount; x++ )
+		{
+			if( ucBuffer[ x ] != prvPATTERN( ulReceived + x ) )
+			{
+				pxResult->ulErrors++;
+			}
+		}
+		ulReceived += xCount;
+		xProgress += xCount;
+
+		if( xProgress == 0 )
+		{
+			if( ++ulIdleWaits > prvBENCH_MAX_IDLE_WAITS )
+			{
+				break;
+			}
+			pvWait();
+		}
+		else
+		{
+			ulIdleWaits = 0;
+		}
+	}
+
+	pxResult->ulCycles = portGET_CYCLE_COUNT() - ulStartCycle;
+
+	vUartStreamSetLoopback( uxPort, pdFALSE );
+
+	/* Report the driver's work during the benchmark alone. */
+	vUartStreamGetStats( uxPort, &( pxResult->xStats ) );
+	pxResult->xStats.ulInterrupts -= xStart.ulInterrupts;
+	pxResult->xStats.ulDmaInterrupts -= xStart.ulDmaInterrupts;
+	pxResult->xStats.ulRxBytes -= xStart.ulRxBytes;
+	pxResult->xStats.ulTxBytes -= xStart.ulTxBytes;
+	pxResult->xStats.ulRxDropped -= xStart.ulRxDropped;
+	pxResult->xStats.ulRxOverruns -= xStart.ulRxOverruns;
+	pxResult->xStats.ulLineErrors -= xStart.ulLineErrors;
+
+	pxResult->ulBytes = ulReceived;
+
+	return ( ( ulReceived == ulBytes ) && ( pxResult->ulErrors == 0 ) ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelay( void )
+{
+	vTaskDelay( 1 );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_UART_STREAM == 1 ) */
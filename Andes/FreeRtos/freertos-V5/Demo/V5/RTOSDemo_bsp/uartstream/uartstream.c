@@ -0,0 +1,450 @@
+#include "FreeRTOS.h"
+
+#if( configUSE_UART_STREAM == 1 )
+
+#include "task.h"
+#include "uartstream.h"
+
+#if( configUART_STREAM_USE_DMA == 1 )
+	#include "cache.h"
+
+	#ifndef AE250_DMA
+		#error configUART_STREAM_USE_DMA is only supported by the AE250 DMA controller
+	#endif
+#endif
+
+/* Bytes moved between the FIFOs and the stream buffers in one call. */
+#define prvISR_CHUNK				( 16 )
+
+#define prvLSR_ERRORS				( UARTC_LSR_PE | UARTC_LSR_FE | UARTC_LSR_BI )
+
+/* ATCDMAC100 channel control and interrupt status fields. */
+#define prvDMA_CTRL_ENABLE			( 1UL << 0 )
+#define prvDMA_CTRL_DST_REQ( x )	( ( uint32_t ) ( x ) << 4 )
+#define prvDMA_CTRL_DST_FIXED		( 2UL << 12 )
+#define prvDMA_CTRL_DST_HANDSHAKE	( 1UL << 16 )
+#define prvDMA_INT_ERROR( x )		( 1UL << ( x ) )
+#define prvDMA_INT_ABORT( x )		( 1UL << ( 8 + ( x ) ) )
+#define prvDMA_INT_DONE( x )		( 1UL << ( 16 + ( x ) ) )
+
+/*-----------------------------------------------------------*/
+
+typedef struct UartStreamPort
+{
+	UART_RegDef *pxUart;
+	StreamBufferHandle_t xRxStream;
+	StreamBufferHandle_t xTxStream;
+	uint32_t ulFifoDepth;
+	UartStreamStats_t xStats;
+
+	#if( configUART_STREAM_USE_DMA == 1 )
+		UBaseType_t uxDmaChannel;
+		uint32_t ulDmaRequest;
+		volatile BaseType_t xDmaBusy;
+		uint8_t ucDmaBuffer[ configUART_STREAM_DMA_CHUNK ] __attribute__( ( aligned( 64 ) ) );
+	#endif
+} UartStreamPort_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Handle every interrupt the UART of pxPort has pending.
+ */
+static void prvHandleInterrupt( UartStreamPort_t *pxPort );
+
+/*
+ * Move every byte in the receive FIFO to the receive stream buffer.
+ */
+static void prvReceive( UartStreamPort_t *pxPort, BaseType_t *pxHigherPriorityTaskWoken );
+
+/*
+ * Refill the empty transmit FIFO from the transmit stream buffer, disabling
+ * the transmit interrupt once the stream buffer is empty.
+ */
+static void prvTransmit( UartStreamPort_t *pxPort, BaseType_t *pxHigherPriorityTaskWoken );
+
+#if( configUART_STREAM_USE_DMA == 1 )
+	/*
+	 * Start a DMA transfer of the next chunk of the transmit stream buffer, or
+	 * mark the channel idle if the stream buffer is empty.
+	 */
+	static void prvStartDma( UartStreamPort_t *pxPort, BaseType_t *pxHigherPriorityTaskWoken );
+#endif
+
+/*-----------------------------------------------------------*/
+
+static UartStreamPort_t xPorts[ uartstreamNUM_PORTS ];
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xUartStreamInit( UBaseType_t uxPort, uint32_t ulBaud, size_t xRxBufferSize, size_t xTxBufferSize )
+{
+UartStreamPort_t * const pxPort = &( xPorts[ uxPort ] );
+UART_RegDef *pxUart;
+uint32_t ulFcr = UARTC_FCR_FIFO_EN | UARTC_FCR_RFIFO_RESET | UARTC_FCR_TFIFO_RESET | configUART_STREAM_RX_TRIGGER;
+
+	configASSERT( uxPort < uartstreamNUM_PORTS );
+	configASSERT( pxPort->pxUart == NULL );
+
+	/* Receivers and senders are woken by any change, so a small read or
+	write is never held back. */
+	pxPort->xRxStream = xStreamBufferCreate( xRxBufferSize, 1 );
+	pxPort->xTxStream = xStreamBufferCreate( xTxBufferSize, 1 );
+	if( ( pxPort->xRxStream == NULL ) || ( pxPort->xTxStream == NULL ) )
+	{
+		if( pxPort->xRxStream != NULL )
+		{
+			vStreamBufferDelete( pxPort->xRxStream );
+			pxPort->xRxStream = NULL;
+		}
+		if( pxPort->xTxStream != NULL )
+		{
+			vStreamBufferDelete( pxPort->xTxStream );
+			pxPort->xTxStream = NULL;
+		}
+		return pdFAIL;
+	}
+
+	pxUart = ( uxPort == uartstreamUART1 ) ? DEV_UART1 : DEV_UART2;
+	pxPort->pxUart = pxUart;
+
+	/* CFG[1:0] gives the FIFO depth as 16 << n bytes. */
+	pxPort->ulFifoDepth = 16UL << ( uartstreamREAD( pxUart, CFG ) & 0x3UL );
+
+	#if( configUART_STREAM_USE_DMA == 1 )
+	{
+		pxPort->uxDmaChannel = configUART_STREAM_DMA_CHANNEL + uxPort;
+		pxPort->ulDmaRequest = ( uxPort == uartstreamUART1 ) ? configUART1_DMA_TX_REQ : configUART2_DMA_TX_REQ;
+		pxPort->xDmaBusy = pdFALSE;
+		ulFcr |= UARTC_FCR_DMA_EN;
+	}
+	#endif
+
+	uartstreamWRITE( pxUart, IER, 0UL );
+	uartstreamWRITE( pxUart, LCR, 0UL );
+	uart_set_baudrate( pxUart, ulBaud );
+	uartstreamWRITE( pxUart, LCR, UARTC_LCR_PARITY_NONE | UARTC_LCR_BITS8 | UARTC_LCR_STOP1 );
+	uartstreamWRITE( pxUart, FCR, ulFcr );
+
+	/* The transmit interrupt is enabled only while there is data to send. */
+	uartstreamWRITE( pxUart, IER, UARTC_IER_RDR | UARTC_IER_RLS );
+
+	if( uxPort == uartstreamUART1 )
+	{
+		__nds__plic_set_priority( IRQ_UART1_SOURCE, configUART_STREAM_IRQ_PRIORITY );
+		__nds__plic_enable_interrupt( IRQ_UART1_SOURCE );
+	}
+	else
+	{
+		__nds__plic_set_priority( IRQ_UART2_SOURCE, configUART_STREAM_IRQ_PRIORITY );
+		__nds__plic_enable_interrupt( IRQ_UART2_SOURCE );
+	}
+
+	#if( configUART_STREAM_USE_DMA == 1 )
+	{
+		__nds__plic_set_priority( IRQ_DMA_SOURCE, configUART_STREAM_IRQ_PRIORITY );
+		__nds__plic_enable_interrupt( IRQ_DMA_SOURCE );
+	}
+	#endif
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+size_t xUartStreamSend( UBaseType_t uxPort, const void *pvData, size_t xLength, TickType_t xTicksToWait )
+{
+UartStreamPort_t * const pxPort = &( xPorts[ uxPort ] );
+const uint8_t *pucData = ( const uint8_t * ) pvData;
+size_t xSent = 0, xWritten;
+
+	configASSERT( uxPort < uartstreamNUM_PORTS );
+	configASSERT( pxPort->pxUart != NULL );
+
+	/* Writes larger than the free space are sent a piece at a time, starting
+	the transmitter after each piece so it drains while this task waits for
+	more space. */
+	while( xSent < xLength )
+	{
+		xWritten = xStreamBufferSend( pxPort->xTxStream, &( pucData[ xSent ] ), xLength - xSent, xTicksToWait );
+		if( xWritten == 0 )
+		{
+			break;
+		}
+		xSent += xWritten;
+
+		/* The interrupt disables itself only when it finds the stream buffer
+		empty, so once enabled here it sends everything just written. */
+		taskENTER_CRITICAL();
+		{
+			#if( configUART_STREAM_USE_DMA == 1 )
+			if( pxPort->xDmaBusy == pdFALSE )
+			#endif
+			{
+				uartstreamWRITE( pxPort->pxUart, IER, uartstreamREAD( pxPort->pxUart, IER ) | UARTC_IER_THRE );
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	return xSent;
+}
+/*-----------------------------------------------------------*/
+
+size_t xUartStreamReceive( UBaseType_t uxPort, void *pvData, size_t xLength, TickType_t xTicksToWait )
+{
+	configASSERT( uxPort < uartstreamNUM_PORTS );
+	configASSERT( xPorts[ uxPort ].pxUart != NULL );
+
+	return xStreamBufferReceive( xPorts[ uxPort ].xRxStream, pvData, xLength, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+void vUartStreamSetLoopback( UBaseType_t uxPort, BaseType_t xEnable )
+{
+UART_RegDef *pxUart;
+
+	configASSERT( uxPort < uartstreamNUM_PORTS );
+	configASSERT( xPorts[ uxPort ].pxUart != NULL );
+
+	pxUart = xPorts[ uxPort ].pxUart;
+	if( xEnable != pdFALSE )
+	{
+		uartstreamWRITE( pxUart, MCR, uartstreamREAD( pxUart, MCR ) | UARTC_MCR_LPBK );
+	}
+	else
+	{
+		uartstreamWRITE( pxUart, MCR, uartstreamREAD( pxUart, MCR ) & ~UARTC_MCR_LPBK );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vUartStreamGetStats( UBaseType_t uxPort, UartStreamStats_t *pxStats )
+{
+	configASSERT( uxPort < uartstreamNUM_PORTS );
+
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xPorts[ uxPort ].xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandleInterrupt( UartStreamPort_t *pxPort )
+{
+UART_RegDef * const pxUart = pxPort->pxUart;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+uint32_t ulLsr;
+
+	if( pxUart == NULL )
+	{
+		return;
+	}
+
+	pxPort->xStats.ulInterrupts++;
+
+	for( ;; )
+	{
+		switch( uartstreamREAD( pxUart, IIR ) & UARTC_IIR_INT_MASK )
+		{
+			case UARTC_IIR_NONE:
+				portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+				return;
+
+			case UARTC_IIR_RLS:
+				/* Reading LSR clears the error, the data is read below. */
+				ulLsr = uartstreamREAD( pxUart, LSR );
+				if( ( ulLsr & UARTC_LSR_OE ) != 0 )
+				{
+					pxPort->xStats.ulRxOverruns++;
+				}
+				if( ( ulLsr & prvLSR_ERRORS ) != 0 )
+				{
+					pxPort->xStats.ulLineErrors++;
+				}
+				prvReceive( pxPort, &xHigherPriorityTaskWoken );
+				break;
+
+			case UARTC_IIR_RDA:
+			case UARTC_IIR_RTO:
+				prvReceive( pxPort, &xHigherPriorityTaskWoken );
+				break;
+
+			case UARTC_IIR_THRE:
+				prvTransmit( pxPort, &xHigherPriorityTaskWoken );
+				break;
+
+			default:
+				/* Modem status, which is not enabled. */
+				( void ) uartstreamREAD( pxUart, MSR );
+				break;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceive( UartStreamPort_t *pxPort, BaseType_t *pxHigherPriorityTaskWoken )
+{
+UART_RegDef * const pxUart = pxPort->pxUart;
+uint8_t ucBuffer[ prvISR_CHUNK ];
+size_t xCount = 0, xSent;
+uint32_t ulLsr;
+
+	for( ;; )
+	{
+		ulLsr = uartstreamREAD( pxUart, LSR );
+		if( ( ulLsr & UARTC_LSR_RDR ) != 0 )
+		{
+			if( ( ulLsr & UARTC_LSR_OE ) != 0 )
+			{
+				pxPort->xStats.ulRxOverruns++;
+			}
+			if( ( ulLsr & prvLSR_ERRORS ) != 0 )
+			{
+				pxPort->xStats.ulLineErrors++;
+			}
+			ucBuffer[ xCount++ ] = ( uint8_t ) uartstreamREAD( pxUart, RBR );
+		}
+
+		if( ( xCount == sizeof( ucBuffer ) ) || ( ( ( ulLsr & UARTC_LSR_RDR ) == 0 ) && ( xCount > 0 ) ) )
+		{
+			xSent = xStreamBufferSendFromISR( pxPort->xRxStream, ucBuffer, xCount, pxHigherPriorityTaskWoken );
+			pxPort->xStats.ulRxBytes += xSent;
+			pxPort->xStats.ulRxDropped += xCount - xSent;
+			xCount = 0;
+		}
+
+		if( ( ulLsr & UARTC_LSR_RDR ) == 0 )
+		{
+			break;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTransmit( UartStreamPort_t *pxPort, BaseType_t *pxHigherPriorityTaskWoken )
+{
+UART_RegDef * const pxUart = pxPort->pxUart;
+
+	#if( configUART_STREAM_USE_DMA == 1 )
+	{
+		/* The interrupt only starts the channel, which then refills the FIFO
+		on its own until the stream buffer is empty. */
+		uartstreamWRITE( pxUart, IER, uartstreamREAD( pxUart, IER ) & ~UARTC_IER_THRE );
+		if( pxPort->xDmaBusy == pdFALSE )
+		{
+			prvStartDma( pxPort, pxHigherPriorityTaskWoken );
+		}
+	}
+	#else
+	{
+	uint8_t ucBuffer[ prvISR_CHUNK ];
+	size_t xSpace, xCount, x;
+
+		if( ( uartstreamREAD( pxUart, LSR ) & UARTC_LSR_THRE ) == 0 )
+		{
+			return;
+		}
+
+		for( xSpace = pxPort->ulFifoDepth; xSpace > 0; xSpace -= xCount )
+		{
+			xCount = xStreamBufferReceiveFromISR( pxPort->xTxStream, ucBuffer, ( xSpace < sizeof( ucBuffer ) ) ? xSpace : sizeof( ucBuffer ), pxHigherPriorityTaskWoken );
+			if( xCount == 0 )
+			{
+				break;
+			}
+
+			for( x = 0; x < xCount; x++ )
+			{
+				uartstreamWRITE( pxUart, THR, ucBuffer[ x ] );
+			}
+			pxPort->xStats.ulTxBytes += xCount;
+		}
+
+		if( xSpace == pxPort->ulFifoDepth )
+		{
+			/* Nothing left to send. */
+			uartstreamWRITE( pxUart, IER, uartstreamREAD( pxUart, IER ) & ~UARTC_IER_THRE );
+		}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void uart1_irq_handler( void )
+{
+	prvHandleInterrupt( &( xPorts[ uartstreamUART1 ] ) );
+}
+/*-----------------------------------------------------------*/
+
+void uart2_irq_handler( void )
+{
+	prvHandleInterrupt( &( xPorts[ uartstreamUART2 ] ) );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUART_STREAM_USE_DMA == 1 )
+
+	static void prvStartDma( UartStreamPort_t *pxPort, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	DMA_CHANNEL_REG * const pxChannel = &( DEV_DMA->CHANNEL[ pxPort->uxDmaChannel ] );
+	size_t xCount;
+
+		xCount = xStreamBufferReceiveFromISR( pxPort->xTxStream, pxPort->ucDmaBuffer, sizeof( pxPort->ucDmaBuffer ), pxHigherPriorityTaskWoken );
+		if( xCount == 0 )
+		{
+			pxPort->xDmaBusy = pdFALSE;
+			return;
+		}
+
+		pxPort->xDmaBusy = pdTRUE;
+		nds_dma_writeback_range( ( unsigned long ) pxPort->ucDmaBuffer, xCount );
+
+		/* Byte wide, incrementing source, and the UART transmit request
+		paces writes to the fixed THR address. */
+		pxChannel->SRCADDR = ( uint32_t ) ( uintptr_t ) pxPort->ucDmaBuffer;
+		pxChannel->DSTADDR = ( uint32_t ) ( uintptr_t ) &( pxPort->pxUart->THR );
+		pxChannel->TRANSIZE = ( uint32_t ) xCount;
+		pxChannel->LLP = 0;
+		pxChannel->CTRL = prvDMA_CTRL_DST_REQ( pxPort->ulDmaRequest ) | prvDMA_CTRL_DST_FIXED | prvDMA_CTRL_DST_HANDSHAKE | prvDMA_CTRL_ENABLE;
+
+		pxPort->xStats.ulTxBytes += xCount;
+	}
+	/*-----------------------------------------------------------*/
+
+	void dma_irq_handler( void )
+	{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	const uint32_t ulStatus = DEV_DMA->INTSTATUS;
+	UartStreamPort_t *pxPort;
+	UBaseType_t uxPort, uxChannel;
+
+		/* Write one to clear. */
+		DEV_DMA->INTSTATUS = ulStatus;
+
+		for( uxPort = 0; uxPort < uartstreamNUM_PORTS; uxPort++ )
+		{
+			pxPort = &( xPorts[ uxPort ] );
+			uxChannel = configUART_STREAM_DMA_CHANNEL + uxPort;
+
+			if( ( pxPort->pxUart == NULL ) || ( ( ulStatus & ( prvDMA_INT_DONE( uxChannel ) | prvDMA_INT_ERROR( uxChannel ) | prvDMA_INT_ABORT( uxChannel ) ) ) == 0 ) )
+			{
+				continue;
+			}
+
+			pxPort->xStats.ulDmaInterrupts++;
+			if( ( ulStatus & ( prvDMA_INT_ERROR( uxChannel ) | prvDMA_INT_ABORT( uxChannel ) ) ) != 0 )
+			{
+				pxPort->xStats.ulLineErrors++;
+			}
+
+			prvStartDma( pxPort, &xHigherPriorityTaskWoken );
+		}
+
+		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ( configUART_STREAM_USE_DMA == 1 ) */
+
+#endif /* ( configUSE_UART_STREAM == 1 ) */
@@ -0,0 +1,125 @@
+#ifndef UARTSTREAM_H
+#define UARTSTREAM_H
+
+/*
+ * Interrupt driven UART driver backed by stream buffers.
+ *
+ * uart.c sends and receives one byte at a time, busy waiting on the line
+ * status register for each.  This driver instead keeps a receive and a
+ * transmit stream buffer for each UART and moves data between them and the
+ * UART FIFOs from the UART interrupt:
+ *
+ * + Received bytes raise an interrupt once the receive FIFO reaches
+ *   configUART_STREAM_RX_TRIGGER, or when bytes have waited in the FIFO for
+ *   four character times, and the interrupt moves every byte in the FIFO to
+ *   the receive stream buffer.  A higher trigger level means fewer
+ *   interrupts, at the cost of a smaller margin before the FIFO overruns.
+ *
+ * + xUartStreamSend() writes to the transmit stream buffer and enables the
+ *   transmit holding register empty interrupt, which refills the whole
+ *   transmit FIFO each time it empties, and is disabled again once the
+ *   stream buffer is empty.
+ *
+ * With configUART_STREAM_USE_DMA set to 1 the transmit FIFO is instead filled
+ * by the AE250 DMA controller in handshake mode, one chunk of up to
+ * configUART_STREAM_DMA_CHUNK bytes at a time, so a chunk costs one
+ * interrupt.  Reception always uses the FIFO interrupts, as the number of
+ * bytes that will arrive is not known in advance.
+ *
+ * Each stream buffer has a single reader and a single writer, so only one
+ * task may send to, and one task receive from, each UART at a time.
+ *
+ * xUartBenchLoopback() in uartbench.c measures throughput with the UART in
+ * loopback mode.  All register accesses go through uartstreamREAD() and
+ * uartstreamWRITE(), so the same code can run against the UART model in
+ * Demo/Host_GCC/UartStream.
+ */
+
+#if( configUSE_UART_STREAM == 1 )
+
+#include "stream_buffer.h"
+#include "uart.h"
+
+/* FCR receive trigger level, one of the UARTC_FCR_RFIFO16_TRGL values. */
+#ifndef configUART_STREAM_RX_TRIGGER
+	#define configUART_STREAM_RX_TRIGGER	UARTC_FCR_RFIFO16_TRGL8
+#endif
+
+/* PLIC priority of the UART and DMA interrupts. */
+#ifndef configUART_STREAM_IRQ_PRIORITY
+	#define configUART_STREAM_IRQ_PRIORITY	( 1 )
+#endif
+
+/* Fill the transmit FIFO by DMA. */
+#ifndef configUART_STREAM_USE_DMA
+	#define configUART_STREAM_USE_DMA		0
+#endif
+
+#if( configUART_STREAM_USE_DMA == 1 )
+	/* The DMA channel used by UART1, UART2 uses the next. */
+	#ifndef configUART_STREAM_DMA_CHANNEL
+		#define configUART_STREAM_DMA_CHANNEL	( 0 )
+	#endif
+
+	/* Bytes moved by each DMA transfer. */
+	#ifndef configUART_STREAM_DMA_CHUNK
+		#define configUART_STREAM_DMA_CHUNK		( 64 )
+	#endif
+
+	/* The DMA request lines of the UART transmitters depend on how the
+	platform is built, so must be given. */
+	#if !defined( configUART1_DMA_TX_REQ ) || !defined( configUART2_DMA_TX_REQ )
+		#error configUART1_DMA_TX_REQ and configUART2_DMA_TX_REQ must be set to the DMA requests of the UART transmitters
+	#endif
+#endif
+
+/* Register accessors, see the top of this file. */
+#ifndef uartstreamREAD
+	#define uartstreamREAD( pxUart, xRegister )				( ( pxUart )->xRegister )
+	#define uartstreamWRITE( pxUart, xRegister, ulValue )	( ( pxUart )->xRegister = ( ulValue ) )
+#endif
+
+/* Values of uxPort. */
+#define uartstreamUART1						( 0 )
+#define uartstreamUART2						( 1 )
+#define uartstreamNUM_PORTS					( 2 )
+
+typedef struct UartStreamStats
+{
+	uint32_t ulInterrupts;		/* UART interrupts taken. */
+	uint32_t ulDmaInterrupts;	/* DMA transfers completed. */
+	uint32_t ulRxBytes;			/* Bytes written to the receive stream buffer. */
+	uint32_t ulTxBytes;			/* Bytes written to the UART. */
+	uint32_t ulRxDropped;		/* Bytes lost because the receive stream buffer was full. */
+	uint32_t ulRxOverruns;		/* Receive FIFO overruns. */
+	uint32_t ulLineErrors;		/* Parity, framing and break errors, and DMA errors. */
+} UartStreamStats_t;
+
+/* Result of xUartBenchLoopback(). */
+typedef struct UartBenchResult
+{
+	uint32_t ulBytes;			/* Bytes sent and received back. */
+	uint32_t ulErrors;			/* Bytes received with the wrong value. */
+	uint32_t ulCycles;			/* portGET_CYCLE_COUNT() cycles taken. */
+	UartStreamStats_t xStats;	/* The driver statistics for the benchmark alone. */
+} UartBenchResult_t;
+
+/* Public API of uartstream.c */
+BaseType_t xUartStreamInit( UBaseType_t uxPort, uint32_t ulBaud, size_t xRxBufferSize, size_t xTxBufferSize );
+size_t xUartStreamSend( UBaseType_t uxPort, const void *pvData, size_t xLength, TickType_t xTicksToWait );
+size_t xUartStreamReceive( UBaseType_t uxPort, void *pvData, size_t xLength, TickType_t xTicksToWait );
+void vUartStreamSetLoopback( UBaseType_t uxPort, BaseType_t xEnable );
+void vUartStreamGetStats( UBaseType_t uxPort, UartStreamStats_t *pxStats );
+
+/* Public API of uartbench.c */
+BaseType_t xUartBenchLoopback( UBaseType_t uxPort, uint32_t ulBytes, void ( *pvWait )( void ), UartBenchResult_t *pxResult );
+
+/* Called from the PLIC dispatcher in interrupt.c only. */
+void uart1_irq_handler( void );
+void uart2_irq_handler( void );
+#if( configUART_STREAM_USE_DMA == 1 )
+	void dma_irq_handler( void );
+#endif
+
+#endif /* ( configUSE_UART_STREAM == 1 ) */
+#endif /* UARTSTREAM_H */
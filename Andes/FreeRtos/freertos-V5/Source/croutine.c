@@ -51,12 +51,40 @@ static List_t xPendingReadyCoRoutineList;								/*< Holds co-routines that have
 
 /* Other file private variables. --------------------------------*/
 CRCB_t * pxCurrentCoRoutine = NULL;
-static UBaseType_t uxTopCoRoutineReadyPriority = 0;
+static uint32_t ulReadyCoRoutinePriorities = 0UL;						/*< One bit per priority that has ready co-routines - see corPRIORITY_BIT(). */
 static TickType_t xCoRoutineTickCount = 0, xLastTickCount = 0, xPassedTicks = 0;
 
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+	static TaskHandle_t volatile xCoRoutineHostTask = NULL;				/*< The task calling vCoRoutineScheduleOrBlock(), which is notified when a co-routine is readied from outside the co-routine scheduler. */
+#endif
+
 /* The initial state of the co-routine when it is created. */
 #define corINITIAL_STATE	( 0 )
 
+/* Values that can be assigned to the ucNotifyState member of the CRCB. */
+#define corNOT_WAITING_NOTIFICATION		( ( uint8_t ) 0 )
+#define corWAITING_NOTIFICATION			( ( uint8_t ) 1 )
+#define corNOTIFICATION_RECEIVED		( ( uint8_t ) 2 )
+
+#if( configMAX_CO_ROUTINE_PRIORITIES > 32 )
+	#error configMAX_CO_ROUTINE_PRIORITIES must not exceed 32 as the ready priorities are held in a 32-bit bitmap.
+#endif
+
+/* Ready priorities are stored in reverse bit order - priority
+( configMAX_CO_ROUTINE_PRIORITIES - 1 ) uses bit 0 - so the highest ready
+priority is found by counting trailing zeros.  Ports that have a count trailing
+zeros instruction define portCOUNT_TRAILING_ZEROS() in portmacro.h. */
+#define corPRIORITY_BIT( uxPriority )	( ( uint32_t ) 1UL << ( ( ( UBaseType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( UBaseType_t ) 1 ) - ( uxPriority ) ) )
+
+#ifndef portCOUNT_TRAILING_ZEROS
+	#define corUSE_GENERIC_COUNT_TRAILING_ZEROS	1
+	#define portCOUNT_TRAILING_ZEROS( ulBits )	prvCountTrailingZeros( ulBits )
+#else
+	#define corUSE_GENERIC_COUNT_TRAILING_ZEROS	0
+#endif
+
+#define corGET_HIGHEST_READY_PRIORITY()	( ( ( UBaseType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( UBaseType_t ) 1 ) - ( UBaseType_t ) portCOUNT_TRAILING_ZEROS( ulReadyCoRoutinePriorities ) )
+
 /*
  * Place the co-routine represented by pxCRCB into the appropriate ready queue
  * for the priority.  It is inserted at the end of the list.
@@ -66,10 +94,7 @@ static TickType_t xCoRoutineTickCount = 0, xLastTickCount = 0, xPassedTicks = 0;
  */
 #define prvAddCoRoutineToReadyQueue( pxCRCB )																		\
 {																													\
-	if( pxCRCB->uxPriority > uxTopCoRoutineReadyPriority )															\
-	{																												\
-		uxTopCoRoutineReadyPriority = pxCRCB->uxPriority;															\
-	}																												\
+	ulReadyCoRoutinePriorities |= corPRIORITY_BIT( pxCRCB->uxPriority );											\
 	vListInsertEnd( ( List_t * ) &( pxReadyCoRoutineLists[ pxCRCB->uxPriority ] ), &( pxCRCB->xGenericListItem ) );	\
 }
 
@@ -97,6 +122,49 @@ static void prvCheckPendingReadyList( void );
  */
 static void prvCheckDelayedList( void );
 
+/*
+ * Process the pending ready and delayed lists, then run the highest priority
+ * ready co-routine.  Returns pdFALSE if no co-routine was ready to run.
+ */
+static BaseType_t prvRunCoRoutine( void );
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	/*
+	 * Move a co-routine that is blocked without being on an event list (in
+	 * crNOTIFY_WAIT() or waiting on a stream buffer) to the pending ready list.
+	 * Must be called with interrupts masked.
+	 */
+	static void prvUnblockCoRoutine( CRCB_t *pxCRCB, BaseType_t *pxHigherPriorityTaskWoken );
+
+	/*
+	 * Common part of xCoRoutineNotify() and xCoRoutineNotifyFromISR().  Must be
+	 * called with interrupts masked.
+	 */
+	static BaseType_t prvNotifyCoRoutine( CRCB_t *pxCRCB, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );
+
+	/*
+	 * Unblock the task running vCoRoutineScheduleOrBlock() because the pending
+	 * ready list is no longer empty.  Must be called with interrupts masked.
+	 */
+	#define prvNotifyHostTask( pxHigherPriorityTaskWoken )					\
+	{																		\
+		if( xCoRoutineHostTask != NULL )									\
+		{																	\
+			vTaskNotifyGiveFromISR( xCoRoutineHostTask, ( pxHigherPriorityTaskWoken ) );	\
+		}																	\
+	}
+
+#else
+
+	#define prvNotifyHostTask( pxHigherPriorityTaskWoken )
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+
+#if( corUSE_GENERIC_COUNT_TRAILING_ZEROS == 1 )
+	static UBaseType_t prvCountTrailingZeros( uint32_t ulBits );
+#endif
+
 /*-----------------------------------------------------------*/
 
 BaseType_t xCoRoutineCreate( crCOROUTINE_CODE pxCoRoutineCode, UBaseType_t uxPriority, UBaseType_t uxIndex )
@@ -141,6 +209,13 @@ CRCB_t *pxCoRoutine;
 		/* Event lists are always in priority order. */
 		listSET_LIST_ITEM_VALUE( &( pxCoRoutine->xEventListItem ), ( ( TickType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( TickType_t ) uxPriority ) );
 
+		#if( configUSE_TASK_NOTIFICATIONS == 1 )
+		{
+			pxCoRoutine->ucNotifyState = corNOT_WAITING_NOTIFICATION;
+			pxCoRoutine->ulNotifiedValue = 0UL;
+		}
+		#endif
+
 		/* Now the co-routine has been initialised it can be added to the ready
 		list at the correct priority. */
 		prvAddCoRoutineToReadyQueue( pxCoRoutine );
@@ -167,7 +242,10 @@ TickType_t xTimeToWake;
 	/* We must remove ourselves from the ready list before adding
 	ourselves to the blocked list as the same list item is used for
 	both lists. */
-	( void ) uxListRemove( ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) );
+	if( uxListRemove( ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) ) == ( UBaseType_t ) 0 )
+	{
+		ulReadyCoRoutinePriorities &= ~corPRIORITY_BIT( pxCurrentCoRoutine->uxPriority );
+	}
 
 	/* The list item will be inserted in wake time order. */
 	listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xGenericListItem ), xTimeToWake );
@@ -275,33 +353,89 @@ CRCB_t *pxCRCB;
 }
 /*-----------------------------------------------------------*/
 
-void vCoRoutineSchedule( void )
+static BaseType_t prvRunCoRoutine( void )
 {
+UBaseType_t uxPriority;
+
 	/* See if any co-routines readied by events need moving to the ready lists. */
 	prvCheckPendingReadyList();
 
 	/* See if any delayed co-routines have timed out. */
 	prvCheckDelayedList();
 
-	/* Find the highest priority queue that contains ready co-routines. */
-	while( listLIST_IS_EMPTY( &( pxReadyCoRoutineLists[ uxTopCoRoutineReadyPriority ] ) ) )
+	if( ulReadyCoRoutinePriorities == 0UL )
 	{
-		if( uxTopCoRoutineReadyPriority == 0 )
-		{
-			/* No more co-routines to check. */
-			return;
-		}
-		--uxTopCoRoutineReadyPriority;
+		/* No co-routines are ready to run. */
+		return pdFALSE;
 	}
 
+	/* Find the highest priority queue that contains ready co-routines. */
+	uxPriority = corGET_HIGHEST_READY_PRIORITY();
+
 	/* listGET_OWNER_OF_NEXT_ENTRY walks through the list, so the co-routines
 	 of the	same priority get an equal share of the processor time. */
-	listGET_OWNER_OF_NEXT_ENTRY( pxCurrentCoRoutine, &( pxReadyCoRoutineLists[ uxTopCoRoutineReadyPriority ] ) );
+	listGET_OWNER_OF_NEXT_ENTRY( pxCurrentCoRoutine, &( pxReadyCoRoutineLists[ uxPriority ] ) );
 
 	/* Call the co-routine. */
 	( pxCurrentCoRoutine->pxCoRoutineFunction )( pxCurrentCoRoutine, pxCurrentCoRoutine->uxIndex );
 
-	return;
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vCoRoutineSchedule( void )
+{
+	( void ) prvRunCoRoutine();
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	void vCoRoutineScheduleOrBlock( void )
+	{
+	TickType_t xTicksToWait;
+
+		/* Remember which task to wake when a co-routine is readied by an
+		interrupt, a task or another co-routine. */
+		xCoRoutineHostTask = xTaskGetCurrentTaskHandle();
+
+		if( prvRunCoRoutine() == pdFALSE )
+		{
+			/* Nothing is ready, so block until the next delayed co-routine
+			times out.  The lists were processed by prvRunCoRoutine(), so the
+			head of the delayed list has not yet expired. */
+			if( listLIST_IS_EMPTY( pxDelayedCoRoutineList ) == pdFALSE )
+			{
+				xTicksToWait = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedCoRoutineList ) - xCoRoutineTickCount;
+			}
+			else if( listLIST_IS_EMPTY( pxOverflowDelayedCoRoutineList ) == pdFALSE )
+			{
+				/* Wake when the tick count overflows so the delayed lists get
+				swapped. */
+				xTicksToWait = ( TickType_t ) 0 - xCoRoutineTickCount;
+			}
+			else
+			{
+				xTicksToWait = portMAX_DELAY;
+			}
+
+			/* Anything that readies a co-routine from outside the co-routine
+			scheduler also gives this notification, so no events are missed if
+			they occur before the task blocks. */
+			( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+CoRoutineHandle_t xCoRoutineGetCurrentHandle( void )
+{
+	return pxCurrentCoRoutine;
 }
 /*-----------------------------------------------------------*/
 
@@ -336,6 +470,7 @@ BaseType_t xReturn;
 	pxUnblockedCRCB = ( CRCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxEventList );
 	( void ) uxListRemove( &( pxUnblockedCRCB->xEventListItem ) );
 	vListInsertEnd( ( List_t * ) &( xPendingReadyCoRoutineList ), &( pxUnblockedCRCB->xEventListItem ) );
+	prvNotifyHostTask( NULL );
 
 	if( pxUnblockedCRCB->uxPriority >= pxCurrentCoRoutine->uxPriority )
 	{
@@ -348,6 +483,271 @@ BaseType_t xReturn;
 
 	return xReturn;
 }
+/*-----------------------------------------------------------*/
+
+void vCoRoutinePlaceOnUnorderedEventList( List_t *pxEventList, const TickType_t xItemValue, const TickType_t xTicksToWait )
+{
+	/* The scheduler is suspended, so no task can access the event list.  The
+	event list item value holds the value the waker needs, rather than the
+	co-routine priority, until uxCoRoutineResetEventItemValue() is called. */
+	listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xEventListItem ), xItemValue );
+	vCoRoutineAddToDelayedList( xTicksToWait, NULL );
+	vListInsertEnd( pxEventList, &( pxCurrentCoRoutine->xEventListItem ) );
+}
+/*-----------------------------------------------------------*/
+
+void vCoRoutineRemoveFromUnorderedEventList( ListItem_t *pxEventListItem, const TickType_t xItemValue )
+{
+	/* Called by a task or co-routine with the scheduler suspended.  The ready
+	lists can only be accessed by the co-routine scheduler, so the co-routine
+	is moved to the pending ready list - which is also accessed by interrupts
+	and by prvCheckDelayedList() with interrupts disabled. */
+	listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue );
+
+	taskENTER_CRITICAL();
+	{
+		( void ) uxListRemove( pxEventListItem );
+		vListInsertEnd( ( List_t * ) &( xPendingReadyCoRoutineList ), pxEventListItem );
+		prvNotifyHostTask( NULL );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+TickType_t uxCoRoutineResetEventItemValue( void )
+{
+TickType_t uxReturn;
+
+	uxReturn = listGET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xEventListItem ) );
+
+	/* Reset the event list item to its normal value - so it can be used with
+	queues again. */
+	listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xEventListItem ), ( ( TickType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( TickType_t ) pxCurrentCoRoutine->uxPriority ) );
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	static void prvUnblockCoRoutine( CRCB_t *pxCRCB, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	const List_t *pxContainer = listLIST_ITEM_CONTAINER( &( pxCRCB->xGenericListItem ) );
+
+		/* Only move the co-routine if it is still blocked.  If its wait has
+		already timed out, or it has already been readied, then it is either
+		in a ready list or its event list item is in the pending ready list,
+		and it will see the notification when it next runs. */
+		if( ( ( pxContainer == &xDelayedCoRoutineList1 ) || ( pxContainer == &xDelayedCoRoutineList2 ) ) &&
+			( listLIST_ITEM_CONTAINER( &( pxCRCB->xEventListItem ) ) == NULL ) )
+		{
+			vListInsertEnd( ( List_t * ) &( xPendingReadyCoRoutineList ), &( pxCRCB->xEventListItem ) );
+			prvNotifyHostTask( pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	static BaseType_t prvNotifyCoRoutine( CRCB_t *pxCRCB, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	BaseType_t xReturn = pdPASS;
+	uint8_t ucOriginalNotifyState;
+
+		ucOriginalNotifyState = pxCRCB->ucNotifyState;
+		pxCRCB->ucNotifyState = corNOTIFICATION_RECEIVED;
+
+		switch( eAction )
+		{
+			case eSetBits	:
+				pxCRCB->ulNotifiedValue |= ulValue;
+				break;
+
+			case eIncrement	:
+				( pxCRCB->ulNotifiedValue )++;
+				break;
+
+			case eSetValueWithOverwrite	:
+				pxCRCB->ulNotifiedValue = ulValue;
+				break;
+
+			case eSetValueWithoutOverwrite :
+				if( ucOriginalNotifyState != corNOTIFICATION_RECEIVED )
+				{
+					pxCRCB->ulNotifiedValue = ulValue;
+				}
+				else
+				{
+					/* The value could not be written to the co-routine. */
+					xReturn = pdFAIL;
+				}
+				break;
+
+			case eNoAction :
+				/* The co-routine is being notified without its notify value
+				being updated. */
+				break;
+
+			default:
+				/* Should not get here if all enums are handled. */
+				configASSERT( pdFALSE );
+				break;
+		}
+
+		/* If the co-routine is in crNOTIFY_WAIT() then ready it. */
+		if( ucOriginalNotifyState == corWAITING_NOTIFICATION )
+		{
+			prvUnblockCoRoutine( pxCRCB, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	BaseType_t xCoRoutineNotify( CoRoutineHandle_t xCoRoutineToNotify, uint32_t ulValue, eNotifyAction eAction )
+	{
+	BaseType_t xReturn, xHostTaskWoken = pdFALSE;
+
+		configASSERT( xCoRoutineToNotify );
+
+		taskENTER_CRITICAL();
+		{
+			xReturn = prvNotifyCoRoutine( ( CRCB_t * ) xCoRoutineToNotify, ulValue, eAction, &xHostTaskWoken );
+		}
+		taskEXIT_CRITICAL();
+
+		if( xHostTaskWoken != pdFALSE )
+		{
+			/* The task running the co-routines has a priority above the
+			calling task. */
+			taskYIELD();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	BaseType_t xCoRoutineNotifyFromISR( CoRoutineHandle_t xCoRoutineToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	BaseType_t xReturn;
+	UBaseType_t uxSavedInterruptStatus;
+
+		configASSERT( xCoRoutineToNotify );
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			xReturn = prvNotifyCoRoutine( ( CRCB_t * ) xCoRoutineToNotify, ulValue, eAction, pxHigherPriorityTaskWoken );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	BaseType_t xCoRoutineNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	{
+	BaseType_t xReturn;
+
+		taskENTER_CRITICAL();
+		{
+			if( pxCurrentCoRoutine->ucNotifyState != corNOTIFICATION_RECEIVED )
+			{
+				/* Clear bits in the co-routine's notification value as bits
+				may get set by the notifying task, co-routine or interrupt. */
+				pxCurrentCoRoutine->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentCoRoutine->ucNotifyState = corWAITING_NOTIFICATION;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ( xTicksToWait > ( TickType_t ) 0 ) && ( pxCurrentCoRoutine->ucNotifyState == corWAITING_NOTIFICATION ) )
+			{
+				/* Block.  This is done inside the critical section so a
+				notification cannot be missed between setting the state and
+				entering the delayed list.  The co-routine macro calls this
+				function again, with no block time, when the co-routine next
+				runs. */
+				vCoRoutineAddToDelayedList( xTicksToWait, NULL );
+				xReturn = errQUEUE_BLOCKED;
+			}
+			else
+			{
+				if( pulNotificationValue != NULL )
+				{
+					/* Output the current notification value, which may or may
+					not have changed. */
+					*pulNotificationValue = pxCurrentCoRoutine->ulNotifiedValue;
+				}
+
+				if( pxCurrentCoRoutine->ucNotifyState != corNOTIFICATION_RECEIVED )
+				{
+					/* A notification was not received. */
+					xReturn = pdFAIL;
+				}
+				else
+				{
+					/* A notification was already pending or a notification was
+					received while the co-routine was blocked. */
+					pxCurrentCoRoutine->ulNotifiedValue &= ~ulBitsToClearOnExit;
+					xReturn = pdPASS;
+				}
+
+				pxCurrentCoRoutine->ucNotifyState = corNOT_WAITING_NOTIFICATION;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if( corUSE_GENERIC_COUNT_TRAILING_ZEROS == 1 )
+
+	static UBaseType_t prvCountTrailingZeros( uint32_t ulBits )
+	{
+	UBaseType_t uxCount = ( UBaseType_t ) 0;
+
+		/* ulBits must not be zero. */
+		while( ( ulBits & 0x01UL ) == 0UL )
+		{
+			ulBits >>= 1;
+			uxCount++;
+		}
+
+		return uxCount;
+	}
+
+#endif /* corUSE_GENERIC_COUNT_TRAILING_ZEROS */
 
 #endif /* configUSE_CO_ROUTINES == 0 */
 
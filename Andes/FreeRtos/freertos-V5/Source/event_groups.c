@@ -38,6 +38,11 @@ task.h is included from an application file. */
 #include "task.h"
 #include "timers.h"
 #include "event_groups.h"
+#include "slab.h"
+
+#if( configUSE_CO_ROUTINES == 1 )
+	#include "croutine.h"
+#endif
 
 /* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
 because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
@@ -65,6 +70,10 @@ typedef struct EventGroupDef_t
 	EventBits_t uxEventBits;
 	List_t xTasksWaitingForBits;		/*< List of tasks waiting for a bit to be set. */
 
+	#if( configUSE_CO_ROUTINES == 1 )
+		List_t xCoRoutinesWaitingForBits;	/*< List of co-routines waiting for a bit to be set. */
+	#endif
+
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxEventGroupNumber;
 	#endif
@@ -86,6 +95,14 @@ typedef struct EventGroupDef_t
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Unblock the tasks (or, if xCoRoutines is pdTRUE, the co-routines) in pxList
+ * whose wait condition is met by the current event bits.  Returns the bits that
+ * must be cleared because an unblocked waiter specified xClearOnExit.  Must be
+ * called with the scheduler suspended.
+ */
+static EventBits_t prvUnblockWaiters( EventGroup_t *pxEventBits, const List_t *pxList, const BaseType_t xCoRoutines ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -115,6 +132,12 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_CO_ROUTINES == 1 )
+			{
+				vListInitialise( &( pxEventBits->xCoRoutinesWaitingForBits ) );
+			}
+			#endif
+
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note that
@@ -159,13 +182,19 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 		sizeof( TickType_t ), the TickType_t variables will be accessed in two
 		or more reads operations, and the alignment requirements is only that
 		of each individual read. */
-		pxEventBits = ( EventGroup_t * ) pvPortMalloc( sizeof( EventGroup_t ) ); /*lint !e9087 !e9079 see comment above. */
+		pxEventBits = ( EventGroup_t * ) slabALLOCATE_OBJECT( eSlabCacheEventGroup, sizeof( EventGroup_t ) ); /*lint !e9087 !e9079 see comment above. */
 
 		if( pxEventBits != NULL )
 		{
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_CO_ROUTINES == 1 )
+			{
+				vListInitialise( &( pxEventBits->xCoRoutinesWaitingForBits ) );
+			}
+			#endif
+
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note this
@@ -518,95 +547,127 @@ EventBits_t uxReturn;
 
 EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet )
 {
-ListItem_t *pxListItem, *pxNext;
-ListItem_t const *pxListEnd;
-List_t const * pxList;
-EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+EventBits_t uxBitsToClear;
 EventGroup_t *pxEventBits = xEventGroup;
-BaseType_t xMatchFound = pdFALSE;
 
 	/* Check the user is not attempting to set the bits used by the kernel
 	itself. */
 	configASSERT( xEventGroup );
 	configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-	pxList = &( pxEventBits->xTasksWaitingForBits );
-	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	vTaskSuspendAll();
 	{
 		traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-		pxListItem = listGET_HEAD_ENTRY( pxList );
-
 		/* Set the bits. */
 		pxEventBits->uxEventBits |= uxBitsToSet;
 
-		/* See if the new bit value should unblock any tasks. */
-		while( pxListItem != pxListEnd )
+		/* See if the new bit value should unblock any tasks or co-routines.
+		Bits are only cleared once all the waiters have been tested, so every
+		waiter sees the same bit value. */
+		uxBitsToClear = prvUnblockWaiters( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), pdFALSE );
+
+		#if( configUSE_CO_ROUTINES == 1 )
 		{
-			pxNext = listGET_NEXT( pxListItem );
-			uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-			xMatchFound = pdFALSE;
+			uxBitsToClear |= prvUnblockWaiters( pxEventBits, &( pxEventBits->xCoRoutinesWaitingForBits ), pdTRUE );
+		}
+		#endif
+
+		/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+		bit was set in the control word. */
+		pxEventBits->uxEventBits &= ~uxBitsToClear;
+	}
+	( void ) xTaskResumeAll();
 
-			/* Split the bits waited for from the control bits. */
-			uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-			uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+	return pxEventBits->uxEventBits;
+}
+/*-----------------------------------------------------------*/
 
-			if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+static EventBits_t prvUnblockWaiters( EventGroup_t *pxEventBits, const List_t *pxList, const BaseType_t xCoRoutines )
+{
+ListItem_t *pxListItem, *pxNext;
+ListItem_t const *pxListEnd;
+EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+BaseType_t xMatchFound = pdFALSE;
+
+	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+	pxListItem = listGET_HEAD_ENTRY( pxList );
+
+	while( pxListItem != pxListEnd )
+	{
+		pxNext = listGET_NEXT( pxListItem );
+		uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+		xMatchFound = pdFALSE;
+
+		/* Split the bits waited for from the control bits. */
+		uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+		uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+		if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+		{
+			/* Just looking for single bit being set. */
+			if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
 			{
-				/* Just looking for single bit being set. */
-				if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-				{
-					xMatchFound = pdTRUE;
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
+				xMatchFound = pdTRUE;
 			}
-			else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+			else
 			{
-				/* All bits are set. */
-				xMatchFound = pdTRUE;
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+		{
+			/* All bits are set. */
+			xMatchFound = pdTRUE;
+		}
+		else
+		{
+			/* Need all bits to be set, but not all the bits were set. */
+		}
+
+		if( xMatchFound != pdFALSE )
+		{
+			/* The bits match.  Should the bits be cleared on exit? */
+			if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+			{
+				uxBitsToClear |= uxBitsWaitedFor;
 			}
 			else
 			{
-				/* Need all bits to be set, but not all the bits were set. */
+				mtCOVERAGE_TEST_MARKER();
 			}
 
-			if( xMatchFound != pdFALSE )
+			/* Store the actual event flag value in the task's event list
+			item before removing the task from the event list.  The
+			eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+			that is was unblocked due to its required bits matching, rather
+			than because it timed out. */
+			#if( configUSE_CO_ROUTINES == 1 )
 			{
-				/* The bits match.  Should the bits be cleared on exit? */
-				if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+				if( xCoRoutines != pdFALSE )
 				{
-					uxBitsToClear |= uxBitsWaitedFor;
+					vCoRoutineRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
 				}
-
-				/* Store the actual event flag value in the task's event list
-				item before removing the task from the event list.  The
-				eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-				that is was unblocked due to its required bits matching, rather
-				than because it timed out. */
+			}
+			#else
+			{
+				( void ) xCoRoutines;
 				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
 			}
-
-			/* Move onto the next list item.  Note pxListItem->pxNext is not
-			used here as the list item may have been removed from the event list
-			and inserted into the ready/pending reading list. */
-			pxListItem = pxNext;
+			#endif
 		}
 
-		/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
-		bit was set in the control word. */
-		pxEventBits->uxEventBits &= ~uxBitsToClear;
+		/* Move onto the next list item.  Note pxListItem->pxNext is not
+		used here as the list item may have been removed from the event list
+		and inserted into the ready/pending reading list. */
+		pxListItem = pxNext;
 	}
-	( void ) xTaskResumeAll();
 
-	return pxEventBits->uxEventBits;
+	return uxBitsToClear;
 }
 /*-----------------------------------------------------------*/
 
@@ -627,11 +688,23 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 			vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
 		}
 
+		#if( configUSE_CO_ROUTINES == 1 )
+		{
+			const List_t *pxCoRoutinesWaitingForBits = &( pxEventBits->xCoRoutinesWaitingForBits );
+
+			while( listCURRENT_LIST_LENGTH( pxCoRoutinesWaitingForBits ) > ( UBaseType_t ) 0 )
+			{
+				/* As above, but for co-routines. */
+				vCoRoutineRemoveFromUnorderedEventList( pxCoRoutinesWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+			}
+		}
+		#endif
+
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
 		{
 			/* The event group can only have been allocated dynamically - free
 			it again. */
-			vPortFree( pxEventBits );
+			slabFREE_OBJECT( eSlabCacheEventGroup, pxEventBits );
 		}
 		#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
 		{
@@ -639,7 +712,7 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 			dynamically, so check before attempting to free the memory. */
 			if( pxEventBits->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
 			{
-				vPortFree( pxEventBits );
+				slabFREE_OBJECT( eSlabCacheEventGroup, pxEventBits );
 			}
 			else
 			{
@@ -652,6 +725,101 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_CO_ROUTINES == 1 )
+
+	BaseType_t xEventGroupCRWaitBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, EventBits_t *puxEventBits, TickType_t xTicksToWait )
+	{
+	EventGroup_t *pxEventBits = xEventGroup;
+	EventBits_t uxReturn, uxControlBits = 0;
+	BaseType_t xReturn = pdFAIL;
+
+		configASSERT( xEventGroup );
+		configASSERT( puxEventBits );
+		configASSERT( ( uxBitsToWaitFor & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+		configASSERT( uxBitsToWaitFor != 0 );
+
+		/* If the co-routine was unblocked by xEventGroupSetBits() then the bits
+		that unblocked it are in its event list item.  Reading the value also
+		resets it, so this is only true on the second call made by
+		crEVENT_GROUP_WAIT_BITS() after the co-routine blocked. */
+		uxReturn = uxCoRoutineResetEventItemValue();
+
+		if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) != ( EventBits_t ) 0 )
+		{
+			/* The bits were already cleared by xEventGroupSetBits(), if
+			xClearOnExit was set. */
+			*puxEventBits = uxReturn & ~eventEVENT_BITS_CONTROL_BYTES;
+			xReturn = pdPASS;
+		}
+		else
+		{
+			vTaskSuspendAll();
+			{
+				const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
+
+				*puxEventBits = uxCurrentEventBits;
+
+				/* Check to see if the wait condition is already met, which is also
+				the case if the bits were set between a timeout and the co-routine
+				running again. */
+				if( prvTestWaitCondition( uxCurrentEventBits, uxBitsToWaitFor, xWaitForAllBits ) != pdFALSE )
+				{
+					/* Clear the wait bits if requested to do so. */
+					if( xClearOnExit != pdFALSE )
+					{
+						pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xReturn = pdPASS;
+				}
+				else if( xTicksToWait != ( TickType_t ) 0 )
+				{
+					/* The co-routine is going to block.  uxControlBits remember the
+					behaviour requested of this call for use when the event bits
+					unblock the co-routine, exactly as for a task. */
+					if( xClearOnExit != pdFALSE )
+					{
+						uxControlBits |= eventCLEAR_EVENTS_ON_EXIT_BIT;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					if( xWaitForAllBits != pdFALSE )
+					{
+						uxControlBits |= eventWAIT_FOR_ALL_BITS;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					vCoRoutinePlaceOnUnorderedEventList( &( pxEventBits->xCoRoutinesWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+					xReturn = errQUEUE_BLOCKED;
+
+					traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
+				}
+				else
+				{
+					/* The wait condition was not met and no block time was
+					specified, or the block time expired. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			( void ) xTaskResumeAll();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINES */
+/*-----------------------------------------------------------*/
+
 /* For internal use only - execute a 'set bits' command that was pended from
 an interrupt. */
 void vEventGroupSetBitsCallback( void *pvEventGroup, const uint32_t ulBitsToSet )
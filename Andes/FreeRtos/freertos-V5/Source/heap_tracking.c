@@ -0,0 +1,344 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_tracking.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to track heap allocations.  This #if is closed at the very bottom of this file.
+If you want to track heap allocations then ensure configUSE_HEAP_TRACKING is
+set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_HEAP_TRACKING == 1 )
+
+#if ( configUSE_STATS_FORMATTING_FUNCTIONS == 1 )
+	/* vHeapTrackingList() uses snprintf(). */
+	#include <stdio.h>
+#endif
+
+/* The number of 32-bit values in the header of a dump, and the number of
+blocks read from the heap at a time when writing a dump or a list. */
+#define heaptrackDUMP_HEADER_WORDS		( 8U )
+#define heaptrackBATCH_SIZE				( 8U )
+
+/* The size of each block record in a dump. */
+#define heaptrackDUMP_RECORD_SIZE		( ( 4U * sizeof( void * ) ) + sizeof( uint32_t ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the histogram bucket that counts ulValue.
+ */
+static UBaseType_t prvHistogramBucket( uint32_t ulValue );
+
+/*
+ * Write a value of xSize bytes to the dump at pucBuffer, and return the
+ * position following the value.
+ */
+static uint8_t *prvDumpValue( uint8_t *pucBuffer, const void *pvValue, size_t xSize );
+
+/*-----------------------------------------------------------*/
+
+/* The histograms and counters.  ulNextSequence is only set in copies. */
+static HeapTrackingStats_t xStats;
+
+/* The sequence number given to the next allocation.  0 is never used, as it
+identifies blocks held in a task heap cache. */
+static uint32_t ulNextSequence = 1UL;
+
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHistogramBucket( uint32_t ulValue )
+{
+UBaseType_t uxBucket = 0;
+
+	while( ( ulValue > 1UL ) && ( uxBucket < ( UBaseType_t ) ( heaptrackHISTOGRAM_BUCKETS - 1 ) ) )
+	{
+		ulValue >>= 1;
+		uxBucket++;
+	}
+
+	return uxBucket;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulHeapTrackingRecordAllocation( size_t xWantedSize, uint32_t ulCycles )
+{
+uint32_t ulSequence;
+
+	/* Requests too large to fit in 32 bits are counted in the last bucket. */
+	if( xWantedSize > ( size_t ) UINT32_MAX )
+	{
+		xWantedSize = ( size_t ) UINT32_MAX;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		xStats.ulSizeHistogram[ prvHistogramBucket( ( uint32_t ) xWantedSize ) ]++;
+		xStats.ulAllocationCycleHistogram[ prvHistogramBucket( ulCycles ) ]++;
+
+		if( ulCycles > xStats.ulMaximumAllocationCycles )
+		{
+			xStats.ulMaximumAllocationCycles = ulCycles;
+		}
+
+		ulSequence = ulNextSequence;
+		ulNextSequence++;
+
+		if( ulNextSequence == 0UL )
+		{
+			ulNextSequence = 1UL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return ulSequence;
+}
+/*-----------------------------------------------------------*/
+
+void vHeapTrackingRecordFailure( size_t xWantedSize )
+{
+	if( xWantedSize > ( size_t ) UINT32_MAX )
+	{
+		xWantedSize = ( size_t ) UINT32_MAX;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		xStats.ulFailedAllocations++;
+
+		if( ( uint32_t ) xWantedSize > xStats.ulLargestFailedRequest )
+		{
+			xStats.ulLargestFailedRequest = ( uint32_t ) xWantedSize;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vHeapTrackingRecordFree( uint32_t ulCycles )
+{
+	taskENTER_CRITICAL();
+	{
+		xStats.ulFreeCycleHistogram[ prvHistogramBucket( ulCycles ) ]++;
+
+		if( ulCycles > xStats.ulMaximumFreeCycles )
+		{
+			xStats.ulMaximumFreeCycles = ulCycles;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulHeapTrackingGetSequence( void )
+{
+uint32_t ulSequence;
+
+	taskENTER_CRITICAL();
+	{
+		ulSequence = ulNextSequence;
+	}
+	taskEXIT_CRITICAL();
+
+	return ulSequence;
+}
+/*-----------------------------------------------------------*/
+
+void vHeapTrackingGetStats( HeapTrackingStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xStats;
+		pxStats->ulNextSequence = ulNextSequence;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vHeapTrackingResetStats( void )
+{
+	taskENTER_CRITICAL();
+	{
+		memset( ( void * ) &xStats, 0x00, sizeof( xStats ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvDumpValue( uint8_t *pucBuffer, const void *pvValue, size_t xSize )
+{
+	/* The buffer need not be aligned, so copy the bytes. */
+	memcpy( ( void * ) pucBuffer, pvValue, xSize );
+	return pucBuffer + xSize;
+}
+/*-----------------------------------------------------------*/
+
+size_t xHeapTrackingDump( uint8_t *pucBuffer, size_t xBufferLength, uint32_t ulFromSequence )
+{
+HeapTrackingStats_t xSnapshot;
+HeapAllocation_t xAllocations[ heaptrackBATCH_SIZE ];
+uint32_t ulHeader[ heaptrackDUMP_HEADER_WORDS ];
+uint32_t ulBlocksWritten = 0, ulBlocksAllocated = 0;
+UBaseType_t uxBlocks, uxBlock;
+uint8_t *pucNext, *pucHeader;
+const size_t xFixedSize = sizeof( ulHeader ) + sizeof( xSnapshot );
+uintptr_t uxWord;
+
+	if( xBufferLength < xFixedSize )
+	{
+		return 0;
+	}
+
+	vHeapTrackingGetStats( &xSnapshot );
+
+	/* The header is written last, once the number of blocks is known. */
+	pucHeader = pucBuffer;
+	pucNext = prvDumpValue( pucBuffer + sizeof( ulHeader ), &xSnapshot, sizeof( xSnapshot ) );
+
+	/* Read the blocks a batch at a time, with the scheduler suspended so no
+	task can allocate or free a block between batches.  Blocks that do not fit
+	in the buffer are still counted. */
+	vTaskSuspendAll();
+	do
+	{
+		uxBlocks = uxPortGetHeapAllocations( xAllocations, heaptrackBATCH_SIZE, ( UBaseType_t ) ulBlocksAllocated, ulFromSequence );
+
+		for( uxBlock = 0; uxBlock < uxBlocks; uxBlock++ )
+		{
+			if( ( size_t ) ( ( pucBuffer + xBufferLength ) - pucNext ) >= heaptrackDUMP_RECORD_SIZE )
+			{
+				uxWord = ( uintptr_t ) xAllocations[ uxBlock ].pvAddress;
+				pucNext = prvDumpValue( pucNext, &uxWord, sizeof( uxWord ) );
+				uxWord = ( uintptr_t ) xAllocations[ uxBlock ].xSize;
+				pucNext = prvDumpValue( pucNext, &uxWord, sizeof( uxWord ) );
+				uxWord = ( uintptr_t ) xAllocations[ uxBlock ].pvCaller;
+				pucNext = prvDumpValue( pucNext, &uxWord, sizeof( uxWord ) );
+				uxWord = ( uintptr_t ) xAllocations[ uxBlock ].xOwner;
+				pucNext = prvDumpValue( pucNext, &uxWord, sizeof( uxWord ) );
+				pucNext = prvDumpValue( pucNext, &( xAllocations[ uxBlock ].ulSequence ), sizeof( uint32_t ) );
+				ulBlocksWritten++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			ulBlocksAllocated++;
+		}
+	} while( uxBlocks == heaptrackBATCH_SIZE );
+	( void ) xTaskResumeAll();
+
+	ulHeader[ 0 ] = heaptrackDUMP_MAGIC;
+	ulHeader[ 1 ] = heaptrackDUMP_VERSION;
+	ulHeader[ 2 ] = ( uint32_t ) sizeof( void * );
+	ulHeader[ 3 ] = heaptrackHISTOGRAM_BUCKETS;
+	ulHeader[ 4 ] = ulBlocksWritten;
+	ulHeader[ 5 ] = ulBlocksAllocated;
+	ulHeader[ 6 ] = ulFromSequence;
+	ulHeader[ 7 ] = 0UL;
+	( void ) prvDumpValue( pucHeader, ulHeader, sizeof( ulHeader ) );
+
+	return ( size_t ) ( pucNext - pucBuffer );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
+
+	void vHeapTrackingList( char *pcWriteBuffer, size_t xBufferLength, uint32_t ulFromSequence )
+	{
+	HeapAllocation_t xAllocations[ heaptrackBATCH_SIZE ];
+	UBaseType_t uxBlocks, uxBlock, uxListed = 0;
+	size_t xBytes = 0, xRemaining = xBufferLength;
+	int iWritten;
+
+		/*
+		 * PLEASE NOTE:
+		 *
+		 * This function is provided for convenience only.  Do not consider it
+		 * to be part of the memory allocator.
+		 *
+		 * The blocks are read from the heap a batch at a time, so blocks
+		 * allocated or freed while the list is being written can be missed or
+		 * listed twice.
+		 */
+
+		if( xBufferLength == 0 )
+		{
+			return;
+		}
+
+		*pcWriteBuffer = ( char ) 0x00;
+
+		do
+		{
+			uxBlocks = uxPortGetHeapAllocations( xAllocations, heaptrackBATCH_SIZE, uxListed, ulFromSequence );
+
+			for( uxBlock = 0; uxBlock < uxBlocks; uxBlock++ )
+			{
+				iWritten = snprintf( pcWriteBuffer, xRemaining, "%p\t%u\t%p\t%p\t%u\r\n", xAllocations[ uxBlock ].pvAddress, ( unsigned int ) xAllocations[ uxBlock ].xSize, xAllocations[ uxBlock ].pvCaller, ( void * ) xAllocations[ uxBlock ].xOwner, ( unsigned int ) xAllocations[ uxBlock ].ulSequence ); /*lint !e586 snprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+
+				if( ( iWritten < 0 ) || ( ( size_t ) iWritten >= xRemaining ) )
+				{
+					/* The buffer is full.  snprintf() has terminated the
+					string. */
+					return;
+				}
+
+				pcWriteBuffer += iWritten;
+				xRemaining -= ( size_t ) iWritten;
+				xBytes += xAllocations[ uxBlock ].xSize;
+			}
+
+			uxListed += uxBlocks;
+		} while( uxBlocks == heaptrackBATCH_SIZE );
+
+		( void ) snprintf( pcWriteBuffer, xRemaining, "%u blocks, %u bytes\r\n", ( unsigned int ) uxListed, ( unsigned int ) xBytes ); /*lint !e586 snprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+	}
+
+#endif /* configUSE_STATS_FORMATTING_FUNCTIONS */
+
+/* This entire source file will be skipped if the application is not configured
+to track heap allocations.  If you want to track heap allocations then ensure
+configUSE_HEAP_TRACKING is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_HEAP_TRACKING == 1 */
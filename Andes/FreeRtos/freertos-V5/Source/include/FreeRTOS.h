@@ -206,6 +206,80 @@ extern "C" {
 	#define configUSE_MUTEXES 0
 #endif
 
+#ifndef configUSE_TRANSITIVE_PRIORITY_INHERITANCE
+	#define configUSE_TRANSITIVE_PRIORITY_INHERITANCE 0
+#endif
+
+#ifndef configMAX_PRIORITY_INHERITANCE_DEPTH
+	/* The maximum number of mutex holders a priority is propagated through
+	when configUSE_TRANSITIVE_PRIORITY_INHERITANCE is 1. */
+	#define configMAX_PRIORITY_INHERITANCE_DEPTH 8
+#endif
+
+#ifndef configUSE_CEILING_MUTEXES
+	#define configUSE_CEILING_MUTEXES 0
+#endif
+
+#ifndef configUSE_FAST_SEMAPHORES
+	#define configUSE_FAST_SEMAPHORES 0
+#endif
+
+#ifndef configUSE_RW_LOCKS
+	#define configUSE_RW_LOCKS 0
+#endif
+
+#ifndef configUSE_MEMORY_POOLS
+	#define configUSE_MEMORY_POOLS 0
+#endif
+
+#ifndef configUSE_KERNEL_OBJECT_SLABS
+	#define configUSE_KERNEL_OBJECT_SLABS 0
+#endif
+
+#ifndef configSLAB_OBJECTS_PER_SLAB
+	#define configSLAB_OBJECTS_PER_SLAB 8
+#endif
+
+#ifndef configUSE_TASK_HEAP_CACHE
+	#define configUSE_TASK_HEAP_CACHE 0
+#endif
+
+#ifndef configHEAP_CACHE_SIZE_CLASSES
+	#define configHEAP_CACHE_SIZE_CLASSES 4
+#endif
+
+#ifndef configUSE_SHARED_STACK_TASKS
+	#define configUSE_SHARED_STACK_TASKS 0
+#endif
+
+#ifndef configSHARED_STACK_DEPTH
+	#define configSHARED_STACK_DEPTH configMINIMAL_STACK_SIZE
+#endif
+
+#ifndef configHEAP_CACHE_DEPTH
+	#define configHEAP_CACHE_DEPTH 4
+#endif
+
+#ifndef configUSE_HEAP_TRACKING
+	#define configUSE_HEAP_TRACKING 0
+#endif
+
+#ifndef configUSE_SECTION_PROFILING
+	#define configUSE_SECTION_PROFILING 0
+#endif
+
+#ifndef configSECTION_PROFILE_LONGEST
+	#define configSECTION_PROFILE_LONGEST 8
+#endif
+
+#ifndef configUSE_ALIGNED_KERNEL_OBJECTS
+	#define configUSE_ALIGNED_KERNEL_OBJECTS 0
+#endif
+
+#ifndef configKERNEL_OBJECT_ALIGNMENT
+	#define configKERNEL_OBJECT_ALIGNMENT portBYTE_ALIGNMENT
+#endif
+
 #ifndef configUSE_TIMERS
 	#define configUSE_TIMERS 0
 #endif
@@ -402,6 +476,14 @@ hold explicit before calling the code. */
 	#define configRECORD_STACK_HIGH_ADDRESS 0
 #endif
 
+#ifndef configRECORD_STACK_PEAK
+	#define configRECORD_STACK_PEAK 0
+#endif
+
+#if( ( configRECORD_STACK_PEAK == 1 ) && ( ( portHAS_STACK_PEAK_RECORDING == 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 0 ) || ( portSTACK_GROWTH > 0 ) ) )
+	#error configRECORD_STACK_PEAK needs a port that records the deepest stack pointer of each task, a stack that grows down, and configRECORD_STACK_HIGH_ADDRESS set to 1
+#endif
+
 #ifndef configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H
 	#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H 0
 #endif
@@ -576,6 +658,14 @@ hold explicit before calling the code. */
     #define traceFREE( pvAddress, uiSize )
 #endif
 
+#ifndef traceSLAB_CACHE_ALLOCATE
+	#define traceSLAB_CACHE_ALLOCATE( eCache, pvObject )
+#endif
+
+#ifndef traceSLAB_CACHE_FREE
+	#define traceSLAB_CACHE_FREE( eCache, pvObject )
+#endif
+
 #ifndef traceEVENT_GROUP_CREATE
 	#define traceEVENT_GROUP_CREATE( xEventGroup )
 #endif
@@ -620,6 +710,70 @@ hold explicit before calling the code. */
 	#define traceEVENT_GROUP_DELETE( xEventGroup )
 #endif
 
+#ifndef traceRWLOCK_CREATE
+	#define traceRWLOCK_CREATE( xRWLock )
+#endif
+
+#ifndef traceRWLOCK_CREATE_FAILED
+	#define traceRWLOCK_CREATE_FAILED()
+#endif
+
+#ifndef traceRWLOCK_ACQUIRE
+	#define traceRWLOCK_ACQUIRE( xRWLock, xForWriting )
+#endif
+
+#ifndef traceRWLOCK_ACQUIRE_FAILED
+	#define traceRWLOCK_ACQUIRE_FAILED( xRWLock, xForWriting )
+#endif
+
+#ifndef traceBLOCKING_ON_RWLOCK
+	#define traceBLOCKING_ON_RWLOCK( xRWLock, xForWriting )
+#endif
+
+#ifndef traceRWLOCK_RELEASE
+	#define traceRWLOCK_RELEASE( xRWLock, xForWriting )
+#endif
+
+#ifndef traceRWLOCK_DELETE
+	#define traceRWLOCK_DELETE( xRWLock )
+#endif
+
+#ifndef traceMEMPOOL_CREATE
+	#define traceMEMPOOL_CREATE( xMemPool )
+#endif
+
+#ifndef traceMEMPOOL_CREATE_FAILED
+	#define traceMEMPOOL_CREATE_FAILED()
+#endif
+
+#ifndef traceMEMPOOL_ALLOC
+	#define traceMEMPOOL_ALLOC( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEMPOOL_ALLOC_FAILED
+	#define traceMEMPOOL_ALLOC_FAILED( xMemPool )
+#endif
+
+#ifndef traceBLOCKING_ON_MEMPOOL_ALLOC
+	#define traceBLOCKING_ON_MEMPOOL_ALLOC( xMemPool )
+#endif
+
+#ifndef traceMEMPOOL_ALLOC_FROM_ISR
+	#define traceMEMPOOL_ALLOC_FROM_ISR( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEMPOOL_FREE
+	#define traceMEMPOOL_FREE( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEMPOOL_FREE_FROM_ISR
+	#define traceMEMPOOL_FREE_FROM_ISR( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEMPOOL_DELETE
+	#define traceMEMPOOL_DELETE( xMemPool )
+#endif
+
 #ifndef tracePEND_FUNC_CALL
 	#define tracePEND_FUNC_CALL(xFunctionToPend, pvParameter1, ulParameter2, ret)
 #endif
@@ -778,6 +932,18 @@ hold explicit before calling the code. */
 	#define configUSE_QUEUE_SETS 0
 #endif
 
+#ifndef configUSE_QUEUE_SET_BITMAP
+	#define configUSE_QUEUE_SET_BITMAP 0
+#endif
+
+#ifndef configUSE_SKIP_LISTS
+	#define configUSE_SKIP_LISTS 0
+#endif
+
+#ifndef configSKIP_LIST_LEVELS
+	#define configSKIP_LIST_LEVELS 4
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
 	#define portTASK_USES_FLOATING_POINT()
 #endif
@@ -842,6 +1008,45 @@ hold explicit before calling the code. */
 	#define portTICK_TYPE_IS_ATOMIC 0
 #endif
 
+#ifndef portHAS_ATOMIC_INSTRUCTIONS
+	/* Set to 1 in portmacro.h if the compiler's __atomic built-in functions
+	can be used to implement atomic.h without a critical section. */
+	#define portHAS_ATOMIC_INSTRUCTIONS 0
+#endif
+
+#ifndef portGET_CYCLE_COUNT
+	/* Returns a free running 32-bit count used to time kernel operations, such
+	as heap allocations when configUSE_HEAP_TRACKING is 1.  Ports that have a
+	cycle counter define this in portmacro.h. */
+	#define portGET_CYCLE_COUNT() ( ( uint32_t ) 0UL )
+#endif
+
+#ifndef portGET_CALLER_ADDRESS
+	/* Returns the return address of the function in which it is used, or NULL
+	if the port cannot provide it. */
+	#define portGET_CALLER_ADDRESS() ( ( void * ) NULL )
+#endif
+
+/* The alignment of the kernel objects, task stacks, and queue and stream buffer
+storage areas that the kernel allocates from the heap.  If
+configUSE_ALIGNED_KERNEL_OBJECTS is 1 then configKERNEL_OBJECT_ALIGNMENT is used
+where it is larger than portBYTE_ALIGNMENT.  configKERNEL_OBJECT_ALIGNMENT can
+be an expression that is evaluated at run time, such as a function that returns
+the data cache line size, so an object does not share a cache line with
+unrelated data.  pvPortMallocAligned() is then required, which is provided by
+heap_4.c and heap_5.c. */
+#if( configUSE_ALIGNED_KERNEL_OBJECTS == 1 )
+	#define portKERNEL_OBJECT_ALIGNMENT ( ( ( size_t ) ( configKERNEL_OBJECT_ALIGNMENT ) > ( size_t ) portBYTE_ALIGNMENT ) ? ( size_t ) ( configKERNEL_OBJECT_ALIGNMENT ) : ( size_t ) portBYTE_ALIGNMENT )
+	#define pvPortMallocKernelObject( xSize ) pvPortMallocAligned( ( xSize ), portKERNEL_OBJECT_ALIGNMENT )
+#else
+	#define portKERNEL_OBJECT_ALIGNMENT ( ( size_t ) portBYTE_ALIGNMENT )
+	#define pvPortMallocKernelObject( xSize ) pvPortMalloc( xSize )
+#endif
+
+/* xSize rounded up to a multiple of portKERNEL_OBJECT_ALIGNMENT, used where an
+object and its storage area are allocated together. */
+#define portKERNEL_OBJECT_SIZE( xSize ) ( ( ( size_t ) ( xSize ) + ( portKERNEL_OBJECT_ALIGNMENT - ( size_t ) 1 ) ) & ~( portKERNEL_OBJECT_ALIGNMENT - ( size_t ) 1 ) )
+
 #ifndef configSUPPORT_STATIC_ALLOCATION
 	/* Defaults to 0 for backward compatibility. */
 	#define configSUPPORT_STATIC_ALLOCATION 0
@@ -880,6 +1085,62 @@ hold explicit before calling the code. */
 	#error configUSE_MUTEXES must be set to 1 to use recursive mutexes
 #endif
 
+#if( ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error configUSE_MUTEXES must be set to 1 to use transitive priority inheritance
+#endif
+
+#if( ( configUSE_CEILING_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error configUSE_MUTEXES must be set to 1 to use priority ceiling mutexes
+#endif
+
+#if( ( configUSE_RW_LOCKS == 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error configUSE_MUTEXES must be set to 1 to use reader-writer locks
+#endif
+
+#if( ( configUSE_QUEUE_SET_BITMAP == 1 ) && ( configUSE_QUEUE_SETS != 1 ) )
+	#error configUSE_QUEUE_SETS must be set to 1 to use readiness bitmap queue sets
+#endif
+
+#if( ( configUSE_SKIP_LISTS == 1 ) && ( ( configSKIP_LIST_LEVELS < 1 ) || ( configSKIP_LIST_LEVELS > 15 ) ) )
+	#error configSKIP_LIST_LEVELS must be between 1 and 15
+#endif
+
+#if( ( configUSE_KERNEL_OBJECT_SLABS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use kernel object slab caches
+#endif
+
+#if( configSLAB_OBJECTS_PER_SLAB < 1 )
+	#error configSLAB_OBJECTS_PER_SLAB must be at least 1
+#endif
+
+#if( ( configUSE_ALIGNED_KERNEL_OBJECTS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use aligned kernel objects
+#endif
+
+#if( ( configUSE_TASK_HEAP_CACHE == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use per task heap caches
+#endif
+
+#if( ( configUSE_TASK_HEAP_CACHE == 1 ) && ( ( configHEAP_CACHE_SIZE_CLASSES < 1 ) || ( configHEAP_CACHE_DEPTH < 1 ) ) )
+	#error configHEAP_CACHE_SIZE_CLASSES and configHEAP_CACHE_DEPTH must both be at least 1
+#endif
+
+#if( ( configUSE_SHARED_STACK_TASKS == 1 ) && ( ( configUSE_TASK_NOTIFICATIONS != 1 ) || ( INCLUDE_vTaskSuspend != 1 ) || ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) ) )
+	#error Run to completion tasks are triggered by task notifications, wait in the suspended list and use dynamically allocated shared stacks, so require configUSE_TASK_NOTIFICATIONS, INCLUDE_vTaskSuspend and configSUPPORT_DYNAMIC_ALLOCATION to be 1
+#endif
+
+#if( ( configUSE_SHARED_STACK_TASKS == 1 ) && ( portUSING_MPU_WRAPPERS == 1 ) )
+	#error Run to completion tasks are not supported by MPU ports
+#endif
+
+#if( ( configUSE_HEAP_TRACKING == 1 ) && ( ( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) ) || ( ( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 ) ) ) )
+	#error Heap tracking records the task that allocates each block, so requires xTaskGetCurrentTaskHandle() and xTaskGetSchedulerState() to be available
+#endif
+
+#if( ( configUSE_SECTION_PROFILING == 1 ) && ( configSECTION_PROFILE_LONGEST < 1 ) )
+	#error configSECTION_PROFILE_LONGEST must be at least 1
+#endif
+
 #ifndef configINITIAL_TICK_COUNT
 	#define configINITIAL_TICK_COUNT 0
 #endif
@@ -1065,6 +1326,10 @@ struct xSTATIC_LIST_ITEM
 	#endif
 	TickType_t xDummy2;
 	void *pvDummy3[ 4 ];
+	#if( configUSE_SKIP_LISTS == 1 )
+		void *pvDummy5[ 2 * configSKIP_LIST_LEVELS ];
+		UBaseType_t uxDummy6;
+	#endif
 	#if( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
 		TickType_t xDummy4;
 	#endif
@@ -1079,6 +1344,9 @@ struct xSTATIC_MINI_LIST_ITEM
 	#endif
 	TickType_t xDummy2;
 	void *pvDummy3[ 2 ];
+	#if( configUSE_SKIP_LISTS == 1 )
+		void *pvDummy4[ 2 + ( 2 * configSKIP_LIST_LEVELS ) ];
+	#endif
 };
 typedef struct xSTATIC_MINI_LIST_ITEM StaticMiniListItem_t;
 
@@ -1122,14 +1390,27 @@ typedef struct xSTATIC_TCB
 	#if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
 		void			*pxDummy8;
 	#endif
+	#if ( configRECORD_STACK_PEAK == 1 )
+		void			*pxDummy25;
+	#endif
 	#if ( portCRITICAL_NESTING_IN_TCB == 1 )
 		UBaseType_t		uxDummy9;
+		#if ( configUSE_SECTION_PROFILING == 1 )
+			uint32_t	ulDummy26[ 2 ];
+			void		*pvDummy27;
+		#endif
 	#endif
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t		uxDummy10[ 2 ];
 	#endif
 	#if ( configUSE_MUTEXES == 1 )
 		UBaseType_t		uxDummy12[ 2 ];
+		#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+			void		*pvDummy13[ 2 ];
+			#if ( configUSE_RW_LOCKS == 1 )
+				void	*pvDummy28[ 2 ];
+			#endif
+		#endif
 	#endif
 	#if ( configUSE_APPLICATION_TASK_TAG == 1 )
 		void			*pxDummy14;
@@ -1137,6 +1418,12 @@ typedef struct xSTATIC_TCB
 	#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
 		void			*pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
 	#endif
+	#if( configUSE_TASK_HEAP_CACHE == 1 )
+		void			*pvDummy23[ configHEAP_CACHE_SIZE_CLASSES ];
+	#endif
+	#if( configUSE_SHARED_STACK_TASKS == 1 )
+		void			*pvDummy24[ 3 ];
+	#endif
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 		uint32_t		ulDummy16;
 	#endif
@@ -1183,16 +1470,32 @@ typedef struct xSTATIC_QUEUE
 		UBaseType_t uxDummy2;
 	} u;
 
+	#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+		void *pvDummy10;
+	#endif
+
+	#if ( configUSE_CEILING_MUTEXES == 1 )
+		UBaseType_t uxDummy11;
+	#endif
+
 	StaticList_t xDummy3[ 2 ];
 	UBaseType_t uxDummy4[ 3 ];
 	uint8_t ucDummy5[ 2 ];
 
+	#if ( configUSE_FAST_SEMAPHORES == 1 )
+		uint32_t ulDummy12;
+		UBaseType_t uxDummy13;
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucDummy6;
 	#endif
 
 	#if ( configUSE_QUEUE_SETS == 1 )
 		void *pvDummy7;
+		#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+			UBaseType_t uxDummy14;
+		#endif
 	#endif
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -1222,6 +1525,10 @@ typedef struct xSTATIC_EVENT_GROUP
 	TickType_t xDummy1;
 	StaticList_t xDummy2;
 
+	#if( configUSE_CO_ROUTINES == 1 )
+		StaticList_t xDummy5;
+	#endif
+
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy3;
 	#endif
@@ -1232,6 +1539,56 @@ typedef struct xSTATIC_EVENT_GROUP
 
 } StaticEventGroup_t;
 
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the real reader-writer lock structure used internally
+ * by FreeRTOS is not accessible to application code.  The StaticRWLock_t
+ * structure below is provided so the application writer can statically
+ * allocate the memory required to create a reader-writer lock.  Its sizes and
+ * alignment requirements are guaranteed to match those of the genuine
+ * structure, no matter which architecture is being used, and no matter how the
+ * values in FreeRTOSConfig.h are set.
+ */
+typedef struct xSTATIC_RW_LOCK
+{
+	StaticList_t xDummy1[ 2 ];
+	void *pvDummy2;
+	#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+		void *pvDummy6;
+	#endif
+	UBaseType_t uxDummy3[ 2 ];
+	uint8_t ucDummy4;
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucDummy5;
+	#endif
+
+} StaticRWLock_t;
+
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the real memory pool structure used internally by
+ * FreeRTOS is not accessible to application code.  The StaticMemPool_t
+ * structure below is provided so the application writer can statically
+ * allocate the memory required to create a memory pool.  Its sizes and
+ * alignment requirements are guaranteed to match those of the genuine
+ * structure, no matter which architecture is being used, and no matter how the
+ * values in FreeRTOSConfig.h are set.
+ */
+typedef struct xSTATIC_MEM_POOL
+{
+	uint32_t ulDummy1[ 3 ];
+	StaticList_t xDummy2;
+	void *pvDummy3;
+	size_t xDummy4;
+	UBaseType_t uxDummy5;
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucDummy6;
+	#endif
+
+} StaticMemPool_t;
+
 /*
  * In line with software engineering best practice, especially when supplying a
  * library that is likely to change in future versions, FreeRTOS implements a
@@ -1282,6 +1639,13 @@ typedef struct xSTATIC_STREAM_BUFFER
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy4;
 	#endif
+	#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+		void *pvDummy5;
+		UBaseType_t uxDummy6;
+	#endif
+	#if ( configUSE_CO_ROUTINES == 1 )
+		void *pvDummy7[ 2 ];
+	#endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
@@ -32,6 +32,11 @@
  * This file implements atomic functions by disabling interrupts globally.
  * Implementations with architecture specific atomic instructions can be
  * provided under each compiler directory.
+ *
+ * Ports that set portHAS_ATOMIC_INSTRUCTIONS to 1 in portmacro.h use the GCC
+ * __atomic built-in functions instead, which compile to the architecture's
+ * atomic instructions (for example AMO and LR/SC on RISC-V) so neither
+ * interrupts nor the scheduler are disabled.
  */
 
 #ifndef ATOMIC_H
@@ -110,11 +115,10 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32( uint32_t volatile *
 {
 uint32_t ulReturnValue;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		if( *pulDestination == ulComparand )
+		if( __atomic_compare_exchange_n( pulDestination, &ulComparand, ulExchange, pdFALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) )
 		{
-			*pulDestination = ulExchange;
 			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
 		}
 		else
@@ -122,7 +126,23 @@ uint32_t ulReturnValue;
 			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
 		}
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			if( *pulDestination == ulComparand )
+			{
+				*pulDestination = ulExchange;
+				ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+			}
+			else
+			{
+				ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+			}
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
 
 	return ulReturnValue;
 }
@@ -145,12 +165,20 @@ static portFORCE_INLINE void * Atomic_SwapPointers_p32( void * volatile * ppvDes
 {
 void * pReturnValue;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
+	{
+		pReturnValue = __atomic_exchange_n( ppvDestination, pvExchange, __ATOMIC_SEQ_CST );
+	}
+	#else
 	{
-		pReturnValue = *ppvDestination;
-		*ppvDestination = pvExchange;
+		ATOMIC_ENTER_CRITICAL();
+		{
+			pReturnValue = *ppvDestination;
+			*ppvDestination = pvExchange;
+		}
+		ATOMIC_EXIT_CRITICAL();
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#endif
 
 	return pReturnValue;
 }
@@ -178,15 +206,26 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_p32( void * volat
 {
 uint32_t ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		if( *ppvDestination == pvComparand )
+		if( __atomic_compare_exchange_n( ppvDestination, &pvComparand, pvExchange, pdFALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) )
 		{
-			*ppvDestination = pvExchange;
 			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
 		}
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			if( *ppvDestination == pvComparand )
+			{
+				*ppvDestination = pvExchange;
+				ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+			}
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
 
 	return ulReturnValue;
 }
@@ -210,12 +249,20 @@ static portFORCE_INLINE uint32_t Atomic_Add_u32( uint32_t volatile * pulAddend,
 {
 	uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		ulCurrent = *pulAddend;
-		*pulAddend += ulCount;
+		ulCurrent = __atomic_fetch_add( pulAddend, ulCount, __ATOMIC_SEQ_CST );
+	}
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulAddend;
+			*pulAddend += ulCount;
+		}
+		ATOMIC_EXIT_CRITICAL();
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#endif
 
 	return ulCurrent;
 }
@@ -238,12 +285,20 @@ static portFORCE_INLINE uint32_t Atomic_Subtract_u32( uint32_t volatile * pulAdd
 {
 	uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
+	{
+		ulCurrent = __atomic_fetch_sub( pulAddend, ulCount, __ATOMIC_SEQ_CST );
+	}
+	#else
 	{
-		ulCurrent = *pulAddend;
-		*pulAddend -= ulCount;
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulAddend;
+			*pulAddend -= ulCount;
+		}
+		ATOMIC_EXIT_CRITICAL();
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#endif
 
 	return ulCurrent;
 }
@@ -263,12 +318,20 @@ static portFORCE_INLINE uint32_t Atomic_Increment_u32( uint32_t volatile * pulAd
 {
 uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		ulCurrent = *pulAddend;
-		*pulAddend += 1;
+		ulCurrent = __atomic_fetch_add( pulAddend, 1U, __ATOMIC_SEQ_CST );
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulAddend;
+			*pulAddend += 1;
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
 
 	return ulCurrent;
 }
@@ -288,12 +351,20 @@ static portFORCE_INLINE uint32_t Atomic_Decrement_u32( uint32_t volatile * pulAd
 {
 uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		ulCurrent = *pulAddend;
-		*pulAddend -= 1;
+		ulCurrent = __atomic_fetch_sub( pulAddend, 1U, __ATOMIC_SEQ_CST );
+	}
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulAddend;
+			*pulAddend -= 1;
+		}
+		ATOMIC_EXIT_CRITICAL();
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#endif
 
 	return ulCurrent;
 }
@@ -316,12 +387,20 @@ static portFORCE_INLINE uint32_t Atomic_OR_u32( uint32_t volatile * pulDestinati
 {
 uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
+	{
+		ulCurrent = __atomic_fetch_or( pulDestination, ulValue, __ATOMIC_SEQ_CST );
+	}
+	#else
 	{
-		ulCurrent = *pulDestination;
-		*pulDestination |= ulValue;
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulDestination;
+			*pulDestination |= ulValue;
+		}
+		ATOMIC_EXIT_CRITICAL();
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#endif
 
 	return ulCurrent;
 }
@@ -343,12 +422,20 @@ static portFORCE_INLINE uint32_t Atomic_AND_u32( uint32_t volatile * pulDestinat
 {
 uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		ulCurrent = *pulDestination;
-		*pulDestination &= ulValue;
+		ulCurrent = __atomic_fetch_and( pulDestination, ulValue, __ATOMIC_SEQ_CST );
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulDestination;
+			*pulDestination &= ulValue;
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
 
 	return ulCurrent;
 }
@@ -370,12 +457,20 @@ static portFORCE_INLINE uint32_t Atomic_NAND_u32( uint32_t volatile * pulDestina
 {
 uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
 	{
-		ulCurrent = *pulDestination;
-		*pulDestination = ~( ulCurrent & ulValue );
+		ulCurrent = __atomic_fetch_nand( pulDestination, ulValue, __ATOMIC_SEQ_CST );
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulDestination;
+			*pulDestination = ~( ulCurrent & ulValue );
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
 
 	return ulCurrent;
 }
@@ -397,12 +492,20 @@ static portFORCE_INLINE uint32_t Atomic_XOR_u32( uint32_t volatile * pulDestinat
 {
 uint32_t ulCurrent;
 
-	ATOMIC_ENTER_CRITICAL();
+	#if( portHAS_ATOMIC_INSTRUCTIONS == 1 )
+	{
+		ulCurrent = __atomic_fetch_xor( pulDestination, ulValue, __ATOMIC_SEQ_CST );
+	}
+	#else
 	{
-		ulCurrent = *pulDestination;
-		*pulDestination ^= ulValue;
+		ATOMIC_ENTER_CRITICAL();
+		{
+			ulCurrent = *pulDestination;
+			*pulDestination ^= ulValue;
+		}
+		ATOMIC_EXIT_CRITICAL();
 	}
-	ATOMIC_EXIT_CRITICAL();
+	#endif
 
 	return ulCurrent;
 }
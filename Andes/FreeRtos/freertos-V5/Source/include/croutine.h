@@ -33,6 +33,7 @@
 #endif
 
 #include "list.h"
+#include "task.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +55,11 @@ typedef struct corCoRoutineControlBlock
 	UBaseType_t 		uxPriority;			/*< The priority of the co-routine in relation to other co-routines. */
 	UBaseType_t 		uxIndex;			/*< Used to distinguish between co-routines when multiple co-routines use the same co-routine function. */
 	uint16_t 			uxState;			/*< Used internally by the co-routine implementation. */
+
+	#if( configUSE_TASK_NOTIFICATIONS == 1 )
+		volatile uint8_t	ucNotifyState;		/*< Whether the co-routine is waiting for, or has received, a notification. */
+		volatile uint32_t	ulNotifiedValue;	/*< The co-routine's notification value, used in the same way as a task's. */
+	#endif
 } CRCB_t; /* Co-routine control block.  Note must be identical in size down to uxPriority with TCB_t. */
 
 /**
@@ -172,6 +178,91 @@ BaseType_t xCoRoutineCreate( crCOROUTINE_CODE pxCoRoutineCode, UBaseType_t uxPri
  */
 void vCoRoutineSchedule( void );
 
+/**
+ * croutine. h
+ *<pre>
+ void vCoRoutineScheduleOrBlock( void );</pre>
+ *
+ * Run a co-routine, or block the calling task until one is able to run.
+ *
+ * vCoRoutineScheduleOrBlock() behaves as vCoRoutineSchedule(), but is intended
+ * to be called in a loop from a dedicated task rather than from the idle task.
+ * When no co-routine is ready the calling task blocks on its task notification
+ * until the next co-routine delay expires, or until an interrupt, task or
+ * co-routine readies a co-routine - so a single task can host thousands of
+ * co-routines without polling.
+ *
+ * configUSE_TASK_NOTIFICATIONS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.  Only one task may run co-routines, and it must
+ * not use its own task notification for anything else.
+ *
+ * Example usage:
+   <pre>
+ void vCoRoutineHostTask( void *pvParameters )
+ {
+     for( ;; )
+     {
+         vCoRoutineScheduleOrBlock();
+     }
+ }
+ </pre>
+ * \defgroup vCoRoutineScheduleOrBlock vCoRoutineScheduleOrBlock
+ * \ingroup Tasks
+ */
+void vCoRoutineScheduleOrBlock( void );
+
+/**
+ * croutine. h
+ *<pre>
+ CoRoutineHandle_t xCoRoutineGetCurrentHandle( void );</pre>
+ *
+ * @return The handle of the co-routine that is currently running.  This is the
+ * same as the xHandle parameter of the co-routine function, and can be stored
+ * so tasks and interrupts can later notify the co-routine.
+ *
+ * \defgroup xCoRoutineGetCurrentHandle xCoRoutineGetCurrentHandle
+ * \ingroup Tasks
+ */
+CoRoutineHandle_t xCoRoutineGetCurrentHandle( void );
+
+/**
+ * croutine. h
+ *<pre>
+ BaseType_t xCoRoutineNotify( CoRoutineHandle_t xCoRoutineToNotify, uint32_t ulValue, eNotifyAction eAction );</pre>
+ *
+ * Send a notification to a co-routine.  The notification value and eAction are
+ * used exactly as for xTaskNotify(), and a co-routine that is blocked in
+ * crNOTIFY_WAIT() is readied.  Can be called from tasks and co-routines, but
+ * not from an interrupt - use xCoRoutineNotifyFromISR() from an interrupt.
+ *
+ * configUSE_TASK_NOTIFICATIONS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @return pdFAIL if eAction is eSetValueWithoutOverwrite and the co-routine
+ * already had a pending notification, otherwise pdPASS.
+ *
+ * \defgroup xCoRoutineNotify xCoRoutineNotify
+ * \ingroup Tasks
+ */
+BaseType_t xCoRoutineNotify( CoRoutineHandle_t xCoRoutineToNotify, uint32_t ulValue, eNotifyAction eAction );
+
+/**
+ * croutine. h
+ *<pre>
+ BaseType_t xCoRoutineNotifyFromISR( CoRoutineHandle_t xCoRoutineToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</pre>
+ *
+ * A version of xCoRoutineNotify() that can be called from an interrupt.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if readying the co-routine
+ * unblocked the task that runs the co-routines, and that task has a priority
+ * above the task that was interrupted.  A context switch should then be
+ * requested before the interrupt exits.  May be NULL.
+ *
+ * \defgroup xCoRoutineNotifyFromISR xCoRoutineNotifyFromISR
+ * \ingroup Tasks
+ */
+BaseType_t xCoRoutineNotifyFromISR( CoRoutineHandle_t xCoRoutineToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );
+
 /**
  * croutine. h
  * <pre>
@@ -693,6 +784,212 @@ void vCoRoutineSchedule( void );
  */
 #define crQUEUE_RECEIVE_FROM_ISR( pxQueue, pvBuffer, pxCoRoutineWoken ) xQueueCRReceiveFromISR( ( pxQueue ), ( pvBuffer ), ( pxCoRoutineWoken ) )
 
+/**
+ * croutine. h
+ * <pre>
+ crNOTIFY_WAIT(
+                  CoRoutineHandle_t xHandle,
+                  uint32_t ulBitsToClearOnEntry,
+                  uint32_t ulBitsToClearOnExit,
+                  uint32_t *pulNotificationValue,
+                  TickType_t xTicksToWait,
+                  BaseType_t *pxResult
+              )</pre>
+ *
+ * The co-routine equivalent of xTaskNotifyWait().  Blocks the co-routine until
+ * it is sent a notification by xCoRoutineNotify() or xCoRoutineNotifyFromISR(),
+ * or until xTicksToWait ticks pass.
+ *
+ * crNOTIFY_WAIT can only be called from the co-routine function itself - not
+ * from within a function called by the co-routine function.  This is because
+ * co-routines do not maintain their own stack.
+ *
+ * @param xHandle The handle of the calling co-routine.  This is the xHandle
+ * parameter of the co-routine function.
+ *
+ * @param ulBitsToClearOnEntry, ulBitsToClearOnExit As for xTaskNotifyWait().
+ *
+ * @param pulNotificationValue Used to pass out the notification value, or NULL
+ * if the value is not required.  As the co-routine does not maintain its stack
+ * the variable pointed to must be declared static.
+ *
+ * @param xTicksToWait The number of ticks to wait for a notification.
+ *
+ * @param pxResult Set to pdPASS if a notification was received, otherwise
+ * pdFAIL.
+ *
+ * Example usage:
+ <pre>
+ static void vConnectionCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+ {
+ static uint32_t ulRequest;
+ BaseType_t xResult;
+
+     crSTART( xHandle );
+
+     for( ;; )
+     {
+         crNOTIFY_WAIT( xHandle, 0, 0xffffffffUL, &ulRequest, 100, &xResult );
+
+         if( xResult == pdPASS )
+         {
+             // Process ulRequest.
+         }
+     }
+
+     crEND();
+ }</pre>
+ * \defgroup crNOTIFY_WAIT crNOTIFY_WAIT
+ * \ingroup Tasks
+ */
+#define crNOTIFY_WAIT( xHandle, ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait, pxResult )		\
+{																														\
+	*( pxResult ) = xCoRoutineNotifyWait( ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																				\
+	{																													\
+		crSET_STATE0( ( xHandle ) );																					\
+		*( pxResult ) = xCoRoutineNotifyWait( ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), 0 );	\
+	}																													\
+}
+
+/**
+ * croutine. h
+ * <pre>
+ crSTREAM_BUFFER_SEND(
+                         CoRoutineHandle_t xHandle,
+                         StreamBufferHandle_t xStreamBuffer,
+                         const void *pvTxData,
+                         size_t xDataLengthBytes,
+                         size_t *pxBytesSent,
+                         TickType_t xTicksToWait,
+                         BaseType_t *pxResult
+                     )</pre>
+ *
+ * The co-routine equivalent of xStreamBufferSend().  If the stream buffer does
+ * not have enough space for any of the data the co-routine blocks until a
+ * reader makes space or until xTicksToWait ticks pass.  The stream buffer can
+ * be read by a task, by an interrupt or by another co-routine.
+ *
+ * As with tasks, at most one co-routine or task may block on each end of a
+ * stream buffer, and a co-routine must not wait for its own notification while
+ * it is blocked on a stream buffer.
+ *
+ * @param pxBytesSent Set to the number of bytes written.  As the co-routine
+ * does not maintain its stack the variable must be declared static.
+ *
+ * @param pxResult Set to pdPASS if any bytes were written, otherwise pdFAIL.
+ *
+ * \defgroup crSTREAM_BUFFER_SEND crSTREAM_BUFFER_SEND
+ * \ingroup Tasks
+ */
+#define crSTREAM_BUFFER_SEND( xHandle, xStreamBuffer, pvTxData, xDataLengthBytes, pxBytesSent, xTicksToWait, pxResult )		\
+{																														\
+	*( pxResult ) = xStreamBufferCRSend( ( xStreamBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxBytesSent ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																				\
+	{																													\
+		crSET_STATE0( ( xHandle ) );																					\
+		*( pxResult ) = xStreamBufferCRSend( ( xStreamBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxBytesSent ), 0 );	\
+	}																													\
+}
+
+/**
+ * croutine. h
+ * <pre>
+ crSTREAM_BUFFER_RECEIVE(
+                            CoRoutineHandle_t xHandle,
+                            StreamBufferHandle_t xStreamBuffer,
+                            void *pvRxData,
+                            size_t xBufferLengthBytes,
+                            size_t *pxReceivedBytes,
+                            TickType_t xTicksToWait,
+                            BaseType_t *pxResult
+                        )</pre>
+ *
+ * The co-routine equivalent of xStreamBufferReceive().  If the stream buffer
+ * holds less data than its trigger level the co-routine blocks until a writer
+ * adds data or until xTicksToWait ticks pass.
+ *
+ * @param pvRxData The buffer into which data is copied.  As the co-routine
+ * does not maintain its stack the buffer must be declared static.
+ *
+ * @param pxReceivedBytes Set to the number of bytes read.  As the co-routine
+ * does not maintain its stack the variable must be declared static.
+ *
+ * @param pxResult Set to pdPASS if any bytes were read, otherwise pdFAIL.
+ *
+ * Example usage:
+ <pre>
+ static void vEchoCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+ {
+ static uint8_t ucBuffer[ 16 ];
+ static size_t xReceived, xSent;
+ BaseType_t xResult;
+
+     crSTART( xHandle );
+
+     for( ;; )
+     {
+         crSTREAM_BUFFER_RECEIVE( xHandle, xRxStream, ucBuffer, sizeof( ucBuffer ), &xReceived, portMAX_DELAY, &xResult );
+
+         if( xResult == pdPASS )
+         {
+             crSTREAM_BUFFER_SEND( xHandle, xTxStream, ucBuffer, xReceived, &xSent, portMAX_DELAY, &xResult );
+         }
+     }
+
+     crEND();
+ }</pre>
+ * \defgroup crSTREAM_BUFFER_RECEIVE crSTREAM_BUFFER_RECEIVE
+ * \ingroup Tasks
+ */
+#define crSTREAM_BUFFER_RECEIVE( xHandle, xStreamBuffer, pvRxData, xBufferLengthBytes, pxReceivedBytes, xTicksToWait, pxResult )	\
+{																														\
+	*( pxResult ) = xStreamBufferCRReceive( ( xStreamBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxReceivedBytes ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																				\
+	{																													\
+		crSET_STATE0( ( xHandle ) );																					\
+		*( pxResult ) = xStreamBufferCRReceive( ( xStreamBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxReceivedBytes ), 0 );	\
+	}																													\
+}
+
+/**
+ * croutine. h
+ * <pre>
+ crEVENT_GROUP_WAIT_BITS(
+                            CoRoutineHandle_t xHandle,
+                            EventGroupHandle_t xEventGroup,
+                            EventBits_t uxBitsToWaitFor,
+                            BaseType_t xClearOnExit,
+                            BaseType_t xWaitForAllBits,
+                            EventBits_t *puxEventBits,
+                            TickType_t xTicksToWait,
+                            BaseType_t *pxResult
+                        )</pre>
+ *
+ * The co-routine equivalent of xEventGroupWaitBits().  Any number of tasks and
+ * co-routines can wait on the same event group, and are unblocked by
+ * xEventGroupSetBits() in the same way.
+ *
+ * @param puxEventBits Set to the value of the event bits when the wait
+ * condition was met, or when the wait timed out.  As the co-routine does not
+ * maintain its stack the variable must be declared static.
+ *
+ * @param pxResult Set to pdPASS if the wait condition was met, otherwise
+ * pdFAIL.
+ *
+ * \defgroup crEVENT_GROUP_WAIT_BITS crEVENT_GROUP_WAIT_BITS
+ * \ingroup Tasks
+ */
+#define crEVENT_GROUP_WAIT_BITS( xHandle, xEventGroup, uxBitsToWaitFor, xClearOnExit, xWaitForAllBits, puxEventBits, xTicksToWait, pxResult )	\
+{																														\
+	*( pxResult ) = xEventGroupCRWaitBits( ( xEventGroup ), ( uxBitsToWaitFor ), ( xClearOnExit ), ( xWaitForAllBits ), ( puxEventBits ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																				\
+	{																													\
+		crSET_STATE0( ( xHandle ) );																					\
+		*( pxResult ) = xEventGroupCRWaitBits( ( xEventGroup ), ( uxBitsToWaitFor ), ( xClearOnExit ), ( xWaitForAllBits ), ( puxEventBits ), 0 );	\
+	}																													\
+}
+
 /*
  * This function is intended for internal use by the co-routine macros only.
  * The macro nature of the co-routine implementation requires that the
@@ -713,6 +1010,26 @@ void vCoRoutineAddToDelayedList( TickType_t xTicksToDelay, List_t *pxEventList )
  */
 BaseType_t xCoRoutineRemoveFromEventList( const List_t *pxEventList );
 
+/*
+ * This function is intended for internal use by the co-routine macros only.
+ *
+ * The first call either collects a pending notification or, if xTicksToWait is
+ * not zero, blocks the calling co-routine and returns errQUEUE_BLOCKED.  The
+ * macro then calls it again with xTicksToWait set to 0 once the co-routine
+ * runs again.
+ */
+BaseType_t xCoRoutineNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );
+
+/*
+ * These functions are intended for internal use by the event group
+ * implementation only, and must be called with the scheduler suspended.  They
+ * are the co-routine equivalents of vTaskPlaceOnUnorderedEventList(),
+ * vTaskRemoveFromUnorderedEventList() and uxTaskResetEventItemValue().
+ */
+void vCoRoutinePlaceOnUnorderedEventList( List_t *pxEventList, const TickType_t xItemValue, const TickType_t xTicksToWait );
+void vCoRoutineRemoveFromUnorderedEventList( ListItem_t *pxEventListItem, const TickType_t xItemValue );
+TickType_t uxCoRoutineResetEventItemValue( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -738,6 +738,17 @@ EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup ) PRIVILEG
  */
 void vEventGroupDelete( EventGroupHandle_t xEventGroup ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_CO_ROUTINES == 1 )
+
+/*
+ * The co-routine equivalent of xEventGroupWaitBits().  This function is called
+ * from the crEVENT_GROUP_WAIT_BITS() macro defined within croutine.h and should
+ * not be called directly from application code.
+ */
+BaseType_t xEventGroupCRWaitBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, EventBits_t *puxEventBits, TickType_t xTicksToWait );
+
+#endif /* configUSE_CO_ROUTINES */
+
 /* For internal use only. */
 void vEventGroupSetBitsCallback( void *pvEventGroup, const uint32_t ulBitsToSet ) PRIVILEGED_FUNCTION;
 void vEventGroupClearBitsCallback( void *pvEventGroup, const uint32_t ulBitsToClear ) PRIVILEGED_FUNCTION;
@@ -0,0 +1,277 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef HEAP_TRACKING_H
+#define HEAP_TRACKING_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include heap_tracking.h"
+#endif
+
+#ifndef INC_TASK_H
+	#error "include task.h" must appear in source files before "include heap_tracking.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Heap allocation tracking.
+ *
+ * When configUSE_HEAP_TRACKING is 1 heap_4.c and heap_5.c record, in the
+ * header of every allocated block, the return address of the pvPortMalloc()
+ * call that allocated the block, the task that was running when the block was
+ * allocated, and an allocation sequence number.  Every allocation and free is
+ * also counted in a histogram of requested sizes and in histograms of the time
+ * taken, measured using portGET_CYCLE_COUNT().
+ *
+ * The blocks that are still allocated can be listed at any time, so the code
+ * that owns the heap can be found when the heap is exhausted.  A leak check
+ * reads the sequence number with ulHeapTrackingGetSequence() before a piece of
+ * work, then lists only the blocks allocated after that point once the work
+ * has completed.  The information can be read directly, written to a buffer
+ * in the binary format described by xHeapTrackingDump() for transfer to a
+ * host, formatted as text by vHeapTrackingList(), or sent to the Andes RTOS
+ * tracer.
+ *
+ * Tracking adds three members to the header of every block, a critical
+ * section to each allocation and free, and a few cycle counter reads.  Blocks
+ * are only enumerated when requested, by walking the heap with the scheduler
+ * suspended.
+ *
+ * configUSE_HEAP_TRACKING must be set to 1 in FreeRTOSConfig.h for the
+ * functions in this file to be available, and heap_tracking.c must be included
+ * in the build along with heap_4.c or heap_5.c.
+ *
+ * \defgroup HeapTracking HeapTracking
+ */
+
+/* The number of buckets in each histogram.  Bucket n counts values from 2^n
+to ( 2^( n + 1 ) ) - 1, except the first bucket also counts 0 and the last
+bucket counts every larger value. */
+#define heaptrackHISTOGRAM_BUCKETS		( 16 )
+
+/* Identifies the binary format written by xHeapTrackingDump(). */
+#define heaptrackDUMP_MAGIC				( 0x4b525448UL ) /* "HTRK" in little endian byte order. */
+#define heaptrackDUMP_VERSION			( 1U )
+
+/* Describes one allocated block.  Used to pass information out of
+uxPortGetHeapAllocations(). */
+typedef struct xHEAP_ALLOCATION
+{
+	void *pvAddress;		/* The address returned by pvPortMalloc(). */
+	size_t xSize;			/* The number of bytes available to the application, which can exceed the number requested. */
+	void *pvCaller;			/* The return address of the pvPortMalloc() call, or NULL if not known. */
+	TaskHandle_t xOwner;	/* The task that allocated the block, or NULL if it was allocated before the scheduler started.  The task might since have been deleted. */
+	uint32_t ulSequence;	/* The allocation sequence number of the block. */
+} HeapAllocation_t;
+
+/* Used to pass information out of vHeapTrackingGetStats(). */
+typedef struct xHEAP_TRACKING_STATS
+{
+	uint32_t ulSizeHistogram[ heaptrackHISTOGRAM_BUCKETS ];				/* Successful allocations by the number of bytes requested. */
+	uint32_t ulAllocationCycleHistogram[ heaptrackHISTOGRAM_BUCKETS ];	/* Successful allocations by the number of cycles taken. */
+	uint32_t ulFreeCycleHistogram[ heaptrackHISTOGRAM_BUCKETS ];		/* Frees by the number of cycles taken. */
+	uint32_t ulMaximumAllocationCycles;		/* The longest time taken by a successful allocation. */
+	uint32_t ulMaximumFreeCycles;			/* The longest time taken by a free. */
+	uint32_t ulFailedAllocations;			/* The number of allocations that returned NULL. */
+	uint32_t ulLargestFailedRequest;		/* The largest number of bytes requested by an allocation that returned NULL. */
+	uint32_t ulNextSequence;				/* The sequence number the next allocation will be given. */
+} HeapTrackingStats_t;
+
+/**
+ * heap_tracking.h
+ *<pre>
+ uint32_t ulHeapTrackingGetSequence( void );
+ </pre>
+ *
+ * Returns the sequence number the next allocation will be given.  Every
+ * block allocated after the call has a sequence number greater than or equal
+ * to the returned value, until the sequence number wraps after 2^32
+ * allocations.
+ *
+ * \defgroup ulHeapTrackingGetSequence ulHeapTrackingGetSequence
+ * \ingroup HeapTracking
+ */
+uint32_t ulHeapTrackingGetSequence( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * heap_tracking.h
+ *<pre>
+ void vHeapTrackingGetStats( HeapTrackingStats_t *pxStats );
+ </pre>
+ *
+ * Return a copy of the histograms and counters.
+ *
+ * @param pxStats The structure into which the information is written.
+ *
+ * \defgroup vHeapTrackingGetStats vHeapTrackingGetStats
+ * \ingroup HeapTracking
+ */
+void vHeapTrackingGetStats( HeapTrackingStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * heap_tracking.h
+ *<pre>
+ void vHeapTrackingResetStats( void );
+ </pre>
+ *
+ * Clear the histograms and counters.  Does not change the sequence number or
+ * the information held for allocated blocks.
+ *
+ * \defgroup vHeapTrackingResetStats vHeapTrackingResetStats
+ * \ingroup HeapTracking
+ */
+void vHeapTrackingResetStats( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * heap_tracking.h
+ *<pre>
+ UBaseType_t uxPortGetHeapAllocations( HeapAllocation_t *pxAllocations, UBaseType_t uxArraySize, UBaseType_t uxFirst, uint32_t ulFromSequence );
+ </pre>
+ *
+ * Describe the blocks that are currently allocated, in address order.  Blocks
+ * freed to a task heap cache (see configUSE_TASK_HEAP_CACHE) are not
+ * included.  Implemented by heap_4.c and heap_5.c.
+ *
+ * @param pxAllocations An array into which the blocks are written.
+ *
+ * @param uxArraySize The number of entries in pxAllocations.
+ *
+ * @param uxFirst The number of matching blocks to skip before writing to
+ * pxAllocations, so a large heap can be read in several calls.
+ *
+ * @param ulFromSequence Only blocks with a sequence number greater than or
+ * equal to ulFromSequence are included.  Pass 0 to include every block.
+ *
+ * @return The number of entries written to pxAllocations.
+ *
+ * Example usage:
+   <pre>
+	void vRunCheckedForLeaks( void )
+	{
+	uint32_t ulMark;
+	HeapAllocation_t xLeaks[ 4 ];
+	UBaseType_t uxLeaks;
+
+		ulMark = ulHeapTrackingGetSequence();
+		vDoWorkThatShouldNotLeak();
+
+		// Anything vDoWorkThatShouldNotLeak() allocated and did not free.
+		uxLeaks = uxPortGetHeapAllocations( xLeaks, 4, 0, ulMark );
+	}
+   </pre>
+ * \defgroup uxPortGetHeapAllocations uxPortGetHeapAllocations
+ * \ingroup HeapTracking
+ */
+UBaseType_t uxPortGetHeapAllocations( HeapAllocation_t *pxAllocations, UBaseType_t uxArraySize, UBaseType_t uxFirst, uint32_t ulFromSequence ) PRIVILEGED_FUNCTION;
+
+/**
+ * heap_tracking.h
+ *<pre>
+ size_t xHeapTrackingDump( uint8_t *pucBuffer, size_t xBufferLength, uint32_t ulFromSequence );
+ </pre>
+ *
+ * Write the histograms, counters and allocated blocks to a buffer in a binary
+ * format that can be saved or sent to a host for analysis.  All values are in
+ * the byte order of the target, and "word" below is the size of a pointer on
+ * the target.  The dump is a header of eight 32-bit values:
+ *
+ *   magic (heaptrackDUMP_MAGIC), version (heaptrackDUMP_VERSION), word size,
+ *   histogram buckets, number of blocks in the dump, number of blocks
+ *   allocated, from sequence, reserved (0)
+ *
+ * followed by the fields of HeapTrackingStats_t as 32-bit values in the order
+ * they are declared, followed by one record per block of four words and one
+ * 32-bit value:
+ *
+ *   address, size, caller, owner, sequence
+ *
+ * If the buffer is too small to hold every block then as many as fit are
+ * written, and the two block counts in the header differ.
+ *
+ * @param pucBuffer The buffer into which the dump is written.
+ *
+ * @param xBufferLength The size of pucBuffer in bytes.
+ *
+ * @param ulFromSequence As for uxPortGetHeapAllocations().
+ *
+ * @return The number of bytes written, or 0 if the buffer is too small to
+ * hold the header and statistics.
+ *
+ * \defgroup xHeapTrackingDump xHeapTrackingDump
+ * \ingroup HeapTracking
+ */
+size_t xHeapTrackingDump( uint8_t *pucBuffer, size_t xBufferLength, uint32_t ulFromSequence ) PRIVILEGED_FUNCTION;
+
+/**
+ * heap_tracking.h
+ *<pre>
+ void vHeapTrackingList( char *pcWriteBuffer, size_t xBufferLength, uint32_t ulFromSequence );
+ </pre>
+ *
+ * configUSE_STATS_FORMATTING_FUNCTIONS must be set to a value greater than 0
+ * in FreeRTOSConfig.h for this function to be available.
+ *
+ * Write a human readable table of the allocated blocks to pcWriteBuffer, one
+ * line per block, giving the address, size, caller, owner and sequence number
+ * in that order, followed by a line giving the number of blocks and bytes
+ * listed.  Like vTaskList() this is intended for debugging, so is not
+ * efficient.
+ *
+ * @param pcWriteBuffer The buffer into which the table is written.
+ *
+ * @param xBufferLength The size of pcWriteBuffer in bytes.  The table is
+ * truncated if it does not fit.
+ *
+ * @param ulFromSequence As for uxPortGetHeapAllocations().
+ *
+ * \defgroup vHeapTrackingList vHeapTrackingList
+ * \ingroup HeapTracking
+ */
+void vHeapTrackingList( char *pcWriteBuffer, size_t xBufferLength, uint32_t ulFromSequence ) PRIVILEGED_FUNCTION;
+
+/*
+ * THE FOLLOWING FUNCTIONS ARE FOR THE USE OF THE MEMORY ALLOCATORS ONLY, AND
+ * SHOULD NOT BE CALLED FROM APPLICATION CODE.
+ *
+ * ulHeapTrackingRecordAllocation() counts a successful allocation and returns
+ * the sequence number to store in the block.  vHeapTrackingRecordFailure() and
+ * vHeapTrackingRecordFree() count failed allocations and frees respectively.
+ * Each updates the counters from within a critical section, so can be called
+ * whether or not the scheduler is suspended.
+ */
+uint32_t ulHeapTrackingRecordAllocation( size_t xWantedSize, uint32_t ulCycles ) PRIVILEGED_FUNCTION;
+void vHeapTrackingRecordFailure( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+void vHeapTrackingRecordFree( uint32_t ulCycles ) PRIVILEGED_FUNCTION;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_TRACKING_H */
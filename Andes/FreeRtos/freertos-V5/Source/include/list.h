@@ -48,6 +48,19 @@
  * effectively a two way link between the object containing the list item and
  * the list item itself.
  *
+ * If configUSE_SKIP_LISTS is 1 then the list is also a skip list, so
+ * vListInsert() does not have to walk the whole of a long sorted list (such as
+ * the delayed task list or an event list) to find the insertion point.  Each
+ * item added by vListInsert() is also linked into a random number of up to
+ * configSKIP_LIST_LEVELS index levels.  Each level is a doubly linked list that
+ * holds about a quarter of the items of the level below, in the same order, and
+ * uses the end marker as its end too.  vListInsert() moves along each level in
+ * turn, starting with the sparsest, so takes time proportional to the log of
+ * the number of items rather than the number of items.  uxListRemove() unlinks
+ * an item from the levels it is in.  The pxNext/pxPrevious list, and therefore
+ * the behaviour of every list access macro, is exactly the same as when
+ * configUSE_SKIP_LISTS is 0.  Items added by vListInsertEnd() are not indexed.
+ *
  *
  * \page ListIntroduction List Implementation
  * \ingroup FreeRTOSIntro
@@ -145,6 +158,11 @@ struct xLIST_ITEM
 	struct xLIST_ITEM * configLIST_VOLATILE pxPrevious;	/*< Pointer to the previous ListItem_t in the list. */
 	void * pvOwner;										/*< Pointer to the object (normally a TCB) that contains the list item.  There is therefore a two way link between the object containing the list item and the list item itself. */
 	struct xLIST * configLIST_VOLATILE pxContainer;		/*< Pointer to the list in which this list item is placed (if any). */
+	#if( configUSE_SKIP_LISTS == 1 )
+		struct xLIST_ITEM * configLIST_VOLATILE pxSkipNext[ configSKIP_LIST_LEVELS ];		/*< Pointers to the next ListItem_t in each index level the item is in. */
+		struct xLIST_ITEM * configLIST_VOLATILE pxSkipPrevious[ configSKIP_LIST_LEVELS ];	/*< Pointers to the previous ListItem_t in each index level the item is in. */
+		UBaseType_t uxSkipLevels;						/*< The number of index levels the item is linked into, 0 if the item is only in the list itself. */
+	#endif
 	listSECOND_LIST_ITEM_INTEGRITY_CHECK_VALUE			/*< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 };
 typedef struct xLIST_ITEM ListItem_t;					/* For some reason lint wants this as two separate definitions. */
@@ -155,6 +173,15 @@ struct xMINI_LIST_ITEM
 	configLIST_VOLATILE TickType_t xItemValue;
 	struct xLIST_ITEM * configLIST_VOLATILE pxNext;
 	struct xLIST_ITEM * configLIST_VOLATILE pxPrevious;
+	#if( configUSE_SKIP_LISTS == 1 )
+		/* The end marker is also the end of each index level, so pxSkipNext
+		must be at the same offset as in ListItem_t.  The index members follow
+		pvOwner and pxContainer in ListItem_t, so the members that precede them
+		are where debuggers expect to find them. */
+		void * pvUnused[ 2 ];
+		struct xLIST_ITEM * configLIST_VOLATILE pxSkipNext[ configSKIP_LIST_LEVELS ];
+		struct xLIST_ITEM * configLIST_VOLATILE pxSkipPrevious[ configSKIP_LIST_LEVELS ];
+	#endif
 };
 typedef struct xMINI_LIST_ITEM MiniListItem_t;
 
@@ -358,6 +385,8 @@ void vListInitialiseItem( ListItem_t * const pxItem ) PRIVILEGED_FUNCTION;
 /*
  * Insert a list item into a list.  The item will be inserted into the list in
  * a position determined by its item value (descending item value order).
+ * Takes time proportional to the length of the list, or to the log of the
+ * length of the list if configUSE_SKIP_LISTS is 1.
  *
  * @param pxList The list into which the item is to be inserted.
  *
@@ -0,0 +1,345 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include mempool.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A memory pool is a partition of equally sized blocks, such as the buffers
+ * used to hold network packets or the messages passed between a driver and a
+ * protocol task.  Allocating from and freeing to a pool takes a constant time,
+ * no matter how many blocks are in use, and a pool cannot fragment.
+ *
+ * The free blocks of a pool are held on a list that is threaded through the
+ * blocks themselves, so a pool needs no memory other than the blocks and a
+ * small control structure.  Blocks are taken from and returned to the list
+ * using atomic compare and swap operations rather than critical sections, so
+ * the pool can be used from tasks and interrupts without disabling
+ * interrupts.  A task that finds the pool empty can wait in the Blocked state,
+ * in priority order, for a block to be freed.
+ *
+ * configUSE_MEMORY_POOLS must be set to 1 in FreeRTOSConfig.h for the
+ * functions in this file to be available, and mempool.c must be included in
+ * the build.
+ *
+ * \defgroup MemPool MemPool
+ */
+
+/**
+ * mempool.h
+ *
+ * Type by which memory pools are referenced.  For example, a call to
+ * xMemPoolCreate() returns a MemPoolHandle_t variable that can then be used as
+ * a parameter to the other memory pool functions.
+ *
+ * \defgroup MemPoolHandle_t MemPoolHandle_t
+ * \ingroup MemPool
+ */
+struct MemPoolDef_t;
+typedef struct MemPoolDef_t * MemPoolHandle_t;
+
+/* The size a pool actually uses for each block when the block size passed to
+xMemPoolCreate() or xMemPoolCreateStatic() is xBlockSize.  Blocks are large
+enough to hold the link to the next free block, and are rounded up so every
+block meets the port's alignment requirement. */
+#define mempoolBLOCK_SIZE( xBlockSize )	( ( ( ( ( size_t ) ( xBlockSize ) ) < sizeof( uint32_t ) ? sizeof( uint32_t ) : ( ( size_t ) ( xBlockSize ) ) ) + ( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The number of bytes of storage that must be passed to xMemPoolCreateStatic()
+to create a pool of uxBlockCount blocks of xBlockSize bytes each. */
+#define mempoolSTORAGE_SIZE( xBlockSize, uxBlockCount )	( mempoolBLOCK_SIZE( xBlockSize ) * ( size_t ) ( uxBlockCount ) )
+
+/* The largest number of blocks a pool can hold. */
+#define mempoolMAX_BLOCK_COUNT	( ( UBaseType_t ) 0xffffU )
+
+/**
+ * mempool.h
+ *<pre>
+ MemPoolHandle_t xMemPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount );
+ </pre>
+ *
+ * Create a new memory pool, allocating the memory required to hold both the
+ * pool's control structure and its blocks from the FreeRTOS heap in a single
+ * allocation.
+ *
+ * @param xBlockSize The size, in bytes, of each block in the pool.  The size is
+ * rounded up as described for mempoolBLOCK_SIZE().
+ *
+ * @param uxBlockCount The number of blocks in the pool.  Must be between 1 and
+ * mempoolMAX_BLOCK_COUNT.
+ *
+ * @return If the pool was created then a handle to the pool is returned.  If
+ * there was insufficient FreeRTOS heap available to create the pool then NULL
+ * is returned.
+ *
+ * Example usage:
+   <pre>
+	#define PACKET_SIZE		128
+	#define PACKET_COUNT	16
+
+	MemPoolHandle_t xPacketPool;
+
+	void vInitialisePackets( void )
+	{
+		xPacketPool = xMemPoolCreate( PACKET_SIZE, PACKET_COUNT );
+		configASSERT( xPacketPool );
+	}
+
+	void vProtocolTask( void *pvParameters )
+	{
+	uint8_t *pucPacket;
+
+		for( ;; )
+		{
+			// Wait up to 10ms for a free packet buffer.
+			pucPacket = ( uint8_t * ) pvMemPoolAlloc( xPacketPool, pdMS_TO_TICKS( 10 ) );
+
+			if( pucPacket != NULL )
+			{
+				prvBuildPacket( pucPacket );
+
+				// The driver frees the buffer from its transmit complete
+				// interrupt by calling vMemPoolFreeFromISR().
+				prvSendPacket( pucPacket );
+			}
+		}
+	}
+   </pre>
+ * \defgroup xMemPoolCreate xMemPoolCreate
+ * \ingroup MemPool
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	MemPoolHandle_t xMemPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mempool.h
+ *<pre>
+ MemPoolHandle_t xMemPoolCreateStatic( size_t xBlockSize, UBaseType_t uxBlockCount, uint8_t *pucPoolStorage, StaticMemPool_t *pxStaticMemPool );
+ </pre>
+ *
+ * Create a new memory pool using memory provided by the application writer.
+ *
+ * @param xBlockSize The size, in bytes, of each block in the pool.
+ *
+ * @param uxBlockCount The number of blocks in the pool.  Must be between 1 and
+ * mempoolMAX_BLOCK_COUNT.
+ *
+ * @param pucPoolStorage Must point to an array of at least
+ * mempoolSTORAGE_SIZE( xBlockSize, uxBlockCount ) bytes that is aligned to
+ * portBYTE_ALIGNMENT.  The blocks are allocated from this array.
+ *
+ * @param pxStaticMemPool Must point to a variable of type StaticMemPool_t,
+ * which will then be used to hold the pool's control structure.
+ *
+ * @return If the pool was created then a handle to the pool is returned.  If
+ * either pucPoolStorage or pxStaticMemPool was NULL then NULL is returned.
+ *
+ * Example usage:
+   <pre>
+	#define MESSAGE_SIZE	20
+	#define MESSAGE_COUNT	8
+
+	static uint8_t ucMessageStorage[ mempoolSTORAGE_SIZE( MESSAGE_SIZE, MESSAGE_COUNT ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+	static StaticMemPool_t xMessagePoolStruct;
+
+	void vInitialiseMessages( void )
+	{
+	MemPoolHandle_t xMessagePool;
+
+		xMessagePool = xMemPoolCreateStatic( MESSAGE_SIZE, MESSAGE_COUNT, ucMessageStorage, &xMessagePoolStruct );
+	}
+   </pre>
+ * \defgroup xMemPoolCreateStatic xMemPoolCreateStatic
+ * \ingroup MemPool
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	MemPoolHandle_t xMemPoolCreateStatic( size_t xBlockSize, UBaseType_t uxBlockCount, uint8_t *pucPoolStorage, StaticMemPool_t *pxStaticMemPool ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mempool.h
+ *<pre>
+ void *pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait );
+ </pre>
+ *
+ * Allocate a block from a memory pool.  If the pool is empty the calling task
+ * can wait in the Blocked state for another task or an interrupt to free a
+ * block.  If more than one task is waiting then the highest priority task
+ * obtains the next block freed.
+ *
+ * Must not be called from an interrupt - use pvMemPoolAllocFromISR() instead.
+ *
+ * @param xMemPool The pool from which the block is allocated.
+ *
+ * @param xTicksToWait The maximum time to wait in the Blocked state for a block
+ * to become available.  Set to 0 to return immediately.
+ *
+ * @return A pointer to the block, which is mempoolBLOCK_SIZE( xBlockSize )
+ * bytes long, or NULL if no block became available before the block time
+ * expired.
+ *
+ * \defgroup pvMemPoolAlloc pvMemPoolAlloc
+ * \ingroup MemPool
+ */
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool );
+ </pre>
+ *
+ * A version of pvMemPoolAlloc() that can be called from an interrupt service
+ * routine.  It never blocks.
+ *
+ * @param xMemPool The pool from which the block is allocated.
+ *
+ * @return A pointer to the block, or NULL if the pool was empty.
+ *
+ * \defgroup pvMemPoolAllocFromISR pvMemPoolAllocFromISR
+ * \ingroup MemPool
+ */
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ void vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock );
+ </pre>
+ *
+ * Return a block to the memory pool from which it was allocated.  If any tasks
+ * are waiting for a block then the highest priority waiting task is
+ * unblocked.
+ *
+ * Must not be called from an interrupt - use vMemPoolFreeFromISR() instead.
+ *
+ * @param xMemPool The pool to which the block is returned.
+ *
+ * @param pvBlock The block being freed, as returned by pvMemPoolAlloc() or
+ * pvMemPoolAllocFromISR().
+ *
+ * \defgroup vMemPoolFree vMemPoolFree
+ * \ingroup MemPool
+ */
+void vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ void vMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock, BaseType_t *pxHigherPriorityTaskWoken );
+ </pre>
+ *
+ * A version of vMemPoolFree() that can be called from an interrupt service
+ * routine.
+ *
+ * @param xMemPool The pool to which the block is returned.
+ *
+ * @param pvBlock The block being freed.
+ *
+ * @param pxHigherPriorityTaskWoken vMemPoolFreeFromISR() sets
+ * *pxHigherPriorityTaskWoken to pdTRUE if freeing the block unblocked a task
+ * that has a priority above that of the currently running task.  If
+ * vMemPoolFreeFromISR() sets this value to pdTRUE then a context switch should
+ * be requested before the interrupt is exited.  pxHigherPriorityTaskWoken can
+ * be NULL.
+ *
+ * \defgroup vMemPoolFreeFromISR vMemPoolFreeFromISR
+ * \ingroup MemPool
+ */
+void vMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xMemPool );
+ </pre>
+ *
+ * @return The number of blocks that are currently free in xMemPool.  Can be
+ * called from an interrupt.
+ *
+ * \defgroup uxMemPoolGetFreeCount uxMemPoolGetFreeCount
+ * \ingroup MemPool
+ */
+UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ UBaseType_t uxMemPoolGetMinimumEverFreeCount( MemPoolHandle_t xMemPool );
+ </pre>
+ *
+ * @return The lowest number of blocks that have been free in xMemPool since the
+ * pool was created, which can be used to size the pool.
+ *
+ * \defgroup uxMemPoolGetMinimumEverFreeCount uxMemPoolGetMinimumEverFreeCount
+ * \ingroup MemPool
+ */
+UBaseType_t uxMemPoolGetMinimumEverFreeCount( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ size_t xMemPoolGetBlockSize( MemPoolHandle_t xMemPool );
+ </pre>
+ *
+ * @return The size of each block in xMemPool after rounding, which may be
+ * larger than the block size passed in when the pool was created.
+ *
+ * \defgroup xMemPoolGetBlockSize xMemPoolGetBlockSize
+ * \ingroup MemPool
+ */
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ *<pre>
+ void vMemPoolDelete( MemPoolHandle_t xMemPool );
+ </pre>
+ *
+ * Delete a memory pool.  No tasks can be waiting for a block when the pool is
+ * deleted, and blocks that are still allocated must not be used afterwards.
+ *
+ * @param xMemPool The pool being deleted.
+ *
+ * \defgroup vMemPoolDelete vMemPoolDelete
+ * \ingroup MemPool
+ */
+void vMemPoolDelete( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEMPOOL_H */
@@ -796,6 +796,26 @@ BaseType_t xMessageBufferReceiveCompletedFromISR( MessageBufferHandle_t xStreamB
  */
 #define xMessageBufferReceiveCompletedFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) xStreamBufferReceiveCompletedFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxHigherPriorityTaskWoken )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+BaseType_t xMessageBufferAddToSet( MessageBufferHandle_t xMessageBuffer, QueueSetHandle_t xQueueSet );
+BaseType_t xMessageBufferRemoveFromSet( MessageBufferHandle_t xMessageBuffer, QueueSetHandle_t xQueueSet );
+</pre>
+ *
+ * Add a message buffer to, or remove a message buffer from, a queue set.  A
+ * message buffer in a set is ready whenever it holds at least one message.  See
+ * xStreamBufferAddToSet() and xStreamBufferRemoveFromSet().
+ *
+ * \defgroup xMessageBufferAddToSet xMessageBufferAddToSet
+ * \ingroup MessageBufferManagement
+ */
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+	#define xMessageBufferAddToSet( xMessageBuffer, xQueueSet ) xStreamBufferAddToSet( ( StreamBufferHandle_t ) xMessageBuffer, xQueueSet )
+	#define xMessageBufferRemoveFromSet( xMessageBuffer, xQueueSet ) xStreamBufferRemoveFromSet( ( StreamBufferHandle_t ) xMessageBuffer, xQueueSet )
+#endif
+
 #if defined( __cplusplus )
 } /* extern "C" */
 #endif
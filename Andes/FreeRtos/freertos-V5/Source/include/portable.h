@@ -88,6 +88,10 @@ must be set in the compiler's include path. */
 	#define portHAS_STACK_OVERFLOW_CHECKING 0
 #endif
 
+#ifndef portHAS_STACK_PEAK_RECORDING
+	#define portHAS_STACK_PEAK_RECORDING 0
+#endif
+
 #ifndef portARCH_NAME
 	#define portARCH_NAME NULL
 #endif
@@ -157,6 +161,20 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t *pxHeapStats );
 
+/*
+ * Used by the kernel when a task is deleted to return any blocks held in the
+ * task's heap cache (see configUSE_TASK_HEAP_CACHE) to the heap.  Only
+ * implemented by heap_4.c and heap_5.c.
+ */
+void vPortReleaseTaskHeapCache( void **ppvHeapCache ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate xSize bytes aligned to xAlignment, which must be a power of two, for
+ * example so a DMA buffer starts on a cache line.  The memory is freed with
+ * vPortFree().  Only implemented by heap_4.c and heap_5.c.
+ */
+void *pvPortMallocAligned( size_t xSize, size_t xAlignment ) PRIVILEGED_FUNCTION;
+
 /*
  * Map to the memory management routines required for the port.
  */
@@ -73,6 +73,8 @@ typedef struct QueueDefinition * QueueSetMemberHandle_t;
 #define queueQUEUE_TYPE_COUNTING_SEMAPHORE	( ( uint8_t ) 2U )
 #define queueQUEUE_TYPE_BINARY_SEMAPHORE	( ( uint8_t ) 3U )
 #define queueQUEUE_TYPE_RECURSIVE_MUTEX		( ( uint8_t ) 4U )
+#define queueQUEUE_TYPE_CEILING_MUTEX		( ( uint8_t ) 5U )
+#define queueQUEUE_TYPE_FAST_SEMAPHORE		( ( uint8_t ) 6U )
 
 /**
  * queue. h
@@ -1413,9 +1415,29 @@ BaseType_t xQueueCRReceive( QueueHandle_t xQueue, void *pvBuffer, TickType_t xTi
  */
 QueueHandle_t xQueueCreateMutex( const uint8_t ucQueueType ) PRIVILEGED_FUNCTION;
 QueueHandle_t xQueueCreateMutexStatic( const uint8_t ucQueueType, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
+QueueHandle_t xQueueCreateCeilingMutex( const UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+QueueHandle_t xQueueCreateCeilingMutexStatic( const UBaseType_t uxCeilingPriority, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
 QueueHandle_t xQueueCreateCountingSemaphore( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount ) PRIVILEGED_FUNCTION;
 QueueHandle_t xQueueCreateCountingSemaphoreStatic( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
 BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Use xSemaphoreTakeCeiling() and
+ * xSemaphoreGiveCeiling() instead of calling these functions directly.
+ */
+BaseType_t xQueueCeilingMutexTake( QueueHandle_t xMutex, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueCeilingMutexGive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Use xSemaphoreCreateFast(), xSemaphoreTakeFast()
+ * and xSemaphoreGiveFast() instead of calling these functions directly.
+ */
+QueueHandle_t xQueueCreateFastSemaphore( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount ) PRIVILEGED_FUNCTION;
+QueueHandle_t xQueueCreateFastSemaphoreStatic( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueFastSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueFastSemaphoreGive( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueFastSemaphoreGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
 TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
 
@@ -1550,6 +1572,15 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
  *    5, and a counting semaphore that has a maximum count of 3, then
  *    uxEventQueueLength should be set to (5 + 3), or 8.
  *
+ * Note 5:  When configUSE_QUEUE_SET_BITMAP is set to 1 in FreeRTOSConfig.h the
+ * queue set does not store events.  Each member instead has a bit in a ready
+ * bit map, so sending to a member does not copy its handle into the set, and
+ * uxEventQueueLength is the maximum number of members the set can hold (at most
+ * 1024) rather than the sum of their lengths.  A bitmap queue set can also
+ * contain stream buffers and message buffers - see xStreamBufferAddToSet().
+ * Only queues, binary and counting semaphores, and stream and message buffers
+ * can be members; fast semaphores cannot.
+ *
  * @return If the queue set is created successfully then a handle to the created
  * queue set is returned.  Otherwise NULL is returned.
  */
@@ -1572,6 +1603,11 @@ QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength ) PRIVILE
  * @param xQueueSet The handle of the queue set to which the queue or semaphore
  * is being added.
  *
+ * Note 2:  When configUSE_QUEUE_SET_BITMAP is set to 1 a queue or semaphore
+ * that already contains data can be added to a set, in which case it is ready
+ * immediately.  Adding fails if the set already holds its maximum number of
+ * members.
+ *
  * @return If the queue or semaphore was successfully added to the queue set
  * then pdPASS is returned.  If the queue could not be successfully added to the
  * queue set because it is already a member of a different queue set then pdFAIL
@@ -1581,7 +1617,9 @@ BaseType_t xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHan
 
 /*
  * Removes a queue or semaphore from a queue set.  A queue or semaphore can only
- * be removed from a set if the queue or semaphore is empty.
+ * be removed from a set if the queue or semaphore is empty, unless
+ * configUSE_QUEUE_SET_BITMAP is set to 1, in which case it can be removed at
+ * any time.
  *
  * See FreeRTOS/Source/Demo/Common/Minimal/QueueSet.c for an example using this
  * function.
@@ -1619,6 +1657,12 @@ BaseType_t xQueueRemoveFromSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueS
  * semaphore) operation must not be performed on a member of a queue set unless
  * a call to xQueueSelectFromSet() has first returned a handle to that set member.
  *
+ * Note 4:  When configUSE_QUEUE_SET_BITMAP is set to 1 each call returns a
+ * member that held data when it was selected, starting the search after the
+ * member returned last so busy members cannot starve the others.  A member
+ * stays ready until it is found to be empty, so a member that is not read after
+ * being selected will be returned again by a later call.
+ *
  * @param xQueueSet The queue set on which the task will (potentially) block.
  *
  * @param xTicksToWait The maximum time, in ticks, that the calling task will
@@ -1646,6 +1690,26 @@ void vQueueSetQueueNumber( QueueHandle_t xQueue, UBaseType_t uxQueueNumber ) PRI
 UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 uint8_t ucQueueGetQueueType( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+	/* Used by stream_buffer.c to place stream and message buffers in a queue
+	set.  All three functions must be called from within a critical section. */
+	#define queueSET_MEMBER_TYPE_QUEUE			( ( uint8_t ) 0U )
+	#define queueSET_MEMBER_TYPE_STREAM_BUFFER	( ( uint8_t ) 1U )
+
+	BaseType_t xQueueSetAddMember( QueueSetHandle_t xQueueSet, void *pvMember, uint8_t ucMemberType, UBaseType_t *puxMemberIndex ) PRIVILEGED_FUNCTION;
+	void vQueueSetRemoveMember( QueueSetHandle_t xQueueSet, UBaseType_t uxMemberIndex ) PRIVILEGED_FUNCTION;
+	BaseType_t xQueueSetMemberReady( QueueSetHandle_t xQueueSet, UBaseType_t uxMemberIndex ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	/* Used by rwlock.c.  Recalculate the priority xMutexHolder inherits through
+	every mutex and reader-writer lock it holds, then pass any change on along
+	the chain of mutex holders it is blocked behind.  Returns pdTRUE if the
+	priority of xMutexHolder changed.  Must be called from within a critical
+	section. */
+	BaseType_t xQueueUpdateMutexHolderPriority( TaskHandle_t const xMutexHolder ) PRIVILEGED_FUNCTION;
+#endif
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,315 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include rwlock.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A reader-writer lock guards a resource that is read far more often than it
+ * is written, such as a routing table or a configuration store.  Any number of
+ * tasks can hold the lock for reading at the same time, but a task that holds
+ * the lock for writing has exclusive access - no other task can hold the lock
+ * for either reading or writing.
+ *
+ * Tasks that cannot obtain the lock wait on one of the lock's two event lists
+ * in priority order, and can specify a maximum time to wait.  A task that holds
+ * the lock for writing inherits the priority of the highest priority task that
+ * is waiting for the lock, in the same way as the holder of a mutex.  The
+ * holders of a read lock are not recorded, so do not inherit priorities.
+ * Priorities are not propagated through reader-writer locks when
+ * configUSE_TRANSITIVE_PRIORITY_INHERITANCE is 1, and a task that holds both a
+ * write lock and a mutex should give the mutex back after releasing the write
+ * lock, as giving the mutex back recalculates the holder's priority from the
+ * mutexes it still holds only.
+ *
+ * configUSE_RW_LOCKS must be set to 1 in FreeRTOSConfig.h for the functions
+ * in this file to be available, and rwlock.c must be included in the build.
+ * Reader-writer locks can only be used from tasks, not from interrupts.
+ *
+ * \defgroup RWLock RWLock
+ */
+
+/**
+ * rwlock.h
+ *
+ * Type by which reader-writer locks are referenced.  For example, a call to
+ * xRWLockCreate() returns an RWLockHandle_t variable that can then be used as
+ * a parameter to the other reader-writer lock functions.
+ *
+ * \defgroup RWLockHandle_t RWLockHandle_t
+ * \ingroup RWLock
+ */
+struct RWLockDef_t;
+typedef struct RWLockDef_t * RWLockHandle_t;
+
+/* Policies that can be passed to xRWLockCreate() and xRWLockCreateStatic().
+With rwlockPREFER_WRITERS a task cannot obtain a read lock while another task
+is waiting for a write lock, so a steady stream of readers cannot keep writers
+out.  With rwlockPREFER_READERS a task can always obtain a read lock while the
+lock is held for reading, which gives the greatest read throughput but can
+starve writers. */
+#define rwlockPREFER_WRITERS	( ( UBaseType_t ) 0U )
+#define rwlockPREFER_READERS	( ( UBaseType_t ) 1U )
+
+/**
+ * rwlock.h
+ *<pre>
+ RWLockHandle_t xRWLockCreate( UBaseType_t uxPolicy );
+ </pre>
+ *
+ * Create a new reader-writer lock, allocating the memory required to hold the
+ * lock from the FreeRTOS heap.
+ *
+ * @param uxPolicy Either rwlockPREFER_WRITERS or rwlockPREFER_READERS, as
+ * described above.
+ *
+ * @return If the lock was created then a handle to the lock is returned.  If
+ * there was insufficient FreeRTOS heap available to create the lock then NULL
+ * is returned.
+ *
+ * Example usage:
+   <pre>
+	RWLockHandle_t xRouteTableLock;
+
+	void vInitialiseRoutes( void )
+	{
+		xRouteTableLock = xRWLockCreate( rwlockPREFER_WRITERS );
+		configASSERT( xRouteTableLock );
+	}
+
+	BaseType_t xLookUpRoute( uint32_t ulAddress, Route_t *pxRoute )
+	{
+	BaseType_t xFound = pdFALSE;
+
+		if( xRWLockAcquireRead( xRouteTableLock, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+		{
+			// Any number of tasks can be searching the table at once.
+			xFound = prvSearchRouteTable( ulAddress, pxRoute );
+			xRWLockReleaseRead( xRouteTableLock );
+		}
+
+		return xFound;
+	}
+
+	void vAddRoute( const Route_t *pxRoute )
+	{
+		if( xRWLockAcquireWrite( xRouteTableLock, portMAX_DELAY ) == pdPASS )
+		{
+			// No other task can be accessing the table.
+			prvInsertRoute( pxRoute );
+			xRWLockReleaseWrite( xRouteTableLock );
+		}
+	}
+   </pre>
+ * \defgroup xRWLockCreate xRWLockCreate
+ * \ingroup RWLock
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RWLockHandle_t xRWLockCreate( const UBaseType_t uxPolicy ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rwlock.h
+ *<pre>
+ RWLockHandle_t xRWLockCreateStatic( UBaseType_t uxPolicy, StaticRWLock_t *pxRWLockBuffer );
+ </pre>
+ *
+ * Create a new reader-writer lock using memory provided by the application
+ * writer.
+ *
+ * @param uxPolicy Either rwlockPREFER_WRITERS or rwlockPREFER_READERS.
+ *
+ * @param pxRWLockBuffer Must point to a variable of type StaticRWLock_t, which
+ * will then be used to hold the lock's data structures, removing the need for
+ * the memory to be allocated dynamically.
+ *
+ * @return If the lock was created then a handle to the lock is returned.  If
+ * pxRWLockBuffer was NULL then NULL is returned.
+ *
+ * \defgroup xRWLockCreateStatic xRWLockCreateStatic
+ * \ingroup RWLock
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RWLockHandle_t xRWLockCreateStatic( const UBaseType_t uxPolicy, StaticRWLock_t *pxRWLockBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rwlock.h
+ *<pre>
+ BaseType_t xRWLockAcquireRead( RWLockHandle_t xRWLock, TickType_t xTicksToWait );
+ </pre>
+ *
+ * Obtain a lock for reading.  The lock can be obtained if it is not held for
+ * writing and, if the lock was created with rwlockPREFER_WRITERS, no task is
+ * waiting to obtain it for writing.
+ *
+ * A task must not attempt to obtain a read lock while holding the same lock for
+ * writing, and must call xRWLockReleaseRead() once for each successful call to
+ * xRWLockAcquireRead().
+ *
+ * @param xRWLock The lock being obtained.
+ *
+ * @param xTicksToWait The maximum time to wait in the Blocked state for the
+ * lock to become available.  Set to 0 to return immediately.
+ *
+ * @return pdPASS if the lock was obtained, otherwise pdFAIL.
+ *
+ * \defgroup xRWLockAcquireRead xRWLockAcquireRead
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockAcquireRead( RWLockHandle_t xRWLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *<pre>
+ BaseType_t xRWLockAcquireWrite( RWLockHandle_t xRWLock, TickType_t xTicksToWait );
+ </pre>
+ *
+ * Obtain a lock for writing.  The lock can only be obtained if no other task
+ * holds it for either reading or writing.  While the calling task waits for the
+ * lock, the task holding the lock for writing (if any) inherits the calling
+ * task's priority if it is higher than its own.
+ *
+ * Write locks are not recursive - a task that holds a write lock must not
+ * attempt to obtain it again.
+ *
+ * @param xRWLock The lock being obtained.
+ *
+ * @param xTicksToWait The maximum time to wait in the Blocked state for the
+ * lock to become available.  Set to 0 to return immediately.
+ *
+ * @return pdPASS if the lock was obtained, otherwise pdFAIL.
+ *
+ * \defgroup xRWLockAcquireWrite xRWLockAcquireWrite
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockAcquireWrite( RWLockHandle_t xRWLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *<pre>
+ BaseType_t xRWLockReleaseRead( RWLockHandle_t xRWLock );
+ </pre>
+ *
+ * Release a lock previously obtained using xRWLockAcquireRead().  If this was
+ * the last read lock then a task waiting to write is unblocked.
+ *
+ * @param xRWLock The lock being released.
+ *
+ * @return pdPASS if the lock was released.  pdFAIL if the lock was not held
+ * for reading.
+ *
+ * \defgroup xRWLockReleaseRead xRWLockReleaseRead
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockReleaseRead( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *<pre>
+ BaseType_t xRWLockReleaseWrite( RWLockHandle_t xRWLock );
+ </pre>
+ *
+ * Release a lock previously obtained using xRWLockAcquireWrite().  Any priority
+ * inherited while the lock was held is disinherited.  Depending on the lock's
+ * policy either the highest priority task waiting to write or all the tasks
+ * waiting to read are unblocked.
+ *
+ * @param xRWLock The lock being released.
+ *
+ * @return pdPASS if the lock was released.  pdFAIL if the calling task did not
+ * hold the lock for writing.
+ *
+ * \defgroup xRWLockReleaseWrite xRWLockReleaseWrite
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockReleaseWrite( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *<pre>
+ UBaseType_t uxRWLockGetReaderCount( RWLockHandle_t xRWLock );
+ </pre>
+ *
+ * @return The number of read locks currently held on xRWLock.
+ *
+ * \defgroup uxRWLockGetReaderCount uxRWLockGetReaderCount
+ * \ingroup RWLock
+ */
+UBaseType_t uxRWLockGetReaderCount( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *<pre>
+ TaskHandle_t xRWLockGetWriteHolder( RWLockHandle_t xRWLock );
+ </pre>
+ *
+ * @return The handle of the task that holds xRWLock for writing, or NULL if
+ * the lock is not held for writing.
+ *
+ * \defgroup xRWLockGetWriteHolder xRWLockGetWriteHolder
+ * \ingroup RWLock
+ */
+TaskHandle_t xRWLockGetWriteHolder( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *<pre>
+ void vRWLockDelete( RWLockHandle_t xRWLock );
+ </pre>
+ *
+ * Delete a reader-writer lock.  The lock must not be held, and no tasks can be
+ * waiting for it, when it is deleted.
+ *
+ * @param xRWLock The lock being deleted.
+ *
+ * \defgroup vRWLockDelete vRWLockDelete
+ * \ingroup RWLock
+ */
+void vRWLockDelete( RWLockHandle_t xRWLock ) PRIVILEGED_FUNCTION;
+
+/* Not public API functions. */
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	/* Used by queue.c.  Returns the priority of the highest priority task
+	waiting for any of the locks held for writing by xWriteHolder, or
+	tskIDLE_PRIORITY if there are none. */
+	UBaseType_t uxRWLockGetHighestPriorityOfHeldLockWaiters( TaskHandle_t const xWriteHolder ) PRIVILEGED_FUNCTION;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RWLOCK_H */
@@ -0,0 +1,184 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef SECTION_PROFILE_H
+#define SECTION_PROFILE_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include section_profile.h"
+#endif
+
+#ifndef INC_TASK_H
+	#error "include task.h" must appear in source files before "include section_profile.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Critical section and scheduler suspension profiling.
+ *
+ * When configUSE_SECTION_PROFILING is 1 tasks.c times, using
+ * portGET_CYCLE_COUNT(), every outermost critical section entered with
+ * taskENTER_CRITICAL() and every period for which the scheduler is suspended
+ * by vTaskSuspendAll().  For each of the two kinds of section a count and a
+ * histogram of the times are kept, along with the configSECTION_PROFILE_LONGEST
+ * longest sections seen, each with the address from which the section was
+ * entered and the task that entered it.  The longest sections are the places
+ * that add most to interrupt latency and to the time taken to switch to a
+ * higher priority task, so they are the places to shorten first.
+ *
+ * A task that yields from within a critical section runs with interrupts
+ * enabled until it is switched back in, so the time for which it is switched
+ * out is not counted.  Critical sections are only timed on ports that keep
+ * the critical nesting count in the TCB (portCRITICAL_NESTING_IN_TCB set to
+ * 1), and neither kind of section is timed before the scheduler is started.
+ * When configUSE_TICKLESS_IDLE is not 0 the idle task sleeps with the
+ * scheduler suspended, so its sleeps are recorded as scheduler suspensions.
+ *
+ * Profiling adds a few cycle counter reads and three members to each TCB,
+ * and records each section with interrupts disabled at the point the section
+ * ends, which lengthens every section by the time taken to record it.
+ *
+ * configUSE_SECTION_PROFILING must be set to 1 in FreeRTOSConfig.h for the
+ * functions in this file to be available, and section_profile.c must be
+ * included in the build.
+ *
+ * \defgroup SectionProfile SectionProfile
+ */
+
+/* The kinds of section that are profiled. */
+#define sectprofCRITICAL_SECTION		( 0U )
+#define sectprofSCHEDULER_SUSPENDED		( 1U )
+#define sectprofNUMBER_OF_KINDS			( 2U )
+
+/* The number of buckets in each histogram.  Bucket n counts sections of 2^n
+to ( 2^( n + 1 ) ) - 1 cycles, except the first bucket also counts 0 and the
+last bucket counts every longer section. */
+#define sectprofHISTOGRAM_BUCKETS		( 16 )
+
+/* Describes one of the longest sections. */
+typedef struct xSECTION_RECORD
+{
+	uint32_t ulCycles;		/* The length of the section. */
+	void *pvCaller;			/* The return address of the taskENTER_CRITICAL() or vTaskSuspendAll() call that started the section, or NULL if not known. */
+	TaskHandle_t xTask;		/* The task that entered the section.  The task might since have been deleted. */
+} SectionRecord_t;
+
+/* Used to pass information out of vSectionProfileGet(). */
+typedef struct xSECTION_PROFILE
+{
+	uint32_t ulCount;										/* The number of sections recorded. */
+	uint32_t ulHistogram[ sectprofHISTOGRAM_BUCKETS ];		/* Sections by the number of cycles taken. */
+	SectionRecord_t xLongest[ configSECTION_PROFILE_LONGEST ];	/* The longest sections, longest first.  Entries not yet used are zero. */
+} SectionProfile_t;
+
+/**
+ * section_profile.h
+ *<pre>
+ void vSectionProfileGet( UBaseType_t uxKind, SectionProfile_t *pxProfile );
+ </pre>
+ *
+ * Return a copy of the profile of one kind of section.
+ *
+ * @param uxKind sectprofCRITICAL_SECTION or sectprofSCHEDULER_SUSPENDED.
+ *
+ * @param pxProfile The structure into which the profile is written.
+ *
+ * Example usage:
+   <pre>
+	void vShowLongestCriticalSection( void )
+	{
+	static SectionProfile_t xProfile;
+
+		vSectionProfileGet( sectprofCRITICAL_SECTION, &xProfile );
+
+		// xProfile.xLongest[ 0 ].pvCaller is the code that kept interrupts
+		// masked for longest, and xProfile.xLongest[ 0 ].ulCycles is how long
+		// it kept them masked.
+	}
+   </pre>
+ * \defgroup vSectionProfileGet vSectionProfileGet
+ * \ingroup SectionProfile
+ */
+void vSectionProfileGet( UBaseType_t uxKind, SectionProfile_t *pxProfile ) PRIVILEGED_FUNCTION;
+
+/**
+ * section_profile.h
+ *<pre>
+ void vSectionProfileReset( void );
+ </pre>
+ *
+ * Clear the profiles of both kinds of section, so for example the sections
+ * taken while the application initialises can be discarded.
+ *
+ * \defgroup vSectionProfileReset vSectionProfileReset
+ * \ingroup SectionProfile
+ */
+void vSectionProfileReset( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * section_profile.h
+ *<pre>
+ void vSectionProfileList( char *pcWriteBuffer, size_t xBufferLength );
+ </pre>
+ *
+ * configUSE_STATS_FORMATTING_FUNCTIONS must be set to a value greater than 0
+ * in FreeRTOSConfig.h for this function to be available.
+ *
+ * Write a human readable table of the longest sections to pcWriteBuffer, one
+ * line per section, giving the kind, cycles, caller and task in that order,
+ * followed by one line per kind giving the number of sections recorded.  Like
+ * vTaskList() this is intended for debugging, so is not efficient.
+ *
+ * @param pcWriteBuffer The buffer into which the table is written.
+ *
+ * @param xBufferLength The size of pcWriteBuffer in bytes.  The table is
+ * truncated if it does not fit.
+ *
+ * \defgroup vSectionProfileList vSectionProfileList
+ * \ingroup SectionProfile
+ */
+void vSectionProfileList( char *pcWriteBuffer, size_t xBufferLength ) PRIVILEGED_FUNCTION;
+
+/*
+ * THE FOLLOWING FUNCTION IS FOR THE USE OF THE KERNEL ONLY, AND SHOULD NOT BE
+ * CALLED FROM APPLICATION CODE.
+ *
+ * vSectionProfileRecord() records a section of kind uxKind that lasted
+ * ulCycles.  It must be called with interrupts disabled, and does not enter a
+ * critical section itself, so it can be called from the end of a critical
+ * section.
+ */
+void vSectionProfileRecord( UBaseType_t uxKind, uint32_t ulCycles, void *pvCaller, TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SECTION_PROFILE_H */
@@ -778,6 +778,159 @@ typedef QueueHandle_t SemaphoreHandle_t;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
 
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateCeilingMutex( UBaseType_t uxCeilingPriority )</pre>
+ *
+ * Creates a new priority ceiling mutex type semaphore instance, and returns a
+ * handle by which the new mutex can be referenced.
+ *
+ * configUSE_CEILING_MUTEXES must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * A priority ceiling mutex uses the immediate priority ceiling protocol in
+ * place of priority inheritance.  A task that takes the mutex has its
+ * priority raised to uxCeilingPriority straight away, so it cannot be
+ * preempted by any other task that uses the mutex until the mutex is given
+ * back.  Tasks that block on the mutex do not cause the holder's priority to
+ * be changed, making the worst case blocking time easier to bound, and taking
+ * the mutex does not require the list of waiting tasks to be inspected.
+ *
+ * uxCeilingPriority must be at least as high as the priority of the highest
+ * priority task that will ever take the mutex.  Taking the mutex from a task
+ * with a higher priority triggers configASSERT().
+ *
+ * As with other mutex types, the raised priority is only dropped once the
+ * holding task no longer holds any mutexes.
+ *
+ * Mutexes created using this function can be accessed using the
+ * xSemaphoreTake() and xSemaphoreGive() macros, or the faster
+ * xSemaphoreTakeCeiling() and xSemaphoreGiveCeiling() macros.  The
+ * xSemaphoreTakeRecursive() and xSemaphoreGiveRecursive() macros must not be
+ * used.
+ *
+ * Mutex type semaphores cannot be used from within interrupt service routines.
+ *
+ * @param uxCeilingPriority The priority at which a task holding the mutex
+ * executes.  Must be less than configMAX_PRIORITIES.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * semaphore is returned.  If there was not enough heap to allocate the mutex
+ * data structures then NULL is returned.
+ *
+ * Example usage:
+ <pre>
+ #define mainSPI_CEILING_PRIORITY ( tskIDLE_PRIORITY + 3 )
+
+ SemaphoreHandle_t xSemaphore;
+
+ void vATask( void * pvParameters )
+ {
+    // Create a mutex that is used by tasks whose priorities are no higher
+    // than mainSPI_CEILING_PRIORITY.
+    xSemaphore = xSemaphoreCreateCeilingMutex( mainSPI_CEILING_PRIORITY );
+
+    if( xSemaphore != NULL )
+    {
+        // While this task holds the mutex it runs at mainSPI_CEILING_PRIORITY.
+        if( xSemaphoreTake( xSemaphore, portMAX_DELAY ) == pdTRUE )
+        {
+            // Access the shared resource here, then give the mutex back.
+            xSemaphoreGive( xSemaphore );
+        }
+    }
+ }
+ </pre>
+ * \defgroup xSemaphoreCreateCeilingMutex xSemaphoreCreateCeilingMutex
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_CEILING_MUTEXES == 1 ) )
+	#define xSemaphoreCreateCeilingMutex( uxCeilingPriority ) xQueueCreateCeilingMutex( ( uxCeilingPriority ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateCeilingMutexStatic( UBaseType_t uxCeilingPriority, StaticSemaphore_t *pxMutexBuffer )</pre>
+ *
+ * Creates a new priority ceiling mutex type semaphore instance using memory
+ * provided by the application writer.  See xSemaphoreCreateCeilingMutex() for
+ * a description of priority ceiling mutexes.
+ *
+ * @param uxCeilingPriority The priority at which a task holding the mutex
+ * executes.  Must be less than configMAX_PRIORITIES.
+ *
+ * @param pxMutexBuffer Must point to a variable of type StaticSemaphore_t,
+ * which will be used to hold the mutex's data structure, removing the need for
+ * the memory to be allocated dynamically.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * mutex is returned.  If pxMutexBuffer was NULL then NULL is returned.
+ *
+ * Example usage:
+ <pre>
+ SemaphoreHandle_t xSemaphore;
+ StaticSemaphore_t xMutexBuffer;
+
+ void vATask( void * pvParameters )
+ {
+    // As no dynamic memory allocation is performed, xSemaphore cannot be NULL.
+    xSemaphore = xSemaphoreCreateCeilingMutexStatic( tskIDLE_PRIORITY + 3, &xMutexBuffer );
+ }
+ </pre>
+ * \defgroup xSemaphoreCreateCeilingMutexStatic xSemaphoreCreateCeilingMutexStatic
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configUSE_CEILING_MUTEXES == 1 ) )
+	#define xSemaphoreCreateCeilingMutexStatic( uxCeilingPriority, pxMutexBuffer ) xQueueCreateCeilingMutexStatic( ( uxCeilingPriority ), ( pxMutexBuffer ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>BaseType_t xSemaphoreTakeCeiling( SemaphoreHandle_t xSemaphore, TickType_t xBlockTime )</pre>
+ *
+ * Obtain a mutex created using xSemaphoreCreateCeilingMutex() or
+ * xSemaphoreCreateCeilingMutexStatic().  If the mutex is available it is
+ * taken, and the calling task raised to the mutex's ceiling priority, in a
+ * single critical section without going through the generic semaphore code.
+ * If the mutex is not available the call behaves as xSemaphoreTake().
+ *
+ * @param xSemaphore A handle to the priority ceiling mutex being taken.
+ *
+ * @param xBlockTime The time in ticks to wait for the mutex to become
+ * available.  A block time of zero can be used to poll the mutex.
+ *
+ * @return pdTRUE if the mutex was obtained.  pdFALSE if xBlockTime expired
+ * without the mutex becoming available.
+ *
+ * \defgroup xSemaphoreTakeCeiling xSemaphoreTakeCeiling
+ * \ingroup Semaphores
+ */
+#if( configUSE_CEILING_MUTEXES == 1 )
+	#define xSemaphoreTakeCeiling( xSemaphore, xBlockTime ) xQueueCeilingMutexTake( ( QueueHandle_t ) ( xSemaphore ), ( xBlockTime ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>BaseType_t xSemaphoreGiveCeiling( SemaphoreHandle_t xSemaphore )</pre>
+ *
+ * Release a priority ceiling mutex previously obtained using
+ * xSemaphoreTakeCeiling() or xSemaphoreTake().  If no task is waiting for the
+ * mutex it is given back, and the calling task's priority restored, in a
+ * single critical section.  Otherwise the call behaves as xSemaphoreGive().
+ *
+ * @param xSemaphore A handle to the priority ceiling mutex being released.
+ *
+ * @return pdTRUE if the mutex was released.  pdFALSE if the mutex was not
+ * held.
+ *
+ * \defgroup xSemaphoreGiveCeiling xSemaphoreGiveCeiling
+ * \ingroup Semaphores
+ */
+#if( configUSE_CEILING_MUTEXES == 1 )
+	#define xSemaphoreGiveCeiling( xSemaphore ) xQueueCeilingMutexGive( ( QueueHandle_t ) ( xSemaphore ) )
+#endif
+
+
 /**
  * semphr. h
  * <pre>SemaphoreHandle_t xSemaphoreCreateRecursiveMutex( void )</pre>
@@ -1083,6 +1236,196 @@ typedef QueueHandle_t SemaphoreHandle_t;
 	#define xSemaphoreCreateCountingStatic( uxMaxCount, uxInitialCount, pxSemaphoreBuffer ) xQueueCreateCountingSemaphoreStatic( ( uxMaxCount ), ( uxInitialCount ), ( pxSemaphoreBuffer ) )
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateFast( UBaseType_t uxMaxCount, UBaseType_t uxInitialCount )</pre>
+ *
+ * Creates a new fast semaphore instance, and returns a handle by which the new
+ * fast semaphore can be referenced.  configUSE_FAST_SEMAPHORES must be set to
+ * 1 in FreeRTOSConfig.h for this macro to be available.
+ *
+ * A fast semaphore behaves like a counting semaphore, but its count is held
+ * outside of the queue structure and is updated using the functions in
+ * atomic.h.  Taking a fast semaphore that is available, or giving a fast
+ * semaphore that no task is waiting for, therefore does not enter a critical
+ * section, suspend the scheduler, or access the semaphore's event lists.  The
+ * kernel is only entered when a task has to block on the semaphore, or when a
+ * give has to unblock a task.  On ports that set portHAS_ATOMIC_INSTRUCTIONS
+ * to 1 the uncontended paths are a single atomic instruction.
+ *
+ * Fast semaphores must only be accessed using xSemaphoreTakeFast(),
+ * xSemaphoreGiveFast() and xSemaphoreGiveFastFromISR().  The standard
+ * semaphore API functions, including uxSemaphoreGetCount(), must not be used
+ * with a fast semaphore.
+ *
+ * @param uxMaxCount The maximum count value that can be reached.  When the
+ *        semaphore reaches this value it can no longer be 'given'.
+ *
+ * @param uxInitialCount The count value assigned to the semaphore when it is
+ *        created.
+ *
+ * @return Handle to the created fast semaphore.  NULL if the memory required
+ * to hold the semaphore could not be allocated.
+ *
+ * Example usage:
+ <pre>
+ SemaphoreHandle_t xSemaphore;
+
+ void vATask( void * pvParameters )
+ {
+    // Create a fast semaphore that can count to 10, and which is initially
+    // empty.
+    xSemaphore = xSemaphoreCreateFast( 10, 0 );
+
+    if( xSemaphore != NULL )
+    {
+        // The semaphore was created successfully.
+        // The semaphore can now be used.
+    }
+ }
+ </pre>
+ * \defgroup xSemaphoreCreateFast xSemaphoreCreateFast
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_FAST_SEMAPHORES == 1 ) )
+	#define xSemaphoreCreateFast( uxMaxCount, uxInitialCount ) xQueueCreateFastSemaphore( ( uxMaxCount ), ( uxInitialCount ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateFastStatic( UBaseType_t uxMaxCount, UBaseType_t uxInitialCount, StaticSemaphore_t *pxSemaphoreBuffer )</pre>
+ *
+ * Creates a new fast semaphore instance using memory provided by the
+ * application writer.  See xSemaphoreCreateFast() for a description of fast
+ * semaphores.
+ *
+ * @param uxMaxCount The maximum count value that can be reached.
+ *
+ * @param uxInitialCount The count value assigned to the semaphore when it is
+ *        created.
+ *
+ * @param pxSemaphoreBuffer Must point to a variable of type StaticSemaphore_t,
+ * which will be used to hold the semaphore's data structure.
+ *
+ * @return If the fast semaphore was successfully created then a handle to the
+ * created semaphore is returned.  If pxSemaphoreBuffer was NULL then NULL is
+ * returned.
+ *
+ * \defgroup xSemaphoreCreateFastStatic xSemaphoreCreateFastStatic
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configUSE_FAST_SEMAPHORES == 1 ) )
+	#define xSemaphoreCreateFastStatic( uxMaxCount, uxInitialCount, pxSemaphoreBuffer ) xQueueCreateFastSemaphoreStatic( ( uxMaxCount ), ( uxInitialCount ), ( pxSemaphoreBuffer ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateFastMutex( void )</pre>
+ *
+ * Creates a fast semaphore that has a maximum count of 1 and is initially
+ * available, so can be used to guard a resource in the same way as a mutex.
+ *
+ * NOTE: Unlike a mutex created using xSemaphoreCreateMutex(), a fast mutex
+ * does not record its holder and does not implement priority inheritance, so
+ * it should only be used where the resource is guarded for short periods by
+ * tasks that all run at the same priority, or where priority inversion is
+ * otherwise known not to be a problem.
+ *
+ * @return Handle to the created fast mutex.  NULL if the memory required to
+ * hold the mutex could not be allocated.
+ *
+ * \defgroup xSemaphoreCreateFastMutex xSemaphoreCreateFastMutex
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_FAST_SEMAPHORES == 1 ) )
+	#define xSemaphoreCreateFastMutex() xQueueCreateFastSemaphore( ( UBaseType_t ) 1, ( UBaseType_t ) 1 )
+#endif
+
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateFastMutexStatic( StaticSemaphore_t *pxMutexBuffer )</pre>
+ *
+ * As xSemaphoreCreateFastMutex(), but the memory used to hold the mutex is
+ * provided by the application writer.
+ *
+ * @param pxMutexBuffer Must point to a variable of type StaticSemaphore_t,
+ * which will be used to hold the mutex's data structure.
+ *
+ * \defgroup xSemaphoreCreateFastMutexStatic xSemaphoreCreateFastMutexStatic
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configUSE_FAST_SEMAPHORES == 1 ) )
+	#define xSemaphoreCreateFastMutexStatic( pxMutexBuffer ) xQueueCreateFastSemaphoreStatic( ( UBaseType_t ) 1, ( UBaseType_t ) 1, ( pxMutexBuffer ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>BaseType_t xSemaphoreTakeFast( SemaphoreHandle_t xSemaphore, TickType_t xBlockTime )</pre>
+ *
+ * Obtain a semaphore created using xSemaphoreCreateFast(),
+ * xSemaphoreCreateFastStatic(), xSemaphoreCreateFastMutex() or
+ * xSemaphoreCreateFastMutexStatic().  If the semaphore is available the call
+ * returns without entering the kernel.
+ *
+ * @param xSemaphore A handle to the fast semaphore being taken.
+ *
+ * @param xBlockTime The time in ticks to wait for the semaphore to become
+ * available.  A block time of zero can be used to poll the semaphore.
+ *
+ * @return pdTRUE if the semaphore was obtained.  pdFALSE if xBlockTime
+ * expired without the semaphore becoming available.
+ *
+ * \defgroup xSemaphoreTakeFast xSemaphoreTakeFast
+ * \ingroup Semaphores
+ */
+#if( configUSE_FAST_SEMAPHORES == 1 )
+	#define xSemaphoreTakeFast( xSemaphore, xBlockTime ) xQueueFastSemaphoreTake( ( QueueHandle_t ) ( xSemaphore ), ( xBlockTime ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>BaseType_t xSemaphoreGiveFast( SemaphoreHandle_t xSemaphore )</pre>
+ *
+ * Release a fast semaphore.  The kernel is only entered if a task is blocked
+ * waiting for the semaphore.  This must not be called from an ISR - see
+ * xSemaphoreGiveFastFromISR().
+ *
+ * @param xSemaphore A handle to the fast semaphore being released.
+ *
+ * @return pdTRUE if the semaphore was released.  errQUEUE_FULL if the
+ * semaphore's count was already at its maximum.
+ *
+ * \defgroup xSemaphoreGiveFast xSemaphoreGiveFast
+ * \ingroup Semaphores
+ */
+#if( configUSE_FAST_SEMAPHORES == 1 )
+	#define xSemaphoreGiveFast( xSemaphore ) xQueueFastSemaphoreGive( ( QueueHandle_t ) ( xSemaphore ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>BaseType_t xSemaphoreGiveFastFromISR( SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken )</pre>
+ *
+ * A version of xSemaphoreGiveFast() that can be called from an ISR.
+ *
+ * @param xSemaphore A handle to the fast semaphore being released.
+ *
+ * @param pxHigherPriorityTaskWoken xSemaphoreGiveFastFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if giving the semaphore caused a task
+ * to unblock, and the unblocked task has a priority higher than the currently
+ * running task.  If xSemaphoreGiveFastFromISR() sets this value to pdTRUE then
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * @return pdTRUE if the semaphore was released.  errQUEUE_FULL if the
+ * semaphore's count was already at its maximum.
+ *
+ * \defgroup xSemaphoreGiveFastFromISR xSemaphoreGiveFastFromISR
+ * \ingroup Semaphores
+ */
+#if( configUSE_FAST_SEMAPHORES == 1 )
+	#define xSemaphoreGiveFastFromISR( xSemaphore, pxHigherPriorityTaskWoken ) xQueueFastSemaphoreGiveFromISR( ( QueueHandle_t ) ( xSemaphore ), ( pxHigherPriorityTaskWoken ) )
+#endif
+
 /**
  * semphr. h
  * <pre>void vSemaphoreDelete( SemaphoreHandle_t xSemaphore );</pre>
@@ -0,0 +1,168 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include slab.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Kernel object slab caches.
+ *
+ * When configUSE_KERNEL_OBJECT_SLABS is 1 the control blocks of dynamically
+ * created tasks, queues (including semaphores and mutexes), software timers,
+ * event groups and stream buffers (including message buffers) are allocated
+ * from per type caches instead of directly from the FreeRTOS heap.  Each cache
+ * obtains memory from pvPortMalloc() a slab of configSLAB_OBJECTS_PER_SLAB
+ * objects at a time, and keeps freed objects on a free list for reuse, so
+ * creating and deleting an object takes constant time and objects that are
+ * created and deleted frequently do not fragment the heap.  The storage area
+ * of a queue or stream buffer, and the stack of a task, are still allocated
+ * from the heap as their size is not fixed.
+ *
+ * Memory used by a cache is never returned to the heap.  xSlabCacheReserve()
+ * can be used to populate a cache when the system starts, before the heap is
+ * fragmented.
+ *
+ * configUSE_KERNEL_OBJECT_SLABS must be set to 1 in FreeRTOSConfig.h for the
+ * functions in this file to be available, and slab.c must be included in the
+ * build.
+ *
+ * \defgroup SlabCache SlabCache
+ */
+
+/* The caches.  Each cache holds objects of one type, sized using the
+corresponding StaticXxx_t structure from FreeRTOS.h. */
+typedef enum
+{
+	eSlabCacheTask = 0,		/* Task control blocks. */
+	eSlabCacheQueue,		/* Queues, semaphores, mutexes and queue sets. */
+	eSlabCacheTimer,		/* Software timers. */
+	eSlabCacheEventGroup,	/* Event groups. */
+	eSlabCacheStreamBuffer,	/* Stream buffers and message buffers. */
+	eSlabCacheCount			/* The number of caches - not a valid cache. */
+} eSlabCache;
+
+/* Used to pass information about a cache out of vSlabCacheGetStats(). */
+typedef struct xSlabCacheStats
+{
+	size_t xObjectSize;						/* The size of each object in the cache, in bytes. */
+	size_t xNumberOfSlabs;					/* The number of slabs the cache has obtained from the heap. */
+	size_t xObjectsInUse;					/* The number of objects currently allocated from the cache. */
+	size_t xObjectsFree;					/* The number of objects held in the cache available for allocation. */
+	size_t xMaximumObjectsInUse;			/* The largest value xObjectsInUse has held since the system booted. */
+	size_t xNumberOfSuccessfulAllocations;	/* The number of objects allocated from the cache. */
+	size_t xNumberOfSuccessfulFrees;		/* The number of objects returned to the cache. */
+	size_t xNumberOfFailedAllocations;		/* The number of times an object was requested but the heap could not supply a new slab. */
+} SlabCacheStats_t;
+
+/**
+ * slab.h
+ *<pre>
+ BaseType_t xSlabCacheReserve( eSlabCache eCache, size_t xObjects );
+ </pre>
+ *
+ * Ensure a cache holds at least xObjects free objects, obtaining new slabs from
+ * the FreeRTOS heap as necessary.  Typically called before the scheduler is
+ * started, with the number of objects of each type the application expects to
+ * use, so later object creation does not need to access the heap at all.
+ *
+ * @param eCache The cache to populate.
+ *
+ * @param xObjects The number of objects that must be free in the cache.
+ *
+ * @return pdPASS if the cache holds at least xObjects free objects when the
+ * function returns, or pdFAIL if the heap could not supply enough memory.
+ *
+ * Example usage:
+   <pre>
+	int main( void )
+	{
+		// Each connection uses a queue and a timer, so make sure creating the
+		// objects for the maximum number of connections never fails.
+		xSlabCacheReserve( eSlabCacheQueue, MAX_CONNECTIONS );
+		xSlabCacheReserve( eSlabCacheTimer, MAX_CONNECTIONS );
+
+		vTaskStartScheduler();
+	}
+   </pre>
+ * \defgroup xSlabCacheReserve xSlabCacheReserve
+ * \ingroup SlabCache
+ */
+BaseType_t xSlabCacheReserve( eSlabCache eCache, size_t xObjects ) PRIVILEGED_FUNCTION;
+
+/**
+ * slab.h
+ *<pre>
+ void vSlabCacheGetStats( eSlabCache eCache, SlabCacheStats_t *pxStats );
+ </pre>
+ *
+ * Return information about the current state of a cache.
+ *
+ * @param eCache The cache being queried.
+ *
+ * @param pxStats The structure into which the information is written.
+ *
+ * \defgroup vSlabCacheGetStats vSlabCacheGetStats
+ * \ingroup SlabCache
+ */
+void vSlabCacheGetStats( eSlabCache eCache, SlabCacheStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/*
+ * THE FOLLOWING FUNCTIONS AND MACROS ARE FOR THE USE OF THE KERNEL ONLY, AND
+ * SHOULD NOT BE CALLED FROM APPLICATION CODE.
+ *
+ * pvSlabCacheAllocate() returns an object of at least xWantedSize bytes from a
+ * cache, or NULL if the cache is empty and a new slab could not be allocated.
+ * vSlabCacheFree() returns an object obtained from pvSlabCacheAllocate() to
+ * the same cache.
+ */
+void *pvSlabCacheAllocate( eSlabCache eCache, size_t xWantedSize ) PRIVILEGED_FUNCTION;
+void vSlabCacheFree( eSlabCache eCache, void *pvObject ) PRIVILEGED_FUNCTION;
+
+/* Used by the kernel to allocate and free fixed size control blocks, so the
+kernel source does not need to test configUSE_KERNEL_OBJECT_SLABS at every
+allocation. */
+#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+	#define slabALLOCATE_OBJECT( eCache, xSize )	pvSlabCacheAllocate( ( eCache ), ( xSize ) )
+	#define slabFREE_OBJECT( eCache, pvObject )		vSlabCacheFree( ( eCache ), ( pvObject ) )
+#else
+	#define slabALLOCATE_OBJECT( eCache, xSize )	pvPortMallocKernelObject( xSize )
+	#define slabFREE_OBJECT( eCache, pvObject )		vPortFree( pvObject )
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLAB_H */
@@ -35,7 +35,9 @@
  *
  * Setting configCHECK_FOR_STACK_OVERFLOW to 1 will cause the macro to check
  * the current stack state only - comparing the current top of stack value to
- * the stack limit.  Setting configCHECK_FOR_STACK_OVERFLOW to greater than 1
+ * the stack limit, or, if configRECORD_STACK_PEAK is 1, comparing the lowest
+ * stack pointer the port recorded while the task ran to the stack limit.
+ * Setting configCHECK_FOR_STACK_OVERFLOW to greater than 1
  * will also cause the last few stack bytes to be checked to ensure the value
  * to which the bytes were set when the task was created have not been
  * overwritten.  Note this second test does not guarantee that an overflowed
@@ -44,7 +46,22 @@
 
 /*-----------------------------------------------------------*/
 
-#if( ( configCHECK_FOR_STACK_OVERFLOW == 1 ) && ( portSTACK_GROWTH < 0 ) )
+#if( ( configCHECK_FOR_STACK_OVERFLOW == 1 ) && ( portSTACK_GROWTH < 0 ) && ( configRECORD_STACK_PEAK == 1 ) )
+
+	/* The port records the lowest stack pointer the task has reached, which
+	catches an overflow between context switches too. */
+	#define taskCHECK_FOR_STACK_OVERFLOW()																\
+	{																									\
+		if( pxCurrentTCB->pxStackPeak <= pxCurrentTCB->pxStack )										\
+		{																								\
+			vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pxCurrentTCB->pcTaskName );	\
+		}																								\
+	}
+
+#endif /* configCHECK_FOR_STACK_OVERFLOW == 1 */
+/*-----------------------------------------------------------*/
+
+#if( ( configCHECK_FOR_STACK_OVERFLOW == 1 ) && ( portSTACK_GROWTH < 0 ) && ( configRECORD_STACK_PEAK == 0 ) )
 
 	/* Only the current stack state is to be checked. */
 	#define taskCHECK_FOR_STACK_OVERFLOW()																\
@@ -55,6 +55,11 @@
 	#error "include FreeRTOS.h must appear in source files before include stream_buffer.h"
 #endif
 
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+	/* For QueueSetHandle_t. */
+	#include "queue.h"
+#endif
+
 #if defined( __cplusplus )
 extern "C" {
 #endif
@@ -833,6 +838,79 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
  */
 BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+BaseType_t xStreamBufferAddToSet( StreamBufferHandle_t xStreamBuffer, QueueSetHandle_t xQueueSet );
+</pre>
+ *
+ * Adds a stream buffer to a queue set that was created by xQueueCreateSet(),
+ * so a task can block on the stream buffer and on queues, semaphores and other
+ * stream buffers at the same time.  configUSE_QUEUE_SET_BITMAP must be set to 1
+ * in FreeRTOSConfig.h for xStreamBufferAddToSet() to be available.
+ *
+ * The stream buffer is ready, and can be returned by xQueueSelectFromSet(),
+ * whenever it contains data, regardless of its trigger level.  As with queues,
+ * data must not be read from a stream buffer that is in a set unless
+ * xQueueSelectFromSet() has first returned its handle (cast to a
+ * QueueSetMemberHandle_t).
+ *
+ * @param xStreamBuffer The handle of the stream buffer being added to the set.
+ *
+ * @param xQueueSet The handle of the queue set.
+ *
+ * @return pdPASS if the stream buffer was added to the set.  pdFAIL if the
+ * stream buffer is already in a set, or the set already holds its maximum
+ * number of members.
+ *
+ * \defgroup xStreamBufferAddToSet xStreamBufferAddToSet
+ * \ingroup StreamBufferManagement
+ */
+BaseType_t xStreamBufferAddToSet( StreamBufferHandle_t xStreamBuffer, QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+BaseType_t xStreamBufferRemoveFromSet( StreamBufferHandle_t xStreamBuffer, QueueSetHandle_t xQueueSet );
+</pre>
+ *
+ * Removes a stream buffer from the queue set it was added to by
+ * xStreamBufferAddToSet().  The stream buffer does not need to be empty.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being removed.
+ *
+ * @param xQueueSet The handle of the queue set the stream buffer is in.
+ *
+ * @return pdPASS if the stream buffer was removed from the set, or pdFAIL if
+ * the stream buffer was not a member of xQueueSet.
+ *
+ * \defgroup xStreamBufferRemoveFromSet xStreamBufferRemoveFromSet
+ * \ingroup StreamBufferManagement
+ */
+BaseType_t xStreamBufferRemoveFromSet( StreamBufferHandle_t xStreamBuffer, QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+
+#if( configUSE_CO_ROUTINES == 1 )
+
+/*
+ * The functions defined above are for passing data to and from tasks.  The
+ * functions below are the equivalents for passing data to and from
+ * co-routines.
+ *
+ * These functions are called from the co-routine macro implementation and
+ * should not be called directly from application code.  Instead use the macro
+ * wrappers defined within croutine.h.
+ */
+BaseType_t xStreamBufferCRSend( StreamBufferHandle_t xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, size_t *pxBytesSent, TickType_t xTicksToWait );
+BaseType_t xStreamBufferCRReceive( StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, size_t *pxReceivedBytes, TickType_t xTicksToWait );
+
+#endif /* configUSE_CO_ROUTINES */
+
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
 												 size_t xTriggerLevelBytes,
@@ -75,6 +75,12 @@ typedef struct tskTaskControlBlock* TaskHandle_t;
  */
 typedef BaseType_t (*TaskHookFunction_t)( void * );
 
+/*
+ * Defines the prototype to which run to completion task handlers must conform.
+ * The second parameter is the notification value that triggered the handler.
+ */
+typedef void (*TaskRunToCompletionFunction_t)( void *, uint32_t );
+
 /* Task states returned by eTaskGetState. */
 typedef enum
 {
@@ -664,6 +670,82 @@ void vATask( void *pvParameters )
  */
 void vTaskAllocateMPURegions( TaskHandle_t xTask, const MemoryRegion_t * const pxRegions ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ *<pre>
+ BaseType_t xTaskCreateRunToCompletion(
+							  TaskRunToCompletionFunction_t pxTaskCode,
+							  const char * const pcName,
+							  void *pvParameters,
+							  UBaseType_t uxPriority,
+							  TaskHandle_t *pxCreatedTask
+						  );</pre>
+ *
+ * configUSE_SHARED_STACK_TASKS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Create a run to completion task.  Such a task is an event handler rather
+ * than a never ending loop: it waits, without consuming a stack, until it is
+ * sent a task notification, then pxTaskCode is called with the notification
+ * value (which is cleared) and the task waits again once pxTaskCode returns.
+ *
+ * Because a handler that has returned has nothing left on its stack, all the
+ * run to completion tasks of the same priority execute on a single stack of
+ * configSHARED_STACK_DEPTH words that is allocated when the first of them is
+ * created and is never freed.  A run to completion task therefore costs only
+ * its TCB.  Higher priority tasks can still preempt a handler part way
+ * through.  Other run to completion tasks of the same priority cannot, and
+ * are not time sliced with it, as they need the stack it is using.
+ *
+ * pxTaskCode must not block, must not hold a mutex (priority inheritance would
+ * move the task away from its stack) and must return with the scheduler
+ * resumed.  The task must not be suspended while its handler is running.
+ * Blocking in the handler, or suspending the task while its handler is
+ * running, triggers configASSERT().
+ *
+ * @param pxTaskCode The handler called each time the task is notified.
+ *
+ * @param pcName A descriptive name for the task.
+ *
+ * @param pvParameters Passed into pxTaskCode each time it is called.
+ *
+ * @param uxPriority The priority at which the handler runs.
+ *
+ * @param pxCreatedTask Used to pass back a handle by which the task can be
+ * notified.
+ *
+ * @return pdPASS if the task was created, otherwise
+ * errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY.
+ *
+ * Example usage:
+   <pre>
+ // Called each time the task is notified.
+ void vRxHandler( void *pvParameters, uint32_t ulNotifiedValue )
+ {
+	 vProcessFrames( ( Port_t * ) pvParameters, ulNotifiedValue );
+ }
+
+ void vOtherFunction( void )
+ {
+ TaskHandle_t xHandle;
+
+	 xTaskCreateRunToCompletion( vRxHandler, "RX", &xPort, tskIDLE_PRIORITY + 2, &xHandle );
+
+	 // Run the handler, passing 1 as the notification value.
+	 xTaskNotifyGive( xHandle );
+ }
+   </pre>
+ * \defgroup xTaskCreateRunToCompletion xTaskCreateRunToCompletion
+ * \ingroup Tasks
+ */
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+	BaseType_t xTaskCreateRunToCompletion(	TaskRunToCompletionFunction_t pxTaskCode,
+											const char * const pcName,	/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+											void * const pvParameters,
+											UBaseType_t uxPriority,
+											TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * <pre>void vTaskDelete( TaskHandle_t xTask );</pre>
@@ -1468,6 +1550,29 @@ UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask ) PRIVILEGED_FUNCTIO
  */
 configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * <PRE>configSTACK_DEPTH_TYPE uxTaskGetStackPeak( TaskHandle_t xTask, configSTACK_DEPTH_TYPE *puxStackSize );</PRE>
+ *
+ * configRECORD_STACK_PEAK must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available, which needs a port that records the deepest stack
+ * pointer of each task as it runs.
+ *
+ * Returns the most stack the task associated with xTask has used, in words,
+ * since it was created.  Unlike uxTaskGetStackHighWaterMark() the stack is not
+ * scanned, so the call takes the same time whatever the size of the stack, and
+ * stack the task reserved but never wrote is counted as used.
+ *
+ * @param xTask Handle of the task associated with the stack to be checked.
+ * Set xTask to NULL to check the stack of the calling task.
+ *
+ * @param puxStackSize If not NULL, set to the size of the stack in words.
+ *
+ * @return The most stack the task has used, in words.  A value larger than the
+ * size of the stack means the stack has overflowed.
+ */
+configSTACK_DEPTH_TYPE uxTaskGetStackPeak( TaskHandle_t xTask, configSTACK_DEPTH_TYPE *puxStackSize ) PRIVILEGED_FUNCTION;
+
 /* When using trace macros it is sometimes necessary to include task.h before
 FreeRTOS.h.  When this is done TaskHookFunction_t will not yet have been defined,
 so the following two prototypes will cause a compilation error.  This can be
@@ -2471,6 +2576,16 @@ BaseType_t xTaskPriorityDisinherit( TaskHandle_t const pxMutexHolder ) PRIVILEGE
  */
 void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder, UBaseType_t uxHighestPriorityWaitingTask ) PRIVILEGED_FUNCTION;
 
+/*
+ * Used by transitive priority inheritance.  Set the priority of the mutex
+ * holder to the greater of its base priority and uxHighestPriorityWaitingTask,
+ * which is the priority of the highest priority task waiting for any mutex the
+ * holder still holds.  If the holder is itself blocked on another mutex it is
+ * moved to the position in that mutex's waiting list that matches its new
+ * priority.  Returns pdTRUE if the holder's priority changed.
+ */
+BaseType_t xTaskPriorityInheritanceUpdate( TaskHandle_t const pxMutexHolder, UBaseType_t uxHighestPriorityWaitingTask ) PRIVILEGED_FUNCTION;
+
 /*
  * Get the uxTCBNumber assigned to the task referenced by the xTask parameter.
  */
@@ -2527,6 +2642,44 @@ eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Returns the heap cache array of the calling task,
+ * which has configHEAP_CACHE_SIZE_CLASSES entries, or NULL if the scheduler has
+ * not been started.  The contents of the array are managed by the heap
+ * implementation.
+ */
+void **ppvTaskGetHeapCache( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Raise the priority of the calling task to the
+ * ceiling priority of a priority ceiling mutex it has just taken.  The priority
+ * is restored by xTaskPriorityDisinherit() once the task no longer holds any
+ * mutexes.
+ */
+void vTaskPriorityRaiseToCeiling( UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Get and set the head of the list of mutexes held by
+ * a task, and the mutex the calling task is blocked waiting to obtain.  The
+ * kernel only stores these values, queue.c maintains them when
+ * configUSE_TRANSITIVE_PRIORITY_INHERITANCE is set to 1.
+ */
+void *pvTaskGetMutexesHeld( TaskHandle_t xMutexHolder ) PRIVILEGED_FUNCTION;
+void vTaskSetMutexesHeld( TaskHandle_t xMutexHolder, void *pvMutexesHeld ) PRIVILEGED_FUNCTION;
+void *pvTaskGetMutexBlockedOn( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+void vTaskSetMutexBlockedOn( void *pvMutex ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Get and set the head of the list of reader-writer
+ * locks held for writing by a task, and the lock the calling task is blocked
+ * waiting to obtain.  rwlock.c maintains these values when both
+ * configUSE_TRANSITIVE_PRIORITY_INHERITANCE and configUSE_RW_LOCKS are set to 1.
+ */
+void *pvTaskGetRWLocksHeld( TaskHandle_t xLockHolder ) PRIVILEGED_FUNCTION;
+void vTaskSetRWLocksHeld( TaskHandle_t xLockHolder, void *pvRWLocksHeld ) PRIVILEGED_FUNCTION;
+void *pvTaskGetRWLockBlockedOn( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+void vTaskSetRWLockBlockedOn( void *pvRWLock ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critial
  * section.
@@ -30,12 +30,37 @@
 #include "FreeRTOS.h"
 #include "list.h"
 
+#if( configUSE_SKIP_LISTS == 1 )
+
+	/* Each index level holds about one in four of the items in the level
+	below it, so two random bits are used per level. */
+	#define listSKIP_LIST_LEVEL_BITS	( 2U )
+	#define listSKIP_LIST_LEVEL_MASK	( ( 1UL << listSKIP_LIST_LEVEL_BITS ) - 1UL )
+
+	/*
+	 * Return the number of index levels a newly inserted item is linked into,
+	 * from 0 to configSKIP_LIST_LEVELS.
+	 */
+	static UBaseType_t prvSkipListLevels( void );
+
+	/* State of the pseudo random sequence used to choose the number of index
+	levels of each item.  Lists are only updated from critical sections or with
+	the scheduler suspended, and the sequence would not be harmed by a race
+	anyway. */
+	static uint32_t ulSkipListRandom = 0x2545f491UL;
+
+#endif /* configUSE_SKIP_LISTS */
+
 /*-----------------------------------------------------------
  * PUBLIC LIST API documented in list.h
  *----------------------------------------------------------*/
 
 void vListInitialise( List_t * const pxList )
 {
+#if( configUSE_SKIP_LISTS == 1 )
+	UBaseType_t uxLevel;
+#endif
+
 	/* The list structure contains a list item which is used to mark the
 	end of the list.  To initialise the list the list end is inserted
 	as the only list entry. */
@@ -50,6 +75,18 @@ void vListInitialise( List_t * const pxList )
 	pxList->xListEnd.pxNext = ( ListItem_t * ) &( pxList->xListEnd );	/*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	pxList->xListEnd.pxPrevious = ( ListItem_t * ) &( pxList->xListEnd );/*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 
+	/* The list end is also the end of every index level, so each index level
+	is empty in the same way. */
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+		for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configSKIP_LIST_LEVELS; uxLevel++ )
+		{
+			pxList->xListEnd.pxSkipNext[ uxLevel ] = ( ListItem_t * ) &( pxList->xListEnd );		/*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+			pxList->xListEnd.pxSkipPrevious[ uxLevel ] = ( ListItem_t * ) &( pxList->xListEnd );	/*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+		}
+	}
+	#endif
+
 	pxList->uxNumberOfItems = ( UBaseType_t ) 0U;
 
 	/* Write known values into the list if
@@ -64,6 +101,12 @@ void vListInitialiseItem( ListItem_t * const pxItem )
 	/* Make sure the list item is not recorded as being on a list. */
 	pxItem->pxContainer = NULL;
 
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+		pxItem->uxSkipLevels = 0U;
+	}
+	#endif
+
 	/* Write known values into the list item if
 	configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 	listSET_FIRST_LIST_ITEM_INTEGRITY_CHECK_VALUE( pxItem );
@@ -93,6 +136,14 @@ ListItem_t * const pxIndex = pxList->pxIndex;
 	pxIndex->pxPrevious->pxNext = pxNewListItem;
 	pxIndex->pxPrevious = pxNewListItem;
 
+	/* The list is not sorted, so the item is not added to the index
+	levels. */
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+		pxNewListItem->uxSkipLevels = 0U;
+	}
+	#endif
+
 	/* Remember which list the item is in. */
 	pxNewListItem->pxContainer = pxList;
 
@@ -104,6 +155,10 @@ void vListInsert( List_t * const pxList, ListItem_t * const pxNewListItem )
 {
 ListItem_t *pxIterator;
 const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
+#if( configUSE_SKIP_LISTS == 1 )
+	ListItem_t *pxPredecessors[ configSKIP_LIST_LEVELS ];
+	UBaseType_t uxLevel, uxLevels = 0U;
+#endif
 
 	/* Only effective when configASSERT() is also defined, these tests may catch
 	the list data structures being overwritten in memory.  They will not catch
@@ -147,7 +202,32 @@ const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
 			   before vTaskStartScheduler() has been called?).
 		**********************************************************************/
 
-		for( pxIterator = ( ListItem_t * ) &( pxList->xListEnd ); pxIterator->pxNext->xItemValue <= xValueOfInsertion; pxIterator = pxIterator->pxNext ) /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. *//*lint !e440 The iterator moves to a different value, not xValueOfInsertion. */
+		pxIterator = ( ListItem_t * ) &( pxList->xListEnd ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+
+		#if( configUSE_SKIP_LISTS == 1 )
+		{
+			/* Move along each index level, sparsest first, as far as the last
+			item that sorts before the new item, then drop to the level below.
+			The item reached on each level is the item the new item follows
+			on that level.  The end marker holds portMAX_DELAY, so stops every
+			level. */
+			for( uxLevel = ( UBaseType_t ) configSKIP_LIST_LEVELS; uxLevel > 0U; uxLevel-- )
+			{
+				while( pxIterator->pxSkipNext[ uxLevel - 1U ]->xItemValue <= xValueOfInsertion )
+				{
+					pxIterator = pxIterator->pxSkipNext[ uxLevel - 1U ];
+				}
+
+				pxPredecessors[ uxLevel - 1U ] = pxIterator;
+			}
+
+			uxLevels = prvSkipListLevels();
+		}
+		#endif /* configUSE_SKIP_LISTS */
+
+		/* Walk the remainder of the list, which is only a few items if the
+		index levels were used. */
+		for( ; pxIterator->pxNext->xItemValue <= xValueOfInsertion; pxIterator = pxIterator->pxNext ) /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. *//*lint !e440 The iterator moves to a different value, not xValueOfInsertion. */
 		{
 			/* There is nothing to do here, just iterating to the wanted
 			insertion position. */
@@ -159,6 +239,22 @@ const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
 	pxNewListItem->pxPrevious = pxIterator;
 	pxIterator->pxNext = pxNewListItem;
 
+	/* Items with the value portMAX_DELAY are always at the end of the list so
+	are not worth indexing. */
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+		for( uxLevel = 0U; uxLevel < uxLevels; uxLevel++ )
+		{
+			pxNewListItem->pxSkipNext[ uxLevel ] = pxPredecessors[ uxLevel ]->pxSkipNext[ uxLevel ];
+			pxNewListItem->pxSkipNext[ uxLevel ]->pxSkipPrevious[ uxLevel ] = pxNewListItem;
+			pxNewListItem->pxSkipPrevious[ uxLevel ] = pxPredecessors[ uxLevel ];
+			pxPredecessors[ uxLevel ]->pxSkipNext[ uxLevel ] = pxNewListItem;
+		}
+
+		pxNewListItem->uxSkipLevels = uxLevels;
+	}
+	#endif /* configUSE_SKIP_LISTS */
+
 	/* Remember which list the item is in.  This allows fast removal of the
 	item later. */
 	pxNewListItem->pxContainer = pxList;
@@ -172,10 +268,25 @@ UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove )
 /* The list item knows which list it is in.  Obtain the list from the list
 item. */
 List_t * const pxList = pxItemToRemove->pxContainer;
+#if( configUSE_SKIP_LISTS == 1 )
+	UBaseType_t uxLevel;
+#endif
 
 	pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
 	pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
 
+	#if( configUSE_SKIP_LISTS == 1 )
+	{
+		for( uxLevel = 0U; uxLevel < pxItemToRemove->uxSkipLevels; uxLevel++ )
+		{
+			pxItemToRemove->pxSkipNext[ uxLevel ]->pxSkipPrevious[ uxLevel ] = pxItemToRemove->pxSkipPrevious[ uxLevel ];
+			pxItemToRemove->pxSkipPrevious[ uxLevel ]->pxSkipNext[ uxLevel ] = pxItemToRemove->pxSkipNext[ uxLevel ];
+		}
+
+		pxItemToRemove->uxSkipLevels = 0U;
+	}
+	#endif /* configUSE_SKIP_LISTS */
+
 	/* Only used during decision coverage testing. */
 	mtCOVERAGE_TEST_DELAY();
 
@@ -196,3 +307,29 @@ List_t * const pxList = pxItemToRemove->pxContainer;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_SKIP_LISTS == 1 )
+
+	static UBaseType_t prvSkipListLevels( void )
+	{
+	uint32_t ulBits;
+	UBaseType_t uxLevels = 0U;
+
+		/* xorshift32.  The number of levels is the number of consecutive
+		pairs of zero bits, so an item is in level n with probability 4^-n. */
+		ulSkipListRandom ^= ulSkipListRandom << 13;
+		ulSkipListRandom ^= ulSkipListRandom >> 17;
+		ulSkipListRandom ^= ulSkipListRandom << 5;
+		ulBits = ulSkipListRandom;
+
+		while( ( uxLevels < ( UBaseType_t ) configSKIP_LIST_LEVELS ) && ( ( ulBits & listSKIP_LIST_LEVEL_MASK ) == 0UL ) )
+		{
+			uxLevels++;
+			ulBits >>= listSKIP_LIST_LEVEL_BITS;
+		}
+
+		return uxLevels;
+	}
+
+#endif /* configUSE_SKIP_LISTS */
+/*-----------------------------------------------------------*/
+
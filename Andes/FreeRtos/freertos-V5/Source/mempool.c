@@ -0,0 +1,593 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "atomic.h"
+#include "mempool.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to include memory pool functionality.  This #if is closed at the very bottom of
+this file.  If you want to include memory pools then ensure
+configUSE_MEMORY_POOLS is set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_MEMORY_POOLS == 1 )
+
+/* The head of the free list is held in a single 32-bit word so it can be
+updated with one compare and swap.  The low 16 bits hold the index of the first
+free block plus one, so 0 means the list is empty.  The first word of each free
+block holds the head value of the rest of the list in the same format.  The high
+16 bits hold a tag that is incremented each time the head changes, so a task or
+interrupt that read the head, was preempted, and then attempts to swap in a next
+block that is no longer valid finds the tag has changed and tries again. */
+#define mempoolINDEX_MASK		( ( uint32_t ) 0x0000ffffUL )
+#define mempoolTAG_INCREMENT	( ( uint32_t ) 0x00010000UL )
+
+typedef struct MemPoolDef_t
+{
+	volatile uint32_t ulFreeHead;			/*< The tag and index of the first free block, as described above. */
+	volatile uint32_t ulFreeCount;			/*< The number of blocks on the free list. */
+	volatile uint32_t ulMinimumFreeCount;	/*< The lowest value ulFreeCount has held. */
+	List_t xTasksWaitingToAllocate;			/*< List of tasks blocked waiting for a block to be freed.  Stored in priority order. */
+	uint8_t *pucStorage;					/*< The first block in the pool. */
+	size_t xBlockSize;						/*< The size of each block after rounding. */
+	UBaseType_t uxBlockCount;				/*< The number of blocks in the pool. */
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucStaticallyAllocated;		/*< Set to pdTRUE if the pool is statically allocated to ensure no attempt is made to free the memory. */
+	#endif
+} MemPool_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Set the initial state of a newly created pool, with every block on the free
+ * list.
+ */
+static void prvInitialiseNewMemPool( MemPool_t *pxMemPool, size_t xBlockSize, UBaseType_t uxBlockCount, uint8_t *pucPoolStorage ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove the first block from the free list and return it, or return NULL if
+ * the list is empty.  Safe to call from any context without a critical section.
+ */
+static void *prvPopBlock( MemPool_t * const pxMemPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return a block to the front of the free list.  Safe to call from any context
+ * without a critical section.
+ */
+static void prvPushBlock( MemPool_t * const pxMemPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	MemPoolHandle_t xMemPoolCreateStatic( size_t xBlockSize, UBaseType_t uxBlockCount, uint8_t *pucPoolStorage, StaticMemPool_t *pxStaticMemPool )
+	{
+	MemPool_t *pxMemPool;
+
+		/* The storage and a StaticMemPool_t object must be provided. */
+		configASSERT( pucPoolStorage );
+		configASSERT( pxStaticMemPool );
+
+		/* Each block starts on an aligned address only if the storage does. */
+		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucPoolStorage ) & ( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) == 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticMemPool_t equals the size of the real pool
+			structure. */
+			volatile size_t xSize = sizeof( StaticMemPool_t );
+			configASSERT( xSize == sizeof( MemPool_t ) );
+		} /*lint !e529 xSize is referenced if configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucPoolStorage != NULL ) && ( pxStaticMemPool != NULL ) )
+		{
+			/* The user has provided a statically allocated pool - use it. */
+			pxMemPool = ( MemPool_t * ) pxStaticMemPool; /*lint !e740 !e9087 MemPool_t and StaticMemPool_t are deliberately aliased for data hiding purposes and guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+			prvInitialiseNewMemPool( pxMemPool, xBlockSize, uxBlockCount, pucPoolStorage );
+
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note that
+				this pool was created statically in case the pool is later
+				deleted. */
+				pxMemPool->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			traceMEMPOOL_CREATE( pxMemPool );
+		}
+		else
+		{
+			pxMemPool = NULL;
+			traceMEMPOOL_CREATE_FAILED();
+		}
+
+		return pxMemPool;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	MemPoolHandle_t xMemPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount )
+	{
+	MemPool_t *pxMemPool = NULL;
+	size_t xHeaderSize, xRoundedBlockSize;
+
+		configASSERT( ( uxBlockCount > ( UBaseType_t ) 0U ) && ( uxBlockCount <= mempoolMAX_BLOCK_COUNT ) );
+
+		/* The control structure and the blocks are allocated together, with the
+		blocks following the control structure.  Rounding the size of the
+		structure up to the alignment of the allocation keeps the blocks
+		aligned too. */
+		xHeaderSize = portKERNEL_OBJECT_SIZE( sizeof( MemPool_t ) );
+		xRoundedBlockSize = mempoolBLOCK_SIZE( xBlockSize );
+
+		/* Check the total size does not overflow. */
+		if( ( uxBlockCount > ( UBaseType_t ) 0U ) && ( ( size_t ) uxBlockCount <= ( ( ( size_t ) ~( ( size_t ) 0 ) - xHeaderSize ) / xRoundedBlockSize ) ) )
+		{
+			pxMemPool = ( MemPool_t * ) pvPortMallocKernelObject( xHeaderSize + ( xRoundedBlockSize * ( size_t ) uxBlockCount ) ); /*lint !e9087 !e9079 pvPortMalloc() returns memory aligned for any kernel structure. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxMemPool != NULL )
+		{
+			prvInitialiseNewMemPool( pxMemPool, xBlockSize, uxBlockCount, ( ( uint8_t * ) pxMemPool ) + xHeaderSize );
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note this
+				pool was allocated dynamically in case the pool is later
+				deleted. */
+				pxMemPool->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			traceMEMPOOL_CREATE( pxMemPool );
+		}
+		else
+		{
+			traceMEMPOOL_CREATE_FAILED(); /*lint !e9063 Else branch only exists to allow tracing and does not generate code if trace macros are not defined. */
+		}
+
+		return pxMemPool;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewMemPool( MemPool_t *pxMemPool, size_t xBlockSize, UBaseType_t uxBlockCount, uint8_t *pucPoolStorage )
+{
+UBaseType_t uxBlock;
+
+	configASSERT( ( uxBlockCount > ( UBaseType_t ) 0U ) && ( uxBlockCount <= mempoolMAX_BLOCK_COUNT ) );
+
+	pxMemPool->pucStorage = pucPoolStorage;
+	pxMemPool->xBlockSize = mempoolBLOCK_SIZE( xBlockSize );
+	pxMemPool->uxBlockCount = uxBlockCount;
+	vListInitialise( &( pxMemPool->xTasksWaitingToAllocate ) );
+
+	/* Thread the free list through the blocks in address order, so the first
+	blocks allocated are those at the start of the storage.  Block n holds the
+	index of block n + 1 plus one, and the last block holds 0. */
+	for( uxBlock = 0; uxBlock < uxBlockCount; uxBlock++ )
+	{
+		*( ( uint32_t * ) &( pucPoolStorage[ uxBlock * pxMemPool->xBlockSize ] ) ) = ( uxBlock + ( UBaseType_t ) 1U < uxBlockCount ) ? ( uint32_t ) ( uxBlock + ( UBaseType_t ) 2U ) : ( uint32_t ) 0U; /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT so can hold a uint32_t. */
+	}
+
+	pxMemPool->ulFreeHead = ( uint32_t ) 1U;
+	pxMemPool->ulFreeCount = ( uint32_t ) uxBlockCount;
+	pxMemPool->ulMinimumFreeCount = ( uint32_t ) uxBlockCount;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvPopBlock( MemPool_t * const pxMemPool )
+{
+uint32_t ulHead, ulNext, ulFreeCount, ulMinimum;
+uint8_t *pucBlock;
+
+	for( ;; )
+	{
+		ulHead = pxMemPool->ulFreeHead;
+
+		if( ( ulHead & mempoolINDEX_MASK ) == ( uint32_t ) 0U )
+		{
+			/* The pool is empty. */
+			pucBlock = NULL;
+			break;
+		}
+
+		/* The block is part of the pool's storage whether or not it is still
+		free, so reading its link is safe even if another task or interrupt
+		allocates the block first - in which case the link read may be junk,
+		but the tag will have changed and the compare and swap will fail. */
+		pucBlock = &( pxMemPool->pucStorage[ ( size_t ) ( ( ulHead & mempoolINDEX_MASK ) - ( uint32_t ) 1U ) * pxMemPool->xBlockSize ] );
+		ulNext = *( ( volatile uint32_t * ) pucBlock ) & mempoolINDEX_MASK; /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT so can hold a uint32_t. */
+
+		if( Atomic_CompareAndSwap_u32( &( pxMemPool->ulFreeHead ), ( ( ulHead + mempoolTAG_INCREMENT ) & ~mempoolINDEX_MASK ) | ulNext, ulHead ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+		{
+			/* Atomic_Decrement_u32() returns the count before it was
+			decremented. */
+			ulFreeCount = Atomic_Decrement_u32( &( pxMemPool->ulFreeCount ) ) - ( uint32_t ) 1U;
+
+			/* Lower the low water mark if this is the fewest blocks that have
+			been free. */
+			ulMinimum = pxMemPool->ulMinimumFreeCount;
+			while( ( ulFreeCount < ulMinimum ) && ( Atomic_CompareAndSwap_u32( &( pxMemPool->ulMinimumFreeCount ), ulFreeCount, ulMinimum ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+			{
+				ulMinimum = pxMemPool->ulMinimumFreeCount;
+			}
+
+			break;
+		}
+		else
+		{
+			/* Another task or interrupt changed the list between the head
+			being read and the swap - try again. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPushBlock( MemPool_t * const pxMemPool, void *pvBlock )
+{
+uint32_t ulHead, ulIndex, ulPreviousFreeCount;
+size_t xOffset;
+
+	configASSERT( pvBlock );
+
+	/* The block must have come from this pool. */
+	configASSERT( ( uint8_t * ) pvBlock >= pxMemPool->pucStorage );
+	xOffset = ( size_t ) ( ( uint8_t * ) pvBlock - pxMemPool->pucStorage );
+	configASSERT( ( xOffset % pxMemPool->xBlockSize ) == ( size_t ) 0 );
+	configASSERT( xOffset < ( pxMemPool->xBlockSize * ( size_t ) pxMemPool->uxBlockCount ) );
+
+	/* The count is incremented before the block is pushed, and decremented
+	after a block is popped, so it can overstate the number of free blocks for
+	a moment but never understates it.  More frees than allocations indicates a
+	block was freed twice. */
+	ulPreviousFreeCount = Atomic_Increment_u32( &( pxMemPool->ulFreeCount ) );
+	configASSERT( ulPreviousFreeCount < ( uint32_t ) pxMemPool->uxBlockCount );
+	( void ) ulPreviousFreeCount;
+
+	ulIndex = ( uint32_t ) ( xOffset / pxMemPool->xBlockSize ) + ( uint32_t ) 1U;
+
+	do
+	{
+		ulHead = pxMemPool->ulFreeHead;
+
+		/* Link the block to the current head before publishing it. */
+		*( ( volatile uint32_t * ) pvBlock ) = ulHead & mempoolINDEX_MASK; /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT so can hold a uint32_t. */
+
+	} while( Atomic_CompareAndSwap_u32( &( pxMemPool->ulFreeHead ), ( ( ulHead + mempoolTAG_INCREMENT ) & ~mempoolINDEX_MASK ) | ulIndex, ulHead ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait )
+{
+MemPool_t * const pxMemPool = xMemPool;
+BaseType_t xEntryTimeSet = pdFALSE, xBlocked;
+TimeOut_t xTimeOut;
+void *pvBlock;
+
+	configASSERT( pxMemPool );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/*lint -save -e904 This function relaxes the coding standard somewhat to
+	allow return statements within the function itself.  This is done in the
+	interest of execution time efficiency. */
+	for( ;; )
+	{
+		/* The free list is lock free, so a block can be taken without
+		suspending the scheduler or entering a critical section. */
+		pvBlock = prvPopBlock( pxMemPool );
+
+		if( pvBlock != NULL )
+		{
+			traceMEMPOOL_ALLOC( pxMemPool, pvBlock );
+			return pvBlock;
+		}
+		else if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* The pool is empty and no block time was specified (or the block
+			time has expired). */
+			traceMEMPOOL_ALLOC_FAILED( pxMemPool );
+			return NULL;
+		}
+		else if( xEntryTimeSet == pdFALSE )
+		{
+			/* The pool was empty and a block time was specified so configure
+			the timeout structure. */
+			vTaskInternalSetTimeOutState( &xTimeOut );
+			xEntryTimeSet = pdTRUE;
+		}
+		else
+		{
+			/* Entry time was already set. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		vTaskSuspendAll();
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			xBlocked = pdFALSE;
+
+			/* Blocks can be freed from interrupts, which are not held off by
+			suspending the scheduler.  Check the pool is still empty with
+			interrupts masked, so a block freed after the check finds this task
+			on the event list and unblocks it. */
+			taskENTER_CRITICAL();
+			{
+				if( ( pxMemPool->ulFreeHead & mempoolINDEX_MASK ) == ( uint32_t ) 0U )
+				{
+					traceBLOCKING_ON_MEMPOOL_ALLOC( pxMemPool );
+					vTaskPlaceOnEventList( &( pxMemPool->xTasksWaitingToAllocate ), xTicksToWait );
+					xBlocked = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Resuming the scheduler will move this task to the delayed list
+			or, if a block was freed by an interrupt in the meantime, back to
+			the ready list. */
+			if( ( xTaskResumeAll() == pdFALSE ) && ( xBlocked != pdFALSE ) )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* Timed out.  Try once more before giving up. */
+			( void ) xTaskResumeAll();
+			xTicksToWait = ( TickType_t ) 0;
+		}
+	} /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool )
+{
+MemPool_t * const pxMemPool = xMemPool;
+void *pvBlock;
+
+	configASSERT( pxMemPool );
+
+	pvBlock = prvPopBlock( pxMemPool );
+	traceMEMPOOL_ALLOC_FROM_ISR( pxMemPool, pvBlock );
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock )
+{
+MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	traceMEMPOOL_FREE( pxMemPool, pvBlock );
+	prvPushBlock( pxMemPool, pvBlock );
+
+	/* Only take the critical section if it looks like a task is waiting for the
+	block.  A task that is about to wait checks the pool is empty inside a
+	critical section before placing itself on the event list, so cannot miss
+	the block pushed above. */
+	if( listLIST_IS_EMPTY( &( pxMemPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+	{
+		taskENTER_CRITICAL();
+		{
+			if( listLIST_IS_EMPTY( &( pxMemPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( &( pxMemPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+				{
+					/* The unblocked task has a priority higher than our own
+					so yield immediately. */
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+MemPool_t * const pxMemPool = xMemPool;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxMemPool );
+
+	/* RTOS ports that support interrupt nesting have the concept of a maximum
+	system call (or maximum API call) interrupt priority.  Only API functions
+	that end in FromISR can be called from interrupts at or below it.  See
+	http://www.freertos.org/RTOS-Cortex-M3-M4.html. */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	traceMEMPOOL_FREE_FROM_ISR( pxMemPool, pvBlock );
+	prvPushBlock( pxMemPool, pvBlock );
+
+	if( listLIST_IS_EMPTY( &( pxMemPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( listLIST_IS_EMPTY( &( pxMemPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( &( pxMemPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+				{
+					/* The task waiting has a higher priority so record that a
+					context switch is required. */
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xMemPool )
+{
+MemPool_t const * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+	return ( UBaseType_t ) pxMemPool->ulFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemPoolGetMinimumEverFreeCount( MemPoolHandle_t xMemPool )
+{
+MemPool_t const * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+	return ( UBaseType_t ) pxMemPool->ulMinimumFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xMemPool )
+{
+MemPool_t const * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+	return pxMemPool->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolDelete( MemPoolHandle_t xMemPool )
+{
+MemPool_t *pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	vTaskSuspendAll();
+	{
+		traceMEMPOOL_DELETE( pxMemPool );
+
+		/* No tasks can be waiting for a block. */
+		configASSERT( listLIST_IS_EMPTY( &( pxMemPool->xTasksWaitingToAllocate ) ) != pdFALSE );
+
+		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+		{
+			/* The pool can only have been allocated dynamically - free it
+			again. */
+			vPortFree( pxMemPool );
+		}
+		#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+		{
+			/* The pool could have been allocated statically or dynamically, so
+			check before attempting to free the memory. */
+			if( pxMemPool->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+			{
+				vPortFree( pxMemPool );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+	}
+	( void ) xTaskResumeAll();
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include memory pool functionality.  If you want to include memory pools then
+ensure configUSE_MEMORY_POOLS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_MEMORY_POOLS == 1 */
@@ -81,9 +81,12 @@
 #define portasmHAS_CLIC  0
 #endif
 
-/* Constants to define the additional registers. */
+/* Constants to define the additional registers.  Only the assembly code uses
+the register names, so keep them out of C files. */
+#ifdef __ASSEMBLER__
 #define mxstatus 	0x7c4
 #define ucode   	0x801
+#endif
 
 /* Additional FPU registers to save and restore (fcsr + 32 FPUs) */
 #define portasmFPU_CONTEXT_SIZE        ( 1 + ( 32 * portFPWORD_SIZE ) / portWORD_SIZE )
@@ -91,16 +94,34 @@
 /* One additional registers to save and restore, as per the #defines above. */
 #define portasmADDITIONAL_CONTEXT_SIZE ( 2 + portasmFPU_CONTEXT_SIZE )  /* Must be even number on 32-bit cores. */
 
-/* When the kernel update, TCB structure may be changed. So the offset need to be modified */
+/* When the kernel update, TCB structure may be changed. So the offset need to be modified.
+ * portmacro.h includes this header from C as well, so that tasks.c fails to build if the
+ * offsets do not match the TCB, see portCHECK_TCB_OFFSETS(). */
 #if (configHSP_ENABLE==1)
+	/* Set the words of each of the two list items in TCB, see ListItem_t in list.h. */
+	#if( configUSE_SKIP_LISTS == 1 )
+		#ifdef configSKIP_LIST_LEVELS
+			#define ListItemWords_TCB	(6 + 2 * configSKIP_LIST_LEVELS)
+		#else
+			#define ListItemWords_TCB	(6 + 2 * 4) /* The default configSKIP_LIST_LEVELS in FreeRTOS.h */
+		#endif
+	#else
+		#define ListItemWords_TCB		5
+	#endif
+
 	/* Set the bytes of stack's offset in TCB. Unit:byte */
-	#define StackOffset_TCB			(12 * portWORD_SIZE) /* The offset of pxCurrentTCB->pxStack in TCB structure */
+	#define StackOffset_TCB			((2 + 2 * ListItemWords_TCB) * portWORD_SIZE) /* The offset of pxCurrentTCB->pxStack in TCB structure */
 
 	/* Set the offset of top address of stack in TCB. Unit:byte */
-	#define EndStackOffset_TCB		(13 * portWORD_SIZE + configMAX_TASK_NAME_LEN) /* The offset of pxCurrentTCB->pxEndOfStack in TCB structure */
+	#define EndStackOffset_TCB		(StackOffset_TCB + portWORD_SIZE + configMAX_TASK_NAME_LEN) /* The offset of pxCurrentTCB->pxEndOfStack in TCB structure */
+
+	/* Set the offset of the lowest recorded stack pointer in TCB. Unit:byte */
+	#define StackPeakOffset_TCB		(EndStackOffset_TCB + portWORD_SIZE) /* The offset of pxCurrentTCB->pxStackPeak in TCB structure */
 #endif
 
 
+#ifdef __ASSEMBLER__
+
 /* Save additional registers found on the V5 core. */
 .macro portasmSAVE_ADDITIONAL_REGISTERS
 	addi sp, sp, -(portasmADDITIONAL_CONTEXT_SIZE * portWORD_SIZE) /* Make room for the additional registers. */
@@ -155,6 +176,16 @@
 	 */
 	#if( configHSP_ENABLE == 1 )
 		csrci mhsp_ctl, 3
+
+		/*
+		 * In top-of-stack recording mode msp_bound holds the lowest SP of the
+		 * interrupted task, including the context saved above. Keep it in the TCB.
+		 */
+		#if( configRECORD_STACK_PEAK == 1 )
+			load_x t0, pxCurrentTCB
+			csrr t1, msp_bound
+			store_x t1, StackPeakOffset_TCB(t0)
+		#endif
 	#endif
 	.endm
 
@@ -169,10 +200,23 @@
 		/* Load current hardware stack protection and recording CSR */
 		load_x t0, pxCurrentTCB
 
-		load_x t1, StackOffset_TCB(t0)
+		/*
+		 * In top-of-stack recording mode (SCHM) msp_bound follows the lowest SP
+		 * instead of trapping an overflow, so continue from the task's record.
+		 * The overflow is then found by taskCHECK_FOR_STACK_OVERFLOW().
+		 */
+		#if( configRECORD_STACK_PEAK == 1 )
+			load_x t1, StackPeakOffset_TCB(t0)
+		#else
+			load_x t1, StackOffset_TCB(t0)
+		#endif
 		csrw msp_bound, t1
 
-		#if( configRECORD_STACK_HIGH_ADDRESS == 1 )
+		#if( configRECORD_STACK_PEAK == 1 )
+			load_x t1, EndStackOffset_TCB(t0)
+			csrw msp_base, t1
+			li t0, 0x27
+		#elif( configRECORD_STACK_HIGH_ADDRESS == 1 )
 			load_x t1, EndStackOffset_TCB(t0)
 			csrw msp_base, t1
 			li t0, 0x23
@@ -249,5 +293,7 @@
 	csrw mhsp_ctl, t0
 	.endm
 
+#endif /* __ASSEMBLER__ */
+
 
 #endif /* __FREERTOS_RISC_V_EXTENSIONS_H__ */
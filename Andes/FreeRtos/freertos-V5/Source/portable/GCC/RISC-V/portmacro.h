@@ -133,6 +133,10 @@ extern void vTaskExitCritical( void );
 
 #endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
 
+/* Index of the lowest set bit in a non-zero 32-bit value.  Used to scan the
+ready bit maps of queue sets. */
+#define portCOUNT_TRAILING_ZEROS( ulBits ) ( ( UBaseType_t ) __builtin_ctz( ulBits ) )
+
 
 /*-----------------------------------------------------------*/
 
@@ -161,6 +165,69 @@ not necessary for to use this port.  They are defined so the common demo files
 #endif
 
 #define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
+
+/* The low 32 bits of the mcycle counter, used to time kernel operations.  The
+difference between two readings is correct provided the operation takes fewer
+than 2^32 cycles. */
+#define portGET_CYCLE_COUNT()											\
+	( {																	\
+		unsigned long ulCycleCount;										\
+		__asm volatile( "csrr %0, mcycle" : "=r"( ulCycleCount ) );		\
+		( uint32_t ) ulCycleCount;										\
+	} )
+
+#define portGET_CALLER_ADDRESS() __builtin_return_address( 0 )
+
+/* Cores that implement the A (atomic) extension provide AMO and LR/SC
+instructions, so atomic.h does not need to disable interrupts.  portASM.S
+invalidates any outstanding LR reservation on each return from a trap, which
+makes LR/SC sequences safe against interrupts and context switches. */
+#ifdef __riscv_atomic
+	#define portHAS_ATOMIC_INSTRUCTIONS 1
+#endif
+
+/* With the Andes hardware stack protection in top-of-stack recording mode
+msp_bound holds the lowest stack pointer the running task has reached.  The
+trap handler saves it to the TCB of the task it interrupts and restores it when
+the task runs again, see freertos_risc_v_chip_specific_extensions.h. */
+#if( configHSP_ENABLE == 1 ) && ( configRECORD_STACK_PEAK == 1 )
+	#define portHAS_STACK_PEAK_RECORDING 1
+
+	#define portGET_STACK_PEAK()											\
+		( {																	\
+			unsigned long ulStackPeak;										\
+			__asm volatile( "csrr %0, msp_bound" : "=r"( ulStackPeak ) );	\
+			( StackType_t * ) ulStackPeak;									\
+		} )
+#endif
+
+/* The trap handler programs the hardware stack protection from TCB members it
+loads at the fixed offsets in freertos_risc_v_chip_specific_extensions.h.
+tasks.c uses portCHECK_TCB_OFFSETS() to fail the build if a change to the TCB,
+or to ListItem_t, moves those members. */
+#if( configHSP_ENABLE == 1 )
+	#include <stddef.h>
+
+	#define portWORD_SIZE	sizeof( void * )
+	#include "freertos_risc_v_chip_specific_extensions.h"
+
+	#define portCHECK_TCB_OFFSET( xMember, xOffset ) \
+		typedef char portTCB_OFFSET_OF_##xMember[ ( offsetof( TCB_t, xMember ) == ( size_t ) ( xOffset ) ) ? 1 : -1 ]
+
+	#if( configRECORD_STACK_PEAK == 1 )
+		#define portCHECK_TCB_OFFSETS()								\
+			portCHECK_TCB_OFFSET( pxStack, StackOffset_TCB );		\
+			portCHECK_TCB_OFFSET( pxEndOfStack, EndStackOffset_TCB );	\
+			portCHECK_TCB_OFFSET( pxStackPeak, StackPeakOffset_TCB )
+	#elif( configRECORD_STACK_HIGH_ADDRESS == 1 )
+		#define portCHECK_TCB_OFFSETS()								\
+			portCHECK_TCB_OFFSET( pxStack, StackOffset_TCB );		\
+			portCHECK_TCB_OFFSET( pxEndOfStack, EndStackOffset_TCB )
+	#else
+		#define portCHECK_TCB_OFFSETS()								\
+			portCHECK_TCB_OFFSET( pxStack, StackOffset_TCB )
+	#endif
+#endif
 /*-----------------------------------------------------------*/
 
 
@@ -30,6 +30,35 @@
  * (coalescences) adjacent memory blocks as they are freed, and in so doing
  * limits memory fragmentation.
  *
+ * Each free block records its size in its last word (a boundary tag), and the
+ * block that follows a free block is marked as doing so.  A block being freed
+ * can therefore find and combine with free blocks either side of it in
+ * constant time, however fragmented the heap is.  Free blocks are held in
+ * doubly linked lists by size, one list per power of two, so a freed block is
+ * also added to a list in constant time.  pvPortMalloc() searches the first
+ * list that can hold a large enough block, and takes the smallest block that
+ * fits from the first heapBEST_FIT_SEARCH_LIMIT blocks of the list.  This
+ * bounded best fit search keeps large free blocks whole, so limits the
+ * fragmentation of the heap.
+ *
+ * pvPortMallocAligned() allocates memory aligned to more than
+ * portBYTE_ALIGNMENT.  It takes a free block large enough to hold the request
+ * at the next aligned address, and leaves the part of the block in front of
+ * that address in the free list as a smaller free block, so no memory is lost
+ * to the alignment.
+ *
+ * If configUSE_TASK_HEAP_CACHE is 1 then each task holds up to
+ * configHEAP_CACHE_DEPTH blocks of each of configHEAP_CACHE_SIZE_CLASSES small
+ * block sizes that it has freed, and reuses them for its own small allocations
+ * without suspending the scheduler.  Other allocations, and frees when the
+ * cache is full, use the heap as normal.  Cached blocks are not counted as free
+ * by xPortGetFreeHeapSize() or vPortGetHeapStats(), and are returned to the
+ * heap when the task is deleted.
+ *
+ * If configUSE_HEAP_TRACKING is 1 then the header of each allocated block also
+ * records who allocated it, and allocations are counted in histograms - see
+ * heap_tracking.h.  heap_tracking.c must then also be included in the build.
+ *
  * See heap_1.c, heap_2.c and heap_3.c for alternative implementations, and the
  * memory management pages of http://www.FreeRTOS.org for more information.
  */
@@ -42,6 +71,7 @@ task.h is included from an application file. */
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "heap_tracking.h"
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
@@ -55,6 +85,63 @@ task.h is included from an application file. */
 /* Assumes 8bit bytes! */
 #define heapBITS_PER_BYTE		( ( size_t ) 8 )
 
+/* The number of lists free blocks are held in, which must be no greater than
+32.  The first list holds the smallest blocks, and each following list holds
+blocks up to double the size of those in the list before.  The last list also
+holds every larger block. */
+#ifndef heapFREE_LIST_COUNT
+	#define heapFREE_LIST_COUNT			( 24U )
+#endif
+
+#if( heapFREE_LIST_COUNT > 32U )
+	#error The free list bit map is 32 bits wide.
+#endif
+
+/* The number of blocks pvPortMalloc() examines in a free list, taking the
+smallest of them that is large enough.  Larger values find closer fits, so
+fragment the heap less, but take longer.  If none of the blocks examined is
+large enough then every block is examined, so an allocation only fails if no
+free block can satisfy it. */
+#ifndef heapBEST_FIT_SEARCH_LIMIT
+	#define heapBEST_FIT_SEARCH_LIMIT	( 8U )
+#endif
+
+#define heapNO_SEARCH_LIMIT			( ( UBaseType_t ) ~( ( UBaseType_t ) 0U ) )
+
+/* Set in the xBlockSize member of a block when the block in front of it is
+free.  Block sizes are always a multiple of portBYTE_ALIGNMENT, so the bit is
+not otherwise used.  The bit is never set in a free block, as two adjacent free
+blocks are always combined. */
+#define heapPREVIOUS_BLOCK_FREE_BIT	( ( size_t ) 1 )
+
+/* The size of a block without the allocated and previous block free bits. */
+#define heapBLOCK_SIZE( pxBlock )	( ( pxBlock )->xBlockSize & ~( xBlockAllocatedBit | heapPREVIOUS_BLOCK_FREE_BIT ) )
+
+/* The block that follows pxBlock in memory. */
+#define heapNEXT_BLOCK( pxBlock )	( ( BlockLink_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+/* A free block holds a pointer to the previous block in its list of free
+blocks, or NULL if it is the first block in the list, in the first word after
+its BlockLink_t structure, and its size in its last word - the boundary tag.
+The boundary tag is read by the block that follows to find the free block in
+front of it. */
+#define heapPREVIOUS_FREE_BLOCK( pxBlock )	( *( ( BlockLink_t ** ) ( ( ( uint8_t * ) ( pxBlock ) ) + xHeapStructSize ) ) )
+#define heapBOUNDARY_TAG( pxBlock )			( *( ( size_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + ( ( pxBlock )->xBlockSize - sizeof( size_t ) ) ) ) )
+#define heapPREVIOUS_BLOCK( pxBlock )		( ( BlockLink_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) - *( ( ( size_t * ) ( pxBlock ) ) - 1 ) ) )
+
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+	/* Blocks held in a task's heap cache are sorted into size classes that are
+	heapMINIMUM_BLOCK_SIZE bytes wide, so every block in class n is at least
+	( n + 1 ) * heapMINIMUM_BLOCK_SIZE bytes.  Cached blocks remain marked as
+	allocated and are linked through pxNextFreeBlock.  The block at the head of
+	each class stores the number of blocks in the class at the start of the
+	memory that was returned to the application. */
+	#define heapCACHE_MAX_REQUEST			( ( size_t ) configHEAP_CACHE_SIZE_CLASSES * heapMINIMUM_BLOCK_SIZE )
+	#define heapCACHE_CLASS_HOLDING( xSize )	( ( ( xSize ) / heapMINIMUM_BLOCK_SIZE ) - ( size_t ) 1 )
+	#define heapCACHE_CLASS_FOR( xSize )	( ( ( ( ( xSize ) + heapMINIMUM_BLOCK_SIZE ) - ( size_t ) 1 ) / heapMINIMUM_BLOCK_SIZE ) - ( size_t ) 1 )
+	#define heapCACHE_COUNT( pxBlock )		( *( ( size_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + xHeapStructSize ) ) )
+#endif
+
 /* Allocate the memory for the heap. */
 #if( configAPPLICATION_ALLOCATED_HEAP == 1 )
 	/* The application writer has already defined the array used for the RTOS
@@ -64,24 +151,102 @@ task.h is included from an application file. */
 	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
 #endif /* configAPPLICATION_ALLOCATED_HEAP */
 
-/* Define the linked list structure.  This is used to link free blocks in order
-of their memory address. */
+/* Define the linked list structure.  This is used to link free blocks of
+similar sizes. */
 typedef struct A_BLOCK_LINK
 {
 	struct A_BLOCK_LINK *pxNextFreeBlock;	/*<< The next free block in the list. */
 	size_t xBlockSize;						/*<< The size of the free block. */
+
+	#if( configUSE_HEAP_TRACKING == 1 )
+		void *pvCaller;						/*<< The return address of the pvPortMalloc() call that allocated the block. */
+		TaskHandle_t xOwner;				/*<< The task that allocated the block, NULL if the scheduler had not started. */
+		uint32_t ulSequence;				/*<< The allocation sequence number, or 0 while the block is held in a task heap cache. */
+	#endif
 } BlockLink_t;
 
 /*-----------------------------------------------------------*/
 
 /*
- * Inserts a block of memory that is being freed into the correct position in
- * the list of free memory blocks.  The block being freed will be merged with
- * the block in front it and/or the block behind it if the memory blocks are
- * adjacent to each other.
+ * Inserts a block of memory that is being freed into the list of free blocks
+ * of its size.  The block being freed will be merged with the block in front
+ * it and/or the block behind it if they are also free, which is found from the
+ * boundary tags without searching any list.
  */
 static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
 
+/*
+ * Add a free block to, or remove a free block from, the list of free blocks of
+ * its size, without merging it with the blocks either side of it.
+ */
+static void prvAddBlockToFreeList( BlockLink_t *pxBlockToAdd );
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove );
+
+/*
+ * Returns the free block that best fits a request for xWantedSize bytes at an
+ * address aligned to xAlignment, or NULL if no block large enough is found.
+ * The block is left in its free list.  At most uxSearchLimit blocks of each
+ * list are examined.
+ */
+static BlockLink_t *prvFindSuitableBlock( size_t xWantedSize, size_t xAlignment, UBaseType_t uxSearchLimit );
+
+/*
+ * Returns the index of the list that holds free blocks of xBlockSize bytes.
+ */
+static UBaseType_t prvGetFreeListIndex( size_t xBlockSize );
+
+/*
+ * Bit scans.  prvFindLastSet() returns the index of the most significant set
+ * bit, prvFindFirstSet() the index of the least significant set bit.  Neither
+ * can be passed zero.
+ */
+static UBaseType_t prvFindLastSet( size_t xValue );
+static UBaseType_t prvFindFirstSet( uint32_t ulValue );
+
+/*
+ * The implementation of pvPortMalloc() and pvPortMallocAligned().  xAlignment
+ * is a power of two that is at least portBYTE_ALIGNMENT, and pvCaller is the
+ * return address of the public function's caller.
+ */
+static void *prvAllocate( size_t xWantedSize, size_t xAlignment, void *pvCaller );
+
+/*
+ * Returns the number of bytes that must be split from the front of the free
+ * block pxBlock so the memory returned from the block that follows is aligned
+ * to xAlignment - zero if memory returned from pxBlock itself is already
+ * aligned, and otherwise enough to leave a free block of at least
+ * heapMINIMUM_BLOCK_SIZE bytes in front.
+ */
+static size_t prvGetAlignmentGap( const BlockLink_t *pxBlock, size_t xAlignment );
+
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+
+	/*
+	 * Return memory for xWantedSize bytes from a block held in the calling
+	 * task's heap cache, or NULL if the cache does not hold a suitable block.
+	 */
+	static void *prvTakeFromTaskHeapCache( size_t xWantedSize );
+
+	/*
+	 * Place an allocated block that is being freed in the calling task's heap
+	 * cache.  Returns pdFALSE if blocks of that size are not cached, or the
+	 * cache for that size is full, in which case the block must be returned to
+	 * the heap.
+	 */
+	static BaseType_t prvAddToTaskHeapCache( BlockLink_t *pxBlock );
+
+#endif /* configUSE_TASK_HEAP_CACHE */
+
+#if( configUSE_HEAP_TRACKING == 1 )
+
+	/*
+	 * Record the caller, owner and sequence number of a block that has just
+	 * been allocated, and count the allocation in the histograms.
+	 */
+	static void prvTrackAllocation( BlockLink_t *pxBlock, size_t xRequestedSize, void *pvCaller, uint32_t ulStartCycles );
+
+#endif /* configUSE_HEAP_TRACKING */
+
 /*
  * Called automatically to setup the required heap structures the first time
  * pvPortMalloc() is called.
@@ -94,8 +259,13 @@ static void prvHeapInit( void );
 block must by correctly byte aligned. */
 static const size_t xHeapStructSize	= ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
 
-/* Create a couple of list links to mark the start and end of the list. */
-static BlockLink_t xStart, *pxEnd = NULL;
+/* Marks the end of the heap. */
+static BlockLink_t *pxEnd = NULL;
+
+/* The lists of free blocks, and a bit map in which bit n is set when
+pxFreeLists[ n ] is not empty. */
+static BlockLink_t *pxFreeLists[ heapFREE_LIST_COUNT ];
+static uint32_t ulFreeListBitMap = 0UL;
 
 /* Keeps track of the number of calls to allocate and free memory as well as the
 number of free bytes remaining, but says nothing about fragmentation. */
@@ -110,12 +280,82 @@ application.  When the bit is free the block is still part of the free heap
 space. */
 static size_t xBlockAllocatedBit = 0;
 
+#if( configUSE_HEAP_TRACKING == 1 )
+	/* The first block in the heap.  Every block, allocated or free, can be
+	found by walking the heap in address order from this block. */
+	static BlockLink_t *pxFirstBlock = NULL;
+#endif
+
 /*-----------------------------------------------------------*/
 
 void *pvPortMalloc( size_t xWantedSize )
 {
-BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
+	return prvAllocate( xWantedSize, ( size_t ) portBYTE_ALIGNMENT, portGET_CALLER_ADDRESS() );
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMallocAligned( size_t xWantedSize, size_t xAlignment )
+{
+	/* The alignment must be a power of two.  Every block meets alignments
+	smaller than portBYTE_ALIGNMENT. */
+	configASSERT( ( xAlignment & ( xAlignment - ( size_t ) 1 ) ) == 0 );
+
+	if( xAlignment < ( size_t ) portBYTE_ALIGNMENT )
+	{
+		xAlignment = ( size_t ) portBYTE_ALIGNMENT;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return prvAllocate( xWantedSize, xAlignment, portGET_CALLER_ADDRESS() );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvAllocate( size_t xWantedSize, size_t xAlignment, void *pvCaller )
+{
+BlockLink_t *pxBlock, *pxNewBlockLink;
+size_t xLeadingSize;
 void *pvReturn = NULL;
+#if( configUSE_HEAP_TRACKING == 1 )
+	const uint32_t ulStartCycles = portGET_CYCLE_COUNT();
+	const size_t xRequestedSize = xWantedSize;
+#else
+	/* Only recorded when allocations are tracked. */
+	( void ) pvCaller;
+#endif
+
+	#if( configUSE_TASK_HEAP_CACHE == 1 )
+	{
+		/* Small requests are satisfied from the calling task's cache if
+		possible, which does not require the scheduler to be suspended.  Cached
+		blocks are only known to have the default alignment. */
+		if( xAlignment == ( size_t ) portBYTE_ALIGNMENT )
+		{
+			pvReturn = prvTakeFromTaskHeapCache( xWantedSize );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pvReturn != NULL )
+		{
+			#if( configUSE_HEAP_TRACKING == 1 )
+			{
+				prvTrackAllocation( ( BlockLink_t * ) ( ( ( uint8_t * ) pvReturn ) - xHeapStructSize ), xRequestedSize, pvCaller, ulStartCycles );
+			}
+			#endif
+
+			return pvReturn;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_TASK_HEAP_CACHE */
 
 	vTaskSuspendAll();
 	{
@@ -160,29 +400,66 @@ void *pvReturn = NULL;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
+			/* Every block must be large enough to hold the link and boundary
+			tag it needs once it is freed. */
+			if( ( xWantedSize > 0 ) && ( xWantedSize < heapMINIMUM_BLOCK_SIZE ) )
+			{
+				xWantedSize = heapMINIMUM_BLOCK_SIZE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
 			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
 			{
-				/* Traverse the list from the start	(lowest address) block until
-				one	of adequate size is found. */
-				pxPreviousBlock = &xStart;
-				pxBlock = xStart.pxNextFreeBlock;
-				while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+				/* Find the block that best fits the request, including any
+				gap needed to reach an aligned address, from the first few
+				blocks of the lists that can hold one.  Only if none of those
+				fits are all the blocks in the lists examined. */
+				pxBlock = prvFindSuitableBlock( xWantedSize, xAlignment, ( UBaseType_t ) heapBEST_FIT_SEARCH_LIMIT );
+
+				if( pxBlock == NULL )
 				{
-					pxPreviousBlock = pxBlock;
-					pxBlock = pxBlock->pxNextFreeBlock;
+					pxBlock = prvFindSuitableBlock( xWantedSize, xAlignment, heapNO_SEARCH_LIMIT );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
 				}
 
-				/* If the end marker was reached then a block of adequate size
-				was	not found. */
-				if( pxBlock != pxEnd )
+				if( pxBlock != NULL )
 				{
+					/* This block is being returned for use so must be taken
+					out of its list of free blocks.  Any memory split from it
+					below is added to the list for its own size. */
+					prvRemoveBlockFromFreeList( pxBlock );
+
+					xLeadingSize = prvGetAlignmentGap( pxBlock, xAlignment );
+
+					if( xLeadingSize != ( size_t ) 0 )
+					{
+						/* The memory in front of the aligned address is
+						returned to the free lists as a block of its own, and
+						the memory is taken from the block that follows it.
+						The block in front of the free block cannot also be
+						free, as two adjacent free blocks are always
+						combined. */
+						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xLeadingSize );
+						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xLeadingSize;
+						pxBlock->xBlockSize = xLeadingSize;
+						heapBOUNDARY_TAG( pxBlock ) = xLeadingSize;
+						prvAddBlockToFreeList( pxBlock );
+						pxBlock = pxNewBlockLink;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
 					/* Return the memory space pointed to - jumping over the
 					BlockLink_t structure at its start. */
-					pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
-
-					/* This block is being returned for use so must be taken out
-					of the list of free blocks. */
-					pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
 
 					/* If the block is larger than required it can be split into
 					two. */
@@ -200,12 +477,17 @@ void *pvReturn = NULL;
 						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
 						pxBlock->xBlockSize = xWantedSize;
 
-						/* Insert the new block into the list of free blocks. */
-						prvInsertBlockIntoFreeList( pxNewBlockLink );
+						/* The new block is added to the list of free blocks
+						of its size.  The block that follows it is already
+						marked as following a free block. */
+						heapBOUNDARY_TAG( pxNewBlockLink ) = pxNewBlockLink->xBlockSize;
+						prvAddBlockToFreeList( pxNewBlockLink );
 					}
 					else
 					{
-						mtCOVERAGE_TEST_MARKER();
+						/* The block that follows no longer has a free block in
+						front of it. */
+						heapNEXT_BLOCK( pxBlock )->xBlockSize &= ~heapPREVIOUS_BLOCK_FREE_BIT;
 					}
 
 					xFreeBytesRemaining -= pxBlock->xBlockSize;
@@ -220,10 +502,26 @@ void *pvReturn = NULL;
 					}
 
 					/* The block is being returned - it is allocated and owned
-					by the application and has no "next" block. */
+					by the application and has no "next" block.  A block split
+					from the back of a free block follows that free block. */
 					pxBlock->xBlockSize |= xBlockAllocatedBit;
+
+					if( xLeadingSize != ( size_t ) 0 )
+					{
+						pxBlock->xBlockSize |= heapPREVIOUS_BLOCK_FREE_BIT;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 					pxBlock->pxNextFreeBlock = NULL;
 					xNumberOfSuccessfulAllocations++;
+
+					#if( configUSE_HEAP_TRACKING == 1 )
+					{
+						prvTrackAllocation( pxBlock, xRequestedSize, pvCaller, ulStartCycles );
+					}
+					#endif
 				}
 				else
 				{
@@ -244,6 +542,19 @@ void *pvReturn = NULL;
 	}
 	( void ) xTaskResumeAll();
 
+	#if( configUSE_HEAP_TRACKING == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			vHeapTrackingRecordFailure( xRequestedSize );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
 	{
 		if( pvReturn == NULL )
@@ -258,7 +569,7 @@ void *pvReturn = NULL;
 	}
 	#endif
 
-	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( xAlignment - ( size_t ) 1 ) ) == 0 );
 	return pvReturn;
 }
 /*-----------------------------------------------------------*/
@@ -267,6 +578,9 @@ void vPortFree( void *pv )
 {
 uint8_t *puc = ( uint8_t * ) pv;
 BlockLink_t *pxLink;
+#if( configUSE_HEAP_TRACKING == 1 )
+	const uint32_t ulStartCycles = portGET_CYCLE_COUNT();
+#endif
 
 	if( pv != NULL )
 	{
@@ -285,17 +599,49 @@ BlockLink_t *pxLink;
 		{
 			if( pxLink->pxNextFreeBlock == NULL )
 			{
-				/* The block is being returned to the heap - it is no longer
-				allocated. */
-				pxLink->xBlockSize &= ~xBlockAllocatedBit;
+				#if( configUSE_TASK_HEAP_CACHE == 1 )
+				{
+					/* Small blocks are held in the calling task's cache if
+					there is room, which does not require the scheduler to be
+					suspended. */
+					if( prvAddToTaskHeapCache( pxLink ) != pdFALSE )
+					{
+						traceFREE( pv, heapBLOCK_SIZE( pxLink ) );
+
+						#if( configUSE_HEAP_TRACKING == 1 )
+						{
+							vHeapTrackingRecordFree( portGET_CYCLE_COUNT() - ulStartCycles );
+						}
+						#endif
+
+						return;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TASK_HEAP_CACHE */
 
 				vTaskSuspendAll();
 				{
+					/* The block is being returned to the heap - it is no longer
+					allocated.  This is done with the scheduler suspended as
+					freeing the block in front of this block also updates
+					xBlockSize. */
+					pxLink->xBlockSize &= ~xBlockAllocatedBit;
+
 					/* Add this block to the list of free blocks. */
-					xFreeBytesRemaining += pxLink->xBlockSize;
-					traceFREE( pv, pxLink->xBlockSize );
+					xFreeBytesRemaining += heapBLOCK_SIZE( pxLink );
+					traceFREE( pv, heapBLOCK_SIZE( pxLink ) );
 					prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
 					xNumberOfSuccessfulFrees++;
+
+					#if( configUSE_HEAP_TRACKING == 1 )
+					{
+						vHeapTrackingRecordFree( portGET_CYCLE_COUNT() - ulStartCycles );
+					}
+					#endif
 				}
 				( void ) xTaskResumeAll();
 			}
@@ -349,113 +695,291 @@ size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
 
 	pucAlignedHeap = ( uint8_t * ) uxAddress;
 
-	/* xStart is used to hold a pointer to the first item in the list of free
-	blocks.  The void cast is used to prevent compiler warnings. */
-	xStart.pxNextFreeBlock = ( void * ) pucAlignedHeap;
-	xStart.xBlockSize = ( size_t ) 0;
+	/* Work out the position of the top bit in a size_t variable. */
+	xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
 
-	/* pxEnd is used to mark the end of the list of free blocks and is inserted
-	at the end of the heap space. */
+	/* pxEnd is used to mark the end of the heap space and is inserted at the
+	end of it.  It is marked as allocated so it is never combined with the block
+	in front of it. */
 	uxAddress = ( ( size_t ) pucAlignedHeap ) + xTotalHeapSize;
 	uxAddress -= xHeapStructSize;
 	uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
 	pxEnd = ( void * ) uxAddress;
-	pxEnd->xBlockSize = 0;
+	pxEnd->xBlockSize = xBlockAllocatedBit;
 	pxEnd->pxNextFreeBlock = NULL;
 
 	/* To start with there is a single free block that is sized to take up the
 	entire heap space, minus the space taken by pxEnd. */
 	pxFirstFreeBlock = ( void * ) pucAlignedHeap;
 	pxFirstFreeBlock->xBlockSize = uxAddress - ( size_t ) pxFirstFreeBlock;
-	pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
+	prvInsertBlockIntoFreeList( pxFirstFreeBlock );
+
+	#if( configUSE_HEAP_TRACKING == 1 )
+	{
+		pxFirstBlock = pxFirstFreeBlock;
+	}
+	#endif
 
 	/* Only one block exists - and it covers the entire usable heap space. */
 	xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
 	xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
-
-	/* Work out the position of the top bit in a size_t variable. */
-	xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
 }
 /*-----------------------------------------------------------*/
 
 static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
 {
-BlockLink_t *pxIterator;
-uint8_t *puc;
+BlockLink_t *pxPreviousBlock, *pxNextBlock;
 
-	/* Iterate through the list until a block is found that has a higher address
-	than the block being inserted. */
-	for( pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+	/* Is the block in front of the block being inserted free?  If so its
+	boundary tag gives its size, and the two are formed into one big block. */
+	if( ( pxBlockToInsert->xBlockSize & heapPREVIOUS_BLOCK_FREE_BIT ) != 0 )
+	{
+		pxBlockToInsert->xBlockSize &= ~heapPREVIOUS_BLOCK_FREE_BIT;
+		pxPreviousBlock = heapPREVIOUS_BLOCK( pxBlockToInsert );
+		prvRemoveBlockFromFreeList( pxPreviousBlock );
+		pxPreviousBlock->xBlockSize += pxBlockToInsert->xBlockSize;
+		pxBlockToInsert = pxPreviousBlock;
+	}
+	else
 	{
-		/* Nothing to do here, just iterate to the right position. */
+		mtCOVERAGE_TEST_MARKER();
 	}
 
-	/* Do the block being inserted, and the block it is being inserted after
-	make a contiguous block of memory? */
-	puc = ( uint8_t * ) pxIterator;
-	if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+	/* Is the block behind the block being inserted free?  End markers are
+	marked as allocated, so are never combined. */
+	pxNextBlock = heapNEXT_BLOCK( pxBlockToInsert );
+	if( ( pxNextBlock->xBlockSize & xBlockAllocatedBit ) == 0 )
 	{
-		pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
-		pxBlockToInsert = pxIterator;
+		/* Form one big block from the two blocks. */
+		prvRemoveBlockFromFreeList( pxNextBlock );
+		pxBlockToInsert->xBlockSize += pxNextBlock->xBlockSize;
+		pxNextBlock = heapNEXT_BLOCK( pxBlockToInsert );
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	/* Do the block being inserted, and the block it is being inserted before
-	make a contiguous block of memory? */
-	puc = ( uint8_t * ) pxBlockToInsert;
-	if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
+	/* Record the size of the block at its end, where the block behind it can
+	find it, and mark the block behind it as following a free block. */
+	heapBOUNDARY_TAG( pxBlockToInsert ) = pxBlockToInsert->xBlockSize;
+	pxNextBlock->xBlockSize |= heapPREVIOUS_BLOCK_FREE_BIT;
+
+	prvAddBlockToFreeList( pxBlockToInsert );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetAlignmentGap( const BlockLink_t *pxBlock, size_t xAlignment )
+{
+size_t xAddress, xGap;
+
+	/* Blocks are always aligned to portBYTE_ALIGNMENT, so only larger
+	alignments can require a gap. */
+	xAddress = ( ( size_t ) pxBlock ) + xHeapStructSize;
+
+	if( ( xAddress & ( xAlignment - ( size_t ) 1 ) ) == ( size_t ) 0 )
+	{
+		xGap = ( size_t ) 0;
+	}
+	else
+	{
+		/* The gap becomes a free block, so must be at least
+		heapMINIMUM_BLOCK_SIZE bytes.  As both addresses are multiples of
+		portBYTE_ALIGNMENT so is the gap. */
+		xGap = ( ( xAddress + heapMINIMUM_BLOCK_SIZE + ( xAlignment - ( size_t ) 1 ) ) & ~( xAlignment - ( size_t ) 1 ) ) - xAddress;
+	}
+
+	return xGap;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddBlockToFreeList( BlockLink_t *pxBlockToAdd )
+{
+UBaseType_t uxIndex;
+
+	/* Blocks are added to the front of their list. */
+	uxIndex = prvGetFreeListIndex( pxBlockToAdd->xBlockSize );
+	pxBlockToAdd->pxNextFreeBlock = pxFreeLists[ uxIndex ];
+	heapPREVIOUS_FREE_BLOCK( pxBlockToAdd ) = NULL;
+
+	if( pxFreeLists[ uxIndex ] != NULL )
+	{
+		heapPREVIOUS_FREE_BLOCK( pxFreeLists[ uxIndex ] ) = pxBlockToAdd;
+	}
+	else
 	{
-		if( pxIterator->pxNextFreeBlock != pxEnd )
+		ulFreeListBitMap |= ( ( uint32_t ) 1U ) << uxIndex;
+	}
+
+	pxFreeLists[ uxIndex ] = pxBlockToAdd;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove )
+{
+BlockLink_t *pxPreviousFreeBlock;
+UBaseType_t uxIndex;
+
+	pxPreviousFreeBlock = heapPREVIOUS_FREE_BLOCK( pxBlockToRemove );
+
+	if( pxPreviousFreeBlock != NULL )
+	{
+		pxPreviousFreeBlock->pxNextFreeBlock = pxBlockToRemove->pxNextFreeBlock;
+	}
+	else
+	{
+		/* The block is the first in its list. */
+		uxIndex = prvGetFreeListIndex( pxBlockToRemove->xBlockSize );
+		pxFreeLists[ uxIndex ] = pxBlockToRemove->pxNextFreeBlock;
+
+		if( pxFreeLists[ uxIndex ] == NULL )
 		{
-			/* Form one big block from the two blocks. */
-			pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
-			pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+			ulFreeListBitMap &= ~( ( ( uint32_t ) 1U ) << uxIndex );
 		}
 		else
 		{
-			pxBlockToInsert->pxNextFreeBlock = pxEnd;
+			mtCOVERAGE_TEST_MARKER();
 		}
 	}
+
+	if( pxBlockToRemove->pxNextFreeBlock != NULL )
+	{
+		heapPREVIOUS_FREE_BLOCK( pxBlockToRemove->pxNextFreeBlock ) = pxPreviousFreeBlock;
+	}
 	else
 	{
-		pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+		mtCOVERAGE_TEST_MARKER();
 	}
+}
+/*-----------------------------------------------------------*/
 
-	/* If the block being inserted plugged a gab, so was merged with the block
-	before and the block after, then it's pxNextFreeBlock pointer will have
-	already been set, and should not be set here as that would make it point
-	to itself. */
-	if( pxIterator != pxBlockToInsert )
+static BlockLink_t *prvFindSuitableBlock( size_t xWantedSize, size_t xAlignment, UBaseType_t uxSearchLimit )
+{
+BlockLink_t *pxBlock, *pxBestBlock = NULL;
+UBaseType_t uxIndex, uxExamined;
+uint32_t ulBitMap;
+
+	/* Only the list for xWantedSize and the lists after it can hold a block
+	that is large enough.  Every block in the later lists is larger than
+	xWantedSize, so the search only moves past the first list that is not
+	empty if none of its blocks leaves room for the alignment gap. */
+	uxIndex = prvGetFreeListIndex( xWantedSize );
+	ulBitMap = ulFreeListBitMap & ~( ( ( ( uint32_t ) 1U ) << uxIndex ) - ( uint32_t ) 1U );
+
+	while( ( ulBitMap != 0UL ) && ( pxBestBlock == NULL ) )
 	{
-		pxIterator->pxNextFreeBlock = pxBlockToInsert;
+		uxIndex = prvFindFirstSet( ulBitMap );
+		ulBitMap &= ~( ( ( uint32_t ) 1U ) << uxIndex );
+		uxExamined = 0;
+
+		for( pxBlock = pxFreeLists[ uxIndex ]; ( pxBlock != NULL ) && ( uxExamined < uxSearchLimit ); pxBlock = pxBlock->pxNextFreeBlock )
+		{
+			if( ( pxBlock->xBlockSize >= xWantedSize ) && ( ( pxBlock->xBlockSize - xWantedSize ) >= prvGetAlignmentGap( pxBlock, xAlignment ) ) )
+			{
+				/* Of two blocks of the same size take the one at the lower
+				address, so memory is taken from the low end of the heap
+				while large blocks stay free at the high end. */
+				if( ( pxBestBlock == NULL ) || ( pxBlock->xBlockSize < pxBestBlock->xBlockSize ) || ( ( pxBlock->xBlockSize == pxBestBlock->xBlockSize ) && ( pxBlock < pxBestBlock ) ) )
+				{
+					pxBestBlock = pxBlock;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			uxExamined++;
+		}
+	}
+
+	return pxBestBlock;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetFreeListIndex( size_t xBlockSize )
+{
+UBaseType_t uxIndex;
+
+	/* No block is smaller than heapMINIMUM_BLOCK_SIZE. */
+	uxIndex = prvFindLastSet( xBlockSize ) - prvFindLastSet( heapMINIMUM_BLOCK_SIZE );
+
+	if( uxIndex >= heapFREE_LIST_COUNT )
+	{
+		uxIndex = heapFREE_LIST_COUNT - 1U;
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
+
+	return uxIndex;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( size_t xValue )
+{
+	#if defined( __GNUC__ )
+	{
+		return ( UBaseType_t ) ( ( ( sizeof( unsigned long ) * heapBITS_PER_BYTE ) - 1U ) - ( size_t ) __builtin_clzl( ( unsigned long ) xValue ) );
+	}
+	#else
+	{
+	UBaseType_t uxBit = 0;
+
+		while( ( xValue >>= 1 ) != 0 )
+		{
+			uxBit++;
+		}
+
+		return uxBit;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindFirstSet( uint32_t ulValue )
+{
+	#if defined( portCOUNT_TRAILING_ZEROS )
+	{
+		return portCOUNT_TRAILING_ZEROS( ulValue );
+	}
+	#else
+	{
+	UBaseType_t uxBit = 0;
+
+		while( ( ulValue & 0x01UL ) == 0UL )
+		{
+			ulValue >>= 1;
+			uxBit++;
+		}
+
+		return uxBit;
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
 void vPortGetHeapStats( HeapStats_t *pxHeapStats )
 {
 BlockLink_t *pxBlock;
+UBaseType_t uxIndex;
 size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
 
 	vTaskSuspendAll();
 	{
-		pxBlock = xStart.pxNextFreeBlock;
-
-		/* pxBlock will be NULL if the heap has not been initialised.  The heap
-		is initialised automatically when the first allocation is made. */
-		if( pxBlock != NULL )
+		/* Walk every free list.  The lists are empty if the heap has not been
+		initialised. */
+		for( uxIndex = 0; uxIndex < heapFREE_LIST_COUNT; uxIndex++ )
 		{
-			do
+			for( pxBlock = pxFreeLists[ uxIndex ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
 			{
-				/* Increment the number of blocks and record the largest block seen
-				so far. */
+				/* Increment the number of blocks and record the largest block
+				seen so far. */
 				xBlocks++;
 
 				if( pxBlock->xBlockSize > xMaxSize )
@@ -467,11 +991,7 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 				{
 					xMinSize = pxBlock->xBlockSize;
 				}
-
-				/* Move to the next block in the chain until the last block is
-				reached. */
-				pxBlock = pxBlock->pxNextFreeBlock;
-			} while( pxBlock != pxEnd );
+			}
 		}
 	}
 	xTaskResumeAll();
@@ -489,4 +1009,243 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 	}
 	taskEXIT_CRITICAL();
 }
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+
+	static void *prvTakeFromTaskHeapCache( size_t xWantedSize )
+	{
+	void **ppvCache;
+	BlockLink_t *pxBlock = NULL;
+	size_t xClass;
+	void *pvReturn = NULL;
+
+		/* Only requests small enough to be cached are considered, which also
+		ensures the size calculation below cannot overflow.  The block size is
+		calculated in the same way as in pvPortMalloc(). */
+		if( ( xWantedSize > 0 ) && ( xWantedSize <= heapCACHE_MAX_REQUEST ) )
+		{
+			xWantedSize += xHeapStructSize;
+			xWantedSize = ( xWantedSize + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+			xClass = heapCACHE_CLASS_FOR( xWantedSize );
+			ppvCache = ppvTaskGetHeapCache();
+
+			if( ( xClass < ( size_t ) configHEAP_CACHE_SIZE_CLASSES ) && ( ppvCache != NULL ) )
+			{
+				/* Only the calling task uses its cache, but the task could be
+				deleted by another task while it is part way through updating
+				the cache. */
+				taskENTER_CRITICAL();
+				{
+					pxBlock = ( BlockLink_t * ) ppvCache[ xClass ];
+
+					if( pxBlock != NULL )
+					{
+						/* The next block, if any, becomes the head of the class
+						so takes over the count. */
+						if( pxBlock->pxNextFreeBlock != NULL )
+						{
+							heapCACHE_COUNT( pxBlock->pxNextFreeBlock ) = heapCACHE_COUNT( pxBlock ) - ( size_t ) 1;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						ppvCache[ xClass ] = pxBlock->pxNextFreeBlock;
+						pxBlock->pxNextFreeBlock = NULL;
+						xNumberOfSuccessfulAllocations++;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				taskEXIT_CRITICAL();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxBlock != NULL )
+		{
+			pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+			traceMALLOC( pvReturn, heapBLOCK_SIZE( pxBlock ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pvReturn;
+	}
+
+#endif /* configUSE_TASK_HEAP_CACHE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+
+	static BaseType_t prvAddToTaskHeapCache( BlockLink_t *pxBlock )
+	{
+	void **ppvCache;
+	BlockLink_t *pxHead;
+	size_t xClass, xCount;
+	BaseType_t xReturn = pdFALSE;
+
+		xClass = heapCACHE_CLASS_HOLDING( heapBLOCK_SIZE( pxBlock ) );
+		ppvCache = ppvTaskGetHeapCache();
+
+		if( ( xClass < ( size_t ) configHEAP_CACHE_SIZE_CLASSES ) && ( ppvCache != NULL ) )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxHead = ( BlockLink_t * ) ppvCache[ xClass ];
+
+				if( pxHead != NULL )
+				{
+					xCount = heapCACHE_COUNT( pxHead );
+				}
+				else
+				{
+					xCount = 0;
+				}
+
+				if( xCount < ( size_t ) configHEAP_CACHE_DEPTH )
+				{
+					/* The block stays marked as allocated while it is in the
+					cache. */
+					pxBlock->pxNextFreeBlock = pxHead;
+					heapCACHE_COUNT( pxBlock ) = xCount + ( size_t ) 1;
+					ppvCache[ xClass ] = ( void * ) pxBlock;
+					xNumberOfSuccessfulFrees++;
+
+					#if( configUSE_HEAP_TRACKING == 1 )
+					{
+						/* Cached blocks are not reported as allocated. */
+						pxBlock->ulSequence = 0UL;
+					}
+					#endif
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_HEAP_CACHE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+
+	void vPortReleaseTaskHeapCache( void **ppvHeapCache )
+	{
+	BlockLink_t *pxBlock, *pxNextBlock;
+	UBaseType_t uxClass;
+
+		vTaskSuspendAll();
+		{
+			for( uxClass = 0; uxClass < ( UBaseType_t ) configHEAP_CACHE_SIZE_CLASSES; uxClass++ )
+			{
+				pxBlock = ( BlockLink_t * ) ppvHeapCache[ uxClass ];
+				ppvHeapCache[ uxClass ] = NULL;
+
+				/* The blocks were counted as freed when they entered the cache,
+				so are only returned to the list of free blocks here. */
+				while( pxBlock != NULL )
+				{
+					pxNextBlock = pxBlock->pxNextFreeBlock;
+					pxBlock->xBlockSize &= ~xBlockAllocatedBit;
+					xFreeBytesRemaining += heapBLOCK_SIZE( pxBlock );
+					prvInsertBlockIntoFreeList( pxBlock );
+					pxBlock = pxNextBlock;
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+
+#endif /* configUSE_TASK_HEAP_CACHE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TRACKING == 1 )
+
+	static void prvTrackAllocation( BlockLink_t *pxBlock, size_t xRequestedSize, void *pvCaller, uint32_t ulStartCycles )
+	{
+		pxBlock->pvCaller = pvCaller;
+
+		if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+		{
+			pxBlock->xOwner = xTaskGetCurrentTaskHandle();
+		}
+		else
+		{
+			pxBlock->xOwner = NULL;
+		}
+
+		pxBlock->ulSequence = ulHeapTrackingRecordAllocation( xRequestedSize, portGET_CYCLE_COUNT() - ulStartCycles );
+	}
+
+#endif /* configUSE_HEAP_TRACKING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TRACKING == 1 )
+
+	UBaseType_t uxPortGetHeapAllocations( HeapAllocation_t *pxAllocations, UBaseType_t uxArraySize, UBaseType_t uxFirst, uint32_t ulFromSequence )
+	{
+	BlockLink_t *pxBlock;
+	UBaseType_t uxCount = 0;
+
+		vTaskSuspendAll();
+		{
+			/* pxFirstBlock is NULL until the heap has been initialised. */
+			pxBlock = pxFirstBlock;
+
+			while( ( pxBlock != NULL ) && ( pxBlock != pxEnd ) && ( uxCount < uxArraySize ) )
+			{
+				if( ( ( pxBlock->xBlockSize & xBlockAllocatedBit ) != 0 ) && ( pxBlock->ulSequence != 0UL ) && ( pxBlock->ulSequence >= ulFromSequence ) )
+				{
+					if( uxFirst > ( UBaseType_t ) 0 )
+					{
+						uxFirst--;
+					}
+					else
+					{
+						pxAllocations[ uxCount ].pvAddress = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+						pxAllocations[ uxCount ].xSize = heapBLOCK_SIZE( pxBlock ) - xHeapStructSize;
+						pxAllocations[ uxCount ].pvCaller = pxBlock->pvCaller;
+						pxAllocations[ uxCount ].xOwner = pxBlock->xOwner;
+						pxAllocations[ uxCount ].ulSequence = pxBlock->ulSequence;
+						uxCount++;
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Blocks are contiguous, so the next block follows this one. */
+				pxBlock = heapNEXT_BLOCK( pxBlock );
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxCount;
+	}
 
+#endif /* configUSE_HEAP_TRACKING */
@@ -0,0 +1,818 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that uses a two
+ * level segregated fit (TLSF) allocator, so the time taken to allocate and free
+ * memory does not depend on the number of free blocks, and so does not grow as
+ * the heap becomes fragmented.
+ *
+ * Free blocks are held in an array of free lists.  The first level of the
+ * array divides block sizes into powers of two, and the second level divides
+ * each power of two into heapSECOND_LEVEL_INDEX_COUNT linear ranges.  A bit map
+ * per level records which lists are not empty, so a free block that is large
+ * enough to satisfy a request is found with a count leading zeros and two
+ * count trailing zeros operations instead of by walking a list.  Each block
+ * holds a pointer to the block that precedes it in memory, so a block being
+ * freed is merged (coalesced) with both of its neighbours immediately, again
+ * without walking a list.
+ *
+ * As with heap_5.c the heap can be made up of more than one memory region.
+ * Regions are added using vPortDefineHeapRegions(), which takes the same array
+ * of HeapRegion_t structures as heap_5.c.  Unlike heap_5.c the regions need not
+ * be in address order, and vPortDefineHeapRegions() can be called more than
+ * once to add regions at any time.  If configTOTAL_HEAP_SIZE is defined, and
+ * no region has been added by the time pvPortMalloc() is first called, then a
+ * region of that size is created from the ucHeap array (or from an application
+ * defined ucHeap array if configAPPLICATION_ALLOCATED_HEAP is 1),
+ * so heap_6.c can also be used as a direct replacement for heap_4.c.
+ *
+ * Requests are rounded up to the start of the next free list, so the first
+ * block found is always large enough (good fit rather than best fit).  This
+ * can waste up to 1 / heapSECOND_LEVEL_INDEX_COUNT of a large request.  If no
+ * such list holds a block then the head of the list the unrounded size maps to
+ * is also checked, so a request can still use the last large free block.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* A default heap region is created from the ucHeap array if the application
+defines configTOTAL_HEAP_SIZE. */
+#ifdef configTOTAL_HEAP_SIZE
+	#define heapUSE_DEFAULT_REGION			1
+#else
+	#define heapUSE_DEFAULT_REGION			0
+#endif
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE				( ( size_t ) 8 )
+
+/* The number of second level free lists per first level list, which must be a
+power of two no greater than 32.  Larger values waste less memory when large
+requests are rounded up, but need more free list heads. */
+#define heapSECOND_LEVEL_INDEX_LOG2		( 3U )
+#define heapSECOND_LEVEL_INDEX_COUNT	( 1U << heapSECOND_LEVEL_INDEX_LOG2 )
+
+/* The number of first level free lists, which must be no greater than 32.
+Blocks smaller than heapSMALL_BLOCK_SIZE are held in the first first level
+list, divided linearly by alignment.  Each following first level list holds
+blocks up to double the size of those in the list before, so the largest
+block the heap can hold is heapMAX_BLOCK_SIZE - 1 bytes. */
+#ifndef heapFIRST_LEVEL_INDEX_COUNT
+	#define heapFIRST_LEVEL_INDEX_COUNT	( 24U )
+#endif
+
+#define heapSMALL_BLOCK_SIZE			( ( size_t ) heapSECOND_LEVEL_INDEX_COUNT * ( size_t ) portBYTE_ALIGNMENT )
+#define heapMAX_BLOCK_SIZE				( heapSMALL_BLOCK_SIZE << ( heapFIRST_LEVEL_INDEX_COUNT - 1U ) )
+
+#if( heapSECOND_LEVEL_INDEX_COUNT > 32U ) || ( heapFIRST_LEVEL_INDEX_COUNT > 32U )
+	#error The free list bit maps are 32 bits wide.
+#endif
+
+/* The header placed at the start of every block.  pxNextFreeBlock and
+pxPrevFreeBlock are only used while the block is free, so are not counted in
+xHeapStructSize and overlay the start of the memory returned to the
+application while the block is allocated. */
+typedef struct A_BLOCK_LINK
+{
+	struct A_BLOCK_LINK *pxPrevPhysBlock;	/*<< The block immediately before this block in memory, or NULL if this is the first block in its region. */
+	size_t xBlockSize;						/*<< The size of the block, including this header. */
+	struct A_BLOCK_LINK *pxNextFreeBlock;	/*<< The next block in the same free list. */
+	struct A_BLOCK_LINK *pxPrevFreeBlock;	/*<< The previous block in the same free list. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to create the default heap region the first time
+ * pvPortMalloc() is called, if configTOTAL_HEAP_SIZE is defined.
+ */
+#if( heapUSE_DEFAULT_REGION == 1 )
+	static void prvHeapInit( void );
+#endif
+
+/*
+ * Adds a region of memory to the heap as a single free block followed by a
+ * zero sized end marker.  Returns the size of the free block.  Must be called
+ * with the scheduler suspended.
+ */
+static size_t prvAddRegion( uint8_t *pucStartAddress, size_t xSizeInBytes );
+
+/*
+ * Calculate the indexes of the free list that holds blocks of xBlockSize
+ * bytes.
+ */
+static void prvMapBlockSize( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel );
+
+/*
+ * Return a free block that is at least xWantedSize bytes, removing it from
+ * its free list, or NULL if there is no such block.
+ */
+static BlockLink_t *prvFindSuitableBlock( size_t xWantedSize );
+
+/*
+ * Add a free block to, or remove a free block from, the free list that holds
+ * blocks of its size.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove );
+
+/*
+ * Bit scans.  prvFindLastSet() returns the index of the most significant set
+ * bit, prvFindFirstSet() the index of the least significant set bit.  Neither
+ * can be passed zero.
+ */
+static UBaseType_t prvFindLastSet( size_t xValue );
+static UBaseType_t prvFindFirstSet( uint32_t ulValue );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the header placed at the beginning of each allocated memory
+block must by correctly byte aligned.  Blocks must be large enough to hold the
+complete BlockLink_t structure once they are freed. */
+static const size_t xHeapStructSize	= ( sizeof( BlockLink_t * ) + sizeof( size_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+static const size_t xMinimumBlockSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and the bit maps that record which free lists are not
+empty.  Bit n of ulFirstLevelBitMap is set when any list in
+pxFreeLists[ n ] is not empty. */
+static BlockLink_t *pxFreeLists[ heapFIRST_LEVEL_INDEX_COUNT ][ heapSECOND_LEVEL_INDEX_COUNT ];
+static uint32_t ulFirstLevelBitMap = 0UL;
+static uint32_t ulSecondLevelBitMaps[ heapFIRST_LEVEL_INDEX_COUNT ];
+
+/* Set to pdTRUE once at least one region has been added to the heap. */
+static BaseType_t xHeapHasRegions = pdFALSE;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+number of free bytes remaining, but says nothing about fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
+member of an BlockLink_t structure is set then the block belongs to the
+application.  When the bit is free the block is still part of the free heap
+space.  The end marker of each region is permanently marked as allocated so it
+is never merged with the block before it. */
+static const size_t xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
+#if( heapUSE_DEFAULT_REGION == 1 )
+	/* Allocate the memory for the default heap region. */
+	#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+		/* The application writer has already defined the array used for the RTOS
+		heap - probably so it can be placed in a special segment or address. */
+		extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+	#else
+		static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+	#endif /* configAPPLICATION_ALLOCATED_HEAP */
+#endif
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+BlockLink_t *pxBlock, *pxNewBlockLink, *pxNextBlock;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		#if( heapUSE_DEFAULT_REGION == 1 )
+		{
+			/* If this is the first call to malloc then the default heap region
+			will require initialisation. */
+			if( xHeapHasRegions == pdFALSE )
+			{
+				prvHeapInit();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
+		/* The heap must contain at least one region before the first call to
+		pvPortMalloc(). */
+		configASSERT( xHeapHasRegions );
+
+		/* Requests for more than the largest block the heap can hold would
+		also set the allocated bit, so cannot be satisfied. */
+		if( ( xWantedSize > 0 ) && ( xWantedSize < heapMAX_BLOCK_SIZE ) )
+		{
+			/* The wanted size is increased so it can contain the block header
+			in addition to the requested amount of bytes, and so the block is
+			large enough to hold the free list links once it is freed. */
+			xWantedSize += xHeapStructSize;
+
+			/* Ensure that blocks are always aligned to the required number of
+			bytes. */
+			if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+			{
+				/* Byte alignment required. */
+				xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xWantedSize < xMinimumBlockSize )
+			{
+				xWantedSize = xMinimumBlockSize;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xWantedSize <= xFreeBytesRemaining )
+			{
+				pxBlock = prvFindSuitableBlock( xWantedSize );
+
+				if( pxBlock != NULL )
+				{
+					/* If the block is larger than required it can be split into
+					two.  The block after the new block must be allocated (or an
+					end marker), as otherwise it would have been merged with
+					this block when one of them was freed, so the new block does
+					not need to be merged with anything. */
+					if( ( pxBlock->xBlockSize - xWantedSize ) >= xMinimumBlockSize )
+					{
+						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+						pxNewBlockLink->pxPrevPhysBlock = pxBlock;
+						pxBlock->xBlockSize = xWantedSize;
+
+						pxNextBlock = ( void * ) ( ( ( uint8_t * ) pxNewBlockLink ) + pxNewBlockLink->xBlockSize );
+						pxNextBlock->pxPrevPhysBlock = pxNewBlockLink;
+
+						prvInsertBlockIntoFreeList( pxNewBlockLink );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The block is being returned - it is allocated and owned
+					by the application. */
+					pxBlock->xBlockSize |= xBlockAllocatedBit;
+					xNumberOfSuccessfulAllocations++;
+
+					/* Return the memory space pointed to - jumping over the
+					block header at its start. */
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+BlockLink_t *pxLink, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a block header immediately before
+		it. */
+		puc -= xHeapStructSize;
+
+		/* This casting is to keep the compiler from issuing warnings. */
+		pxLink = ( void * ) puc;
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
+
+		if( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 )
+		{
+			vTaskSuspendAll();
+			{
+				/* The block is being returned to the heap - it is no longer
+				allocated. */
+				pxLink->xBlockSize &= ~xBlockAllocatedBit;
+				xFreeBytesRemaining += pxLink->xBlockSize;
+				traceFREE( pv, pxLink->xBlockSize );
+
+				/* Merge with the block before this block in memory, if that
+				block is free. */
+				pxNeighbour = pxLink->pxPrevPhysBlock;
+				if( ( pxNeighbour != NULL ) && ( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 ) )
+				{
+					prvRemoveBlockFromFreeList( pxNeighbour );
+					pxNeighbour->xBlockSize += pxLink->xBlockSize;
+					pxLink = pxNeighbour;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Merge with the block after this block in memory, if that
+				block is free.  The end marker of a region is always marked as
+				allocated so this never steps past the end of a region. */
+				pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxLink ) + pxLink->xBlockSize );
+				if( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 )
+				{
+					prvRemoveBlockFromFreeList( pxNeighbour );
+					pxLink->xBlockSize += pxNeighbour->xBlockSize;
+					pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxLink ) + pxLink->xBlockSize );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxNeighbour->pxPrevPhysBlock = pxLink;
+				prvInsertBlockIntoFreeList( pxLink );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+size_t xTotalHeapSize = 0;
+BaseType_t xDefinedRegions = 0;
+const HeapRegion_t *pxHeapRegion;
+
+	vTaskSuspendAll();
+	{
+		pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+
+		while( pxHeapRegion->xSizeInBytes > 0 )
+		{
+			xTotalHeapSize += prvAddRegion( pxHeapRegion->pucStartAddress, pxHeapRegion->xSizeInBytes );
+
+			/* Move onto the next HeapRegion_t structure. */
+			xDefinedRegions++;
+			pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+		}
+
+		/* Check something was actually defined before it is accessed. */
+		configASSERT( xTotalHeapSize );
+
+		xFreeBytesRemaining += xTotalHeapSize;
+		xMinimumEverFreeBytesRemaining += xTotalHeapSize;
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+#if( heapUSE_DEFAULT_REGION == 1 )
+
+	static void prvHeapInit( void )
+	{
+	size_t xTotalHeapSize;
+
+		xTotalHeapSize = prvAddRegion( ucHeap, ( size_t ) configTOTAL_HEAP_SIZE );
+		xFreeBytesRemaining += xTotalHeapSize;
+		xMinimumEverFreeBytesRemaining += xTotalHeapSize;
+	}
+
+#endif /* heapUSE_DEFAULT_REGION */
+/*-----------------------------------------------------------*/
+
+static size_t prvAddRegion( uint8_t *pucStartAddress, size_t xSizeInBytes )
+{
+BlockLink_t *pxFirstBlock, *pxEnd;
+size_t xAddress, xEndAddress;
+
+	/* Ensure the heap region starts and ends on correctly aligned
+	boundaries. */
+	xAddress = ( size_t ) pucStartAddress;
+	xAddress += ( portBYTE_ALIGNMENT - 1 );
+	xAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	xEndAddress = ( size_t ) pucStartAddress + xSizeInBytes;
+	xEndAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	/* The region must hold at least one minimum sized block plus the end
+	marker, and must not be larger than the largest block the free lists can
+	hold. */
+	configASSERT( xEndAddress > xAddress );
+	configASSERT( ( xEndAddress - xAddress ) >= ( xMinimumBlockSize + xHeapStructSize ) );
+	configASSERT( ( xEndAddress - xAddress ) < heapMAX_BLOCK_SIZE );
+
+	/* The end marker is a zero sized block at the end of the region that is
+	marked as allocated so the last block in the region is never merged with
+	whatever follows the region in memory. */
+	pxEnd = ( BlockLink_t * ) ( xEndAddress - xHeapStructSize );
+	pxEnd->xBlockSize = xBlockAllocatedBit;
+
+	/* To start with there is a single free block in the region that takes up
+	the entire region minus the space taken by the end marker. */
+	pxFirstBlock = ( BlockLink_t * ) xAddress;
+	pxFirstBlock->pxPrevPhysBlock = NULL;
+	pxFirstBlock->xBlockSize = ( size_t ) pxEnd - xAddress;
+	pxEnd->pxPrevPhysBlock = pxFirstBlock;
+
+	prvInsertBlockIntoFreeList( pxFirstBlock );
+	xHeapHasRegions = pdTRUE;
+
+	return pxFirstBlock->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapBlockSize( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel )
+{
+UBaseType_t uxLastSet;
+
+	if( xBlockSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are held in the first first level list, with one second
+		level list per multiple of the alignment. */
+		*puxFirstLevel = 0;
+		*puxSecondLevel = ( UBaseType_t ) ( xBlockSize / ( size_t ) portBYTE_ALIGNMENT );
+	}
+	else
+	{
+		/* The first level is the power of two, the second level the next
+		heapSECOND_LEVEL_INDEX_LOG2 bits below the most significant set bit. */
+		uxLastSet = prvFindLastSet( xBlockSize );
+		*puxFirstLevel = ( uxLastSet - prvFindLastSet( heapSMALL_BLOCK_SIZE ) ) + 1U;
+		*puxSecondLevel = ( UBaseType_t ) ( ( xBlockSize >> ( uxLastSet - heapSECOND_LEVEL_INDEX_LOG2 ) ) & ( heapSECOND_LEVEL_INDEX_COUNT - 1U ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t *prvFindSuitableBlock( size_t xWantedSize )
+{
+BlockLink_t *pxBlock = NULL;
+UBaseType_t uxFirstLevel, uxSecondLevel;
+uint32_t ulBitMap;
+size_t xRequiredSize = xWantedSize;
+
+	/* Round the size up to the first size held by the next free list, so
+	every block in the list found is large enough and only the head of the
+	list needs to be inspected. */
+	if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xWantedSize += ( ( ( size_t ) 1 ) << ( prvFindLastSet( xWantedSize ) - heapSECOND_LEVEL_INDEX_LOG2 ) ) - 1U;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvMapBlockSize( xWantedSize, &uxFirstLevel, &uxSecondLevel );
+
+	if( uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT )
+	{
+		/* Look for a non-empty list in the same first level list first, then
+		for the smallest non-empty list in a larger first level list. */
+		ulBitMap = ulSecondLevelBitMaps[ uxFirstLevel ] & ( ( ( uint32_t ) 0xffffffffUL ) << uxSecondLevel );
+
+		if( ulBitMap == 0UL )
+		{
+			ulBitMap = ulFirstLevelBitMap & ~( ( ( uint32_t ) 0xffffffffUL ) >> ( 31U - uxFirstLevel ) );
+
+			if( ulBitMap != 0UL )
+			{
+				uxFirstLevel = prvFindFirstSet( ulBitMap );
+				ulBitMap = ulSecondLevelBitMaps[ uxFirstLevel ];
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ulBitMap != 0UL )
+		{
+			uxSecondLevel = prvFindFirstSet( ulBitMap );
+			pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock == NULL )
+	{
+		/* There is no list that only holds large enough blocks, but the list
+		the requested size itself maps to may hold a block that is large
+		enough.  Only the head of that list is checked, so the time taken is
+		still bounded. */
+		prvMapBlockSize( xRequiredSize, &uxFirstLevel, &uxSecondLevel );
+
+		if( uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT )
+		{
+			pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+
+			if( ( pxBlock != NULL ) && ( pxBlock->xBlockSize < xRequiredSize ) )
+			{
+				pxBlock = NULL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock != NULL )
+	{
+		prvRemoveBlockFromFreeList( pxBlock );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+BlockLink_t *pxHead;
+
+	prvMapBlockSize( pxBlockToInsert->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+	configASSERT( uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT );
+
+	/* Insert at the head of the list, and mark the list as not empty. */
+	pxHead = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+	pxBlockToInsert->pxNextFreeBlock = pxHead;
+	pxBlockToInsert->pxPrevFreeBlock = NULL;
+
+	if( pxHead != NULL )
+	{
+		pxHead->pxPrevFreeBlock = pxBlockToInsert;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlockToInsert;
+	ulFirstLevelBitMap |= ( ( uint32_t ) 1U ) << uxFirstLevel;
+	ulSecondLevelBitMaps[ uxFirstLevel ] |= ( ( uint32_t ) 1U ) << uxSecondLevel;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+
+	prvMapBlockSize( pxBlockToRemove->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+	if( pxBlockToRemove->pxNextFreeBlock != NULL )
+	{
+		pxBlockToRemove->pxNextFreeBlock->pxPrevFreeBlock = pxBlockToRemove->pxPrevFreeBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlockToRemove->pxPrevFreeBlock != NULL )
+	{
+		pxBlockToRemove->pxPrevFreeBlock->pxNextFreeBlock = pxBlockToRemove->pxNextFreeBlock;
+	}
+	else
+	{
+		/* The block was the head of its list.  If the list is now empty then
+		clear its bit, and the first level bit if the whole first level list is
+		now empty. */
+		pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlockToRemove->pxNextFreeBlock;
+
+		if( pxBlockToRemove->pxNextFreeBlock == NULL )
+		{
+			ulSecondLevelBitMaps[ uxFirstLevel ] &= ~( ( ( uint32_t ) 1U ) << uxSecondLevel );
+
+			if( ulSecondLevelBitMaps[ uxFirstLevel ] == 0UL )
+			{
+				ulFirstLevelBitMap &= ~( ( ( uint32_t ) 1U ) << uxFirstLevel );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( size_t xValue )
+{
+	#if defined( __GNUC__ )
+	{
+		return ( UBaseType_t ) ( ( ( sizeof( unsigned long ) * heapBITS_PER_BYTE ) - 1U ) - ( size_t ) __builtin_clzl( ( unsigned long ) xValue ) );
+	}
+	#else
+	{
+	UBaseType_t uxBit = 0;
+
+		while( ( xValue >>= 1 ) != 0 )
+		{
+			uxBit++;
+		}
+
+		return uxBit;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindFirstSet( uint32_t ulValue )
+{
+	#if defined( portCOUNT_TRAILING_ZEROS )
+	{
+		return portCOUNT_TRAILING_ZEROS( ulValue );
+	}
+	#else
+	{
+	UBaseType_t uxBit = 0;
+
+		while( ( ulValue & 0x01UL ) == 0UL )
+		{
+			ulValue >>= 1;
+			uxBit++;
+		}
+
+		return uxBit;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+BlockLink_t *pxBlock;
+UBaseType_t uxFirstLevel, uxSecondLevel;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+	vTaskSuspendAll();
+	{
+		/* Walk every free list that is not empty. */
+		for( uxFirstLevel = 0; uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT; uxFirstLevel++ )
+		{
+			for( uxSecondLevel = 0; uxSecondLevel < heapSECOND_LEVEL_INDEX_COUNT; uxSecondLevel++ )
+			{
+				for( pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+				{
+					xBlocks++;
+
+					if( pxBlock->xBlockSize > xMaxSize )
+					{
+						xMaxSize = pxBlock->xBlockSize;
+					}
+
+					if( pxBlock->xBlockSize < xMinSize )
+					{
+						xMinSize = pxBlock->xBlockSize;
+					}
+				}
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+	taskENTER_CRITICAL();
+	{
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+	}
+	taskEXIT_CRITICAL();
+}
+
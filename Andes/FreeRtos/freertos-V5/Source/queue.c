@@ -36,6 +36,19 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "slab.h"
+
+#if ( configUSE_FAST_SEMAPHORES == 1 )
+	#include "atomic.h"
+#endif
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+	#include "stream_buffer.h"
+#endif
+
+#if ( ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) && ( configUSE_RW_LOCKS == 1 ) )
+	#include "rwlock.h"
+#endif
 
 #if ( configUSE_CO_ROUTINES == 1 )
 	#include "croutine.h"
@@ -74,13 +87,47 @@ typedef struct SemaphoreData
 {
 	TaskHandle_t xMutexHolder;		 /*< The handle of the task that holds the mutex. */
 	UBaseType_t uxRecursiveCallCount;/*< Maintains a count of the number of times a recursive mutex has been recursively 'taken' when the structure is used as a mutex. */
+
+	#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+		struct QueueDefinition *pxNextHeldMutex; /*< The next mutex held by the same task.  The list starts in the holder's TCB. */
+	#endif
+
+	#if ( configUSE_CEILING_MUTEXES == 1 )
+		UBaseType_t uxCeilingPriority;	/*< The priority a task is raised to while it holds the mutex, or queueNO_CEILING_PRIORITY if the mutex uses priority inheritance. */
+	#endif
 } SemaphoreData_t;
 
+/* A priority ceiling mutex raises its holder to the ceiling priority as soon as
+it is taken, so never needs the holder to inherit the priority of a task that is
+waiting for it. */
+#define queueNO_CEILING_PRIORITY		( ( UBaseType_t ) configMAX_PRIORITIES )
+
+#if ( configUSE_CEILING_MUTEXES == 1 )
+	#define queueIS_CEILING_MUTEX( pxQueue ) ( ( ( pxQueue )->u.xSemaphore.uxCeilingPriority != queueNO_CEILING_PRIORITY ) ? pdTRUE : pdFALSE )
+#else
+	#define queueIS_CEILING_MUTEX( pxQueue ) pdFALSE
+#endif
+
+#if ( configUSE_QUEUE_SETS == 1 )
+	#define queueIS_QUEUE_SET_MEMBER( pxQueue ) ( ( ( pxQueue )->pxQueueSetContainer != NULL ) ? pdTRUE : pdFALSE )
+#else
+	#define queueIS_QUEUE_SET_MEMBER( pxQueue ) pdFALSE
+#endif
+
 /* Semaphores do not actually store or copy data, so have an item size of
 zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH ( ( UBaseType_t ) 0 )
 #define queueMUTEX_GIVE_BLOCK_TIME		 ( ( TickType_t ) 0U )
 
+/* The count of a fast semaphore is held in ulFastCount, which is only ever
+updated atomically.  A negative count is the number of tasks that are blocked,
+or about to block, on the semaphore.  Those tasks block on the queue itself,
+which is used as an unbounded counting semaphore through which the tasks that
+give the semaphore pass wake ups. */
+#define queueFAST_SEMAPHORE_MAX_COUNT	( ( UBaseType_t ) 0x7fffffffUL )
+#define queueFAST_SEMAPHORE_LENGTH		( ( UBaseType_t ) 0x7fffffffUL )
+#define queueNOT_FAST_SEMAPHORE			( ( UBaseType_t ) 0 )
+
 #if( configUSE_PREEMPTION == 0 )
 	/* If the cooperative scheduler is being used then a yield should not be
 	performed just because a higher priority task has been woken. */
@@ -89,6 +136,49 @@ zero. */
 	#define queueYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
 #endif
 
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	/* A bitmap queue set does not store events.  Its storage area holds a
+	QueueSetHeader_t, followed by one QueueSetMember_t per member slot, followed
+	by the ready bit map, which has one bit per member slot.  Bit n of
+	ulReadyGroups is set when word n of the ready bit map is not zero, so a
+	ready member is found with two count trailing zeros operations. */
+	typedef struct QueueSetHeader
+	{
+		UBaseType_t uxMaxMembers;		/*< The number of member slots. */
+		UBaseType_t uxNextToSelect;		/*< The slot at which the next search for a ready member starts. */
+		uint32_t ulReadyGroups;			/*< Summary of the non-zero words in the ready bit map. */
+	} QueueSetHeader_t;
+
+	typedef struct QueueSetMember
+	{
+		void *pvMember;					/*< The queue, semaphore or stream buffer held in the slot, or NULL if the slot is free. */
+		uint8_t ucMemberType;			/*< queueSET_MEMBER_TYPE_QUEUE or queueSET_MEMBER_TYPE_STREAM_BUFFER. */
+	} QueueSetMember_t;
+
+	#define queueSET_BITS_PER_GROUP			( ( UBaseType_t ) 32U )
+	#define queueSET_MAX_MEMBERS			( queueSET_BITS_PER_GROUP * queueSET_BITS_PER_GROUP )
+	#define queueSET_GROUPS( uxMembers )	( ( ( uxMembers ) + ( queueSET_BITS_PER_GROUP - ( UBaseType_t ) 1U ) ) / queueSET_BITS_PER_GROUP )
+
+	#define queueSET_HEADER( pxQueueSet )		( ( QueueSetHeader_t * ) ( pxQueueSet )->pcHead )
+	#define queueSET_MEMBERS( pxQueueSet )		( ( QueueSetMember_t * ) ( queueSET_HEADER( pxQueueSet ) + 1 ) )
+	#define queueSET_READY_BITS( pxQueueSet )	( ( uint32_t * ) ( queueSET_MEMBERS( pxQueueSet ) + queueSET_HEADER( pxQueueSet )->uxMaxMembers ) )
+
+	/* A set can have many more members than cTxLock can count, so stop
+	counting once that many waiting tasks would be unblocked anyway. */
+	#define queueSET_MAX_TX_LOCK			( ( int8_t ) 0x7f )
+
+	/* Ports that have a count trailing zeros instruction define
+	portCOUNT_TRAILING_ZEROS() in portmacro.h. */
+	#ifndef portCOUNT_TRAILING_ZEROS
+		#define queueUSE_GENERIC_COUNT_TRAILING_ZEROS	1
+		#define portCOUNT_TRAILING_ZEROS( ulBits )		prvCountTrailingZeros( ulBits )
+	#else
+		#define queueUSE_GENERIC_COUNT_TRAILING_ZEROS	0
+	#endif
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+
 /*
  * Definition of the queue used by the scheduler.
  * Items are queued by copy, not reference.  See the following link for the
@@ -115,12 +205,20 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 	volatile int8_t cRxLock;		/*< Stores the number of items received from the queue (removed from the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
 	volatile int8_t cTxLock;		/*< Stores the number of items transmitted to the queue (added to the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
 
+	#if( configUSE_FAST_SEMAPHORES == 1 )
+		volatile uint32_t ulFastCount;	/*< The count of a fast semaphore, read as a signed value.  Only accessed through the functions in atomic.h. */
+		UBaseType_t uxFastMaxCount;		/*< The maximum count of a fast semaphore, or queueNOT_FAST_SEMAPHORE if the queue is not a fast semaphore. */
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucStaticallyAllocated;	/*< Set to pdTRUE if the memory used by the queue was statically allocated to ensure no attempt is made to free the memory. */
 	#endif
 
 	#if ( configUSE_QUEUE_SETS == 1 )
 		struct QueueDefinition *pxQueueSetContainer;
+		#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+			UBaseType_t uxQueueSetIndex;	/*< The slot the queue occupies in its queue set. */
+		#endif
 	#endif
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -206,12 +304,54 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+	/*
+	 * Returns a member of a bitmap queue set that holds data, clearing the
+	 * ready bits of any members that are found to be empty on the way, or NULL
+	 * if no member holds data.  Must be called from a critical section.
+	 */
+	static QueueSetMemberHandle_t prvSelectFromQueueSet( Queue_t * const pxQueueSet ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Returns the index of the first member at or after uxNextToSelect, wrapping
+	 * around, that has its ready bit set.  At least one ready bit must be set.
+	 */
+	static UBaseType_t prvFindReadyQueueSetMember( const QueueSetHeader_t * const pxHeader, const uint32_t * const pulReadyBits ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Returns pdTRUE if the set member holds data.
+	 */
+	static BaseType_t prvIsQueueSetMemberReady( const QueueSetMember_t * const pxMember ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Clears the ready bit of a set member.
+	 */
+	static void prvClearQueueSetReadyBit( Queue_t * const pxQueueSet, const UBaseType_t uxMemberIndex ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Uses a critical section to determine if any member of a bitmap queue set
+	 * has its ready bit set.
+	 */
+	static BaseType_t prvIsQueueSetEmpty( const Queue_t *pxQueueSet ) PRIVILEGED_FUNCTION;
+
+	#if( queueUSE_GENERIC_COUNT_TRAILING_ZEROS == 1 )
+		static UBaseType_t prvCountTrailingZeros( uint32_t ulBits ) PRIVILEGED_FUNCTION;
+	#endif
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
  */
 static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, const uint8_t ucQueueType, Queue_t *pxNewQueue ) PRIVILEGED_FUNCTION;
 
+/*
+ * Free the memory used by a dynamically allocated queue.
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	static void prvFreeQueueMemory( Queue_t *pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Mutexes are a special type of queue.  When a mutex is created, first the
  * queue is created, then prvInitialiseMutex() is called to configure the queue
@@ -231,6 +371,58 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	 */
 	static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	/*
+	 * Add a mutex that has just been taken to the list of mutexes held by its
+	 * new holder, and remove it again when it is given back.
+	 */
+	static void prvAddMutexToHeldList( Queue_t * const pxMutex ) PRIVILEGED_FUNCTION;
+	static void prvRemoveMutexFromHeldList( Queue_t * const pxMutex ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Returns the priority of the highest priority task waiting for any of the
+	 * mutexes, or reader-writer locks held for writing, held by xMutexHolder,
+	 * which is the priority xMutexHolder should inherit.
+	 */
+	static UBaseType_t prvGetHighestPriorityOfHeldMutexWaiters( TaskHandle_t const xMutexHolder ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Recalculate the priority of xMutexHolder, then of the holder of the mutex
+	 * or reader-writer lock that task is blocked on, and so on along the chain
+	 * of blocked holders until a priority no longer changes.
+	 */
+	static void prvUpdateInheritanceChain( TaskHandle_t xMutexHolder ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Returns the holder of the mutex, or the write holder of the reader-writer
+	 * lock, that xTask is blocked on, or NULL if xTask is not blocked on a held
+	 * mutex or on a lock held for writing.
+	 */
+	static TaskHandle_t prvGetBlockingHolder( TaskHandle_t const xTask ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configUSE_FAST_SEMAPHORES == 1 )
+	/*
+	 * Called after a queue has been created to configure it as a fast
+	 * semaphore.
+	 */
+	static void prvInitialiseFastSemaphore( Queue_t *pxNewQueue, const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called when a task that was counted as waiting for a fast semaphore
+	 * times out.  Returns pdPASS if a give had already counted the task as
+	 * woken, in which case the task obtained the semaphore after all.
+	 */
+	static BaseType_t prvFastSemaphoreTimedOut( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Increment the count of a fast semaphore if it is below its maximum.
+	 * *pxWakeUpRequired is set to pdTRUE if a task was waiting for the
+	 * semaphore.
+	 */
+	static BaseType_t prvIncrementFastSemaphore( Queue_t * const pxQueue, BaseType_t * const pxWakeUpRequired ) PRIVILEGED_FUNCTION;
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -386,15 +578,54 @@ Queue_t * const pxQueue = xQueue;
 		is an int8_t *.  Therefore, whenever the stack alignment requirements
 		are greater than or equal to the pointer to char requirements the cast
 		is safe.  In other cases alignment requirements are not strict (one or
-		two bytes). */
-		pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
+		two bytes).  If configUSE_KERNEL_OBJECT_SLABS is 1 then the queue
+		structure is allocated from the queue slab cache instead, and the storage
+		area, if any, is allocated separately. */
+		#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+		{
+			pxNewQueue = ( Queue_t * ) slabALLOCATE_OBJECT( eSlabCacheQueue, sizeof( Queue_t ) ); /*lint !e9087 !e9079 see comment above. */
+			pucQueueStorage = NULL;
+
+			if( ( pxNewQueue != NULL ) && ( xQueueSizeInBytes > ( size_t ) 0 ) )
+			{
+				pucQueueStorage = ( uint8_t * ) pvPortMallocKernelObject( xQueueSizeInBytes ); /*lint !e9079 malloc() only returns void*. */
+
+				if( pucQueueStorage == NULL )
+				{
+					slabFREE_OBJECT( eSlabCacheQueue, pxNewQueue );
+					pxNewQueue = NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			pxNewQueue = ( Queue_t * ) pvPortMallocKernelObject( portKERNEL_OBJECT_SIZE( sizeof( Queue_t ) ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
+
+			if( pxNewQueue != NULL )
+			{
+				/* Jump past the queue structure to find the location of the
+				queue storage area, which is aligned in the same way as the
+				structure. */
+				pucQueueStorage = ( uint8_t * ) pxNewQueue;
+				pucQueueStorage += portKERNEL_OBJECT_SIZE( sizeof( Queue_t ) ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+			}
+			else
+			{
+				pucQueueStorage = NULL;
+			}
+		}
+		#endif /* configUSE_KERNEL_OBJECT_SLABS */
 
 		if( pxNewQueue != NULL )
 		{
-			/* Jump past the queue structure to find the location of the queue
-			storage area. */
-			pucQueueStorage = ( uint8_t * ) pxNewQueue;
-			pucQueueStorage += sizeof( Queue_t ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
@@ -419,6 +650,38 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	static void prvFreeQueueMemory( Queue_t *pxQueue )
+	{
+		#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+		{
+			/* The storage area was allocated separately from the queue
+			structure.  Queues with a zero item size (semaphores and mutexes)
+			have no storage area, and pcHead does not point to one. */
+			if( pxQueue->uxItemSize > ( UBaseType_t ) 0 )
+			{
+				vPortFree( pxQueue->pcHead );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			slabFREE_OBJECT( eSlabCacheQueue, pxQueue );
+		}
+		#else
+		{
+			/* The queue structure and storage area were allocated in a single
+			block. */
+			vPortFree( pxQueue );
+		}
+		#endif /* configUSE_KERNEL_OBJECT_SLABS */
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, const uint8_t ucQueueType, Queue_t *pxNewQueue )
 {
 	/* Remove compiler warnings about unused parameters should
@@ -457,6 +720,13 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if( configUSE_FAST_SEMAPHORES == 1 )
+	{
+		pxNewQueue->ulFastCount = 0U;
+		pxNewQueue->uxFastMaxCount = queueNOT_FAST_SEMAPHORE;
+	}
+	#endif /* configUSE_FAST_SEMAPHORES */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -477,6 +747,20 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 			/* In case this is a recursive mutex. */
 			pxNewQueue->u.xSemaphore.uxRecursiveCallCount = 0;
 
+			#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+			{
+				pxNewQueue->u.xSemaphore.pxNextHeldMutex = NULL;
+			}
+			#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+			#if( configUSE_CEILING_MUTEXES == 1 )
+			{
+				/* Changed by the create function if this is a priority ceiling
+				mutex. */
+				pxNewQueue->u.xSemaphore.uxCeilingPriority = queueNO_CEILING_PRIORITY;
+			}
+			#endif /* configUSE_CEILING_MUTEXES */
+
 			traceCREATE_MUTEX( pxNewQueue );
 
 			/* Start with the semaphore in the expected state. */
@@ -527,161 +811,362 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
+#if( ( configUSE_CEILING_MUTEXES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 
-	TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore )
+	QueueHandle_t xQueueCreateCeilingMutex( const UBaseType_t uxCeilingPriority )
 	{
-	TaskHandle_t pxReturn;
-	Queue_t * const pxSemaphore = ( Queue_t * ) xSemaphore;
+	QueueHandle_t xNewQueue;
+	const UBaseType_t uxMutexLength = ( UBaseType_t ) 1, uxMutexSize = ( UBaseType_t ) 0;
 
-		/* This function is called by xSemaphoreGetMutexHolder(), and should not
-		be called directly.  Note:  This is a good way of determining if the
-		calling task is the mutex holder, but not a good way of determining the
-		identity of the mutex holder, as the holder may change between the
-		following critical section exiting and the function returning. */
-		taskENTER_CRITICAL();
+		configASSERT( uxCeilingPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+		xNewQueue = xQueueGenericCreate( uxMutexLength, uxMutexSize, queueQUEUE_TYPE_CEILING_MUTEX );
+		prvInitialiseMutex( ( Queue_t * ) xNewQueue );
+
+		if( xNewQueue != NULL )
 		{
-			if( pxSemaphore->uxQueueType == queueQUEUE_IS_MUTEX )
-			{
-				pxReturn = pxSemaphore->u.xSemaphore.xMutexHolder;
-			}
-			else
-			{
-				pxReturn = NULL;
-			}
+			( ( Queue_t * ) xNewQueue )->u.xSemaphore.uxCeilingPriority = uxCeilingPriority;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
 		}
-		taskEXIT_CRITICAL();
 
-		return pxReturn;
-	} /*lint !e818 xSemaphore cannot be a pointer to const because it is a typedef. */
+		return xNewQueue;
+	}
 
-#endif
+#endif /* configUSE_CEILING_MUTEXES */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
+#if( ( configUSE_CEILING_MUTEXES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
 
-	TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore )
+	QueueHandle_t xQueueCreateCeilingMutexStatic( const UBaseType_t uxCeilingPriority, StaticQueue_t *pxStaticQueue )
 	{
-	TaskHandle_t pxReturn;
+	QueueHandle_t xNewQueue;
+	const UBaseType_t uxMutexLength = ( UBaseType_t ) 1, uxMutexSize = ( UBaseType_t ) 0;
 
-		configASSERT( xSemaphore );
+		configASSERT( uxCeilingPriority < ( UBaseType_t ) configMAX_PRIORITIES );
 
-		/* Mutexes cannot be used in interrupt service routines, so the mutex
-		holder should not change in an ISR, and therefore a critical section is
-		not required here. */
-		if( ( ( Queue_t * ) xSemaphore )->uxQueueType == queueQUEUE_IS_MUTEX )
+		xNewQueue = xQueueGenericCreateStatic( uxMutexLength, uxMutexSize, NULL, pxStaticQueue, queueQUEUE_TYPE_CEILING_MUTEX );
+		prvInitialiseMutex( ( Queue_t * ) xNewQueue );
+
+		if( xNewQueue != NULL )
 		{
-			pxReturn = ( ( Queue_t * ) xSemaphore )->u.xSemaphore.xMutexHolder;
+			( ( Queue_t * ) xNewQueue )->u.xSemaphore.uxCeilingPriority = uxCeilingPriority;
 		}
 		else
 		{
-			pxReturn = NULL;
+			mtCOVERAGE_TEST_MARKER();
 		}
 
-		return pxReturn;
-	} /*lint !e818 xSemaphore cannot be a pointer to const because it is a typedef. */
+		return xNewQueue;
+	}
 
-#endif
+#endif /* configUSE_CEILING_MUTEXES */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_RECURSIVE_MUTEXES == 1 )
+#if( configUSE_CEILING_MUTEXES == 1 )
 
-	BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex )
+	BaseType_t xQueueCeilingMutexTake( QueueHandle_t xMutex, TickType_t xTicksToWait )
 	{
-	BaseType_t xReturn;
-	Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+	Queue_t * const pxMutex = xMutex;
+	BaseType_t xReturn = pdFAIL;
 
 		configASSERT( pxMutex );
+		configASSERT( queueIS_CEILING_MUTEX( pxMutex ) != pdFALSE );
 
-		/* If this is the task that holds the mutex then xMutexHolder will not
-		change outside of this task.  If this task does not hold the mutex then
-		pxMutexHolder can never coincidentally equal the tasks handle, and as
-		this is the only condition we are interested in it does not matter if
-		pxMutexHolder is accessed simultaneously by another task.  Therefore no
-		mutual exclusion is required to test the pxMutexHolder variable. */
-		if( pxMutex->u.xSemaphore.xMutexHolder == xTaskGetCurrentTaskHandle() )
+		/* The holder of a ceiling mutex runs at the ceiling, so there is never
+		a priority to pass on to it, and the mutex can be taken and the
+		caller's priority raised in a single short critical section. */
+		taskENTER_CRITICAL();
 		{
-			traceGIVE_MUTEX_RECURSIVE( pxMutex );
+			if( pxMutex->uxMessagesWaiting != ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_RECEIVE( pxMutex );
 
-			/* uxRecursiveCallCount cannot be zero if xMutexHolder is equal to
-			the task handle, therefore no underflow check is required.  Also,
-			uxRecursiveCallCount is only modified by the mutex holder, and as
-			there can only be one, no mutual exclusion is required to modify the
-			uxRecursiveCallCount member. */
-			( pxMutex->u.xSemaphore.uxRecursiveCallCount )--;
+				pxMutex->uxMessagesWaiting = ( UBaseType_t ) 0;
+				pxMutex->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
 
-			/* Has the recursive call count unwound to 0? */
-			if( pxMutex->u.xSemaphore.uxRecursiveCallCount == ( UBaseType_t ) 0 )
-			{
-				/* Return the mutex.  This will automatically unblock any other
-				task that might be waiting to access the mutex. */
-				( void ) xQueueGenericSend( pxMutex, NULL, queueMUTEX_GIVE_BLOCK_TIME, queueSEND_TO_BACK );
+				#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					/* The ceiling must be included should the holder recalculate
+					its priority after giving back a different mutex. */
+					prvAddMutexToHeldList( pxMutex );
+				}
+				#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+				vTaskPriorityRaiseToCeiling( pxMutex->u.xSemaphore.uxCeilingPriority );
+				xReturn = pdPASS;
 			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
+		}
+		taskEXIT_CRITICAL();
 
-			xReturn = pdPASS;
+		if( xReturn == pdFAIL )
+		{
+			/* The mutex is held, so use the generic path to wait for it, or to
+			fail if xTicksToWait is 0. */
+			xReturn = xQueueSemaphoreTake( xMutex, xTicksToWait );
 		}
 		else
 		{
-			/* The mutex cannot be given because the calling task is not the
-			holder. */
-			xReturn = pdFAIL;
-
-			traceGIVE_MUTEX_RECURSIVE_FAILED( pxMutex );
+			mtCOVERAGE_TEST_MARKER();
 		}
 
 		return xReturn;
 	}
 
-#endif /* configUSE_RECURSIVE_MUTEXES */
+#endif /* configUSE_CEILING_MUTEXES */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_RECURSIVE_MUTEXES == 1 )
+#if( configUSE_CEILING_MUTEXES == 1 )
 
-	BaseType_t xQueueTakeMutexRecursive( QueueHandle_t xMutex, TickType_t xTicksToWait )
+	BaseType_t xQueueCeilingMutexGive( QueueHandle_t xMutex )
 	{
-	BaseType_t xReturn;
-	Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+	Queue_t * const pxMutex = xMutex;
+	BaseType_t xReturn = pdFAIL, xYieldRequired;
+	TaskHandle_t xMutexHolder;
 
 		configASSERT( pxMutex );
+		configASSERT( queueIS_CEILING_MUTEX( pxMutex ) != pdFALSE );
 
-		/* Comments regarding mutual exclusion as per those within
-		xQueueGiveMutexRecursive(). */
-
-		traceTAKE_MUTEX_RECURSIVE( pxMutex );
-
-		if( pxMutex->u.xSemaphore.xMutexHolder == xTaskGetCurrentTaskHandle() )
-		{
-			( pxMutex->u.xSemaphore.uxRecursiveCallCount )++;
-			xReturn = pdPASS;
-		}
-		else
+		taskENTER_CRITICAL();
 		{
-			xReturn = xQueueSemaphoreTake( pxMutex, xTicksToWait );
-
-			/* pdPASS will only be returned if the mutex was successfully
-			obtained.  The calling task may have entered the Blocked state
-			before reaching here. */
-			if( xReturn != pdFAIL )
-			{
-				( pxMutex->u.xSemaphore.uxRecursiveCallCount )++;
-			}
-			else
+			/* Only the common case of a held mutex that no task is waiting
+			for is handled here.  Waking a waiting task, and notifying a queue
+			set, are left to the generic path. */
+			if( ( pxMutex->uxMessagesWaiting == ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxMutex->xTasksWaitingToReceive ) ) != pdFALSE ) && ( queueIS_QUEUE_SET_MEMBER( pxMutex ) == pdFALSE ) )
 			{
-				traceTAKE_MUTEX_RECURSIVE_FAILED( pxMutex );
-			}
-		}
-
-		return xReturn;
-	}
+				traceQUEUE_SEND( pxMutex );
 
-#endif /* configUSE_RECURSIVE_MUTEXES */
-/*-----------------------------------------------------------*/
+				xMutexHolder = pxMutex->u.xSemaphore.xMutexHolder;
 
-#if( ( configUSE_COUNTING_SEMAPHORES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+				#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					if( xMutexHolder != NULL )
+					{
+						prvRemoveMutexFromHeldList( pxMutex );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+				/* Drops the holder back to its base priority if this was the
+				last mutex it held. */
+				xYieldRequired = xTaskPriorityDisinherit( xMutexHolder );
+
+				#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					/* If other mutexes are still held the holder drops to the
+					highest priority it inherits through them instead. */
+					if( ( xYieldRequired == pdFALSE ) && ( xMutexHolder != NULL ) )
+					{
+						xYieldRequired = xTaskPriorityInheritanceUpdate( xMutexHolder, prvGetHighestPriorityOfHeldMutexWaiters( xMutexHolder ) );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+				pxMutex->u.xSemaphore.xMutexHolder = NULL;
+				pxMutex->uxMessagesWaiting = ( UBaseType_t ) 1;
+
+				if( xYieldRequired != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xReturn == pdFAIL )
+		{
+			xReturn = xQueueGenericSend( xMutex, NULL, queueMUTEX_GIVE_BLOCK_TIME, queueSEND_TO_BACK );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
+
+	TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore )
+	{
+	TaskHandle_t pxReturn;
+	Queue_t * const pxSemaphore = ( Queue_t * ) xSemaphore;
+
+		/* This function is called by xSemaphoreGetMutexHolder(), and should not
+		be called directly.  Note:  This is a good way of determining if the
+		calling task is the mutex holder, but not a good way of determining the
+		identity of the mutex holder, as the holder may change between the
+		following critical section exiting and the function returning. */
+		taskENTER_CRITICAL();
+		{
+			if( pxSemaphore->uxQueueType == queueQUEUE_IS_MUTEX )
+			{
+				pxReturn = pxSemaphore->u.xSemaphore.xMutexHolder;
+			}
+			else
+			{
+				pxReturn = NULL;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return pxReturn;
+	} /*lint !e818 xSemaphore cannot be a pointer to const because it is a typedef. */
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
+
+	TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore )
+	{
+	TaskHandle_t pxReturn;
+
+		configASSERT( xSemaphore );
+
+		/* Mutexes cannot be used in interrupt service routines, so the mutex
+		holder should not change in an ISR, and therefore a critical section is
+		not required here. */
+		if( ( ( Queue_t * ) xSemaphore )->uxQueueType == queueQUEUE_IS_MUTEX )
+		{
+			pxReturn = ( ( Queue_t * ) xSemaphore )->u.xSemaphore.xMutexHolder;
+		}
+		else
+		{
+			pxReturn = NULL;
+		}
+
+		return pxReturn;
+	} /*lint !e818 xSemaphore cannot be a pointer to const because it is a typedef. */
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_RECURSIVE_MUTEXES == 1 )
+
+	BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex )
+	{
+	BaseType_t xReturn;
+	Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+
+		configASSERT( pxMutex );
+
+		/* If this is the task that holds the mutex then xMutexHolder will not
+		change outside of this task.  If this task does not hold the mutex then
+		pxMutexHolder can never coincidentally equal the tasks handle, and as
+		this is the only condition we are interested in it does not matter if
+		pxMutexHolder is accessed simultaneously by another task.  Therefore no
+		mutual exclusion is required to test the pxMutexHolder variable. */
+		if( pxMutex->u.xSemaphore.xMutexHolder == xTaskGetCurrentTaskHandle() )
+		{
+			traceGIVE_MUTEX_RECURSIVE( pxMutex );
+
+			/* uxRecursiveCallCount cannot be zero if xMutexHolder is equal to
+			the task handle, therefore no underflow check is required.  Also,
+			uxRecursiveCallCount is only modified by the mutex holder, and as
+			there can only be one, no mutual exclusion is required to modify the
+			uxRecursiveCallCount member. */
+			( pxMutex->u.xSemaphore.uxRecursiveCallCount )--;
+
+			/* Has the recursive call count unwound to 0? */
+			if( pxMutex->u.xSemaphore.uxRecursiveCallCount == ( UBaseType_t ) 0 )
+			{
+				/* Return the mutex.  This will automatically unblock any other
+				task that might be waiting to access the mutex. */
+				( void ) xQueueGenericSend( pxMutex, NULL, queueMUTEX_GIVE_BLOCK_TIME, queueSEND_TO_BACK );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			/* The mutex cannot be given because the calling task is not the
+			holder. */
+			xReturn = pdFAIL;
+
+			traceGIVE_MUTEX_RECURSIVE_FAILED( pxMutex );
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_RECURSIVE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_RECURSIVE_MUTEXES == 1 )
+
+	BaseType_t xQueueTakeMutexRecursive( QueueHandle_t xMutex, TickType_t xTicksToWait )
+	{
+	BaseType_t xReturn;
+	Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+
+		configASSERT( pxMutex );
+
+		/* Comments regarding mutual exclusion as per those within
+		xQueueGiveMutexRecursive(). */
+
+		traceTAKE_MUTEX_RECURSIVE( pxMutex );
+
+		if( pxMutex->u.xSemaphore.xMutexHolder == xTaskGetCurrentTaskHandle() )
+		{
+			( pxMutex->u.xSemaphore.uxRecursiveCallCount )++;
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = xQueueSemaphoreTake( pxMutex, xTicksToWait );
+
+			/* pdPASS will only be returned if the mutex was successfully
+			obtained.  The calling task may have entered the Blocked state
+			before reaching here. */
+			if( xReturn != pdFAIL )
+			{
+				( pxMutex->u.xSemaphore.uxRecursiveCallCount )++;
+			}
+			else
+			{
+				traceTAKE_MUTEX_RECURSIVE_FAILED( pxMutex );
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_RECURSIVE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_COUNTING_SEMAPHORES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
 
 	QueueHandle_t xQueueCreateCountingSemaphoreStatic( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount, StaticQueue_t *pxStaticQueue )
 	{
@@ -737,6 +1222,66 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 #endif /* ( ( configUSE_COUNTING_SEMAPHORES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+	static void prvInitialiseFastSemaphore( Queue_t *pxNewQueue, const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount )
+	{
+		if( pxNewQueue != NULL )
+		{
+			/* The queue's own count starts at zero as it only holds wake ups
+			for tasks that had to block. */
+			pxNewQueue->ulFastCount = ( uint32_t ) uxInitialCount;
+			pxNewQueue->uxFastMaxCount = uxMaxCount;
+
+			traceCREATE_COUNTING_SEMAPHORE();
+		}
+		else
+		{
+			traceCREATE_COUNTING_SEMAPHORE_FAILED();
+		}
+	}
+
+#endif /* configUSE_FAST_SEMAPHORES */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_FAST_SEMAPHORES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreateFastSemaphore( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount )
+	{
+	QueueHandle_t xHandle;
+
+		configASSERT( uxMaxCount != 0 );
+		configASSERT( uxMaxCount <= queueFAST_SEMAPHORE_MAX_COUNT );
+		configASSERT( uxInitialCount <= uxMaxCount );
+
+		xHandle = xQueueGenericCreate( queueFAST_SEMAPHORE_LENGTH, queueSEMAPHORE_QUEUE_ITEM_LENGTH, queueQUEUE_TYPE_FAST_SEMAPHORE );
+		prvInitialiseFastSemaphore( ( Queue_t * ) xHandle, uxMaxCount, uxInitialCount );
+
+		return xHandle;
+	}
+
+#endif /* ( ( configUSE_FAST_SEMAPHORES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_FAST_SEMAPHORES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreateFastSemaphoreStatic( const UBaseType_t uxMaxCount, const UBaseType_t uxInitialCount, StaticQueue_t *pxStaticQueue )
+	{
+	QueueHandle_t xHandle;
+
+		configASSERT( uxMaxCount != 0 );
+		configASSERT( uxMaxCount <= queueFAST_SEMAPHORE_MAX_COUNT );
+		configASSERT( uxInitialCount <= uxMaxCount );
+
+		xHandle = xQueueGenericCreateStatic( queueFAST_SEMAPHORE_LENGTH, queueSEMAPHORE_QUEUE_ITEM_LENGTH, NULL, pxStaticQueue, queueQUEUE_TYPE_FAST_SEMAPHORE );
+		prvInitialiseFastSemaphore( ( Queue_t * ) xHandle, uxMaxCount, uxInitialCount );
+
+		return xHandle;
+	}
+
+#endif /* ( ( configUSE_FAST_SEMAPHORES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait, const BaseType_t xCopyPosition )
 {
 BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
@@ -1468,18 +2013,41 @@ Queue_t * const pxQueue = xQueue;
 						/* Record the information required to implement
 						priority inheritance should it become necessary. */
 						pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
-				}
-				#endif /* configUSE_MUTEXES */
 
-				/* Check to see if other tasks are blocked waiting to give the
-				semaphore, and if so, unblock the highest priority such task. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
-				{
+						#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+						{
+							prvAddMutexToHeldList( pxQueue );
+							vTaskSetMutexBlockedOn( NULL );
+						}
+						#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+						#if ( configUSE_CEILING_MUTEXES == 1 )
+						{
+							/* A priority ceiling mutex raises the holder to
+							the ceiling now, so nothing needs to be done if
+							another task later blocks on the mutex. */
+							if( queueIS_CEILING_MUTEX( pxQueue ) != pdFALSE )
+							{
+								vTaskPriorityRaiseToCeiling( pxQueue->u.xSemaphore.uxCeilingPriority );
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						#endif /* configUSE_CEILING_MUTEXES */
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_MUTEXES */
+
+				/* Check to see if other tasks are blocked waiting to give the
+				semaphore, and if so, unblock the highest priority such task. */
+				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
 						queueYIELD_IF_USING_PREEMPTION();
@@ -1549,9 +2117,9 @@ Queue_t * const pxQueue = xQueue;
 			{
 				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
 
-				#if ( configUSE_MUTEXES == 1 )
+				#if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 0 ) )
 				{
-					if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+					if( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( queueIS_CEILING_MUTEX( pxQueue ) == pdFALSE ) )
 					{
 						taskENTER_CRITICAL();
 						{
@@ -1567,6 +2135,33 @@ Queue_t * const pxQueue = xQueue;
 				#endif
 
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+
+				#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					if( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( queueIS_CEILING_MUTEX( pxQueue ) == pdFALSE ) )
+					{
+						/* Now this task is in the mutex's waiting list its
+						priority can be passed to the mutex holder, and on to
+						the holder of any mutex the holder is itself blocked
+						on. */
+						taskENTER_CRITICAL();
+						{
+							vTaskSetMutexBlockedOn( pxQueue );
+							prvUpdateInheritanceChain( pxQueue->u.xSemaphore.xMutexHolder );
+						}
+						taskEXIT_CRITICAL();
+
+						/* Ensure the chain is recalculated should this task
+						time out. */
+						xInheritanceOccurred = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
 				prvUnlockQueue( pxQueue );
 				if( xTaskResumeAll() == pdFALSE )
 				{
@@ -1606,15 +2201,27 @@ Queue_t * const pxQueue = xQueue;
 					{
 						taskENTER_CRITICAL();
 						{
+							#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+							{
+								/* This task is no longer in the mutex's waiting
+								list, so recalculate the priority of every
+								holder along the chain without it. */
+								vTaskSetMutexBlockedOn( NULL );
+								prvUpdateInheritanceChain( pxQueue->u.xSemaphore.xMutexHolder );
+							}
+							#else
+							{
 							UBaseType_t uxHighestWaitingPriority;
 
-							/* This task blocking on the mutex caused another
-							task to inherit this task's priority.  Now this task
-							has timed out the priority should be disinherited
-							again, but only as low as the next highest priority
-							task that is waiting for the same mutex. */
-							uxHighestWaitingPriority = prvGetDisinheritPriorityAfterTimeout( pxQueue );
-							vTaskPriorityDisinheritAfterTimeout( pxQueue->u.xSemaphore.xMutexHolder, uxHighestWaitingPriority );
+								/* This task blocking on the mutex caused another
+								task to inherit this task's priority.  Now this task
+								has timed out the priority should be disinherited
+								again, but only as low as the next highest priority
+								task that is waiting for the same mutex. */
+								uxHighestWaitingPriority = prvGetDisinheritPriorityAfterTimeout( pxQueue );
+								vTaskPriorityDisinheritAfterTimeout( pxQueue->u.xSemaphore.xMutexHolder, uxHighestWaitingPriority );
+							}
+							#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
 						}
 						taskEXIT_CRITICAL();
 					}
@@ -1633,6 +2240,210 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+	BaseType_t xQueueFastSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
+	{
+	Queue_t * const pxQueue = xQueue;
+	BaseType_t xReturn = pdFAIL;
+	int32_t lCount;
+
+		configASSERT( pxQueue );
+		configASSERT( pxQueue->uxFastMaxCount != queueNOT_FAST_SEMAPHORE );
+
+		if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* Not going to block, so only decrement the count if it is
+			positive - the task must not be counted as a waiter. */
+			lCount = ( int32_t ) pxQueue->ulFastCount;
+
+			while( ( xReturn == pdFAIL ) && ( lCount > 0 ) )
+			{
+				if( Atomic_CompareAndSwap_u32( &( pxQueue->ulFastCount ), ( uint32_t ) ( lCount - 1 ), ( uint32_t ) lCount ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+				{
+					xReturn = pdPASS;
+				}
+				else
+				{
+					lCount = ( int32_t ) pxQueue->ulFastCount;
+				}
+			}
+
+			if( xReturn == pdPASS )
+			{
+				traceQUEUE_RECEIVE( pxQueue );
+			}
+			else
+			{
+				traceQUEUE_RECEIVE_FAILED( pxQueue );
+			}
+		}
+		else if( ( int32_t ) Atomic_Decrement_u32( &( pxQueue->ulFastCount ) ) > 0 )
+		{
+			/* The semaphore was available.  There is no need to enter a
+			critical section or touch the event lists. */
+			traceQUEUE_RECEIVE( pxQueue );
+			xReturn = pdPASS;
+		}
+		else
+		{
+			/* The semaphore was not available, and decrementing the count
+			recorded this task as waiting for it.  Block on the queue until a
+			task or interrupt that gives the semaphore passes on a wake up. */
+			xReturn = xQueueSemaphoreTake( xQueue, xTicksToWait );
+
+			if( xReturn == pdFAIL )
+			{
+				xReturn = prvFastSemaphoreTimedOut( pxQueue );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_FAST_SEMAPHORES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+	static BaseType_t prvFastSemaphoreTimedOut( Queue_t * const pxQueue )
+	{
+	BaseType_t xReturn = pdFAIL;
+	int32_t lCount;
+
+		/* Stop counting this task as a waiter, but only if the count is still
+		negative.  If it is not then a give has already counted this task as
+		woken, and the wake up it passes on must be consumed by this task or
+		the semaphore's count will be wrong. */
+		lCount = ( int32_t ) pxQueue->ulFastCount;
+
+		while( ( lCount < 0 ) && ( Atomic_CompareAndSwap_u32( &( pxQueue->ulFastCount ), ( uint32_t ) ( lCount + 1 ), ( uint32_t ) lCount ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+		{
+			lCount = ( int32_t ) pxQueue->ulFastCount;
+		}
+
+		if( lCount >= 0 )
+		{
+			/* The wake up is either already in the queue or the task giving
+			the semaphore is about to post it, so this will not block for
+			long. */
+			while( xQueueSemaphoreTake( pxQueue, portMAX_DELAY ) == pdFAIL )
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_FAST_SEMAPHORES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+	static BaseType_t prvIncrementFastSemaphore( Queue_t * const pxQueue, BaseType_t * const pxWakeUpRequired )
+	{
+	BaseType_t xReturn = pdPASS;
+	int32_t lCount;
+
+		configASSERT( pxQueue );
+		configASSERT( pxQueue->uxFastMaxCount != queueNOT_FAST_SEMAPHORE );
+
+		/* Increment the count unless it is already at its maximum. */
+		lCount = ( int32_t ) pxQueue->ulFastCount;
+
+		while( ( lCount < ( int32_t ) pxQueue->uxFastMaxCount ) && ( Atomic_CompareAndSwap_u32( &( pxQueue->ulFastCount ), ( uint32_t ) ( lCount + 1 ), ( uint32_t ) lCount ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+		{
+			lCount = ( int32_t ) pxQueue->ulFastCount;
+		}
+
+		if( lCount >= ( int32_t ) pxQueue->uxFastMaxCount )
+		{
+			xReturn = errQUEUE_FULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* A negative count means at least one task is blocked, or about to
+		block, on the queue, so needs to be passed a wake up. */
+		*pxWakeUpRequired = ( lCount < 0 ) ? pdTRUE : pdFALSE;
+
+		return xReturn;
+	}
+
+#endif /* configUSE_FAST_SEMAPHORES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+	BaseType_t xQueueFastSemaphoreGive( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = xQueue;
+	const TickType_t xTicksToWait = 0;
+	BaseType_t xReturn, xWakeUpRequired;
+
+		xReturn = prvIncrementFastSemaphore( pxQueue, &xWakeUpRequired );
+
+		if( xWakeUpRequired != pdFALSE )
+		{
+			/* The queue's length is such that this cannot fail. */
+			( void ) xQueueGenericSend( xQueue, NULL, xTicksToWait, queueSEND_TO_BACK );
+		}
+		else if( xReturn == pdPASS )
+		{
+			traceQUEUE_SEND( pxQueue );
+		}
+		else
+		{
+			traceQUEUE_SEND_FAILED( pxQueue );
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_FAST_SEMAPHORES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FAST_SEMAPHORES == 1 )
+
+	BaseType_t xQueueFastSemaphoreGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	Queue_t * const pxQueue = xQueue;
+	BaseType_t xReturn, xWakeUpRequired;
+
+		xReturn = prvIncrementFastSemaphore( pxQueue, &xWakeUpRequired );
+
+		if( xWakeUpRequired != pdFALSE )
+		{
+			( void ) xQueueGiveFromISR( xQueue, pxHigherPriorityTaskWoken );
+		}
+		else if( xReturn == pdPASS )
+		{
+			traceQUEUE_SEND_FROM_ISR( pxQueue );
+		}
+		else
+		{
+			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_FAST_SEMAPHORES */
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueuePeek( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
 {
 BaseType_t xEntryTimeSet = pdFALSE;
@@ -1985,11 +2796,25 @@ Queue_t * const pxQueue = xQueue;
 	}
 	#endif
 
+	#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+	{
+		/* Do not leave a deleted queue in the member table of a set. */
+		if( pxQueue->pxQueueSetContainer != NULL )
+		{
+			( void ) xQueueRemoveFromSet( pxQueue, pxQueue->pxQueueSetContainer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
 	{
 		/* The queue can only have been allocated dynamically - free it
 		again. */
-		vPortFree( pxQueue );
+		prvFreeQueueMemory( pxQueue );
 	}
 	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
 	{
@@ -1997,7 +2822,7 @@ Queue_t * const pxQueue = xQueue;
 		check before attempting to free the memory. */
 		if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
 		{
-			vPortFree( pxQueue );
+			prvFreeQueueMemory( pxQueue );
 		}
 		else
 		{
@@ -2071,100 +2896,337 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvItemToQueue, const BaseType_t xPosition )
-{
-BaseType_t xReturn = pdFALSE;
-UBaseType_t uxMessagesWaiting;
-
-	/* This function is called from a critical section. */
-
-	uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
 
-	if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
-	{
-		#if ( configUSE_MUTEXES == 1 )
-		{
-			if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
-			{
-				/* The mutex is no longer being held. */
-				xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
-				pxQueue->u.xSemaphore.xMutexHolder = NULL;
-			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
-		}
-		#endif /* configUSE_MUTEXES */
-	}
-	else if( xPosition == queueSEND_TO_BACK )
+	static void prvAddMutexToHeldList( Queue_t * const pxMutex )
 	{
-		( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
-		pxQueue->pcWriteTo += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
-		if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+	TaskHandle_t const xMutexHolder = pxMutex->u.xSemaphore.xMutexHolder;
+
+		/* The holder is NULL if the mutex was taken before any tasks were
+		created.  Mutexes are most often given back in the reverse order to
+		that in which they were taken, so add to the head of the list. */
+		if( xMutexHolder != NULL )
 		{
-			pxQueue->pcWriteTo = pxQueue->pcHead;
+			pxMutex->u.xSemaphore.pxNextHeldMutex = ( Queue_t * ) pvTaskGetMutexesHeld( xMutexHolder );
+			vTaskSetMutexesHeld( xMutexHolder, pxMutex );
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
 	}
-	else
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	static void prvRemoveMutexFromHeldList( Queue_t * const pxMutex )
 	{
-		( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e9087 !e418 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes.  Assert checks null pointer only used when length is 0. */
-		pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
-		if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
-		{
-			pxQueue->u.xQueue.pcReadFrom = ( pxQueue->u.xQueue.pcTail - pxQueue->uxItemSize );
-		}
-		else
+	TaskHandle_t const xMutexHolder = pxMutex->u.xSemaphore.xMutexHolder;
+	Queue_t *pxHeld, *pxPrevious = NULL;
+
+		pxHeld = ( Queue_t * ) pvTaskGetMutexesHeld( xMutexHolder );
+
+		while( ( pxHeld != NULL ) && ( pxHeld != pxMutex ) )
 		{
-			mtCOVERAGE_TEST_MARKER();
+			pxPrevious = pxHeld;
+			pxHeld = pxHeld->u.xSemaphore.pxNextHeldMutex;
 		}
 
-		if( xPosition == queueOVERWRITE )
+		if( pxHeld != NULL )
 		{
-			if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+			if( pxPrevious == NULL )
 			{
-				/* An item is not being added but overwritten, so subtract
-				one from the recorded number of items in the queue so when
-				one is added again below the number of recorded items remains
-				correct. */
-				--uxMessagesWaiting;
+				vTaskSetMutexesHeld( xMutexHolder, pxMutex->u.xSemaphore.pxNextHeldMutex );
 			}
 			else
 			{
-				mtCOVERAGE_TEST_MARKER();
+				pxPrevious->u.xSemaphore.pxNextHeldMutex = pxMutex->u.xSemaphore.pxNextHeldMutex;
 			}
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
-	}
 
-	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+		pxMutex->u.xSemaphore.pxNextHeldMutex = NULL;
+	}
 
-	return xReturn;
-}
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
 /*-----------------------------------------------------------*/
 
-static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
-{
-	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	static UBaseType_t prvGetHighestPriorityOfHeldMutexWaiters( TaskHandle_t const xMutexHolder )
 	{
-		pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
-		if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
-		{
-			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
-		}
-		else
+	const Queue_t *pxHeld;
+	UBaseType_t uxHighestPriority = tskIDLE_PRIORITY, uxPriority;
+
+		/* The head of each waiting list holds the highest priority waiting
+		task, so this is O(number of mutexes held), not O(number of waiting
+		tasks). */
+		for( pxHeld = ( const Queue_t * ) pvTaskGetMutexesHeld( xMutexHolder ); pxHeld != NULL; pxHeld = pxHeld->u.xSemaphore.pxNextHeldMutex )
 		{
-			mtCOVERAGE_TEST_MARKER();
-		}
-		( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
-	}
+			uxPriority = prvGetDisinheritPriorityAfterTimeout( pxHeld );
+
+			#if( configUSE_CEILING_MUTEXES == 1 )
+			{
+				/* The holder of a priority ceiling mutex runs at the ceiling
+				for as long as it holds the mutex. */
+				if( queueIS_CEILING_MUTEX( pxHeld ) != pdFALSE )
+				{
+					uxPriority = pxHeld->u.xSemaphore.uxCeilingPriority;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_CEILING_MUTEXES */
+
+			if( uxPriority > uxHighestPriority )
+			{
+				uxHighestPriority = uxPriority;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		#if( configUSE_RW_LOCKS == 1 )
+		{
+			/* Tasks waiting for a reader-writer lock held for writing pass
+			their priority to the write holder too, so giving a mutex must not
+			drop the priority inherited through a lock. */
+			uxPriority = uxRWLockGetHighestPriorityOfHeldLockWaiters( xMutexHolder );
+
+			if( uxPriority > uxHighestPriority )
+			{
+				uxHighestPriority = uxPriority;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_RW_LOCKS */
+
+		return uxHighestPriority;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	static void prvUpdateInheritanceChain( TaskHandle_t xMutexHolder )
+	{
+	BaseType_t xPriorityChanged = pdTRUE;
+	UBaseType_t uxDepth = 0;
+
+		/* This function is called from a critical section.  Stop as soon as a
+		holder's priority does not change, as nothing further along the chain
+		can change either.  configMAX_PRIORITY_INHERITANCE_DEPTH bounds the
+		time spent here, and guarantees the walk ends should the chain loop
+		back on itself because the tasks are deadlocked. */
+		while( ( xMutexHolder != NULL ) && ( xPriorityChanged != pdFALSE ) && ( uxDepth < ( UBaseType_t ) configMAX_PRIORITY_INHERITANCE_DEPTH ) )
+		{
+			xPriorityChanged = xTaskPriorityInheritanceUpdate( xMutexHolder, prvGetHighestPriorityOfHeldMutexWaiters( xMutexHolder ) );
+			xMutexHolder = prvGetBlockingHolder( xMutexHolder );
+			uxDepth++;
+		}
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	static TaskHandle_t prvGetBlockingHolder( TaskHandle_t const xTask )
+	{
+	const Queue_t * const pxMutex = ( const Queue_t * ) pvTaskGetMutexBlockedOn( xTask );
+	TaskHandle_t xHolder = NULL;
+
+		if( pxMutex != NULL )
+		{
+			xHolder = pxMutex->u.xSemaphore.xMutexHolder;
+		}
+		else
+		{
+			#if( configUSE_RW_LOCKS == 1 )
+			{
+			void * const pvRWLock = pvTaskGetRWLockBlockedOn( xTask );
+
+				/* A lock held for reading has no write holder, and readers
+				are not recorded, so the chain ends there. */
+				if( pvRWLock != NULL )
+				{
+					xHolder = xRWLockGetWriteHolder( ( RWLockHandle_t ) pvRWLock );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_RW_LOCKS */
+		}
+
+		return xHolder;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	BaseType_t xQueueUpdateMutexHolderPriority( TaskHandle_t const xMutexHolder )
+	{
+	BaseType_t xReturn;
+
+		/* This function is called from a critical section. */
+		xReturn = xTaskPriorityInheritanceUpdate( xMutexHolder, prvGetHighestPriorityOfHeldMutexWaiters( xMutexHolder ) );
+
+		if( xReturn != pdFALSE )
+		{
+			/* The holder might itself be waiting for a mutex or a lock, in
+			which case the holder of that mutex or lock inherits the change
+			too. */
+			prvUpdateInheritanceChain( prvGetBlockingHolder( xMutexHolder ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvItemToQueue, const BaseType_t xPosition )
+{
+BaseType_t xReturn = pdFALSE;
+UBaseType_t uxMessagesWaiting;
+
+	/* This function is called from a critical section. */
+
+	uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+	if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
+	{
+		#if ( configUSE_MUTEXES == 1 )
+		{
+			if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+			{
+				/* The mutex is no longer being held. */
+				xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
+
+				#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					if( pxQueue->u.xSemaphore.xMutexHolder != NULL )
+					{
+						/* xTaskPriorityDisinherit() only restores the base
+						priority once the last mutex is returned.  Drop the
+						holder straight to the highest priority it still
+						inherits through the mutexes it continues to hold. */
+						prvRemoveMutexFromHeldList( pxQueue );
+
+						if( xTaskPriorityInheritanceUpdate( pxQueue->u.xSemaphore.xMutexHolder, prvGetHighestPriorityOfHeldMutexWaiters( pxQueue->u.xSemaphore.xMutexHolder ) ) != pdFALSE )
+						{
+							xReturn = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+				pxQueue->u.xSemaphore.xMutexHolder = NULL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_MUTEXES */
+	}
+	else if( xPosition == queueSEND_TO_BACK )
+	{
+		( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+		pxQueue->pcWriteTo += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+		{
+			pxQueue->pcWriteTo = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e9087 !e418 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes.  Assert checks null pointer only used when length is 0. */
+		pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
+		if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+		{
+			pxQueue->u.xQueue.pcReadFrom = ( pxQueue->u.xQueue.pcTail - pxQueue->uxItemSize );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xPosition == queueOVERWRITE )
+		{
+			if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+			{
+				/* An item is not being added but overwritten, so subtract
+				one from the recorded number of items in the queue so when
+				one is added again below the number of recorded items remains
+				correct. */
+				--uxMessagesWaiting;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
+{
+	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+	{
+		pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		{
+			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+	}
 }
 /*-----------------------------------------------------------*/
 
@@ -2768,7 +3830,7 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_TIMERS */
 /*-----------------------------------------------------------*/
 
-#if( ( configUSE_QUEUE_SETS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+#if( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_BITMAP == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 
 	QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength )
 	{
@@ -2782,7 +3844,7 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_BITMAP == 0 ) )
 
 	BaseType_t xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet )
 	{
@@ -2815,7 +3877,7 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_BITMAP == 0 ) )
 
 	BaseType_t xQueueRemoveFromSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet )
 	{
@@ -2851,7 +3913,7 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_BITMAP == 0 ) )
 
 	QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet, TickType_t const xTicksToWait )
 	{
@@ -2864,7 +3926,7 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_BITMAP == 0 ) )
 
 	QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet )
 	{
@@ -2877,7 +3939,7 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_BITMAP == 0 ) )
 
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue )
 	{
@@ -2931,6 +3993,557 @@ Queue_t * const pxQueue = xQueue;
 	}
 
 #endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_SET_BITMAP == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+	QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength )
+	{
+	QueueSetHandle_t pxQueue;
+	UBaseType_t uxStorageSize;
+
+		/* uxEventQueueLength is the number of members the set can hold. */
+		configASSERT( uxEventQueueLength > ( UBaseType_t ) 0 );
+		configASSERT( uxEventQueueLength <= queueSET_MAX_MEMBERS );
+
+		/* The set is a queue of length one, the single item of which holds the
+		member table and the ready bit map. */
+		uxStorageSize = ( UBaseType_t ) sizeof( QueueSetHeader_t ) + ( uxEventQueueLength * ( UBaseType_t ) sizeof( QueueSetMember_t ) ) + ( queueSET_GROUPS( uxEventQueueLength ) * ( UBaseType_t ) sizeof( uint32_t ) );
+		pxQueue = xQueueGenericCreate( ( UBaseType_t ) 1, uxStorageSize, queueQUEUE_TYPE_SET );
+
+		if( pxQueue != NULL )
+		{
+			( void ) memset( ( void * ) pxQueue->pcHead, 0x00, ( size_t ) uxStorageSize );
+			queueSET_HEADER( pxQueue )->uxMaxMembers = uxEventQueueLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxQueue;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	BaseType_t xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet )
+	{
+	Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+	UBaseType_t uxMemberIndex;
+	BaseType_t xReturn, xYieldRequired = pdFALSE;
+
+		configASSERT( pxQueueOrSemaphore );
+		configASSERT( xQueueSet );
+
+		#if( configUSE_FAST_SEMAPHORES == 1 )
+		{
+			/* Uncontended gives to a fast semaphore do not pass through the
+			queue, so could not mark the semaphore as ready. */
+			configASSERT( pxQueueOrSemaphore->uxFastMaxCount == queueNOT_FAST_SEMAPHORE );
+		}
+		#endif
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueueOrSemaphore->pxQueueSetContainer != NULL )
+			{
+				/* Cannot add a queue/semaphore to more than one queue set. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				xReturn = xQueueSetAddMember( xQueueSet, pxQueueOrSemaphore, queueSET_MEMBER_TYPE_QUEUE, &uxMemberIndex );
+
+				if( xReturn != pdFAIL )
+				{
+					pxQueueOrSemaphore->pxQueueSetContainer = xQueueSet;
+					pxQueueOrSemaphore->uxQueueSetIndex = uxMemberIndex;
+
+					/* A queue that already contains data is ready as soon as
+					it is in the set. */
+					if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
+					{
+						xYieldRequired = prvNotifyQueueSetContainer( pxQueueOrSemaphore );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xYieldRequired != pdFALSE )
+		{
+			queueYIELD_IF_USING_PREEMPTION();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	BaseType_t xQueueRemoveFromSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet )
+	{
+	BaseType_t xReturn;
+	Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+
+		taskENTER_CRITICAL();
+		{
+			if( ( xQueueSet == NULL ) || ( pxQueueOrSemaphore->pxQueueSetContainer != xQueueSet ) )
+			{
+				/* The queue was not a member of the set. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				/* The set holds no events for its members, so unlike an event
+				queue set a member can be removed while it contains data. */
+				vQueueSetRemoveMember( xQueueSet, pxQueueOrSemaphore->uxQueueSetIndex );
+				pxQueueOrSemaphore->pxQueueSetContainer = NULL;
+				xReturn = pdPASS;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	} /*lint !e818 xQueueSet could not be declared as pointing to const as it is a typedef. */
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet, TickType_t const xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	TickType_t xTicksRemaining = xTicksToWait;
+	Queue_t * const pxQueueSet = xQueueSet;
+	QueueSetMemberHandle_t xReturn;
+
+		configASSERT( pxQueueSet );
+
+		/* Cannot block if the scheduler is suspended. */
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		/* This follows the structure of xQueueReceive(), with the ready bit
+		map taking the place of the queue storage. */
+
+		/*lint -save -e904  This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				xReturn = prvSelectFromQueueSet( pxQueueSet );
+
+				if( xReturn != NULL )
+				{
+					traceQUEUE_RECEIVE( pxQueueSet );
+					taskEXIT_CRITICAL();
+					return xReturn;
+				}
+				else
+				{
+					if( xTicksRemaining == ( TickType_t ) 0 )
+					{
+						/* No member holds data and no block time is specified
+						(or the block time has expired) so leave now. */
+						taskEXIT_CRITICAL();
+						traceQUEUE_RECEIVE_FAILED( pxQueueSet );
+						return NULL;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueueSet );
+
+			/* Members that become ready while the set is locked increment
+			cTxLock, so the task is unblocked again when the set is unlocked. */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksRemaining ) == pdFALSE )
+			{
+				if( prvIsQueueSetEmpty( pxQueueSet ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_RECEIVE( pxQueueSet );
+					vTaskPlaceOnEventList( &( pxQueueSet->xTasksWaitingToReceive ), xTicksRemaining );
+					prvUnlockQueue( pxQueueSet );
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					/* A ready bit is set.  Loop back to check the member really
+					holds data. */
+					prvUnlockQueue( pxQueueSet );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				prvUnlockQueue( pxQueueSet );
+				( void ) xTaskResumeAll();
+
+				if( prvIsQueueSetEmpty( pxQueueSet ) != pdFALSE )
+				{
+					traceQUEUE_RECEIVE_FAILED( pxQueueSet );
+					return NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		} /*lint -restore */
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet )
+	{
+	QueueSetMemberHandle_t xReturn;
+	UBaseType_t uxSavedInterruptStatus;
+
+		configASSERT( xQueueSet );
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			xReturn = prvSelectFromQueueSet( xQueueSet );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue )
+	{
+		/* This function must be called form a critical section. */
+		configASSERT( pxQueue->pxQueueSetContainer );
+
+		return xQueueSetMemberReady( pxQueue->pxQueueSetContainer, pxQueue->uxQueueSetIndex );
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	BaseType_t xQueueSetAddMember( QueueSetHandle_t xQueueSet, void *pvMember, uint8_t ucMemberType, UBaseType_t *puxMemberIndex )
+	{
+	QueueSetMember_t * const pxMembers = queueSET_MEMBERS( xQueueSet );
+	const UBaseType_t uxMaxMembers = queueSET_HEADER( xQueueSet )->uxMaxMembers;
+	UBaseType_t uxIndex;
+	BaseType_t xReturn = pdFAIL;
+
+		/* This function must be called from a critical section.  Adding
+		members is rare, so a linear search for a free slot is acceptable. */
+		configASSERT( pvMember );
+
+		for( uxIndex = ( UBaseType_t ) 0; ( uxIndex < uxMaxMembers ) && ( xReturn == pdFAIL ); uxIndex++ )
+		{
+			if( pxMembers[ uxIndex ].pvMember == NULL )
+			{
+				pxMembers[ uxIndex ].pvMember = pvMember;
+				pxMembers[ uxIndex ].ucMemberType = ucMemberType;
+				*puxMemberIndex = uxIndex;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	void vQueueSetRemoveMember( QueueSetHandle_t xQueueSet, UBaseType_t uxMemberIndex )
+	{
+		/* This function must be called from a critical section. */
+		configASSERT( uxMemberIndex < queueSET_HEADER( xQueueSet )->uxMaxMembers );
+
+		queueSET_MEMBERS( xQueueSet )[ uxMemberIndex ].pvMember = NULL;
+		prvClearQueueSetReadyBit( xQueueSet, uxMemberIndex );
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	BaseType_t xQueueSetMemberReady( QueueSetHandle_t xQueueSet, UBaseType_t uxMemberIndex )
+	{
+	Queue_t * const pxQueueSet = xQueueSet;
+	QueueSetHeader_t * const pxHeader = queueSET_HEADER( pxQueueSet );
+	const UBaseType_t uxGroup = uxMemberIndex / queueSET_BITS_PER_GROUP;
+	const int8_t cTxLock = pxQueueSet->cTxLock;
+	BaseType_t xReturn = pdFALSE;
+
+		/* This function must be called from a critical section. */
+		configASSERT( uxMemberIndex < pxHeader->uxMaxMembers );
+
+		queueSET_READY_BITS( pxQueueSet )[ uxGroup ] |= ( ( uint32_t ) 1U ) << ( uxMemberIndex % queueSET_BITS_PER_GROUP );
+		pxHeader->ulReadyGroups |= ( ( uint32_t ) 1U ) << uxGroup;
+
+		if( cTxLock == queueUNLOCKED )
+		{
+			if( listLIST_IS_EMPTY( &( pxQueueSet->xTasksWaitingToReceive ) ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueueSet->xTasksWaitingToReceive ) ) != pdFALSE )
+				{
+					/* The task waiting has a higher priority. */
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( cTxLock < queueSET_MAX_TX_LOCK )
+		{
+			pxQueueSet->cTxLock = ( int8_t ) ( cTxLock + 1 );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static QueueSetMemberHandle_t prvSelectFromQueueSet( Queue_t * const pxQueueSet )
+	{
+	QueueSetHeader_t * const pxHeader = queueSET_HEADER( pxQueueSet );
+	const QueueSetMember_t * const pxMembers = queueSET_MEMBERS( pxQueueSet );
+	QueueSetMemberHandle_t xReturn = NULL;
+	UBaseType_t uxIndex;
+
+		/* Ready bits are set when data is sent to a member but are not cleared
+		when the data is read, as the read happens outside of the set.  A set
+		bit therefore only means the member might hold data.  Members found to
+		be empty are cleared here, so each stale bit is only visited once. */
+		while( ( xReturn == NULL ) && ( pxHeader->ulReadyGroups != 0UL ) )
+		{
+			uxIndex = prvFindReadyQueueSetMember( pxHeader, queueSET_READY_BITS( pxQueueSet ) );
+
+			if( prvIsQueueSetMemberReady( &( pxMembers[ uxIndex ] ) ) != pdFALSE )
+			{
+				xReturn = ( QueueSetMemberHandle_t ) pxMembers[ uxIndex ].pvMember;
+
+				/* Start the next search after this member so all ready
+				members are returned in turn. */
+				uxIndex++;
+				if( uxIndex >= pxHeader->uxMaxMembers )
+				{
+					uxIndex = ( UBaseType_t ) 0;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+				pxHeader->uxNextToSelect = uxIndex;
+			}
+			else
+			{
+				prvClearQueueSetReadyBit( pxQueueSet, uxIndex );
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static UBaseType_t prvFindReadyQueueSetMember( const QueueSetHeader_t * const pxHeader, const uint32_t * const pulReadyBits )
+	{
+	const UBaseType_t uxStartGroup = pxHeader->uxNextToSelect / queueSET_BITS_PER_GROUP;
+	const UBaseType_t uxStartBit = pxHeader->uxNextToSelect % queueSET_BITS_PER_GROUP;
+	UBaseType_t uxGroup;
+	uint32_t ulBits;
+
+		/* First look at the members at or after the start position within the
+		start group. */
+		ulBits = pulReadyBits[ uxStartGroup ] & ( ( ( uint32_t ) 0xffffffffUL ) << uxStartBit );
+
+		if( ulBits != 0UL )
+		{
+			uxGroup = uxStartGroup;
+		}
+		else
+		{
+			/* Then the groups after the start group, then wrap around to the
+			first ready group, which can be the start group itself. */
+			ulBits = pxHeader->ulReadyGroups & ( ( ( uint32_t ) 0xfffffffeUL ) << uxStartGroup );
+
+			if( ulBits == 0UL )
+			{
+				ulBits = pxHeader->ulReadyGroups;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			uxGroup = portCOUNT_TRAILING_ZEROS( ulBits );
+			ulBits = pulReadyBits[ uxGroup ];
+		}
+
+		return ( uxGroup * queueSET_BITS_PER_GROUP ) + portCOUNT_TRAILING_ZEROS( ulBits );
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static BaseType_t prvIsQueueSetMemberReady( const QueueSetMember_t * const pxMember )
+	{
+	BaseType_t xReturn;
+
+		if( pxMember->ucMemberType == queueSET_MEMBER_TYPE_STREAM_BUFFER )
+		{
+			xReturn = ( xStreamBufferIsEmpty( ( StreamBufferHandle_t ) pxMember->pvMember ) == pdFALSE ) ? pdTRUE : pdFALSE;
+		}
+		else
+		{
+			xReturn = ( ( ( const Queue_t * ) pxMember->pvMember )->uxMessagesWaiting != ( UBaseType_t ) 0 ) ? pdTRUE : pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static void prvClearQueueSetReadyBit( Queue_t * const pxQueueSet, const UBaseType_t uxMemberIndex )
+	{
+	uint32_t * const pulReadyBits = queueSET_READY_BITS( pxQueueSet );
+	const UBaseType_t uxGroup = uxMemberIndex / queueSET_BITS_PER_GROUP;
+
+		pulReadyBits[ uxGroup ] &= ~( ( ( uint32_t ) 1U ) << ( uxMemberIndex % queueSET_BITS_PER_GROUP ) );
+
+		if( pulReadyBits[ uxGroup ] == 0UL )
+		{
+			queueSET_HEADER( pxQueueSet )->ulReadyGroups &= ~( ( ( uint32_t ) 1U ) << uxGroup );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static BaseType_t prvIsQueueSetEmpty( const Queue_t *pxQueueSet )
+	{
+	BaseType_t xReturn;
+
+		taskENTER_CRITICAL();
+		{
+			if( queueSET_HEADER( pxQueueSet )->ulReadyGroups == 0UL )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				xReturn = pdFALSE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_QUEUE_SET_BITMAP == 1 ) && ( queueUSE_GENERIC_COUNT_TRAILING_ZEROS == 1 ) )
+
+	static UBaseType_t prvCountTrailingZeros( uint32_t ulBits )
+	{
+	UBaseType_t uxCount = ( UBaseType_t ) 0;
+
+		/* ulBits must not be zero. */
+		while( ( ulBits & 0x01UL ) == 0UL )
+		{
+			ulBits >>= 1;
+			uxCount++;
+		}
+
+		return uxCount;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
 
 
 
@@ -0,0 +1,822 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "rwlock.h"
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	#include "queue.h"
+#endif
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to include reader-writer lock functionality.  This #if is closed at the very
+bottom of this file.  If you want to include reader-writer locks then ensure
+configUSE_RW_LOCKS is set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_RW_LOCKS == 1 )
+
+typedef struct RWLockDef_t
+{
+	List_t xTasksWaitingToRead;			/*< List of tasks blocked waiting to obtain the lock for reading.  Stored in priority order. */
+	List_t xTasksWaitingToWrite;		/*< List of tasks blocked waiting to obtain the lock for writing.  Stored in priority order. */
+	TaskHandle_t xWriteHolder;			/*< The task that holds the lock for writing, or NULL. */
+
+	#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+		struct RWLockDef_t *pxNextHeldRWLock;	/*< The next lock in the list of locks held for writing by xWriteHolder. */
+	#endif
+
+	UBaseType_t uxReaders;				/*< The number of read locks currently held. */
+	UBaseType_t uxWritersWaiting;		/*< The number of tasks that are waiting to write, including any that have been unblocked but not yet run. */
+	uint8_t ucPolicy;					/*< rwlockPREFER_WRITERS or rwlockPREFER_READERS. */
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucStaticallyAllocated;	/*< Set to pdTRUE if the lock is statically allocated to ensure no attempt is made to free the memory. */
+	#endif
+} RWLock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Set the initial state of a newly created lock.
+ */
+static void prvInitialiseNewRWLock( RWLock_t *pxRWLock, const UBaseType_t uxPolicy ) PRIVILEGED_FUNCTION;
+
+/*
+ * The implementation of xRWLockAcquireRead() and xRWLockAcquireWrite().
+ */
+static BaseType_t prvRWLockAcquire( RWLock_t * const pxRWLock, const BaseType_t xForWriting, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if the calling task can obtain the lock for writing (if
+ * xForWriting is pdTRUE) or for reading (if xForWriting is pdFALSE).
+ */
+static BaseType_t prvRWLockIsAvailable( const RWLock_t * const pxRWLock, const BaseType_t xForWriting ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks that can make progress after the lock has been released
+ * for writing, or after the last task waiting to write has timed out.  Tasks
+ * that are unblocked retry obtaining the lock when they next run.  Must be
+ * called with the scheduler suspended.
+ */
+static void prvUnblockWaitingTasks( RWLock_t * const pxRWLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the priority of the highest priority task waiting for the lock, or
+ * tskIDLE_PRIORITY if no tasks are waiting.  Used to decide the priority to
+ * which the write holder should drop after a waiting task times out.
+ */
+static UBaseType_t prvGetHighestPriorityWaiting( const RWLock_t * const pxRWLock ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	/*
+	 * Add a lock that has just been obtained for writing to the list of locks
+	 * held by its write holder, and remove it again when it is released.  The
+	 * list lets queue.c include the tasks waiting for the lock when it
+	 * recalculates the priority the holder inherits.
+	 */
+	static void prvAddRWLockToHeldList( RWLock_t * const pxRWLock ) PRIVILEGED_FUNCTION;
+	static void prvRemoveRWLockFromHeldList( RWLock_t * const pxRWLock ) PRIVILEGED_FUNCTION;
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	RWLockHandle_t xRWLockCreateStatic( const UBaseType_t uxPolicy, StaticRWLock_t *pxRWLockBuffer )
+	{
+	RWLock_t *pxRWLock;
+
+		/* A StaticRWLock_t object must be provided. */
+		configASSERT( pxRWLockBuffer );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticRWLock_t equals the size of the real lock
+			structure. */
+			volatile size_t xSize = sizeof( StaticRWLock_t );
+			configASSERT( xSize == sizeof( RWLock_t ) );
+		} /*lint !e529 xSize is referenced if configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		/* The user has provided a statically allocated lock - use it. */
+		pxRWLock = ( RWLock_t * ) pxRWLockBuffer; /*lint !e740 !e9087 RWLock_t and StaticRWLock_t are deliberately aliased for data hiding purposes and guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+		if( pxRWLock != NULL )
+		{
+			prvInitialiseNewRWLock( pxRWLock, uxPolicy );
+
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note that
+				this lock was created statically in case the lock is later
+				deleted. */
+				pxRWLock->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			traceRWLOCK_CREATE( pxRWLock );
+		}
+		else
+		{
+			traceRWLOCK_CREATE_FAILED();
+		}
+
+		return pxRWLock;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	RWLockHandle_t xRWLockCreate( const UBaseType_t uxPolicy )
+	{
+	RWLock_t *pxRWLock;
+
+		pxRWLock = ( RWLock_t * ) pvPortMallocKernelObject( sizeof( RWLock_t ) ); /*lint !e9087 !e9079 pvPortMalloc() returns memory aligned for any kernel structure. */
+
+		if( pxRWLock != NULL )
+		{
+			prvInitialiseNewRWLock( pxRWLock, uxPolicy );
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note this
+				lock was allocated dynamically in case the lock is later
+				deleted. */
+				pxRWLock->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			traceRWLOCK_CREATE( pxRWLock );
+		}
+		else
+		{
+			traceRWLOCK_CREATE_FAILED(); /*lint !e9063 Else branch only exists to allow tracing and does not generate code if trace macros are not defined. */
+		}
+
+		return pxRWLock;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewRWLock( RWLock_t *pxRWLock, const UBaseType_t uxPolicy )
+{
+	configASSERT( ( uxPolicy == rwlockPREFER_WRITERS ) || ( uxPolicy == rwlockPREFER_READERS ) );
+
+	vListInitialise( &( pxRWLock->xTasksWaitingToRead ) );
+	vListInitialise( &( pxRWLock->xTasksWaitingToWrite ) );
+	pxRWLock->xWriteHolder = NULL;
+	pxRWLock->uxReaders = ( UBaseType_t ) 0U;
+
+	#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+	{
+		pxRWLock->pxNextHeldRWLock = NULL;
+	}
+	#endif
+
+	pxRWLock->uxWritersWaiting = ( UBaseType_t ) 0U;
+	pxRWLock->ucPolicy = ( uint8_t ) uxPolicy;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockAcquireRead( RWLockHandle_t xRWLock, TickType_t xTicksToWait )
+{
+	return prvRWLockAcquire( xRWLock, pdFALSE, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockAcquireWrite( RWLockHandle_t xRWLock, TickType_t xTicksToWait )
+{
+	return prvRWLockAcquire( xRWLock, pdTRUE, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRWLockAcquire( RWLock_t * const pxRWLock, const BaseType_t xForWriting, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE, xCountedAsWaitingWriter = pdFALSE, xInheritanceOccurred = pdFALSE;
+TimeOut_t xTimeOut;
+List_t * const pxWaitingList = ( xForWriting != pdFALSE ) ? &( pxRWLock->xTasksWaitingToWrite ) : &( pxRWLock->xTasksWaitingToRead );
+
+	configASSERT( pxRWLock );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/*lint -save -e904 This function relaxes the coding standard somewhat to
+	allow return statements within the function itself.  This is done in the
+	interest of execution time efficiency. */
+	for( ;; )
+	{
+		/* Only tasks access the lock, so suspending the scheduler is enough to
+		protect both the lock's state and its event lists. */
+		vTaskSuspendAll();
+
+		if( prvRWLockIsAvailable( pxRWLock, xForWriting ) != pdFALSE )
+		{
+			if( xForWriting != pdFALSE )
+			{
+				/* Record the holder, and count the lock as a mutex held by
+				the task, so the priority it inherits while holding the lock is
+				only disinherited once it holds no mutexes. */
+				pxRWLock->xWriteHolder = pvTaskIncrementMutexHeldCount();
+
+				#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					prvAddRWLockToHeldList( pxRWLock );
+				}
+				#endif
+
+				if( xCountedAsWaitingWriter != pdFALSE )
+				{
+					( pxRWLock->uxWritersWaiting )--;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				( pxRWLock->uxReaders )++;
+			}
+
+			#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+			{
+				/* This task is no longer waiting for the lock. */
+				vTaskSetRWLockBlockedOn( NULL );
+			}
+			#endif
+
+			traceRWLOCK_ACQUIRE( pxRWLock, xForWriting );
+			( void ) xTaskResumeAll();
+			return pdPASS;
+		}
+		else if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* The lock is not available and no block time was specified.  A
+			task that has blocked before will have left through the timeout
+			path below, so cannot still be counted as waiting. */
+			configASSERT( xCountedAsWaitingWriter == pdFALSE );
+			traceRWLOCK_ACQUIRE_FAILED( pxRWLock, xForWriting );
+			( void ) xTaskResumeAll();
+			return pdFAIL;
+		}
+		else if( xEntryTimeSet == pdFALSE )
+		{
+			/* The lock was not available and a block time was specified so
+			configure the timeout structure. */
+			vTaskInternalSetTimeOutState( &xTimeOut );
+			xEntryTimeSet = pdTRUE;
+		}
+		else
+		{
+			/* Entry time was already set. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			if( ( xForWriting != pdFALSE ) && ( xCountedAsWaitingWriter == pdFALSE ) )
+			{
+				/* From now on readers are held off if the lock prefers
+				writers. */
+				( pxRWLock->uxWritersWaiting )++;
+				xCountedAsWaitingWriter = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 0 )
+			{
+				if( pxRWLock->xWriteHolder != NULL )
+				{
+					taskENTER_CRITICAL();
+					{
+						if( xTaskPriorityInherit( pxRWLock->xWriteHolder ) != pdFALSE )
+						{
+							xInheritanceOccurred = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					taskEXIT_CRITICAL();
+				}
+				else
+				{
+					/* The lock is held for reading.  Readers are not recorded
+					so cannot inherit a priority. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+			traceBLOCKING_ON_RWLOCK( pxRWLock, xForWriting );
+			vTaskPlaceOnEventList( pxWaitingList, xTicksToWait );
+
+			#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+			{
+				/* Record the lock this task is waiting for, so a priority this
+				task inherits while it waits is passed on to the lock's write
+				holder in the same way as to the holder of a mutex.  Tasks only
+				follow the link with the scheduler running, so it is safe to
+				set with the scheduler suspended. */
+				vTaskSetRWLockBlockedOn( pxRWLock );
+
+				if( pxRWLock->xWriteHolder != NULL )
+				{
+					/* Now this task is in the lock's waiting list the write
+					holder's priority is recalculated the same way as for a
+					mutex holder, so it is kept when the holder gives back a
+					mutex, and passed on should the holder be blocked on a
+					mutex itself. */
+					taskENTER_CRITICAL();
+					{
+						( void ) xQueueUpdateMutexHolderPriority( pxRWLock->xWriteHolder );
+					}
+					taskEXIT_CRITICAL();
+
+					/* Ensure the holder's priority is recalculated should
+					this task time out. */
+					xInheritanceOccurred = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+
+			/* Resuming the scheduler will move this task to the delayed list
+			or, if the lock was released by a higher priority task in the
+			meantime, back to the ready list. */
+			if( xTaskResumeAll() == pdFALSE )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* Timed out. */
+			#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+			{
+				vTaskSetRWLockBlockedOn( NULL );
+			}
+			#endif
+
+			if( xCountedAsWaitingWriter != pdFALSE )
+			{
+				( pxRWLock->uxWritersWaiting )--;
+
+				/* Readers might have been held off only because this task was
+				waiting. */
+				if( ( pxRWLock->uxWritersWaiting == ( UBaseType_t ) 0U ) && ( pxRWLock->xWriteHolder == NULL ) )
+				{
+					prvUnblockWaitingTasks( pxRWLock );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* If this task caused the write holder to inherit a priority then
+			the holder's priority must be reduced to the priority of the
+			highest priority task that is still waiting. */
+			if( ( xInheritanceOccurred != pdFALSE ) && ( pxRWLock->xWriteHolder != NULL ) )
+			{
+				taskENTER_CRITICAL();
+				{
+					#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+					{
+						( void ) xQueueUpdateMutexHolderPriority( pxRWLock->xWriteHolder );
+					}
+					#else
+					{
+						vTaskPriorityDisinheritAfterTimeout( pxRWLock->xWriteHolder, prvGetHighestPriorityWaiting( pxRWLock ) );
+					}
+					#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+				}
+				taskEXIT_CRITICAL();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			traceRWLOCK_ACQUIRE_FAILED( pxRWLock, xForWriting );
+			( void ) xTaskResumeAll();
+			return pdFAIL;
+		}
+	} /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockReleaseRead( RWLockHandle_t xRWLock )
+{
+RWLock_t * const pxRWLock = xRWLock;
+BaseType_t xReturn = pdPASS;
+
+	configASSERT( pxRWLock );
+
+	vTaskSuspendAll();
+	{
+		if( pxRWLock->uxReaders > ( UBaseType_t ) 0U )
+		{
+			( pxRWLock->uxReaders )--;
+			traceRWLOCK_RELEASE( pxRWLock, pdFALSE );
+
+			/* The last reader lets the highest priority waiting writer in. */
+			if( ( pxRWLock->uxReaders == ( UBaseType_t ) 0U ) && ( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToWrite ) ) == pdFALSE ) )
+			{
+				( void ) xTaskRemoveFromEventList( &( pxRWLock->xTasksWaitingToWrite ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* The lock was not held for reading. */
+			xReturn = pdFAIL;
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockReleaseWrite( RWLockHandle_t xRWLock )
+{
+RWLock_t * const pxRWLock = xRWLock;
+BaseType_t xReturn = pdPASS, xYieldRequired = pdFALSE;
+
+	configASSERT( pxRWLock );
+
+	vTaskSuspendAll();
+	{
+		if( pxRWLock->xWriteHolder == xTaskGetCurrentTaskHandle() )
+		{
+			/* Drop any priority inherited while the lock was held. */
+			taskENTER_CRITICAL();
+			{
+				xYieldRequired = xTaskPriorityDisinherit( pxRWLock->xWriteHolder );
+
+				#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+				{
+					/* xTaskPriorityDisinherit() only restores the base
+					priority once the last mutex or lock is released.  Drop
+					straight to the highest priority still inherited through
+					the mutexes and locks that continue to be held. */
+					prvRemoveRWLockFromHeldList( pxRWLock );
+
+					if( xQueueUpdateMutexHolderPriority( pxRWLock->xWriteHolder ) != pdFALSE )
+					{
+						xYieldRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+			}
+			taskEXIT_CRITICAL();
+
+			pxRWLock->xWriteHolder = NULL;
+			traceRWLOCK_RELEASE( pxRWLock, pdTRUE );
+
+			prvUnblockWaitingTasks( pxRWLock );
+		}
+		else
+		{
+			/* The calling task did not hold the lock for writing. */
+			xReturn = pdFAIL;
+		}
+	}
+
+	/* A yield is needed if the priority of this task was lowered, even if no
+	task was unblocked by releasing the lock. */
+	if( ( xTaskResumeAll() == pdFALSE ) && ( xYieldRequired != pdFALSE ) )
+	{
+		portYIELD_WITHIN_API();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRWLockIsAvailable( const RWLock_t * const pxRWLock, const BaseType_t xForWriting )
+{
+BaseType_t xReturn;
+
+	if( pxRWLock->xWriteHolder != NULL )
+	{
+		xReturn = pdFALSE;
+	}
+	else if( xForWriting != pdFALSE )
+	{
+		xReturn = ( pxRWLock->uxReaders == ( UBaseType_t ) 0U ) ? pdTRUE : pdFALSE;
+	}
+	else if( pxRWLock->ucPolicy == ( uint8_t ) rwlockPREFER_WRITERS )
+	{
+		xReturn = ( pxRWLock->uxWritersWaiting == ( UBaseType_t ) 0U ) ? pdTRUE : pdFALSE;
+	}
+	else
+	{
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockWaitingTasks( RWLock_t * const pxRWLock )
+{
+List_t * const pxReaders = &( pxRWLock->xTasksWaitingToRead );
+List_t * const pxWriters = &( pxRWLock->xTasksWaitingToWrite );
+
+	if( ( pxRWLock->ucPolicy == ( uint8_t ) rwlockPREFER_WRITERS ) && ( pxRWLock->uxWritersWaiting != ( UBaseType_t ) 0U ) )
+	{
+		/* Readers cannot obtain the lock while a writer is waiting, so only
+		unblock the highest priority writer.  If the waiting writer has
+		already been unblocked then it will obtain the lock when it runs. */
+		if( listLIST_IS_EMPTY( pxWriters ) == pdFALSE )
+		{
+			( void ) xTaskRemoveFromEventList( pxWriters );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else if( listLIST_IS_EMPTY( pxReaders ) == pdFALSE )
+	{
+		/* All the waiting readers can hold the lock at the same time. */
+		while( listLIST_IS_EMPTY( pxReaders ) == pdFALSE )
+		{
+			( void ) xTaskRemoveFromEventList( pxReaders );
+		}
+	}
+	else if( listLIST_IS_EMPTY( pxWriters ) == pdFALSE )
+	{
+		( void ) xTaskRemoveFromEventList( pxWriters );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetHighestPriorityWaiting( const RWLock_t * const pxRWLock )
+{
+UBaseType_t uxHighestPriority = tskIDLE_PRIORITY, uxPriority;
+
+	/* The event lists are ordered by priority, so the task at the head of
+	each list is the highest priority task in that list. */
+	if( listCURRENT_LIST_LENGTH( &( pxRWLock->xTasksWaitingToRead ) ) > 0U )
+	{
+		uxHighestPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxRWLock->xTasksWaitingToRead ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( listCURRENT_LIST_LENGTH( &( pxRWLock->xTasksWaitingToWrite ) ) > 0U )
+	{
+		uxPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxRWLock->xTasksWaitingToWrite ) );
+
+		if( uxPriority > uxHighestPriority )
+		{
+			uxHighestPriority = uxPriority;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxHighestPriority;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	static void prvAddRWLockToHeldList( RWLock_t * const pxRWLock )
+	{
+	TaskHandle_t const xWriteHolder = pxRWLock->xWriteHolder;
+
+		/* The holder is NULL if the lock was obtained before any tasks were
+		created.  The list is only changed with the scheduler suspended, and
+		only read by the kernel from task level. */
+		if( xWriteHolder != NULL )
+		{
+			pxRWLock->pxNextHeldRWLock = ( RWLock_t * ) pvTaskGetRWLocksHeld( xWriteHolder );
+			vTaskSetRWLocksHeld( xWriteHolder, pxRWLock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	static void prvRemoveRWLockFromHeldList( RWLock_t * const pxRWLock )
+	{
+	TaskHandle_t const xWriteHolder = pxRWLock->xWriteHolder;
+	RWLock_t *pxHeld, *pxPrevious = NULL;
+
+		pxHeld = ( RWLock_t * ) pvTaskGetRWLocksHeld( xWriteHolder );
+
+		while( ( pxHeld != NULL ) && ( pxHeld != pxRWLock ) )
+		{
+			pxPrevious = pxHeld;
+			pxHeld = pxHeld->pxNextHeldRWLock;
+		}
+
+		if( pxHeld != NULL )
+		{
+			if( pxPrevious == NULL )
+			{
+				vTaskSetRWLocksHeld( xWriteHolder, pxRWLock->pxNextHeldRWLock );
+			}
+			else
+			{
+				pxPrevious->pxNextHeldRWLock = pxRWLock->pxNextHeldRWLock;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxRWLock->pxNextHeldRWLock = NULL;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	UBaseType_t uxRWLockGetHighestPriorityOfHeldLockWaiters( TaskHandle_t const xWriteHolder )
+	{
+	const RWLock_t *pxHeld;
+	UBaseType_t uxHighestPriority = tskIDLE_PRIORITY, uxPriority;
+
+		for( pxHeld = ( const RWLock_t * ) pvTaskGetRWLocksHeld( xWriteHolder ); pxHeld != NULL; pxHeld = pxHeld->pxNextHeldRWLock )
+		{
+			uxPriority = prvGetHighestPriorityWaiting( pxHeld );
+
+			if( uxPriority > uxHighestPriority )
+			{
+				uxHighestPriority = uxPriority;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return uxHighestPriority;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxRWLockGetReaderCount( RWLockHandle_t xRWLock )
+{
+const RWLock_t * const pxRWLock = xRWLock;
+
+	configASSERT( pxRWLock );
+	return pxRWLock->uxReaders;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xRWLockGetWriteHolder( RWLockHandle_t xRWLock )
+{
+const RWLock_t * const pxRWLock = xRWLock;
+
+	configASSERT( pxRWLock );
+	return pxRWLock->xWriteHolder;
+}
+/*-----------------------------------------------------------*/
+
+void vRWLockDelete( RWLockHandle_t xRWLock )
+{
+RWLock_t *pxRWLock = xRWLock;
+
+	configASSERT( pxRWLock );
+
+	vTaskSuspendAll();
+	{
+		traceRWLOCK_DELETE( pxRWLock );
+
+		/* The lock must not be in use. */
+		configASSERT( pxRWLock->xWriteHolder == NULL );
+		configASSERT( pxRWLock->uxReaders == ( UBaseType_t ) 0U );
+		configASSERT( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToRead ) ) != pdFALSE );
+		configASSERT( listLIST_IS_EMPTY( &( pxRWLock->xTasksWaitingToWrite ) ) != pdFALSE );
+
+		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+		{
+			/* The lock can only have been allocated dynamically - free it
+			again. */
+			vPortFree( pxRWLock );
+		}
+		#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+		{
+			/* The lock could have been allocated statically or dynamically, so
+			check before attempting to free the memory. */
+			if( pxRWLock->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+			{
+				vPortFree( pxRWLock );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+	}
+	( void ) xTaskResumeAll();
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include reader-writer lock functionality.  If you want to include
+reader-writer locks then ensure configUSE_RW_LOCKS is set to 1 in
+FreeRTOSConfig.h. */
+#endif /* configUSE_RW_LOCKS == 1 */
@@ -0,0 +1,214 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "section_profile.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to profile critical sections.  This #if is closed at the very bottom of this
+file.  If you want to profile critical sections then ensure
+configUSE_SECTION_PROFILING is set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_SECTION_PROFILING == 1 )
+
+#if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
+	/* vSectionProfileList() uses snprintf(). */
+	#include <stdio.h>
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the histogram bucket that counts ulCycles.
+ */
+static UBaseType_t prvHistogramBucket( uint32_t ulCycles );
+
+/*-----------------------------------------------------------*/
+
+/* The profile of each kind of section. */
+static SectionProfile_t xProfiles[ sectprofNUMBER_OF_KINDS ];
+
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHistogramBucket( uint32_t ulCycles )
+{
+UBaseType_t uxBucket = 0;
+
+	while( ( ulCycles > 1UL ) && ( uxBucket < ( UBaseType_t ) ( sectprofHISTOGRAM_BUCKETS - 1 ) ) )
+	{
+		ulCycles >>= 1;
+		uxBucket++;
+	}
+
+	return uxBucket;
+}
+/*-----------------------------------------------------------*/
+
+void vSectionProfileRecord( UBaseType_t uxKind, uint32_t ulCycles, void *pvCaller, TaskHandle_t xTask )
+{
+SectionProfile_t *pxProfile;
+UBaseType_t uxPosition;
+
+	configASSERT( uxKind < sectprofNUMBER_OF_KINDS );
+	pxProfile = &( xProfiles[ uxKind ] );
+
+	pxProfile->ulCount++;
+	pxProfile->ulHistogram[ prvHistogramBucket( ulCycles ) ]++;
+
+	/* Most sections are shorter than the shortest of the longest, so check
+	that first. */
+	if( ulCycles > pxProfile->xLongest[ configSECTION_PROFILE_LONGEST - 1 ].ulCycles )
+	{
+		/* Move the shorter sections down to make room, dropping the
+		shortest. */
+		uxPosition = configSECTION_PROFILE_LONGEST - 1;
+
+		while( ( uxPosition > 0U ) && ( ulCycles > pxProfile->xLongest[ uxPosition - 1U ].ulCycles ) )
+		{
+			pxProfile->xLongest[ uxPosition ] = pxProfile->xLongest[ uxPosition - 1U ];
+			uxPosition--;
+		}
+
+		pxProfile->xLongest[ uxPosition ].ulCycles = ulCycles;
+		pxProfile->xLongest[ uxPosition ].pvCaller = pvCaller;
+		pxProfile->xLongest[ uxPosition ].xTask = xTask;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vSectionProfileGet( UBaseType_t uxKind, SectionProfile_t *pxProfile )
+{
+	configASSERT( uxKind < sectprofNUMBER_OF_KINDS );
+
+	taskENTER_CRITICAL();
+	{
+		*pxProfile = xProfiles[ uxKind ];
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vSectionProfileReset( void )
+{
+	taskENTER_CRITICAL();
+	{
+		memset( ( void * ) xProfiles, 0x00, sizeof( xProfiles ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
+
+	void vSectionProfileList( char *pcWriteBuffer, size_t xBufferLength )
+	{
+	static const char * const pcKindNames[ sectprofNUMBER_OF_KINDS ] = { "critical", "suspended" };
+	SectionProfile_t xProfile;
+	uint32_t ulCounts[ sectprofNUMBER_OF_KINDS ];
+	UBaseType_t uxKind, uxRecord;
+	size_t xRemaining = xBufferLength;
+	int iWritten;
+
+		/*
+		 * PLEASE NOTE:
+		 *
+		 * This function is provided for convenience only.  Do not consider it
+		 * to be part of the scheduler.
+		 *
+		 * The profile of each kind is copied separately, so sections recorded
+		 * while the list is being written can appear in one kind but not the
+		 * other.
+		 */
+
+		if( xBufferLength == 0 )
+		{
+			return;
+		}
+
+		*pcWriteBuffer = ( char ) 0x00;
+
+		for( uxKind = 0; uxKind < sectprofNUMBER_OF_KINDS; uxKind++ )
+		{
+			vSectionProfileGet( uxKind, &xProfile );
+			ulCounts[ uxKind ] = xProfile.ulCount;
+
+			for( uxRecord = 0; ( uxRecord < configSECTION_PROFILE_LONGEST ) && ( xProfile.xLongest[ uxRecord ].ulCycles != 0UL ); uxRecord++ )
+			{
+				iWritten = snprintf( pcWriteBuffer, xRemaining, "%s\t%u\t%p\t%p\r\n", pcKindNames[ uxKind ], ( unsigned int ) xProfile.xLongest[ uxRecord ].ulCycles, xProfile.xLongest[ uxRecord ].pvCaller, ( void * ) xProfile.xLongest[ uxRecord ].xTask ); /*lint !e586 snprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+
+				if( ( iWritten < 0 ) || ( ( size_t ) iWritten >= xRemaining ) )
+				{
+					/* The buffer is full.  snprintf() has terminated the
+					string. */
+					return;
+				}
+
+				pcWriteBuffer += iWritten;
+				xRemaining -= ( size_t ) iWritten;
+			}
+		}
+
+		for( uxKind = 0; uxKind < sectprofNUMBER_OF_KINDS; uxKind++ )
+		{
+			iWritten = snprintf( pcWriteBuffer, xRemaining, "%u %s sections\r\n", ( unsigned int ) ulCounts[ uxKind ], pcKindNames[ uxKind ] ); /*lint !e586 snprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+
+			if( ( iWritten < 0 ) || ( ( size_t ) iWritten >= xRemaining ) )
+			{
+				return;
+			}
+
+			pcWriteBuffer += iWritten;
+			xRemaining -= ( size_t ) iWritten;
+		}
+	}
+
+#endif /* configUSE_STATS_FORMATTING_FUNCTIONS */
+
+/* This entire source file will be skipped if the application is not configured
+to profile critical sections.  If you want to profile critical sections then
+ensure configUSE_SECTION_PROFILING is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_SECTION_PROFILING == 1 */
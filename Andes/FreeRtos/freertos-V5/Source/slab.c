@@ -0,0 +1,334 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "slab.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to use kernel object slab caches.  This #if is closed at the very bottom of
+this file.  If you want to use slab caches then ensure
+configUSE_KERNEL_OBJECT_SLABS is set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+
+/* Round a size up to a multiple of the alignment returned by pvPortMalloc(),
+so every object in a slab is correctly aligned. */
+#define slabALIGN_SIZE( xSize )		( ( ( size_t ) ( xSize ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* A free object is linked into its cache's free list through its first
+bytes. */
+typedef struct SlabFreeObject
+{
+	struct SlabFreeObject *pxNextFreeObject;
+} SlabFreeObject_t;
+
+/* Placed at the start of each slab, so all the slabs owned by a cache can be
+found by a debugger. */
+typedef struct SlabHeader
+{
+	struct SlabHeader *pxNextSlab;
+} SlabHeader_t;
+
+#define slabHEADER_SIZE				slabALIGN_SIZE( sizeof( SlabHeader_t ) )
+
+typedef struct SlabCache
+{
+	size_t xObjectSize;						/*< The size of each object, rounded up to the heap alignment. */
+	SlabFreeObject_t *pxFreeObjects;		/*< Objects available for allocation. */
+	SlabHeader_t *pxSlabs;					/*< Every slab obtained from the heap. */
+	size_t xNumberOfSlabs;
+	size_t xObjectsInUse;
+	size_t xObjectsFree;
+	size_t xMaximumObjectsInUse;
+	size_t xNumberOfSuccessfulAllocations;
+	size_t xNumberOfSuccessfulFrees;
+	size_t xNumberOfFailedAllocations;
+} SlabCache_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Allocate a new slab from the FreeRTOS heap, divide it into objects, and
+ * add the objects to the cache's free list.  Returns pdFAIL if the heap could
+ * not supply the memory.  Must not be called from a critical section.
+ */
+static BaseType_t prvAddSlab( SlabCache_t *pxCache ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove and return the object at the head of the cache's free list, or NULL
+ * if the free list is empty.
+ */
+static void *prvTakeFreeObject( SlabCache_t *pxCache ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The caches, indexed by eSlabCache.  The size of each kernel object is taken
+from the StaticXxx_t structure that is used to allocate the same object
+statically, as the real structures are private to the files that use them. */
+PRIVILEGED_DATA static SlabCache_t xSlabCaches[ eSlabCacheCount ] =
+{
+	{ slabALIGN_SIZE( sizeof( StaticTask_t ) ) },			/* eSlabCacheTask */
+	{ slabALIGN_SIZE( sizeof( StaticQueue_t ) ) },			/* eSlabCacheQueue */
+	{ slabALIGN_SIZE( sizeof( StaticTimer_t ) ) },			/* eSlabCacheTimer */
+	{ slabALIGN_SIZE( sizeof( StaticEventGroup_t ) ) },		/* eSlabCacheEventGroup */
+	{ slabALIGN_SIZE( sizeof( StaticStreamBuffer_t ) ) }	/* eSlabCacheStreamBuffer */
+};
+
+/*-----------------------------------------------------------*/
+
+void *pvSlabCacheAllocate( eSlabCache eCache, size_t xWantedSize )
+{
+SlabCache_t *pxCache;
+void *pvReturn;
+
+	configASSERT( eCache < eSlabCacheCount );
+	pxCache = &( xSlabCaches[ eCache ] );
+
+	/* The object must fit in the cache.  If this assert fails then the
+	StaticXxx_t structure for the object does not match the real structure. */
+	configASSERT( xWantedSize <= pxCache->xObjectSize );
+	( void ) xWantedSize;
+
+	/* Keep adding slabs until an object is obtained or the heap is exhausted,
+	as another task could take the objects from a new slab before this task
+	takes one. */
+	pvReturn = prvTakeFreeObject( pxCache );
+
+	while( pvReturn == NULL )
+	{
+		if( prvAddSlab( pxCache ) == pdFAIL )
+		{
+			taskENTER_CRITICAL();
+			{
+				( pxCache->xNumberOfFailedAllocations )++;
+			}
+			taskEXIT_CRITICAL();
+
+			break;
+		}
+		else
+		{
+			pvReturn = prvTakeFreeObject( pxCache );
+		}
+	}
+
+	traceSLAB_CACHE_ALLOCATE( eCache, pvReturn );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vSlabCacheFree( eSlabCache eCache, void *pvObject )
+{
+SlabCache_t *pxCache;
+SlabFreeObject_t *pxObject = ( SlabFreeObject_t * ) pvObject; /*lint !e9079 !e9087 The object was allocated from the cache and is aligned for any kernel structure. */
+
+	configASSERT( eCache < eSlabCacheCount );
+	configASSERT( pvObject );
+	pxCache = &( xSlabCaches[ eCache ] );
+
+	traceSLAB_CACHE_FREE( eCache, pvObject );
+
+	taskENTER_CRITICAL();
+	{
+		configASSERT( pxCache->xObjectsInUse > ( size_t ) 0 );
+
+		pxObject->pxNextFreeObject = pxCache->pxFreeObjects;
+		pxCache->pxFreeObjects = pxObject;
+
+		( pxCache->xObjectsInUse )--;
+		( pxCache->xObjectsFree )++;
+		( pxCache->xNumberOfSuccessfulFrees )++;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSlabCacheReserve( eSlabCache eCache, size_t xObjects )
+{
+SlabCache_t *pxCache;
+size_t xObjectsFree;
+BaseType_t xReturn = pdFAIL, xSlabAdded = pdPASS;
+
+	configASSERT( eCache < eSlabCacheCount );
+	pxCache = &( xSlabCaches[ eCache ] );
+
+	while( ( xReturn == pdFAIL ) && ( xSlabAdded == pdPASS ) )
+	{
+		taskENTER_CRITICAL();
+		{
+			xObjectsFree = pxCache->xObjectsFree;
+		}
+		taskEXIT_CRITICAL();
+
+		if( xObjectsFree >= xObjects )
+		{
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xSlabAdded = prvAddSlab( pxCache );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vSlabCacheGetStats( eSlabCache eCache, SlabCacheStats_t *pxStats )
+{
+const SlabCache_t *pxCache;
+
+	configASSERT( eCache < eSlabCacheCount );
+	configASSERT( pxStats );
+	pxCache = &( xSlabCaches[ eCache ] );
+
+	taskENTER_CRITICAL();
+	{
+		pxStats->xObjectSize = pxCache->xObjectSize;
+		pxStats->xNumberOfSlabs = pxCache->xNumberOfSlabs;
+		pxStats->xObjectsInUse = pxCache->xObjectsInUse;
+		pxStats->xObjectsFree = pxCache->xObjectsFree;
+		pxStats->xMaximumObjectsInUse = pxCache->xMaximumObjectsInUse;
+		pxStats->xNumberOfSuccessfulAllocations = pxCache->xNumberOfSuccessfulAllocations;
+		pxStats->xNumberOfSuccessfulFrees = pxCache->xNumberOfSuccessfulFrees;
+		pxStats->xNumberOfFailedAllocations = pxCache->xNumberOfFailedAllocations;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAddSlab( SlabCache_t *pxCache )
+{
+SlabHeader_t *pxSlab;
+SlabFreeObject_t *pxFirstObject, *pxObject;
+uint8_t *pucObject;
+UBaseType_t uxObject;
+BaseType_t xReturn;
+const size_t xHeaderSize = portKERNEL_OBJECT_SIZE( slabHEADER_SIZE );
+const size_t xObjectStride = portKERNEL_OBJECT_SIZE( pxCache->xObjectSize );
+
+	/* Obtain the slab from the heap outside of the critical section, as
+	pvPortMalloc() may suspend the scheduler.  If kernel objects are aligned
+	to more than portBYTE_ALIGNMENT then the slab, its header and each object
+	are all rounded to that alignment, so no two objects share a cache
+	line. */
+	pxSlab = ( SlabHeader_t * ) pvPortMallocKernelObject( xHeaderSize + ( ( size_t ) configSLAB_OBJECTS_PER_SLAB * xObjectStride ) ); /*lint !e9079 !e9087 pvPortMalloc() returns memory aligned for any kernel structure. */
+
+	if( pxSlab != NULL )
+	{
+		/* Link the objects in the new slab together before touching the cache,
+		so the critical section below is short. */
+		pucObject = ( ( uint8_t * ) pxSlab ) + xHeaderSize;
+		pxFirstObject = ( SlabFreeObject_t * ) pucObject; /*lint !e9079 !e9087 Objects are aligned by slabALIGN_SIZE(). */
+		pxObject = pxFirstObject;
+
+		for( uxObject = ( UBaseType_t ) 1; uxObject < ( UBaseType_t ) configSLAB_OBJECTS_PER_SLAB; uxObject++ )
+		{
+			pucObject += xObjectStride;
+			pxObject->pxNextFreeObject = ( SlabFreeObject_t * ) pucObject; /*lint !e9079 !e9087 Objects are aligned by slabALIGN_SIZE(). */
+			pxObject = pxObject->pxNextFreeObject;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			pxSlab->pxNextSlab = pxCache->pxSlabs;
+			pxCache->pxSlabs = pxSlab;
+
+			pxObject->pxNextFreeObject = pxCache->pxFreeObjects;
+			pxCache->pxFreeObjects = pxFirstObject;
+
+			( pxCache->xNumberOfSlabs )++;
+			pxCache->xObjectsFree += ( size_t ) configSLAB_OBJECTS_PER_SLAB;
+		}
+		taskEXIT_CRITICAL();
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTakeFreeObject( SlabCache_t *pxCache )
+{
+SlabFreeObject_t *pxObject;
+
+	taskENTER_CRITICAL();
+	{
+		pxObject = pxCache->pxFreeObjects;
+
+		if( pxObject != NULL )
+		{
+			pxCache->pxFreeObjects = pxObject->pxNextFreeObject;
+
+			( pxCache->xObjectsFree )--;
+			( pxCache->xObjectsInUse )++;
+			( pxCache->xNumberOfSuccessfulAllocations )++;
+
+			if( pxCache->xObjectsInUse > pxCache->xMaximumObjectsInUse )
+			{
+				pxCache->xMaximumObjectsInUse = pxCache->xObjectsInUse;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return pxObject;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to use kernel object slab caches.  If you want to use slab caches then ensure
+configUSE_KERNEL_OBJECT_SLABS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_KERNEL_OBJECT_SLABS == 1 */
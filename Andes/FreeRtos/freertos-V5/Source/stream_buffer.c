@@ -38,6 +38,11 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "stream_buffer.h"
+#include "slab.h"
+
+#if( configUSE_CO_ROUTINES == 1 )
+	#include "croutine.h"
+#endif
 
 #if( configUSE_TASK_NOTIFICATIONS != 1 )
 	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build stream_buffer.c
@@ -49,6 +54,35 @@ for the header files above, but not in this file, in order to generate the
 correct privileged Vs unprivileged linkage and placement. */
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
 
+/* A co-routine blocked on a stream buffer waits for its co-routine notification
+in the same way a task waits for its task notification.  Unlike the task
+handles, the co-routine handles are cleared by the co-routine itself, when
+crSTREAM_BUFFER_SEND() or crSTREAM_BUFFER_RECEIVE() makes its second call. */
+#if( configUSE_CO_ROUTINES == 1 )
+	#define sbNOTIFY_COROUTINE( xCoRoutine )											\
+		if( ( xCoRoutine ) != NULL )													\
+		{																				\
+			( void ) xCoRoutineNotify( ( xCoRoutine ), ( uint32_t ) 0, eNoAction );		\
+		}
+
+	#define sbNOTIFY_COROUTINE_FROM_ISR( xCoRoutine, pxHigherPriorityTaskWoken )		\
+		if( ( xCoRoutine ) != NULL )													\
+		{																				\
+			( void ) xCoRoutineNotifyFromISR( ( xCoRoutine ),							\
+											  ( uint32_t ) 0,							\
+											  eNoAction,								\
+											  pxHigherPriorityTaskWoken );				\
+		}
+
+	#define sbCOROUTINE_WAITING_TO_RECEIVE( pxStreamBuffer )	( ( ( pxStreamBuffer )->xCoRoutineWaitingToReceive != NULL ) ? pdTRUE : pdFALSE )
+	#define sbCOROUTINE_WAITING_TO_SEND( pxStreamBuffer )		( ( ( pxStreamBuffer )->xCoRoutineWaitingToSend != NULL ) ? pdTRUE : pdFALSE )
+#else
+	#define sbNOTIFY_COROUTINE( xCoRoutine )
+	#define sbNOTIFY_COROUTINE_FROM_ISR( xCoRoutine, pxHigherPriorityTaskWoken )
+	#define sbCOROUTINE_WAITING_TO_RECEIVE( pxStreamBuffer )	pdFALSE
+	#define sbCOROUTINE_WAITING_TO_SEND( pxStreamBuffer )		pdFALSE
+#endif /* configUSE_CO_ROUTINES */
+
 /* If the user has not provided application specific Rx notification macros,
 or #defined the notification macros away, them provide default implementations
 that uses task notifications. */
@@ -64,6 +98,7 @@ that uses task notifications. */
 									  eNoAction );										\
 				( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
 			}																			\
+			sbNOTIFY_COROUTINE( ( pxStreamBuffer )->xCoRoutineWaitingToSend );			\
 		}																				\
 		( void ) xTaskResumeAll();
 #endif /* sbRECEIVE_COMPLETED */
@@ -84,6 +119,8 @@ that uses task notifications. */
 											 pxHigherPriorityTaskWoken );				\
 				( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
 			}																			\
+			sbNOTIFY_COROUTINE_FROM_ISR( ( pxStreamBuffer )->xCoRoutineWaitingToSend,	\
+										 pxHigherPriorityTaskWoken );					\
 		}																				\
 		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
 	}
@@ -103,6 +140,7 @@ that uses task notifications. */
 									  eNoAction );										\
 				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
 			}																			\
+			sbNOTIFY_COROUTINE( ( pxStreamBuffer )->xCoRoutineWaitingToReceive );		\
 		}																				\
 		( void ) xTaskResumeAll();
 #endif /* sbSEND_COMPLETED */
@@ -122,6 +160,8 @@ that uses task notifications. */
 											 pxHigherPriorityTaskWoken );				\
 				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
 			}																			\
+			sbNOTIFY_COROUTINE_FROM_ISR( ( pxStreamBuffer )->xCoRoutineWaitingToReceive,	\
+										 pxHigherPriorityTaskWoken );					\
 		}																				\
 		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
 	}
@@ -152,6 +192,16 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxStreamBufferNumber;		/* Used for tracing purposes. */
 	#endif
+
+	#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+		QueueSetHandle_t xQueueSetContainer;	/* The queue set the stream buffer is in, or NULL. */
+		UBaseType_t uxQueueSetMemberIndex;		/* The slot the stream buffer occupies in its queue set. */
+	#endif
+
+	#if ( configUSE_CO_ROUTINES == 1 )
+		volatile CoRoutineHandle_t xCoRoutineWaitingToReceive;	/* Holds the handle of a co-routine waiting for data, or NULL. */
+		volatile CoRoutineHandle_t xCoRoutineWaitingToSend;		/* Holds the handle of a co-routine waiting to send data to a stream buffer that is full. */
+	#endif
 } StreamBuffer_t;
 
 /*
@@ -212,6 +262,15 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  size_t xTriggerLevelBytes,
 										  uint8_t ucFlags ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_QUEUE_SET_BITMAP == 1 )
+	/*
+	 * Marks the stream buffer as ready in the queue set it is a member of, if
+	 * any, after data has been written to it.
+	 */
+	static void prvNotifyQueueSetContainer( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+	static void prvNotifyQueueSetContainerFromISR( const StreamBuffer_t * const pxStreamBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -219,6 +278,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 	StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, BaseType_t xIsMessageBuffer )
 	{
 	uint8_t *pucAllocatedMemory;
+	uint8_t *pucStorage = NULL;
 	uint8_t ucFlags;
 
 		/* In case the stream buffer is going to be used as a message buffer
@@ -253,14 +313,55 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 		incremented so the free space is returned as the user would expect -
 		this is a quirk of the implementation that means otherwise the free
 		space would be reported as one byte smaller than would be logically
-		expected. */
+		expected.  If configUSE_KERNEL_OBJECT_SLABS is 1 then the structure is
+		instead allocated from the stream buffer slab cache, and only the buffer
+		is allocated using pvPortMalloc(). */
 		xBufferSizeBytes++;
-		pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xBufferSizeBytes + sizeof( StreamBuffer_t ) ); /*lint !e9079 malloc() only returns void*. */
+
+		#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+		{
+			pucAllocatedMemory = ( uint8_t * ) slabALLOCATE_OBJECT( eSlabCacheStreamBuffer, sizeof( StreamBuffer_t ) ); /*lint !e9079 Slab objects are returned as void*. */
+
+			if( pucAllocatedMemory != NULL )
+			{
+				pucStorage = ( uint8_t * ) pvPortMallocKernelObject( xBufferSizeBytes ); /*lint !e9079 malloc() only returns void*. */
+
+				if( pucStorage == NULL )
+				{
+					slabFREE_OBJECT( eSlabCacheStreamBuffer, pucAllocatedMemory );
+					pucAllocatedMemory = NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			pucAllocatedMemory = ( uint8_t * ) pvPortMallocKernelObject( xBufferSizeBytes + portKERNEL_OBJECT_SIZE( sizeof( StreamBuffer_t ) ) ); /*lint !e9079 malloc() only returns void*. */
+
+			if( pucAllocatedMemory != NULL )
+			{
+				/* The storage area follows the structure, and is aligned in
+				the same way. */
+				pucStorage = pucAllocatedMemory + portKERNEL_OBJECT_SIZE( sizeof( StreamBuffer_t ) ); /*lint !e9016 Indexing past structure valid for uint8_t pointer, also storage area has no alignment requirement. */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_KERNEL_OBJECT_SLABS */
 
 		if( pucAllocatedMemory != NULL )
 		{
 			prvInitialiseNewStreamBuffer( ( StreamBuffer_t * ) pucAllocatedMemory, /* Structure at the start of the allocated memory. */ /*lint !e9087 Safe cast as allocated memory is aligned. */ /*lint !e826 Area is not too small and alignment is guaranteed provided malloc() behaves as expected and returns aligned buffer. */
-										   pucAllocatedMemory + sizeof( StreamBuffer_t ),  /* Storage area follows. */ /*lint !e9016 Indexing past structure valid for uint8_t pointer, also storage area has no alignment requirement. */
+										   pucStorage,
 										   xBufferSizeBytes,
 										   xTriggerLevelBytes,
 										   ucFlags );
@@ -364,9 +465,30 @@ StreamBuffer_t * pxStreamBuffer = xStreamBuffer;
 
 	traceSTREAM_BUFFER_DELETE( xStreamBuffer );
 
+	#if( configUSE_QUEUE_SET_BITMAP == 1 )
+	{
+		/* Do not leave a deleted stream buffer in the member table of a set. */
+		if( pxStreamBuffer->xQueueSetContainer != NULL )
+		{
+			( void ) xStreamBufferRemoveFromSet( pxStreamBuffer, pxStreamBuffer->xQueueSetContainer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
 	{
-		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		#if( configUSE_KERNEL_OBJECT_SLABS == 1 )
+		{
+			/* The buffer was allocated using pvPortMalloc() and the structure
+			was allocated from the stream buffer slab cache. */
+			vPortFree( ( void * ) pxStreamBuffer->pucBuffer );
+			slabFREE_OBJECT( eSlabCacheStreamBuffer, pxStreamBuffer );
+		}
+		#elif( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 		{
 			/* Both the structure and the buffer were allocated using a single call
 			to pvPortMalloc(), hence only one call to vPortFree() is required. */
@@ -398,6 +520,11 @@ BaseType_t xReturn = pdFAIL;
 	UBaseType_t uxStreamBufferNumber;
 #endif
 
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+	QueueSetHandle_t xQueueSetContainer;
+	UBaseType_t uxQueueSetMemberIndex;
+#endif
+
 	configASSERT( pxStreamBuffer );
 
 	#if( configUSE_TRACE_FACILITY == 1 )
@@ -408,13 +535,24 @@ BaseType_t xReturn = pdFAIL;
 	}
 	#endif
 
-	/* Can only reset a message buffer if there are no tasks blocked on it. */
+	/* Can only reset a message buffer if there are no tasks or co-routines
+	blocked on it. */
 	taskENTER_CRITICAL();
 	{
-		if( pxStreamBuffer->xTaskWaitingToReceive == NULL )
+		if( ( pxStreamBuffer->xTaskWaitingToReceive == NULL ) && ( sbCOROUTINE_WAITING_TO_RECEIVE( pxStreamBuffer ) == pdFALSE ) )
 		{
-			if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			if( ( pxStreamBuffer->xTaskWaitingToSend == NULL ) && ( sbCOROUTINE_WAITING_TO_SEND( pxStreamBuffer ) == pdFALSE ) )
 			{
+				#if( configUSE_QUEUE_SET_BITMAP == 1 )
+				{
+					/* The queue set still refers to the stream buffer, so the
+					stream buffer must stay a member of the set after the
+					reset. */
+					xQueueSetContainer = pxStreamBuffer->xQueueSetContainer;
+					uxQueueSetMemberIndex = pxStreamBuffer->uxQueueSetMemberIndex;
+				}
+				#endif
+
 				prvInitialiseNewStreamBuffer( pxStreamBuffer,
 											  pxStreamBuffer->pucBuffer,
 											  pxStreamBuffer->xLength,
@@ -428,6 +566,13 @@ BaseType_t xReturn = pdFAIL;
 				}
 				#endif
 
+				#if( configUSE_QUEUE_SET_BITMAP == 1 )
+				{
+					pxStreamBuffer->xQueueSetContainer = xQueueSetContainer;
+					pxStreamBuffer->uxQueueSetMemberIndex = uxQueueSetMemberIndex;
+				}
+				#endif
+
 				traceSTREAM_BUFFER_RESET( xStreamBuffer );
 			}
 		}
@@ -587,6 +732,12 @@ TimeOut_t xTimeOut;
 	{
 		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
 
+		#if( configUSE_QUEUE_SET_BITMAP == 1 )
+		{
+			prvNotifyQueueSetContainer( pxStreamBuffer );
+		}
+		#endif
+
 		/* Was a task waiting for the data? */
 		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
@@ -637,6 +788,12 @@ size_t xRequiredSpace = xDataLengthBytes;
 
 	if( xReturn > ( size_t ) 0 )
 	{
+		#if( configUSE_QUEUE_SET_BITMAP == 1 )
+		{
+			prvNotifyQueueSetContainerFromISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		#endif
+
 		/* Was a task waiting for the data? */
 		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
@@ -1048,6 +1205,20 @@ UBaseType_t uxSavedInterruptStatus;
 		{
 			xReturn = pdFALSE;
 		}
+
+		#if( configUSE_CO_ROUTINES == 1 )
+		{
+			if( pxStreamBuffer->xCoRoutineWaitingToReceive != NULL )
+			{
+				( void ) xCoRoutineNotifyFromISR( pxStreamBuffer->xCoRoutineWaitingToReceive, ( uint32_t ) 0, eNoAction, pxHigherPriorityTaskWoken );
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
 	}
 	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
@@ -1078,6 +1249,20 @@ UBaseType_t uxSavedInterruptStatus;
 		{
 			xReturn = pdFALSE;
 		}
+
+		#if( configUSE_CO_ROUTINES == 1 )
+		{
+			if( pxStreamBuffer->xCoRoutineWaitingToSend != NULL )
+			{
+				( void ) xCoRoutineNotifyFromISR( pxStreamBuffer->xCoRoutineWaitingToSend, ( uint32_t ) 0, eNoAction, pxHigherPriorityTaskWoken );
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
 	}
 	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
@@ -1085,6 +1270,354 @@ UBaseType_t uxSavedInterruptStatus;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_CO_ROUTINES == 1 )
+
+	BaseType_t xStreamBufferCRSend( StreamBufferHandle_t xStreamBuffer,
+									const void *pvTxData,
+									size_t xDataLengthBytes,
+									size_t *pxBytesSent,
+									TickType_t xTicksToWait )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+	CoRoutineHandle_t const xCurrentCoRoutine = xCoRoutineGetCurrentHandle();
+	size_t xRequiredSpace = xDataLengthBytes;
+	BaseType_t xReturn = pdFAIL;
+
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxBytesSent );
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		taskENTER_CRITICAL();
+		{
+			if( pxStreamBuffer->xCoRoutineWaitingToSend == xCurrentCoRoutine )
+			{
+				/* This is the second call made by crSTREAM_BUFFER_SEND() after
+				the co-routine blocked - either space became available or the
+				block time expired.  Stop waiting, and clear the notification
+				state used to wait. */
+				pxStreamBuffer->xCoRoutineWaitingToSend = NULL;
+				( void ) xCoRoutineNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, 0 );
+			}
+			else if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xStreamBufferSpacesAvailable( pxStreamBuffer ) < xRequiredSpace ) )
+			{
+				/* Should only be one writer. */
+				configASSERT( pxStreamBuffer->xCoRoutineWaitingToSend == NULL );
+				pxStreamBuffer->xCoRoutineWaitingToSend = xCurrentCoRoutine;
+
+				/* Clear notification state, then block waiting for space. */
+				( void ) xCoRoutineNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, 0 );
+				xReturn = xCoRoutineNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xReturn == errQUEUE_BLOCKED )
+		{
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+		}
+		else
+		{
+			*pxBytesSent = xStreamBufferSend( xStreamBuffer, pvTxData, xDataLengthBytes, 0 );
+
+			if( *pxBytesSent != ( size_t ) 0 )
+			{
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINES == 1 )
+
+	BaseType_t xStreamBufferCRReceive( StreamBufferHandle_t xStreamBuffer,
+									   void *pvRxData,
+									   size_t xBufferLengthBytes,
+									   size_t *pxReceivedBytes,
+									   TickType_t xTicksToWait )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+	CoRoutineHandle_t const xCurrentCoRoutine = xCoRoutineGetCurrentHandle();
+	size_t xBytesToStoreMessageLength;
+	BaseType_t xReturn = pdFAIL;
+
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxReceivedBytes );
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		}
+		else
+		{
+			xBytesToStoreMessageLength = 0;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			if( pxStreamBuffer->xCoRoutineWaitingToReceive == xCurrentCoRoutine )
+			{
+				/* This is the second call made by crSTREAM_BUFFER_RECEIVE()
+				after the co-routine blocked - either data arrived or the block
+				time expired.  Stop waiting, and clear the notification state
+				used to wait. */
+				pxStreamBuffer->xCoRoutineWaitingToReceive = NULL;
+				( void ) xCoRoutineNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, 0 );
+			}
+			else if( ( xTicksToWait != ( TickType_t ) 0 ) && ( prvBytesInBuffer( pxStreamBuffer ) <= xBytesToStoreMessageLength ) )
+			{
+				/* Should only be one reader. */
+				configASSERT( pxStreamBuffer->xCoRoutineWaitingToReceive == NULL );
+				pxStreamBuffer->xCoRoutineWaitingToReceive = xCurrentCoRoutine;
+
+				/* Clear notification state, then block waiting for data. */
+				( void ) xCoRoutineNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, 0 );
+				xReturn = xCoRoutineNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xReturn == errQUEUE_BLOCKED )
+		{
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+		}
+		else
+		{
+			*pxReceivedBytes = xStreamBufferReceive( xStreamBuffer, pvRxData, xBufferLengthBytes, 0 );
+
+			if( *pxReceivedBytes != ( size_t ) 0 )
+			{
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	BaseType_t xStreamBufferAddToSet( StreamBufferHandle_t xStreamBuffer, QueueSetHandle_t xQueueSet )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+	UBaseType_t uxMemberIndex;
+	BaseType_t xReturn, xYieldRequired = pdFALSE;
+
+		configASSERT( pxStreamBuffer );
+		configASSERT( xQueueSet );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxStreamBuffer->xQueueSetContainer != NULL )
+			{
+				/* Cannot add a stream buffer to more than one queue set. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				xReturn = xQueueSetAddMember( xQueueSet, pxStreamBuffer, queueSET_MEMBER_TYPE_STREAM_BUFFER, &uxMemberIndex );
+
+				if( xReturn != pdFAIL )
+				{
+					pxStreamBuffer->xQueueSetContainer = xQueueSet;
+					pxStreamBuffer->uxQueueSetMemberIndex = uxMemberIndex;
+
+					/* A stream buffer that already contains data is ready as
+					soon as it is in the set. */
+					if( prvBytesInBuffer( pxStreamBuffer ) != ( size_t ) 0 )
+					{
+						xYieldRequired = xQueueSetMemberReady( xQueueSet, uxMemberIndex );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		#if( configUSE_PREEMPTION == 1 )
+		{
+			if( xYieldRequired != pdFALSE )
+			{
+				taskYIELD();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			( void ) xYieldRequired;
+		}
+		#endif
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	BaseType_t xStreamBufferRemoveFromSet( StreamBufferHandle_t xStreamBuffer, QueueSetHandle_t xQueueSet )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+	BaseType_t xReturn;
+
+		configASSERT( pxStreamBuffer );
+
+		taskENTER_CRITICAL();
+		{
+			if( ( xQueueSet == NULL ) || ( pxStreamBuffer->xQueueSetContainer != xQueueSet ) )
+			{
+				/* The stream buffer was not a member of the set. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				vQueueSetRemoveMember( xQueueSet, pxStreamBuffer->uxQueueSetMemberIndex );
+				pxStreamBuffer->xQueueSetContainer = NULL;
+				xReturn = pdPASS;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static void prvNotifyQueueSetContainer( const StreamBuffer_t * const pxStreamBuffer )
+	{
+	BaseType_t xYieldRequired = pdFALSE;
+
+		/* Only stream buffers that are in a set pay for the critical section.
+		The container is checked again inside the critical section in case the
+		stream buffer was removed from the set in the meantime. */
+		if( pxStreamBuffer->xQueueSetContainer != NULL )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( pxStreamBuffer->xQueueSetContainer != NULL )
+				{
+					xYieldRequired = xQueueSetMemberReady( pxStreamBuffer->xQueueSetContainer, pxStreamBuffer->uxQueueSetMemberIndex );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			#if( configUSE_PREEMPTION == 1 )
+			{
+				if( xYieldRequired != pdFALSE )
+				{
+					taskYIELD();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#else
+			{
+				( void ) xYieldRequired;
+			}
+			#endif
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_SET_BITMAP == 1 )
+
+	static void prvNotifyQueueSetContainerFromISR( const StreamBuffer_t * const pxStreamBuffer, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		if( pxStreamBuffer->xQueueSetContainer != NULL )
+		{
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				if( pxStreamBuffer->xQueueSetContainer != NULL )
+				{
+					if( xQueueSetMemberReady( pxStreamBuffer->xQueueSetContainer, pxStreamBuffer->uxQueueSetMemberIndex ) != pdFALSE )
+					{
+						if( pxHigherPriorityTaskWoken != NULL )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_SET_BITMAP */
+/*-----------------------------------------------------------*/
+
 static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
 {
 size_t xNextHead, xFirstLength;
@@ -39,6 +39,8 @@ task.h is included from an application file. */
 #include "task.h"
 #include "timers.h"
 #include "stack_macros.h"
+#include "slab.h"
+#include "section_profile.h"
 
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
 because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
@@ -267,8 +269,18 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 		StackType_t		*pxEndOfStack;		/*< Points to the highest valid address for the stack. */
 	#endif
 
+	#if ( configRECORD_STACK_PEAK == 1 )
+		StackType_t		*pxStackPeak;		/*< The lowest stack pointer the task has reached, as recorded by the port when the task stops running.  Must follow pxEndOfStack as the port accesses it at a fixed offset. */
+	#endif
+
 	#if ( portCRITICAL_NESTING_IN_TCB == 1 )
 		UBaseType_t		uxCriticalNesting;	/*< Holds the critical section nesting depth for ports that do not maintain their own count in the port layer. */
+
+		#if ( configUSE_SECTION_PROFILING == 1 )
+			uint32_t	ulCriticalStart;	/*< The cycle count when the outermost critical section was entered, or when the task was last switched in from within it. */
+			uint32_t	ulCriticalCycles;	/*< The cycles spent in the outermost critical section before the task last yielded from within it. */
+			void		*pvCriticalCaller;	/*< The return address of the call that entered the outermost critical section. */
+		#endif
 	#endif
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -279,6 +291,16 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 	#if ( configUSE_MUTEXES == 1 )
 		UBaseType_t		uxBasePriority;		/*< The priority last assigned to the task - used by the priority inheritance mechanism. */
 		UBaseType_t		uxMutexesHeld;
+
+		#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+			void		*pvMutexesHeld;		/*< The most recently taken mutex that is still held.  The other mutexes held by the task are chained from it by queue.c. */
+			void		*pvMutexBlockedOn;	/*< The mutex the task is waiting to obtain, or NULL if it is not waiting for a mutex. */
+
+			#if ( configUSE_RW_LOCKS == 1 )
+				void	*pvRWLocksHeld;		/*< The most recently obtained reader-writer lock that is still held for writing.  The others are chained from it by rwlock.c. */
+				void	*pvRWLockBlockedOn;	/*< The reader-writer lock the task is waiting to obtain, or NULL if it is not waiting for a lock. */
+			#endif
+		#endif
 	#endif
 
 	#if ( configUSE_APPLICATION_TASK_TAG == 1 )
@@ -289,6 +311,16 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 		void			*pvThreadLocalStoragePointers[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
 	#endif
 
+	#if( configUSE_TASK_HEAP_CACHE == 1 )
+		void			*pvHeapCache[ configHEAP_CACHE_SIZE_CLASSES ];	/*< Small heap blocks freed by the task and held for reuse.  Only accessed by the heap implementation. */
+	#endif
+
+	#if( configUSE_SHARED_STACK_TASKS == 1 )
+		TaskRunToCompletionFunction_t pxRunToCompletionCode;	/*< The handler of a run to completion task. */
+		void			*pvRunToCompletionParameters;	/*< The parameter passed to pxRunToCompletionCode. */
+		struct xSHARED_STACK *pxSharedStack;	/*< The stack shared by the run to completion tasks of the task's priority, or NULL if the task has its own stack. */
+	#endif
+
 	#if( configGENERATE_RUN_TIME_STATS == 1 )
 		uint32_t		ulRunTimeCounter;	/*< Stores the amount of time the task has spent in the Running state. */
 	#endif
@@ -332,6 +364,43 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 below to enable the use of older kernel aware debuggers. */
 typedef tskTCB TCB_t;
 
+/* Ports that access TCB members from assembly code at fixed offsets can check
+the offsets against the structure above when the kernel is built. */
+#ifdef portCHECK_TCB_OFFSETS
+	portCHECK_TCB_OFFSETS();
+#endif
+
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	/*
+	 * A stack used by all the run to completion tasks of one priority.  At most
+	 * one of those tasks can have a handler in progress at any time - it is
+	 * recorded as the owner of the stack until its handler returns.
+	 */
+	typedef struct xSHARED_STACK
+	{
+		StackType_t		*pxStack;			/*< Points to the start of the stack. */
+		StackType_t		*pxTopOfStack;		/*< The aligned top of the stack, from which every handler starts. */
+		TCB_t * volatile pxOwner;			/*< The task whose handler is running on the stack, or NULL if the stack is free. */
+	} SharedStack_t;
+
+	#define taskIS_RUN_TO_COMPLETION( pxTCB ) ( ( pxTCB )->pxSharedStack != NULL )
+	#define taskUSES_SHARED_STACK( pxTaskCode ) ( ( pxTaskCode ) == prvRunToCompletionTask )
+
+	/* A task that owns its shared stack has a handler in progress, so must
+	remain in a ready list until the handler returns.  Otherwise the other run
+	to completion tasks of the same priority could not run, as they need the
+	stack it is using. */
+	#define taskOWNS_SHARED_STACK( pxTCB ) ( ( taskIS_RUN_TO_COMPLETION( pxTCB ) && ( ( pxTCB )->pxSharedStack->pxOwner == ( pxTCB ) ) ) ? pdTRUE : pdFALSE )
+
+#else
+
+	#define taskIS_RUN_TO_COMPLETION( pxTCB ) ( pdFALSE )
+	#define taskUSES_SHARED_STACK( pxTaskCode ) ( pdFALSE )
+	#define taskOWNS_SHARED_STACK( pxTCB ) ( pdFALSE )
+
+#endif /* configUSE_SHARED_STACK_TASKS */
+
 /*lint -save -e956 A manual analysis and inspection has been used to determine
 which static variables must be declared volatile. */
 PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
@@ -360,6 +429,12 @@ PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been r
 
 #endif
 
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	PRIVILEGED_DATA static SharedStack_t xSharedStacks[ configMAX_PRIORITIES ];	/*< Stacks of the run to completion tasks, allocated on first use. */
+
+#endif
+
 /* Global POSIX errno. Its value is changed upon context switching to match
 the errno of the currently running task. */
 #if ( configUSE_POSIX_ERRNO == 1 )
@@ -397,6 +472,13 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t
 
 #endif
 
+#if ( configUSE_SECTION_PROFILING == 1 )
+
+	PRIVILEGED_DATA static uint32_t ulSchedulerSuspendedStart = 0UL;		/*< The cycle count when the scheduler was last suspended. */
+	PRIVILEGED_DATA static void *pvSchedulerSuspendedCaller = NULL;		/*< The return address of the vTaskSuspendAll() call that last suspended the scheduler. */
+
+#endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -507,7 +589,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  * This function determines the 'high water mark' of the task stack by
  * determining how much of the stack remains at the original preset value.
  */
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) && ( configRECORD_STACK_PEAK == 0 ) ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
 
 	static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte ) PRIVILEGED_FUNCTION;
 
@@ -563,6 +645,30 @@ static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	/*
+	 * The code executed by every run to completion task.  Calls the task's
+	 * handler with the notification value, then abandons the frame on the
+	 * shared stack and waits for the next notification.  Never returns.
+	 */
+	static portTASK_FUNCTION_PROTO( prvRunToCompletionTask, pvParameters );
+
+	/*
+	 * Returns the stack shared by the run to completion tasks of priority
+	 * uxPriority, allocating it if this is the first such task.
+	 */
+	static SharedStack_t *prvGetSharedStack( UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called when the scheduler has selected a run to completion task.  Either
+	 * starts the task's handler from the top of the shared stack, or selects the
+	 * task whose handler is already running on that stack instead.
+	 */
+	static void prvSwitchToSharedStack( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_SHARED_STACK_TASKS */
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -693,7 +799,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 			/* Allocate space for the TCB.  Where the memory comes from depends
 			on the implementation of the port malloc function and whether or
 			not static allocation is being used. */
-			pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+			pxNewTCB = ( TCB_t * ) slabALLOCATE_OBJECT( eSlabCacheTask, sizeof( TCB_t ) );
 
 			if( pxNewTCB != NULL )
 			{
@@ -748,19 +854,19 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 			/* Allocate space for the TCB.  Where the memory comes from depends on
 			the implementation of the port malloc function and whether or not static
 			allocation is being used. */
-			pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+			pxNewTCB = ( TCB_t * ) slabALLOCATE_OBJECT( eSlabCacheTask, sizeof( TCB_t ) );
 
 			if( pxNewTCB != NULL )
 			{
 				/* Allocate space for the stack used by the task being created.
 				The base of the stack memory stored in the TCB so the task can
 				be deleted later if required. */
-				pxNewTCB->pxStack = ( StackType_t * ) pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+				pxNewTCB->pxStack = ( StackType_t * ) pvPortMallocKernelObject( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 				if( pxNewTCB->pxStack == NULL )
 				{
 					/* Could not allocate the stack.  Delete the allocated TCB. */
-					vPortFree( pxNewTCB );
+					slabFREE_OBJECT( eSlabCacheTask, pxNewTCB );
 					pxNewTCB = NULL;
 				}
 			}
@@ -770,12 +876,12 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 		StackType_t *pxStack;
 
 			/* Allocate space for the stack used by the task being created. */
-			pxStack = pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+			pxStack = pvPortMallocKernelObject( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
 
 			if( pxStack != NULL )
 			{
 				/* Allocate space for the TCB. */
-				pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+				pxNewTCB = ( TCB_t * ) slabALLOCATE_OBJECT( eSlabCacheTask, sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
 
 				if( pxNewTCB != NULL )
 				{
@@ -821,6 +927,71 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	BaseType_t xTaskCreateRunToCompletion(	TaskRunToCompletionFunction_t pxTaskCode,
+											const char * const pcName,	/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+											void * const pvParameters,
+											UBaseType_t uxPriority,
+											TaskHandle_t * const pxCreatedTask )
+	{
+	TCB_t *pxNewTCB = NULL;
+	SharedStack_t *pxSharedStack;
+	BaseType_t xReturn;
+
+		configASSERT( pxTaskCode );
+
+		if( uxPriority >= ( UBaseType_t ) configMAX_PRIORITIES )
+		{
+			uxPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) 1U;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Only the TCB is allocated per task.  The stack is allocated once per
+		priority. */
+		pxSharedStack = prvGetSharedStack( uxPriority );
+
+		if( pxSharedStack != NULL )
+		{
+			pxNewTCB = ( TCB_t * ) slabALLOCATE_OBJECT( eSlabCacheTask, sizeof( TCB_t ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxNewTCB != NULL )
+		{
+			pxNewTCB->pxStack = pxSharedStack->pxStack;
+
+			#if( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+			{
+				/* The stack does not belong to the task, so must not be freed
+				if the task is deleted. */
+				pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_ONLY;
+			}
+			#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+
+			prvInitialiseNewTask( prvRunToCompletionTask, pcName, ( uint32_t ) configSHARED_STACK_DEPTH, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
+			pxNewTCB->pxRunToCompletionCode = pxTaskCode;
+			pxNewTCB->pxSharedStack = pxSharedStack;
+			prvAddNewTaskToReadyList( pxNewTCB );
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_SHARED_STACK_TASKS */
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
 									const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 									const uint32_t ulStackDepth,
@@ -847,8 +1018,20 @@ UBaseType_t x;
 		uxPriority &= ~portPRIVILEGE_BIT;
 	#endif /* portUSING_MPU_WRAPPERS == 1 */
 
-	/* Avoid dependency on memset() if it is not required. */
+	#if( configUSE_SHARED_STACK_TASKS == 1 )
+	{
+		/* xTaskCreateRunToCompletion() sets these after this function returns
+		when the task is a run to completion task. */
+		pxNewTCB->pxRunToCompletionCode = NULL;
+		pxNewTCB->pvRunToCompletionParameters = pvParameters;
+		pxNewTCB->pxSharedStack = NULL;
+	}
+	#endif /* configUSE_SHARED_STACK_TASKS */
+
+	/* Avoid dependency on memset() if it is not required.  A shared stack is
+	filled when it is allocated, as another task may be using it now. */
 	#if( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+	if( taskUSES_SHARED_STACK( pxTaskCode ) == pdFALSE )
 	{
 		/* Fill the stack with a known value to assist debugging. */
 		( void ) memset( pxNewTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) ulStackDepth * sizeof( StackType_t ) );
@@ -874,6 +1057,12 @@ UBaseType_t x;
 			pxNewTCB->pxEndOfStack = pxTopOfStack;
 		}
 		#endif /* configRECORD_STACK_HIGH_ADDRESS */
+
+		#if( configRECORD_STACK_PEAK == 1 )
+		{
+			pxNewTCB->pxStackPeak = pxTopOfStack;
+		}
+		#endif /* configRECORD_STACK_PEAK */
 	}
 	#else /* portSTACK_GROWTH */
 	{
@@ -935,6 +1124,20 @@ UBaseType_t x;
 	{
 		pxNewTCB->uxBasePriority = uxPriority;
 		pxNewTCB->uxMutexesHeld = 0;
+
+		#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+		{
+			pxNewTCB->pvMutexesHeld = NULL;
+			pxNewTCB->pvMutexBlockedOn = NULL;
+
+			#if ( configUSE_RW_LOCKS == 1 )
+			{
+				pxNewTCB->pvRWLocksHeld = NULL;
+				pxNewTCB->pvRWLockBlockedOn = NULL;
+			}
+			#endif
+		}
+		#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
 	}
 	#endif /* configUSE_MUTEXES */
 
@@ -1009,57 +1212,76 @@ UBaseType_t x;
 	}
 	#endif
 
-	/* Initialize the TCB stack to look as if the task was already running,
-	but had been interrupted by the scheduler.  The return address is set
-	to the start of the task function. Once the stack has been initialised
-	the top of stack variable is updated. */
-	#if( portUSING_MPU_WRAPPERS == 1 )
+	#if( configUSE_TASK_HEAP_CACHE == 1 )
 	{
-		/* If the port has capability to detect stack overflow,
-		pass the stack end address to the stack initialization
-		function as well. */
-		#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+		for( x = 0; x < ( UBaseType_t ) configHEAP_CACHE_SIZE_CLASSES; x++ )
 		{
-			#if( portSTACK_GROWTH < 0 )
+			pxNewTCB->pvHeapCache[ x ] = NULL;
+		}
+	}
+	#endif
+
+	if( taskUSES_SHARED_STACK( pxTaskCode ) != pdFALSE )
+	{
+		/* A run to completion task has no context until it is selected to run,
+		at which point prvSwitchToSharedStack() creates one on the shared
+		stack. */
+		pxNewTCB->pxTopOfStack = NULL;
+	}
+	else
+	{
+		/* Initialize the TCB stack to look as if the task was already running,
+		but had been interrupted by the scheduler.  The return address is set
+		to the start of the task function. Once the stack has been initialised
+		the top of stack variable is updated. */
+		#if( portUSING_MPU_WRAPPERS == 1 )
+		{
+			/* If the port has capability to detect stack overflow,
+			pass the stack end address to the stack initialization
+			function as well. */
+			#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
 			{
-				pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters, xRunPrivileged );
+				#if( portSTACK_GROWTH < 0 )
+				{
+					pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters, xRunPrivileged );
+				}
+				#else /* portSTACK_GROWTH */
+				{
+					pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters, xRunPrivileged );
+				}
+				#endif /* portSTACK_GROWTH */
 			}
-			#else /* portSTACK_GROWTH */
+			#else /* portHAS_STACK_OVERFLOW_CHECKING */
 			{
-				pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters, xRunPrivileged );
+				pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters, xRunPrivileged );
 			}
-			#endif /* portSTACK_GROWTH */
-		}
-		#else /* portHAS_STACK_OVERFLOW_CHECKING */
-		{
-			pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters, xRunPrivileged );
+			#endif /* portHAS_STACK_OVERFLOW_CHECKING */
 		}
-		#endif /* portHAS_STACK_OVERFLOW_CHECKING */
-	}
-	#else /* portUSING_MPU_WRAPPERS */
-	{
-		/* If the port has capability to detect stack overflow,
-		pass the stack end address to the stack initialization
-		function as well. */
-		#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+		#else /* portUSING_MPU_WRAPPERS */
 		{
-			#if( portSTACK_GROWTH < 0 )
+			/* If the port has capability to detect stack overflow,
+			pass the stack end address to the stack initialization
+			function as well. */
+			#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
 			{
-				pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters );
+				#if( portSTACK_GROWTH < 0 )
+				{
+					pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters );
+				}
+				#else /* portSTACK_GROWTH */
+				{
+					pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters );
+				}
+				#endif /* portSTACK_GROWTH */
 			}
-			#else /* portSTACK_GROWTH */
+			#else /* portHAS_STACK_OVERFLOW_CHECKING */
 			{
-				pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters );
+				pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters );
 			}
-			#endif /* portSTACK_GROWTH */
-		}
-		#else /* portHAS_STACK_OVERFLOW_CHECKING */
-		{
-			pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters );
+			#endif /* portHAS_STACK_OVERFLOW_CHECKING */
 		}
-		#endif /* portHAS_STACK_OVERFLOW_CHECKING */
+		#endif /* portUSING_MPU_WRAPPERS */
 	}
-	#endif /* portUSING_MPU_WRAPPERS */
 
 	if( pxCreatedTask != NULL )
 	{
@@ -1084,8 +1306,17 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		if( pxCurrentTCB == NULL )
 		{
 			/* There are no other tasks, or all the other tasks are in
-			the suspended state - make this the current task. */
-			pxCurrentTCB = pxNewTCB;
+			the suspended state - make this the current task.  A run to
+			completion task is not ready until it is notified, so cannot be
+			made the current task. */
+			if( taskIS_RUN_TO_COMPLETION( pxNewTCB ) == pdFALSE )
+			{
+				pxCurrentTCB = pxNewTCB;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
 			if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
 			{
@@ -1106,7 +1337,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			so far. */
 			if( xSchedulerRunning == pdFALSE )
 			{
-				if( pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority )
+				if( ( pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority ) && ( taskIS_RUN_TO_COMPLETION( pxNewTCB ) == pdFALSE ) )
 				{
 					pxCurrentTCB = pxNewTCB;
 				}
@@ -1131,13 +1362,27 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		#endif /* configUSE_TRACE_FACILITY */
 		traceTASK_CREATE( pxNewTCB );
 
-		prvAddTaskToReadyList( pxNewTCB );
+		if( taskIS_RUN_TO_COMPLETION( pxNewTCB ) == pdFALSE )
+		{
+			prvAddTaskToReadyList( pxNewTCB );
+		}
+		else
+		{
+			/* A run to completion task starts off waiting indefinitely for
+			its first notification. */
+			#if( configUSE_SHARED_STACK_TASKS == 1 )
+			{
+				pxNewTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				vListInsertEnd( &xSuspendedTaskList, &( pxNewTCB->xStateListItem ) );
+			}
+			#endif /* configUSE_SHARED_STACK_TASKS */
+		}
 
 		portSETUP_TCB( pxNewTCB );
 	}
 	taskEXIT_CRITICAL();
 
-	if( xSchedulerRunning != pdFALSE )
+	if( ( xSchedulerRunning != pdFALSE ) && ( taskIS_RUN_TO_COMPLETION( pxNewTCB ) == pdFALSE ) )
 	{
 		/* If the created task is of a higher priority than the current task
 		then it should run now. */
@@ -1189,6 +1434,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 
+			#if( configUSE_SHARED_STACK_TASKS == 1 )
+			{
+				/* A run to completion task deleted part way through its
+				handler will never finish with the shared stack. */
+				if( taskOWNS_SHARED_STACK( pxTCB ) != pdFALSE )
+				{
+					pxTCB->pxSharedStack->pxOwner = NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_SHARED_STACK_TASKS */
+
 			/* Increment the uxTaskNumber also so kernel aware debuggers can
 			detect that the task lists need re-generating.  This is done before
 			portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1711,6 +1971,10 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			being suspended. */
 			pxTCB = prvGetTCBFromHandle( xTaskToSuspend );
 
+			/* A run to completion task cannot be suspended part way through
+			its handler, see xTaskCreateRunToCompletion(). */
+			configASSERT( taskOWNS_SHARED_STACK( pxTCB ) == pdFALSE );
+
 			traceTASK_SUSPEND( pxTCB );
 
 			/* Remove task from the ready/delayed list and place in the
@@ -2118,6 +2382,23 @@ void vTaskSuspendAll( void )
 	do not otherwise exhibit real time behaviour. */
 	portSOFTWARE_BARRIER();
 
+	#if( configUSE_SECTION_PROFILING == 1 )
+	{
+		/* Interrupts cannot suspend the scheduler, so the outermost call
+		cannot be interrupted by another between the test and the increment
+		below. */
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			pvSchedulerSuspendedCaller = portGET_CALLER_ADDRESS();
+			ulSchedulerSuspendedStart = portGET_CYCLE_COUNT();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	/* The scheduler is suspended if uxSchedulerSuspended is non-zero.  An increment
 	is used to allow calls to vTaskSuspendAll() to nest. */
 	++uxSchedulerSuspended;
@@ -2211,6 +2492,21 @@ BaseType_t xAlreadyYielded = pdFALSE;
 
 		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 		{
+			#if( configUSE_SECTION_PROFILING == 1 )
+			{
+				/* Sections taken before the scheduler was started are not
+				recorded. */
+				if( xSchedulerRunning != pdFALSE )
+				{
+					vSectionProfileRecord( sectprofSCHEDULER_SUSPENDED, portGET_CYCLE_COUNT() - ulSchedulerSuspendedStart, pvSchedulerSuspendedCaller, pxCurrentTCB );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif
+
 			if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
 			{
 				/* Move any readied tasks from the pending list into the
@@ -3036,11 +3332,54 @@ void vTaskSwitchContext( void )
 		}
 		#endif
 
+		/* A task that yields from within a critical section runs with
+		interrupts enabled until it is switched back in, so pause the timing
+		of its critical section while it is switched out. */
+		#if( ( configUSE_SECTION_PROFILING == 1 ) && ( portCRITICAL_NESTING_IN_TCB == 1 ) )
+		{
+			if( pxCurrentTCB->uxCriticalNesting > 0U )
+			{
+				pxCurrentTCB->ulCriticalCycles += portGET_CYCLE_COUNT() - pxCurrentTCB->ulCriticalStart;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
 		/* Select a new task to run using either the generic C or port
 		optimised asm code. */
 		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+		#if( configUSE_SHARED_STACK_TASKS == 1 )
+		{
+			if( taskIS_RUN_TO_COMPLETION( pxCurrentTCB ) != pdFALSE )
+			{
+				prvSwitchToSharedStack();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_SHARED_STACK_TASKS */
+
 		traceTASK_SWITCHED_IN();
 
+		#if( ( configUSE_SECTION_PROFILING == 1 ) && ( portCRITICAL_NESTING_IN_TCB == 1 ) )
+		{
+			if( pxCurrentTCB->uxCriticalNesting > 0U )
+			{
+				pxCurrentTCB->ulCriticalStart = portGET_CYCLE_COUNT();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
 		/* After the new task is switched in, update the global errno. */
 		#if( configUSE_POSIX_ERRNO == 1 )
 		{
@@ -3742,7 +4081,16 @@ static void prvCheckTasksWaitingTermination( void )
 		parameter is provided to allow it to be skipped. */
 		if( xGetFreeStackSpace != pdFALSE )
 		{
-			#if ( portSTACK_GROWTH > 0 )
+			#if ( configRECORD_STACK_PEAK == 1 )
+			{
+			configSTACK_DEPTH_TYPE uxPeak, uxSize;
+
+				/* The port records the deepest stack pointer, so the stack
+				does not have to be scanned. */
+				uxPeak = uxTaskGetStackPeak( ( TaskHandle_t ) pxTCB, &uxSize );
+				pxTaskStatus->usStackHighWaterMark = ( uxPeak < uxSize ) ? ( uxSize - uxPeak ) : 0;
+			}
+			#elif ( portSTACK_GROWTH > 0 )
 			{
 				pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
 			}
@@ -3794,7 +4142,7 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) && ( configRECORD_STACK_PEAK == 0 ) ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
 
 	static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
 	{
@@ -3811,7 +4159,7 @@ static void prvCheckTasksWaitingTermination( void )
 		return ( configSTACK_DEPTH_TYPE ) ulCount;
 	}
 
-#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) */
+#endif /* ( ( ( configUSE_TRACE_FACILITY == 1 ) && ( configRECORD_STACK_PEAK == 0 ) ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 )
@@ -3882,6 +4230,37 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_uxTaskGetStackHighWaterMark */
 /*-----------------------------------------------------------*/
 
+#if ( configRECORD_STACK_PEAK == 1 )
+
+	configSTACK_DEPTH_TYPE uxTaskGetStackPeak( TaskHandle_t xTask, configSTACK_DEPTH_TYPE *puxStackSize )
+	{
+	TCB_t *pxTCB;
+	StackType_t *pxStackPeak;
+
+		pxTCB = prvGetTCBFromHandle( xTask );
+
+		/* The port only writes the TCB when the task stops running, so the
+		running task reads its peak from the port. */
+		if( pxTCB == pxCurrentTCB )
+		{
+			pxStackPeak = portGET_STACK_PEAK();
+		}
+		else
+		{
+			pxStackPeak = pxTCB->pxStackPeak;
+		}
+
+		if( puxStackSize != NULL )
+		{
+			*puxStackSize = ( configSTACK_DEPTH_TYPE ) ( pxTCB->pxEndOfStack - pxTCB->pxStack );
+		}
+
+		return ( configSTACK_DEPTH_TYPE ) ( pxTCB->pxEndOfStack - pxStackPeak );
+	}
+
+#endif /* configRECORD_STACK_PEAK */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelete == 1 )
 
 	static void prvDeleteTCB( TCB_t *pxTCB )
@@ -3891,6 +4270,14 @@ static void prvCheckTasksWaitingTermination( void )
 		want to allocate and clean RAM statically. */
 		portCLEAN_UP_TCB( pxTCB );
 
+		/* Return any heap blocks the task was holding for reuse to the heap.
+		This is done whether or not the TCB itself was allocated dynamically. */
+		#if( configUSE_TASK_HEAP_CACHE == 1 )
+		{
+			vPortReleaseTaskHeapCache( pxTCB->pvHeapCache );
+		}
+		#endif
+
 		/* Free up the memory allocated by the scheduler for the task.  It is up
 		to the task to free any memory allocated at the application level.
 		See the third party link http://www.nadler.com/embedded/newlibAndFreeRTOS.html
@@ -3901,12 +4288,26 @@ static void prvCheckTasksWaitingTermination( void )
 		}
 		#endif /* configUSE_NEWLIB_REENTRANT */
 
+		#if( configUSE_SHARED_STACK_TASKS == 1 )
+		{
+			/* A shared stack outlives the run to completion tasks using it. */
+			if( taskIS_RUN_TO_COMPLETION( pxTCB ) != pdFALSE )
+			{
+				pxTCB->pxStack = NULL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_SHARED_STACK_TASKS */
+
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
 		{
 			/* The task can only have been allocated dynamically - free both
 			the stack and TCB. */
 			vPortFree( pxTCB->pxStack );
-			vPortFree( pxTCB );
+			slabFREE_OBJECT( eSlabCacheTask, pxTCB );
 		}
 		#elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
 		{
@@ -3918,13 +4319,13 @@ static void prvCheckTasksWaitingTermination( void )
 				/* Both the stack and TCB were allocated dynamically, so both
 				must be freed. */
 				vPortFree( pxTCB->pxStack );
-				vPortFree( pxTCB );
+				slabFREE_OBJECT( eSlabCacheTask, pxTCB );
 			}
 			else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
 			{
 				/* Only the stack was statically allocated, so the TCB is the
 				only memory that must be freed. */
-				vPortFree( pxTCB );
+				slabFREE_OBJECT( eSlabCacheTask, pxTCB );
 			}
 			else
 			{
@@ -4284,6 +4685,216 @@ TCB_t *pxTCB;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	BaseType_t xTaskPriorityInheritanceUpdate( TaskHandle_t const pxMutexHolder, UBaseType_t uxHighestPriorityWaitingTask )
+	{
+	TCB_t * const pxTCB = pxMutexHolder;
+	UBaseType_t uxPriorityUsedOnEntry, uxPriorityToUse;
+	List_t *pxEventList;
+	BaseType_t xReturn = pdFALSE;
+
+		configASSERT( pxTCB );
+
+		/* The holder runs at the greater of its base priority and the priority
+		of the highest priority task waiting for any of the mutexes it holds,
+		so a priority is dropped as soon as the mutex it was inherited through
+		is given back, not when the last mutex is given back. */
+		if( pxTCB->uxBasePriority < uxHighestPriorityWaitingTask )
+		{
+			uxPriorityToUse = uxHighestPriorityWaitingTask;
+		}
+		else
+		{
+			uxPriorityToUse = pxTCB->uxBasePriority;
+		}
+
+		if( pxTCB->uxPriority != uxPriorityToUse )
+		{
+			uxPriorityUsedOnEntry = pxTCB->uxPriority;
+
+			if( uxPriorityToUse > uxPriorityUsedOnEntry )
+			{
+				traceTASK_PRIORITY_INHERIT( pxTCB, uxPriorityToUse );
+			}
+			else
+			{
+				traceTASK_PRIORITY_DISINHERIT( pxTCB, uxPriorityToUse );
+			}
+
+			pxTCB->uxPriority = uxPriorityToUse;
+
+			/* Only reset the event list item value if the value is not being
+			used for anything else. */
+			if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+			{
+				listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriorityToUse ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+				/* If the holder is itself blocked on an event list, such as
+				the list of tasks waiting for another mutex, then re-sort it
+				into that list.  The head of a mutex's waiting list is what the
+				next holder along the chain inherits. */
+				pxEventList = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+				if( ( pxEventList != NULL ) && ( pxEventList != &xPendingReadyList ) )
+				{
+					( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+					vListInsert( pxEventList, &( pxTCB->xEventListItem ) );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Only move the task between ready lists if it is in the Ready
+			state, as there is one Ready list per priority. */
+			if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+			{
+				if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+				{
+					/* It is known that the task is in its ready list so
+					there is no need to check again and the port level
+					reset macro can be called directly. */
+					portRESET_READY_PRIORITY( uxPriorityUsedOnEntry, uxTopReadyPriority );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				prvAddTaskToReadyList( pxTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	void *pvTaskGetMutexesHeld( TaskHandle_t xMutexHolder )
+	{
+	TCB_t * const pxTCB = xMutexHolder;
+
+		configASSERT( pxTCB );
+		return pxTCB->pvMutexesHeld;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	void vTaskSetMutexesHeld( TaskHandle_t xMutexHolder, void *pvMutexesHeld )
+	{
+	TCB_t * const pxTCB = xMutexHolder;
+
+		configASSERT( pxTCB );
+		pxTCB->pvMutexesHeld = pvMutexesHeld;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	void *pvTaskGetMutexBlockedOn( TaskHandle_t xTask )
+	{
+	TCB_t * const pxTCB = xTask;
+
+		configASSERT( pxTCB );
+		return pxTCB->pvMutexBlockedOn;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 )
+
+	void vTaskSetMutexBlockedOn( void *pvMutex )
+	{
+		/* If a mutex is taken before any tasks have been created then
+		pxCurrentTCB will be NULL. */
+		if( pxCurrentTCB != NULL )
+		{
+			pxCurrentTCB->pvMutexBlockedOn = pvMutex;
+		}
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) && ( configUSE_RW_LOCKS == 1 ) )
+
+	void *pvTaskGetRWLocksHeld( TaskHandle_t xLockHolder )
+	{
+	TCB_t * const pxTCB = xLockHolder;
+
+		configASSERT( pxTCB );
+		return pxTCB->pvRWLocksHeld;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE && configUSE_RW_LOCKS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) && ( configUSE_RW_LOCKS == 1 ) )
+
+	void vTaskSetRWLocksHeld( TaskHandle_t xLockHolder, void *pvRWLocksHeld )
+	{
+	TCB_t * const pxTCB = xLockHolder;
+
+		configASSERT( pxTCB );
+		pxTCB->pvRWLocksHeld = pvRWLocksHeld;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE && configUSE_RW_LOCKS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) && ( configUSE_RW_LOCKS == 1 ) )
+
+	void *pvTaskGetRWLockBlockedOn( TaskHandle_t xTask )
+	{
+	TCB_t * const pxTCB = xTask;
+
+		configASSERT( pxTCB );
+		return pxTCB->pvRWLockBlockedOn;
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE && configUSE_RW_LOCKS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TRANSITIVE_PRIORITY_INHERITANCE == 1 ) && ( configUSE_RW_LOCKS == 1 ) )
+
+	void vTaskSetRWLockBlockedOn( void *pvRWLock )
+	{
+		/* If a lock is obtained before any tasks have been created then
+		pxCurrentTCB will be NULL. */
+		if( pxCurrentTCB != NULL )
+		{
+			pxCurrentTCB->pvRWLockBlockedOn = pvRWLock;
+		}
+	}
+
+#endif /* configUSE_TRANSITIVE_PRIORITY_INHERITANCE && configUSE_RW_LOCKS */
+/*-----------------------------------------------------------*/
+
 #if ( portCRITICAL_NESTING_IN_TCB == 1 )
 
 	void vTaskEnterCritical( void )
@@ -4303,6 +4914,14 @@ TCB_t *pxTCB;
 			if( pxCurrentTCB->uxCriticalNesting == 1 )
 			{
 				portASSERT_IF_IN_ISR();
+
+				#if( configUSE_SECTION_PROFILING == 1 )
+				{
+					pxCurrentTCB->pvCriticalCaller = portGET_CALLER_ADDRESS();
+					pxCurrentTCB->ulCriticalCycles = 0UL;
+					pxCurrentTCB->ulCriticalStart = portGET_CYCLE_COUNT();
+				}
+				#endif
 			}
 		}
 		else
@@ -4326,6 +4945,12 @@ TCB_t *pxTCB;
 
 				if( pxCurrentTCB->uxCriticalNesting == 0U )
 				{
+					#if( configUSE_SECTION_PROFILING == 1 )
+					{
+						vSectionProfileRecord( sectprofCRITICAL_SECTION, pxCurrentTCB->ulCriticalCycles + ( portGET_CYCLE_COUNT() - pxCurrentTCB->ulCriticalStart ), pxCurrentTCB->pvCriticalCaller, pxCurrentTCB );
+					}
+					#endif
+
 					portENABLE_INTERRUPTS();
 				}
 				else
@@ -4630,6 +5255,83 @@ TickType_t uxReturn;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TASK_HEAP_CACHE == 1 )
+
+	void **ppvTaskGetHeapCache( void )
+	{
+	void **ppvReturn;
+
+		/* Before the scheduler starts pxCurrentTCB is not necessarily the task
+		that is calling the heap, so no task's cache is used. */
+		if( xSchedulerRunning != pdFALSE )
+		{
+			ppvReturn = pxCurrentTCB->pvHeapCache;
+		}
+		else
+		{
+			ppvReturn = NULL;
+		}
+
+		return ppvReturn;
+	}
+
+#endif /* configUSE_TASK_HEAP_CACHE */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_CEILING_MUTEXES == 1 )
+
+	void vTaskPriorityRaiseToCeiling( UBaseType_t uxCeilingPriority )
+	{
+	TCB_t * const pxTCB = pxCurrentTCB;
+
+		/* This function is called from a critical section.  If the mutex is
+		taken before any tasks have been created then pxCurrentTCB will be
+		NULL. */
+		if( pxTCB != NULL )
+		{
+			/* A task that has a base priority above the ceiling of a mutex it
+			uses could be blocked by a lower priority holder of the mutex, so
+			the ceiling has been set incorrectly. */
+			configASSERT( pxTCB->uxBasePriority <= uxCeilingPriority );
+
+			/* The priority may already be above the ceiling if the task has
+			inherited a priority, or holds a mutex with a higher ceiling. */
+			if( pxTCB->uxPriority < uxCeilingPriority )
+			{
+				/* The task is running, so is in a ready list.  Move it to the
+				ready list of its new priority.  There is no need to yield as
+				the priority is being raised. */
+				if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+				{
+					taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				traceTASK_PRIORITY_INHERIT( pxTCB, uxCeilingPriority );
+				pxTCB->uxPriority = uxCeilingPriority;
+
+				/* The event list item value cannot be in use for any other
+				purpose if this task is running. */
+				listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxCeilingPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+				prvAddTaskToReadyList( pxTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
 	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
@@ -5174,6 +5876,174 @@ TickType_t uxReturn;
 #endif
 /*-----------------------------------------------------------*/
 
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	static portTASK_FUNCTION( prvRunToCompletionTask, pvParameters )
+	{
+	uint32_t ulNotifiedValue;
+
+		/* The task was made ready by a notification.  Consume it. */
+		taskENTER_CRITICAL();
+		{
+			ulNotifiedValue = pxCurrentTCB->ulNotifiedValue;
+			pxCurrentTCB->ulNotifiedValue = 0UL;
+			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		}
+		taskEXIT_CRITICAL();
+
+		pxCurrentTCB->pxRunToCompletionCode( pvParameters, ulNotifiedValue );
+
+		/* Nothing on the shared stack is needed now the handler has returned.
+		Release the stack and wait for the next notification.  The task never
+		returns to this frame - when it is next selected prvSwitchToSharedStack()
+		starts it again from the top of the stack. */
+		configASSERT( uxSchedulerSuspended == 0 );
+		taskENTER_CRITICAL();
+		{
+			pxCurrentTCB->pxSharedStack->pxOwner = NULL;
+
+			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			{
+				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				prvAddCurrentTaskToDelayedList( portMAX_DELAY, pdTRUE );
+			}
+			else
+			{
+				/* The task was notified again while the handler was running,
+				so remains ready to run the handler again. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			portYIELD_WITHIN_API();
+		}
+
+		/* Should not get here.  The critical section is abandoned along with
+		the rest of the frame, as the critical nesting count is reset when the
+		task is next started. */
+		configASSERT( pdFALSE );
+	}
+
+#endif /* configUSE_SHARED_STACK_TASKS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	static SharedStack_t *prvGetSharedStack( UBaseType_t uxPriority )
+	{
+	SharedStack_t *pxSharedStack = &( xSharedStacks[ uxPriority ] );
+	StackType_t *pxStack;
+
+		vTaskSuspendAll();
+		{
+			if( pxSharedStack->pxStack == NULL )
+			{
+				pxStack = ( StackType_t * ) pvPortMallocKernelObject( ( ( size_t ) configSHARED_STACK_DEPTH ) * sizeof( StackType_t ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack. */
+
+				if( pxStack != NULL )
+				{
+					/* The stack is filled once, here, rather than each time a
+					task that uses it is created. */
+					#if( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+					{
+						( void ) memset( pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) configSHARED_STACK_DEPTH * sizeof( StackType_t ) );
+					}
+					#endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
+
+					/* The top of stack is calculated as in prvInitialiseNewTask(). */
+					#if( portSTACK_GROWTH < 0 )
+					{
+						pxSharedStack->pxTopOfStack = &( pxStack[ configSHARED_STACK_DEPTH - 1 ] );
+						pxSharedStack->pxTopOfStack = ( StackType_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pxSharedStack->pxTopOfStack ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) ); /*lint !e923 !e9033 !e9078 MISRA exception. */
+					}
+					#else /* portSTACK_GROWTH */
+					{
+						pxSharedStack->pxTopOfStack = pxStack;
+					}
+					#endif /* portSTACK_GROWTH */
+
+					pxSharedStack->pxOwner = NULL;
+					pxSharedStack->pxStack = pxStack;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		if( pxSharedStack->pxStack == NULL )
+		{
+			pxSharedStack = NULL;
+		}
+
+		return pxSharedStack;
+	}
+
+#endif /* configUSE_SHARED_STACK_TASKS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_SHARED_STACK_TASKS == 1 )
+
+	static void prvSwitchToSharedStack( void )
+	{
+	SharedStack_t * const pxSharedStack = pxCurrentTCB->pxSharedStack;
+	TCB_t *pxOwner = pxSharedStack->pxOwner;
+
+		if( pxOwner == NULL )
+		{
+			/* The stack is free, so start the handler from the top of it,
+			discarding whatever context the task left behind when its handler
+			last returned. */
+			pxSharedStack->pxOwner = pxCurrentTCB;
+
+			#if ( portCRITICAL_NESTING_IN_TCB == 1 )
+			{
+				pxCurrentTCB->uxCriticalNesting = ( UBaseType_t ) 0U;
+			}
+			#endif /* portCRITICAL_NESTING_IN_TCB */
+
+			#if( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+			{
+				#if( portSTACK_GROWTH < 0 )
+				{
+					pxCurrentTCB->pxTopOfStack = pxPortInitialiseStack( pxSharedStack->pxTopOfStack, pxCurrentTCB->pxStack, prvRunToCompletionTask, pxCurrentTCB->pvRunToCompletionParameters );
+				}
+				#else /* portSTACK_GROWTH */
+				{
+					pxCurrentTCB->pxTopOfStack = pxPortInitialiseStack( pxSharedStack->pxTopOfStack, pxCurrentTCB->pxEndOfStack, prvRunToCompletionTask, pxCurrentTCB->pvRunToCompletionParameters );
+				}
+				#endif /* portSTACK_GROWTH */
+			}
+			#else /* portHAS_STACK_OVERFLOW_CHECKING */
+			{
+				pxCurrentTCB->pxTopOfStack = pxPortInitialiseStack( pxSharedStack->pxTopOfStack, prvRunToCompletionTask, pxCurrentTCB->pvRunToCompletionParameters );
+			}
+			#endif /* portHAS_STACK_OVERFLOW_CHECKING */
+		}
+		else if( pxOwner != pxCurrentTCB )
+		{
+			/* A task that uses the same stack was preempted part way through
+			its handler.  Its handler must complete before the stack can be
+			reused, so run it instead.  It cannot have blocked or been
+			suspended, as both are rejected while a task owns its stack. */
+			configASSERT( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxOwner->uxPriority ] ), &( pxOwner->xStateListItem ) ) );
+			pxCurrentTCB = pxOwner;
+		}
+		else
+		{
+			/* The task is resuming a handler that was preempted. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_SHARED_STACK_TASKS */
+/*-----------------------------------------------------------*/
+
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely )
 {
 TickType_t xTimeToWake;
@@ -5188,6 +6058,10 @@ const TickType_t xConstTickCount = xTickCount;
 	}
 	#endif
 
+	/* A run to completion task cannot block part way through its handler, see
+	xTaskCreateRunToCompletion(). */
+	configASSERT( taskOWNS_SHARED_STACK( pxCurrentTCB ) == pdFALSE );
+
 	/* Remove the task from the ready list before adding it to the blocked list
 	as the same list item is used for both lists. */
 	if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )